@@ -0,0 +1,21 @@
+/**
+ * @file blend_asm.h
+ * @brief The blend backend of the target, LV_DRAW_SW_ASM_CUSTOM_INCLUDE of lv_conf.h
+ *
+ * LVGL includes this header in its blend files. The firmware gets the DSP
+ * kernels of the Cortex-M33 (blend_dsp.h) when DISP_BLEND_DSP is set in
+ * lv_conf.h, the x86 host builds the SSE2 / AVX2 kernels (blend_simd.h).
+ * Each header defines its hooks only on its own target; the blends without
+ * a hook use LVGL's scalar code.
+ */
+
+#ifndef BLEND_ASM_H
+#define BLEND_ASM_H
+
+#include "blend_dsp.h"
+
+#if !BLEND_DSP
+#include "blend_simd.h"
+#endif
+
+#endif /* BLEND_ASM_H */
@@ -0,0 +1,525 @@
+/**
+ * @file blend_dsp.c
+ * @brief RGB565 blending with the DSP extension of the Cortex-M33
+ *
+ * Two RGB565 pixels share a 32-bit word, one per 16-bit lane. The kernels
+ * load, blend and store the destination a word at a time and read the masks
+ * four bytes at a time, so fully covered and fully transparent runs cost a
+ * compare and at most two stores.
+ *
+ * LVGL's mix, lv_color_16_16_mix(), with m = (mix + 4) >> 3 is exactly
+ *
+ *     channel = (fg * m + bg * (32 - m)) >> 5
+ *
+ * for every channel, including its shortcuts for mix 0 and 255. When both
+ * pixels of a word mix with the same m (opacity only), each channel of the
+ * two pixels is spread to the lanes and a single multiply-accumulate blends
+ * both: the sums stay below 63 * 32 and can't spill into the other lane.
+ * Pixels with their own mix (masks) use the same formula one at a time on
+ * the 0x07E0F81F spread of lv_color_16_16_mix().
+ *
+ * ARGB8888 and AL88 follow lv_color_24_16_mix() / lv_color_8_16_mix():
+ * (src * mix + dest * (255 - mix)) >> 8 per channel. UXTB16 puts the blue
+ * and red bytes of an ARGB8888 pixel in the lanes, PKHBT the blue and red
+ * of the destination, and one multiply-accumulate blends both channels;
+ * green is a SMUAD of the packed (src, dest) and (mix, 255 - mix).
+ *
+ * RGB565_SWAPPED sources and destinations are swapped with REV16, two
+ * pixels at a time.
+ */
+
+#include "blend_dsp.h"
+
+#if BLEND_DSP
+
+#include "blend_dsp_intrin.h"
+#include "lvgl.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+
+/*===========================================
+ * Private Definitions
+ *===========================================*/
+
+#define LANES_5         0x001F001Fu     /* A 5-bit channel in both lanes */
+#define LANES_6         0x003F003Fu     /* A 6-bit channel in both lanes */
+#define SPREAD_MASK     0x07E0F81Fu     /* Green in the high half, red and blue in the low half */
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static inline uint16_t *row_next(const void *buf, int32_t stride) {
+    return (uint16_t *)((uint8_t *)buf + stride);
+}
+
+static inline uint32_t swap16(uint32_t c) {
+    return ((c >> 8) | (c << 8)) & 0xFFFF;
+}
+
+/* Two pixels of the destination in the lanes, unswapped */
+static inline uint32_t pair_load(const uint16_t *p, bool swapped) {
+    uint32_t v = dsp_load32(p);
+    return swapped ? dsp_rev16(v) : v;
+}
+
+static inline void pair_store(uint16_t *p, uint32_t v, bool swapped) {
+    dsp_store32(p, swapped ? dsp_rev16(v) : v);
+}
+
+static inline uint32_t px_load(const uint16_t *p, bool swapped) {
+    return swapped ? swap16(*p) : *p;
+}
+
+static inline void px_store(uint16_t *p, uint32_t c, bool swapped) {
+    *p = (uint16_t)(swapped ? swap16(c) : c);
+}
+
+/* The factor of lv_color_16_16_mix(): 0..32 */
+static inline uint32_t mix_factor(uint32_t mix) {
+    return (mix + 4) >> 3;
+}
+
+/*-------------------------------------------
+ * One pixel, its own mix
+ *-------------------------------------------*/
+
+static inline uint32_t spread(uint32_t c) {
+    return (c | (c << 16)) & SPREAD_MASK;
+}
+
+/* `fg` spread, `m` = mix_factor() */
+static inline uint32_t mix_px(uint32_t fg, uint32_t bg, uint32_t m) {
+    uint32_t bgs = spread(bg);
+    uint32_t res = ((((fg - bgs) * m) >> 5) + bgs) & SPREAD_MASK;
+    return (res | (res >> 16)) & 0xFFFF;
+}
+
+/* Two pixels, each with its mix in a byte of `mix2` */
+static inline uint32_t mix_pair(uint32_t fg2, uint32_t bg2, uint32_t mix2) {
+    uint32_t lo = mix_px(spread(fg2 & 0xFFFF), bg2 & 0xFFFF, mix_factor(mix2 & 0xFF));
+    uint32_t hi = mix_px(spread(fg2 >> 16), bg2 >> 16, mix_factor(mix2 >> 8));
+    return lo | (hi << 16);
+}
+
+/*-------------------------------------------
+ * Two pixels, the same mix
+ *-------------------------------------------*/
+
+static inline uint32_t lanes_r(uint32_t px2) {
+    return (px2 >> 11) & LANES_5;
+}
+
+static inline uint32_t lanes_g(uint32_t px2) {
+    return (px2 >> 5) & LANES_6;
+}
+
+static inline uint32_t lanes_b(uint32_t px2) {
+    return px2 & LANES_5;
+}
+
+/* Two pixels back from the lanes of (channel * 32) */
+static inline uint32_t lanes_pack(uint32_t r, uint32_t g, uint32_t b) {
+    return ((r << 6) & 0xF800F800u) | (g & 0x07E007E0u) | ((b >> 5) & LANES_5);
+}
+
+static inline uint32_t mix_pair_same(uint32_t fg2, uint32_t bg2, uint32_t m) {
+    uint32_t inv = 32 - m;
+    return lanes_pack(lanes_r(fg2) * m + lanes_r(bg2) * inv,
+                      lanes_g(fg2) * m + lanes_g(bg2) * inv,
+                      lanes_b(fg2) * m + lanes_b(bg2) * inv);
+}
+
+/* LV_OPA_MIX2() of four mask bytes */
+static inline uint32_t mask4_opa(uint32_t mask4, uint32_t opa) {
+    return ((((mask4 & 0xFF) * opa) >> 8)) | ((((mask4 >> 8) & 0xFF) * opa) & 0xFF00) |
+           (((((mask4 >> 16) & 0xFF) * opa) >> 8) << 16) | ((((mask4 >> 24) * opa) & 0xFF00) << 16);
+}
+
+/* LV_OPA_MIX2() of two mask bytes */
+static inline uint32_t mask2_opa(const uint8_t *mask, uint32_t opa) {
+    return ((mask[0] * opa) >> 8) | ((mask[1] * opa) & 0xFF00);
+}
+
+/*-------------------------------------------
+ * ARGB8888 and AL88
+ *-------------------------------------------*/
+
+static inline uint32_t argb8888_to_rgb565(uint32_t s) {
+    return ((s >> 8) & 0xF800) | ((s >> 5) & 0x07E0) | ((s >> 3) & 0x1F);
+}
+
+static inline uint32_t l8_to_rgb565(uint32_t l) {
+    return ((l & 0xF8) << 8) | ((l & 0xFC) << 3) | ((l & 0xF8) >> 3);
+}
+
+/* `s_rb`: 5-bit blue and red in the lanes, `s_g`: 6-bit green, `mix` 1..254 */
+static inline uint32_t mix_rb_g(uint32_t s_rb, uint32_t s_g, uint32_t d, uint32_t mix) {
+    uint32_t inv = 255 - mix;
+    uint32_t d_rb = dsp_pkhbt(d & 0x1F, d, 5);
+    uint32_t rb = s_rb * mix + d_rb * inv;
+    uint32_t g = dsp_smuad(dsp_pkhbt(s_g, (d >> 5) & 0x3F, 16), dsp_pkhbt(mix, inv, 16));
+    return ((rb >> 13) & 0xF800) | ((g >> 3) & 0x07E0) | ((rb >> 8) & 0x1F);
+}
+
+static inline uint32_t mix_argb8888(uint32_t s, uint32_t d, uint32_t mix) {
+    return mix_rb_g((dsp_uxtb16(s) >> 3) & LANES_5, (s >> 10) & 0x3F, d, mix);
+}
+
+static inline uint32_t mix_l8(uint32_t l, uint32_t d, uint32_t mix) {
+    uint32_t l5 = l >> 3;
+    return mix_rb_g(l5 | (l5 << 16), l >> 2, d, mix);
+}
+
+/*-------------------------------------------
+ * Color fill
+ *-------------------------------------------*/
+
+static inline void color_with_opa(lv_draw_sw_blend_fill_dsc_t *dsc, bool swapped) {
+    uint32_t color = lv_color_to_u16(dsc->color);
+    uint32_t m = mix_factor(dsc->opa);
+    uint32_t inv = 32 - m;
+    uint32_t fg = spread(color);
+    uint32_t color2 = color | (color << 16);
+    uint32_t fm_r = lanes_r(color2) * m;
+    uint32_t fm_g = lanes_g(color2) * m;
+    uint32_t fm_b = lanes_b(color2) * m;
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+
+    /* Backgrounds are mostly plain: reuse the result of the previous pair */
+    uint32_t last_bg2 = 0;
+    uint32_t last_res2 = lanes_pack(fm_r, fm_g, fm_b);
+    if (swapped) {
+        last_res2 = dsp_rev16(last_res2);
+    }
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        if (((uintptr_t)dest & 0x2) && w > 0) {
+            px_store(&dest[0], mix_px(fg, px_load(&dest[0], swapped), m), swapped);
+            x = 1;
+        }
+        for (; x + 2 <= w; x += 2) {
+            uint32_t bg2 = dsp_load32(&dest[x]);
+            if (bg2 != last_bg2) {
+                uint32_t b = swapped ? dsp_rev16(bg2) : bg2;
+                uint32_t res = lanes_pack(lanes_r(b) * inv + fm_r, lanes_g(b) * inv + fm_g, lanes_b(b) * inv + fm_b);
+                last_bg2 = bg2;
+                last_res2 = swapped ? dsp_rev16(res) : res;
+            }
+            dsp_store32(&dest[x], last_res2);
+        }
+        if (x < w) {
+            px_store(&dest[x], mix_px(fg, px_load(&dest[x], swapped), m), swapped);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+    }
+}
+
+/* Blend two pixels of the fill, `mix2`: their mix in the low two bytes */
+static inline void color_pair(uint16_t *dest, uint32_t fg, uint32_t color2, uint32_t mix2, bool swapped) {
+    if (mix2 == 0) {
+        return;
+    }
+    if (mix2 == 0xFFFF) {
+        pair_store(dest, color2, swapped);
+        return;
+    }
+    uint32_t bg2 = pair_load(dest, swapped);
+    uint32_t lo = mix_px(fg, bg2 & 0xFFFF, mix_factor(mix2 & 0xFF));
+    uint32_t hi = mix_px(fg, bg2 >> 16, mix_factor(mix2 >> 8));
+    pair_store(dest, lo | (hi << 16), swapped);
+}
+
+/* `opa` < 255: mask and opacity */
+static inline void color_with_mask(lv_draw_sw_blend_fill_dsc_t *dsc, uint32_t opa, bool swapped) {
+    uint32_t color = lv_color_to_u16(dsc->color);
+    uint32_t fg = spread(color);
+    uint32_t color2 = color | (color << 16);
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        if (((uintptr_t)dest & 0x2) && w > 0) {
+            uint32_t mix = opa < 255 ? LV_OPA_MIX2(mask[0], opa) : mask[0];
+            px_store(&dest[0], mix_px(fg, px_load(&dest[0], swapped), mix_factor(mix)), swapped);
+            x = 1;
+        }
+        for (; x + 4 <= w; x += 4) {
+            uint32_t mask4 = dsp_load32(&mask[x]);
+            if (mask4 == 0) {
+                continue;
+            }
+            if (opa < 255) {
+                mask4 = mask4_opa(mask4, opa);
+            } else if (mask4 == 0xFFFFFFFFu) {
+                pair_store(&dest[x], color2, swapped);
+                pair_store(&dest[x + 2], color2, swapped);
+                continue;
+            }
+            color_pair(&dest[x], fg, color2, mask4 & 0xFFFF, swapped);
+            color_pair(&dest[x + 2], fg, color2, mask4 >> 16, swapped);
+        }
+        for (; x + 2 <= w; x += 2) {
+            uint32_t mix2 = opa < 255 ? mask2_opa(&mask[x], opa) : (uint32_t)(mask[x] | (mask[x + 1] << 8));
+            color_pair(&dest[x], fg, color2, mix2, swapped);
+        }
+        if (x < w) {
+            uint32_t mix = opa < 255 ? LV_OPA_MIX2(mask[x], opa) : mask[x];
+            px_store(&dest[x], mix_px(fg, px_load(&dest[x], swapped), mix_factor(mix)), swapped);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        mask += dsc->mask_stride;
+    }
+}
+
+/*-------------------------------------------
+ * RGB565 image
+ *-------------------------------------------*/
+
+/* Opaque copy with the byte order changed */
+static inline void rgb565_swap_copy(lv_draw_sw_blend_image_dsc_t *dsc) {
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint16_t *src = dsc->src_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        if (((uintptr_t)dest & 0x2) && w > 0) {
+            dest[0] = (uint16_t)swap16(src[0]);
+            x = 1;
+        }
+        for (; x + 2 <= w; x += 2) {
+            dsp_store32(&dest[x], dsp_rev16(dsp_load32(&src[x])));
+        }
+        if (x < w) {
+            dest[x] = (uint16_t)swap16(src[x]);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src = row_next(src, dsc->src_stride);
+    }
+}
+
+static inline void rgb565_with_opa(lv_draw_sw_blend_image_dsc_t *dsc, bool src_swapped, bool dest_swapped) {
+    uint32_t m = mix_factor(dsc->opa);
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint16_t *src = dsc->src_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        if (((uintptr_t)dest & 0x2) && w > 0) {
+            px_store(&dest[0], mix_px(spread(px_load(&src[0], src_swapped)), px_load(&dest[0], dest_swapped), m),
+                     dest_swapped);
+            x = 1;
+        }
+        for (; x + 2 <= w; x += 2) {
+            uint32_t res = mix_pair_same(pair_load(&src[x], src_swapped), pair_load(&dest[x], dest_swapped), m);
+            pair_store(&dest[x], res, dest_swapped);
+        }
+        if (x < w) {
+            px_store(&dest[x], mix_px(spread(px_load(&src[x], src_swapped)), px_load(&dest[x], dest_swapped), m),
+                     dest_swapped);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src = row_next(src, dsc->src_stride);
+    }
+}
+
+/* Blend two pixels of the image, `mix2`: their mix in the low two bytes */
+static inline void rgb565_pair(uint16_t *dest, const uint16_t *src, uint32_t mix2, bool src_swapped,
+                               bool dest_swapped) {
+    if (mix2 == 0) {
+        return;
+    }
+    uint32_t fg2 = pair_load(src, src_swapped);
+    if (mix2 == 0xFFFF) {
+        pair_store(dest, fg2, dest_swapped);
+        return;
+    }
+    pair_store(dest, mix_pair(fg2, pair_load(dest, dest_swapped), mix2), dest_swapped);
+}
+
+/* `opa` < 255: mask and opacity */
+static inline void rgb565_with_mask(lv_draw_sw_blend_image_dsc_t *dsc, uint32_t opa, bool src_swapped,
+                                    bool dest_swapped) {
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint16_t *src = dsc->src_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        if (((uintptr_t)dest & 0x2) && w > 0) {
+            uint32_t mix = opa < 255 ? LV_OPA_MIX2(mask[0], opa) : mask[0];
+            px_store(&dest[0], mix_px(spread(px_load(&src[0], src_swapped)), px_load(&dest[0], dest_swapped),
+                                      mix_factor(mix)), dest_swapped);
+            x = 1;
+        }
+        for (; x + 4 <= w; x += 4) {
+            uint32_t mask4 = dsp_load32(&mask[x]);
+            if (mask4 == 0) {
+                continue;
+            }
+            if (opa < 255) {
+                mask4 = mask4_opa(mask4, opa);
+            }
+            rgb565_pair(&dest[x], &src[x], mask4 & 0xFFFF, src_swapped, dest_swapped);
+            rgb565_pair(&dest[x + 2], &src[x + 2], mask4 >> 16, src_swapped, dest_swapped);
+        }
+        for (; x + 2 <= w; x += 2) {
+            uint32_t mix2 = opa < 255 ? mask2_opa(&mask[x], opa) : (uint32_t)(mask[x] | (mask[x + 1] << 8));
+            rgb565_pair(&dest[x], &src[x], mix2, src_swapped, dest_swapped);
+        }
+        if (x < w) {
+            uint32_t mix = opa < 255 ? LV_OPA_MIX2(mask[x], opa) : mask[x];
+            px_store(&dest[x], mix_px(spread(px_load(&src[x], src_swapped)), px_load(&dest[x], dest_swapped),
+                                      mix_factor(mix)), dest_swapped);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src = row_next(src, dsc->src_stride);
+        mask += dsc->mask_stride;
+    }
+}
+
+/*-------------------------------------------
+ * ARGB8888 and AL88 images
+ *-------------------------------------------*/
+
+/* The mix of a pixel with alpha `a` as LVGL's scalar code computes it */
+static inline uint32_t px_mix(uint32_t a, const uint8_t *mask, int32_t x, uint32_t opa) {
+    if (mask == NULL) {
+        return opa >= LV_OPA_MAX ? a : LV_OPA_MIX2(a, opa);
+    }
+    return opa >= LV_OPA_MAX ? LV_OPA_MIX2(a, mask[x]) : LV_OPA_MIX3(a, mask[x], opa);
+}
+
+static inline void argb8888_blend(lv_draw_sw_blend_image_dsc_t *dsc, const uint8_t *mask, uint32_t opa,
+                                  bool dest_swapped) {
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint8_t *src = dsc->src_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        for (int32_t x = 0; x < w; x++) {
+            uint32_t s = dsp_load32(&src[x * 4]);
+            uint32_t mix = px_mix(s >> 24, mask, x, opa);
+            if (mix == 0) {
+                continue;
+            }
+            if (mix == 255) {
+                px_store(&dest[x], argb8888_to_rgb565(s), dest_swapped);
+            } else {
+                px_store(&dest[x], mix_argb8888(s, px_load(&dest[x], dest_swapped), mix), dest_swapped);
+            }
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src += dsc->src_stride;
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+static inline void al88_blend(lv_draw_sw_blend_image_dsc_t *dsc, const uint8_t *mask, uint32_t opa,
+                              bool dest_swapped) {
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const lv_color16a_t *src = dsc->src_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        for (int32_t x = 0; x < w; x++) {
+            uint32_t mix = px_mix(src[x].alpha, mask, x, opa);
+            if (mix == 0) {
+                continue;
+            }
+            if (mix == 255) {
+                px_store(&dest[x], l8_to_rgb565(src[x].lumi), dest_swapped);
+            } else {
+                px_store(&dest[x], mix_l8(src[x].lumi, px_load(&dest[x], dest_swapped), mix), dest_swapped);
+            }
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src = (const lv_color16a_t *)((const uint8_t *)src + dsc->src_stride);
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+lv_result_t blend_dsp_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc, bool dest_swapped) {
+    if (dsc->mask_buf == NULL) {
+        if (dsc->opa >= LV_OPA_MAX) {
+            return LV_RESULT_INVALID;
+        }
+        if (dest_swapped) {
+            color_with_opa(dsc, true);
+        } else {
+            color_with_opa(dsc, false);
+        }
+    } else {
+        uint32_t opa = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+        if (dest_swapped) {
+            color_with_mask(dsc, opa, true);
+        } else {
+            color_with_mask(dsc, opa, false);
+        }
+    }
+    return LV_RESULT_OK;
+}
+
+lv_result_t blend_dsp_rgb565_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool src_swapped, bool dest_swapped) {
+    /* Instantiate the kernels for each byte order */
+    uint32_t order = (src_swapped ? 1 : 0) | (dest_swapped ? 2 : 0);
+
+    if (dsc->mask_buf == NULL) {
+        if (dsc->opa >= LV_OPA_MAX) {
+            if (src_swapped == dest_swapped) {
+                return LV_RESULT_INVALID;
+            }
+            rgb565_swap_copy(dsc);
+            return LV_RESULT_OK;
+        }
+        switch (order) {
+            case 0: rgb565_with_opa(dsc, false, false); break;
+            case 1: rgb565_with_opa(dsc, true, false); break;
+            case 2: rgb565_with_opa(dsc, false, true); break;
+            default: rgb565_with_opa(dsc, true, true); break;
+        }
+    } else {
+        uint32_t opa = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+        switch (order) {
+            case 0: rgb565_with_mask(dsc, opa, false, false); break;
+            case 1: rgb565_with_mask(dsc, opa, true, false); break;
+            case 2: rgb565_with_mask(dsc, opa, false, true); break;
+            default: rgb565_with_mask(dsc, opa, true, true); break;
+        }
+    }
+    return LV_RESULT_OK;
+}
+
+lv_result_t blend_dsp_argb8888_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool dest_swapped) {
+    if (dest_swapped) {
+        argb8888_blend(dsc, dsc->mask_buf, dsc->opa, true);
+    } else {
+        argb8888_blend(dsc, dsc->mask_buf, dsc->opa, false);
+    }
+    return LV_RESULT_OK;
+}
+
+lv_result_t blend_dsp_al88_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool dest_swapped) {
+    if (dest_swapped) {
+        al88_blend(dsc, dsc->mask_buf, dsc->opa, true);
+    } else {
+        al88_blend(dsc, dsc->mask_buf, dsc->opa, false);
+    }
+    return LV_RESULT_OK;
+}
+
+#endif /*BLEND_DSP*/
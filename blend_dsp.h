@@ -0,0 +1,136 @@
+/**
+ * @file blend_dsp.h
+ * @brief RGB565 blending with the DSP extension of the Cortex-M33
+ *
+ * The RP2350 has no MVE, so LVGL's Helium blending can't be used, but the
+ * DSP extension of its Cortex-M33 handles two 16-bit lanes per instruction.
+ * blend_dsp.c implements the blending to RGB565 and RGB565_SWAPPED draw
+ * buffers that gains the most from it:
+ *
+ *  - color fill with opacity, with a mask, and with both
+ *  - RGB565 and RGB565_SWAPPED images with opacity and/or mask
+ *  - ARGB8888 and AL88 images
+ *
+ * The results are bit-exact with LVGL's scalar blending. The other cases
+ * (plain fill, opaque copy, other formats and blend modes) stay scalar.
+ *
+ * lv_conf.h plugs it into the SW renderer:
+ *
+ *     #define LV_USE_DRAW_SW_ASM              LV_DRAW_SW_ASM_CUSTOM
+ *     #define LV_DRAW_SW_ASM_CUSTOM_INCLUDE   "blend_asm.h"
+ *
+ * LVGL includes it in its blend files through blend_asm.h. The firmware
+ * uses it only with DISP_BLEND_DSP set in lv_conf.h (off by default, the
+ * native path hasn't been verified on the device yet). Without the DSP
+ * extension (the host builds) it defines nothing, unless
+ * BLEND_DSP_EMULATE is defined: then the kernels run on the portable C
+ * emulation of the instructions (blend_dsp_intrin.h).
+ */
+
+#ifndef BLEND_DSP_H
+#define BLEND_DSP_H
+
+/* lv_conf.h, for DISP_BLEND_DSP */
+#include "src/misc/lv_types.h"
+
+#if (defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP && defined(DISP_BLEND_DSP) && DISP_BLEND_DSP) || \
+    defined(BLEND_DSP_EMULATE)
+#define BLEND_DSP 1
+#else
+#define BLEND_DSP 0
+#endif
+
+#if BLEND_DSP
+
+#include <stdbool.h>
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+/**
+ * @brief Blend a color to an RGB565 or RGB565_SWAPPED buffer with opacity and/or mask
+ * @param dsc Fill descriptor of LVGL's SW renderer
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code (plain fill)
+ */
+lv_result_t blend_dsp_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc, bool dest_swapped);
+
+/**
+ * @brief Blend an RGB565 or RGB565_SWAPPED image to an RGB565 or RGB565_SWAPPED buffer
+ * @param dsc Image descriptor of LVGL's SW renderer, normal blend mode
+ * @param src_swapped true: the image is RGB565_SWAPPED
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code (plain copy)
+ */
+lv_result_t blend_dsp_rgb565_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool src_swapped, bool dest_swapped);
+
+/**
+ * @brief Blend an ARGB8888 image to an RGB565 or RGB565_SWAPPED buffer
+ * @param dsc Image descriptor of LVGL's SW renderer, normal blend mode
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK
+ */
+lv_result_t blend_dsp_argb8888_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool dest_swapped);
+
+/**
+ * @brief Blend an AL88 image to an RGB565 or RGB565_SWAPPED buffer
+ * @param dsc Image descriptor of LVGL's SW renderer, normal blend mode
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK
+ */
+lv_result_t blend_dsp_al88_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool dest_swapped);
+
+/*===========================================
+ * LVGL Blend Hooks
+ *===========================================*/
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)      blend_dsp_color_to_rgb565(dsc, false)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)     blend_dsp_color_to_rgb565(dsc, false)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)  blend_dsp_color_to_rgb565(dsc, false)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)      blend_dsp_rgb565_to_rgb565(dsc, false, false)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)     blend_dsp_rgb565_to_rgb565(dsc, false, false)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  blend_dsp_rgb565_to_rgb565(dsc, false, false)
+
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565(dsc)               blend_dsp_rgb565_to_rgb565(dsc, true, false)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)      blend_dsp_rgb565_to_rgb565(dsc, true, false)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)     blend_dsp_rgb565_to_rgb565(dsc, true, false)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  blend_dsp_rgb565_to_rgb565(dsc, true, false)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc)                 blend_dsp_argb8888_to_rgb565(dsc, false)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)        blend_dsp_argb8888_to_rgb565(dsc, false)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)       blend_dsp_argb8888_to_rgb565(dsc, false)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)    blend_dsp_argb8888_to_rgb565(dsc, false)
+
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565(dsc)                 blend_dsp_al88_to_rgb565(dsc, false)
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)        blend_dsp_al88_to_rgb565(dsc, false)
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)       blend_dsp_al88_to_rgb565(dsc, false)
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)    blend_dsp_al88_to_rgb565(dsc, false)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_WITH_OPA(dsc)      blend_dsp_color_to_rgb565(dsc, true)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_WITH_MASK(dsc)     blend_dsp_color_to_rgb565(dsc, true)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  blend_dsp_color_to_rgb565(dsc, true)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)               blend_dsp_rgb565_to_rgb565(dsc, false, true)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)      blend_dsp_rgb565_to_rgb565(dsc, false, true)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)     blend_dsp_rgb565_to_rgb565(dsc, false, true)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  blend_dsp_rgb565_to_rgb565(dsc, false, true)
+
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)      blend_dsp_rgb565_to_rgb565(dsc, true, true)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)     blend_dsp_rgb565_to_rgb565(dsc, true, true)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  blend_dsp_rgb565_to_rgb565(dsc, true, true)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)                 blend_dsp_argb8888_to_rgb565(dsc, true)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)        blend_dsp_argb8888_to_rgb565(dsc, true)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)       blend_dsp_argb8888_to_rgb565(dsc, true)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)    blend_dsp_argb8888_to_rgb565(dsc, true)
+
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)                 blend_dsp_al88_to_rgb565(dsc, true)
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)        blend_dsp_al88_to_rgb565(dsc, true)
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)       blend_dsp_al88_to_rgb565(dsc, true)
+#define LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)    blend_dsp_al88_to_rgb565(dsc, true)
+
+#endif /*BLEND_DSP*/
+
+#endif /* BLEND_DSP_H */
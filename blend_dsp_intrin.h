@@ -0,0 +1,94 @@
+/**
+ * @file blend_dsp_intrin.h
+ * @brief The DSP extension instructions used by blend_dsp.c
+ *
+ * On cores with the DSP extension (Cortex-M33 of the RP2350, __ARM_FEATURE_DSP)
+ * these map to the ACLE intrinsics of arm_acle.h, one instruction each.
+ * Elsewhere they are emulated in portable C with the same results, so the
+ * kernels can be built and checked against the scalar blending on the host
+ * (host/test_blend_dsp).
+ *
+ * Only the few operations of the kernels are provided. A 32-bit word holds
+ * two 16-bit lanes: lane 0 in the low half, lane 1 in the high half.
+ */
+
+#ifndef BLEND_DSP_INTRIN_H
+#define BLEND_DSP_INTRIN_H
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP && !defined(BLEND_DSP_EMULATE)
+#define BLEND_DSP_NATIVE 1
+#include <arm_acle.h>
+#else
+#define BLEND_DSP_NATIVE 0
+#endif
+
+#if BLEND_DSP_NATIVE
+
+/* UXTB16: bytes 0 and 2 zero-extended to the two lanes */
+static inline uint32_t dsp_uxtb16(uint32_t x) {
+    return (uint32_t)__uxtb16(x);
+}
+
+/* UXTB16 ROR #8: bytes 1 and 3 zero-extended to the two lanes */
+static inline uint32_t dsp_uxtb16_ror8(uint32_t x) {
+    return (uint32_t)__uxtb16(__ror(x, 8));
+}
+
+/* REV16: swap the bytes of both lanes */
+static inline uint32_t dsp_rev16(uint32_t x) {
+    return __rev16(x);
+}
+
+/* SMUAD: lane0(a) * lane0(b) + lane1(a) * lane1(b), signed lanes */
+static inline uint32_t dsp_smuad(uint32_t a, uint32_t b) {
+    return (uint32_t)__smuad((int16x2_t)a, (int16x2_t)b);
+}
+
+/* PKHBT: lane 0 of `lo`, lane 0 of `hi` shifted left by `sh` as lane 1 */
+#define dsp_pkhbt(lo, hi, sh) \
+    __extension__({ \
+        uint32_t _r; \
+        __asm("pkhbt %0, %1, %2, lsl %3" : "=r"(_r) : "r"((uint32_t)(lo)), "r"((uint32_t)(hi)), "I"(sh)); \
+        _r; \
+    })
+
+#else /*BLEND_DSP_NATIVE*/
+
+static inline uint32_t dsp_uxtb16(uint32_t x) {
+    return x & 0x00FF00FFu;
+}
+
+static inline uint32_t dsp_uxtb16_ror8(uint32_t x) {
+    return (x >> 8) & 0x00FF00FFu;
+}
+
+static inline uint32_t dsp_rev16(uint32_t x) {
+    return ((x >> 8) & 0x00FF00FFu) | ((x << 8) & 0xFF00FF00u);
+}
+
+static inline uint32_t dsp_smuad(uint32_t a, uint32_t b) {
+    int32_t lo = (int32_t)(int16_t)(a & 0xFFFF) * (int16_t)(b & 0xFFFF);
+    int32_t hi = (int32_t)(int16_t)(a >> 16) * (int16_t)(b >> 16);
+    return (uint32_t)(lo + hi);
+}
+
+#define dsp_pkhbt(lo, hi, sh) \
+    (((uint32_t)(lo) & 0xFFFFu) | (((uint32_t)(hi) << (sh)) & 0xFFFF0000u))
+
+#endif /*BLEND_DSP_NATIVE*/
+
+/* Unaligned-safe word access, a single LDR/STR on the Cortex-M33 */
+static inline uint32_t dsp_load32(const void *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void dsp_store32(void *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+#endif /* BLEND_DSP_INTRIN_H */
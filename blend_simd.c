@@ -0,0 +1,308 @@
+/**
+ * @file blend_simd.c
+ * @brief SSE2 / AVX2 blending for the x86 host builds
+ *
+ * Every kernel reproduces LVGL's scalar arithmetic lane by lane:
+ *
+ *  - RGB565 destinations: lv_color_16_16_mix() is, with m = (mix + 4) >> 3,
+ *    bg + (((fg - bg) * m) >> 5) per channel (an arithmetic shift), in the
+ *    16-bit lanes of 8 (SSE2) or 16 (AVX2) pixels.
+ *  - ARGB8888 sources to RGB565: lv_color_24_16_mix() is
+ *    (src * mix + dest * (255 - mix)) >> 8 per channel; its shortcuts for
+ *    mix 0 and 255 are the same formula with 256 in place of 255.
+ *  - ARGB8888 destinations: lv_color_32_32_mix() on an opaque destination is
+ *    LV_UDIV255(fg * a + bg * (255 - a)) per channel: a 16-bit multiply-high
+ *    by 0x8081 and a shift. Vectors with a semi-transparent destination
+ *    pixel go through the scalar formula, it needs a division.
+ *
+ * The opacity and mask combine to the mix with LV_OPA_MIX2() and
+ * LV_OPA_MIX3() exactly as in the scalar code, in the same branches.
+ *
+ * blend_simd_kernels.h holds the kernels, written once for both widths.
+ */
+
+#include "blend_simd.h"
+
+#if BLEND_SIMD
+
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+#include "lvgl.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+static blend_simd_level_t max_level;
+static blend_simd_level_t level;
+
+static const char *level_names[] = {"scalar", "sse2", "avx2"};
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static inline uint16_t *row_next(const void *buf, int32_t stride) {
+    return (uint16_t *)((uint8_t *)buf + stride);
+}
+
+/* lv_color_mix32() of the color channels, `a` 3..252 */
+static inline uint32_t mix32_channels(uint32_t fg, uint32_t bg, uint32_t a) {
+    uint32_t res = 0;
+    for (uint32_t shift = 0; shift < 24; shift += 8) {
+        uint32_t f = (fg >> shift) & 0xFF;
+        uint32_t b = (bg >> shift) & 0xFF;
+        res |= LV_UDIV255(f * a + b * (255 - a)) << shift;
+    }
+    return res;
+}
+
+/* lv_color_32_32_mix() of one pixel */
+static uint32_t mix32_px(uint32_t fg, uint32_t bg) {
+    uint32_t fa = fg >> 24;
+    uint32_t ba = bg >> 24;
+
+    if (fa >= LV_OPA_MAX || ba <= LV_OPA_MIN) {
+        return fg;
+    }
+    if (fa <= LV_OPA_MIN) {
+        return bg;
+    }
+    if (ba == 255) {
+        return mix32_channels(fg, bg, fa) | 0xFF000000u;
+    }
+
+    /* Both semi-transparent: the mix of the alpha ratio, the alpha of the compositing */
+    uint32_t res_a = 255 - LV_OPA_MIX2(255 - fa, 255 - ba);
+    uint32_t ratio = fa * 255 / res_a;
+    uint32_t res;
+    if (ratio >= LV_OPA_MAX) {
+        res = fg;
+    } else if (ratio <= LV_OPA_MIN) {
+        res = bg;
+    } else {
+        res = mix32_channels(fg, bg, ratio);
+    }
+    return (res & 0x00FFFFFFu) | (res_a << 24);
+}
+
+/*-------------------------------------------
+ * SSE2
+ *-------------------------------------------*/
+
+static inline __attribute__((target("sse2"))) __m128i load_mask32_sse2(const uint8_t *mask) {
+    int32_t m;
+    memcpy(&m, mask, sizeof(m));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(m), zero), zero);
+}
+
+#define SIMD_FN(name)       name##_sse2
+#define SIMD_ATTR           __attribute__((target("sse2")))
+#define vec_t               __m128i
+#define VEC_PX16            8
+#define VEC_PX32            4
+#define VEC_MASK_ALL        0xFFFF
+#define v_load(p)           _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define v_store(p, v)       _mm_storeu_si128((__m128i *)(void *)(p), v)
+#define v_zero()            _mm_setzero_si128()
+#define v_set16(x)          _mm_set1_epi16((short)(x))
+#define v_set32(x)          _mm_set1_epi32((int)(x))
+#define v_add16             _mm_add_epi16
+#define v_sub16             _mm_sub_epi16
+#define v_mullo16           _mm_mullo_epi16
+#define v_mulhi16           _mm_mulhi_epu16
+#define v_srli16            _mm_srli_epi16
+#define v_slli16            _mm_slli_epi16
+#define v_srai16            _mm_srai_epi16
+#define v_srli32            _mm_srli_epi32
+#define v_slli32            _mm_slli_epi32
+#define v_srai32            _mm_srai_epi32
+#define v_and               _mm_and_si128
+#define v_or                _mm_or_si128
+#define v_andnot            _mm_andnot_si128
+#define v_cmpeq16           _mm_cmpeq_epi16
+#define v_cmpeq32           _mm_cmpeq_epi32
+#define v_cmpgt32           _mm_cmpgt_epi32
+#define v_movemask8         _mm_movemask_epi8
+#define v_unpacklo8         _mm_unpacklo_epi8
+#define v_unpackhi8         _mm_unpackhi_epi8
+#define v_packus16          _mm_packus_epi16
+#define v_packs32           _mm_packs_epi32
+#define v_order32(v)        (v)
+#define v_alpha16(v)        _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xFF), 0xFF)
+#define v_load_mask16(p)    _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(const void *)(p)), _mm_setzero_si128())
+#define v_load_mask32(p)    load_mask32_sse2(p)
+
+#include "blend_simd_kernels.h"
+
+#undef SIMD_FN
+#undef SIMD_ATTR
+#undef vec_t
+#undef VEC_PX16
+#undef VEC_PX32
+#undef VEC_MASK_ALL
+#undef v_load
+#undef v_store
+#undef v_zero
+#undef v_set16
+#undef v_set32
+#undef v_add16
+#undef v_sub16
+#undef v_mullo16
+#undef v_mulhi16
+#undef v_srli16
+#undef v_slli16
+#undef v_srai16
+#undef v_srli32
+#undef v_slli32
+#undef v_srai32
+#undef v_and
+#undef v_or
+#undef v_andnot
+#undef v_cmpeq16
+#undef v_cmpeq32
+#undef v_cmpgt32
+#undef v_movemask8
+#undef v_unpacklo8
+#undef v_unpackhi8
+#undef v_packus16
+#undef v_packs32
+#undef v_order32
+#undef v_alpha16
+#undef v_load_mask16
+#undef v_load_mask32
+
+/*-------------------------------------------
+ * AVX2
+ *-------------------------------------------*/
+
+#define SIMD_FN(name)       name##_avx2
+#define SIMD_ATTR           __attribute__((target("avx2")))
+#define vec_t               __m256i
+#define VEC_PX16            16
+#define VEC_PX32            8
+#define VEC_MASK_ALL        (-1)
+#define v_load(p)           _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define v_store(p, v)       _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#define v_zero()            _mm256_setzero_si256()
+#define v_set16(x)          _mm256_set1_epi16((short)(x))
+#define v_set32(x)          _mm256_set1_epi32((int)(x))
+#define v_add16             _mm256_add_epi16
+#define v_sub16             _mm256_sub_epi16
+#define v_mullo16           _mm256_mullo_epi16
+#define v_mulhi16           _mm256_mulhi_epu16
+#define v_srli16            _mm256_srli_epi16
+#define v_slli16            _mm256_slli_epi16
+#define v_srai16            _mm256_srai_epi16
+#define v_srli32            _mm256_srli_epi32
+#define v_slli32            _mm256_slli_epi32
+#define v_srai32            _mm256_srai_epi32
+#define v_and               _mm256_and_si256
+#define v_or                _mm256_or_si256
+#define v_andnot            _mm256_andnot_si256
+#define v_cmpeq16           _mm256_cmpeq_epi16
+#define v_cmpeq32           _mm256_cmpeq_epi32
+#define v_cmpgt32           _mm256_cmpgt_epi32
+#define v_movemask8         _mm256_movemask_epi8
+#define v_unpacklo8         _mm256_unpacklo_epi8
+#define v_unpackhi8         _mm256_unpackhi_epi8
+#define v_packus16          _mm256_packus_epi16
+#define v_packs32           _mm256_packs_epi32
+/* The packs work in the 128-bit halves: put the 64-bit quarters back in pixel order */
+#define v_order32(v)        _mm256_permute4x64_epi64(v, 0xD8)
+#define v_alpha16(v)        _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xFF), 0xFF)
+#define v_load_mask16(p)    _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(const void *)(p)))
+#define v_load_mask32(p)    _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(const void *)(p)))
+
+#include "blend_simd_kernels.h"
+
+/*-------------------------------------------
+ * CPU detection
+ *-------------------------------------------*/
+
+__attribute__((constructor)) static void blend_simd_init(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        max_level = BLEND_SIMD_AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        max_level = BLEND_SIMD_SSE2;
+    } else {
+        max_level = BLEND_SIMD_SCALAR;
+    }
+    level = max_level;
+
+    const char *env = getenv("BLEND_SIMD");
+    if (env) {
+        for (int i = BLEND_SIMD_SCALAR; i <= BLEND_SIMD_AVX2; i++) {
+            if (strcmp(env, level_names[i]) == 0) {
+                blend_simd_set_level((blend_simd_level_t)i);
+            }
+        }
+    }
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+blend_simd_level_t blend_simd_get_level(void) {
+    return level;
+}
+
+blend_simd_level_t blend_simd_set_level(blend_simd_level_t new_level) {
+    level = new_level < max_level ? new_level : max_level;
+    return level;
+}
+
+blend_simd_level_t blend_simd_get_max_level(void) {
+    return max_level;
+}
+
+const char *blend_simd_level_name(blend_simd_level_t l) {
+    return l <= BLEND_SIMD_AVX2 ? level_names[l] : "?";
+}
+
+lv_result_t blend_simd_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc, bool dest_swapped) {
+    switch (level) {
+        case BLEND_SIMD_AVX2: return color_to_rgb565_avx2(dsc, dest_swapped);
+        case BLEND_SIMD_SSE2: return color_to_rgb565_sse2(dsc, dest_swapped);
+        default: return LV_RESULT_INVALID;
+    }
+}
+
+lv_result_t blend_simd_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t *dsc) {
+    switch (level) {
+        case BLEND_SIMD_AVX2: return color_to_argb8888_avx2(dsc);
+        case BLEND_SIMD_SSE2: return color_to_argb8888_sse2(dsc);
+        default: return LV_RESULT_INVALID;
+    }
+}
+
+lv_result_t blend_simd_rgb565_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool src_swapped, bool dest_swapped) {
+    switch (level) {
+        case BLEND_SIMD_AVX2: return rgb565_to_rgb565_avx2(dsc, src_swapped, dest_swapped);
+        case BLEND_SIMD_SSE2: return rgb565_to_rgb565_sse2(dsc, src_swapped, dest_swapped);
+        default: return LV_RESULT_INVALID;
+    }
+}
+
+lv_result_t blend_simd_argb8888_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool dest_swapped) {
+    switch (level) {
+        case BLEND_SIMD_AVX2: return argb8888_to_rgb565_avx2(dsc, dest_swapped);
+        case BLEND_SIMD_SSE2: return argb8888_to_rgb565_sse2(dsc, dest_swapped);
+        default: return LV_RESULT_INVALID;
+    }
+}
+
+lv_result_t blend_simd_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t *dsc) {
+    switch (level) {
+        case BLEND_SIMD_AVX2: return argb8888_to_argb8888_avx2(dsc);
+        case BLEND_SIMD_SSE2: return argb8888_to_argb8888_sse2(dsc);
+        default: return LV_RESULT_INVALID;
+    }
+}
+
+#endif /*BLEND_SIMD*/
@@ -0,0 +1,167 @@
+/**
+ * @file blend_simd.h
+ * @brief SSE2 / AVX2 blending for the x86 host builds
+ *
+ * The simulator, the screenshot tests and the host benchmarks render with
+ * LVGL's SW renderer too. blend_simd.c gives them the SIMD versions of the
+ * blends they spend the most time in:
+ *
+ *  - color fill to RGB565, RGB565_SWAPPED and ARGB8888 with opacity and/or
+ *    mask
+ *  - RGB565 and RGB565_SWAPPED images to RGB565 and RGB565_SWAPPED with
+ *    opacity and/or mask, and the opaque copy between the byte orders
+ *  - ARGB8888 images to RGB565, RGB565_SWAPPED and ARGB8888
+ *
+ * The results are bit-exact with LVGL's scalar blending, which still handles
+ * the other formats and blend modes, the plain fills and the plain copies
+ * in the same byte order: those are stores at the speed of the memory.
+ *
+ * The kernels are built for SSE2 and for AVX2 and chosen at startup from
+ * the CPU features. The BLEND_SIMD environment variable ("scalar", "sse2"
+ * or "avx2") selects a lower level at startup, blend_simd_set_level()
+ * changes it at run time, e.g. to compare with the scalar code.
+ *
+ * blend_asm.h includes this header in LVGL's blend files.
+ */
+
+#ifndef BLEND_SIMD_H
+#define BLEND_SIMD_H
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(BLEND_SIMD_DISABLE)
+#define BLEND_SIMD 1
+#else
+#define BLEND_SIMD 0
+#endif
+
+#if BLEND_SIMD
+
+#include <stdbool.h>
+#include "src/misc/lv_types.h"
+
+/*===========================================
+ * Public Types
+ *===========================================*/
+
+typedef enum {
+    BLEND_SIMD_SCALAR,      /* LVGL's scalar code */
+    BLEND_SIMD_SSE2,
+    BLEND_SIMD_AVX2,
+} blend_simd_level_t;
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+/**
+ * @brief The kernels in use
+ */
+blend_simd_level_t blend_simd_get_level(void);
+
+/**
+ * @brief Select the kernels, not above what the CPU supports
+ * @param level Highest level to use
+ * @return The level in use
+ */
+blend_simd_level_t blend_simd_set_level(blend_simd_level_t level);
+
+/**
+ * @brief Highest level the CPU supports
+ */
+blend_simd_level_t blend_simd_get_max_level(void);
+
+/**
+ * @brief Name of a level: "scalar", "sse2" or "avx2"
+ */
+const char *blend_simd_level_name(blend_simd_level_t level);
+
+/**
+ * @brief Blend a color to an RGB565 or RGB565_SWAPPED buffer
+ * @param dsc Fill descriptor of LVGL's SW renderer
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code (plain fill)
+ */
+lv_result_t blend_simd_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc, bool dest_swapped);
+
+/**
+ * @brief Blend a color to an ARGB8888 buffer
+ * @param dsc Fill descriptor of LVGL's SW renderer
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code (plain fill)
+ */
+lv_result_t blend_simd_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t *dsc);
+
+/**
+ * @brief Blend an RGB565 or RGB565_SWAPPED image to an RGB565 or RGB565_SWAPPED buffer
+ * @param dsc Image descriptor of LVGL's SW renderer, normal blend mode
+ * @param src_swapped true: the image is RGB565_SWAPPED
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code (plain copy)
+ */
+lv_result_t blend_simd_rgb565_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool src_swapped, bool dest_swapped);
+
+/**
+ * @brief Blend an ARGB8888 image to an RGB565 or RGB565_SWAPPED buffer
+ * @param dsc Image descriptor of LVGL's SW renderer, normal blend mode
+ * @param dest_swapped true: the destination is RGB565_SWAPPED
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code
+ */
+lv_result_t blend_simd_argb8888_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc, bool dest_swapped);
+
+/**
+ * @brief Blend an ARGB8888 image to an ARGB8888 buffer
+ * @param dsc Image descriptor of LVGL's SW renderer, normal blend mode
+ * @return LV_RESULT_OK if blended, LV_RESULT_INVALID to use the scalar code
+ */
+lv_result_t blend_simd_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t *dsc);
+
+/*===========================================
+ * LVGL Blend Hooks
+ *===========================================*/
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)      blend_simd_color_to_rgb565(dsc, false)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)     blend_simd_color_to_rgb565(dsc, false)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)  blend_simd_color_to_rgb565(dsc, false)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)      blend_simd_rgb565_to_rgb565(dsc, false, false)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)     blend_simd_rgb565_to_rgb565(dsc, false, false)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  blend_simd_rgb565_to_rgb565(dsc, false, false)
+
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565(dsc)               blend_simd_rgb565_to_rgb565(dsc, true, false)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)      blend_simd_rgb565_to_rgb565(dsc, true, false)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)     blend_simd_rgb565_to_rgb565(dsc, true, false)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  blend_simd_rgb565_to_rgb565(dsc, true, false)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc)                 blend_simd_argb8888_to_rgb565(dsc, false)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)        blend_simd_argb8888_to_rgb565(dsc, false)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)       blend_simd_argb8888_to_rgb565(dsc, false)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)    blend_simd_argb8888_to_rgb565(dsc, false)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_WITH_OPA(dsc)      blend_simd_color_to_rgb565(dsc, true)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_WITH_MASK(dsc)     blend_simd_color_to_rgb565(dsc, true)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  blend_simd_color_to_rgb565(dsc, true)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)               blend_simd_rgb565_to_rgb565(dsc, false, true)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)      blend_simd_rgb565_to_rgb565(dsc, false, true)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)     blend_simd_rgb565_to_rgb565(dsc, false, true)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  blend_simd_rgb565_to_rgb565(dsc, false, true)
+
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)      blend_simd_rgb565_to_rgb565(dsc, true, true)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)     blend_simd_rgb565_to_rgb565(dsc, true, true)
+#define LV_DRAW_SW_RGB565_SWAPPED_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  blend_simd_rgb565_to_rgb565(dsc, true, true)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)                 blend_simd_argb8888_to_rgb565(dsc, true)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)        blend_simd_argb8888_to_rgb565(dsc, true)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)       blend_simd_argb8888_to_rgb565(dsc, true)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)    blend_simd_argb8888_to_rgb565(dsc, true)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888_WITH_OPA(dsc)        blend_simd_color_to_argb8888(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888_WITH_MASK(dsc)       blend_simd_color_to_argb8888(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888_MIX_MASK_OPA(dsc)    blend_simd_color_to_argb8888(dsc)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_ARGB8888(dsc)               blend_simd_argb8888_to_argb8888(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_ARGB8888_WITH_OPA(dsc)      blend_simd_argb8888_to_argb8888(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_ARGB8888_WITH_MASK(dsc)     blend_simd_argb8888_to_argb8888(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_ARGB8888_MIX_MASK_OPA(dsc)  blend_simd_argb8888_to_argb8888(dsc)
+
+#endif /*BLEND_SIMD*/
+
+#endif /* BLEND_SIMD_H */
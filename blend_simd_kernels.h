@@ -0,0 +1,441 @@
+/**
+ * @file blend_simd_kernels.h
+ * @brief The kernels of blend_simd.c for one vector width
+ *
+ * blend_simd.c includes this file twice: with the SSE2 definitions of vec_t
+ * and the v_*() operations, and with the AVX2 ones. SIMD_FN() gives the
+ * functions of each width their own names, SIMD_ATTR the target of the
+ * compiler. Rows are blended a vector at a time; the pixels left at the end
+ * of a row go through the same vector code on a copy in a stack buffer.
+ */
+
+/*-------------------------------------------
+ * RGB565
+ *-------------------------------------------*/
+
+static inline SIMD_ATTR vec_t SIMD_FN(swap16)(vec_t v) {
+    return v_or(v_slli16(v, 8), v_srli16(v, 8));
+}
+
+static inline SIMD_ATTR vec_t SIMD_FN(load565)(const uint16_t *p, bool swapped) {
+    vec_t v = v_load(p);
+    return swapped ? SIMD_FN(swap16)(v) : v;
+}
+
+static inline SIMD_ATTR void SIMD_FN(store565)(uint16_t *p, vec_t v, bool swapped) {
+    v_store(p, swapped ? SIMD_FN(swap16)(v) : v);
+}
+
+/* lv_color_16_16_mix() of each lane: bg + ((fg - bg) * m) >> 5 per channel, `m` 0..32 */
+static inline SIMD_ATTR vec_t SIMD_FN(mix565)(vec_t fg, vec_t bg, vec_t m) {
+    vec_t c5 = v_set16(0x1F);
+    vec_t c6 = v_set16(0x3F);
+    vec_t bg_r = v_srli16(bg, 11);
+    vec_t bg_g = v_and(v_srli16(bg, 5), c6);
+    vec_t bg_b = v_and(bg, c5);
+    vec_t r = v_add16(bg_r, v_srai16(v_mullo16(v_sub16(v_srli16(fg, 11), bg_r), m), 5));
+    vec_t g = v_add16(bg_g, v_srai16(v_mullo16(v_sub16(v_and(v_srli16(fg, 5), c6), bg_g), m), 5));
+    vec_t b = v_add16(bg_b, v_srai16(v_mullo16(v_sub16(v_and(fg, c5), bg_b), m), 5));
+    return v_or(v_or(v_slli16(r, 11), v_slli16(g, 5)), b);
+}
+
+/* The factor of lv_color_16_16_mix() from the mix of each lane */
+static inline SIMD_ATTR vec_t SIMD_FN(mix_factor)(vec_t mix) {
+    return v_srli16(v_add16(mix, v_set16(4)), 3);
+}
+
+/* The mix of VEC_PX16 pixels: the mask, LV_OPA_MIX2() of the mask and `opa` if it's below 255 */
+static inline SIMD_ATTR vec_t SIMD_FN(mask_mix)(const uint8_t *mask, uint32_t opa) {
+    vec_t mix = v_load_mask16(mask);
+    return opa < 255 ? v_srli16(v_mullo16(mix, v_set16(opa)), 8) : mix;
+}
+
+/* VEC_PX16 pixels of the fill, `mask` NULL: `opa` only */
+static inline SIMD_ATTR void SIMD_FN(color_rgb565_vec)(uint16_t *dest, const uint8_t *mask, vec_t fg, uint32_t opa,
+                                                       bool swapped) {
+    vec_t m;
+    if (mask == NULL) {
+        m = SIMD_FN(mix_factor)(v_set16(opa));
+    } else {
+        vec_t mix = SIMD_FN(mask_mix)(mask, opa);
+        if (v_movemask8(v_cmpeq16(mix, v_zero())) == VEC_MASK_ALL) {
+            return;
+        }
+        if (v_movemask8(v_cmpeq16(mix, v_set16(0xFF))) == VEC_MASK_ALL) {
+            SIMD_FN(store565)(dest, fg, swapped);
+            return;
+        }
+        m = SIMD_FN(mix_factor)(mix);
+    }
+    SIMD_FN(store565)(dest, SIMD_FN(mix565)(fg, SIMD_FN(load565)(dest, swapped), m), swapped);
+}
+
+/* `opa` 255: mask only */
+static void SIMD_ATTR SIMD_FN(color_rgb565)(lv_draw_sw_blend_fill_dsc_t *dsc, uint32_t opa, bool swapped) {
+    vec_t fg = v_set16(lv_color_to_u16(dsc->color));
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        for (; x + VEC_PX16 <= w; x += VEC_PX16) {
+            SIMD_FN(color_rgb565_vec)(&dest[x], mask ? &mask[x] : NULL, fg, opa, swapped);
+        }
+        if (x < w) {
+            uint16_t d[VEC_PX16];
+            uint8_t mk[VEC_PX16] = {0};
+            size_t n = (size_t)(w - x);
+            memcpy(d, &dest[x], n * 2);
+            if (mask) {
+                memcpy(mk, &mask[x], n);
+            }
+            SIMD_FN(color_rgb565_vec)(d, mask ? mk : NULL, fg, opa, swapped);
+            memcpy(&dest[x], d, n * 2);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+static void SIMD_ATTR SIMD_FN(rgb565_swap_copy)(lv_draw_sw_blend_image_dsc_t *dsc) {
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint16_t *src = dsc->src_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        for (; x + VEC_PX16 <= w; x += VEC_PX16) {
+            v_store(&dest[x], SIMD_FN(swap16)(v_load(&src[x])));
+        }
+        for (; x < w; x++) {
+            dest[x] = (uint16_t)((src[x] >> 8) | (src[x] << 8));
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src = row_next(src, dsc->src_stride);
+    }
+}
+
+/* VEC_PX16 pixels of the image, `mask` NULL: `opa` only */
+static inline SIMD_ATTR void SIMD_FN(rgb565_vec)(uint16_t *dest, const uint16_t *src, const uint8_t *mask,
+                                                 uint32_t opa, bool src_swapped, bool dest_swapped) {
+    vec_t m;
+    if (mask == NULL) {
+        m = SIMD_FN(mix_factor)(v_set16(opa));
+    } else {
+        vec_t mix = SIMD_FN(mask_mix)(mask, opa);
+        if (v_movemask8(v_cmpeq16(mix, v_zero())) == VEC_MASK_ALL) {
+            return;
+        }
+        if (v_movemask8(v_cmpeq16(mix, v_set16(0xFF))) == VEC_MASK_ALL) {
+            SIMD_FN(store565)(dest, SIMD_FN(load565)(src, src_swapped), dest_swapped);
+            return;
+        }
+        m = SIMD_FN(mix_factor)(mix);
+    }
+    vec_t fg = SIMD_FN(load565)(src, src_swapped);
+    SIMD_FN(store565)(dest, SIMD_FN(mix565)(fg, SIMD_FN(load565)(dest, dest_swapped), m), dest_swapped);
+}
+
+/* `opa` 255: mask only */
+static void SIMD_ATTR SIMD_FN(rgb565_rgb565)(lv_draw_sw_blend_image_dsc_t *dsc, uint32_t opa, bool src_swapped,
+                                             bool dest_swapped) {
+    int32_t w = dsc->dest_w;
+    uint16_t *dest = dsc->dest_buf;
+    const uint16_t *src = dsc->src_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        for (; x + VEC_PX16 <= w; x += VEC_PX16) {
+            SIMD_FN(rgb565_vec)(&dest[x], &src[x], mask ? &mask[x] : NULL, opa, src_swapped, dest_swapped);
+        }
+        if (x < w) {
+            uint16_t d[VEC_PX16];
+            uint16_t s[VEC_PX16] = {0};
+            uint8_t mk[VEC_PX16] = {0};
+            size_t n = (size_t)(w - x);
+            memcpy(d, &dest[x], n * 2);
+            memcpy(s, &src[x], n * 2);
+            if (mask) {
+                memcpy(mk, &mask[x], n);
+            }
+            SIMD_FN(rgb565_vec)(d, s, mask ? mk : NULL, opa, src_swapped, dest_swapped);
+            memcpy(&dest[x], d, n * 2);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src = row_next(src, dsc->src_stride);
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+/* VEC_PX16 ARGB8888 pixels, the mix as LVGL's scalar code computes it from the alpha */
+static inline SIMD_ATTR void SIMD_FN(argb8888_rgb565_vec)(uint16_t *dest, const uint8_t *src, const uint8_t *mask,
+                                                          uint32_t opa, bool swapped) {
+    vec_t s0 = v_load(src);
+    vec_t s1 = v_load(src + sizeof(vec_t));
+    /* Green-blue and alpha-red of each pixel in the 16-bit lanes */
+    vec_t gb = v_order32(v_packs32(v_srai32(v_slli32(s0, 16), 16), v_srai32(v_slli32(s1, 16), 16)));
+    vec_t ar = v_order32(v_packs32(v_srai32(s0, 16), v_srai32(s1, 16)));
+    vec_t c8 = v_set16(0xFF);
+    vec_t mix = v_srli16(ar, 8);
+
+    if (mask) {
+        vec_t am = v_mullo16(mix, v_load_mask16(mask));
+        mix = opa < LV_OPA_MAX ? v_mulhi16(am, v_set16(opa)) : v_srli16(am, 8);
+    } else if (opa < LV_OPA_MAX) {
+        mix = v_srli16(v_mullo16(mix, v_set16(opa)), 8);
+    }
+    vec_t none = v_cmpeq16(mix, v_zero());
+    if (v_movemask8(none) == VEC_MASK_ALL) {
+        return;
+    }
+
+    /* (src * mix + dest * (255 - mix)) >> 8, with 256 instead of 255 for the mix 0 and 255 shortcuts */
+    vec_t ms = v_sub16(mix, v_cmpeq16(mix, c8));
+    vec_t md = v_sub16(v_sub16(c8, mix), none);
+    vec_t bg = SIMD_FN(load565)(dest, swapped);
+    vec_t r = v_add16(v_mullo16(v_srli16(v_and(ar, c8), 3), ms), v_mullo16(v_srli16(bg, 11), md));
+    vec_t g = v_add16(v_mullo16(v_srli16(gb, 10), ms), v_mullo16(v_and(v_srli16(bg, 5), v_set16(0x3F)), md));
+    vec_t b = v_add16(v_mullo16(v_srli16(v_and(gb, c8), 3), ms), v_mullo16(v_and(bg, v_set16(0x1F)), md));
+    vec_t res = v_or(v_or(v_slli16(v_srli16(r, 8), 11), v_slli16(v_srli16(g, 8), 5)), v_srli16(b, 8));
+    SIMD_FN(store565)(dest, res, swapped);
+}
+
+static void SIMD_ATTR SIMD_FN(argb8888_rgb565)(lv_draw_sw_blend_image_dsc_t *dsc, bool swapped) {
+    int32_t w = dsc->dest_w;
+    uint32_t opa = dsc->opa;
+    uint16_t *dest = dsc->dest_buf;
+    const uint8_t *src = dsc->src_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        for (; x + VEC_PX16 <= w; x += VEC_PX16) {
+            SIMD_FN(argb8888_rgb565_vec)(&dest[x], &src[x * 4], mask ? &mask[x] : NULL, opa, swapped);
+        }
+        if (x < w) {
+            uint16_t d[VEC_PX16];
+            uint8_t s[VEC_PX16 * 4] = {0};
+            uint8_t mk[VEC_PX16] = {0};
+            size_t n = (size_t)(w - x);
+            memcpy(d, &dest[x], n * 2);
+            memcpy(s, &src[x * 4], n * 4);
+            if (mask) {
+                memcpy(mk, &mask[x], n);
+            }
+            SIMD_FN(argb8888_rgb565_vec)(d, s, mask ? mk : NULL, opa, swapped);
+            memcpy(&dest[x], d, n * 2);
+        }
+        dest = row_next(dest, dsc->dest_stride);
+        src += dsc->src_stride;
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+/*-------------------------------------------
+ * ARGB8888
+ *-------------------------------------------*/
+
+/* lv_color_32_32_mix() of VEC_PX32 pixels, `fg` with its final alpha */
+static inline SIMD_ATTR vec_t SIMD_FN(mix32)(vec_t fg, vec_t bg) {
+    vec_t fa = v_srli32(fg, 24);
+    vec_t ba = v_srli32(bg, 24);
+    vec_t bg_clear = v_cmpgt32(v_set32(LV_OPA_MIN + 1), ba);
+    unsigned opaque = (unsigned)v_movemask8(v_or(v_cmpeq32(ba, v_set32(0xFF)), bg_clear));
+
+    /* Opaque destination: LV_UDIV255(fg * a + bg * (255 - a)) per channel */
+    vec_t zero = v_zero();
+    vec_t c8 = v_set16(0xFF);
+    vec_t div = v_set16(0x8081);
+    vec_t fl = v_unpacklo8(fg, zero);
+    vec_t fh = v_unpackhi8(fg, zero);
+    vec_t al = v_alpha16(fl);
+    vec_t ah = v_alpha16(fh);
+    vec_t xl = v_add16(v_mullo16(fl, al), v_mullo16(v_unpacklo8(bg, zero), v_sub16(c8, al)));
+    vec_t xh = v_add16(v_mullo16(fh, ah), v_mullo16(v_unpackhi8(bg, zero), v_sub16(c8, ah)));
+    vec_t mixed = v_packus16(v_srli16(v_mulhi16(xl, div), 7), v_srli16(v_mulhi16(xh, div), 7));
+    mixed = v_or(mixed, v_set32(0xFF000000u));
+
+    vec_t take_fg = v_or(v_cmpgt32(fa, v_set32(LV_OPA_MAX - 1)), bg_clear);
+    vec_t take_bg = v_andnot(take_fg, v_cmpgt32(v_set32(LV_OPA_MIN + 1), fa));
+    vec_t res = v_or(v_and(take_fg, fg), v_and(take_bg, bg));
+    res = v_or(res, v_andnot(v_or(take_fg, take_bg), mixed));
+
+    if (opaque != (unsigned)VEC_MASK_ALL) {
+        /* Semi-transparent destination pixels: the ratio of the alphas needs a division */
+        uint32_t f[VEC_PX32];
+        uint32_t b[VEC_PX32];
+        uint32_t r[VEC_PX32];
+        v_store(f, fg);
+        v_store(b, bg);
+        v_store(r, res);
+        for (int i = 0; i < VEC_PX32; i++) {
+            if (!((opaque >> (4 * i)) & 1)) {
+                r[i] = mix32_px(f[i], b[i]);
+            }
+        }
+        res = v_load(r);
+    }
+    return res;
+}
+
+/* The alpha of VEC_PX32 pixels: `alpha` with the mask and `opa` applied as LVGL's scalar code does */
+static inline SIMD_ATTR vec_t SIMD_FN(alpha32)(vec_t alpha, const uint8_t *mask, uint32_t opa) {
+    if (mask) {
+        vec_t am = v_mullo16(alpha, v_load_mask32(mask));
+        return opa < LV_OPA_MAX ? v_mulhi16(am, v_set32(opa)) : v_srli32(am, 8);
+    }
+    return opa < LV_OPA_MAX ? v_srli32(v_mullo16(alpha, v_set32(opa)), 8) : alpha;
+}
+
+/* VEC_PX32 pixels of the fill, `mask` NULL: `opa` only */
+static inline SIMD_ATTR void SIMD_FN(color_argb8888_vec)(uint32_t *dest, const uint8_t *mask, vec_t color,
+                                                         uint32_t opa) {
+    vec_t a = mask ? v_load_mask32(mask) : v_set32(opa);
+    if (mask && opa < LV_OPA_MAX) {
+        a = v_srli32(v_mullo16(a, v_set32(opa)), 8);
+    }
+    v_store(dest, SIMD_FN(mix32)(v_or(color, v_slli32(a, 24)), v_load(dest)));
+}
+
+static void SIMD_ATTR SIMD_FN(color_argb8888)(lv_draw_sw_blend_fill_dsc_t *dsc) {
+    vec_t color = v_set32(lv_color_to_u32(dsc->color) & 0x00FFFFFFu);
+    uint32_t opa = dsc->opa;
+    int32_t w = dsc->dest_w;
+    uint32_t *dest = dsc->dest_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        for (; x + VEC_PX32 <= w; x += VEC_PX32) {
+            SIMD_FN(color_argb8888_vec)(&dest[x], mask ? &mask[x] : NULL, color, opa);
+        }
+        if (x < w) {
+            uint32_t d[VEC_PX32];
+            uint8_t mk[VEC_PX32] = {0};
+            size_t n = (size_t)(w - x);
+            memcpy(d, &dest[x], n * 4);
+            if (mask) {
+                memcpy(mk, &mask[x], n);
+            }
+            SIMD_FN(color_argb8888_vec)(d, mask ? mk : NULL, color, opa);
+            memcpy(&dest[x], d, n * 4);
+        }
+        dest = (uint32_t *)((uint8_t *)dest + dsc->dest_stride);
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+/* VEC_PX32 pixels of the image */
+static inline SIMD_ATTR void SIMD_FN(argb8888_argb8888_vec)(uint32_t *dest, const uint32_t *src, const uint8_t *mask,
+                                                            uint32_t opa) {
+    vec_t s = v_load(src);
+    if (mask || opa < LV_OPA_MAX) {
+        vec_t a = SIMD_FN(alpha32)(v_srli32(s, 24), mask, opa);
+        s = v_or(v_and(s, v_set32(0x00FFFFFFu)), v_slli32(a, 24));
+    }
+    v_store(dest, SIMD_FN(mix32)(s, v_load(dest)));
+}
+
+static void SIMD_ATTR SIMD_FN(argb8888_argb8888)(lv_draw_sw_blend_image_dsc_t *dsc) {
+    uint32_t opa = dsc->opa;
+    int32_t w = dsc->dest_w;
+    uint32_t *dest = dsc->dest_buf;
+    const uint32_t *src = dsc->src_buf;
+    const uint8_t *mask = dsc->mask_buf;
+
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        int32_t x = 0;
+        for (; x + VEC_PX32 <= w; x += VEC_PX32) {
+            SIMD_FN(argb8888_argb8888_vec)(&dest[x], &src[x], mask ? &mask[x] : NULL, opa);
+        }
+        if (x < w) {
+            uint32_t d[VEC_PX32];
+            uint32_t s[VEC_PX32] = {0};
+            uint8_t mk[VEC_PX32] = {0};
+            size_t n = (size_t)(w - x);
+            memcpy(d, &dest[x], n * 4);
+            memcpy(s, &src[x], n * 4);
+            if (mask) {
+                memcpy(mk, &mask[x], n);
+            }
+            SIMD_FN(argb8888_argb8888_vec)(d, s, mask ? mk : NULL, opa);
+            memcpy(&dest[x], d, n * 4);
+        }
+        dest = (uint32_t *)((uint8_t *)dest + dsc->dest_stride);
+        src = (const uint32_t *)((const uint8_t *)src + dsc->src_stride);
+        if (mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+}
+
+/*-------------------------------------------
+ * Entry points of the width
+ *-------------------------------------------*/
+
+/* The plain fills are stores at the speed of the memory, the scalar code's too */
+static lv_result_t SIMD_ATTR SIMD_FN(color_to_rgb565)(lv_draw_sw_blend_fill_dsc_t *dsc, bool swapped) {
+    if (dsc->mask_buf == NULL && dsc->opa >= LV_OPA_MAX) {
+        return LV_RESULT_INVALID;
+    }
+    uint32_t opa = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+    if (swapped) {
+        SIMD_FN(color_rgb565)(dsc, opa, true);
+    } else {
+        SIMD_FN(color_rgb565)(dsc, opa, false);
+    }
+    return LV_RESULT_OK;
+}
+
+static lv_result_t SIMD_ATTR SIMD_FN(rgb565_to_rgb565)(lv_draw_sw_blend_image_dsc_t *dsc, bool src_swapped,
+                                                       bool dest_swapped) {
+    if (dsc->mask_buf == NULL && dsc->opa >= LV_OPA_MAX) {
+        if (src_swapped == dest_swapped) {
+            return LV_RESULT_INVALID;
+        }
+        SIMD_FN(rgb565_swap_copy)(dsc);
+        return LV_RESULT_OK;
+    }
+
+    /* Instantiate the kernel for each byte order */
+    uint32_t opa = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+    switch ((src_swapped ? 1 : 0) | (dest_swapped ? 2 : 0)) {
+        case 0: SIMD_FN(rgb565_rgb565)(dsc, opa, false, false); break;
+        case 1: SIMD_FN(rgb565_rgb565)(dsc, opa, true, false); break;
+        case 2: SIMD_FN(rgb565_rgb565)(dsc, opa, false, true); break;
+        default: SIMD_FN(rgb565_rgb565)(dsc, opa, true, true); break;
+    }
+    return LV_RESULT_OK;
+}
+
+static lv_result_t SIMD_ATTR SIMD_FN(argb8888_to_rgb565)(lv_draw_sw_blend_image_dsc_t *dsc, bool swapped) {
+    if (swapped) {
+        SIMD_FN(argb8888_rgb565)(dsc, true);
+    } else {
+        SIMD_FN(argb8888_rgb565)(dsc, false);
+    }
+    return LV_RESULT_OK;
+}
+
+static lv_result_t SIMD_ATTR SIMD_FN(color_to_argb8888)(lv_draw_sw_blend_fill_dsc_t *dsc) {
+    if (dsc->mask_buf == NULL && dsc->opa >= LV_OPA_MAX) {
+        return LV_RESULT_INVALID;
+    }
+    SIMD_FN(color_argb8888)(dsc);
+    return LV_RESULT_OK;
+}
+
+static lv_result_t SIMD_ATTR SIMD_FN(argb8888_to_argb8888)(lv_draw_sw_blend_image_dsc_t *dsc) {
+    SIMD_FN(argb8888_argb8888)(dsc);
+    return LV_RESULT_OK;
+}
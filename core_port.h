@@ -0,0 +1,53 @@
+/**
+ * @file core_port.h
+ * @brief Minimal dual-core abstraction used by the display pipeline
+ *
+ * On the RP2350 this maps to pico_multicore (core_port_pico.c), on Linux
+ * core 1 is a POSIX thread (host/core_port_posix.c).
+ */
+
+#ifndef CORE_PORT_H
+#define CORE_PORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Start running a function on the second core
+ * @param entry Function to run, it must never return
+ */
+void core_port_launch(void (*entry)(void));
+
+/**
+ * @brief Get a free running microsecond timestamp (wraps around)
+ * @return Current time in microseconds
+ */
+uint32_t core_port_time_us(void);
+
+/**
+ * @brief Wait for an event from the other core (or give up the CPU briefly)
+ */
+void core_port_wait_event(void);
+
+/**
+ * @brief Wake up the other core if it is waiting in core_port_wait_event()
+ */
+void core_port_signal_event(void);
+
+/**
+ * @brief Sleep on core 0 until core_port_wake() is called or the timeout expires
+ *
+ * Wake-ups are sticky: if core_port_wake() was called since the last
+ * core_port_sleep() it returns at once.
+ *
+ * @param timeout_us Longest time to sleep
+ * @return true if woken by core_port_wake(), false on timeout
+ */
+bool core_port_sleep(uint32_t timeout_us);
+
+/**
+ * @brief End core_port_sleep() early, callable from interrupts and from core 1
+ */
+void core_port_wake(void);
+
+#endif /* CORE_PORT_H */
@@ -0,0 +1,47 @@
+/**
+ * @file core_port_pico.c
+ * @brief Dual-core abstraction on top of pico_multicore
+ */
+
+#include "core_port.h"
+#include "pico/multicore.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+/* Set by core_port_wake(), consumed by core_port_sleep() */
+static volatile bool wake_pending;
+
+void core_port_launch(void (*entry)(void)) {
+    multicore_launch_core1(entry);
+}
+
+uint32_t core_port_time_us(void) {
+    return time_us_32();
+}
+
+void core_port_wait_event(void) {
+    __wfe();
+}
+
+void core_port_signal_event(void) {
+    __sev();
+}
+
+bool core_port_sleep(uint32_t timeout_us) {
+    absolute_time_t until = make_timeout_time_us(timeout_us);
+
+    /* Any interrupt or SEV ends the WFE, only core_port_wake() ends the sleep.
+     * The SEV in core_port_wake() keeps a wake-up between the check and the WFE */
+    while (!wake_pending) {
+        if (best_effort_wfe_or_timeout(until)) {
+            return false;
+        }
+    }
+    wake_pending = false;
+    return true;
+}
+
+void core_port_wake(void) {
+    wake_pending = true;
+    __sev();
+}
@@ -184,6 +184,7 @@ bool ft6336u_read(ft6336u_t *dev, ft6336u_touch_data_t *data) {
         data->points[0].y = ((buf[FT6336U_REG_P1_YH] & 0x0F) << 8) | buf[FT6336U_REG_P1_YL];
         data->points[0].weight = buf[FT6336U_REG_P1_WEIGHT];
         data->points[0].area = (buf[FT6336U_REG_P1_MISC] >> 4) & 0x0F;
+        data->points[0].id = (buf[FT6336U_REG_P1_YH] >> 4) & 0x0F;
         data->points[0].valid = true;
         
         /* Apply coordinate transformation */
@@ -197,6 +198,7 @@ bool ft6336u_read(ft6336u_t *dev, ft6336u_touch_data_t *data) {
         data->points[1].y = ((buf[FT6336U_REG_P2_YH] & 0x0F) << 8) | buf[FT6336U_REG_P2_YL];
         data->points[1].weight = buf[FT6336U_REG_P2_WEIGHT];
         data->points[1].area = (buf[FT6336U_REG_P2_MISC] >> 4) & 0x0F;
+        data->points[1].id = (buf[FT6336U_REG_P2_YH] >> 4) & 0x0F;
         data->points[1].valid = true;
         
         /* Apply coordinate transformation */
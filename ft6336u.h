@@ -93,6 +93,7 @@ typedef struct {
     uint8_t event;      /* Event type (press, release, contact) */
     uint8_t weight;     /* Touch pressure/weight */
     uint8_t area;       /* Touch area */
+    uint8_t id;         /* Touch ID, follows the finger when the other one lifts */
     bool valid;         /* Whether this touch point is valid */
 } ft6336u_touch_point_t;
 
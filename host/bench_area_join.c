@@ -0,0 +1,306 @@
+/**
+ * @file bench_area_join.c
+ * @brief Joining the invalidated areas of recorded lv_demo_benchmark() frames
+ *
+ * Replays the invalidated areas LVGL collected before every refresh of
+ * lv_demo_benchmark() on the 480 x 320 display of main.c, and joins them with
+ * the all-pairs strategy of LVGL 9.4 and with the sort and sweep of
+ * lv_refr_join_areas_sweep(), each with the pixel count as the cost (the
+ * LVGL 9.4 rule) and with the cost model of main.c (a fixed cost per window,
+ * render and wire time per pixel).
+ *
+ * Reports for each combination the pixels rendered, the windows flushed
+ * (strips of the 40 line buffer ring), the time the cost model of main.c
+ * estimates for them, and the CPU time spent in joining per frame.
+ *
+ * With --record the trace is recorded instead: the benchmark runs on a
+ * display with main.c's geometry and a join callback writes the areas of
+ * every refresh with more than one area (the others are the same for every
+ * strategy) to the file.
+ *
+ * Usage: bench_area_join [--window NS] <trace> | --record <trace>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "demos/lv_demos.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry, buffers and cost model as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+#define DISP_AREA_COST_WINDOW_NS    30000
+#define DISP_AREA_COST_PX_NS        40
+#define SPI_BAUDRATE        (75 * 1000 * 1000)
+
+#define TRACE_FRAMES_MAX    20000
+#define CPU_REPEAT          20
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Invalidated areas of one refresh
+ */
+typedef struct {
+    uint8_t cnt;
+    lv_area_t areas[LV_INV_BUF_SIZE];
+} trace_frame_t;
+
+/**
+ * @brief Totals of one strategy over the trace
+ */
+typedef struct {
+    uint64_t px;            /* Pixels rendered */
+    uint64_t windows;       /* Strips flushed */
+    uint64_t cost_ns;       /* Estimated by the cost model of main.c */
+    uint64_t cpu_ns;        /* Joining, for the whole trace */
+} result_t;
+
+static trace_frame_t *trace;
+static uint32_t trace_cnt;
+
+static FILE *record_file;
+static uint32_t record_cnt;
+static volatile bool bench_done;
+
+static lv_display_area_cost_t spi_cost = {
+    .window = DISP_AREA_COST_WINDOW_NS,
+    .px_render = DISP_AREA_COST_PX_NS,
+    .byte_flush = (uint32_t)(8ull * 1000000000u / SPI_BAUDRATE),
+};
+
+/*===========================================
+ * Recording
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+static void record_join_cb(lv_display_t *disp) {
+    if (disp->inv_p > 1) {
+        fprintf(record_file, "%u", (unsigned)disp->inv_p);
+        for (uint32_t i = 0; i < disp->inv_p; i++) {
+            const lv_area_t *a = &disp->inv_areas[i];
+            fprintf(record_file, " %d %d %d %d", (int)a->x1, (int)a->y1, (int)a->x2, (int)a->y2);
+        }
+        fprintf(record_file, "\n");
+        record_cnt++;
+    }
+    lv_refr_join_areas_pairwise(disp);
+}
+
+static void bench_end_cb(const lv_demo_benchmark_summary_t *summary) {
+    (void)summary;
+    bench_done = true;
+}
+
+static int record(const char *path) {
+    record_file = fopen(path, "w");
+    if (record_file == NULL) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+    fprintf(record_file, "# Invalidated areas of lv_demo_benchmark() before joining, recorded by bench_area_join\n");
+    fprintf(record_file, "# %u x %u, one refresh with more than one area per line\n", DISP_HOR_RES, DISP_VER_RES);
+    fprintf(record_file, "# <area count> <x1> <y1> <x2> <y2> ...\n");
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_set_join_areas_cb(disp, record_join_cb);
+
+    lv_demo_benchmark_set_end_cb(bench_end_cb);
+    lv_demo_benchmark();
+    while (!bench_done) {
+        lv_timer_handler();
+    }
+
+    fclose(record_file);
+    printf("%u refreshes with more than one area recorded to %s\n", (unsigned)record_cnt, path);
+    return 0;
+}
+
+/*===========================================
+ * Replay
+ *===========================================*/
+
+static bool load_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+    trace = malloc(TRACE_FRAMES_MAX * sizeof(trace_frame_t));
+    trace_cnt = 0;
+
+    char line[4096];
+    while (fgets(line, sizeof(line), f) && trace_cnt < TRACE_FRAMES_MAX) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        char *p = line;
+        trace_frame_t *frame = &trace[trace_cnt];
+        unsigned long cnt = strtoul(p, &p, 10);
+        if (cnt == 0 || cnt > LV_INV_BUF_SIZE) {
+            continue;
+        }
+        for (uint32_t i = 0; i < cnt; i++) {
+            frame->areas[i].x1 = (int32_t)strtol(p, &p, 10);
+            frame->areas[i].y1 = (int32_t)strtol(p, &p, 10);
+            frame->areas[i].x2 = (int32_t)strtol(p, &p, 10);
+            frame->areas[i].y2 = (int32_t)strtol(p, &p, 10);
+        }
+        frame->cnt = (uint8_t)cnt;
+        trace_cnt++;
+    }
+    fclose(f);
+    return trace_cnt > 0;
+}
+
+static void set_frame(lv_display_t *disp, const trace_frame_t *frame) {
+    memcpy(disp->inv_areas, frame->areas, frame->cnt * sizeof(lv_area_t));
+    memset(disp->inv_area_joined, 0, frame->cnt);
+    disp->inv_p = frame->cnt;
+}
+
+static void run(lv_display_t *disp, lv_display_join_areas_cb_t join_cb, const lv_display_area_cost_t *cost,
+                result_t *res) {
+    memset(res, 0, sizeof(*res));
+
+    /* Joining only, repeated for a measurable time */
+    lv_display_set_area_cost(disp, cost);
+    uint64_t start = cpu_ns();
+    for (uint32_t r = 0; r < CPU_REPEAT; r++) {
+        for (uint32_t i = 0; i < trace_cnt; i++) {
+            set_frame(disp, &trace[i]);
+            join_cb(disp);
+        }
+    }
+    res->cpu_ns = (cpu_ns() - start) / CPU_REPEAT;
+
+    /* What the refresh does with the joined areas, estimated with the cost model of main.c */
+    for (uint32_t i = 0; i < trace_cnt; i++) {
+        lv_display_set_area_cost(disp, cost);
+        set_frame(disp, &trace[i]);
+        join_cb(disp);
+
+        lv_display_set_area_cost(disp, &spi_cost);
+        for (uint32_t a = 0; a < disp->inv_p; a++) {
+            if (disp->inv_area_joined[a]) {
+                continue;
+            }
+            const lv_area_t *area = &disp->inv_areas[a];
+            int32_t w = lv_area_get_width(area);
+            int32_t h = lv_area_get_height(area);
+            int32_t max_row = LV_MIN(h, DISP_BUF_SIZE / w);
+            uint32_t strips = (uint32_t)((h + max_row - 1) / max_row);
+            res->px += lv_area_get_size(area);
+            res->windows += strips;
+            /* Every strip is a window on the bus */
+            res->cost_ns += lv_display_get_area_cost(disp, area) + (uint64_t)(strips - 1) * spi_cost.window;
+        }
+    }
+}
+
+static void print_result(const char *name, const result_t *res) {
+    printf("%-24s %9.2f %8llu %10.1f %10.0f\n", name, res->px / 1e6, (unsigned long long)res->windows,
+           res->cost_ns / 1e6, (double)res->cpu_ns / trace_cnt);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "--record") == 0) {
+        lv_init();
+        lv_tick_set_cb(tick_cb);
+        return record(argv[2]);
+    }
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            spi_cost.window = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (path == NULL && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL) {
+        fprintf(stderr, "Usage: %s [--window NS] <trace> | --record <trace>\n", argv[0]);
+        return 1;
+    }
+    if (!load_trace(path)) {
+        fprintf(stderr, "Can't load the trace %s\n", path);
+        return 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+
+    result_t pairwise_px, sweep_px, pairwise_spi, sweep_spi;
+    run(disp, lv_refr_join_areas_pairwise, NULL, &pairwise_px);
+    run(disp, lv_refr_join_areas_sweep, NULL, &sweep_px);
+    run(disp, lv_refr_join_areas_pairwise, &spi_cost, &pairwise_spi);
+    run(disp, lv_refr_join_areas_sweep, &spi_cost, &sweep_spi);
+
+    uint32_t area_cnt = 0;
+    for (uint32_t i = 0; i < trace_cnt; i++) {
+        area_cnt += trace[i].cnt;
+    }
+    printf("%u refreshes, %.1f areas on average; cost model: %u ns per window, %u ns per pixel, %u ns per byte\n",
+           (unsigned)trace_cnt, (double)area_cnt / trace_cnt, (unsigned)spi_cost.window,
+           (unsigned)spi_cost.px_render, (unsigned)spi_cost.byte_flush);
+    printf("%-24s %9s %8s %10s %10s\n", "Strategy", "Rendered", "Windows", "Estimated", "Joining");
+    printf("%-24s %9s %8s %10s %10s\n", "", "Mpx", "", "ms", "ns/frame");
+    print_result("pairwise, pixel count", &pairwise_px);
+    print_result("sweep, pixel count", &sweep_px);
+    print_result("pairwise, cost model", &pairwise_spi);
+    print_result("sweep, cost model", &sweep_spi);
+
+    /* The cost model trades a few pixels for fewer windows */
+    CHECK(sweep_spi.windows < sweep_px.windows);
+    CHECK(sweep_spi.cost_ns < pairwise_px.cost_ns);
+    /* The sweep is as good as comparing all pairs */
+    CHECK(sweep_spi.cost_ns <= pairwise_spi.cost_ns + pairwise_spi.cost_ns / 100);
+    CHECK(sweep_px.px <= pairwise_px.px + pairwise_px.px / 100);
+
+    lv_display_delete(disp);
+    free(trace);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
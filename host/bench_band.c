@@ -0,0 +1,419 @@
+/**
+ * @file bench_band.c
+ * @brief Render threads with tiles and with band rendering
+ *
+ * Runs lv_demo_benchmark() on the 480 x 320 display of main.c with LVGL
+ * built with LV_USE_OS = LV_OS_PTHREAD and BENCH_DRAW_UNIT_CNT SW render
+ * threads (bench_band_1, _2, _4 and _8). Four runs:
+ *
+ *   - one: one tile, no bands, a draw task per thread
+ *   - tiles: LVGL's default, every refreshed area is cut into a tile per
+ *     thread (lv_display_set_tile_cnt()) and the widgets are drawn in every
+ *     tile
+ *   - bands: one tile, the big draw tasks are cut into bands
+ *     (lv_draw_sw_set_band_min_size()) which the idle threads steal
+ *   - both: a tile per thread and bands
+ *
+ * The runs with bands have to flush the same pixels as the ones with the
+ * same tiles and without bands (the layers are cut at the tiles, so the
+ * tiles change the rounding of some layers).
+ *
+ * The CPU time of every render thread is sampled at the start and at the end
+ * of every refresh. Per scene it reports:
+ *
+ *   - draw: CPU time of all render threads in the "one" run
+ *   - est.: CPU time of the LVGL thread (widget tree, draw task creation and
+ *     dispatch) + CPU time of the busiest render thread of each refresh,
+ *     i.e. the refresh time if every thread had a core of its own
+ *   - par.: CPU time of all render threads / busiest render thread, how
+ *     much of the drawing ran in parallel
+ *
+ * and the bands drawn and stolen. On a host with fewer cores than threads
+ * the threads only run when the scheduler switches to them, which shows up
+ * as less stealing and a lower par. than with a core per thread.
+ *
+ * Usage: bench_band_N [--band-min-size PX]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "demos/lv_demos.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define SCENE_MAX           32
+#define THREAD_CNT          LV_DRAW_SW_DRAW_UNIT_CNT
+
+/* The tiles of the render threads have layers of their own, more than the 128 kB of lv_conf.h */
+#define HEAP_POOL_CNT       8
+#define HEAP_POOL_SIZE      (64 * 1024)
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of a scene, or of a refresh
+ */
+typedef struct {
+    uint64_t refr_cnt;
+    uint64_t draw_ns;       /* All render threads */
+    uint64_t busiest_ns;    /* The busiest render thread of each refresh */
+    uint64_t main_ns;       /* The LVGL thread */
+    uint64_t wall_ns;
+    uint32_t hash;          /* Of the run, at the end */
+} scene_stats_t;
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    scene_stats_t scenes[SCENE_MAX];
+    const char *names[SCENE_MAX];
+    uint32_t scene_cnt;
+    uint32_t hash;          /* Of every flushed area and pixel */
+    uint32_t band_cnt;
+    uint32_t stolen_cnt;
+} run_t;
+
+/**
+ * @brief How the work is shared by the render threads
+ */
+typedef struct {
+    const char *name;
+    uint32_t tile_cnt;
+    uint32_t band_min_size;
+    uint32_t ref;           /* The run which has to flush the same pixels */
+} config_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+static volatile bool bench_done;
+static lv_draw_sw_unit_t *sw_unit;
+
+/* One entry per refresh, with the simulated time when it ended */
+static uint32_t refr_ticks[16384];
+static scene_stats_t refrs[16384];
+static uint32_t refr_cnt;
+
+/* CPU times at the start of the refresh */
+static uint64_t thread_start_ns[THREAD_CNT];
+static uint64_t main_start_ns;
+static uint64_t wall_start_ns;
+
+/*===========================================
+ * Clocks
+ *===========================================*/
+
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint64_t render_thread_ns(uint32_t i) {
+    clockid_t clock;
+    if (!sw_unit->thread_dscs[i].inited ||
+        pthread_getcpuclockid(sw_unit->thread_dscs[i].thread.thread, &clock) != 0) {
+        return 0;
+    }
+    return clock_ns(clock);
+}
+
+static lv_draw_sw_unit_t *sw_unit_find(void) {
+    for (lv_draw_unit_t *u = LV_GLOBAL_DEFAULT()->draw_info.unit_head; u; u = u->next) {
+        if (u->name && strncmp(u->name, "SW", 2) == 0) {
+            return (lv_draw_sw_unit_t *)u;
+        }
+    }
+    return NULL;
+}
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    run_act->hash = fnv1a(run_act->hash, area, sizeof(*area));
+    run_act->hash = fnv1a(run_act->hash, px_map, lv_area_get_size(area) * 2);
+    lv_display_flush_ready(disp);
+}
+
+static void refr_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_REFR_START) {
+        for (uint32_t i = 0; i < THREAD_CNT; i++) {
+            thread_start_ns[i] = render_thread_ns(i);
+        }
+        main_start_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+        wall_start_ns = clock_ns(CLOCK_MONOTONIC);
+    } else if (code == LV_EVENT_REFR_READY) {
+        if (refr_cnt == sizeof(refrs) / sizeof(refrs[0])) {
+            return;
+        }
+        scene_stats_t *r = &refrs[refr_cnt];
+        memset(r, 0, sizeof(*r));
+        r->refr_cnt = 1;
+        r->wall_ns = clock_ns(CLOCK_MONOTONIC) - wall_start_ns;
+        r->main_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - main_start_ns;
+        for (uint32_t i = 0; i < THREAD_CNT; i++) {
+            uint64_t ns = render_thread_ns(i) - thread_start_ns[i];
+            r->draw_ns += ns;
+            if (ns > r->busiest_ns) {
+                r->busiest_ns = ns;
+            }
+        }
+        r->hash = run_act->hash;
+        refr_ticks[refr_cnt++] = tick_ms;
+    }
+}
+
+/**
+ * @brief The title of the demo shows the measured CPU load, keep its pixels the same in every run
+ */
+static void perf_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    LV_UNUSED(subject);
+    lv_obj_t *title = lv_observer_get_target(observer);
+    if (title) {
+        lv_label_set_text(title, "lv_demo_benchmark\nsysmon values hidden");
+    }
+}
+
+/*===========================================
+ * Benchmark Demo
+ *===========================================*/
+
+static void scene_add(scene_stats_t *s, const scene_stats_t *r) {
+    s->refr_cnt += r->refr_cnt;
+    s->draw_ns += r->draw_ns;
+    s->busiest_ns += r->busiest_ns;
+    s->main_ns += r->main_ns;
+    s->wall_ns += r->wall_ns;
+    s->hash = r->hash;
+}
+
+static void bench_end_cb(const lv_demo_benchmark_summary_t *summary) {
+    /* Attribute the refreshes to the scenes by their time */
+    uint32_t scene_end = 0;
+    uint32_t r = 0;
+    for (const lv_demo_benchmark_scene_dsc_t *scene = summary->scenes;
+         scene->scene_time && run_act->scene_cnt < SCENE_MAX; scene++) {
+        scene_end += scene->scene_time;
+        scene_stats_t *s = &run_act->scenes[run_act->scene_cnt];
+        run_act->names[run_act->scene_cnt++] = scene->name;
+        for (; r < refr_cnt && refr_ticks[r] <= scene_end; r++) {
+            scene_add(s, &refrs[r]);
+        }
+    }
+    for (uint32_t i = 0; i < THREAD_CNT; i++) {
+        run_act->band_cnt += sw_unit->thread_dscs[i].band_drawn_cnt;
+        run_act->stolen_cnt += sw_unit->thread_dscs[i].band_stolen_cnt;
+    }
+    bench_done = true;
+}
+
+static void run_demo(const config_t *config, run_t *run) {
+    memset(run, 0, sizeof(*run));
+    run->hash = 2166136261u;
+    run_act = run;
+    refr_cnt = 0;
+    tick_ms = 0;
+    bench_done = false;
+
+    lv_init();
+    for (uint32_t i = 0; i < HEAP_POOL_CNT; i++) {
+        lv_mem_add_pool(malloc(HEAP_POOL_SIZE), HEAP_POOL_SIZE);
+    }
+    lv_tick_set_cb(tick_cb);
+    lv_draw_sw_set_band_min_size(config->band_min_size);
+    sw_unit = sw_unit_find();
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_ALL, NULL);
+    lv_display_set_tile_cnt(disp, config->tile_cnt);
+    /* With LV_OS_PTHREAD the CPU load of the label comes from /proc/stat, it differs in every run */
+    lv_sysmon_hide_performance(disp);
+
+    lv_demo_benchmark_set_end_cb(bench_end_cb);
+    lv_demo_benchmark();
+    /* After the observer of the demo, to overwrite its title */
+    lv_subject_add_observer_with_target(&disp->perf_sysmon_backend.subject, perf_observer_cb,
+                                        lv_obj_get_child(lv_layer_top(), 0), NULL);
+    while (!bench_done) {
+        tick_ms += FRAME_MS;
+        lv_timer_handler();
+    }
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+/**
+ * @brief Run in a child process
+ *
+ * The demos keep state in static variables, lv_deinit() doesn't reset those:
+ * every run starts from the same state in a fresh copy of the process.
+ */
+static void run_forked(const config_t *config, run_t *run) {
+    run_t *shared = mmap(NULL, sizeof(run_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CHECK(shared != MAP_FAILED);
+    if (shared == MAP_FAILED) {
+        return;
+    }
+    memset(shared, 0, sizeof(*shared));
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        run_demo(config, shared);
+        _exit(0);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    *run = *shared;
+    munmap(shared, sizeof(run_t));
+}
+
+/*===========================================
+ * Report
+ *===========================================*/
+
+#define CONFIG_CNT 4
+
+static double est_ms(const scene_stats_t *s) {
+    return (s->main_ns + s->busiest_ns) / 1e6;
+}
+
+static double par(const scene_stats_t *s) {
+    return s->busiest_ns ? (double)s->draw_ns / s->busiest_ns : 1;
+}
+
+static void print_scene(const char *name, const scene_stats_t *s[CONFIG_CNT]) {
+    printf("%-28s %8.1f", name, s[0]->draw_ns / 1e6);
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        printf(" %8.1f", est_ms(s[c]));
+    }
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        printf(" %5.2f", par(s[c]));
+    }
+    printf("\n");
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t band_min_size = LV_DRAW_SW_BAND_MIN_PX;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--band-min-size") == 0 && i + 1 < argc) {
+            band_min_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--band-min-size PX]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    /* The layers are cut differently with tiles, their rounding differs:
+     * the runs with bands are compared to the same tiles without bands */
+    const config_t configs[CONFIG_CNT] = {
+        {"one", 1, 0, 0},
+        {"tiles", THREAD_CNT, 0, 1},
+        {"bands", 1, band_min_size, 0},
+        {"both", THREAD_CNT, band_min_size, 1},
+    };
+    static run_t runs[CONFIG_CNT];
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        run_forked(&configs[c], &runs[c]);
+    }
+
+    printf("%u render thread(s), %u ms frames, bands from %u px, CPU time in the refreshes\n",
+           (unsigned)THREAD_CNT, FRAME_MS, (unsigned)band_min_size);
+    printf("%-28s %8s %8s %8s %8s %8s %5s %5s %5s %5s\n", "Scene",
+           "Draw", "Est.", "", "", "", "Par.", "", "", "");
+    printf("%-28s %8s", "", "ms");
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        printf(" %8s", configs[c].name);
+    }
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        printf(" %5s", configs[c].name);
+    }
+    printf("\n");
+
+    scene_stats_t totals[CONFIG_CNT] = {0};
+    const scene_stats_t *s[CONFIG_CNT];
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        CHECK(runs[c].scene_cnt > 0 && runs[c].scene_cnt == runs[0].scene_cnt);
+    }
+    for (uint32_t i = 0; i < runs[0].scene_cnt; i++) {
+        for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+            s[c] = &runs[c].scenes[i];
+            scene_add(&totals[c], s[c]);
+            /* The same refreshes and pixels */
+            const scene_stats_t *ref = &runs[configs[c].ref].scenes[i];
+            if (s[c]->refr_cnt != ref->refr_cnt || s[c]->hash != ref->hash) {
+                printf("FAIL %s: %s differs from %s\n", runs[0].names[i],
+                       configs[c].name, configs[configs[c].ref].name);
+                failures++;
+            }
+        }
+        print_scene(runs[0].names[i], s);
+    }
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        s[c] = &totals[c];
+    }
+    print_scene("Total", s);
+
+    printf("\n");
+    for (uint32_t c = 0; c < CONFIG_CNT; c++) {
+        printf("%-6s main %8.1f ms, busiest thread %8.1f ms, wall %8.1f ms, %u bands drawn, %u stolen\n",
+               configs[c].name, totals[c].main_ns / 1e6, totals[c].busiest_ns / 1e6, totals[c].wall_ns / 1e6,
+               (unsigned)runs[c].band_cnt, (unsigned)runs[c].stolen_cnt);
+        CHECK(runs[c].hash == runs[configs[c].ref].hash);
+    }
+
+    CHECK(runs[0].band_cnt == 0 && runs[1].band_cnt == 0);
+    if (THREAD_CNT > 1 && band_min_size) {
+        CHECK(runs[2].band_cnt > 0 && runs[2].stolen_cnt > 0);
+        /* With bands the widgets are drawn once, not in every tile */
+        CHECK(totals[2].main_ns < totals[1].main_ns);
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file bench_draw_arena.c
+ * @brief Heap traffic of the refreshes with and without the draw arena
+ *
+ * Runs lv_demo_benchmark() on the 480 x 320 display of main.c with the
+ * 128 kB TLSF heap of lv_conf.h twice, without and with a draw arena
+ * (lv_draw_arena_resize()), and checks that every flushed pixel is the same.
+ *
+ * The calls of the heap are counted by wrapping lv_malloc_core(),
+ * lv_realloc_core() and lv_free_core() at link time. Reports per scene, only
+ * for the time spent in the refreshes:
+ *
+ *   - heap calls (malloc + realloc + free) per refresh
+ *   - fragmentation of the heap and its biggest free block, sampled in
+ *     every flush, i.e. while the draw tasks of the area are alive
+ *
+ * and the high-water mark of the arena, to size DISP_DRAW_ARENA_SIZE of main.c.
+ *
+ * Usage: bench_draw_arena [--arena-size BYTES]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "demos/lv_demos.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define SCENE_MAX           32
+#define ARENA_SIZE_DEF      (8 * 1024)
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of a scene, or of a refresh while it runs
+ */
+typedef struct {
+    uint64_t refr_cnt;
+    uint64_t heap_calls;    /* malloc + realloc + free in the refreshes */
+    uint64_t flush_cnt;
+    uint64_t frag_pct_sum;  /* Of the samples in the flushes */
+    uint32_t frag_pct_max;
+    uint32_t biggest_min;   /* Smallest of the biggest free blocks in the flushes */
+} scene_stats_t;
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    scene_stats_t scenes[SCENE_MAX];
+    const char *names[SCENE_MAX];
+    uint32_t scene_cnt;
+    uint32_t hash;          /* Of every flushed area and pixel */
+    lv_draw_arena_stats_t arena;
+} run_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+static volatile bool bench_done;
+static bool in_refr;
+
+/* One entry per refresh, with the simulated time when it ended */
+static uint32_t refr_ticks[16384];
+static scene_stats_t refrs[16384];
+static uint32_t refr_cnt;
+static scene_stats_t refr_act;
+
+/*===========================================
+ * Heap Counters
+ *===========================================*/
+
+void *__real_lv_malloc_core(size_t size);
+void *__real_lv_realloc_core(void *p, size_t new_size);
+void __real_lv_free_core(void *p);
+
+void *__wrap_lv_malloc_core(size_t size) {
+    if (in_refr) {
+        refr_act.heap_calls++;
+    }
+    return __real_lv_malloc_core(size);
+}
+
+void *__wrap_lv_realloc_core(void *p, size_t new_size) {
+    if (in_refr) {
+        refr_act.heap_calls++;
+    }
+    return __real_lv_realloc_core(p, new_size);
+}
+
+void __wrap_lv_free_core(void *p) {
+    if (in_refr) {
+        refr_act.heap_calls++;
+    }
+    __real_lv_free_core(p);
+}
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    run_act->hash = fnv1a(run_act->hash, area, sizeof(*area));
+    run_act->hash = fnv1a(run_act->hash, px_map, lv_area_get_size(area) * 2);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    refr_act.flush_cnt++;
+    refr_act.frag_pct_sum += mon.frag_pct;
+    if (mon.frag_pct > refr_act.frag_pct_max) {
+        refr_act.frag_pct_max = mon.frag_pct;
+    }
+    if (mon.free_biggest_size < refr_act.biggest_min) {
+        refr_act.biggest_min = mon.free_biggest_size;
+    }
+
+    lv_display_flush_ready(disp);
+}
+
+static void refr_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_REFR_START) {
+        memset(&refr_act, 0, sizeof(refr_act));
+        refr_act.biggest_min = UINT32_MAX;
+        in_refr = true;
+    } else if (code == LV_EVENT_REFR_READY) {
+        in_refr = false;
+        if (refr_cnt < sizeof(refrs) / sizeof(refrs[0])) {
+            refr_act.refr_cnt = 1;
+            refr_ticks[refr_cnt] = tick_ms;
+            refrs[refr_cnt++] = refr_act;
+        }
+    }
+}
+
+/**
+ * @brief The title of the demo shows the measured CPU load, keep its pixels the same in every run
+ */
+static void perf_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    LV_UNUSED(subject);
+    lv_obj_t *title = lv_observer_get_target(observer);
+    if (title) {
+        lv_label_set_text(title, "lv_demo_benchmark\nsysmon values hidden");
+    }
+}
+
+/*===========================================
+ * Benchmark Demo
+ *===========================================*/
+
+static void scene_add(scene_stats_t *s, const scene_stats_t *r) {
+    s->refr_cnt += r->refr_cnt;
+    s->heap_calls += r->heap_calls;
+    s->flush_cnt += r->flush_cnt;
+    s->frag_pct_sum += r->frag_pct_sum;
+    if (r->frag_pct_max > s->frag_pct_max) {
+        s->frag_pct_max = r->frag_pct_max;
+    }
+    if (r->biggest_min < s->biggest_min) {
+        s->biggest_min = r->biggest_min;
+    }
+}
+
+static void bench_end_cb(const lv_demo_benchmark_summary_t *summary) {
+    /* Attribute the refreshes to the scenes by their time */
+    uint32_t scene_end = 0;
+    uint32_t r = 0;
+    for (const lv_demo_benchmark_scene_dsc_t *scene = summary->scenes;
+         scene->scene_time && run_act->scene_cnt < SCENE_MAX; scene++) {
+        scene_end += scene->scene_time;
+        scene_stats_t *s = &run_act->scenes[run_act->scene_cnt];
+        run_act->names[run_act->scene_cnt++] = scene->name;
+        s->biggest_min = UINT32_MAX;
+        for (; r < refr_cnt && refr_ticks[r] <= scene_end; r++) {
+            scene_add(s, &refrs[r]);
+        }
+    }
+    lv_draw_arena_get_stats(&run_act->arena);
+    bench_done = true;
+}
+
+static void run_demo(uint32_t arena_size, run_t *run) {
+    memset(run, 0, sizeof(*run));
+    run->hash = 2166136261u;
+    run_act = run;
+    refr_cnt = 0;
+    tick_ms = 0;
+    bench_done = false;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_draw_arena_resize(arena_size);
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_ALL, NULL);
+
+    lv_demo_benchmark_set_end_cb(bench_end_cb);
+    lv_demo_benchmark();
+    /* After the observer of the demo, to overwrite its title */
+    lv_subject_add_observer_with_target(&disp->perf_sysmon_backend.subject, perf_observer_cb,
+                                        lv_obj_get_child(lv_layer_top(), 0), NULL);
+    while (!bench_done) {
+        tick_ms += FRAME_MS;
+        lv_timer_handler();
+    }
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+/**
+ * @brief Run in a child process
+ *
+ * The demos keep state in static variables, lv_deinit() doesn't reset those:
+ * every run starts from the same state in a fresh copy of the process.
+ */
+static void run_forked(uint32_t arena_size, run_t *run) {
+    run_t *shared = mmap(NULL, sizeof(run_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CHECK(shared != MAP_FAILED);
+    if (shared == MAP_FAILED) {
+        return;
+    }
+    memset(shared, 0, sizeof(*shared));
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        run_demo(arena_size, shared);
+        _exit(0);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    *run = *shared;
+    munmap(shared, sizeof(run_t));
+}
+
+/*===========================================
+ * Report
+ *===========================================*/
+
+static void print_scene(const char *name, const scene_stats_t *off, const scene_stats_t *on) {
+    double refr_off = off->refr_cnt ? (double)off->refr_cnt : 1;
+    double refr_on = on->refr_cnt ? (double)on->refr_cnt : 1;
+    double flush_off = off->flush_cnt ? (double)off->flush_cnt : 1;
+    double flush_on = on->flush_cnt ? (double)on->flush_cnt : 1;
+    printf("%-28s %6llu %8.1f %8.1f %6.1f %6.1f %4u %4u %7.1f %7.1f\n", name,
+           (unsigned long long)off->refr_cnt,
+           off->heap_calls / refr_off, on->heap_calls / refr_on,
+           off->frag_pct_sum / flush_off, on->frag_pct_sum / flush_on,
+           off->frag_pct_max, on->frag_pct_max,
+           off->flush_cnt ? off->biggest_min / 1024.0 : 0,
+           on->flush_cnt ? on->biggest_min / 1024.0 : 0);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t arena_size = ARENA_SIZE_DEF;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--arena-size") == 0 && i + 1 < argc) {
+            arena_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--arena-size BYTES]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static run_t off, on;
+    run_forked(0, &off);
+    run_forked(arena_size, &on);
+
+    printf("%u ms frames, %u kB heap, %u B arena, in the refreshes only\n",
+           FRAME_MS, (unsigned)(LV_MEM_SIZE / 1024), (unsigned)arena_size);
+    printf("%-28s %6s %8s %8s %6s %6s %4s %4s %7s %7s\n", "Scene", "Refr.",
+           "Heap", "calls", "Frag.", "avg %", "max", "%", "Big.", "free kB");
+    printf("%-28s %6s %8s %8s %6s %6s %4s %4s %7s %7s\n", "", "",
+           "", "arena", "", "arena", "", "arena", "", "arena");
+
+    scene_stats_t total_off = {.biggest_min = UINT32_MAX};
+    scene_stats_t total_on = {.biggest_min = UINT32_MAX};
+    for (uint32_t i = 0; i < off.scene_cnt; i++) {
+        print_scene(off.names[i], &off.scenes[i], &on.scenes[i]);
+        /* The same refreshes */
+        CHECK(on.scenes[i].refr_cnt == off.scenes[i].refr_cnt);
+        scene_add(&total_off, &off.scenes[i]);
+        scene_add(&total_on, &on.scenes[i]);
+    }
+    print_scene("Total", &total_off, &total_on);
+
+    printf("\nArena: %u B, high-water %u B, %u allocations, %u from the heap, %u resets\n",
+           (unsigned)on.arena.size, (unsigned)on.arena.max_used, (unsigned)on.arena.alloc_cnt,
+           (unsigned)on.arena.heap_alloc_cnt, (unsigned)on.arena.reset_cnt);
+
+    /* The same pixels were flushed */
+    CHECK(off.scene_cnt > 0 && off.scene_cnt == on.scene_cnt);
+    CHECK(off.hash == on.hash);
+    /* Without an arena nothing may be taken from it */
+    CHECK(off.arena.size == 0 && off.arena.alloc_cnt == 0);
+    if (arena_size) {
+        CHECK(on.arena.size == arena_size);
+        CHECK(on.arena.alloc_cnt > 0);
+        /* The draw tasks were most of the heap traffic of the refreshes */
+        CHECK(total_on.heap_calls * 2 < total_off.heap_calls);
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file bench_draw_list.c
+ * @brief Redrawing a dashboard with and without the recorded draw lists
+ *
+ * A static dashboard (panels with charts, cards with shadows, bars and
+ * buttons) with a few small things changing in every frame: a gauge on the
+ * first panel, a value next to it and a bar on every card. Everything under
+ * them is redrawn: without draw lists the draw events of those widgets are
+ * sent again and they read their styles and build the same draw
+ * descriptors, with lv_obj_draw_list_resize() the draw tasks recorded when
+ * they were drawn unchanged the second time are added again. The changed
+ * widgets are not recorded.
+ *
+ * A second scene sweeps a marker over the dashboard. Its areas are at a
+ * new place in every frame, so the widgets under it are redrawn to clip
+ * areas they were never drawn to: the lists are recorded for the whole
+ * widget and replayed for any part of it.
+ *
+ * The CPU time between LV_EVENT_RENDER_START and LV_EVENT_RENDER_READY
+ * without the flush callback and without the SW draw unit (its dispatch_cb
+ * is wrapped to measure it) is the time spent in lv_obj_redraw(): walking
+ * the widget tree, the draw events and creating the draw tasks.
+ *
+ * Runs the same frames on the 480 x 320 display of main.c without and with
+ * the draw lists. The flushed frames have to be the same.
+ *
+ * Usage: bench_draw_list [--size BYTES] [--frames N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define FRAME_CNT_DEF       600
+#define LIST_SIZE_DEF       (24 * 1024)
+#define MARKER_SIZE         24
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    uint64_t render_ns;     /* CPU time of the refreshes */
+    uint64_t flush_ns;
+    uint64_t draw_ns;       /* CPU time of the draw unit */
+    uint64_t px;            /* Pixels flushed */
+    uint32_t hash;          /* Of the flushed pixels */
+    lv_obj_draw_list_stats_t stats;
+} run_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+static uint64_t render_start_ns;
+static int32_t (*sw_dispatch_cb)(lv_draw_unit_t *draw_unit, lv_layer_t *layer);
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    uint64_t t0 = cpu_ns();
+
+    /* FNV-1a of the area and its pixels */
+    const uint8_t *p = px_map;
+    size_t size = (size_t)lv_area_get_size(area) * 2;
+    uint32_t h = run_act->hash ^ (uint32_t)(area->x1 << 16 | area->y1);
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    run_act->hash = h;
+    run_act->px += lv_area_get_size(area);
+    lv_display_flush_ready(disp);
+
+    run_act->flush_ns += cpu_ns() - t0;
+}
+
+static void render_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        render_start_ns = cpu_ns();
+    } else {
+        run_act->render_ns += cpu_ns() - render_start_ns;
+    }
+}
+
+static int32_t dispatch_cb(lv_draw_unit_t *draw_unit, lv_layer_t *layer) {
+    uint64_t t0 = cpu_ns();
+    int32_t res = sw_dispatch_cb(draw_unit, layer);
+    run_act->draw_ns += cpu_ns() - t0;
+    return res;
+}
+
+static uint64_t redraw_ns(const run_t *res) {
+    return res->render_ns - res->flush_ns - res->draw_ns;
+}
+
+/*===========================================
+ * Dashboard
+ *===========================================*/
+
+/**
+ * @brief A panel with a gradient, a title, a value and a chart
+ */
+static lv_obj_t *chart_panel_create(lv_obj_t *parent, int32_t x, int32_t y, const char *title) {
+    lv_obj_t *panel = lv_obj_create(parent);
+    lv_obj_remove_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(panel, x, y);
+    lv_obj_set_size(panel, 220, 140);
+    lv_obj_set_style_bg_color(panel, lv_palette_darken(LV_PALETTE_BLUE_GREY, 3), 0);
+    lv_obj_set_style_bg_grad_color(panel, lv_palette_darken(LV_PALETTE_BLUE_GREY, 4), 0);
+    lv_obj_set_style_bg_grad_dir(panel, LV_GRAD_DIR_VER, 0);
+    lv_obj_set_style_pad_all(panel, 8, 0);
+    lv_obj_set_style_text_color(panel, lv_color_white(), 0);
+    lv_label_set_text(lv_label_create(panel), title);
+
+    lv_obj_t *chart = lv_chart_create(panel);
+    lv_obj_set_size(chart, lv_pct(100), 90);
+    lv_obj_align(chart, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_chart_set_point_count(chart, 24);
+    lv_chart_set_div_line_count(chart, 4, 6);
+    lv_chart_series_t *s1 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_CYAN), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_series_t *s2 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_AMBER), LV_CHART_AXIS_PRIMARY_Y);
+    for (uint32_t i = 0; i < 24; i++) {
+        lv_chart_set_next_value(chart, s1, (int32_t)lv_rand(20, 80));
+        lv_chart_set_next_value(chart, s2, (int32_t)lv_rand(10, 60));
+    }
+    return panel;
+}
+
+/**
+ * @brief A rounded card with a shadow, a title, a bar and a button
+ */
+static lv_obj_t *card_create(lv_obj_t *parent, int32_t x, int32_t y, const char *title) {
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_remove_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(card, x, y);
+    lv_obj_set_size(card, 105, 130);
+    lv_obj_set_style_radius(card, 12, 0);
+    lv_obj_set_style_shadow_width(card, 10, 0);
+    lv_obj_set_style_shadow_offset_y(card, 3, 0);
+    lv_obj_set_style_pad_all(card, 8, 0);
+
+    lv_label_set_text(lv_label_create(card), title);
+
+    lv_obj_t *bar = lv_bar_create(card);
+    lv_obj_set_size(bar, lv_pct(100), 10);
+    lv_obj_align(bar, LV_ALIGN_LEFT_MID, 0, -5);
+
+    lv_obj_t *btn = lv_button_create(card);
+    lv_obj_align(btn, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_label_set_text(lv_label_create(btn), LV_SYMBOL_SETTINGS " Set");
+    return bar;
+}
+
+static void run(bool sweep, uint32_t list_size, uint32_t frame_cnt, run_t *res) {
+    memset(res, 0, sizeof(*res));
+    run_act = res;
+    tick_ms = 0;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_rand_set_seed(1);
+    lv_obj_draw_list_resize(list_size);
+
+    lv_draw_unit_t *unit = LV_GLOBAL_DEFAULT()->draw_info.unit_head;
+    sw_dispatch_cb = unit->dispatch_cb;
+    unit->dispatch_cb = dispatch_cb;
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_READY, NULL);
+    lv_sysmon_hide_performance(disp);
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    lv_obj_t *panel = chart_panel_create(scr, 10, 10, "Temperature");
+    chart_panel_create(scr, 250, 10, "Humidity");
+    lv_obj_t *bars[4];
+    bars[0] = card_create(scr, 10, 175, "Fan");
+    bars[1] = card_create(scr, 125, 175, "Pump");
+    bars[2] = card_create(scr, 240, 175, "Heater");
+    bars[3] = card_create(scr, 355, 175, "Valve");
+
+    lv_obj_t *value = lv_label_create(panel);
+    lv_obj_align(value, LV_ALIGN_TOP_RIGHT, 0, 0);
+
+    lv_obj_t *gauge = lv_arc_create(scr);
+    lv_obj_set_size(gauge, 70, 70);
+    lv_obj_set_pos(gauge, 140, 40);
+    lv_obj_remove_flag(gauge, LV_OBJ_FLAG_CLICKABLE);
+
+    lv_obj_t *marker = lv_obj_create(scr);
+    lv_obj_set_size(marker, MARKER_SIZE, MARKER_SIZE);
+    lv_obj_set_style_radius(marker, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_bg_color(marker, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_set_style_bg_opa(marker, LV_OPA_70, 0);
+    lv_obj_set_style_border_width(marker, 0, 0);
+    if (!sweep) {
+        lv_obj_add_flag(marker, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    int32_t sweep_w = DISP_HOR_RES - MARKER_SIZE;
+    for (uint32_t i = 0; i < frame_cnt; i++) {
+        tick_ms += FRAME_MS;
+
+        if (sweep) {
+            /* Back and forth on two rows: over the charts and over the cards */
+            int32_t x = (int32_t)(i * 4 % (2 * sweep_w));
+            if (x > sweep_w) {
+                x = 2 * sweep_w - x;
+            }
+            int32_t y = (i * 4 / (2 * sweep_w)) % 2 ? 230 : 90;
+            lv_obj_set_pos(marker, x, y);
+        } else {
+            lv_arc_set_value(gauge, (int32_t)(i % 100));
+            for (uint32_t b = 0; b < 4; b++) {
+                lv_bar_set_value(bars[b], (int32_t)((i + b * 25) % 100), LV_ANIM_OFF);
+            }
+            lv_label_set_text_fmt(value, "%u.%u C", (unsigned)(21 + i / 100), (unsigned)(i % 10));
+        }
+
+        lv_timer_handler();
+    }
+
+    lv_obj_draw_list_get_stats(&res->stats);
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+static void print_run(const char *name, const run_t *res) {
+    const lv_obj_draw_list_stats_t *s = &res->stats;
+    printf("%-6s %9.2f %9.2f %8u %8u %8u %8u %8u\n", name,
+           redraw_ns(res) / 1e6, res->px / 1e6,
+           (unsigned)s->record_cnt, (unsigned)s->replay_cnt, (unsigned)s->replay_task_cnt,
+           (unsigned)s->skip_cnt, (unsigned)s->max_used);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t list_size = LIST_SIZE_DEF;
+    uint32_t frame_cnt = FRAME_CNT_DEF;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            list_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_cnt = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--size BYTES] [--frames N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("%u frames of %u ms, draw lists of %u bytes\n", (unsigned)frame_cnt, FRAME_MS, (unsigned)list_size);
+    printf("%-6s %9s %9s %8s %8s %8s %8s %8s\n", "Lists", "Redraw", "Flushed", "Records", "Replays",
+           "Tasks", "Skipped", "Max used");
+    printf("%-6s %9s %9s %8s %8s %8s %8s %8s\n", "", "CPU ms", "Mpx", "", "", "", "", "bytes");
+
+    for (uint32_t sweep = 0; sweep < 2; sweep++) {
+        run_t off, on;
+        run(sweep, 0, frame_cnt, &off);
+        run(sweep, list_size, frame_cnt, &on);
+
+        printf("%s\n", sweep ? "Marker sweeping over the dashboard" : "Gauge, value and bars changing");
+        print_run("off", &off);
+        print_run("on", &on);
+        printf("Redraw CPU with lists: %.1f %%\n",
+               100.0 * redraw_ns(&on) / redraw_ns(&off));
+
+        /* The same pixels were flushed */
+        CHECK(on.px == off.px);
+        CHECK(on.hash == off.hash);
+        CHECK(off.stats.record_cnt == 0);
+        CHECK(on.stats.max_used <= list_size);
+        if (!sweep) {
+            CHECK(on.stats.replay_cnt > on.stats.record_cnt);
+        }
+        /* The redraw CPU time is only reported, it's too noisy to compare with other tests running */
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
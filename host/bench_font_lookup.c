@@ -0,0 +1,319 @@
+/**
+ * @file bench_font_lookup.c
+ * @brief Character lookups of the shipped Montserrat fonts with and without the lookup tables
+ *
+ * Without the tables every character walks the cmaps of the font (the
+ * symbols are a bsearch in a sparse list) and the next character is looked
+ * up again for kerning. lv_font_fmt_txt_lookup_set_max_size() builds a
+ * direct table for the characters below 256, a hash table for the others and
+ * keeps the kerning classes next to the glyph ids.
+ *
+ * First every code point (U+0000 ... U+10FFFF) and every pair of the font's
+ * characters are looked up both ways and have to give the same glyph
+ * descriptors. Then the CPU time of the glyph descriptors of a paragraph, of
+ * the symbols and of lv_text_get_size() wrapping the paragraph is compared,
+ * the best of RUN_CNT runs. The symbols have to be faster with the hash table;
+ * the ASCII characters are a FORMAT0_TINY cmap already, they gain less.
+ *
+ * Usage: bench_font_lookup [--size BYTES] [--loops N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define LETTER_MAX          0x10FFFF
+#define LOOKUP_SIZE_DEF     2048
+#define LOOP_CNT_DEF        400
+#define RUN_CNT             5
+#define TEXT_WIDTH          460     /* A label on the 480 px wide display of main.c */
+
+static const char *text =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Pellentesque fringilla, lorem dapibus "
+    "fringilla feugiat, justo arcu volutpat magna, vitae ultricies metus tortor nec est. Fusce ut tellus "
+    "arcu. Fusce eu rutrum metus, nec porta felis. Sed sed ligula laoreet, sodales lacus blandit, elementum "
+    "justo. Sed posuere quam ut pellentesque ullamcorper. In quis consequat magna. Etiam quis turpis nec "
+    "lorem dictum finibus. Donec mattis enim dolor, consequat lacinia nisi scelerisque id. Nulla euismod, "
+    "purus sit amet accumsan tempus, lorem lectus euismod dolor, sit amet facilisis nisl quam elementum "
+    "nisi. Curabitur et massa eget lorem lacinia scelerisque eget vitae felis. Nulla facilisi. "
+    "AVA WAY Ty To 25 \xC2\xB0" "C";
+
+/* What the status bar and the buttons show */
+static const char *symbols =
+    LV_SYMBOL_WIFI LV_SYMBOL_BATTERY_FULL LV_SYMBOL_BATTERY_3 LV_SYMBOL_BATTERY_EMPTY LV_SYMBOL_CHARGE
+    LV_SYMBOL_BLUETOOTH LV_SYMBOL_GPS LV_SYMBOL_BELL LV_SYMBOL_SETTINGS LV_SYMBOL_HOME LV_SYMBOL_OK
+    LV_SYMBOL_CLOSE LV_SYMBOL_PLUS LV_SYMBOL_MINUS LV_SYMBOL_LEFT LV_SYMBOL_RIGHT LV_SYMBOL_UP LV_SYMBOL_DOWN
+    LV_SYMBOL_PLAY LV_SYMBOL_PAUSE LV_SYMBOL_STOP LV_SYMBOL_VOLUME_MAX LV_SYMBOL_MUTE LV_SYMBOL_REFRESH
+    LV_SYMBOL_TRASH LV_SYMBOL_EDIT LV_SYMBOL_SAVE LV_SYMBOL_WARNING LV_SYMBOL_UPLOAD LV_SYMBOL_DOWNLOAD;
+
+/**
+ * @brief What a code point gives without the tables
+ */
+typedef struct {
+    uint32_t letter;
+    lv_font_glyph_dsc_t dsc;
+} ref_glyph_t;
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static bool glyph_dsc_get(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter, uint32_t letter_next) {
+    memset(dsc, 0, sizeof(*dsc));
+    return font->get_glyph_dsc(font, dsc, letter, letter_next);
+}
+
+static const lv_font_fmt_txt_lookup_t *lookup_find(const lv_font_t *font) {
+    for (uint32_t b = 0; b < LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT; b++) {
+        for (const lv_font_fmt_txt_lookup_t *l = LV_GLOBAL_DEFAULT()->font_fmt_txt_lookup.buckets[b]; l;
+             l = l->bucket_next) {
+            if (l->fdsc == font->dsc) {
+                return l;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*===========================================
+ * Correctness
+ *===========================================*/
+
+/**
+ * @brief Compare every code point and every pair of characters with and without the tables
+ * @return The number of characters with a glyph
+ */
+static uint32_t sweep(const lv_font_t *font, uint32_t lookup_size) {
+    lv_font_fmt_txt_lookup_set_max_size(0);
+
+    uint32_t cnt = 0;
+    uint32_t cap = 256;
+    ref_glyph_t *ref = malloc(cap * sizeof(ref_glyph_t));
+    lv_font_glyph_dsc_t dsc;
+    for (uint32_t letter = 0; letter <= LETTER_MAX; letter++) {
+        if (!glyph_dsc_get(font, &dsc, letter, 0)) {
+            continue;
+        }
+        if (cnt == cap) {
+            cap *= 2;
+            ref = realloc(ref, cap * sizeof(ref_glyph_t));
+        }
+        ref[cnt].letter = letter;
+        ref[cnt].dsc = dsc;
+        cnt++;
+    }
+
+    uint16_t *ref_adv = malloc((size_t)cnt * cnt * sizeof(uint16_t));
+    for (uint32_t i = 0; i < cnt; i++) {
+        for (uint32_t j = 0; j < cnt; j++) {
+            glyph_dsc_get(font, &dsc, ref[i].letter, ref[j].letter);
+            ref_adv[i * cnt + j] = dsc.adv_w;
+        }
+    }
+
+    lv_font_fmt_txt_lookup_set_max_size(lookup_size);
+
+    uint32_t i = 0;
+    uint32_t mismatch = 0;
+    for (uint32_t letter = 0; letter <= LETTER_MAX; letter++) {
+        bool found = glyph_dsc_get(font, &dsc, letter, 0);
+        bool found_ref = i < cnt && ref[i].letter == letter;
+        if (found != found_ref || (found && memcmp(&dsc, &ref[i].dsc, sizeof(dsc)) != 0)) {
+            if (mismatch++ == 0) {
+                printf("U+%04X differs\n", (unsigned)letter);
+            }
+        }
+        if (found_ref) {
+            i++;
+        }
+    }
+
+    for (i = 0; i < cnt; i++) {
+        for (uint32_t j = 0; j < cnt; j++) {
+            glyph_dsc_get(font, &dsc, ref[i].letter, ref[j].letter);
+            if (dsc.adv_w != ref_adv[i * cnt + j] && mismatch++ == 0) {
+                printf("Kerning of U+%04X U+%04X differs\n", (unsigned)ref[i].letter, (unsigned)ref[j].letter);
+            }
+        }
+    }
+    CHECK(mismatch == 0);
+
+    free(ref_adv);
+    free(ref);
+    return cnt;
+}
+
+/*===========================================
+ * Benchmark
+ *===========================================*/
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    uint64_t text_ns;       /* The glyph descriptors of the text's characters */
+    uint64_t symbols_ns;    /* The glyph descriptors of the symbols */
+    uint64_t size_ns;       /* lv_text_get_size() of the text */
+    uint32_t adv_sum;       /* Of all the glyph descriptors, to compare the runs */
+    int32_t height;         /* Of the wrapped text */
+} run_t;
+
+/**
+ * @brief Code points of a string, 0 terminated
+ */
+typedef struct {
+    uint32_t letters[1024];
+    uint32_t cnt;
+} letters_t;
+
+static letters_t text_letters;
+static letters_t symbol_letters;
+
+static void letters_init(letters_t *l, const char *txt) {
+    uint32_t ofs = 0;
+    while (txt[ofs] && l->cnt < sizeof(l->letters) / sizeof(l->letters[0]) - 1) {
+        l->letters[l->cnt++] = lv_text_encoded_next(txt, &ofs);
+    }
+    l->letters[l->cnt] = 0;
+}
+
+/**
+ * @brief Look up every character with the next one for kerning, as lv_text_get_size() and the label drawing do
+ */
+static uint64_t glyphs_ns(const lv_font_t *font, const letters_t *l, uint32_t loop_cnt, run_t *res) {
+    lv_font_glyph_dsc_t dsc;
+    uint64_t t0 = cpu_ns();
+    for (uint32_t n = 0; n < loop_cnt; n++) {
+        for (uint32_t i = 0; i < l->cnt; i++) {
+            glyph_dsc_get(font, &dsc, l->letters[i], l->letters[i + 1]);
+            res->adv_sum += dsc.adv_w;
+        }
+    }
+    return cpu_ns() - t0;
+}
+
+static void run(const lv_font_t *font, uint32_t lookup_size, uint32_t loop_cnt, run_t *res) {
+    memset(res, 0, sizeof(*res));
+    lv_font_fmt_txt_lookup_set_max_size(lookup_size);
+
+    /* Build the tables outside of the measurement */
+    lv_font_glyph_dsc_t dsc;
+    glyph_dsc_get(font, &dsc, 'A', 0);
+
+    res->text_ns = glyphs_ns(font, &text_letters, loop_cnt, res);
+    res->symbols_ns = glyphs_ns(font, &symbol_letters, loop_cnt * 8, res);
+
+    uint64_t t0 = cpu_ns();
+    for (uint32_t n = 0; n < loop_cnt / 4; n++) {
+        lv_point_t size;
+        lv_text_get_size(&size, text, font, 0, 0, TEXT_WIDTH, LV_TEXT_FLAG_NONE);
+        res->height = size.y;
+    }
+    res->size_ns = cpu_ns() - t0;
+}
+
+static void best_of(uint64_t *best, uint64_t ns, int r) {
+    if (r == 0 || ns < *best) {
+        *best = ns;
+    }
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t lookup_size = LOOKUP_SIZE_DEF;
+    uint32_t loop_cnt = LOOP_CNT_DEF;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            lookup_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loop_cnt = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--size BYTES] [--loops N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    lv_init();
+    letters_init(&text_letters, text);
+    letters_init(&symbol_letters, symbols);
+
+    static const struct {
+        const lv_font_t *font;
+        const char *name;
+    } fonts[] = {
+        {&lv_font_montserrat_12, "montserrat_12"},
+        {&lv_font_montserrat_14, "montserrat_14"},
+        {&lv_font_montserrat_20, "montserrat_20"},
+        {&lv_font_montserrat_24, "montserrat_24"},
+        {&lv_font_montserrat_26, "montserrat_26"},
+    };
+
+    printf("Lookup tables of at most %u bytes, %u loops, ns per character, us per lv_text_get_size()\n",
+           (unsigned)lookup_size, (unsigned)loop_cnt);
+    printf("%-14s %5s %5s  %-21s  %-21s  %-21s\n", "Font", "Chars", "Bytes",
+           "Text off / on", "Symbols off / on", "Text size off / on");
+
+    for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+        const lv_font_t *font = fonts[f].font;
+        uint32_t char_cnt = sweep(font, lookup_size);
+
+        const lv_font_fmt_txt_lookup_t *lookup = lookup_find(font);
+        CHECK(lookup != NULL);
+        uint32_t used = lookup ? lookup->size : 0;
+        bool has_hash = lookup && lookup->hash_keys;
+        CHECK(used <= lookup_size);
+
+        run_t off = {0}, on = {0};
+        for (int r = 0; r < RUN_CNT; r++) {
+            run_t off_r, on_r;
+            run(font, 0, loop_cnt, &off_r);
+            run(font, lookup_size, loop_cnt, &on_r);
+
+            CHECK(on_r.adv_sum == off_r.adv_sum);
+            CHECK(on_r.height == off_r.height);
+
+            best_of(&off.text_ns, off_r.text_ns, r);
+            best_of(&on.text_ns, on_r.text_ns, r);
+            best_of(&off.symbols_ns, off_r.symbols_ns, r);
+            best_of(&on.symbols_ns, on_r.symbols_ns, r);
+            best_of(&off.size_ns, off_r.size_ns, r);
+            best_of(&on.size_ns, on_r.size_ns, r);
+        }
+
+        double text_cnt = (double)text_letters.cnt * loop_cnt;
+        double symbol_cnt = (double)symbol_letters.cnt * loop_cnt * 8;
+        double size_cnt = (double)(loop_cnt / 4) * 1000;
+        printf("%-14s %5u %5u  %6.1f / %5.1f (%3.0f%%)  %6.1f / %5.1f (%3.0f%%)  %6.1f / %5.1f (%3.0f%%)\n",
+               fonts[f].name, (unsigned)char_cnt, (unsigned)used,
+               off.text_ns / text_cnt, on.text_ns / text_cnt, 100.0 * on.text_ns / off.text_ns,
+               off.symbols_ns / symbol_cnt, on.symbols_ns / symbol_cnt, 100.0 * on.symbols_ns / off.symbols_ns,
+               off.size_ns / size_cnt, on.size_ns / size_cnt, 100.0 * on.size_ns / off.size_ns);
+
+        /* Without the hash table (a smaller --size) the symbols are searched as before */
+        if (has_hash) {
+            CHECK(on.symbols_ns < off.symbols_ns);
+        }
+    }
+
+    lv_deinit();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
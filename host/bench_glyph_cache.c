@@ -0,0 +1,304 @@
+/**
+ * @file bench_glyph_cache.c
+ * @brief Text scenes of lv_demo_benchmark() with and without the glyph cache
+ *
+ * The Montserrat fonts are stored with 4 bpp, so every glyph is expanded to
+ * A8 before it's blended; the glyphs of compressed fonts are decoded too.
+ * With lv_font_fmt_txt_cache_resize() the expanded bitmaps are kept and only
+ * the blending is left.
+ *
+ * The scenes are "Multiple labels" (rows of "Hello LVGL!" labels changing
+ * their color in every frame) and "Screen sized text" (a screen of text
+ * scrolling), as lv_demo_benchmark() builds them on the 480 x 320 display of
+ * main.c. Both run with lv_font_montserrat_20, the font of the demo, and
+ * with lv_font_montserrat_28_compressed.
+ *
+ * The CPU time between LV_EVENT_RENDER_START and LV_EVENT_RENDER_READY
+ * without the flush callback is compared, the best of RUN_CNT runs. The
+ * flushed frames have to be the same, and the cache has to stay in its
+ * budget. bench_glyph_cache_4 renders with 4 SW draw units sharing the
+ * cache (lv_conf_threads.h); the CPU time of the render threads is not
+ * measured there, only the frames are checked.
+ *
+ * Usage: bench_glyph_cache [--size BYTES] [--frames N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+
+/* Left out of the firmware by lv_conf.h, built here for the compressed runs */
+#undef LV_FONT_MONTSERRAT_28_COMPRESSED
+#define LV_FONT_MONTSERRAT_28_COMPRESSED 1
+#include "src/font/lv_font_montserrat_28_compressed.c"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define FRAME_CNT_DEF       300
+#define CACHE_SIZE_DEF      (16 * 1024)
+#define SCROLL_STEP         3
+#define RUN_CNT             3
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+static const char *lorem =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Pellentesque fringilla, lorem dapibus "
+    "fringilla feugiat, justo arcu volutpat magna, vitae ultricies metus tortor nec est. Fusce ut tellus "
+    "arcu. Fusce eu rutrum metus, nec porta felis. Sed sed ligula laoreet, sodales lacus blandit, elementum "
+    "justo. Sed posuere quam ut pellentesque ullamcorper. In quis consequat magna. Etiam quis turpis nec "
+    "lorem dictum finibus. Donec mattis enim dolor, consequat lacinia nisi scelerisque id. Nulla euismod, "
+    "purus sit amet accumsan tempus, lorem lectus euismod dolor, sit amet facilisis nisl quam elementum "
+    "nisi. Curabitur et massa eget lorem lacinia scelerisque eget vitae felis. Nulla facilisi.\n\n"
+    "Vivamus auctor sit amet ante id rhoncus. Duis a dolor neque. Mauris eu ornare tortor. Vivamus "
+    "consequat, ipsum a volutpat congue, sem libero laoreet nulla, malesuada efficitur leo orci a est. "
+    "Donec tincidunt nulla nibh, quis pretium mi fermentum quis. Fusce a mattis libero. Curabitur in felis "
+    "suscipit, ultrices diam imperdiet, vestibulum arcu. Praesent id faucibus turpis. Pellentesque sed "
+    "massa tincidunt, interdum purus tempus, pellentesque risus. Fusce feugiat magna eget nisl eleifend "
+    "efficitur. Mauris ut convallis justo. Integer malesuada rutrum orci non tincidunt.\n\n"
+    "Nullam aliquet leo sit amet volutpat tincidunt. Mauris ac accumsan nibh. Morbi accumsan commodo leo, "
+    "at hendrerit massa hendrerit et. Aliquam nec sodales ex. Morbi at aliquet sem. Sed at magna ut felis "
+    "mollis dictum ut ac orci. Nunc id lorem lacus. Vivamus id accumsan dolor, sed suscipit nulla. "
+    "Pellentesque dictum erat non bibendum tempor. Fusce arcu risus, eleifend in lacus a, iaculis "
+    "fermentum sapien. Praesent sodales libero vitae massa suscipit tincidunt. Aliquam quis arcu urna. "
+    "Nunc sit amet mi leo.";
+
+typedef enum {
+    SCENE_LABELS,
+    SCENE_TEXT,
+} scene_t;
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    uint64_t render_ns;     /* CPU time of the refreshes */
+    uint64_t flush_ns;
+    uint64_t px;            /* Pixels flushed */
+    uint32_t hash;          /* Of the flushed pixels */
+    size_t cache_used;      /* Bytes in the glyph cache at the end */
+} run_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+static uint64_t render_start_ns;
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    uint64_t t0 = cpu_ns();
+
+    /* FNV-1a of the area and its pixels */
+    const uint8_t *p = px_map;
+    size_t size = (size_t)lv_area_get_size(area) * 2;
+    uint32_t h = run_act->hash ^ (uint32_t)(area->x1 << 16 | area->y1);
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    run_act->hash = h;
+    run_act->px += lv_area_get_size(area);
+    lv_display_flush_ready(disp);
+
+    run_act->flush_ns += cpu_ns() - t0;
+}
+
+static void render_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        render_start_ns = cpu_ns();
+    } else {
+        run_act->render_ns += cpu_ns() - render_start_ns;
+    }
+}
+
+static uint64_t draw_ns(const run_t *res) {
+    return res->render_ns - res->flush_ns;
+}
+
+/*===========================================
+ * Scenes
+ *===========================================*/
+
+/**
+ * @brief Rows of labels as in multiple_labels_cb() of lv_demo_benchmark.c
+ */
+static void labels_create(lv_obj_t *scr, const lv_font_t *font) {
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_flex_align(scr, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_SPACE_EVENLY);
+
+    lv_point_t s;
+    lv_text_get_size(&s, "Hello LVGL!", font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+
+    int32_t hor_cnt = lv_obj_get_content_width(scr) / (s.x * 3 / 2);
+    int32_t ver_cnt = lv_obj_get_content_height(scr) / (s.y * 3);
+    for (int32_t y = 0; y < ver_cnt; y++) {
+        for (int32_t x = 0; x < hor_cnt; x++) {
+            lv_obj_t *obj = lv_label_create(scr);
+            if (x == 0) {
+                lv_obj_add_flag(obj, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK);
+            }
+            lv_label_set_text_static(obj, "Hello LVGL!");
+        }
+    }
+}
+
+static void labels_step(lv_obj_t *scr, uint32_t frame) {
+    uint32_t cnt = lv_obj_get_child_count(scr);
+    for (uint32_t i = 0; i < cnt; i++) {
+        lv_color_t c = lv_palette_main((lv_palette_t)((frame + i) % LV_PALETTE_LAST));
+        lv_obj_set_style_text_color(lv_obj_get_child(scr, (int32_t)i), c, 0);
+    }
+}
+
+static void run(scene_t scene, const lv_font_t *font, uint32_t cache_size, uint32_t frame_cnt, run_t *res) {
+    memset(res, 0, sizeof(*res));
+    run_act = res;
+    tick_ms = 0;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_font_fmt_txt_cache_resize(cache_size, true);
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_READY, NULL);
+    lv_sysmon_hide_performance(disp);
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    lv_obj_set_style_text_font(scr, font, 0);
+    if (scene == SCENE_LABELS) {
+        labels_create(scr, font);
+    } else {
+        lv_obj_t *label = lv_label_create(scr);
+        lv_obj_set_width(label, lv_pct(100));
+        lv_label_set_text_static(label, lorem);
+    }
+    lv_obj_update_layout(scr);
+    int32_t scroll_max = lv_obj_get_scroll_bottom(scr);
+
+    for (uint32_t i = 0; i < frame_cnt; i++) {
+        tick_ms += FRAME_MS;
+
+        if (scene == SCENE_LABELS) {
+            labels_step(scr, i);
+        } else {
+            /* Down and back up */
+            int32_t y = (int32_t)(i * SCROLL_STEP % (2 * scroll_max));
+            if (y > scroll_max) {
+                y = 2 * scroll_max - y;
+            }
+            lv_obj_scroll_to_y(scr, y, LV_ANIM_OFF);
+        }
+
+        lv_timer_handler();
+    }
+
+    res->cache_used = lv_cache_get_size(LV_GLOBAL_DEFAULT()->font_fmt_txt_cache, NULL);
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+static void print_run(const char *name, const run_t *res) {
+    printf("%-6s %9.2f %9.2f %9u\n", name, draw_ns(res) / 1e6, res->px / 1e6, (unsigned)res->cache_used);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t cache_size = CACHE_SIZE_DEF;
+    uint32_t frame_cnt = FRAME_CNT_DEF;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            cache_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_cnt = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("Usage: %s [--size BYTES] [--frames N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("%u frames of %u ms, glyph cache of %u bytes\n", (unsigned)frame_cnt, FRAME_MS, (unsigned)cache_size);
+    printf("%-6s %9s %9s %9s\n", "Cache", "Render", "Flushed", "Cached");
+    printf("%-6s %9s %9s %9s\n", "", "CPU ms", "Mpx", "bytes");
+
+    static const char *scene_names[] = {"Multiple labels", "Screen sized text"};
+    static const struct {
+        const lv_font_t *font;
+        const char *name;
+    } fonts[] = {
+        {&lv_font_montserrat_20, "montserrat_20, 4 bpp"},
+        {&lv_font_montserrat_28_compressed, "montserrat_28_compressed"},
+    };
+    for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+        for (int scene = SCENE_LABELS; scene <= SCENE_TEXT; scene++) {
+            run_t off, on;
+            for (int r = 0; r < RUN_CNT; r++) {
+                run_t off_r, on_r;
+                run((scene_t)scene, fonts[f].font, 0, frame_cnt, &off_r);
+                run((scene_t)scene, fonts[f].font, cache_size, frame_cnt, &on_r);
+
+                /* The same pixels were flushed */
+                CHECK(on_r.px == off_r.px);
+                CHECK(on_r.hash == off_r.hash);
+                CHECK(off_r.cache_used == 0);
+                CHECK(on_r.cache_used > 0 && on_r.cache_used <= cache_size);
+
+                if (r == 0 || draw_ns(&off_r) < draw_ns(&off)) {
+                    off = off_r;
+                }
+                if (r == 0 || draw_ns(&on_r) < draw_ns(&on)) {
+                    on = on_r;
+                }
+            }
+
+            printf("%s, %s\n", scene_names[scene], fonts[f].name);
+            print_run("off", &off);
+            print_run("on", &on);
+            printf("Render CPU with the cache: %.1f %%\n", 100.0 * draw_ns(&on) / draw_ns(&off));
+
+#if LV_USE_OS == LV_OS_NONE
+            /* Decoding is the expensive part, the 4 bpp expansion is close to the noise */
+            if (fonts[f].font == &lv_font_montserrat_28_compressed) {
+                CHECK(draw_ns(&on) < draw_ns(&off));
+            }
+#endif
+        }
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * @file bench_idle.c
+ * @brief Idle CPU and wake-up latency of the tickless main loop
+ *
+ * Runs a mostly idle screen (a label updated by a 250 ms timer and a button
+ * that gets tapped every 150 ms) twice: with the old loop that calls
+ * lv_timer_handler() back to back, and with the idle_loop.c loop of main.c,
+ * where core_port_sleep() is a condition variable wait. A thread plays the
+ * touch INT: it pushes the samples into the touch ring and wakes the loop.
+ *
+ * Reports the CPU time of the LVGL thread, the INT to lv_indev_read() latency
+ * and how late the 250 ms timer runs. Fails if the tickless loop doesn't use
+ * a fraction of the CPU of the spinning one, or is never woken by the touch.
+ * The latencies are only reported: they are the wake-up jitter of the host
+ * threads, and grow with the load of the host (e.g. ctest -j).
+ *
+ * Usage: bench_idle [--seconds N]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "core_port.h"
+#include "touch_ring.h"
+#include "idle_loop.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define LABEL_PERIOD_MS     250
+#define TAP_PERIOD_MS       150
+#define REPORT_MS           10      /* FT6336U report period while touched */
+
+/* Pass limit of the tickless loop */
+#define MAX_CPU_RATIO       4       /* At most 1/4 of the CPU time of the spinning loop */
+
+static uint8_t disp_buf[DISP_HOR_RES * 40 * 2];
+
+/**
+ * @brief Measurements of one run
+ */
+typedef struct {
+    uint32_t loops;
+    uint32_t cpu_us;            /* CPU time of the LVGL thread */
+    uint32_t wall_us;
+    uint32_t touch_latency_avg_us;
+    uint32_t touch_latency_max_us;
+    uint32_t timer_late_max_ms; /* Worst delay of the label timer past its period */
+    uint32_t taps;
+} run_result_t;
+
+static lv_obj_t *label;
+static uint32_t label_last_ms;
+static uint32_t timer_late_max_ms;
+static uint32_t taps;
+
+static volatile bool producer_stop;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(now_ns() / 1000000u);
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+static void label_timer_cb(lv_timer_t *timer) {
+    (void)timer;
+    uint32_t now = lv_tick_get();
+    if (label_last_ms != 0) {
+        uint32_t elapsed = now - label_last_ms;
+        if (elapsed > LABEL_PERIOD_MS && elapsed - LABEL_PERIOD_MS > timer_late_max_ms) {
+            timer_late_max_ms = elapsed - LABEL_PERIOD_MS;
+        }
+    }
+    label_last_ms = now;
+    lv_label_set_text_fmt(label, "%u", (unsigned)(now / LABEL_PERIOD_MS));
+}
+
+static void click_cb(lv_event_t *e) {
+    (void)e;
+    taps++;
+}
+
+static void push_sample(bool pressed) {
+    ft6336u_touch_data_t data = {0};
+    if (pressed) {
+        data.touch_count = 1;
+        data.points[0] = (ft6336u_touch_point_t){.x = DISP_HOR_RES / 2, .y = DISP_VER_RES / 2, .valid = true};
+    }
+    touch_ring_push(&data, core_port_time_us());
+    idle_loop_wake();
+}
+
+/**
+ * @brief Touch INT stand-in: a short tap every TAP_PERIOD_MS
+ */
+static void *producer_thread(void *arg) {
+    (void)arg;
+    while (!producer_stop) {
+        struct timespec ts = {.tv_nsec = REPORT_MS * 1000000};
+        push_sample(true);
+        nanosleep(&ts, NULL);
+        push_sample(true);
+        nanosleep(&ts, NULL);
+        push_sample(false);
+
+        ts.tv_nsec = (TAP_PERIOD_MS - 2 * REPORT_MS) * 1000000;
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+static void drain_touch(lv_indev_t *indev) {
+    for (int i = 0; i < TOUCH_RING_LEN && touch_ring_pending(); i++) {
+        lv_indev_read(indev);
+    }
+}
+
+static void run(lv_indev_t *indev, bool tickless, uint32_t seconds, run_result_t *res) {
+    touch_ring_stats_t touch_before, touch_after;
+    touch_ring_get_stats(&touch_before);
+    label_last_ms = 0;
+    timer_late_max_ms = 0;
+    taps = 0;
+
+    uint64_t end = now_ns() + (uint64_t)seconds * 1000000000u;
+    uint64_t wall = now_ns();
+    uint64_t cpu = thread_cpu_ns();
+    uint32_t loops = 0;
+
+    while (now_ns() < end) {
+        if (tickless) {
+            /* The main loop of main.c */
+            idle_loop_begin();
+            drain_touch(indev);
+            idle_loop_sleep(lv_timer_handler());
+        } else {
+            /* The loop before idle_loop.c: no delay */
+            drain_touch(indev);
+            lv_timer_handler();
+        }
+        loops++;
+    }
+
+    res->cpu_us = (uint32_t)((thread_cpu_ns() - cpu) / 1000);
+    res->wall_us = (uint32_t)((now_ns() - wall) / 1000);
+    res->loops = loops;
+
+    touch_ring_get_stats(&touch_after);
+    uint32_t delivered = touch_after.delivered - touch_before.delivered;
+    res->touch_latency_avg_us = delivered ? (touch_after.latency_sum_us - touch_before.latency_sum_us) / delivered : 0;
+    /* The ring keeps the maximum of both runs, the spinning one runs first */
+    res->touch_latency_max_us = touch_after.latency_max_us;
+    res->timer_late_max_ms = timer_late_max_ms;
+    res->taps = taps;
+}
+
+static void print_result(const char *name, const run_result_t *res) {
+    printf("%-10s %10u %6.1f%% %11u %11u %12u %5u\n", name, (unsigned)res->loops,
+           res->cpu_us * 100.0 / (res->wall_us ? res->wall_us : 1),
+           (unsigned)res->touch_latency_avg_us, (unsigned)res->touch_latency_max_us,
+           (unsigned)res->timer_late_max_ms, (unsigned)res->taps);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t seconds = 2;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--seconds N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    idle_loop_init();
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    label = lv_label_create(scr);
+    lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 20);
+    lv_timer_create(label_timer_cb, LABEL_PERIOD_MS, NULL);
+
+    lv_obj_t *btn = lv_button_create(scr);
+    lv_obj_set_size(btn, 120, 60);
+    lv_obj_center(btn);
+    lv_obj_add_event_cb(btn, click_cb, LV_EVENT_CLICKED, NULL);
+
+    /* No controller: the producer thread fills the ring like the INT handler would */
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(indev, disp);
+    lv_indev_set_read_cb(indev, touch_ring_read_cb);
+    lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer_thread, NULL);
+
+    run_result_t spin, tickless;
+    run(indev, false, seconds, &spin);
+    run(indev, true, seconds, &tickless);
+
+    producer_stop = true;
+    pthread_join(thread, NULL);
+
+    idle_loop_stats_t stats;
+    idle_loop_get_stats(&stats);
+
+    printf("%u s per loop, label timer %u ms, a tap every %u ms\n",
+           (unsigned)seconds, LABEL_PERIOD_MS, TAP_PERIOD_MS);
+    printf("%-10s %10s %7s %11s %11s %12s %5s\n", "Loop", "Iterations", "CPU", "Touch avg", "Touch max",
+           "Timer late", "Taps");
+    printf("%-10s %10s %7s %11s %11s %12s %5s\n", "", "", "", "us", "us", "ms", "");
+    print_result("spin", &spin);
+    print_result("tickless", &tickless);
+    printf("Tickless: %u sleeps, %u woken early, %u ms asleep\n",
+           (unsigned)stats.sleeps, (unsigned)stats.wakeups, (unsigned)(stats.slept_us / 1000));
+
+    CHECK(tickless.cpu_us * MAX_CPU_RATIO < spin.cpu_us);
+    CHECK(tickless.taps > 0);
+    CHECK(stats.wakeups > 0);
+
+    lv_display_delete(disp);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file bench_inv_tiles.c
+ * @brief Dirty tiles vs. the list of invalidated areas
+ *
+ * Replays invalidated areas through lv_inv_area() on the 480 x 320 display
+ * of main.c, once with the list of areas joined by the sort and sweep, and
+ * once for each tile size of lv_display_set_inv_tile_size(). All of them use
+ * the cost model of main.c. Two workloads:
+ *
+ *   - the scenes of lv_demo_benchmark(), recorded by bench_area_join
+ *   - 300 digit labels counting with their own periods (as in
+ *     test_inv_overflow), hundreds of small areas per refresh
+ *
+ * Reports for each the CPU time of invalidating an area and of preparing a
+ * refresh (joining the list or turning the dirty tiles into areas), and the
+ * pixels rendered, the windows flushed (strips of the 40 line buffer ring)
+ * and the time the cost model estimates for them.
+ *
+ * Usage: bench_inv_tiles <trace>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry, buffers and cost model as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+#define DISP_AREA_COST_WINDOW_NS    30000
+#define DISP_AREA_COST_PX_NS        40
+#define SPI_BAUDRATE        (75 * 1000 * 1000)
+
+#define TRACE_FRAMES_MAX    20000
+#define TRACE_AREAS_MAX     200000
+#define CPU_REPEAT          20
+
+/* The labels: a digit in a 16 x 20 cell, 16 ms per frame */
+#define LABEL_CNT           300
+#define LABEL_FRAMES        150
+#define LABEL_PERIOD_MIN    16
+#define LABEL_PERIOD_MAX    100
+
+/**
+ * @brief Invalidated areas of one refresh
+ */
+typedef struct {
+    uint32_t first;         /* Index of the first area in `areas` */
+    uint32_t cnt;
+} frame_t;
+
+/**
+ * @brief Refreshes to replay
+ */
+typedef struct {
+    frame_t *frames;
+    uint32_t frame_cnt;
+    lv_area_t *areas;
+    uint32_t area_cnt;
+} workload_t;
+
+/**
+ * @brief Totals of one representation over a workload
+ */
+typedef struct {
+    uint64_t px;            /* Pixels rendered */
+    uint64_t windows;       /* Strips flushed */
+    uint64_t cost_ns;       /* Estimated by the cost model of main.c */
+    uint64_t inv_ns;        /* lv_inv_area(), for the whole workload */
+    uint64_t prep_ns;       /* Joining or turning the tiles into areas, for the whole workload */
+    uint32_t uncovered;     /* Invalidated pixels not refreshed */
+} result_t;
+
+static const lv_display_area_cost_t spi_cost = {
+    .window = DISP_AREA_COST_WINDOW_NS,
+    .px_render = DISP_AREA_COST_PX_NS,
+    .byte_flush = (uint32_t)(8ull * 1000000000u / SPI_BAUDRATE),
+};
+
+/* Pixels refreshed in a frame */
+static uint8_t cover_map[DISP_VER_RES][DISP_HOR_RES];
+
+/*===========================================
+ * Workloads
+ *===========================================*/
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void workload_init(workload_t *w) {
+    w->frames = malloc(TRACE_FRAMES_MAX * sizeof(frame_t));
+    w->areas = malloc(TRACE_AREAS_MAX * sizeof(lv_area_t));
+    w->frame_cnt = 0;
+    w->area_cnt = 0;
+}
+
+static void workload_free(workload_t *w) {
+    free(w->frames);
+    free(w->areas);
+}
+
+static bool load_trace(workload_t *w, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+
+    char line[4096];
+    while (fgets(line, sizeof(line), f) && w->frame_cnt < TRACE_FRAMES_MAX) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        char *p = line;
+        unsigned long cnt = strtoul(p, &p, 10);
+        if (cnt == 0 || w->area_cnt + cnt > TRACE_AREAS_MAX) {
+            continue;
+        }
+        frame_t *frame = &w->frames[w->frame_cnt++];
+        frame->first = w->area_cnt;
+        frame->cnt = (uint32_t)cnt;
+        for (uint32_t i = 0; i < cnt; i++) {
+            lv_area_t *a = &w->areas[w->area_cnt++];
+            a->x1 = (int32_t)strtol(p, &p, 10);
+            a->y1 = (int32_t)strtol(p, &p, 10);
+            a->x2 = (int32_t)strtol(p, &p, 10);
+            a->y2 = (int32_t)strtol(p, &p, 10);
+        }
+    }
+    fclose(f);
+    return w->frame_cnt > 0;
+}
+
+/* The area of every label whose digit changed in the frame */
+static void make_labels(workload_t *w) {
+    const uint32_t cols = DISP_HOR_RES / 16;
+    uint32_t period[LABEL_CNT];
+    uint32_t phase[LABEL_CNT];
+
+    lv_rand_set_seed(LABEL_CNT);
+    for (uint32_t i = 0; i < LABEL_CNT; i++) {
+        period[i] = lv_rand(LABEL_PERIOD_MIN, LABEL_PERIOD_MAX);
+        phase[i] = lv_rand(0, period[i] * 10);
+    }
+
+    for (uint32_t t = 1; t <= LABEL_FRAMES; t++) {
+        frame_t *frame = &w->frames[w->frame_cnt++];
+        frame->first = w->area_cnt;
+        frame->cnt = 0;
+        for (uint32_t i = 0; i < LABEL_CNT; i++) {
+            if ((t * 16 + phase[i]) / period[i] == ((t - 1) * 16 + phase[i]) / period[i]) {
+                continue;
+            }
+            int32_t x = (int32_t)(i % cols) * 16 + 3;
+            int32_t y = (int32_t)(i / cols) * 20 + 2;
+            lv_area_set(&w->areas[w->area_cnt++], x, y, x + 8, y + 15);
+            frame->cnt++;
+        }
+    }
+}
+
+/*===========================================
+ * Replay
+ *===========================================*/
+
+static void invalidate_frame(lv_display_t *disp, const workload_t *w, const frame_t *frame) {
+    for (uint32_t a = 0; a < frame->cnt; a++) {
+        lv_inv_area(disp, &w->areas[frame->first + a]);
+    }
+}
+
+/* What lv_display_refr_timer() does before rendering */
+static void prepare_refresh(lv_display_t *disp) {
+    if (lv_display_get_inv_tile_size(disp)) {
+        lv_refr_inv_tiles_to_areas(disp);
+    } else {
+        lv_refr_join_areas_sweep(disp);
+    }
+}
+
+static void end_refresh(lv_display_t *disp) {
+    memset(disp->inv_area_joined, 0, disp->inv_p);
+    disp->inv_p = 0;
+}
+
+static uint32_t count_uncovered(const lv_area_t *area) {
+    uint32_t cnt = 0;
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        for (int32_t x = area->x1; x <= area->x2; x++) {
+            cnt += !cover_map[y][x];
+        }
+    }
+    return cnt;
+}
+
+static void run(lv_display_t *disp, const workload_t *w, uint32_t tile_size, result_t *res) {
+    memset(res, 0, sizeof(*res));
+    lv_inv_area(disp, NULL);
+    lv_display_set_inv_tile_size(disp, tile_size);
+
+    /* Invalidating only, then also preparing, repeated for a measurable time */
+    uint64_t start = cpu_ns();
+    for (uint32_t r = 0; r < CPU_REPEAT; r++) {
+        for (uint32_t i = 0; i < w->frame_cnt; i++) {
+            invalidate_frame(disp, w, &w->frames[i]);
+            lv_inv_area(disp, NULL);
+        }
+    }
+    uint64_t mid = cpu_ns();
+    for (uint32_t r = 0; r < CPU_REPEAT; r++) {
+        for (uint32_t i = 0; i < w->frame_cnt; i++) {
+            invalidate_frame(disp, w, &w->frames[i]);
+            prepare_refresh(disp);
+            end_refresh(disp);
+        }
+    }
+    uint64_t end = cpu_ns();
+    res->inv_ns = (mid - start) / CPU_REPEAT;
+    res->prep_ns = end - mid > mid - start ? (end - mid - (mid - start)) / CPU_REPEAT : 0;
+
+    /* What the refresh does with the areas, estimated with the cost model of main.c */
+    for (uint32_t i = 0; i < w->frame_cnt; i++) {
+        const frame_t *frame = &w->frames[i];
+        invalidate_frame(disp, w, frame);
+        prepare_refresh(disp);
+
+        memset(cover_map, 0, sizeof(cover_map));
+        for (uint32_t a = 0; a < disp->inv_p; a++) {
+            if (disp->inv_area_joined[a]) {
+                continue;
+            }
+            const lv_area_t *area = &disp->inv_areas[a];
+            int32_t w_px = lv_area_get_width(area);
+            int32_t h_px = lv_area_get_height(area);
+            int32_t max_row = LV_MIN(h_px, DISP_BUF_SIZE / w_px);
+            uint32_t strips = (uint32_t)((h_px + max_row - 1) / max_row);
+            res->px += lv_area_get_size(area);
+            res->windows += strips;
+            /* Every strip is a window on the bus */
+            res->cost_ns += lv_display_get_area_cost(disp, area) + (uint64_t)(strips - 1) * spi_cost.window;
+            for (int32_t y = area->y1; y <= area->y2; y++) {
+                memset(&cover_map[y][area->x1], 1, w_px);
+            }
+        }
+        for (uint32_t a = 0; a < frame->cnt; a++) {
+            res->uncovered += count_uncovered(&w->areas[frame->first + a]);
+        }
+        end_refresh(disp);
+    }
+}
+
+static void print_result(const char *name, const workload_t *w, const result_t *res) {
+    printf("%-16s %10.0f %9.0f %9.2f %8llu %10.1f\n", name, (double)res->inv_ns / w->area_cnt,
+           (double)res->prep_ns / w->frame_cnt, res->px / 1e6, (unsigned long long)res->windows,
+           res->cost_ns / 1e6);
+}
+
+static void compare(lv_display_t *disp, const char *title, const workload_t *w) {
+    static const uint32_t tile_sizes[] = {0, 8, 16, 32};
+
+    printf("\n%s: %u refreshes, %.1f areas on average\n", title, (unsigned)w->frame_cnt,
+           (double)w->area_cnt / w->frame_cnt);
+    printf("%-16s %10s %9s %9s %8s %10s\n", "Invalidation", "Invalidate", "Prepare", "Rendered", "Windows",
+           "Estimated");
+    printf("%-16s %10s %9s %9s %8s %10s\n", "", "ns/area", "ns/frame", "Mpx", "", "ms");
+    for (uint32_t i = 0; i < sizeof(tile_sizes) / sizeof(tile_sizes[0]); i++) {
+        char name[32];
+        if (tile_sizes[i] == 0) {
+            snprintf(name, sizeof(name), "list, sweep");
+        } else {
+            snprintf(name, sizeof(name), "tiles %ux%u", (unsigned)tile_sizes[i], (unsigned)tile_sizes[i]);
+        }
+        result_t res;
+        run(disp, w, tile_sizes[i], &res);
+        print_result(name, w, &res);
+
+        /* Every invalidated pixel is refreshed */
+        CHECK(res.uncovered == 0);
+    }
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <trace>\n", argv[0]);
+        return 1;
+    }
+    workload_t demo;
+    workload_init(&demo);
+    if (!load_trace(&demo, argv[1])) {
+        fprintf(stderr, "Can't load the trace %s\n", argv[1]);
+        return 1;
+    }
+    workload_t labels;
+    workload_init(&labels);
+    make_labels(&labels);
+
+    lv_init();
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_area_cost(disp, &spi_cost);
+
+    printf("Cost model: %u ns per window, %u ns per pixel, %u ns per byte\n", (unsigned)spi_cost.window,
+           (unsigned)spi_cost.px_render, (unsigned)spi_cost.byte_flush);
+    compare(disp, "Benchmark demo", &demo);
+    compare(disp, "300 counting labels", &labels);
+
+    lv_display_delete(disp);
+    workload_free(&demo);
+    workload_free(&labels);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
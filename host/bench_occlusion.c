@@ -0,0 +1,364 @@
+/**
+ * @file bench_occlusion.c
+ * @brief Overdraw with and without occlusion culling
+ *
+ * Renders the same frames on the 480 x 320 display of main.c twice, without
+ * and with lv_display_set_occlusion_culling(), and checks that every flushed
+ * pixel is the same. Two workloads:
+ *
+ *   - lv_demo_benchmark(), every scene, with a simulated 16 ms tick
+ *   - a stack of cards sliding over each other, like the notifications or
+ *     the pages of a card stack: most of every card is hidden by the next
+ *
+ * Reports per scene the overdraw (pixels of the draw tasks per refreshed
+ * pixel, as sysmon shows it) with and without culling, and the CPU time of
+ * the refreshes.
+ *
+ * Usage: bench_occlusion
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "demos/lv_demos.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define SCENE_MAX           32
+#define CARD_CNT            6
+#define CARD_FRAMES         300
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of a scene
+ */
+typedef struct {
+    uint64_t render_px;     /* Pixels of the refreshed areas */
+    uint64_t draw_px;       /* Pixels of the draw tasks which were drawn */
+    uint64_t culled_px;     /* Pixels of the draw tasks dropped or clipped */
+    uint64_t cpu_ns;
+} scene_stats_t;
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    scene_stats_t scenes[SCENE_MAX];
+    const char *names[SCENE_MAX];
+    uint32_t scene_cnt;
+    uint32_t hash;          /* Of every flushed area and pixel */
+} run_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+static uint64_t cpu_pending;
+static volatile bool bench_done;
+
+/* Counters of every sysmon report, with the simulated time of the report */
+static uint32_t report_ticks[4096];
+static scene_stats_t reports[4096];
+static uint32_t report_cnt;
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    run_act->hash = fnv1a(run_act->hash, area, sizeof(*area));
+    run_act->hash = fnv1a(run_act->hash, px_map, lv_area_get_size(area) * 2);
+    lv_display_flush_ready(disp);
+}
+
+/**
+ * @brief Collect the counters of every sysmon report, before they are reset
+ */
+static void perf_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    const lv_sysmon_perf_info_t *perf = lv_subject_get_pointer(subject);
+    if (report_cnt == sizeof(reports) / sizeof(reports[0])) {
+        return;
+    }
+    report_ticks[report_cnt] = tick_ms;
+    scene_stats_t *r = &reports[report_cnt++];
+    r->render_px = perf->measured.render_px;
+    r->draw_px = perf->measured.draw_px;
+    r->culled_px = perf->measured.draw_px_culled;
+    r->cpu_ns = cpu_pending;
+    cpu_pending = 0;
+
+    /* The title of the demo shows the measured CPU load, keep its pixels the same in every run */
+    lv_obj_t *title = lv_observer_get_target(observer);
+    if (title) {
+        lv_label_set_text(title, "lv_demo_benchmark\nsysmon values hidden");
+    }
+}
+
+static lv_display_t *display_create(bool culling) {
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_set_occlusion_culling(disp, culling);
+    /* The overdraw line is only shown with culling */
+    lv_sysmon_hide_performance(disp);
+    return disp;
+}
+
+static void step(void) {
+    tick_ms += FRAME_MS;
+    uint64_t t0 = cpu_ns();
+    lv_timer_handler();
+    cpu_pending += cpu_ns() - t0;
+}
+
+/*===========================================
+ * Benchmark Demo
+ *===========================================*/
+
+static void bench_end_cb(const lv_demo_benchmark_summary_t *summary) {
+    /* Attribute the reports to the scenes by their time */
+    uint32_t scene_end = 0;
+    uint32_t r = 0;
+    for (const lv_demo_benchmark_scene_dsc_t *scene = summary->scenes;
+         scene->scene_time && run_act->scene_cnt < SCENE_MAX; scene++) {
+        scene_end += scene->scene_time;
+        scene_stats_t *s = &run_act->scenes[run_act->scene_cnt];
+        run_act->names[run_act->scene_cnt++] = scene->name;
+        for (; r < report_cnt && report_ticks[r] <= scene_end; r++) {
+            s->render_px += reports[r].render_px;
+            s->draw_px += reports[r].draw_px;
+            s->culled_px += reports[r].culled_px;
+            s->cpu_ns += reports[r].cpu_ns;
+        }
+    }
+    bench_done = true;
+}
+
+static void run_demo(bool culling, run_t *run) {
+    memset(run, 0, sizeof(*run));
+    run->hash = 2166136261u;
+    run_act = run;
+    report_cnt = 0;
+    cpu_pending = 0;
+    tick_ms = 0;
+    bench_done = false;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_display_t *disp = display_create(culling);
+
+    lv_demo_benchmark_set_end_cb(bench_end_cb);
+    lv_demo_benchmark();
+    /* After the observer of the demo, to overwrite its title */
+    lv_subject_add_observer_with_target(&disp->perf_sysmon_backend.subject, perf_observer_cb,
+                                        lv_obj_get_child(lv_layer_top(), 0), NULL);
+    while (!bench_done) {
+        step();
+    }
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+/*===========================================
+ * Card Stack
+ *===========================================*/
+
+static void card_y_cb(void *obj, int32_t v) {
+    lv_obj_set_y(obj, v);
+}
+
+static lv_obj_t *card_create(lv_obj_t *parent, uint32_t i) {
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_remove_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(card, 400, 140);
+    lv_obj_set_x(card, 40);
+    lv_obj_set_style_bg_color(card, lv_palette_lighten(LV_PALETTE_BLUE_GREY, 1 + i % 4), 0);
+
+    lv_obj_t *title = lv_label_create(card);
+    lv_label_set_text_fmt(title, "Notification %u", (unsigned)i);
+
+    lv_obj_t *text = lv_label_create(card);
+    lv_label_set_text(text, "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+                      "tempor incididunt ut labore et dolore magna aliqua.");
+    lv_obj_set_width(text, lv_pct(100));
+    lv_obj_set_y(text, 24);
+
+    lv_obj_t *btn = lv_button_create(card);
+    lv_obj_align(btn, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_label_set_text(lv_label_create(btn), "Open");
+
+    /* Slide up and down over the previous card, each with its own phase */
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, card);
+    lv_anim_set_exec_cb(&a, card_y_cb);
+    lv_anim_set_values(&a, 10 + (int32_t)i * 30, 30 + (int32_t)i * 30);
+    lv_anim_set_duration(&a, 800 + i * 150);
+    lv_anim_set_playback_duration(&a, 800 + i * 150);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+    return card;
+}
+
+static void run_cards(bool culling, run_t *run) {
+    memset(run, 0, sizeof(*run));
+    run->hash = 2166136261u;
+    run_act = run;
+    report_cnt = 0;
+    cpu_pending = 0;
+    tick_ms = 0;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_display_t *disp = display_create(culling);
+    lv_subject_add_observer(&disp->perf_sysmon_backend.subject, perf_observer_cb, NULL);
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    for (uint32_t i = 0; i < CARD_CNT; i++) {
+        card_create(scr, i);
+    }
+    for (uint32_t i = 0; i < CARD_FRAMES; i++) {
+        step();
+    }
+
+    run->names[0] = "Card stack";
+    run->scene_cnt = 1;
+    for (uint32_t r = 0; r < report_cnt; r++) {
+        run->scenes[0].render_px += reports[r].render_px;
+        run->scenes[0].draw_px += reports[r].draw_px;
+        run->scenes[0].culled_px += reports[r].culled_px;
+        run->scenes[0].cpu_ns += reports[r].cpu_ns;
+    }
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+/**
+ * @brief Run in a child process
+ *
+ * The demos keep state in static variables, lv_deinit() doesn't reset those:
+ * every run starts from the same state in a fresh copy of the process.
+ */
+static void run_forked(void (*run_cb)(bool culling, run_t *run), bool culling, run_t *run) {
+    run_t *shared = mmap(NULL, sizeof(run_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CHECK(shared != MAP_FAILED);
+    if (shared == MAP_FAILED) {
+        return;
+    }
+    memset(shared, 0, sizeof(*shared));
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        run_cb(culling, shared);
+        _exit(0);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    *run = *shared;
+    munmap(shared, sizeof(run_t));
+}
+
+/*===========================================
+ * Report
+ *===========================================*/
+
+static void print_scene(const char *name, const scene_stats_t *off, const scene_stats_t *on) {
+    double render_px = off->render_px ? (double)off->render_px : 1;
+    printf("%-32s %8.2f %8.2f %8.2f %9.2f %9.2f\n", name,
+           off->render_px / 1e6,
+           off->draw_px / render_px, on->draw_px / render_px,
+           off->cpu_ns / 1e6, on->cpu_ns / 1e6);
+}
+
+static void compare(const run_t *off, const run_t *on) {
+    scene_stats_t total_off = {0};
+    scene_stats_t total_on = {0};
+    for (uint32_t i = 0; i < off->scene_cnt; i++) {
+        const scene_stats_t *s_off = &off->scenes[i];
+        const scene_stats_t *s_on = &on->scenes[i];
+        print_scene(off->names[i], s_off, s_on);
+
+        /* The same draw tasks were added for the same areas */
+        CHECK(s_on->render_px == s_off->render_px);
+        CHECK(s_on->draw_px + s_on->culled_px == s_off->draw_px);
+        CHECK(s_off->culled_px == 0);
+
+        total_off.render_px += s_off->render_px;
+        total_off.draw_px += s_off->draw_px;
+        total_off.cpu_ns += s_off->cpu_ns;
+        total_on.draw_px += s_on->draw_px;
+        total_on.cpu_ns += s_on->cpu_ns;
+    }
+    if (off->scene_cnt > 1) {
+        print_scene("Total", &total_off, &total_on);
+    }
+
+    /* And the same pixels were flushed */
+    CHECK(off->scene_cnt == on->scene_cnt);
+    CHECK(off->hash == on->hash);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(void) {
+    static run_t off, on;
+
+    printf("%u ms frames, overdraw: pixels of the draw tasks per refreshed pixel\n", FRAME_MS);
+    printf("%-32s %8s %8s %8s %9s %9s\n", "Scene", "Refr.", "Overdraw", "", "CPU", "");
+    printf("%-32s %8s %8s %8s %9s %9s\n", "", "Mpx", "", "culled", "ms", "culled");
+
+    run_forked(run_demo, false, &off);
+    run_forked(run_demo, true, &on);
+    compare(&off, &on);
+
+    run_forked(run_cards, false, &off);
+    run_forked(run_cards, true, &on);
+    compare(&off, &on);
+    /* Most of every card is hidden by the next, but a border counts all the pixels of its box */
+    CHECK(on.scenes[0].draw_px < off.scenes[0].draw_px * 4 / 5);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
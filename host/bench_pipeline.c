@@ -0,0 +1,189 @@
+/**
+ * @file bench_pipeline.c
+ * @brief Host benchmark of the dual-core render/flush pipeline
+ *
+ * Runs lv_demo_benchmark() on an ST7796 whose bus is simulated by spi_sim.c,
+ * either through lcd_pipeline.c (core 1 is a pthread) or with blocking
+ * transfers on core 0 for comparison. Rendering runs at host speed, so the
+ * numbers show how much of the SPI time the pipeline hides, not the FPS of
+ * the Pico itself.
+ *
+ * Usage: bench_pipeline [--blocking] [--baud HZ]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "src/drivers/display/st7796/lv_st7796.h"
+#include "demos/lv_demos.h"
+#include "lcd_pipeline.h"
+#include "spi_sim.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffers as main.c */
+#define DISP_HOR_RES    480
+#define DISP_VER_RES    320
+#define DISP_RING_STRIPS    6
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+static uint8_t disp_ring[DISP_RING_STRIPS][DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+static volatile bool bench_done;
+
+/* Load of core 1 as reported by lv_sysmon */
+static uint64_t core1_load_sum;
+static uint32_t core1_load_cnt;
+
+/*===========================================
+ * Simulated Bus Access
+ *===========================================*/
+
+/* Core 1 side of the pipeline */
+static void sim_send_cmd(const uint8_t *cmd, size_t cmd_size, const uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)param;
+    spi_sim_write_blocking(cmd_size + param_size);
+}
+
+static void sim_send_color(const uint8_t *cmd, size_t cmd_size, uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)param;
+    spi_sim_write_blocking(cmd_size + param_size);
+}
+
+/* Everything on core 0, the render thread waits for every transfer */
+static void blocking_send_cmd(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                              const uint8_t *param, size_t param_size) {
+    (void)disp;
+    sim_send_cmd(cmd, cmd_size, param, param_size);
+}
+
+static void blocking_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                                uint8_t *param, size_t param_size) {
+    sim_send_color(cmd, cmd_size, param, param_size);
+    lv_display_flush_ready(disp);
+}
+
+/*===========================================
+ * LVGL Callbacks
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void perf_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    (void)observer;
+    const lv_sysmon_perf_info_t *info = lv_subject_get_pointer(subject);
+    core1_load_sum += info->calculated.cpu_proc;
+    core1_load_cnt++;
+}
+
+static void bench_end_cb(const lv_demo_benchmark_summary_t *summary) {
+    printf("%-28s %6s %10s %10s %10s\n", "Scene", "FPS", "CPU core0", "Render ms", "Flush ms");
+    for (const lv_demo_benchmark_scene_dsc_t *scene = summary->scenes; scene->create_cb; scene++) {
+        if (scene->measurement_cnt == 0) {
+            continue;
+        }
+        printf("%-28s %6u %9u%% %10u %10u\n", scene->name,
+               (unsigned)(scene->fps_avg / scene->measurement_cnt),
+               (unsigned)(scene->cpu_avg_usage / scene->measurement_cnt),
+               (unsigned)(scene->render_avg_time / scene->measurement_cnt),
+               (unsigned)(scene->flush_avg_time / scene->measurement_cnt));
+    }
+
+    if (summary->valid_scene_cnt > 0) {
+        printf("%-28s %6u %9u%% %10u %10u\n", "All scenes (avg.)",
+               (unsigned)(summary->total_avg_fps / summary->valid_scene_cnt),
+               (unsigned)(summary->total_avg_cpu / summary->valid_scene_cnt),
+               (unsigned)(summary->total_avg_render_time / summary->valid_scene_cnt),
+               (unsigned)(summary->total_avg_flush_time / summary->valid_scene_cnt));
+    }
+
+    bench_done = true;
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    bool blocking = false;
+    uint32_t baudrate = SPI_SIM_DEFAULT_BAUDRATE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--blocking") == 0) {
+            blocking = true;
+        } else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baudrate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--blocking] [--baud HZ]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    spi_sim_init(baudrate);
+    printf("SPI %u MHz, %s\n", (unsigned)(baudrate / 1000000),
+           blocking ? "blocking transfers on core 0" : "render on core 0, flush on core 1");
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    lv_display_t *disp;
+    if (blocking) {
+        disp = lv_st7796_create(DISP_HOR_RES, DISP_VER_RES, LV_LCD_FLAG_BGR,
+                                blocking_send_cmd, blocking_send_color);
+    } else {
+        lcd_pipeline_sink_t sink = {
+            .send_cmd = sim_send_cmd,
+            .send_color = sim_send_color,
+            .swap_bytes = false,
+        };
+        lcd_pipeline_init(&sink);
+        disp = lv_st7796_create(DISP_HOR_RES, DISP_VER_RES, LV_LCD_FLAG_BGR,
+                                lcd_pipeline_send_cmd, lcd_pipeline_send_color);
+    }
+    lv_lcd_generic_mipi_set_address_mode(disp, false, true, true, true);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffer_ring(disp, disp_ring, sizeof(disp_ring[0]), DISP_RING_STRIPS);
+    if (!blocking) {
+        lv_display_set_flush_wait_cb(disp, lcd_pipeline_flush_wait_cb);
+        lv_sysmon_performance_set_proc_idle_cb(disp, lcd_pipeline_get_idle_percent);
+    }
+
+    lv_subject_add_observer(&disp->perf_sysmon_backend.subject, perf_observer_cb, NULL);
+
+    lv_demo_benchmark_set_end_cb(bench_end_cb);
+    lv_demo_benchmark();
+
+    uint32_t t_start = lv_tick_get();
+    while (!bench_done) {
+        lv_timer_handler();
+    }
+    uint32_t elapsed_ms = lv_tick_elaps(t_start);
+
+    spi_sim_stats_t bus;
+    spi_sim_get_stats(&bus);
+    printf("SPI bus busy %u%% (%llu KiB in %u ms)\n",
+           (unsigned)(bus.busy_ns / 10000 / (elapsed_ms ? elapsed_ms : 1)),
+           (unsigned long long)(bus.bytes / 1024), (unsigned)elapsed_ms);
+
+    if (!blocking) {
+        lcd_pipeline_stats_t stats;
+        lcd_pipeline_get_stats(&stats);
+        printf("Core 1: %u%% load (sysmon avg.), %u strips, core 0 waited for a free slot %u times\n",
+               (unsigned)(core1_load_cnt ? core1_load_sum / core1_load_cnt : 0),
+               (unsigned)stats.strips, (unsigned)stats.queue_full);
+    }
+
+    return 0;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file bench_render_cache.c
+ * @brief A dashboard under a small animated gauge, with and without the render cache
+ *
+ * The panels of the dashboard are expensive to draw (gradients, a rounded
+ * chart with a shadow) but rarely change; the gauge on top of the first one is
+ * animated in every frame and a value on the same panel changes once a
+ * second. Without the render cache every refresh of the gauge draws the
+ * panel under it again, with lv_obj_set_render_cache() it is drawn once into
+ * a buffer (and again when its value changes) and only copied.
+ *
+ * The panel covers its area, so its buffer is RGB565 like the display and
+ * fits into the default budget (LV_OBJ_RENDER_CACHE_DEF_SIZE). The whole
+ * LVGL heap is only 128 KB (LV_MEM_SIZE), so the rounded card with a shadow,
+ * which would need an ARGB8888 buffer, is not cached: nothing covers it.
+ *
+ * Runs the same frames on the 480 x 320 display of main.c without and with
+ * the cache and reports the CPU time of the refreshes, how often the panel
+ * was drawn and the size of the cache. The frames are compared at a few
+ * points, they may differ only by a rounding step.
+ *
+ * Usage: bench_render_cache
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define FRAME_CNT           300
+#define SAMPLE_EVERY        60      /* Compare the frames this often */
+#define SAMPLE_CNT          (FRAME_CNT / SAMPLE_EVERY)
+#define VALUE_EVERY         60      /* Change the value on the panel this often */
+#define MAX_DIFF            2       /* In 5 or 6 bit units of a channel */
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    uint64_t cpu_ns;
+    uint64_t px;            /* Pixels flushed */
+    uint32_t panel_draws;   /* Draw events of the panel under the gauge */
+    size_t cache_size;
+} run_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+
+/* The screen as flushed, in RGB565 (swapped) */
+static uint16_t screen[DISP_VER_RES][DISP_HOR_RES];
+static uint16_t samples[2][SAMPLE_CNT][DISP_VER_RES][DISP_HOR_RES];
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    const uint16_t *src = (const uint16_t *)px_map;
+    int32_t w = lv_area_get_width(area);
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&screen[y][area->x1], src, w * 2);
+        src += w;
+    }
+    run_act->px += lv_area_get_size(area);
+    lv_display_flush_ready(disp);
+}
+
+static void draw_main_cb(lv_event_t *e) {
+    (void)e;
+    run_act->panel_draws++;
+}
+
+/*===========================================
+ * Dashboard
+ *===========================================*/
+
+/**
+ * @brief An opaque panel with a gradient, a title and a chart
+ */
+static lv_obj_t *chart_panel_create(lv_obj_t *parent, int32_t x, int32_t y, const char *title,
+                                    lv_obj_t **value) {
+    lv_obj_t *panel = lv_obj_create(parent);
+    lv_obj_remove_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(panel, x, y);
+    lv_obj_set_size(panel, 220, 140);
+    lv_obj_set_style_radius(panel, 0, 0);
+    lv_obj_set_style_bg_color(panel, lv_palette_darken(LV_PALETTE_BLUE_GREY, 3), 0);
+    lv_obj_set_style_bg_grad_color(panel, lv_palette_darken(LV_PALETTE_BLUE_GREY, 4), 0);
+    lv_obj_set_style_bg_grad_dir(panel, LV_GRAD_DIR_VER, 0);
+    lv_obj_set_style_shadow_width(panel, 0, 0);
+    lv_obj_set_style_pad_all(panel, 8, 0);
+    lv_obj_set_style_text_color(panel, lv_color_white(), 0);
+
+    lv_label_set_text(lv_label_create(panel), title);
+    *value = lv_label_create(panel);
+    lv_label_set_text(*value, "");
+    lv_obj_align(*value, LV_ALIGN_TOP_RIGHT, 0, 0);
+
+    lv_obj_t *chart = lv_chart_create(panel);
+    lv_obj_set_size(chart, lv_pct(100), 90);
+    lv_obj_align(chart, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_radius(chart, 10, 0);
+    lv_obj_set_style_shadow_width(chart, 24, 0);
+    lv_obj_set_style_shadow_spread(chart, 2, 0);
+    lv_obj_set_style_bg_grad_color(chart, lv_palette_lighten(LV_PALETTE_BLUE_GREY, 3), 0);
+    lv_obj_set_style_bg_grad_dir(chart, LV_GRAD_DIR_VER, 0);
+    lv_chart_set_point_count(chart, 24);
+    lv_chart_set_div_line_count(chart, 4, 6);
+    lv_chart_series_t *s1 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_CYAN), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_series_t *s2 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_AMBER), LV_CHART_AXIS_PRIMARY_Y);
+    for (uint32_t i = 0; i < 24; i++) {
+        lv_chart_set_next_value(chart, s1, (int32_t)lv_rand(20, 80));
+        lv_chart_set_next_value(chart, s2, (int32_t)lv_rand(10, 60));
+    }
+    return panel;
+}
+
+/**
+ * @brief A rounded card with a shadow
+ */
+static lv_obj_t *card_create(lv_obj_t *parent, int32_t x, int32_t y) {
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_remove_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(card, x, y);
+    lv_obj_set_size(card, 120, 70);
+    lv_obj_set_style_radius(card, 12, 0);
+    lv_obj_set_style_shadow_width(card, 10, 0);
+    lv_obj_set_style_shadow_offset_y(card, 3, 0);
+    lv_obj_set_style_bg_grad_color(card, lv_palette_lighten(LV_PALETTE_BLUE, 4), 0);
+    lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_VER, 0);
+
+    lv_label_set_text(lv_label_create(card), "Pressure\n101 kPa");
+    return card;
+}
+
+static void run(bool cache, run_t *res) {
+    memset(res, 0, sizeof(*res));
+    run_act = res;
+    tick_ms = 0;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_rand_set_seed(1);
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_sysmon_hide_performance(disp);
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    lv_obj_t *value;
+    lv_obj_t *value2;
+    lv_obj_t *panel = chart_panel_create(scr, 10, 10, "Temperature", &value);
+    chart_panel_create(scr, 250, 10, "Humidity", &value2);
+    lv_label_set_text(value2, "48 %");
+    card_create(scr, 20, 200);
+    lv_obj_add_event_cb(panel, draw_main_cb, LV_EVENT_DRAW_MAIN, NULL);
+    lv_obj_set_render_cache(panel, cache);
+
+    /* The gauge on top of the first panel */
+    lv_obj_t *gauge = lv_arc_create(scr);
+    lv_obj_set_size(gauge, 90, 90);
+    lv_obj_set_pos(gauge, 120, 50);
+    lv_obj_remove_flag(gauge, LV_OBJ_FLAG_CLICKABLE);
+
+    uint32_t sample = 0;
+    for (uint32_t i = 0; i < FRAME_CNT; i++) {
+        tick_ms += FRAME_MS;
+        lv_arc_set_value(gauge, (int32_t)(i % 100));
+        if (i % VALUE_EVERY == 0) {
+            lv_label_set_text_fmt(value, "%u.%u C", (unsigned)(21 + i / 600), (unsigned)(i / VALUE_EVERY % 10));
+        }
+
+        uint64_t t0 = cpu_ns();
+        lv_timer_handler();
+        res->cpu_ns += cpu_ns() - t0;
+
+        if (i % SAMPLE_EVERY == SAMPLE_EVERY - 1) {
+            memcpy(samples[cache][sample++], screen, sizeof(screen));
+        }
+    }
+    res->cache_size = lv_cache_get_size(LV_GLOBAL_DEFAULT()->obj_render_cache, NULL);
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+/**
+ * @brief Largest difference of a color channel between the sampled frames
+ */
+static uint32_t samples_diff(void) {
+    const uint16_t *a = &samples[0][0][0][0];
+    const uint16_t *b = &samples[1][0][0][0];
+    uint32_t max_diff = 0;
+    for (size_t i = 0; i < sizeof(samples[0]) / 2; i++) {
+        /* Swapped RGB565 */
+        uint16_t ca = (uint16_t)(a[i] << 8 | a[i] >> 8);
+        uint16_t cb = (uint16_t)(b[i] << 8 | b[i] >> 8);
+        int32_t d[3] = {
+            (ca & 0x1F) - (cb & 0x1F),
+            ((ca >> 5) & 0x3F) - ((cb >> 5) & 0x3F),
+            (ca >> 11) - (cb >> 11),
+        };
+        for (uint32_t c = 0; c < 3; c++) {
+            uint32_t ad = (uint32_t)abs(d[c]);
+            if (ad > max_diff) {
+                max_diff = ad;
+            }
+        }
+    }
+    return max_diff;
+}
+
+static void print_run(const char *name, const run_t *res) {
+    printf("%-14s %9.2f %9.2f %12u %10u\n", name, res->cpu_ns / 1e6, res->px / 1e6,
+           (unsigned)res->panel_draws, (unsigned)res->cache_size);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(void) {
+    run_t off, on;
+
+    printf("%u frames of %u ms, a gauge animated over a chart panel\n", FRAME_CNT, FRAME_MS);
+    printf("%-14s %9s %9s %12s %10s\n", "Render cache", "CPU", "Flushed", "Panel draws", "Cache");
+    printf("%-14s %9s %9s %12s %10s\n", "", "ms", "Mpx", "", "bytes");
+
+    run(false, &off);
+    run(true, &on);
+    print_run("off", &off);
+    print_run("on", &on);
+    uint32_t diff = samples_diff();
+    printf("Largest difference of a channel: %u\n", (unsigned)diff);
+
+    /* The same areas were refreshed */
+    CHECK(on.px == off.px);
+    CHECK(diff <= MAX_DIFF);
+    CHECK(on.cache_size > 0 && on.cache_size <= LV_OBJ_RENDER_CACHE_DEF_SIZE);
+    /* The panel was drawn only when its value changed */
+    CHECK(on.panel_draws <= FRAME_CNT / VALUE_EVERY);
+    CHECK(on.panel_draws < off.panel_draws);
+    /* The CPU time is only reported: the runs are too short to compare it reliably */
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
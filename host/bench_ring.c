@@ -0,0 +1,226 @@
+/**
+ * @file bench_ring.c
+ * @brief Host benchmark of the flush buffer ring depth and strip height
+ *
+ * Redraws a full screen of widgets through lcd_pipeline.c over the bus
+ * simulated by spi_sim.c, once for every combination of ring depth and strip
+ * height, and reports the time from the invalidation to the last strip on the
+ * wire. The host renders far faster than the RP2350, so every strip's render
+ * time is stretched by `--cpu-scale` to get closer to the real balance of
+ * render and SPI time.
+ *
+ * Usage: bench_ring [--baud HZ] [--cpu-scale N] [--frames N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "src/drivers/display/st7796/lv_st7796.h"
+#include "lcd_pipeline.h"
+#include "core_port.h"
+#include "spi_sim.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define DISP_HOR_RES    480
+#define DISP_VER_RES    320
+
+static const uint32_t ring_depths[] = {2, 3, 4, 6, 8};
+static const uint32_t strip_lines[] = {20, 40, 80, 160};
+
+#define MAX_DEPTH       8
+#define MAX_LINES       160
+#define STRIP_SIZE(lines)   (DISP_HOR_RES * (lines) * 2)
+
+static uint8_t ring_mem[MAX_DEPTH * STRIP_SIZE(MAX_LINES)] __attribute__((aligned(4)));
+
+/* Render slowdown applied to every strip */
+static uint32_t cpu_scale = 10;
+
+/* Start of the strip being rendered, moved forward by the time spent waiting */
+static uint64_t render_start_ns;
+static uint64_t wait_ns;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(now_ns() / 1000000u);
+}
+
+/* Core 1 side of the pipeline */
+static void sim_send_cmd(const uint8_t *cmd, size_t cmd_size, const uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)param;
+    spi_sim_write_blocking(cmd_size + param_size);
+}
+
+static void sim_send_color(const uint8_t *cmd, size_t cmd_size, uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)param;
+    spi_sim_write_blocking(cmd_size + param_size);
+}
+
+/**
+ * @brief Stretch the render time of the strip, then queue it (core 0)
+ */
+static void slow_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                            uint8_t *param, size_t param_size) {
+    uint64_t now = now_ns();
+    uint64_t until = now + (now - render_start_ns) * (cpu_scale - 1);
+    while (now_ns() < until) {
+        /* Busy, like the CPU would be */
+    }
+
+    lcd_pipeline_send_color(disp, cmd, cmd_size, param, param_size);
+    render_start_ns = now_ns();
+}
+
+/**
+ * @brief Count the time core 0 waits for a free strip
+ */
+static void flush_wait_cb(lv_display_t *disp) {
+    uint64_t t = now_ns();
+    lcd_pipeline_flush_wait_cb(disp);
+    uint64_t waited = now_ns() - t;
+    wait_ns += waited;
+    render_start_ns += waited;
+}
+
+/**
+ * @brief Wait until every submitted strip is on the wire
+ */
+static void wait_for_ring(lv_display_t *disp) {
+    while (disp->buf_ring_submitted != disp->buf_ring_flushed) {
+        core_port_wait_event();
+    }
+}
+
+static void create_scene(void) {
+    lv_obj_t *scr = lv_screen_active();
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x203040), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_color_hex(0x405060), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_VER, 0);
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_style_pad_all(scr, 12, 0);
+    lv_obj_set_style_pad_gap(scr, 12, 0);
+
+    for (int i = 0; i < 6; i++) {
+        lv_obj_t *card = lv_obj_create(scr);
+        lv_obj_set_size(card, 140, 135);
+        lv_obj_set_style_radius(card, 12, 0);
+        lv_obj_set_style_shadow_width(card, 16, 0);
+        lv_obj_set_style_shadow_opa(card, LV_OPA_40, 0);
+
+        lv_obj_t *arc = lv_arc_create(card);
+        lv_obj_set_size(arc, 70, 70);
+        lv_arc_set_value(arc, 15 * (i + 1));
+        lv_obj_align(arc, LV_ALIGN_TOP_MID, 0, 0);
+
+        lv_obj_t *label = lv_label_create(card);
+        lv_label_set_text_fmt(label, "Sensor %d\n%d.%d", i + 1, 20 + i, i * 3);
+        lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, 0);
+    }
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t baudrate = SPI_SIM_DEFAULT_BAUDRATE;
+    uint32_t frames = 30;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baudrate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--cpu-scale") == 0 && i + 1 < argc) {
+            cpu_scale = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--baud HZ] [--cpu-scale N] [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cpu_scale == 0) {
+        cpu_scale = 1;
+    }
+    if (frames == 0) {
+        frames = 1;
+    }
+
+    spi_sim_init(baudrate);
+    printf("SPI %u MHz, render time x%u, %u full screen frames per configuration\n",
+           (unsigned)(baudrate / 1000000), (unsigned)cpu_scale, (unsigned)frames);
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    lcd_pipeline_sink_t sink = {
+        .send_cmd = sim_send_cmd,
+        .send_color = sim_send_color,
+        .swap_bytes = false,
+    };
+    lcd_pipeline_init(&sink);
+    lv_display_t *disp = lv_st7796_create(DISP_HOR_RES, DISP_VER_RES, LV_LCD_FLAG_BGR,
+                                          lcd_pipeline_send_cmd, slow_send_color);
+    lv_lcd_generic_mipi_set_address_mode(disp, false, true, true, true);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_flush_wait_cb(disp, flush_wait_cb);
+
+    /* Render the first frame with any buffer so the init sequence is out of the way */
+    lv_display_set_buffer_ring(disp, ring_mem, STRIP_SIZE(MAX_LINES), 2);
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_hide_performance(disp);
+#endif
+#if LV_USE_MEM_MONITOR
+    lv_sysmon_hide_memory(disp);
+#endif
+    create_scene();
+    render_start_ns = now_ns();
+    lv_refr_now(disp);
+    wait_for_ring(disp);
+
+    printf("%6s %6s %8s %9s %6s %6s %11s\n", "Depth", "Lines", "RAM KiB", "Frame ms", "FPS", "Bus %", "Core0 wait");
+
+    for (size_t d = 0; d < sizeof(ring_depths) / sizeof(ring_depths[0]); d++) {
+        for (size_t l = 0; l < sizeof(strip_lines) / sizeof(strip_lines[0]); l++) {
+            uint32_t depth = ring_depths[d];
+            uint32_t lines = strip_lines[l];
+            lv_display_set_buffer_ring(disp, ring_mem, STRIP_SIZE(lines), depth);
+
+            spi_sim_init(baudrate);
+            wait_ns = 0;
+            uint64_t t_start = now_ns();
+            for (uint32_t f = 0; f < frames; f++) {
+                lv_obj_invalidate(lv_screen_active());
+                render_start_ns = now_ns();
+                lv_refr_now(disp);
+                wait_for_ring(disp);
+            }
+            uint64_t elapsed_ns = now_ns() - t_start;
+
+            spi_sim_stats_t bus;
+            spi_sim_get_stats(&bus);
+            double frame_ms = (double)elapsed_ns / frames / 1e6;
+            printf("%6u %6u %8u %9.2f %6.1f %5u%% %10u%%\n", (unsigned)depth, (unsigned)lines,
+                   (unsigned)(depth * STRIP_SIZE(lines) / 1024), frame_ms, 1000.0 / frame_ms,
+                   (unsigned)(bus.busy_ns * 100 / elapsed_ns), (unsigned)(wait_ns * 100 / elapsed_ns));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file bench_row_hash.c
+ * @brief Wire bytes of lv_demo_benchmark() with and without the row hash filter
+ *
+ * Runs lv_demo_benchmark() through the same path as main.c (lcd_pipeline.c,
+ * one batched transfer per strip replayed on the simulated bus) with the
+ * row hash filter of the MIPI driver enabled. Every flush counts the pixel
+ * bytes it sent and the bytes of the unchanged rows it skipped, so one run
+ * gives both numbers for identical frames: without the filter the strips
+ * would have sent `sent + skipped`.
+ *
+ * The bytes are attributed to the scenes by time, from the scene durations of
+ * the benchmark summary, in 10 ms buckets.
+ *
+ * Usage: bench_row_hash [--tile N] [--baud HZ]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "src/drivers/display/st7796/lv_st7796.h"
+#include "demos/lv_demos.h"
+#include "lcd_pipeline.h"
+#include "lcd_dma_chain_replay.h"
+#include "spi_sim.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffers as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_RING_STRIPS    6
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+#define DISP_ROW_HASH_TILE_W    96
+
+#define BUCKET_MS           10
+#define BUCKET_CNT          (120 * 1000 / BUCKET_MS)    /* Longer than the benchmark */
+
+static uint8_t disp_ring[DISP_RING_STRIPS][DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Pixel bytes flushed during one bucket
+ */
+typedef struct {
+    uint64_t sent;
+    uint64_t saved;
+} bucket_t;
+
+static bucket_t buckets[BUCKET_CNT];
+
+static lv_display_t *bench_disp;
+static uint32_t bench_start_ms;
+static volatile bool bench_done;
+
+/*===========================================
+ * Simulated Bus Access
+ *===========================================*/
+
+/* Core 1 side of the pipeline */
+static void sim_send_cmd(const uint8_t *cmd, size_t cmd_size, const uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)param;
+    spi_sim_write_blocking(cmd_size + param_size);
+}
+
+static void sim_send_color(const uint8_t *cmd, size_t cmd_size, uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)param;
+    spi_sim_write_blocking(cmd_size + param_size);
+}
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+/**
+ * @brief Add the bytes flushed since the last call to the current bucket
+ */
+static void collect(void) {
+    static lv_lcd_row_hash_stats_t last;
+    lv_lcd_row_hash_stats_t stats;
+    lv_lcd_generic_mipi_get_row_hash_stats(bench_disp, &stats);
+
+    uint32_t bucket = lv_tick_elaps(bench_start_ms) / BUCKET_MS;
+    if (bucket >= BUCKET_CNT) {
+        bucket = BUCKET_CNT - 1;
+    }
+    buckets[bucket].sent += stats.bytes_sent - last.bytes_sent;
+    buckets[bucket].saved += stats.bytes_saved - last.bytes_saved;
+    last = stats;
+}
+
+static void print_row(const char *name, uint64_t sent, uint64_t saved, uint32_t ms) {
+    uint64_t total = sent + saved;
+    printf("%-28s %10llu %10llu %7.1f%% %9.2f\n", name,
+           (unsigned long long)(total / 1024), (unsigned long long)(sent / 1024),
+           total ? saved * 100.0 / total : 0.0,
+           ms ? sent / 1024.0 / 1024.0 * 1000.0 / ms : 0.0);
+}
+
+static void bench_end_cb(const lv_demo_benchmark_summary_t *summary) {
+    collect();
+
+    printf("%-28s %10s %10s %8s %9s\n", "Scene", "No filter", "Filter", "Saved", "Filter");
+    printf("%-28s %10s %10s %8s %9s\n", "", "KiB", "KiB", "", "MiB/s");
+
+    uint64_t sent_sum = 0;
+    uint64_t saved_sum = 0;
+    uint32_t scene_start_ms = 0;
+    for (const lv_demo_benchmark_scene_dsc_t *scene = summary->scenes; scene->create_cb; scene++) {
+        uint32_t first = scene_start_ms / BUCKET_MS;
+        uint32_t last = LV_MIN((scene_start_ms + scene->scene_time) / BUCKET_MS, BUCKET_CNT);
+        uint64_t sent = 0;
+        uint64_t saved = 0;
+        for (uint32_t b = first; b < last; b++) {
+            sent += buckets[b].sent;
+            saved += buckets[b].saved;
+        }
+        print_row(scene->name, sent, saved, scene->scene_time);
+        sent_sum += sent;
+        saved_sum += saved;
+        scene_start_ms += scene->scene_time;
+    }
+    print_row("All scenes", sent_sum, saved_sum, scene_start_ms);
+
+    bench_done = true;
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t tile_w = DISP_ROW_HASH_TILE_W;
+    uint32_t baudrate = SPI_SIM_DEFAULT_BAUDRATE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tile") == 0 && i + 1 < argc) {
+            tile_w = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baudrate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--tile N] [--baud HZ]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tile_w == 0) {
+        fprintf(stderr, "The tile width must be at least 1\n");
+        return 1;
+    }
+
+    spi_sim_init(baudrate);
+    printf("SPI %u MHz, row hash tiles of %u px\n", (unsigned)(baudrate / 1000000), (unsigned)tile_w);
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    lcd_pipeline_sink_t sink = {
+        .send_cmd = sim_send_cmd,
+        .send_color = sim_send_color,
+        .send_transfer = lcd_dma_chain_run,
+        .swap_bytes = false,
+    };
+    lcd_pipeline_init(&sink);
+    bench_disp = lv_st7796_create(DISP_HOR_RES, DISP_VER_RES, LV_LCD_FLAG_BGR,
+                                  lcd_pipeline_send_cmd, lcd_pipeline_send_color);
+    lv_lcd_generic_mipi_set_send_transfer_cb(bench_disp, lcd_pipeline_send_transfer);
+    lv_lcd_generic_mipi_set_address_mode(bench_disp, false, true, true, true);
+    if (lv_lcd_generic_mipi_set_row_hash(bench_disp, tile_w) != LV_RESULT_OK) {
+        fprintf(stderr, "Can't allocate the row hash table\n");
+        return 1;
+    }
+    lv_display_set_color_format(bench_disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffer_ring(bench_disp, disp_ring, sizeof(disp_ring[0]), DISP_RING_STRIPS);
+    lv_display_set_flush_wait_cb(bench_disp, lcd_pipeline_flush_wait_cb);
+
+    lv_demo_benchmark_set_end_cb(bench_end_cb);
+    bench_start_ms = lv_tick_get();
+    lv_demo_benchmark();
+
+    while (!bench_done) {
+        lv_timer_handler();
+        collect();
+    }
+
+    lv_lcd_row_hash_stats_t stats;
+    lv_lcd_generic_mipi_get_row_hash_stats(bench_disp, &stats);
+    lcd_dma_chain_replay_stats_t replay;
+    lcd_dma_chain_replay_get_stats(&replay);
+    printf("%u strips, %u without a changed row (sent as one row)\n",
+           (unsigned)stats.flush_cnt, (unsigned)stats.unchanged_cnt);
+    printf("Batched transfers: %u, %llu KiB on the wire in %llu ms\n", (unsigned)replay.transfers,
+           (unsigned long long)(replay.bytes / 1024), (unsigned long long)(replay.wire_ns / 1000000));
+
+    return 0;
+}
@@ -0,0 +1,480 @@
+/**
+ * @file bench_scroll_blit.c
+ * @brief The "Containers with scrolling" scene with and without scroll blitting
+ *
+ * The scene of lv_demo_benchmark() is built again here: a column of cards on
+ * the screen, scrolled a few pixels in every frame by an animation, under the
+ * title on the top layer. Without lv_display_set_scroll_blit() every step
+ * redraws the whole screen, with it only the rows scrolled in, the title and
+ * the scrollbar are rendered and the rest is moved.
+ *
+ * Two displays are measured:
+ * - direct mode, 480 x 320 like main.c with a frame buffer: the pixels are
+ *   moved in the buffer.
+ * - partial mode through the MIPI driver, 320 x 480 (portrait, the axes of
+ *   the ST7796 are not swapped) with the strip buffer and the row hash filter
+ *   of main.c: the controller moves them, lv_lcd_generic_mipi_set_hw_scroll().
+ *   The ST7796 is simulated: its memory, the address window, MADCTL and the
+ *   vertical scrolling (the panel line `TFA + n` shows the memory row
+ *   `TFA + (VSP - TFA + n) % VSA`). It runs with and without mirrored pages.
+ *
+ * Every frame as shown has to be the same with and without blitting. Reports
+ * the CPU time of the refreshes (in partial mode with the simulated writes),
+ * the invalidated pixels, the bytes sent to the controller and the number of
+ * moves.
+ *
+ * Usage: bench_scroll_blit
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "src/drivers/display/st7796/lv_st7796.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffers as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+#define DISP_ROW_HASH_TILE_W    96
+
+/* The memory of the ST7796 */
+#define LCD_MEM_COLS        320
+#define LCD_MEM_ROWS        480
+
+#define FRAME_MS            16
+#define FRAME_CNT           300
+
+/* As in lv_demo_benchmark.c */
+#define HEADER_HEIGHT       48
+#define PAD_BASIC           8
+
+static uint8_t frame_buf[DISP_HOR_RES * DISP_VER_RES * 2] __attribute__((aligned(4)));
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of a run
+ */
+typedef struct {
+    uint64_t cpu_ns;
+    uint64_t inv_px;        /* Invalidated pixels */
+    uint64_t wire_bytes;    /* Commands, parameters and pixels sent to the controller */
+    uint32_t blitted;
+    uint64_t frames[FRAME_CNT]; /* Hash of each frame as shown */
+} run_t;
+
+/**
+ * @brief The simulated ST7796
+ */
+typedef struct {
+    uint16_t mem[LCD_MEM_ROWS][LCD_MEM_COLS];
+    uint8_t madctl;
+    uint8_t cmd;            /* Last command */
+    uint16_t xs, xe, ys, ye;
+    uint16_t x, y;          /* Address counter */
+    uint16_t tfa, vsa, vsp; /* Vertical scrolling */
+} lcd_sim_t;
+
+static uint32_t tick_ms;
+static run_t *run_act;
+static lcd_sim_t lcd;
+
+/*===========================================
+ * Simulated Controller
+ *===========================================*/
+
+static void lcd_reset(void) {
+    memset(&lcd, 0, sizeof(lcd));
+    lcd.xe = LCD_MEM_COLS - 1;
+    lcd.ye = LCD_MEM_ROWS - 1;
+    lcd.vsa = LCD_MEM_ROWS;
+}
+
+static void lcd_write_param(const uint8_t *param, size_t size) {
+    switch (lcd.cmd) {
+    case LV_LCD_CMD_SET_COLUMN_ADDRESS:
+        if (size >= 4) {
+            lcd.xs = (uint16_t)(param[0] << 8 | param[1]);
+            lcd.xe = (uint16_t)(param[2] << 8 | param[3]);
+        }
+        break;
+    case LV_LCD_CMD_SET_PAGE_ADDRESS:
+        if (size >= 4) {
+            lcd.ys = (uint16_t)(param[0] << 8 | param[1]);
+            lcd.ye = (uint16_t)(param[2] << 8 | param[3]);
+        }
+        break;
+    case LV_LCD_CMD_SET_ADDRESS_MODE:
+        if (size >= 1) {
+            lcd.madctl = param[0];
+        }
+        break;
+    case LV_LCD_CMD_SET_SCROLL_AREA:
+        if (size >= 6) {
+            lcd.tfa = (uint16_t)(param[0] << 8 | param[1]);
+            lcd.vsa = (uint16_t)(param[2] << 8 | param[3]);
+        }
+        break;
+    case LV_LCD_CMD_SET_SCROLL_START:
+        if (size >= 2) {
+            lcd.vsp = (uint16_t)(param[0] << 8 | param[1]);
+        }
+        break;
+    case LV_LCD_CMD_WRITE_MEMORY_START:
+        for (size_t i = 0; i + 1 < size; i += 2) {
+            /* Columns and pages as written, rows and columns of the memory as mirrored */
+            uint16_t col = lcd.x;
+            uint16_t row = lcd.y;
+            if (lcd.madctl & LV_LCD_MASK_PAGE_COLUMN_ORDER) {
+                col = lcd.y;
+                row = lcd.x;
+            }
+            if (lcd.madctl & LV_LCD_MASK_COLUMN_ADDRESS_ORDER) {
+                col = LCD_MEM_COLS - 1 - col;
+            }
+            if (lcd.madctl & LV_LCD_MASK_PAGE_ADDRESS_ORDER) {
+                row = LCD_MEM_ROWS - 1 - row;
+            }
+            if (col < LCD_MEM_COLS && row < LCD_MEM_ROWS) {
+                lcd.mem[row][col] = (uint16_t)(param[i] << 8 | param[i + 1]);
+            }
+            if (++lcd.x > lcd.xe) {
+                lcd.x = lcd.xs;
+                lcd.y++;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void lcd_write_cmd(uint8_t cmd) {
+    lcd.cmd = cmd;
+    if (cmd == LV_LCD_CMD_WRITE_MEMORY_START) {
+        lcd.x = lcd.xs;
+        lcd.y = lcd.ys;
+    }
+}
+
+/**
+ * @brief Hash of the panel: each line shows a row of the memory
+ */
+static uint64_t lcd_scan_hash(void) {
+    uint64_t hash = 14695981039346656037u;
+    for (uint32_t line = 0; line < LCD_MEM_ROWS; line++) {
+        uint32_t row = line;
+        if (line >= lcd.tfa && line < (uint32_t)lcd.tfa + lcd.vsa) {
+            row = lcd.tfa + (line - lcd.tfa + lcd.vsp - lcd.tfa + lcd.vsa) % lcd.vsa;
+        }
+        const uint8_t *p = (const uint8_t *)lcd.mem[row];
+        for (uint32_t i = 0; i < sizeof(lcd.mem[0]); i++) {
+            hash = (hash ^ p[i]) * 1099511628211u;
+        }
+    }
+    return hash;
+}
+
+static void sim_send_cmd(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size, const uint8_t *param,
+                         size_t param_size) {
+    (void)disp;
+    lcd_write_cmd(cmd[0]);
+    lcd_write_param(param, param_size);
+    run_act->wire_bytes += cmd_size + param_size;
+}
+
+static void sim_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size, uint8_t *param,
+                           size_t param_size) {
+    lcd_write_cmd(cmd[0]);
+    lcd_write_param(param, param_size);
+    run_act->wire_bytes += cmd_size + param_size;
+    lv_display_flush_ready(disp);
+}
+
+static void sim_send_transfer(lv_display_t *disp, const lv_lcd_transfer_t *xfer) {
+    for (uint32_t i = 0; i < xfer->seg_cnt; i++) {
+        const lv_lcd_transfer_seg_t *seg = &xfer->seg[i];
+        const uint8_t *data = lv_lcd_transfer_seg_get_data(seg);
+        if (seg->dc == LV_LCD_DC_COMMAND) {
+            lcd_write_cmd(data[0]);
+        } else {
+            lcd_write_param(data, seg->size);
+        }
+        run_act->wire_bytes += seg->size;
+    }
+    if (!xfer->flush_continues) {
+        lv_display_flush_ready(disp);
+    }
+}
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+/* The waits of the controller's initialization pass on the same clock */
+static void delay_cb(uint32_t ms) {
+    tick_ms += ms;
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void direct_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+static uint64_t frame_buf_hash(void) {
+    uint64_t hash = 14695981039346656037u;
+    for (uint32_t i = 0; i < sizeof(frame_buf); i++) {
+        hash = (hash ^ frame_buf[i]) * 1099511628211u;
+    }
+    return hash;
+}
+
+static void invalidate_area_cb(lv_event_t *e) {
+    const lv_area_t *area = lv_event_get_param(e);
+    run_act->inv_px += lv_area_get_size(area);
+}
+
+/*===========================================
+ * Scene
+ *===========================================*/
+
+/**
+ * @brief A card like card_create() of lv_demo_benchmark.c
+ */
+static lv_obj_t *card_create(lv_obj_t *parent) {
+    lv_obj_t *panel = lv_obj_create(parent);
+    lv_obj_set_size(panel, 270, 120);
+    lv_obj_set_style_pad_all(panel, 8, 0);
+
+    LV_IMAGE_DECLARE(img_benchmark_avatar);
+    lv_obj_t *child = lv_image_create(panel);
+    lv_obj_align(child, LV_ALIGN_LEFT_MID, 0, 0);
+    lv_image_set_src(child, &img_benchmark_avatar);
+
+    child = lv_label_create(panel);
+    lv_label_set_text_static(child, "John Smith");
+    lv_obj_set_style_text_font(child, &lv_font_montserrat_24, 0);
+    lv_obj_set_pos(child, 100, 0);
+
+    child = lv_label_create(panel);
+    lv_label_set_text_static(child, "A DIY enthusiast");
+    lv_obj_set_style_text_font(child, &lv_font_montserrat_14, 0);
+    lv_obj_set_pos(child, 100, 30);
+
+    child = lv_button_create(panel);
+    lv_obj_set_pos(child, 100, 50);
+    lv_label_set_text_static(lv_label_create(child), "Connect");
+
+    return panel;
+}
+
+static void scroll_anim_y_cb(void *var, int32_t v) {
+    lv_obj_scroll_to_y(var, v, LV_ANIM_OFF);
+}
+
+/**
+ * @brief The screen of the benchmark and containers_with_scrolling_cb()
+ */
+static void scene_create(void) {
+    lv_obj_t *scr = lv_screen_active();
+    lv_obj_remove_style_all(scr);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(scr, lv_palette_lighten(LV_PALETTE_GREY, 4), 0);
+    lv_obj_set_style_text_color(scr, lv_color_black(), 0);
+    lv_obj_set_style_pad_all(scr, PAD_BASIC, 0);
+    lv_obj_set_style_pad_gap(scr, PAD_BASIC, 0);
+    lv_obj_set_style_pad_top(scr, HEADER_HEIGHT, 0);
+
+    lv_obj_t *title = lv_label_create(lv_layer_top());
+    lv_obj_set_style_bg_opa(title, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(title, lv_color_white(), 0);
+    lv_obj_set_width(title, lv_pct(100));
+    lv_label_set_text_static(title, "Containers with scrolling");
+
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_flex_align(scr, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
+    lv_obj_set_style_pad_row(scr, 32, 0);
+
+    int32_t hor_cnt = LV_MAX(lv_obj_get_content_width(scr) / 400, 1);
+    int32_t ver_cnt = LV_MAX(lv_obj_get_content_height(scr) / (120 + 32), 1) * 2;
+    if (ver_cnt < 20) {
+        ver_cnt = 20;
+    }
+    for (int32_t y = 0; y < ver_cnt; y++) {
+        for (int32_t x = 0; x < hor_cnt; x++) {
+            lv_obj_t *card = card_create(scr);
+            if (x == 0) {
+                lv_obj_add_flag(card, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK);
+            }
+        }
+    }
+
+    lv_obj_update_layout(scr);
+    uint32_t t = lv_anim_speed(lv_display_get_dpi(NULL));
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, scr);
+    lv_anim_set_exec_cb(&a, scroll_anim_y_cb);
+    lv_anim_set_values(&a, 0, lv_obj_get_scroll_bottom(scr));
+    lv_anim_set_duration(&a, t);
+    lv_anim_set_reverse_duration(&a, t);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+}
+
+/*===========================================
+ * Runs
+ *===========================================*/
+
+static void run_frames(lv_display_t *disp, bool lcd_scan, run_t *res) {
+    lv_display_add_event_cb(disp, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_sysmon_hide_performance(disp);
+    scene_create();
+
+    for (uint32_t i = 0; i < FRAME_CNT; i++) {
+        tick_ms += FRAME_MS;
+        uint64_t t0 = cpu_ns();
+        lv_timer_handler();
+        res->cpu_ns += cpu_ns() - t0;
+        res->frames[i] = lcd_scan ? lcd_scan_hash() : frame_buf_hash();
+    }
+
+    lv_display_inv_stats_t stats;
+    lv_display_get_inv_stats(disp, &stats);
+    res->blitted = stats.blitted;
+}
+
+static void run_direct(bool blit, run_t *res) {
+    memset(res, 0, sizeof(*res));
+    run_act = res;
+    tick_ms = 0;
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, frame_buf, NULL, sizeof(frame_buf), LV_DISPLAY_RENDER_MODE_DIRECT);
+    lv_display_set_flush_cb(disp, direct_flush_cb);
+    lv_display_set_scroll_blit(disp, blit);
+    run_frames(disp, false, res);
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+static void run_partial(bool blit, bool mirror_y, run_t *res) {
+    memset(res, 0, sizeof(*res));
+    run_act = res;
+    tick_ms = 0;
+    lcd_reset();
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_delay_set_cb(delay_cb);
+
+    /* Portrait: the rows of the display are the rows of the memory */
+    lv_display_t *disp = lv_st7796_create(LCD_MEM_COLS, LCD_MEM_ROWS, LV_LCD_FLAG_BGR, sim_send_cmd, sim_send_color);
+    lv_lcd_generic_mipi_set_send_transfer_cb(disp, sim_send_transfer);
+    lv_lcd_generic_mipi_set_address_mode(disp, true, mirror_y, false, true);
+    lv_lcd_generic_mipi_set_row_hash(disp, DISP_ROW_HASH_TILE_W);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    if (blit) {
+        lv_lcd_generic_mipi_set_hw_scroll(disp, LCD_MEM_ROWS);
+        lv_display_set_scroll_blit(disp, true);
+    }
+    run_frames(disp, true, res);
+
+    lv_display_delete(disp);
+    lv_deinit();
+}
+
+/**
+ * @brief Index of the first frame which differs, FRAME_CNT if none
+ */
+static uint32_t first_diff(const run_t *a, const run_t *b) {
+    uint32_t i = 0;
+    while (i < FRAME_CNT && a->frames[i] == b->frames[i]) {
+        i++;
+    }
+    return i;
+}
+
+static void print_run(const char *name, const run_t *res) {
+    printf("%-18s %9.2f %12.2f %9llu %9u\n", name, res->cpu_ns / 1e6, res->inv_px / 1e6,
+           (unsigned long long)(res->wire_bytes / 1024), (unsigned)res->blitted);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(void) {
+    static run_t direct_off, direct_on, partial_off, partial_on, mirror_off, mirror_on;
+
+    printf("%u frames of %u ms, \"Containers with scrolling\"\n", FRAME_CNT, FRAME_MS);
+    printf("%-18s %9s %12s %9s %9s\n", "Scroll blit", "CPU", "Invalidated", "Sent", "Moved");
+    printf("%-18s %9s %12s %9s %9s\n", "", "ms", "Mpx", "KiB", "");
+
+    run_direct(false, &direct_off);
+    run_direct(true, &direct_on);
+    print_run("direct off", &direct_off);
+    print_run("direct on", &direct_on);
+    run_partial(false, false, &partial_off);
+    run_partial(true, false, &partial_on);
+    print_run("partial off", &partial_off);
+    print_run("partial on", &partial_on);
+    run_partial(false, true, &mirror_off);
+    run_partial(true, true, &mirror_on);
+    print_run("partial MY off", &mirror_off);
+    print_run("partial MY on", &mirror_on);
+
+    uint32_t direct_diff = first_diff(&direct_off, &direct_on);
+    uint32_t partial_diff = first_diff(&partial_off, &partial_on);
+    uint32_t mirror_diff = first_diff(&mirror_off, &mirror_on);
+    if (direct_diff < FRAME_CNT || partial_diff < FRAME_CNT || mirror_diff < FRAME_CNT) {
+        printf("First different frame: direct %u, partial %u, partial MY %u\n",
+               (unsigned)direct_diff, (unsigned)partial_diff, (unsigned)mirror_diff);
+    }
+
+    /* The same frames */
+    CHECK(direct_diff == FRAME_CNT);
+    CHECK(partial_diff == FRAME_CNT);
+    CHECK(mirror_diff == FRAME_CNT);
+    /* Almost every step was moved, by far less was drawn and sent */
+    CHECK(direct_off.blitted == 0 && partial_off.blitted == 0);
+    CHECK(direct_on.blitted > FRAME_CNT * 3 / 4);
+    CHECK(partial_on.blitted > FRAME_CNT * 3 / 4);
+    CHECK(mirror_on.blitted == partial_on.blitted);
+    CHECK(direct_on.inv_px * 4 < direct_off.inv_px);
+    CHECK(partial_on.wire_bytes * 4 < partial_off.wire_bytes);
+    CHECK(direct_on.cpu_ns < direct_off.cpu_ns);
+    CHECK(partial_on.cpu_ns < partial_off.cpu_ns);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
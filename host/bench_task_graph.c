@@ -0,0 +1,307 @@
+/**
+ * @file bench_task_graph.c
+ * @brief Draw task dispatch with and without the dependency graph
+ *
+ * Renders frames of 1000 to 10000 random rectangles on the 480 x 320 display
+ * of main.c, once with the older draw tasks searched at every dispatch and
+ * once with lv_display_set_draw_task_graph(). The software renderer is
+ * replaced by a stub draw unit which draws nothing, so the frame time is only
+ * adding, dispatching and removing the draw tasks:
+ *
+ *   - the stub has 1 to 8 lanes, like the render threads of the software
+ *     renderer with LV_DRAW_SW_DRAW_UNIT_CNT, and takes tasks like it does
+ *   - a task keeps its lane for 1 + px / 256 dispatches, and one task is
+ *     added per dispatch, so the unfinished tasks pile up in the layer as
+ *     they do while a real renderer is busy
+ *
+ * A checked run of each case verifies that no task is started before an older
+ * overlapping one is finished, and that every task is drawn.
+ *
+ * Usage: bench_task_graph [--max-tasks N] [--frames N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry as main.c, rendered in one piece so each frame is one layer */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_VER_RES)
+
+#define RECT_MIN            8
+#define RECT_MAX            72
+#define LANE_MAX            8
+#define STUB_UNIT_ID        42
+
+/* 10000 tasks with their fill descriptors don't fit in LV_MEM_SIZE. The heap
+ * is grown by pools, each smaller than the largest block of LV_MEM_SIZE. */
+#define HEAP_POOL_SIZE      (64 * 1024)
+#define HEAP_POOL_CNT       256
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+static const uint32_t task_counts[] = {1000, 2000, 5000, 10000};
+static const uint32_t lane_counts[] = {1, 2, 4, 8};
+
+/**
+ * @brief Draw unit which only takes the tasks and finishes them later
+ */
+typedef struct {
+    lv_draw_unit_t base;
+    uint32_t lane_cnt;
+    lv_draw_task_t *lanes[LANE_MAX];
+    uint64_t lane_end[LANE_MAX];
+    uint64_t tick;          /* Dispatches so far */
+    bool check;
+    uint32_t drawn;
+    uint32_t violations;
+} stub_unit_t;
+
+static stub_unit_t *stub;
+static uint32_t rect_cnt;
+static uint32_t seed;
+
+/*===========================================
+ * Stub draw unit
+ *===========================================*/
+
+static uint32_t task_px(const lv_draw_task_t *t) {
+    lv_area_t a;
+    if (!lv_area_intersect(&a, &t->_real_area, &t->clip_area)) {
+        return 0;
+    }
+    return lv_area_get_size(&a);
+}
+
+/**
+ * @brief Count the older unfinished tasks overlapping a task which is started
+ */
+static void check_order(lv_draw_task_t *t) {
+    lv_draw_task_t *t_old;
+    for (t_old = t->prev; t_old; t_old = t_old->prev) {
+        lv_area_t a;
+        if (t_old->state != LV_DRAW_TASK_STATE_FINISHED &&
+            lv_area_intersect(&a, &t_old->_real_area, &t->_real_area)) {
+            stub->violations++;
+        }
+    }
+}
+
+static int32_t stub_evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *task) {
+    LV_UNUSED(draw_unit);
+    task->preference_score = 0;
+    task->preferred_draw_unit_id = STUB_UNIT_ID;
+    return 0;
+}
+
+static int32_t stub_dispatch(lv_draw_unit_t *draw_unit, lv_layer_t *layer) {
+    stub_unit_t *u = (stub_unit_t *)draw_unit;
+    u->tick++;
+
+    bool all_idle = true;
+    for (uint32_t i = 0; i < u->lane_cnt; i++) {
+        if (u->lanes[i] && u->lanes[i]->target_layer == layer && u->lane_end[i] <= u->tick) {
+            u->lanes[i]->state = LV_DRAW_TASK_STATE_FINISHED;
+            u->lanes[i] = NULL;
+            u->drawn++;
+        }
+        if (u->lanes[i]) {
+            all_idle = false;
+        }
+    }
+
+    /* As the software renderer takes them */
+    int32_t taken_cnt = 0;
+    lv_draw_task_t *t = NULL;
+    for (uint32_t i = 0; i < u->lane_cnt; i++) {
+        if (u->lanes[i]) {
+            continue;
+        }
+        t = u->lane_cnt == 1 ? lv_draw_get_available_task(layer, NULL, STUB_UNIT_ID) :
+            lv_draw_get_next_available_task(layer, t, STUB_UNIT_ID);
+        if (t == NULL) {
+            break;
+        }
+        if (u->check) {
+            check_order(t);
+        }
+        t->state = LV_DRAW_TASK_STATE_IN_PROGRESS;
+        u->lanes[i] = t;
+        u->lane_end[i] = u->tick + 1 + task_px(t) / 256;
+        taken_cnt++;
+        all_idle = false;
+    }
+
+    /* The lanes finish on a later dispatch, as a render thread would request it */
+    if (!all_idle) {
+        lv_draw_dispatch_request();
+    }
+
+    return all_idle ? LV_DRAW_UNIT_IDLE : taken_cnt;
+}
+
+/**
+ * @brief Replace the draw units by the stub
+ */
+static void stub_install(void) {
+    stub = lv_draw_create_unit(sizeof(stub_unit_t));
+    stub->base.name = "STUB";
+    stub->base.evaluate_cb = stub_evaluate;
+    stub->base.dispatch_cb = stub_dispatch;
+
+    /* The software renderer is left out of the list and never freed */
+    stub->base.next = NULL;
+    LV_GLOBAL_DEFAULT()->draw_info.unit_head = &stub->base;
+    LV_GLOBAL_DEFAULT()->draw_info.unit_cnt = 1;
+}
+
+/*===========================================
+ * Scene
+ *===========================================*/
+
+static uint32_t rnd(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static void draw_rects_cb(lv_event_t *e) {
+    lv_layer_t *layer = lv_event_get_layer(e);
+
+    lv_draw_fill_dsc_t dsc;
+    lv_draw_fill_dsc_init(&dsc);
+
+    /* The same rectangles in every frame */
+    seed = 1;
+    for (uint32_t i = 0; i < rect_cnt; i++) {
+        lv_area_t a;
+        a.x1 = rnd() % DISP_HOR_RES;
+        a.y1 = rnd() % DISP_VER_RES;
+        a.x2 = a.x1 + RECT_MIN + rnd() % (RECT_MAX - RECT_MIN);
+        a.y2 = a.y1 + RECT_MIN + rnd() % (RECT_MAX - RECT_MIN);
+        dsc.color = lv_color_hex(rnd());
+        lv_draw_fill(layer, &dsc, &a);
+    }
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    LV_UNUSED(area);
+    LV_UNUSED(px_map);
+    lv_display_flush_ready(disp);
+}
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/**
+ * @brief Render frames of a case
+ * @return average CPU time of a frame in ns
+ */
+static uint64_t run(lv_display_t *disp, uint32_t tasks, uint32_t lanes, bool graph, bool check, uint32_t frames) {
+    rect_cnt = tasks;
+    stub->lane_cnt = lanes;
+    stub->check = check;
+    stub->violations = 0;
+    lv_display_set_draw_task_graph(disp, graph);
+
+    uint64_t total = 0;
+    for (uint32_t f = 0; f < frames; f++) {
+        stub->drawn = 0;
+        lv_obj_invalidate(lv_screen_active());
+        uint64_t t0 = cpu_ns();
+        lv_refr_now(disp);
+        total += cpu_ns() - t0;
+
+        /* The rectangles and the background of the screen */
+        CHECK(stub->drawn >= tasks + 1);
+    }
+
+    if (check) {
+        CHECK(stub->violations == 0);
+    }
+
+    return total / frames;
+}
+
+/*===========================================
+ * Main
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t max_tasks = 10000;
+    uint32_t frames = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-tasks") == 0 && i + 1 < argc) {
+            max_tasks = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t)atoi(argv[++i]);
+        }
+        else {
+            printf("Usage: %s [--max-tasks N] [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (frames == 0) {
+        frames = 1;
+    }
+
+    lv_init();
+    for (uint32_t i = 0; i < HEAP_POOL_CNT; i++) {
+        lv_mem_add_pool(malloc(HEAP_POOL_SIZE), HEAP_POOL_SIZE);
+    }
+    stub_install();
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_sysmon_hide_performance(disp);
+
+    lv_obj_t *scr = lv_screen_active();
+    lv_obj_add_event_cb(scr, draw_rects_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+
+    printf("Draw task dispatch, %dx%d, rectangles of %d..%d px, CPU time per frame\n\n",
+           DISP_HOR_RES, DISP_VER_RES, RECT_MIN, RECT_MAX);
+    printf("%6s %6s %12s %12s %9s %12s\n", "tasks", "lanes", "search [us]", "graph [us]", "speedup", "graph [ns/task]");
+
+    for (uint32_t ti = 0; ti < sizeof(task_counts) / sizeof(task_counts[0]); ti++) {
+        uint32_t tasks = task_counts[ti];
+        if (tasks > max_tasks) {
+            break;
+        }
+        for (uint32_t li = 0; li < sizeof(lane_counts) / sizeof(lane_counts[0]); li++) {
+            uint32_t lanes = lane_counts[li];
+            run(disp, tasks, lanes, false, true, 1);
+            run(disp, tasks, lanes, true, true, 1);
+
+            uint64_t search_ns = run(disp, tasks, lanes, false, false, frames);
+            uint64_t graph_ns = run(disp, tasks, lanes, true, false, frames);
+            printf("%6u %6u %12.0f %12.0f %8.1fx %12.0f\n", tasks, lanes,
+                   search_ns / 1000.0, graph_ns / 1000.0, (double)search_ns / graph_ns,
+                   (double)graph_ns / tasks);
+        }
+    }
+
+    /* Nothing is left of the graph after a frame */
+    CHECK(disp->layer_head->task_graph == NULL);
+    CHECK(disp->layer_head->draw_task_head == NULL);
+
+    if (failures) {
+        printf("\n%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("\nOK\n");
+    return 0;
+}
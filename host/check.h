@@ -0,0 +1,23 @@
+/**
+ * @file check.h
+ * @brief Failure counting shared by the host tests and benchmarks
+ *
+ * A failed CHECK prints its location and condition and keeps going, so one run
+ * reports every broken check. main() returns nonzero when `failures` is set.
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+static int failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#endif /* CHECK_H */
@@ -0,0 +1,112 @@
+/**
+ * @file core_port_posix.c
+ * @brief Dual-core abstraction on top of POSIX threads (host builds)
+ *
+ * Core 1 is a detached pthread. The event functions mimic the WFE/SEV event
+ * register of the Cortex-M33: each core has a sticky event flag that is set
+ * by the other core and consumed by core_port_wait_event().
+ * core_port_sleep() is a condition variable wait on CLOCK_MONOTONIC.
+ */
+
+#include "core_port.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+static pthread_mutex_t event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+static bool event_pending[2];
+
+/* core_port_sleep()/core_port_wake(), the "interrupts" are other threads */
+static pthread_once_t sleep_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t sleep_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sleep_cond;
+static bool wake_pending;
+
+/* The thread started by core_port_launch() is core 1, every other thread is core 0 */
+static _Thread_local int core_num;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static void *core1_thread(void *arg) {
+    void (*entry)(void) = (void (*)(void))arg;
+    core_num = 1;
+    entry();
+    return NULL;
+}
+
+static void sleep_init(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sleep_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void core_port_launch(void (*entry)(void)) {
+    pthread_t thread;
+    pthread_create(&thread, NULL, core1_thread, (void *)entry);
+    pthread_detach(thread);
+}
+
+uint32_t core_port_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+void core_port_wait_event(void) {
+    pthread_mutex_lock(&event_mutex);
+    while (!event_pending[core_num]) {
+        pthread_cond_wait(&event_cond, &event_mutex);
+    }
+    event_pending[core_num] = false;
+    pthread_mutex_unlock(&event_mutex);
+}
+
+void core_port_signal_event(void) {
+    pthread_mutex_lock(&event_mutex);
+    event_pending[!core_num] = true;
+    pthread_cond_broadcast(&event_cond);
+    pthread_mutex_unlock(&event_mutex);
+}
+
+bool core_port_sleep(uint32_t timeout_us) {
+    pthread_once(&sleep_once, sleep_init);
+
+    struct timespec until;
+    clock_gettime(CLOCK_MONOTONIC, &until);
+    uint64_t ns = (uint64_t)until.tv_nsec + (uint64_t)timeout_us * 1000;
+    until.tv_sec += (time_t)(ns / 1000000000);
+    until.tv_nsec = (long)(ns % 1000000000);
+
+    pthread_mutex_lock(&sleep_mutex);
+    while (!wake_pending) {
+        if (pthread_cond_timedwait(&sleep_cond, &sleep_mutex, &until) != 0) {
+            break;
+        }
+    }
+    bool woken = wake_pending;
+    wake_pending = false;
+    pthread_mutex_unlock(&sleep_mutex);
+    return woken;
+}
+
+void core_port_wake(void) {
+    pthread_once(&sleep_once, sleep_init);
+
+    pthread_mutex_lock(&sleep_mutex);
+    wake_pending = true;
+    pthread_cond_signal(&sleep_cond);
+    pthread_mutex_unlock(&sleep_mutex);
+}
@@ -0,0 +1,249 @@
+/**
+ * @file ft6336u_sim.c
+ * @brief Simulated FT6336U replaying a touch trace
+ *
+ * The registers follow the trace. Once G_MODE is set to trigger mode, a
+ * thread pulses the INT pin at the time of every trace sample.
+ */
+
+#include "hal_sim.h"
+#include "hal_internal.h"
+#include "ft6336u.h"
+#include "pico/time.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================
+ * Private Types and Variables
+ *===========================================*/
+
+typedef struct {
+    uint32_t time_ms;
+    uint8_t count;
+    uint16_t x[FT6336U_MAX_TOUCH_POINTS];
+    uint16_t y[FT6336U_MAX_TOUCH_POINTS];
+} touch_sample_t;
+
+static pthread_mutex_t touch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t touch_once = PTHREAD_ONCE_INIT;
+
+static touch_sample_t *trace;
+static size_t trace_len;
+
+static uint8_t regs[256];
+static uint8_t reg_ptr;
+
+static bool int_thread_running;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+/**
+ * @brief Power-on register values and the trace from SIM_TOUCH_TRACE
+ */
+static void touch_sim_init(void) {
+    regs[FT6336U_REG_TD_STATUS] = 0;
+    regs[FT6336U_REG_LIB_VER_H] = 0x30;
+    regs[FT6336U_REG_LIB_VER_L] = 0x03;
+    regs[FT6336U_REG_CIPHER] = 0x64;
+    regs[FT6336U_REG_FIRMID] = 0x10;
+    regs[FT6336U_REG_FOCALTECH_ID] = 0x11;
+
+    const char *path = getenv("SIM_TOUCH_TRACE");
+    if (path && !sim_touch_load_trace(path)) {
+        fprintf(stderr, "FT6336U sim: can't load touch trace %s\n", path);
+        exit(1);
+    }
+}
+
+/**
+ * @brief Find the sample active at `time_ms`, NULL before the first one
+ */
+static const touch_sample_t *trace_find(uint32_t time_ms, size_t *index) {
+    const touch_sample_t *sample = NULL;
+    for (size_t i = 0; i < trace_len && trace[i].time_ms <= time_ms; i++) {
+        sample = &trace[i];
+        *index = i;
+    }
+    return sample;
+}
+
+/**
+ * @brief Update the touch registers (0x00-0x0E) from the trace
+ */
+static void touch_regs_update(void) {
+    uint32_t now_ms = (uint32_t)((hal_now_ns() - hal_boot_ns()) / 1000000);
+    size_t index = 0;
+    const touch_sample_t *sample = trace_find(now_ms, &index);
+    const touch_sample_t *prev = (sample && index > 0) ? &trace[index - 1] : NULL;
+
+    memset(regs, 0, FT6336U_REG_P2_MISC + 1);
+    if (!sample) {
+        return;
+    }
+
+    regs[FT6336U_REG_TD_STATUS] = sample->count;
+    for (uint8_t i = 0; i < sample->count; i++) {
+        /* Points are 6 registers apart: XH XL YH YL WEIGHT MISC */
+        uint8_t *p = &regs[FT6336U_REG_P1_XH + i * 6];
+        uint8_t event = (prev && prev->count > i) ? FT6336U_EVENT_CONTACT : FT6336U_EVENT_PRESS_DOWN;
+        p[0] = (uint8_t)((event << 6) | ((sample->x[i] >> 8) & 0x0F));
+        p[1] = (uint8_t)sample->x[i];
+        p[2] = (uint8_t)((i << 4) | ((sample->y[i] >> 8) & 0x0F));   /* Touch ID in the high nibble */
+        p[3] = (uint8_t)sample->y[i];
+        p[4] = 0x20;
+        p[5] = 0x10;
+    }
+}
+
+/**
+ * @brief Pulse INT low for every trace sample from now on (trigger mode)
+ */
+static void *touch_int_thread(void *arg) {
+    (void)arg;
+    hal_gpio_drive(HAL_SIM_TOUCH_INT_GPIO, true);
+    uint64_t start_us = (hal_now_ns() - hal_boot_ns()) / 1000;
+
+    for (size_t i = 0;; i++) {
+        pthread_mutex_lock(&touch_mutex);
+        bool done = i >= trace_len;
+        uint32_t time_ms = done ? 0 : trace[i].time_ms;
+        pthread_mutex_unlock(&touch_mutex);
+        if (done) {
+            break;
+        }
+
+        if ((uint64_t)time_ms * 1000 < start_us) {
+            continue;   /* Reported before trigger mode was enabled */
+        }
+        /* A late thread still pulses for every report, right away */
+        uint64_t now_us = (hal_now_ns() - hal_boot_ns()) / 1000;
+        if ((uint64_t)time_ms * 1000 > now_us) {
+            sleep_us((uint64_t)time_ms * 1000 - now_us);
+        }
+
+        /* The falling edge runs the GPIO interrupt, the main loop then reads the registers */
+        hal_gpio_drive(HAL_SIM_TOUCH_INT_GPIO, false);
+        sleep_us(HAL_SIM_TOUCH_INT_PULSE_US);
+        hal_gpio_drive(HAL_SIM_TOUCH_INT_GPIO, true);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Start the INT thread the first time trigger mode is set (touch_mutex held)
+ */
+static void touch_int_start(void) {
+    if (int_thread_running || regs[FT6336U_REG_G_MODE] != FT6336U_G_MODE_TRIGGER) {
+        return;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, touch_int_thread, NULL);
+    pthread_detach(thread);
+    int_thread_running = true;
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+bool sim_touch_load_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+
+    touch_sample_t *samples = NULL;
+    size_t len = 0, cap = 0;
+    char line[256];
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), f)) {
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        touch_sample_t s = {0};
+        unsigned t, cnt, x1, y1, x2, y2;
+        int n = sscanf(line, "%u %u %u %u %u %u", &t, &cnt, &x1, &y1, &x2, &y2);
+        if (n <= 0) {
+            continue;   /* Empty line */
+        }
+        if (n < 2 || cnt > FT6336U_MAX_TOUCH_POINTS || n != 2 + (int)cnt * 2 ||
+            (len > 0 && t < samples[len - 1].time_ms)) {
+            ok = false;
+            break;
+        }
+
+        s.time_ms = t;
+        s.count = (uint8_t)cnt;
+        if (cnt >= 1) {
+            s.x[0] = (uint16_t)x1;
+            s.y[0] = (uint16_t)y1;
+        }
+        if (cnt >= 2) {
+            s.x[1] = (uint16_t)x2;
+            s.y[1] = (uint16_t)y2;
+        }
+
+        if (len == cap) {
+            cap = cap ? cap * 2 : 64;
+            samples = realloc(samples, cap * sizeof(*samples));
+        }
+        samples[len++] = s;
+    }
+    fclose(f);
+
+    if (!ok) {
+        free(samples);
+        return false;
+    }
+
+    pthread_mutex_lock(&touch_mutex);
+    free(trace);
+    trace = samples;
+    trace_len = len;
+    pthread_mutex_unlock(&touch_mutex);
+
+    return true;
+}
+
+int ft6336u_sim_write(const uint8_t *src, size_t len) {
+    pthread_once(&touch_once, touch_sim_init);
+
+    if (len == 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&touch_mutex);
+    /* First byte sets the register pointer, the rest is written from there */
+    reg_ptr = src[0];
+    for (size_t i = 1; i < len; i++) {
+        regs[reg_ptr++] = src[i];
+    }
+    touch_int_start();
+    pthread_mutex_unlock(&touch_mutex);
+
+    return (int)len;
+}
+
+int ft6336u_sim_read(uint8_t *dst, size_t len) {
+    pthread_once(&touch_once, touch_sim_init);
+
+    pthread_mutex_lock(&touch_mutex);
+    if (reg_ptr <= FT6336U_REG_P2_MISC) {
+        touch_regs_update();
+    }
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = regs[reg_ptr++];
+    }
+    pthread_mutex_unlock(&touch_mutex);
+
+    return (int)len;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file hal_gpio.c
+ * @brief Simulated GPIO and interrupt controller
+ */
+
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hal_internal.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+static atomic_bool gpio_level[NUM_BANK0_GPIOS];
+static bool gpio_out[NUM_BANK0_GPIOS];
+
+/* One interrupt at a time, like a single NVIC priority level */
+static pthread_mutex_t irq_mutex = PTHREAD_MUTEX_INITIALIZER;
+static irq_handler_t irq_handlers[IRQ_COUNT];
+static atomic_bool irq_enabled[IRQ_COUNT];
+
+/* Edge interrupts of the GPIOs, one callback for all pins like the SDK */
+static atomic_uint gpio_irq_mask[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_irq_callback;
+
+/*===========================================
+ * GPIO
+ *===========================================*/
+
+void gpio_init(uint gpio) {
+    gpio_out[gpio] = false;
+    atomic_store(&gpio_level[gpio], false);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    gpio_out[gpio] = out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    atomic_store(&gpio_level[gpio], value);
+}
+
+bool gpio_get(uint gpio) {
+    return atomic_load(&gpio_level[gpio]);
+}
+
+void gpio_pull_up(uint gpio) {
+    if (!gpio_out[gpio]) {
+        atomic_store(&gpio_level[gpio], true);
+    }
+}
+
+void gpio_pull_down(uint gpio) {
+    if (!gpio_out[gpio]) {
+        atomic_store(&gpio_level[gpio], false);
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    pthread_mutex_lock(&irq_mutex);
+    gpio_irq_callback = callback;
+    pthread_mutex_unlock(&irq_mutex);
+
+    unsigned mask = atomic_load(&gpio_irq_mask[gpio]);
+    atomic_store(&gpio_irq_mask[gpio], enabled ? mask | event_mask : mask & ~event_mask);
+    if (enabled) {
+        irq_set_enabled(IO_IRQ_BANK0, true);
+    }
+}
+
+void hal_gpio_drive(uint gpio, bool value) {
+    bool prev = atomic_exchange(&gpio_level[gpio], value);
+    uint32_t event = 0;
+    if (prev && !value) {
+        event = GPIO_IRQ_EDGE_FALL;
+    } else if (!prev && value) {
+        event = GPIO_IRQ_EDGE_RISE;
+    }
+
+    event &= atomic_load(&gpio_irq_mask[gpio]);
+    if (event == 0 || !atomic_load(&irq_enabled[IO_IRQ_BANK0])) {
+        return;
+    }
+
+    pthread_mutex_lock(&irq_mutex);
+    if (gpio_irq_callback) {
+        gpio_irq_callback(gpio, event);
+    }
+    pthread_mutex_unlock(&irq_mutex);
+}
+
+/*===========================================
+ * IRQ
+ *===========================================*/
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    pthread_mutex_lock(&irq_mutex);
+    irq_handlers[num] = handler;
+    pthread_mutex_unlock(&irq_mutex);
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    atomic_store(&irq_enabled[num], enabled);
+}
+
+void hal_irq_raise(uint num) {
+    if (!atomic_load(&irq_enabled[num])) {
+        return;
+    }
+
+    pthread_mutex_lock(&irq_mutex);
+    if (irq_handlers[num]) {
+        irq_handlers[num]();
+    }
+    pthread_mutex_unlock(&irq_mutex);
+}
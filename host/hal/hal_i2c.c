@@ -0,0 +1,55 @@
+/**
+ * @file hal_i2c.c
+ * @brief Simulated I2C bus
+ */
+
+#include "hardware/i2c.h"
+#include "pico/time.h"
+#include "hal_internal.h"
+#include "ft6336u.h"
+
+i2c_inst_t i2c_sim_inst[2] = {
+    {.index = 0},
+    {.index = 1},
+};
+
+/**
+ * @brief Wait for the wire time of a transfer: address byte plus data, 9 bits each
+ */
+static void i2c_sim_wire_time(i2c_inst_t *i2c, size_t len) {
+    if (i2c->baudrate > 0) {
+        sleep_us(((uint64_t)(len + 1) * 9 * 1000000) / i2c->baudrate);
+    }
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    i2c->baudrate = 0;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    i2c_sim_wire_time(i2c, len);
+
+    if (addr == FT6336U_I2C_ADDR) {
+        return ft6336u_sim_write(src, len);
+    }
+
+    /* Nobody acknowledged the address */
+    return PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    i2c_sim_wire_time(i2c, len);
+
+    if (addr == FT6336U_I2C_ADDR) {
+        return ft6336u_sim_read(dst, len);
+    }
+
+    return PICO_ERROR_GENERIC;
+}
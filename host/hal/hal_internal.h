@@ -0,0 +1,46 @@
+/**
+ * @file hal_internal.h
+ * @brief Shared between the simulated peripherals
+ */
+
+#ifndef HAL_INTERNAL_H
+#define HAL_INTERNAL_H
+
+#include "pico/types.h"
+
+/* Wiring of the simulated board: FT6336U INT, PIN_TOUCH_INT in main.c */
+#define HAL_SIM_TOUCH_INT_GPIO      5
+
+/* Length of the INT pulse of a report in trigger mode */
+#define HAL_SIM_TOUCH_INT_PULSE_US  100
+
+/**
+ * @brief CLOCK_MONOTONIC time of boot (process start) in ns
+ */
+uint64_t hal_boot_ns(void);
+
+/**
+ * @brief Current CLOCK_MONOTONIC time in ns
+ */
+uint64_t hal_now_ns(void);
+
+/**
+ * @brief Run the handler of an interrupt if it is enabled
+ * @param num IRQ number
+ */
+void hal_irq_raise(uint num);
+
+/**
+ * @brief Drive an input pin from a simulated peripheral
+ * @param gpio GPIO number
+ * @param value Level
+ */
+void hal_gpio_drive(uint gpio, bool value);
+
+/**
+ * @brief Access the simulated FT6336U (called by the I2C bus)
+ */
+int ft6336u_sim_write(const uint8_t *src, size_t len);
+int ft6336u_sim_read(uint8_t *dst, size_t len);
+
+#endif /* HAL_INTERNAL_H */
@@ -0,0 +1,30 @@
+/**
+ * @file hal_sim.c
+ * @brief End of a simulated run
+ */
+
+#include "hal_sim.h"
+#include "hal_internal.h"
+#include "spi_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void sim_benchmark_done(uint32_t avg_fps) {
+    uint64_t elapsed_ns = hal_now_ns() - hal_boot_ns();
+    spi_sim_stats_t bus;
+    spi_sim_get_stats(&bus);
+
+    printf("SIM: SPI %u MHz, bus busy %u%%, %llu KiB in %u writes\n",
+           (unsigned)(spi_sim_get_baudrate() / 1000000),
+           (unsigned)(bus.busy_ns * 100 / (elapsed_ns ? elapsed_ns : 1)),
+           (unsigned long long)(bus.bytes / 1024), (unsigned)bus.writes);
+    printf("SIM: average %u FPS\n", (unsigned)avg_fps);
+
+    const char *min_fps = getenv("SIM_MIN_FPS");
+    if (min_fps && avg_fps < strtoul(min_fps, NULL, 0)) {
+        printf("SIM: FAIL, below the required %s FPS\n", min_fps);
+        exit(1);
+    }
+
+    exit(0);
+}
@@ -0,0 +1,262 @@
+/**
+ * @file hal_spi.c
+ * @brief Simulated SPI and DMA
+ */
+
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "hal_internal.h"
+#include "spi_sim.h"
+#include <pthread.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*===========================================
+ * Private Types and Variables
+ *===========================================*/
+
+typedef struct {
+    bool claimed;
+    bool busy;
+    bool irq0_enabled;
+    bool irq0_status;
+    uint64_t done_ns;       /* CLOCK_MONOTONIC time when the transfer completes */
+} dma_sim_channel_t;
+
+spi_inst_t spi_sim_inst[2] = {
+    {.index = 0},
+    {.index = 1},
+};
+
+static uint spi_baudrate[2];
+
+static pthread_mutex_t dma_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dma_cond;         /* Timer thread wake-up, uses CLOCK_MONOTONIC */
+static pthread_cond_t dma_done_cond;    /* Signalled when a transfer completes */
+static pthread_once_t dma_once = PTHREAD_ONCE_INIT;
+static dma_sim_channel_t dma_channels[NUM_DMA_CHANNELS];
+
+/*===========================================
+ * DMA Timer Thread
+ *===========================================*/
+
+/**
+ * @brief Complete transfers when their wire time is over and raise DMA_IRQ_0
+ */
+static void *dma_timer_thread(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&dma_mutex);
+    while (true) {
+        uint64_t next_ns = UINT64_MAX;
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+            if (dma_channels[ch].busy && dma_channels[ch].done_ns < next_ns) {
+                next_ns = dma_channels[ch].done_ns;
+            }
+        }
+
+        if (next_ns == UINT64_MAX) {
+            pthread_cond_wait(&dma_cond, &dma_mutex);
+            continue;
+        }
+
+        if (hal_now_ns() < next_ns) {
+            struct timespec ts = {
+                .tv_sec = (time_t)(next_ns / 1000000000u),
+                .tv_nsec = (long)(next_ns % 1000000000u),
+            };
+            pthread_cond_timedwait(&dma_cond, &dma_mutex, &ts);
+            continue;
+        }
+
+        bool raise = false;
+        uint64_t now = hal_now_ns();
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+            dma_sim_channel_t *c = &dma_channels[ch];
+            if (c->busy && c->done_ns <= now) {
+                c->busy = false;
+                if (c->irq0_enabled) {
+                    c->irq0_status = true;
+                    raise = true;
+                }
+            }
+        }
+        pthread_cond_broadcast(&dma_done_cond);
+
+        if (raise) {
+            /* The handler may start the next transfer */
+            pthread_mutex_unlock(&dma_mutex);
+            hal_irq_raise(DMA_IRQ_0);
+            pthread_mutex_lock(&dma_mutex);
+        }
+    }
+
+    return NULL;
+}
+
+static void dma_sim_start(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&dma_cond, &attr);
+    pthread_cond_init(&dma_done_cond, NULL);
+    pthread_condattr_destroy(&attr);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, dma_timer_thread, NULL);
+    pthread_detach(thread);
+}
+
+/*===========================================
+ * SPI
+ *===========================================*/
+
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate) {
+    /* Same divider search as the SDK: even prescaler 2..254, post-divider 1..256 */
+    uint32_t freq_in = clock_get_hz(clk_peri);
+    uint prescale, postdiv;
+
+    for (prescale = 2; prescale <= 254; prescale += 2) {
+        if (freq_in < prescale * 256 * (uint64_t)baudrate) {
+            break;
+        }
+    }
+    for (postdiv = 256; postdiv > 1; --postdiv) {
+        if (freq_in / (prescale * (postdiv - 1)) > baudrate) {
+            break;
+        }
+    }
+
+    spi_baudrate[spi->index] = freq_in / (prescale * postdiv);
+    spi_sim_init(spi_baudrate[spi->index]);
+    return spi_baudrate[spi->index];
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi) {
+    return spi_baudrate[spi->index];
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    return spi_set_baudrate(spi, baudrate);
+}
+
+void spi_deinit(spi_inst_t *spi) {
+    spi_baudrate[spi->index] = 0;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    (void)spi;
+    (void)src;
+    spi_sim_write_blocking(len);
+    return (int)len;
+}
+
+bool spi_is_busy(const spi_inst_t *spi) {
+    (void)spi;
+    return spi_sim_is_busy();
+}
+
+/*===========================================
+ * DMA
+ *===========================================*/
+
+int dma_claim_unused_channel(bool required) {
+    pthread_mutex_lock(&dma_mutex);
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!dma_channels[ch].claimed) {
+            dma_channels[ch].claimed = true;
+            pthread_mutex_unlock(&dma_mutex);
+            return (int)ch;
+        }
+    }
+    pthread_mutex_unlock(&dma_mutex);
+
+    if (required) {
+        fprintf(stderr, "No DMA channels are available\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    pthread_mutex_lock(&dma_mutex);
+    dma_channels[channel].claimed = false;
+    pthread_mutex_unlock(&dma_mutex);
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {.ctrl = DMA_CTRL_EN};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, 0x3f);      /* DREQ_FORCE */
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    return c;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    if (!trigger) {
+        return;
+    }
+
+    pthread_once(&dma_once, dma_sim_start);
+
+    size_t data_size = 1u << ((config->ctrl & DMA_CTRL_DATA_SIZE_MASK) >> DMA_CTRL_DATA_SIZE_LSB);
+    size_t bytes = (size_t)transfer_count * data_size;
+    uint64_t done_ns;
+
+    if (write_addr == &spi0->hw.dr || write_addr == &spi1->hw.dr) {
+        /* Paced by the SPI TX DREQ: takes the wire time of the data */
+        done_ns = spi_sim_start_write(bytes);
+    } else {
+        /* Memory to memory, instantaneous */
+        if (config->ctrl & DMA_CTRL_INCR_WRITE) {
+            memmove((void *)write_addr, (const void *)read_addr, bytes);
+        }
+        done_ns = hal_now_ns();
+    }
+
+    pthread_mutex_lock(&dma_mutex);
+    dma_channels[channel].busy = true;
+    dma_channels[channel].done_ns = done_ns;
+    pthread_cond_signal(&dma_cond);
+    pthread_mutex_unlock(&dma_mutex);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    pthread_mutex_lock(&dma_mutex);
+    bool busy = dma_channels[channel].busy;
+    pthread_mutex_unlock(&dma_mutex);
+    return busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    pthread_mutex_lock(&dma_mutex);
+    while (dma_channels[channel].busy) {
+        pthread_cond_wait(&dma_done_cond, &dma_mutex);
+    }
+    pthread_mutex_unlock(&dma_mutex);
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    pthread_mutex_lock(&dma_mutex);
+    dma_channels[channel].irq0_enabled = enabled;
+    pthread_mutex_unlock(&dma_mutex);
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    pthread_mutex_lock(&dma_mutex);
+    bool status = dma_channels[channel].irq0_status;
+    pthread_mutex_unlock(&dma_mutex);
+    return status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    pthread_mutex_lock(&dma_mutex);
+    dma_channels[channel].irq0_status = false;
+    pthread_mutex_unlock(&dma_mutex);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file hal_time.c
+ * @brief Simulated timer, clocks and stdio
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hal_internal.h"
+#include <stdio.h>
+#include <time.h>
+
+static uint64_t boot_ns;
+
+/* Boot is the start of the process */
+__attribute__((constructor)) static void hal_time_init(void) {
+    boot_ns = hal_now_ns();
+}
+
+uint64_t hal_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+uint64_t hal_boot_ns(void) {
+    return boot_ns;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return (hal_now_ns() - boot_ns) / 1000;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+uint64_t time_us_64(void) {
+    return get_absolute_time();
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)get_absolute_time();
+}
+
+void sleep_us(uint64_t us) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(us / 1000000),
+        .tv_nsec = (long)(us % 1000000) * 1000,
+    };
+    while (nanosleep(&ts, &ts) != 0) {
+        /* Interrupted, sleep for the rest */
+    }
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    switch (clk_index) {
+        case clk_ref:
+            return 12 * 1000 * 1000;
+        case clk_usb:
+        case clk_adc:
+            return 48 * 1000 * 1000;
+        default:
+            return SYS_CLK_HZ;
+    }
+}
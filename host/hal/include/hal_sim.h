@@ -0,0 +1,43 @@
+/**
+ * @file hal_sim.h
+ * @brief Controls of the simulated board that have no Pico SDK equivalent
+ *
+ * Only available when building for the host (PICO_ON_DEVICE == 0).
+ *
+ * Environment variables read by the simulator:
+ * - SIM_TOUCH_TRACE: FT6336U touch trace to replay, see sim_touch_load_trace()
+ * - SIM_MIN_FPS:     sim_benchmark_done() exits with 1 below this average FPS
+ */
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include "pico/types.h"
+
+/**
+ * @brief Load a touch trace for the simulated FT6336U
+ *
+ * One sample per line, `#` starts a comment:
+ *
+ *     <time ms> <touch count> [<x1> <y1> [<x2> <y2>]]
+ *
+ * Times are since boot and must increase. Coordinates are raw panel
+ * coordinates as the FT6336U reports them (before swap/invert). A sample
+ * holds until the next one, a count of 0 releases all fingers.
+ *
+ * @param path Trace file
+ * @return true on success, false if the file can't be read or parsed
+ */
+bool sim_touch_load_trace(const char *path);
+
+/**
+ * @brief Report the end of the benchmark and terminate the simulation
+ *
+ * Prints the SPI bus statistics and exits with status 1 if `avg_fps` is
+ * below SIM_MIN_FPS, 0 otherwise.
+ *
+ * @param avg_fps Average FPS of all benchmark scenes
+ */
+void sim_benchmark_done(uint32_t avg_fps);
+
+#endif /* HAL_SIM_H */
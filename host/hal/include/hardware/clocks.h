@@ -0,0 +1,30 @@
+/**
+ * @file clocks.h
+ * @brief Host stand-in for hardware/clocks.h
+ */
+
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+#include "pico/types.h"
+
+/* RP2350 defaults: 150 MHz system clock, clk_peri runs from clk_sys */
+#define SYS_CLK_HZ      (150 * 1000 * 1000)
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_gpout1,
+    clk_gpout2,
+    clk_gpout3,
+    clk_ref,
+    clk_sys,
+    clk_peri,
+    clk_hstx,
+    clk_usb,
+    clk_adc,
+    CLK_COUNT
+};
+
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif /* _HARDWARE_CLOCKS_H */
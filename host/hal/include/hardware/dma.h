@@ -0,0 +1,73 @@
+/**
+ * @file dma.h
+ * @brief Host stand-in for hardware/dma.h
+ *
+ * Only memory to SPI TX FIFO transfers are simulated. A triggered transfer
+ * occupies the SPI bus for its wire time and completes on a timer thread,
+ * which raises DMA_IRQ_0 if enabled for the channel.
+ */
+
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+#include "pico/types.h"
+#include "hardware/irq.h"
+
+#define NUM_DMA_CHANNELS    16
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+/* Fields of dma_channel_config.ctrl (same layout as CHx_CTRL_TRIG) */
+#define DMA_CTRL_EN             (1u << 0)
+#define DMA_CTRL_DATA_SIZE_LSB  2
+#define DMA_CTRL_DATA_SIZE_MASK (3u << DMA_CTRL_DATA_SIZE_LSB)
+#define DMA_CTRL_INCR_READ      (1u << 4)
+#define DMA_CTRL_INCR_WRITE     (1u << 6)
+#define DMA_CTRL_CHAIN_TO_LSB   13
+#define DMA_CTRL_CHAIN_TO_MASK  (0xfu << DMA_CTRL_CHAIN_TO_LSB)
+#define DMA_CTRL_TREQ_SEL_LSB   17
+#define DMA_CTRL_TREQ_SEL_MASK  (0x3fu << DMA_CTRL_TREQ_SEL_LSB)
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~DMA_CTRL_DATA_SIZE_MASK) | ((uint32_t)size << DMA_CTRL_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? (c->ctrl | DMA_CTRL_INCR_READ) : (c->ctrl & ~DMA_CTRL_INCR_READ);
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? (c->ctrl | DMA_CTRL_INCR_WRITE) : (c->ctrl & ~DMA_CTRL_INCR_WRITE);
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->ctrl = (c->ctrl & ~DMA_CTRL_TREQ_SEL_MASK) | ((uint32_t)dreq << DMA_CTRL_TREQ_SEL_LSB);
+}
+
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->ctrl = (c->ctrl & ~DMA_CTRL_CHAIN_TO_MASK) | ((uint32_t)chain_to << DMA_CTRL_CHAIN_TO_LSB);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+
+#endif /* _HARDWARE_DMA_H */
@@ -0,0 +1,30 @@
+/**
+ * @file i2c.h
+ * @brief Host stand-in for hardware/i2c.h
+ *
+ * Transfers take their wire time at the configured baud rate (9 bits per
+ * byte plus the address byte) and are routed to the simulated devices, at
+ * the moment only the FT6336U (see hal_sim.h).
+ */
+
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+#include "pico/types.h"
+
+typedef struct i2c_inst {
+    uint index;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c_sim_inst[2];
+
+#define i2c0    (&i2c_sim_inst[0])
+#define i2c1    (&i2c_sim_inst[1])
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif /* _HARDWARE_I2C_H */
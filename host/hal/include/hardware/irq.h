@@ -0,0 +1,35 @@
+/**
+ * @file irq.h
+ * @brief Host stand-in for hardware/irq.h
+ *
+ * Interrupt handlers run on the simulator thread that raised the interrupt.
+ * Handlers are serialised against each other but not against the main
+ * thread, so they must only touch state that is safe to share (volatile
+ * flags, lv_display_flush_ready()) - the same rule as on the device.
+ */
+
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+typedef void (*irq_handler_t)(void);
+
+enum irq_num {
+    TIMER0_IRQ_0 = 0,
+    DMA_IRQ_0 = 10,
+    DMA_IRQ_1 = 11,
+    DMA_IRQ_2 = 12,
+    DMA_IRQ_3 = 13,
+    IO_IRQ_BANK0 = 21,
+    SPI0_IRQ = 31,
+    SPI1_IRQ = 32,
+    I2C0_IRQ = 36,
+    I2C1_IRQ = 37,
+    IRQ_COUNT = 52
+};
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif /* _HARDWARE_IRQ_H */
@@ -0,0 +1,57 @@
+/**
+ * @file spi.h
+ * @brief Host stand-in for hardware/spi.h
+ *
+ * Writes occupy the simulated bus (host/spi_sim.c) for their wire time at
+ * the baud rate the RP2350 would actually generate. The data is dropped.
+ */
+
+#ifndef _HARDWARE_SPI_H
+#define _HARDWARE_SPI_H
+
+#include "pico/types.h"
+
+typedef struct {
+    io_rw_32 cr0;
+    io_rw_32 cr1;
+    io_rw_32 dr;
+    io_ro_32 sr;
+    io_rw_32 cpsr;
+} spi_hw_t;
+
+typedef struct spi_inst {
+    spi_hw_t hw;
+    uint index;
+} spi_inst_t;
+
+extern spi_inst_t spi_sim_inst[2];
+
+#define spi0    (&spi_sim_inst[0])
+#define spi1    (&spi_sim_inst[1])
+
+/* DREQ numbers of the RP2350 */
+#define DREQ_SPI0_TX    24
+#define DREQ_SPI0_RX    25
+#define DREQ_SPI1_TX    26
+#define DREQ_SPI1_RX    27
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+void spi_deinit(spi_inst_t *spi);
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate);
+uint spi_get_baudrate(const spi_inst_t *spi);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+bool spi_is_busy(const spi_inst_t *spi);
+
+static inline spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &spi->hw;
+}
+
+static inline uint spi_get_index(const spi_inst_t *spi) {
+    return spi->index;
+}
+
+static inline uint spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+    return (spi->index ? DREQ_SPI1_TX : DREQ_SPI0_TX) + !is_tx;
+}
+
+#endif /* _HARDWARE_SPI_H */
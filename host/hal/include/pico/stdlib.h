@@ -0,0 +1,21 @@
+/**
+ * @file stdlib.h
+ * @brief Host stand-in for pico/stdlib.h
+ */
+
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+/**
+ * @brief Make stdout line buffered so the log interleaves like the UART does
+ */
+bool stdio_init_all(void);
+
+static inline void tight_loop_contents(void) {
+}
+
+#endif /* _PICO_STDLIB_H */
@@ -0,0 +1,21 @@
+/**
+ * @file time.h
+ * @brief Host stand-in for pico/time.h, based on CLOCK_MONOTONIC
+ *
+ * "Boot" is the start of the process.
+ */
+
+#ifndef _PICO_TIME_H
+#define _PICO_TIME_H
+
+#include "pico/types.h"
+
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t to_us_since_boot(absolute_time_t t);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#endif /* _PICO_TIME_H */
@@ -0,0 +1,29 @@
+/**
+ * @file types.h
+ * @brief Host stand-in for the Pico SDK basic types
+ */
+
+#ifndef _PICO_TYPES_H
+#define _PICO_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef PICO_ON_DEVICE
+#define PICO_ON_DEVICE 0
+#endif
+
+typedef unsigned int uint;
+
+typedef uint64_t absolute_time_t;
+
+/* Volatile register types used by the hardware structs */
+typedef volatile uint32_t io_rw_32;
+typedef volatile const uint32_t io_ro_32;
+
+#define PICO_OK                 0
+#define PICO_ERROR_GENERIC      (-1)
+#define PICO_ERROR_TIMEOUT      (-2)
+
+#endif /* _PICO_TYPES_H */
@@ -0,0 +1,126 @@
+/**
+ * @file lcd_dma_chain_replay.c
+ * @brief Host replay of batched MIPI DBI transfers
+ */
+
+#include "lcd_dma_chain_replay.h"
+#include "spi_sim.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+static pthread_mutex_t replay_mutex = PTHREAD_MUTEX_INITIALIZER;
+static lcd_dma_chain_replay_stats_t replay_stats;
+static lcd_dma_chain_replay_seg_t last_segs[LV_LCD_TRANSFER_SEG_MAX];
+static uint32_t last_seg_cnt;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void lcd_dma_chain_init(spi_inst_t *spi, uint pin_dc, uint pin_cs) {
+    (void)spi;
+    (void)pin_dc;
+    (void)pin_cs;
+    lcd_dma_chain_replay_reset();
+}
+
+void lcd_dma_chain_run(const lv_lcd_transfer_t *xfer) {
+    lcd_dma_chain_replay_seg_t segs[LV_LCD_TRANSFER_SEG_MAX];
+    uint32_t seg_cnt = 0;
+    uint32_t dc_switches = 0;
+    uint64_t bytes = 0;
+    uint64_t wire_ns = 0;
+
+    /* The chain is paced by the bus only: every segment starts where the previous one ended */
+    uint64_t t = now_ns();
+    uint64_t first_ns = 0;
+    uint32_t pending = 0;       /* Bytes since the last DC change */
+    lv_lcd_dc_t dc = xfer->seg[0].dc;
+    for (uint32_t i = 0; i < xfer->seg_cnt; i++) {
+        const lv_lcd_transfer_seg_t *seg = &xfer->seg[i];
+        if (seg->size == 0) {
+            continue;
+        }
+
+        if (seg->dc != dc) {
+            /* The device chain waits for these bytes in the RX FIFO, more would overrun it and hang */
+            if (pending > LCD_DMA_CHAIN_FIFO_DEPTH) {
+                fprintf(stderr, "DC change after %u bytes in segment %u, the RX FIFO holds %u\n",
+                        (unsigned)pending, (unsigned)i, (unsigned)LCD_DMA_CHAIN_FIFO_DEPTH);
+                abort();
+            }
+            t += LCD_DMA_CHAIN_REPLAY_DC_NS;
+            dc = seg->dc;
+            dc_switches++;
+            pending = 0;
+        }
+        pending += seg->size;
+
+        uint64_t seg_wire_ns = (uint64_t)seg->size * 8 * 1000000000u / spi_sim_get_baudrate();
+        uint64_t end = spi_sim_start_write_at(seg->size, t);
+        lcd_dma_chain_replay_seg_t *r = &segs[seg_cnt++];
+        r->dc = seg->dc;
+        r->size = seg->size;
+        r->first = lv_lcd_transfer_seg_get_data(seg)[0];
+        r->start_ns = end - seg_wire_ns;
+        r->end_ns = end;
+        if (seg_cnt == 1) {
+            first_ns = r->start_ns;
+        }
+
+        bytes += seg->size;
+        wire_ns += seg_wire_ns;
+        t = end;
+    }
+
+    pthread_mutex_lock(&replay_mutex);
+    memcpy(last_segs, segs, sizeof(segs[0]) * seg_cnt);
+    last_seg_cnt = seg_cnt;
+    replay_stats.transfers++;
+    replay_stats.dc_switches += dc_switches;
+    replay_stats.bytes += bytes;
+    replay_stats.wire_ns += wire_ns;
+    replay_stats.span_ns += seg_cnt ? t - first_ns : 0;
+    pthread_mutex_unlock(&replay_mutex);
+
+    /* Like the device version, return when the last bit is on the wire */
+    spi_sim_wait(t);
+}
+
+void lcd_dma_chain_replay_reset(void) {
+    pthread_mutex_lock(&replay_mutex);
+    replay_stats = (lcd_dma_chain_replay_stats_t){0};
+    last_seg_cnt = 0;
+    pthread_mutex_unlock(&replay_mutex);
+}
+
+void lcd_dma_chain_replay_get_stats(lcd_dma_chain_replay_stats_t *stats) {
+    pthread_mutex_lock(&replay_mutex);
+    *stats = replay_stats;
+    pthread_mutex_unlock(&replay_mutex);
+}
+
+uint32_t lcd_dma_chain_replay_get_last(lcd_dma_chain_replay_seg_t *segs) {
+    pthread_mutex_lock(&replay_mutex);
+    uint32_t cnt = last_seg_cnt;
+    memcpy(segs, last_segs, sizeof(segs[0]) * cnt);
+    pthread_mutex_unlock(&replay_mutex);
+    return cnt;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file lcd_dma_chain_replay.h
+ * @brief Host replay of batched MIPI DBI transfers
+ *
+ * Implements lcd_dma_chain.h on the simulated bus: the segments of a
+ * transfer are queued back to back like the DMA chain sends them, the DC
+ * line changes LCD_DMA_CHAIN_REPLAY_DC_NS after the last bit of the previous
+ * segment. The timeline of the last transfer and running totals can be read
+ * back for timing tests. A DC change after more than LCD_DMA_CHAIN_FIFO_DEPTH
+ * bytes, which would hang the device chain, aborts.
+ */
+
+#ifndef LCD_DMA_CHAIN_REPLAY_H
+#define LCD_DMA_CHAIN_REPLAY_H
+
+#include "lcd_dma_chain.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Bus idle time of a DC change: the RX wait step finishing plus the IO_BANK0 write */
+#define LCD_DMA_CHAIN_REPLAY_DC_NS      100
+
+/*===========================================
+ * Data Structures
+ *===========================================*/
+
+/**
+ * @brief One replayed segment
+ */
+typedef struct {
+    lv_lcd_dc_t dc;         /* DC level */
+    uint32_t size;          /* Bytes */
+    uint8_t first;          /* First byte, the command for command segments */
+    uint64_t start_ns;      /* First bit on the wire (CLOCK_MONOTONIC) */
+    uint64_t end_ns;        /* Last bit on the wire (CLOCK_MONOTONIC) */
+} lcd_dma_chain_replay_seg_t;
+
+/**
+ * @brief Totals since the last reset
+ */
+typedef struct {
+    uint32_t transfers;     /* Transfers replayed */
+    uint32_t dc_switches;   /* DC changes inside the transfers */
+    uint64_t bytes;         /* Bytes sent */
+    uint64_t wire_ns;       /* Time the bytes occupy the bus */
+    uint64_t span_ns;       /* First bit to last bit of every transfer, summed */
+} lcd_dma_chain_replay_stats_t;
+
+/*===========================================
+ * Function Prototypes
+ *===========================================*/
+
+/**
+ * @brief Clear the totals
+ */
+void lcd_dma_chain_replay_reset(void);
+
+/**
+ * @brief Get the totals
+ * @param stats Pointer to the structure to fill
+ */
+void lcd_dma_chain_replay_get_stats(lcd_dma_chain_replay_stats_t *stats);
+
+/**
+ * @brief Get the timeline of the last transfer
+ * @param segs Array of LV_LCD_TRANSFER_SEG_MAX elements to fill
+ * @return Number of segments
+ */
+uint32_t lcd_dma_chain_replay_get_last(lcd_dma_chain_replay_seg_t *segs);
+
+#endif /* LCD_DMA_CHAIN_REPLAY_H */
@@ -0,0 +1,24 @@
+/**
+ * @file lv_conf_threads.h
+ * @brief lv_conf.h of the firmware with SW render threads (host builds)
+ *
+ * The same configuration with LV_USE_OS = LV_OS_PTHREAD and
+ * BENCH_DRAW_UNIT_CNT render threads, for host/bench_band.
+ */
+
+#ifndef LV_CONF_THREADS_H
+#define LV_CONF_THREADS_H
+
+#include "../lv_conf.h"
+
+#undef LV_USE_OS
+#define LV_USE_OS   LV_OS_PTHREAD
+
+#undef LV_DRAW_SW_DRAW_UNIT_CNT
+#ifdef BENCH_DRAW_UNIT_CNT
+#define LV_DRAW_SW_DRAW_UNIT_CNT    BENCH_DRAW_UNIT_CNT
+#else
+#define LV_DRAW_SW_DRAW_UNIT_CNT    1
+#endif
+
+#endif /* LV_CONF_THREADS_H */
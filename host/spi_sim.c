@@ -0,0 +1,92 @@
+/**
+ * @file spi_sim.c
+ * @brief Simulated SPI bus for host builds
+ */
+
+#include "spi_sim.h"
+#include <pthread.h>
+#include <time.h>
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+static pthread_mutex_t bus_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t bus_baudrate = SPI_SIM_DEFAULT_BAUDRATE;
+static uint64_t bus_free_at_ns;
+static spi_sim_stats_t bus_stats;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void spi_sim_init(uint32_t baudrate) {
+    pthread_mutex_lock(&bus_mutex);
+    bus_baudrate = baudrate;
+    bus_free_at_ns = 0;
+    bus_stats = (spi_sim_stats_t){0};
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+uint32_t spi_sim_get_baudrate(void) {
+    return bus_baudrate;
+}
+
+uint64_t spi_sim_start_write(size_t len) {
+    return spi_sim_start_write_at(len, now_ns());
+}
+
+uint64_t spi_sim_start_write_at(size_t len, uint64_t start_ns) {
+    uint64_t wire_ns = (uint64_t)len * 8 * 1000000000u / bus_baudrate;
+
+    pthread_mutex_lock(&bus_mutex);
+    uint64_t start = start_ns;
+    if (bus_free_at_ns > start) {
+        start = bus_free_at_ns;
+    }
+    bus_free_at_ns = start + wire_ns;
+    uint64_t done = bus_free_at_ns;
+    bus_stats.bytes += len;
+    bus_stats.busy_ns += wire_ns;
+    bus_stats.writes++;
+    pthread_mutex_unlock(&bus_mutex);
+
+    return done;
+}
+
+void spi_sim_wait(uint64_t deadline_ns) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000u),
+        .tv_nsec = (long)(deadline_ns % 1000000000u),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        /* Interrupted, sleep again */
+    }
+}
+
+void spi_sim_write_blocking(size_t len) {
+    spi_sim_wait(spi_sim_start_write(len));
+}
+
+bool spi_sim_is_busy(void) {
+    pthread_mutex_lock(&bus_mutex);
+    bool busy = bus_free_at_ns > now_ns();
+    pthread_mutex_unlock(&bus_mutex);
+    return busy;
+}
+
+void spi_sim_get_stats(spi_sim_stats_t *stats) {
+    pthread_mutex_lock(&bus_mutex);
+    *stats = bus_stats;
+    pthread_mutex_unlock(&bus_mutex);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file spi_sim.h
+ * @brief Simulated SPI bus for host builds
+ *
+ * Nothing is sent anywhere, the bus only takes as long as the real one would:
+ * every write occupies the bus for `bytes * 8 / baudrate` seconds of wall clock
+ * time. Writes queue up behind each other like on a real bus.
+ */
+
+#ifndef SPI_SIM_H
+#define SPI_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Fastest SCK the RP2350 can generate for the ST7796 (clk_peri / 2) */
+#define SPI_SIM_DEFAULT_BAUDRATE    (75 * 1000 * 1000)
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint64_t bytes;         /* Bytes written */
+    uint64_t busy_ns;       /* Time the bus was occupied */
+    uint32_t writes;        /* Number of writes */
+} spi_sim_stats_t;
+
+/**
+ * @brief Set the simulated SCK frequency and reset the statistics
+ * @param baudrate SCK frequency in Hz
+ */
+void spi_sim_init(uint32_t baudrate);
+
+/**
+ * @brief Get the simulated SCK frequency
+ * @return SCK frequency in Hz
+ */
+uint32_t spi_sim_get_baudrate(void);
+
+/**
+ * @brief Occupy the bus with a write without waiting for it
+ * @param len Number of bytes
+ * @return CLOCK_MONOTONIC time in ns when the last bit leaves the bus
+ */
+uint64_t spi_sim_start_write(size_t len);
+
+/**
+ * @brief Occupy the bus from a given time, or from when it is free if that is later
+ *
+ * Unlike spi_sim_start_write() the current time is not taken into account, so
+ * sequences paced by hardware (e.g. DMA chains) are timed without the host's
+ * scheduling gaps.
+ *
+ * @param len Number of bytes
+ * @param start_ns CLOCK_MONOTONIC time in ns of the first bit
+ * @return CLOCK_MONOTONIC time in ns when the last bit leaves the bus
+ */
+uint64_t spi_sim_start_write_at(size_t len, uint64_t start_ns);
+
+/**
+ * @brief Sleep until an absolute CLOCK_MONOTONIC time
+ * @param deadline_ns Time returned by spi_sim_start_write()
+ */
+void spi_sim_wait(uint64_t deadline_ns);
+
+/**
+ * @brief Write and wait until the write is on the wire
+ * @param len Number of bytes
+ */
+void spi_sim_write_blocking(size_t len);
+
+/**
+ * @brief Check whether the bus is still sending
+ * @return true until the last queued write is on the wire
+ */
+bool spi_sim_is_busy(void);
+
+/**
+ * @brief Get the bus statistics
+ * @param stats Pointer to the structure to fill
+ */
+void spi_sim_get_stats(spi_sim_stats_t *stats);
+
+#endif /* SPI_SIM_H */
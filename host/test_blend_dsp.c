@@ -0,0 +1,367 @@
+/**
+ * @file test_blend_dsp.c
+ * @brief The DSP blend kernels (blend_dsp.c) against LVGL's scalar blending
+ *
+ * blend_dsp.c is built here with BLEND_DSP_EMULATE, on the portable C
+ * emulation of the DSP instructions, while the LVGL library has no DSP
+ * backend and blends with its scalar code (its SIMD hooks are switched
+ * off). Every kernel runs on random rows of random widths, heights, strides
+ * and alignments of the destination, the mask and the source, with plain
+ * runs and random pixels, opacities and mask values; the whole destination
+ * buffer (also around the blended area) must match the scalar result bit
+ * for bit. Cases a kernel leaves to the scalar code (LV_RESULT_INVALID) run
+ * the scalar code, as the hooks do.
+ *
+ * The color fills are also checked exhaustively: every opacity and every
+ * mask value on every destination color.
+ *
+ * AL88 isn't enabled in lv_conf.h, so its scalar reference is the same
+ * image as ARGB8888 with the luminance in all three channels:
+ * lv_color_8_16_mix() is lv_color_24_16_mix() of such a pixel.
+ *
+ * Usage: test_blend_dsp [--cases N] [--seed N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565_swapped.h"
+#include "blend_dsp.h"
+#include "blend_simd.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define MAX_W       72
+#define MAX_H       5
+#define PAD         8           /* Pixels around the blended area, must stay untouched */
+#define BUF_PX      ((MAX_W + 2 * PAD) * (MAX_H + 2))
+
+typedef enum {
+    SRC_COLOR,
+    SRC_RGB565,
+    SRC_RGB565_SWAPPED,
+    SRC_ARGB8888,
+    SRC_AL88,
+    SRC_CNT,
+} src_t;
+
+static const char *src_names[SRC_CNT] = {"color", "RGB565", "RGB565_SWAPPED", "ARGB8888", "AL88"};
+
+typedef enum {
+    VARIANT_PLAIN,      /* No mask, opa >= LV_OPA_MAX */
+    VARIANT_OPA,
+    VARIANT_MASK,
+    VARIANT_MASK_OPA,
+    VARIANT_CNT,
+} variant_t;
+
+static const char *variant_names[VARIANT_CNT] = {"plain", "opa", "mask", "mask+opa"};
+
+/* Geometry and content of one case */
+typedef struct {
+    int32_t w;
+    int32_t h;
+    int32_t dest_stride;        /* In pixels */
+    int32_t dest_ofs;           /* Pixel offset of the blended area, changes the alignment */
+    int32_t mask_stride;
+    int32_t mask_ofs;
+    int32_t src_stride;
+    int32_t src_ofs;
+    lv_opa_t opa;
+    lv_color_t color;
+} case_t;
+
+static uint16_t dest_init[BUF_PX];
+static uint16_t dest_ref[BUF_PX];
+static uint16_t dest_dsp[BUF_PX];
+static uint8_t mask_buf[BUF_PX + 4];
+static uint8_t src_buf[BUF_PX * 4 + 4] __attribute__((aligned(4)));
+static uint8_t src_argb_buf[BUF_PX * 4 + 4] __attribute__((aligned(4)));   /* AL88 as ARGB8888 */
+
+static uint32_t rng_state = 1;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint32_t rnd(void) {
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Random bytes with runs: blending code takes shortcuts on repeated and extreme values */
+static void fill_random(uint8_t *buf, size_t len, size_t unit) {
+    size_t i = 0;
+    while (i < len) {
+        size_t run = (1 + rnd() % 9) * unit;
+        uint32_t kind = rnd() % 4;
+        uint8_t v[4];
+        for (size_t k = 0; k < 4; k++) {
+            v[k] = (uint8_t)rnd();
+        }
+        for (size_t j = 0; j < run && i < len; j++, i++) {
+            switch (kind) {
+                case 0: buf[i] = 0x00; break;
+                case 1: buf[i] = 0xFF; break;
+                case 2: buf[i] = v[j % unit]; break;  /* The same value repeated */
+                default: buf[i] = (uint8_t)rnd(); break;
+            }
+        }
+    }
+}
+
+static void random_case(case_t *c, src_t src, variant_t variant) {
+    c->w = 1 + rnd() % MAX_W;
+    c->h = 1 + rnd() % MAX_H;
+    c->dest_stride = c->w + rnd() % (2 * PAD);
+    c->dest_ofs = PAD / 2 + rnd() % 2;
+    c->mask_stride = c->w + rnd() % 5;
+    c->mask_ofs = rnd() % 4;
+    c->src_stride = c->w + rnd() % 3;
+    c->src_ofs = rnd() % 2;
+    c->color = lv_color_hex(rnd());
+
+    switch (variant) {
+        case VARIANT_PLAIN:
+        case VARIANT_MASK:
+            c->opa = LV_OPA_MAX + rnd() % (256 - LV_OPA_MAX);
+            break;
+        default:
+            c->opa = rnd() % LV_OPA_MAX;
+            break;
+    }
+
+    fill_random((uint8_t *)dest_init, sizeof(dest_init), 2);
+    fill_random(mask_buf, sizeof(mask_buf), 1);
+    fill_random(src_buf, sizeof(src_buf), src == SRC_ARGB8888 ? 4 : 2);
+}
+
+/* AL88 source as ARGB8888 for the scalar reference */
+static void al88_to_argb8888(const case_t *c) {
+    for (int32_t i = 0; i < (c->h + 1) * c->src_stride; i++) {
+        const lv_color16a_t *px = (const lv_color16a_t *)(src_buf + (c->src_ofs + i) * 2);
+        uint8_t *out = src_argb_buf + i * 4;
+        out[0] = px->lumi;
+        out[1] = px->lumi;
+        out[2] = px->lumi;
+        out[3] = px->alpha;
+    }
+}
+
+/* Blend one case into `dest` with the scalar code or with the DSP kernels */
+static void blend(const case_t *c, src_t src, variant_t variant, bool dest_swapped, bool dsp, uint16_t *dest) {
+    bool mask = variant == VARIANT_MASK || variant == VARIANT_MASK_OPA;
+    memcpy(dest, dest_init, sizeof(dest_init));
+
+    if (src == SRC_COLOR) {
+        lv_draw_sw_blend_fill_dsc_t dsc = {
+            .dest_buf = dest + c->dest_ofs,
+            .dest_w = c->w,
+            .dest_h = c->h,
+            .dest_stride = c->dest_stride * 2,
+            .mask_buf = mask ? mask_buf + c->mask_ofs : NULL,
+            .mask_stride = c->mask_stride,
+            .color = c->color,
+            .opa = c->opa,
+        };
+        if (dsp && blend_dsp_color_to_rgb565(&dsc, dest_swapped) == LV_RESULT_OK) {
+            return;
+        }
+        if (dest_swapped) {
+            lv_draw_sw_blend_color_to_rgb565_swapped(&dsc);
+        } else {
+            lv_draw_sw_blend_color_to_rgb565(&dsc);
+        }
+        return;
+    }
+
+    lv_draw_sw_blend_image_dsc_t dsc = {
+        .dest_buf = dest + c->dest_ofs,
+        .dest_w = c->w,
+        .dest_h = c->h,
+        .dest_stride = c->dest_stride * 2,
+        .mask_buf = mask ? mask_buf + c->mask_ofs : NULL,
+        .mask_stride = c->mask_stride,
+        .opa = c->opa,
+        .blend_mode = LV_BLEND_MODE_NORMAL,
+    };
+
+    lv_result_t res = LV_RESULT_INVALID;
+    switch (src) {
+        case SRC_RGB565:
+        case SRC_RGB565_SWAPPED:
+            dsc.src_buf = src_buf + c->src_ofs * 2;
+            dsc.src_stride = c->src_stride * 2;
+            dsc.src_color_format = src == SRC_RGB565 ? LV_COLOR_FORMAT_RGB565 : LV_COLOR_FORMAT_RGB565_SWAPPED;
+            if (dsp) {
+                res = blend_dsp_rgb565_to_rgb565(&dsc, src == SRC_RGB565_SWAPPED, dest_swapped);
+            }
+            break;
+        case SRC_ARGB8888:
+            dsc.src_buf = src_buf + c->src_ofs * 4;
+            dsc.src_stride = c->src_stride * 4;
+            dsc.src_color_format = LV_COLOR_FORMAT_ARGB8888;
+            if (dsp) {
+                res = blend_dsp_argb8888_to_rgb565(&dsc, dest_swapped);
+            }
+            break;
+        default:
+            if (dsp) {
+                dsc.src_buf = src_buf + c->src_ofs * 2;
+                dsc.src_stride = c->src_stride * 2;
+                dsc.src_color_format = LV_COLOR_FORMAT_AL88;
+                res = blend_dsp_al88_to_rgb565(&dsc, dest_swapped);
+            } else {
+                al88_to_argb8888(c);
+                dsc.src_buf = src_argb_buf;
+                dsc.src_stride = c->src_stride * 4;
+                dsc.src_color_format = LV_COLOR_FORMAT_ARGB8888;
+            }
+            break;
+    }
+
+    if (res == LV_RESULT_OK) {
+        return;
+    }
+    if (dest_swapped) {
+        lv_draw_sw_blend_image_to_rgb565_swapped(&dsc);
+    } else {
+        lv_draw_sw_blend_image_to_rgb565(&dsc);
+    }
+}
+
+static bool run_case(src_t src, variant_t variant, bool dest_swapped) {
+    case_t c;
+    random_case(&c, src, variant);
+    blend(&c, src, variant, dest_swapped, false, dest_ref);
+    blend(&c, src, variant, dest_swapped, true, dest_dsp);
+
+    for (int32_t i = 0; i < BUF_PX; i++) {
+        if (dest_ref[i] != dest_dsp[i]) {
+            printf("FAIL %s %s to RGB565%s: w %d h %d dest_ofs %d stride %d mask_ofs %d opa %d, "
+                   "px %d: scalar 0x%04x, DSP 0x%04x\n",
+                   src_names[src], variant_names[variant], dest_swapped ? "_SWAPPED" : "",
+                   (int)c.w, (int)c.h, (int)c.dest_ofs, (int)c.dest_stride, (int)c.mask_ofs, c.opa,
+                   (int)i, dest_ref[i], dest_dsp[i]);
+            failures++;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Every opacity and every mask value on every destination color */
+static void check_fill_exhaustive(bool dest_swapped) {
+    static uint16_t all_ref[65536];
+    static uint16_t all_dsp[65536];
+    static uint8_t mask_all[65536];
+    uint32_t mismatches = 0;
+
+    for (uint32_t v = 0; v < 256; v++) {
+        /* Shifted by one every round: every mask value on every color */
+        for (uint32_t i = 0; i < 65536; i++) {
+            mask_all[i] = (uint8_t)(i + (i >> 8) + v);
+        }
+
+        for (int variant = VARIANT_OPA; variant < VARIANT_CNT; variant++) {
+            for (uint32_t i = 0; i < 65536; i++) {
+                all_ref[i] = (uint16_t)i;
+            }
+            memcpy(all_dsp, all_ref, sizeof(all_ref));
+
+            lv_draw_sw_blend_fill_dsc_t dsc = {
+                .dest_w = 256,
+                .dest_h = 256,
+                .dest_stride = 512,
+                .mask_buf = variant == VARIANT_OPA ? NULL : mask_all,
+                .mask_stride = 256,
+                .color = lv_color_hex(rnd()),
+            };
+            switch (variant) {
+                case VARIANT_OPA: dsc.opa = (lv_opa_t)LV_MIN(v, LV_OPA_MAX - 1); break;
+                case VARIANT_MASK: dsc.opa = LV_OPA_COVER; break;
+                default: dsc.opa = (lv_opa_t)(rnd() % LV_OPA_MAX); break;
+            }
+
+            dsc.dest_buf = all_ref;
+            if (dest_swapped) {
+                lv_draw_sw_blend_color_to_rgb565_swapped(&dsc);
+            } else {
+                lv_draw_sw_blend_color_to_rgb565(&dsc);
+            }
+            dsc.dest_buf = all_dsp;
+            CHECK(blend_dsp_color_to_rgb565(&dsc, dest_swapped) == LV_RESULT_OK);
+
+            if (memcmp(all_ref, all_dsp, sizeof(all_ref)) != 0) {
+                mismatches++;
+            }
+        }
+    }
+    printf("Fill to RGB565%s, every opa and mask value on every color: %s\n", dest_swapped ? "_SWAPPED" : "",
+           mismatches ? "MISMATCH" : "bit-exact");
+    CHECK(mismatches == 0);
+}
+
+/*===========================================
+ * Main
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t cases = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+            cases = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rng_state = (uint32_t)strtoul(argv[++i], NULL, 0) | 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--cases N] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    lv_init();
+#if BLEND_SIMD
+    /* The reference is LVGL's scalar code, not the SSE2 / AVX2 hooks of the host build */
+    blend_simd_set_level(BLEND_SIMD_SCALAR);
+#endif
+
+    printf("%u random cases per kernel\n", (unsigned)cases);
+    printf("%-16s %-9s %10s %16s\n", "Source", "Variant", "RGB565", "RGB565_SWAPPED");
+    for (int src = 0; src < SRC_CNT; src++) {
+        for (int variant = 0; variant < VARIANT_CNT; variant++) {
+            if (src == SRC_COLOR && variant == VARIANT_PLAIN) {
+                continue;   /* Plain fill: scalar */
+            }
+            uint32_t ok[2] = {0, 0};
+            for (int swapped = 0; swapped < 2; swapped++) {
+                for (uint32_t i = 0; i < cases && ok[swapped] == i; i++) {
+                    ok[swapped] += run_case(src, variant, swapped);
+                }
+            }
+            printf("%-16s %-9s %10s %16s\n", src_names[src], variant_names[variant],
+                   ok[0] == cases ? "bit-exact" : "MISMATCH", ok[1] == cases ? "bit-exact" : "MISMATCH");
+        }
+    }
+
+    check_fill_exhaustive(false);
+    check_fill_exhaustive(true);
+
+    lv_deinit();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
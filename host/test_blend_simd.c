@@ -0,0 +1,413 @@
+/**
+ * @file test_blend_simd.c
+ * @brief The SSE2 / AVX2 blend kernels (blend_simd.c) against LVGL's scalar blending
+ *
+ * LVGL is built with the SIMD hooks (lv_conf.h, blend_asm.h), so the same
+ * LVGL blend functions give the scalar result at BLEND_SIMD_SCALAR and the
+ * SIMD result at the other levels. Every kernel runs on random rows of
+ * random widths (whole vectors and tails), heights, strides and alignments,
+ * with plain runs and random pixels, opacities and mask values, on every
+ * level the CPU supports; the whole destination buffer (also around the
+ * blended area) must match the scalar result bit for bit. ARGB8888
+ * destinations are either opaque or random (transparent, semi-transparent
+ * and opaque pixels mixed).
+ *
+ * Then the throughput of every kernel on every level, in Mpx/s, blending
+ * a 320x240 area (opaque destination for ARGB8888).
+ *
+ * Usage: test_blend_simd [--cases N] [--seed N] [--bench-px N]
+ *        (--bench-px 0 skips the benchmark)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565_swapped.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_argb8888.h"
+#include "blend_simd.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define MAX_W       100         /* Several AVX2 vectors and a tail */
+#define MAX_H       4
+#define PAD         8           /* Pixels around the blended area, must stay untouched */
+#define BUF_PX      ((MAX_W + 2 * PAD) * (MAX_H + 2))
+
+#define BENCH_W     320
+#define BENCH_H     240
+
+typedef enum {
+    SRC_COLOR,
+    SRC_RGB565,
+    SRC_RGB565_SWAPPED,
+    SRC_ARGB8888,
+    SRC_CNT,
+} src_t;
+
+static const char *src_names[SRC_CNT] = {"color", "RGB565", "RGB565_SWAPPED", "ARGB8888"};
+
+typedef enum {
+    DEST_RGB565,
+    DEST_RGB565_SWAPPED,
+    DEST_ARGB8888,
+    DEST_CNT,
+} dest_t;
+
+static const char *dest_names[DEST_CNT] = {"RGB565", "RGB565_SWAPPED", "ARGB8888"};
+static const uint32_t dest_px_size[DEST_CNT] = {2, 2, 4};
+
+typedef enum {
+    VARIANT_PLAIN,      /* No mask, opa >= LV_OPA_MAX */
+    VARIANT_OPA,
+    VARIANT_MASK,
+    VARIANT_MASK_OPA,
+    VARIANT_CNT,
+} variant_t;
+
+static const char *variant_names[VARIANT_CNT] = {"plain", "opa", "mask", "mask+opa"};
+
+/* Geometry and content of one case */
+typedef struct {
+    int32_t w;
+    int32_t h;
+    int32_t dest_stride;        /* In pixels */
+    int32_t dest_ofs;           /* Pixel offset of the blended area, changes the alignment */
+    int32_t mask_stride;
+    int32_t mask_ofs;
+    int32_t src_stride;
+    int32_t src_ofs;
+    lv_opa_t opa;
+    lv_color_t color;
+} case_t;
+
+static uint8_t dest_init[BUF_PX * 4];
+static uint8_t dest_ref[BUF_PX * 4];
+static uint8_t dest_simd[BUF_PX * 4];
+static uint8_t mask_buf[BUF_PX + 4];
+static uint8_t src_buf[BUF_PX * 4 + 4] __attribute__((aligned(4)));
+
+static uint32_t rng_state = 1;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint32_t rnd(void) {
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Random bytes with runs: blending code takes shortcuts on repeated and extreme values */
+static void fill_random(uint8_t *buf, size_t len, size_t unit) {
+    size_t i = 0;
+    while (i < len) {
+        size_t run = (1 + rnd() % 9) * unit;
+        uint32_t kind = rnd() % 4;
+        uint8_t v[4];
+        for (size_t k = 0; k < 4; k++) {
+            v[k] = (uint8_t)rnd();
+        }
+        for (size_t j = 0; j < run && i < len; j++, i++) {
+            switch (kind) {
+                case 0: buf[i] = 0x00; break;
+                case 1: buf[i] = 0xFF; break;
+                case 2: buf[i] = v[j % unit]; break;  /* The same value repeated */
+                default: buf[i] = (uint8_t)rnd(); break;
+            }
+        }
+    }
+}
+
+static bool kernel_exists(src_t src, dest_t dest) {
+    if (dest == DEST_ARGB8888) {
+        return src == SRC_COLOR || src == SRC_ARGB8888;
+    }
+    return true;
+}
+
+static void random_case(case_t *c, src_t src, variant_t variant, dest_t dest) {
+    c->w = 1 + rnd() % MAX_W;
+    c->h = 1 + rnd() % MAX_H;
+    c->dest_stride = c->w + rnd() % (2 * PAD);
+    c->dest_ofs = PAD / 2 + rnd() % 2;
+    c->mask_stride = c->w + rnd() % 5;
+    c->mask_ofs = rnd() % 4;
+    c->src_stride = c->w + rnd() % 3;
+    c->src_ofs = rnd() % 2;
+    c->color = lv_color_hex(rnd());
+
+    switch (variant) {
+        case VARIANT_PLAIN:
+        case VARIANT_MASK:
+            c->opa = LV_OPA_MAX + rnd() % (256 - LV_OPA_MAX);
+            break;
+        default:
+            c->opa = rnd() % LV_OPA_MAX;
+            break;
+    }
+
+    fill_random(dest_init, sizeof(dest_init), dest_px_size[dest]);
+    if (dest == DEST_ARGB8888 && rnd() % 2) {
+        /* Opaque destination, the usual case */
+        for (size_t i = 3; i < sizeof(dest_init); i += 4) {
+            dest_init[i] = 0xFF;
+        }
+    }
+    fill_random(mask_buf, sizeof(mask_buf), 1);
+    fill_random(src_buf, sizeof(src_buf), src == SRC_ARGB8888 ? 4 : 2);
+}
+
+/* Blend with LVGL's blend functions, through the hooks of the current level */
+static void blend(const case_t *c, src_t src, variant_t variant, dest_t dest, uint8_t *dest_buf) {
+    bool mask = variant == VARIANT_MASK || variant == VARIANT_MASK_OPA;
+    uint32_t px_size = dest_px_size[dest];
+
+    if (src == SRC_COLOR) {
+        lv_draw_sw_blend_fill_dsc_t dsc = {
+            .dest_buf = dest_buf + c->dest_ofs * px_size,
+            .dest_w = c->w,
+            .dest_h = c->h,
+            .dest_stride = c->dest_stride * px_size,
+            .mask_buf = mask ? mask_buf + c->mask_ofs : NULL,
+            .mask_stride = c->mask_stride,
+            .color = c->color,
+            .opa = c->opa,
+        };
+        switch (dest) {
+            case DEST_RGB565: lv_draw_sw_blend_color_to_rgb565(&dsc); break;
+            case DEST_RGB565_SWAPPED: lv_draw_sw_blend_color_to_rgb565_swapped(&dsc); break;
+            default: lv_draw_sw_blend_color_to_argb8888(&dsc); break;
+        }
+        return;
+    }
+
+    uint32_t src_px_size = src == SRC_ARGB8888 ? 4 : 2;
+    lv_draw_sw_blend_image_dsc_t dsc = {
+        .dest_buf = dest_buf + c->dest_ofs * px_size,
+        .dest_w = c->w,
+        .dest_h = c->h,
+        .dest_stride = c->dest_stride * px_size,
+        .mask_buf = mask ? mask_buf + c->mask_ofs : NULL,
+        .mask_stride = c->mask_stride,
+        .src_buf = src_buf + c->src_ofs * src_px_size,
+        .src_stride = c->src_stride * src_px_size,
+        .opa = c->opa,
+        .blend_mode = LV_BLEND_MODE_NORMAL,
+    };
+    switch (src) {
+        case SRC_RGB565: dsc.src_color_format = LV_COLOR_FORMAT_RGB565; break;
+        case SRC_RGB565_SWAPPED: dsc.src_color_format = LV_COLOR_FORMAT_RGB565_SWAPPED; break;
+        default: dsc.src_color_format = LV_COLOR_FORMAT_ARGB8888; break;
+    }
+    switch (dest) {
+        case DEST_RGB565: lv_draw_sw_blend_image_to_rgb565(&dsc); break;
+        case DEST_RGB565_SWAPPED: lv_draw_sw_blend_image_to_rgb565_swapped(&dsc); break;
+        default: lv_draw_sw_blend_image_to_argb8888(&dsc); break;
+    }
+}
+
+static bool run_case(blend_simd_level_t level, src_t src, variant_t variant, dest_t dest) {
+    case_t c;
+    random_case(&c, src, variant, dest);
+
+    memcpy(dest_ref, dest_init, sizeof(dest_init));
+    blend_simd_set_level(BLEND_SIMD_SCALAR);
+    blend(&c, src, variant, dest, dest_ref);
+
+    memcpy(dest_simd, dest_init, sizeof(dest_init));
+    blend_simd_set_level(level);
+    blend(&c, src, variant, dest, dest_simd);
+
+    uint32_t px_size = dest_px_size[dest];
+    for (uint32_t i = 0; i < BUF_PX; i++) {
+        if (memcmp(dest_ref + i * px_size, dest_simd + i * px_size, px_size) != 0) {
+            uint32_t ref = 0;
+            uint32_t simd = 0;
+            memcpy(&ref, dest_ref + i * px_size, px_size);
+            memcpy(&simd, dest_simd + i * px_size, px_size);
+            printf("FAIL %s: %s %s to %s: w %d h %d dest_ofs %d stride %d mask_ofs %d opa %d, "
+                   "px %u: scalar 0x%08x, SIMD 0x%08x\n",
+                   blend_simd_level_name(level), src_names[src], variant_names[variant], dest_names[dest],
+                   (int)c.w, (int)c.h, (int)c.dest_ofs, (int)c.dest_stride, (int)c.mask_ofs, c.opa,
+                   (unsigned)i, (unsigned)ref, (unsigned)simd);
+            failures++;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_level(blend_simd_level_t level, uint32_t cases) {
+    printf("\n%s: %u random cases per kernel\n", blend_simd_level_name(level), (unsigned)cases);
+    printf("%-16s %-9s %10s %16s %10s\n", "Source", "Variant", "RGB565", "RGB565_SWAPPED", "ARGB8888");
+    for (int src = 0; src < SRC_CNT; src++) {
+        for (int variant = 0; variant < VARIANT_CNT; variant++) {
+            const char *res[DEST_CNT];
+            for (int dest = 0; dest < DEST_CNT; dest++) {
+                if (!kernel_exists(src, dest)) {
+                    res[dest] = "-";
+                    continue;
+                }
+                uint32_t ok = 0;
+                for (uint32_t i = 0; i < cases && ok == i; i++) {
+                    ok += run_case(level, src, variant, dest);
+                }
+                res[dest] = ok == cases ? "bit-exact" : "MISMATCH";
+            }
+            printf("%-16s %-9s %10s %16s %10s\n", src_names[src], variant_names[variant],
+                   res[DEST_RGB565], res[DEST_RGB565_SWAPPED], res[DEST_ARGB8888]);
+        }
+    }
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Mpx/s of one kernel blending a BENCH_W x BENCH_H area */
+static double bench_kernel(src_t src, variant_t variant, dest_t dest, uint32_t bench_px,
+                           uint8_t *dest_buf, uint8_t *src_big, uint8_t *mask_big) {
+    bool mask = variant == VARIANT_MASK || variant == VARIANT_MASK_OPA;
+    lv_opa_t opa = variant == VARIANT_PLAIN || variant == VARIANT_MASK ? LV_OPA_COVER : LV_OPA_50;
+    uint32_t px_size = dest_px_size[dest];
+    uint32_t src_px_size = src == SRC_ARGB8888 ? 4 : 2;
+    uint32_t rounds = bench_px / (BENCH_W * BENCH_H) + 1;
+
+    lv_draw_sw_blend_fill_dsc_t fill = {
+        .dest_buf = dest_buf,
+        .dest_w = BENCH_W,
+        .dest_h = BENCH_H,
+        .dest_stride = BENCH_W * px_size,
+        .mask_buf = mask ? mask_big : NULL,
+        .mask_stride = BENCH_W,
+        .color = lv_color_hex(0x3080C0),
+        .opa = opa,
+    };
+    lv_draw_sw_blend_image_dsc_t image = {
+        .dest_buf = dest_buf,
+        .dest_w = BENCH_W,
+        .dest_h = BENCH_H,
+        .dest_stride = BENCH_W * px_size,
+        .mask_buf = mask ? mask_big : NULL,
+        .mask_stride = BENCH_W,
+        .src_buf = src_big,
+        .src_stride = BENCH_W * src_px_size,
+        .opa = opa,
+        .blend_mode = LV_BLEND_MODE_NORMAL,
+        .src_color_format = src == SRC_RGB565 ? LV_COLOR_FORMAT_RGB565 :
+                            src == SRC_RGB565_SWAPPED ? LV_COLOR_FORMAT_RGB565_SWAPPED : LV_COLOR_FORMAT_ARGB8888,
+    };
+
+    /* Opaque destination: what the renderer blends to */
+    memset(dest_buf, 0xFF, BENCH_W * BENCH_H * px_size);
+
+    double t0 = now_s();
+    for (uint32_t r = 0; r < rounds; r++) {
+        if (src == SRC_COLOR) {
+            switch (dest) {
+                case DEST_RGB565: lv_draw_sw_blend_color_to_rgb565(&fill); break;
+                case DEST_RGB565_SWAPPED: lv_draw_sw_blend_color_to_rgb565_swapped(&fill); break;
+                default: lv_draw_sw_blend_color_to_argb8888(&fill); break;
+            }
+        } else {
+            switch (dest) {
+                case DEST_RGB565: lv_draw_sw_blend_image_to_rgb565(&image); break;
+                case DEST_RGB565_SWAPPED: lv_draw_sw_blend_image_to_rgb565_swapped(&image); break;
+                default: lv_draw_sw_blend_image_to_argb8888(&image); break;
+            }
+        }
+    }
+    double t = now_s() - t0;
+    return (double)rounds * BENCH_W * BENCH_H / t / 1e6;
+}
+
+static void bench(uint32_t bench_px) {
+    static uint8_t dest_buf[BENCH_W * BENCH_H * 4];
+    static uint8_t src_big[BENCH_W * BENCH_H * 4];
+    static uint8_t mask_big[BENCH_W * BENCH_H];
+    blend_simd_level_t max = blend_simd_get_max_level();
+
+    fill_random(src_big, sizeof(src_big), 4);
+    fill_random(mask_big, sizeof(mask_big), 1);
+
+    printf("\nThroughput, Mpx/s (%dx%d, %u px per kernel and level)\n", BENCH_W, BENCH_H, (unsigned)bench_px);
+    printf("%-16s %-9s %-15s", "Source", "Variant", "Destination");
+    for (int l = BLEND_SIMD_SCALAR; l <= (int)max; l++) {
+        printf(" %8s", blend_simd_level_name((blend_simd_level_t)l));
+    }
+    printf(" %8s\n", "speedup");
+
+    for (int dest = 0; dest < DEST_CNT; dest++) {
+        for (int src = 0; src < SRC_CNT; src++) {
+            if (!kernel_exists(src, dest)) {
+                continue;
+            }
+            for (int variant = 0; variant < VARIANT_CNT; variant++) {
+                double mpx[BLEND_SIMD_AVX2 + 1];
+                printf("%-16s %-9s %-15s", src_names[src], variant_names[variant], dest_names[dest]);
+                for (int l = BLEND_SIMD_SCALAR; l <= (int)max; l++) {
+                    blend_simd_set_level((blend_simd_level_t)l);
+                    mpx[l] = bench_kernel(src, variant, dest, bench_px, dest_buf, src_big, mask_big);
+                    printf(" %8.0f", mpx[l]);
+                }
+                printf(" %7.1fx\n", mpx[max] / mpx[BLEND_SIMD_SCALAR]);
+            }
+        }
+    }
+    blend_simd_set_level(max);
+}
+
+/*===========================================
+ * Main
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t cases = 1000;
+    uint32_t bench_px = 20000000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+            cases = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rng_state = (uint32_t)strtoul(argv[++i], NULL, 0) | 1;
+        } else if (strcmp(argv[i], "--bench-px") == 0 && i + 1 < argc) {
+            bench_px = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--cases N] [--seed N] [--bench-px N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    lv_init();
+
+    blend_simd_level_t max = blend_simd_get_max_level();
+    printf("CPU: up to %s\n", blend_simd_level_name(max));
+    for (int l = BLEND_SIMD_SSE2; l <= (int)max; l++) {
+        check_level((blend_simd_level_t)l, cases);
+    }
+
+    if (bench_px) {
+        bench(bench_px);
+    }
+
+    lv_deinit();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file test_dma_chain.c
+ * @brief Timing test of the batched MIPI DBI transfers
+ *
+ * Refreshes the same screen through the ST7796 driver twice over the
+ * simulated bus: with separate blocking command and pixel writes, and with
+ * one batched transfer per strip replayed by lcd_dma_chain_replay.c. Checks
+ * the segments of the batched transfers and that their only bus gaps are the
+ * DC changes, then prints the per-strip gaps of both. Last, a portrait screen
+ * scrolled by the controller checks the strip wrapping around its scrolling
+ * area.
+ *
+ * Usage: test_dma_chain [--baud HZ]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "src/drivers/display/st7796/lv_st7796.h"
+#include "lcd_dma_chain_replay.h"
+#include "spi_sim.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define DISP_HOR_RES    480
+#define DISP_VER_RES    320
+#define DISP_BUF_LINES  40
+#define FRAMES          5
+
+/* Hardware scrolling case: rows scrolled, so the last strip wraps around the scrolling area */
+#define SCROLL_ROWS     25
+
+static uint8_t disp_buf1[DISP_HOR_RES * DISP_BUF_LINES * 2] __attribute__((aligned(4)));
+static uint8_t disp_buf2[DISP_HOR_RES * DISP_BUF_LINES * 2] __attribute__((aligned(4)));
+
+/* Separate writes: start of the current strip's CASET and the totals */
+static uint64_t strip_start_ns;
+static uint64_t strip_wire_ns;
+static uint64_t separate_gap_ns;
+static uint32_t separate_strips;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(now_ns() / 1000000u);
+}
+
+static uint64_t wire_ns(size_t len) {
+    return (uint64_t)len * 8 * 1000000000u / spi_sim_get_baudrate();
+}
+
+/* Blocking write with the CPU toggling DC in between, like pipeline_send_cmd() in main.c */
+static void separate_write(const uint8_t *cmd, size_t cmd_size, size_t param_size) {
+    uint64_t done = spi_sim_start_write(cmd_size);
+    if (cmd[0] == LV_LCD_CMD_SET_COLUMN_ADDRESS) {
+        strip_start_ns = done - wire_ns(cmd_size);
+        strip_wire_ns = 0;
+    }
+    strip_wire_ns += wire_ns(cmd_size);
+    spi_sim_wait(done);
+
+    if (param_size > 0) {
+        spi_sim_write_blocking(param_size);
+        strip_wire_ns += wire_ns(param_size);
+    }
+}
+
+static void separate_send_cmd(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                              const uint8_t *param, size_t param_size) {
+    (void)disp;
+    (void)param;
+    separate_write(cmd, cmd_size, param_size);
+}
+
+static void separate_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                                uint8_t *param, size_t param_size) {
+    (void)param;
+    separate_write(cmd, cmd_size, param_size);
+    separate_gap_ns += now_ns() - strip_start_ns - strip_wire_ns;
+    separate_strips++;
+    lv_display_flush_ready(disp);
+}
+
+static void batched_send_transfer(lv_display_t *disp, const lv_lcd_transfer_t *xfer) {
+    lcd_dma_chain_run(xfer);
+    if (!xfer->flush_continues) {
+        lv_display_flush_ready(disp);
+    }
+}
+
+static lv_display_t *create_display(bool batched) {
+    lv_display_t *disp = lv_st7796_create(DISP_HOR_RES, DISP_VER_RES, LV_LCD_FLAG_BGR,
+                                          separate_send_cmd, separate_send_color);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf1, disp_buf2, sizeof(disp_buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    if (batched) {
+        lv_lcd_generic_mipi_set_send_transfer_cb(disp, batched_send_transfer);
+    }
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x204060), 0);
+    lv_obj_t *label = lv_label_create(scr);
+    lv_label_set_text(label, "DMA chain");
+    lv_obj_center(label);
+    return disp;
+}
+
+static void refresh(lv_display_t *disp) {
+    for (int i = 0; i < FRAMES; i++) {
+        lv_obj_invalidate(lv_display_get_screen_active(disp));
+        lv_refr_now(disp);
+    }
+}
+
+/**
+ * @brief Refresh a portrait screen scrolled with the controller's vertical scrolling
+ *
+ * The strip at the bottom wraps around the end of the scrolling area. Its
+ * second window has to be a transfer of its own: the DC line can't change
+ * after the pixels of the first one.
+ */
+static void check_hw_scroll(void) {
+    lv_display_t *disp = lv_st7796_create(DISP_VER_RES, DISP_HOR_RES, LV_LCD_FLAG_BGR,
+                                          separate_send_cmd, separate_send_color);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf1, disp_buf2, sizeof(disp_buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_lcd_generic_mipi_set_send_transfer_cb(disp, batched_send_transfer);
+    lv_lcd_generic_mipi_set_hw_scroll(disp, DISP_HOR_RES);
+    lv_display_set_scroll_blit(disp, true);
+
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    lv_obj_remove_style_all(scr);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x204060), 0);
+    lv_obj_t *content = lv_obj_create(scr);
+    lv_obj_set_size(content, DISP_VER_RES / 2, DISP_HOR_RES * 2);
+    lv_refr_now(disp);
+
+    lv_obj_scroll_by(scr, 0, -SCROLL_ROWS, LV_ANIM_OFF);
+    lv_refr_now(disp);
+    lv_display_inv_stats_t inv_stats;
+    lv_display_get_inv_stats(disp, &inv_stats);
+    CHECK(inv_stats.blitted == 1);
+
+    lcd_dma_chain_replay_reset();
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+
+    /* Every strip, plus the second window of the one at the bottom */
+    uint32_t strip_lines = sizeof(disp_buf1) / (DISP_VER_RES * 2);
+    lcd_dma_chain_replay_stats_t stats;
+    lcd_dma_chain_replay_get_stats(&stats);
+    CHECK(stats.transfers == (DISP_HOR_RES + strip_lines - 1) / strip_lines + 1);
+
+    /* RASET, RAMWR and the wrapped rows from the top of the scrolling area */
+    lcd_dma_chain_replay_seg_t segs[LV_LCD_TRANSFER_SEG_MAX];
+    uint32_t seg_cnt = lcd_dma_chain_replay_get_last(segs);
+    CHECK(seg_cnt == 4);
+    if (seg_cnt == 4) {
+        CHECK(segs[0].dc == LV_LCD_DC_COMMAND && segs[0].first == LV_LCD_CMD_SET_PAGE_ADDRESS);
+        CHECK(segs[1].dc == LV_LCD_DC_DATA && segs[1].size == 4 && segs[1].first == 0);
+        CHECK(segs[2].dc == LV_LCD_DC_COMMAND && segs[2].first == LV_LCD_CMD_WRITE_MEMORY_START);
+        CHECK(segs[3].dc == LV_LCD_DC_DATA && segs[3].size == DISP_VER_RES * SCROLL_ROWS * 2);
+    }
+
+    lv_display_delete(disp);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t baudrate = SPI_SIM_DEFAULT_BAUDRATE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baudrate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--baud HZ]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    spi_sim_init(baudrate);
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    /* Separate command and pixel writes */
+    lv_display_t *disp = create_display(false);
+    refresh(disp);
+    lv_display_delete(disp);
+
+    /* One batched transfer per strip */
+    lcd_dma_chain_init(NULL, 0, 0);
+    disp = create_display(true);
+    refresh(disp);
+
+    lcd_dma_chain_replay_stats_t stats;
+    lcd_dma_chain_replay_get_stats(&stats);
+    uint32_t strips = FRAMES * ((DISP_VER_RES + DISP_BUF_LINES - 1) / DISP_BUF_LINES);
+    CHECK(stats.transfers == strips);
+    CHECK(stats.dc_switches == 5 * stats.transfers);
+    CHECK(stats.bytes == (uint64_t)FRAMES * (DISP_HOR_RES * DISP_VER_RES * 2 + stats.transfers / FRAMES * 11));
+
+    /* CASET, RASET, RAMWR, pixels: DC low for the commands only, the last strip ends at the bottom */
+    lcd_dma_chain_replay_seg_t segs[LV_LCD_TRANSFER_SEG_MAX];
+    uint32_t seg_cnt = lcd_dma_chain_replay_get_last(segs);
+    CHECK(seg_cnt == 6);
+    if (seg_cnt == 6) {
+        static const uint8_t cmds[3] = {LV_LCD_CMD_SET_COLUMN_ADDRESS, LV_LCD_CMD_SET_PAGE_ADDRESS,
+                                        LV_LCD_CMD_WRITE_MEMORY_START};
+        for (uint32_t i = 0; i < seg_cnt; i++) {
+            CHECK(segs[i].dc == (i % 2 ? LV_LCD_DC_DATA : LV_LCD_DC_COMMAND));
+            if (i % 2 == 0) {
+                CHECK(segs[i].size == 1 && segs[i].first == cmds[i / 2]);
+            }
+            /* The DC line never changes while the previous segment is still on the wire */
+            if (i > 0) {
+                CHECK(segs[i].start_ns >= segs[i - 1].end_ns + LCD_DMA_CHAIN_REPLAY_DC_NS);
+            }
+        }
+        CHECK(segs[5].size == DISP_HOR_RES * DISP_BUF_LINES * 2);
+    }
+
+    /* No gaps besides the DC changes (1 ns rounding per segment) */
+    uint64_t batched_gap_ns = stats.span_ns - stats.wire_ns;
+    uint64_t dc_gap_ns = (uint64_t)stats.dc_switches * LCD_DMA_CHAIN_REPLAY_DC_NS;
+    CHECK(batched_gap_ns >= dc_gap_ns && batched_gap_ns <= dc_gap_ns + 6 * stats.transfers);
+
+    printf("SPI %u MHz, %u strips of %u lines\n", (unsigned)(baudrate / 1000000), (unsigned)strips,
+           (unsigned)DISP_BUF_LINES);
+    printf("Separate writes:   %6.2f us bus gap per strip\n",
+           separate_strips ? (double)separate_gap_ns / separate_strips / 1000.0 : 0.0);
+    printf("Batched transfer:  %6.2f us bus gap per strip\n",
+           stats.transfers ? (double)batched_gap_ns / stats.transfers / 1000.0 : 0.0);
+
+    lv_display_delete(disp);
+
+    check_hw_scroll();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
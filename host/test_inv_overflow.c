@@ -0,0 +1,268 @@
+/**
+ * @file test_inv_overflow.c
+ * @brief Rendered pixels of many independently animated labels
+ *
+ * Hundreds of digit labels on the 480 x 320 display of main.c, each counting
+ * with its own period, invalidate more areas per refresh than the initial
+ * invalidation buffer holds. The test runs the same frames twice:
+ *
+ *   - with the buffer of lv_inv_area(): grows up to LV_INV_BUF_MAX areas and
+ *     coalesces them on a tile grid when even that is full
+ *   - with the rule of LVGL 9.4, emulated with an LV_EVENT_INVALIDATE_AREA
+ *     handler: when LV_INV_BUF_SIZE areas are saved the next one becomes the
+ *     whole screen
+ *
+ * and compares the pixels they render with the union of the invalidated
+ * areas, the least any strategy has to render.
+ *
+ * Usage: test_inv_overflow
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same geometry and buffer as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+
+#define FRAME_MS            16
+#define FRAME_CNT           150
+#define LABEL_CNT_MAX       300     /* As many as fit into LV_MEM_SIZE */
+#define LABEL_PERIOD_MIN    FRAME_MS
+
+/**
+ * @brief A counting label
+ */
+typedef struct {
+    lv_obj_t *label;
+    uint32_t period;        /* ms per digit */
+    uint32_t phase;
+} counter_t;
+
+static uint8_t disp_buf[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief Totals of one run
+ */
+typedef struct {
+    uint64_t px;            /* Pixels rendered */
+    uint64_t union_px;      /* Pixels invalidated, the lower bound */
+    uint32_t full_frames;   /* Refreshes of the whole screen */
+    lv_display_inv_stats_t stats;
+} result_t;
+
+static uint32_t tick_ms;
+static bool emulate_fallback;
+static bool refreshing;
+static result_t *result;
+static uint64_t frame_px;
+static counter_t counters[LABEL_CNT_MAX];
+
+/* Pixels invalidated since the last refresh */
+static uint8_t inv_map[DISP_VER_RES][DISP_HOR_RES];
+
+/*===========================================
+ * Display
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return tick_ms;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)px_map;
+    frame_px += lv_area_get_size(area);
+    lv_display_flush_ready(disp);
+}
+
+static uint32_t count_inv_map(void) {
+    uint32_t cnt = 0;
+    for (uint32_t y = 0; y < DISP_VER_RES; y++) {
+        for (uint32_t x = 0; x < DISP_HOR_RES; x++) {
+            cnt += inv_map[y][x];
+        }
+    }
+    return cnt;
+}
+
+static void disp_event_cb(lv_event_t *e) {
+    lv_display_t *disp = lv_event_get_target(e);
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_REFR_START) {
+        refreshing = true;
+        frame_px = 0;
+    } else if (code == LV_EVENT_REFR_READY) {
+        refreshing = false;
+        if (frame_px == 0) {
+            return;
+        }
+        result->px += frame_px;
+        result->union_px += count_inv_map();
+        result->full_frames += frame_px >= (uint64_t)DISP_HOR_RES * DISP_VER_RES;
+        memset(inv_map, 0, sizeof(inv_map));
+    } else if (code == LV_EVENT_INVALIDATE_AREA && !refreshing) {
+        /* Also sent during the refresh to round the strips, those aren't invalidated areas */
+        lv_area_t *area = lv_event_get_param(e);
+        for (int32_t y = area->y1; y <= area->y2; y++) {
+            memset(&inv_map[y][area->x1], 1, lv_area_get_width(area));
+        }
+
+        if (emulate_fallback && disp->inv_p >= LV_INV_BUF_SIZE) {
+            for (uint32_t i = 0; i < disp->inv_p; i++) {
+                if (lv_area_is_in(area, &disp->inv_areas[i], 0)) {
+                    return;
+                }
+            }
+            lv_area_set(area, 0, 0, DISP_HOR_RES - 1, DISP_VER_RES - 1);
+        }
+    }
+}
+
+/*===========================================
+ * Labels
+ *===========================================*/
+
+static void create_labels(lv_obj_t *scr, uint32_t cnt, uint32_t period_max) {
+    /* A grid of cells just large enough for a digit, filled row by row */
+    const int32_t cell_w = 16;
+    const int32_t cell_h = 20;
+    const uint32_t cols = DISP_HOR_RES / cell_w;
+
+    for (uint32_t i = 0; i < cnt; i++) {
+        counter_t *c = &counters[i];
+        c->label = lv_label_create(scr);
+        lv_label_set_text(c->label, "0");
+        lv_obj_set_pos(c->label, (int32_t)(i % cols) * cell_w + 3, (int32_t)(i / cols) * cell_h + 2);
+        c->period = lv_rand(LABEL_PERIOD_MIN, period_max);
+        c->phase = lv_rand(0, c->period * 10);
+    }
+}
+
+/**
+ * @brief Step every label to its digit at the current time
+ *
+ * Each label has its own period and phase, like an animation per label, but
+ * without the memory of hundreds of lv_anim_t in LV_MEM_SIZE.
+ */
+static void step_labels(uint32_t cnt) {
+    for (uint32_t i = 0; i < cnt; i++) {
+        counter_t *c = &counters[i];
+        char digit = (char)('0' + (tick_ms + c->phase) / c->period % 10);
+        /* Invalidate only when the digit changes */
+        if (lv_label_get_text(c->label)[0] != digit) {
+            char text[2] = {digit, '\0'};
+            lv_label_set_text(c->label, text);
+        }
+    }
+}
+
+/*===========================================
+ * Runs
+ *===========================================*/
+
+static void run(uint32_t label_cnt, uint32_t period_max, bool fallback, result_t *res) {
+    memset(res, 0, sizeof(*res));
+    result = res;
+    emulate_fallback = fallback;
+    lv_rand_set_seed(label_cnt);
+    tick_ms = 0;
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_ALL, NULL);
+
+    create_labels(lv_display_get_screen_active(disp), label_cnt, period_max);
+    step_labels(label_cnt);
+    lv_refr_now(disp);
+
+    /* Count from the first change on */
+    memset(res, 0, sizeof(*res));
+    lv_display_reset_inv_stats(disp);
+    for (uint32_t i = 0; i < FRAME_CNT; i++) {
+        tick_ms += FRAME_MS;
+        step_labels(label_cnt);
+        lv_refr_now(disp);
+    }
+    lv_display_get_inv_stats(disp, &res->stats);
+
+    lv_display_delete(disp);
+}
+
+static void print_result(uint32_t label_cnt, uint32_t period_max, const char *name, const result_t *res) {
+    printf("%6u %3u-%-3u  %-12s %9.2f %9.2f %6.2f %6u %9u %3u/%u\n", (unsigned)label_cnt,
+           LABEL_PERIOD_MIN, (unsigned)period_max, name,
+           res->px / 1e6, res->union_px / 1e6, (double)res->px / res->union_px,
+           (unsigned)res->full_frames, (unsigned)res->stats.overflows,
+           (unsigned)res->stats.peak, (unsigned)res->stats.capacity);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(void) {
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    printf("%u frames of %u ms, every label counts with its own period\n", FRAME_CNT, FRAME_MS);
+    printf("%6s %7s  %-12s %9s %9s %6s %6s %9s %7s\n", "Labels", "Period", "Buffer", "Rendered", "Union",
+           "Ratio", "Full", "Overflows", "Peak");
+    printf("%6s %7s  %-12s %9s %9s %6s %6s %9s %7s\n", "", "ms", "", "Mpx", "Mpx", "", "frames", "", "");
+
+    /* A few labels, more than LV_INV_BUF_SIZE changing per frame, more than LV_INV_BUF_MAX */
+    static const struct {
+        uint32_t label_cnt;
+        uint32_t period_max;
+    } cases[] = {
+        {16, 1000},
+        {300, 100},
+        {300, 20},
+    };
+    uint32_t coalesce_overflows = 0;
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t cnt = cases[i].label_cnt;
+        uint32_t period_max = cases[i].period_max;
+        result_t fallback, coalesce;
+        run(cnt, period_max, true, &fallback);
+        run(cnt, period_max, false, &coalesce);
+        print_result(cnt, period_max, "full screen", &fallback);
+        print_result(cnt, period_max, "coalescing", &coalesce);
+
+        /* The same frames were invalidated, and every invalidated pixel was rendered */
+        CHECK(coalesce.union_px == fallback.union_px);
+        CHECK(coalesce.px >= coalesce.union_px);
+        CHECK(coalesce.px <= fallback.px);
+        CHECK(coalesce.full_frames == 0);
+        if (coalesce.stats.peak <= LV_INV_BUF_SIZE) {
+            CHECK(coalesce.px == fallback.px);
+        } else if (coalesce.stats.overflows == 0) {
+            /* Just a larger buffer */
+            CHECK(fallback.full_frames > 0);
+            CHECK(coalesce.px < fallback.px / 2);
+        } else {
+            /* Coalesced on tiles, still well below the whole screen */
+            CHECK(coalesce.px < fallback.px * 3 / 4);
+        }
+        coalesce_overflows += coalesce.stats.overflows;
+    }
+    CHECK(coalesce_overflows > 0);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,348 @@
+/**
+ * @file test_tear_sync.c
+ * @brief Tearing effect synchronization against a simulated panel scan
+ *
+ * Animates a full-screen redraw on the ST7796 driver with batched transfers
+ * and runs the flush side on a virtual timeline: strips become ready at the
+ * render speed of the Pico, each transfer occupies the 75 MHz bus for its
+ * bytes, and a simulated TE output pulses at the start of every vertical
+ * blanking of a 61 Hz panel. Before each transfer the driver is asked for
+ * its delay, as core 1 of lcd_pipeline.c does.
+ *
+ * A beam model independent of the driver checks every transfer line by line:
+ * a write is tear-prone if a refresh reads some of its lines old and others
+ * new, or one of them half written. Reports the frame latency and the
+ * tear-prone writes without synchronization, with it, and with it enabled
+ * but no TE pulses (pin not wired), in portrait (the strips run along the
+ * scan lines) and in the landscape mode of main.c (every strip crosses all
+ * scan lines).
+ *
+ * Usage: test_tear_sync [--frames N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "src/drivers/display/st7796/lv_st7796.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Native ST7796 panel: 320 x 480, scanned along the 480 rows */
+#define PANEL_W             320
+#define PANEL_H             480
+#define PANEL_VBLANK_LINES  4
+#define PANEL_PERIOD_NS     16393443    /* 61 Hz, off the nominal 60 Hz on purpose */
+#define PANEL_TE_PHASE_NS   5200000     /* First TE pulse */
+
+#define BUS_HZ              (75 * 1000 * 1000)
+#define STRIP_LINES         40
+#define RING_STRIPS         6
+#define RENDER_NS_PER_LINE  40000       /* About what core 0 needs for the benchmark's widgets */
+
+static uint8_t disp_ring[RING_STRIPS][PANEL_H * STRIP_LINES * 2] __attribute__((aligned(4)));
+
+/**
+ * @brief One scenario
+ */
+typedef struct {
+    const char *name;
+    bool landscape;         /* Address mode of main.c: swapped axes, every strip crosses all scan lines */
+    bool tear_sync;         /* Ask the driver for a delay */
+    bool te_wired;          /* The TE pulses reach the driver */
+} scenario_t;
+
+/**
+ * @brief Measurements of one scenario
+ */
+typedef struct {
+    uint32_t frames;
+    uint64_t latency_sum_ns;
+    uint64_t latency_max_ns;
+    uint32_t writes;
+    uint32_t tear_prone;    /* Found by the beam model */
+    lv_lcd_tear_sync_stats_t sync;
+    uint32_t period_us;     /* Period measured by the driver */
+} result_t;
+
+/* Virtual timeline */
+static uint64_t sim_ns;             /* Render side (core 0) */
+static uint64_t bus_free_ns;        /* Flush side (core 1 and the bus) */
+static uint64_t next_te_ns;
+static uint64_t strip_done_ns[RING_STRIPS];
+static uint32_t strip_cnt;
+
+static const scenario_t *cur;
+static result_t *res;
+static lv_display_t *sim_disp;
+
+/*===========================================
+ * Panel Model
+ *===========================================*/
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(sim_ns / 1000000);
+}
+
+static void delay_cb(uint32_t ms) {
+    sim_ns += (uint64_t)ms * 1000000;
+}
+
+/**
+ * @brief Report the TE pulses up to a point in time
+ */
+static void te_until(uint64_t t_ns) {
+    while (next_te_ns <= t_ns) {
+        if (cur->te_wired) {
+            lv_lcd_generic_mipi_tear_pulse(sim_disp, (uint32_t)(next_te_ns / 1000));
+        }
+        next_te_ns += PANEL_PERIOD_NS;
+    }
+}
+
+/**
+ * @brief Time a scan line is read by the beam in the refresh following a TE pulse
+ */
+static uint64_t line_read_ns(uint64_t te_ns, uint32_t line) {
+    return te_ns + (uint64_t)(PANEL_VBLANK_LINES + line) * PANEL_PERIOD_NS / (PANEL_H + PANEL_VBLANK_LINES);
+}
+
+/**
+ * @brief Check a write line by line against every refresh that overlaps it
+ *
+ * @param first First scan line of the window
+ * @param last Last scan line of the window
+ * @param progressive The lines are written one after the other, otherwise all of them all along
+ */
+static bool beam_tears(uint32_t first, uint32_t last, bool progressive, uint64_t start_ns, uint64_t end_ns) {
+    uint32_t cnt = last - first + 1;
+    uint64_t te0 = PANEL_TE_PHASE_NS;
+
+    /* Refreshes that read the window between start - period and end */
+    uint64_t k = start_ns > te0 + 2 * (uint64_t)PANEL_PERIOD_NS ? (start_ns - te0) / PANEL_PERIOD_NS - 2 : 0;
+    for (uint64_t te = te0 + k * PANEL_PERIOD_NS; te <= end_ns; te += PANEL_PERIOD_NS) {
+        bool seen_old = false;
+        bool seen_new = false;
+        for (uint32_t i = 0; i < cnt; i++) {
+            uint64_t ws = progressive ? start_ns + (end_ns - start_ns) * i / cnt : start_ns;
+            uint64_t we = progressive ? start_ns + (end_ns - start_ns) * (i + 1) / cnt : end_ns;
+            uint64_t t = line_read_ns(te, first + i);
+            if (t < ws) {
+                seen_old = true;
+            } else if (t >= we) {
+                seen_new = true;
+            } else {
+                return true;
+            }
+        }
+        if (seen_old && seen_new) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*===========================================
+ * Display Callbacks
+ *===========================================*/
+
+static void send_cmd(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size, const uint8_t *param,
+                     size_t param_size) {
+    (void)disp;
+    (void)cmd;
+    (void)cmd_size;
+    (void)param;
+    (void)param_size;
+}
+
+static void send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size, uint8_t *param, size_t param_size) {
+    (void)cmd;
+    (void)cmd_size;
+    (void)param;
+    (void)param_size;
+    lv_display_flush_ready(disp);
+}
+
+/**
+ * @brief The flush side on the virtual timeline: wait for the strip and the bus, then for the scheduler
+ */
+static void send_transfer(lv_display_t *disp, const lv_lcd_transfer_t *xfer) {
+    uint32_t cmd_bytes = 0;
+    uint32_t px_bytes = 0;
+    for (uint32_t i = 0; i < xfer->seg_cnt; i++) {
+        if (xfer->seg[i].data) {
+            px_bytes += xfer->seg[i].size;
+        } else {
+            cmd_bytes += xfer->seg[i].size;
+        }
+    }
+    const uint8_t *caset = lv_lcd_transfer_seg_get_data(&xfer->seg[1]);
+    const uint8_t *raset = lv_lcd_transfer_seg_get_data(&xfer->seg[3]);
+    uint32_t cols = ((caset[2] << 8) | caset[3]) - ((caset[0] << 8) | caset[1]) + 1;
+
+    /* Core 0 rendered the strip, after a slot of the ring was free again */
+    uint64_t slot_free = strip_done_ns[strip_cnt % RING_STRIPS];
+    sim_ns = LV_MAX(sim_ns, slot_free) + (uint64_t)RENDER_NS_PER_LINE * (px_bytes / 2 / cols);
+
+    uint64_t start = LV_MAX(sim_ns, bus_free_ns);
+    te_until(start);
+    if (cur->tear_sync) {
+        start += (uint64_t)lv_lcd_generic_mipi_get_tear_delay(disp, xfer, (uint32_t)(start / 1000)) * 1000;
+    }
+    uint64_t px_start = start + (uint64_t)cmd_bytes * 8 * 1000000000 / BUS_HZ;
+    uint64_t end = px_start + (uint64_t)px_bytes * 8 * 1000000000 / BUS_HZ;
+
+    /* The scan lines from the window itself, not from the driver's prediction */
+    uint32_t first;
+    uint32_t last;
+    if (cur->landscape) {
+        first = (caset[0] << 8) | caset[1];
+        last = (caset[2] << 8) | caset[3];
+    } else {
+        first = (raset[0] << 8) | raset[1];
+        last = (raset[2] << 8) | raset[3];
+    }
+    if (beam_tears(first, last, !cur->landscape, px_start, end)) {
+        res->tear_prone++;
+    }
+    res->writes++;
+
+    bus_free_ns = end;
+    strip_done_ns[strip_cnt % RING_STRIPS] = end;
+    strip_cnt++;
+    lv_display_flush_ready(disp);
+}
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static void run(const scenario_t *scenario, uint32_t frames, result_t *result) {
+    cur = scenario;
+    res = result;
+    memset(result, 0, sizeof(*result));
+    sim_ns = 0;
+    bus_free_ns = 0;
+    next_te_ns = PANEL_TE_PHASE_NS;
+    memset(strip_done_ns, 0, sizeof(strip_done_ns));
+    strip_cnt = 0;
+
+    uint32_t hor_res = scenario->landscape ? PANEL_H : PANEL_W;
+    uint32_t ver_res = scenario->landscape ? PANEL_W : PANEL_H;
+    sim_disp = lv_st7796_create(hor_res, ver_res, LV_LCD_FLAG_BGR, send_cmd, send_color);
+    lv_lcd_generic_mipi_set_send_transfer_cb(sim_disp, send_transfer);
+    if (scenario->landscape) {
+        lv_lcd_generic_mipi_set_address_mode(sim_disp, false, true, true, true);
+    }
+    lv_display_set_color_format(sim_disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffer_ring(sim_disp, disp_ring, hor_res * STRIP_LINES * 2, RING_STRIPS);
+    if (scenario->tear_sync) {
+        lv_lcd_tear_sync_config_t config = {
+            .scan_lines = PANEL_H,
+            .vblank_lines = PANEL_VBLANK_LINES,
+            .bus_hz = BUS_HZ,
+        };
+        lv_lcd_generic_mipi_set_tear_sync(sim_disp, &config);
+    }
+    lv_sysmon_hide_performance(sim_disp);
+
+    lv_obj_t *scr = lv_display_get_screen_active(sim_disp);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x203040), 0);
+    lv_obj_t *bar = lv_obj_create(scr);
+    lv_obj_set_size(bar, 40, ver_res);
+
+    /* Settle the period measurement before measuring */
+    sim_ns = 4 * (uint64_t)PANEL_PERIOD_NS;
+    te_until(sim_ns);
+
+    for (uint32_t i = 0; i < frames; i++) {
+        lv_obj_set_x(bar, (int32_t)(i * 8 % (hor_res - 40)));
+        lv_obj_invalidate(scr);
+
+        /* The frame starts when core 0 is done with the previous one */
+        uint64_t frame_start = sim_ns;
+        lv_refr_now(sim_disp);
+        uint64_t latency = bus_free_ns - frame_start;
+        result->latency_sum_ns += latency;
+        result->latency_max_ns = LV_MAX(result->latency_max_ns, latency);
+        result->frames++;
+    }
+
+    lv_lcd_generic_mipi_get_tear_sync_stats(sim_disp, &result->sync);
+    result->period_us = ((lv_lcd_generic_mipi_driver_t *)lv_display_get_driver_data(sim_disp))->tear_period_us;
+    lv_display_delete(sim_disp);
+}
+
+static void print_result(const scenario_t *scenario, const result_t *result) {
+    printf("%-28s %8.2f %8.2f %6u/%-5u %7u %8u\n", scenario->name,
+           result->latency_sum_ns / 1e6 / (result->frames ? result->frames : 1), result->latency_max_ns / 1e6,
+           (unsigned)result->tear_prone, (unsigned)result->writes, (unsigned)result->sync.delayed,
+           (unsigned)(result->sync.delay_us / 1000));
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t frames = 60;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_delay_set_cb(delay_cb);
+
+    static const scenario_t scenarios[] = {
+        {"portrait, no sync", false, false, false},
+        {"portrait, TE sync", false, true, true},
+        {"portrait, TE not wired", false, true, false},
+        {"landscape, no sync", true, false, false},
+        {"landscape, TE sync", true, true, true},
+    };
+    enum { PORTRAIT_OFF, PORTRAIT_SYNC, PORTRAIT_NO_TE, LANDSCAPE_OFF, LANDSCAPE_SYNC, SCENARIO_CNT };
+    result_t results[SCENARIO_CNT];
+
+    printf("%u frames, panel %.1f Hz, SPI %u MHz, %u line strips\n", (unsigned)frames,
+           1e9 / PANEL_PERIOD_NS, (unsigned)(BUS_HZ / 1000000), STRIP_LINES);
+    printf("%-28s %8s %8s %12s %7s %8s\n", "Scenario", "Latency", "Max", "Tear-prone", "Delayed", "Delay");
+    printf("%-28s %8s %8s %12s %7s %8s\n", "", "ms", "ms", "writes", "writes", "ms");
+    for (int i = 0; i < SCENARIO_CNT; i++) {
+        run(&scenarios[i], frames, &results[i]);
+        print_result(&scenarios[i], &results[i]);
+    }
+
+    /* The strips run along the scan lines: every write can stay clear of the beam */
+    CHECK(results[PORTRAIT_OFF].tear_prone > 0);
+    CHECK(results[PORTRAIT_SYNC].tear_prone == 0);
+    CHECK(results[PORTRAIT_SYNC].sync.tear_prone == 0);
+    CHECK(results[PORTRAIT_SYNC].sync.delayed > 0);
+    CHECK(LV_ABS((int32_t)results[PORTRAIT_SYNC].period_us - PANEL_PERIOD_NS / 1000) <= 2);
+
+    /* Without pulses nothing changes */
+    CHECK(results[PORTRAIT_NO_TE].sync.unsynced == results[PORTRAIT_NO_TE].writes);
+    CHECK(results[PORTRAIT_NO_TE].tear_prone == results[PORTRAIT_OFF].tear_prone);
+    CHECK(results[PORTRAIT_NO_TE].latency_sum_ns == results[PORTRAIT_OFF].latency_sum_ns);
+
+    /* Every strip crosses all scan lines and takes longer than the blanking: nothing to gain, nothing to wait for */
+    CHECK(results[LANDSCAPE_SYNC].sync.tear_prone == results[LANDSCAPE_SYNC].writes);
+    CHECK(results[LANDSCAPE_SYNC].sync.delayed == 0);
+    CHECK(results[LANDSCAPE_SYNC].latency_sum_ns == results[LANDSCAPE_OFF].latency_sum_ns);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file test_touch_gesture.c
+ * @brief Two-finger gestures from a recorded FT6336U trace
+ *
+ * Replays a two-finger trace on the simulated FT6336U through the same path
+ * as main.c: INT interrupt, I2C read, touch ring, event-driven input device
+ * and LVGL's pinch/rotate recognizers. A pinch out scales a scrollable
+ * container, a rotation and a pinch in transform an image (touch_gesture.c).
+ * Checks the final transforms, and that after the first gesture, which lets
+ * LVGL create the recognizer state, lv_indev_read() allocates nothing.
+ *
+ * Usage: test_touch_gesture <trace>
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lvgl.h"
+#include "hardware/gpio.h"
+#include "hal_sim.h"
+#include "ft6336u.h"
+#include "touch_ring.h"
+#include "touch_gesture.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Same panel setup as main.c */
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define PIN_TOUCH_INT       5
+
+/* End of the pinch out in host/traces/pinch_rotate.txt: the warm-up gesture */
+#define WARMUP_END_MS       650
+/* Last sample of the trace, plus some margin */
+#define TRACE_END_MS        1700
+
+#define IMG_SIZE            64
+
+static uint8_t disp_buf[DISP_HOR_RES * 40 * 2];
+static uint16_t img_px[IMG_SIZE * IMG_SIZE];
+
+static uint32_t gesture_events[LV_INDEV_GESTURE_CNT];
+
+/* INT edges seen by the interrupt */
+static atomic_uint int_edges;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(now_ns() / 1000000u);
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+static void touch_int_callback(uint gpio, uint32_t events) {
+    (void)events;
+    if (gpio == PIN_TOUCH_INT) {
+        atomic_fetch_add(&int_edges, 1);
+        touch_ring_irq_handler();
+    }
+}
+
+static void count_gesture_cb(lv_event_t *e) {
+    lv_indev_gesture_type_t type = lv_event_get_gesture_type(e);
+    if (type < LV_INDEV_GESTURE_CNT) {
+        gesture_events[type]++;
+    }
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <trace>\n", argv[0]);
+        return 1;
+    }
+    if (!sim_touch_load_trace(argv[1])) {
+        fprintf(stderr, "Can't load %s\n", argv[1]);
+        return 1;
+    }
+
+    uint64_t boot_ns = now_ns();
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+
+    /* Left half: a scrollable container */
+    lv_obj_t *scr = lv_display_get_screen_active(disp);
+    lv_obj_t *cont = lv_obj_create(scr);
+    lv_obj_set_size(cont, 220, 300);
+    lv_obj_align(cont, LV_ALIGN_LEFT_MID, 10, 0);
+    lv_obj_t *content = lv_obj_create(cont);
+    lv_obj_set_size(content, 180, 600);
+    /* The pinch lands on the child, LV_EVENT_GESTURE only bubbles with this flag */
+    lv_obj_add_flag(content, LV_OBJ_FLAG_EVENT_BUBBLE);
+    touch_gesture_add_zoom(cont, false);
+
+    /* Right half: an image */
+    for (uint32_t i = 0; i < IMG_SIZE * IMG_SIZE; i++) {
+        img_px[i] = (uint16_t)(i * 37);
+    }
+    static lv_image_dsc_t img_dsc;
+    img_dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    img_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+    img_dsc.header.w = IMG_SIZE;
+    img_dsc.header.h = IMG_SIZE;
+    img_dsc.header.stride = IMG_SIZE * 2;
+    img_dsc.data = (const uint8_t *)img_px;
+    img_dsc.data_size = sizeof(img_px);
+    lv_obj_t *img = lv_image_create(scr);
+    lv_image_set_src(img, &img_dsc);
+    lv_image_set_inner_align(img, LV_IMAGE_ALIGN_CENTER);
+    lv_obj_set_size(img, 200, 200);
+    lv_obj_align(img, LV_ALIGN_CENTER, 120, 0);
+    touch_gesture_add_zoom(img, true);
+
+    lv_obj_add_event_cb(cont, count_gesture_cb, LV_EVENT_GESTURE, NULL);
+    lv_obj_add_event_cb(img, count_gesture_cb, LV_EVENT_GESTURE, NULL);
+
+    /* The touch path of main.c */
+    i2c_init(i2c1, 400 * 1000);
+    static ft6336u_t touch_dev;
+    ft6336u_config_t config = {
+        .i2c = i2c1,
+        .max_x = DISP_HOR_RES,
+        .max_y = DISP_VER_RES,
+        .swap_xy = true,
+        .invert_x = true,
+    };
+    CHECK(ft6336u_init(&touch_dev, &config));
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(indev, disp);
+    lv_indev_set_read_cb(indev, touch_ring_read_cb);
+    lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);
+    gpio_set_irq_enabled_with_callback(PIN_TOUCH_INT, GPIO_IRQ_EDGE_FALL, true, touch_int_callback);
+    CHECK(touch_ring_init(&touch_dev));
+
+    /* Main loop of main.c, counting the reads that leave more blocks allocated */
+    uint32_t allocating_reads = 0;
+    uint32_t reads = 0;
+    while (true) {
+        touch_ring_service();
+        uint32_t time_ms = (uint32_t)((now_ns() - boot_ns) / 1000000u);
+        if (time_ms > TRACE_END_MS && !touch_ring_pending()) {
+            break;
+        }
+
+        for (int i = 0; i < TOUCH_RING_LEN && touch_ring_pending(); i++) {
+            lv_mem_monitor_t before, after;
+            lv_mem_monitor(&before);
+            lv_indev_read(indev);
+            lv_mem_monitor(&after);
+            if (time_ms > WARMUP_END_MS) {
+                reads++;
+                if (after.used_cnt > before.used_cnt) {
+                    allocating_reads++;
+                }
+            }
+        }
+        lv_timer_handler();
+
+        struct timespec ts = {.tv_nsec = 5 * 1000000};
+        nanosleep(&ts, NULL);
+    }
+
+    touch_ring_stats_t stats;
+    touch_ring_get_stats(&stats);
+
+    int32_t cont_scale = lv_obj_get_style_transform_scale_x(cont, LV_PART_MAIN);
+    int32_t img_scale = lv_image_get_scale(img);
+    int32_t img_rotation = lv_image_get_rotation(img);
+
+    printf("Samples: %u delivered, %u dropped\n", (unsigned)stats.delivered, (unsigned)stats.dropped);
+    printf("Gesture events: pinch %u, rotate %u, two-finger swipe %u\n",
+           (unsigned)gesture_events[LV_INDEV_GESTURE_PINCH], (unsigned)gesture_events[LV_INDEV_GESTURE_ROTATE],
+           (unsigned)gesture_events[LV_INDEV_GESTURE_TWO_FINGERS_SWIPE]);
+    printf("Container scale %d, image scale %d, image rotation %d.%d deg\n",
+           (int)cont_scale, (int)img_scale, (int)(img_rotation / 10), (int)LV_ABS(img_rotation % 10));
+    printf("Reads after warm-up: %u, allocating: %u\n", (unsigned)reads, (unsigned)allocating_reads);
+
+    /* Every report was read, or merged into a later read while the main loop was busy */
+    CHECK(stats.pushed + stats.dropped == atomic_load(&int_edges));
+    CHECK(stats.delivered == stats.pushed && stats.delivered > 80);
+    CHECK(gesture_events[LV_INDEV_GESTURE_PINCH] > 0);
+    CHECK(gesture_events[LV_INDEV_GESTURE_ROTATE] > 0);
+
+    /* Pinch out from 60 to 200 px: about 3.3x */
+    CHECK(cont_scale > 256 * 5 / 2 && cont_scale < 256 * 4);
+    /* 45 degrees, the recognizer starts counting after 0.2 rad (11.5 degrees) */
+    CHECK(LV_ABS(img_rotation) > 300 && LV_ABS(img_rotation) < 500);
+    /* Pinch in from 160 to 80 px: about 0.5x */
+    CHECK(img_scale > 256 * 2 / 5 && img_scale < 256 * 3 / 5);
+
+    CHECK(reads > 50);
+    CHECK(allocating_reads == 0);
+    CHECK(lv_indev_get_state(indev) == LV_INDEV_STATE_RELEASED);
+
+    lv_display_delete(disp);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
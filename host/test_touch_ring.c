@@ -0,0 +1,306 @@
+/**
+ * @file test_touch_ring.c
+ * @brief Latency and overflow test of the interrupt-driven touch sampling
+ *
+ * The simulated FT6336U replays a synthetic trace (a tap and a swipe, one
+ * report every 10 ms) and pulses INT at its own pace, the GPIO interrupt calls
+ * touch_ring_irq_handler(). The main thread runs the main loop of main.c:
+ * touch_ring_service(), drain the ring with lv_indev_read(), then
+ * lv_timer_handler() and a simulated frame. Checks that every report reaches
+ * LVGL in order within a frame or is counted as dropped, then stalls the
+ * main loop over several INT edges and checks that all but one are counted
+ * as dropped.
+ *
+ * Usage: test_touch_ring [--frame-us N]
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "lvgl.h"
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hal_sim.h"
+#include "touch_ring.h"
+#include "check.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+#define DISP_HOR_RES        480
+#define DISP_VER_RES        320
+#define PIN_TOUCH_INT       5
+#define REPORT_MS           10      /* FT6336U report period while touched */
+#define TAP_SAMPLES         5
+#define SWIPE_SAMPLES       40
+#define TRACE_MAX           (TAP_SAMPLES + SWIPE_SAMPLES + 2)
+#define TRACE_START_MS      50      /* First report after the start of the test */
+#define STALL_EDGES         10      /* INT edges while the main loop stalls */
+
+/* Allowed INT to lv_indev_read() time on top of one frame: the I2C read in touch_ring_service()
+ * and thread wake-up jitter */
+#define LATENCY_SLACK_US    15000
+
+/* Longest wait for the simulated controller's INT thread, which runs late on a busy host */
+#define TRACE_TIMEOUT_MS    2000
+
+static uint8_t disp_buf[DISP_HOR_RES * 40 * 2];
+
+typedef struct {
+    uint32_t time_ms;
+    ft6336u_touch_data_t data;
+} trace_sample_t;
+
+static trace_sample_t trace[TRACE_MAX];
+static uint32_t trace_len;
+
+/* Last trace sample delivered, the next one can only be the same or a later one */
+static uint32_t expected;
+static uint32_t out_of_order;
+
+static uint32_t clicks;
+
+/* INT edges seen by the interrupt */
+static atomic_uint int_edges;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(now_ns() / 1000000u);
+}
+
+static void sleep_until_ns(uint64_t t) {
+    struct timespec ts = {.tv_sec = (time_t)(t / 1000000000u), .tv_nsec = (long)(t % 1000000000u)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        /* Interrupted, sleep for the rest */
+    }
+}
+
+static void touch_int_callback(uint gpio, uint32_t events) {
+    (void)events;
+    if (gpio == PIN_TOUCH_INT) {
+        atomic_fetch_add(&int_edges, 1);
+        touch_ring_irq_handler();
+    }
+}
+
+static void trace_add(uint32_t time_ms, uint8_t count, uint16_t x, uint16_t y) {
+    trace_sample_t *s = &trace[trace_len++];
+    s->time_ms = time_ms;
+    s->data = (ft6336u_touch_data_t){0};
+    s->data.touch_count = count;
+    if (count > 0) {
+        s->data.points[0] = (ft6336u_touch_point_t){.x = x, .y = y, .valid = true};
+    }
+}
+
+/**
+ * @brief Tap on the button, then swipe across the screen, starting at `start_ms` since boot
+ */
+static void trace_build(uint32_t start_ms) {
+    trace_len = 0;
+    uint32_t t = start_ms;
+    for (uint32_t i = 0; i < TAP_SAMPLES; i++, t += REPORT_MS) {
+        trace_add(t, 1, DISP_HOR_RES / 2, DISP_VER_RES / 2);
+    }
+    trace_add(t, 0, 0, 0);
+
+    t += 80;
+    for (uint32_t i = 0; i < SWIPE_SAMPLES; i++, t += REPORT_MS) {
+        trace_add(t, 1, (uint16_t)(20 + i * 10), 40);
+    }
+    trace_add(t, 0, 0, 0);
+}
+
+/**
+ * @brief Let the simulated controller replay the trace
+ */
+static bool trace_load(void) {
+    char path[] = "/tmp/test_touch_ring_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return false;
+    }
+    FILE *f = fdopen(fd, "w");
+    for (uint32_t i = 0; i < trace_len; i++) {
+        const ft6336u_touch_data_t *d = &trace[i].data;
+        if (d->touch_count > 0) {
+            fprintf(f, "%u 1 %u %u\n", (unsigned)trace[i].time_ms, (unsigned)d->points[0].x,
+                    (unsigned)d->points[0].y);
+        } else {
+            fprintf(f, "%u 0\n", (unsigned)trace[i].time_ms);
+        }
+    }
+    fclose(f);
+    bool ok = sim_touch_load_trace(path);
+    unlink(path);
+    return ok;
+}
+
+/**
+ * @brief touch_ring_read_cb() checking the order of the delivered samples
+ *
+ * A sample has the report in the registers when the main loop read them: the
+ * one of its INT edge, or a later one if the read was late. The edge of that
+ * later report reads it again.
+ */
+static void checked_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    touch_ring_stats_t before, after;
+    touch_ring_get_stats(&before);
+    touch_ring_read_cb(indev, data);
+    touch_ring_get_stats(&after);
+    if (after.delivered == before.delivered) {
+        return;     /* Periodic read while pressed, nothing new */
+    }
+
+    for (uint32_t i = expected; i < trace_len; i++) {
+        const ft6336u_touch_data_t *exp = &trace[i].data;
+        bool pressed = exp->touch_count > 0;
+        if (pressed == (data->state == LV_INDEV_STATE_PRESSED) &&
+            (!pressed || (data->point.x == exp->points[0].x && data->point.y == exp->points[0].y))) {
+            expected = i;
+            return;
+        }
+    }
+    out_of_order++;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+static void click_cb(lv_event_t *e) {
+    (void)e;
+    clicks++;
+}
+
+/**
+ * @brief The main loop of main.c with a simulated frame time
+ */
+static void main_loop_step(lv_indev_t *indev, uint32_t frame_us) {
+    touch_ring_service();
+    for (int i = 0; i < TOUCH_RING_LEN && touch_ring_pending(); i++) {
+        lv_indev_read(indev);
+    }
+    lv_timer_handler();
+    sleep_until_ns(now_ns() + (uint64_t)frame_us * 1000u);
+}
+
+/*===========================================
+ * Main Function
+ *===========================================*/
+
+int main(int argc, char **argv) {
+    uint32_t frame_us = 8000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frame-us") == 0 && i + 1 < argc) {
+            frame_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--frame-us N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, disp_buf, NULL, sizeof(disp_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+
+    lv_obj_t *btn = lv_button_create(lv_display_get_screen_active(disp));
+    lv_obj_set_size(btn, 120, 60);
+    lv_obj_center(btn);
+    lv_obj_add_event_cb(btn, click_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(indev, disp);
+    lv_indev_set_read_cb(indev, checked_read_cb);
+    lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);
+
+    /* The touch path of main.c, the controller reports at its own pace */
+    trace_build(to_ms_since_boot(get_absolute_time()) + TRACE_START_MS);
+    if (!trace_load()) {
+        fprintf(stderr, "Can't write the touch trace\n");
+        return 1;
+    }
+    static ft6336u_t touch_dev;
+    i2c_init(i2c1, 400 * 1000);
+    ft6336u_config_t config = {.i2c = i2c1, .max_x = DISP_HOR_RES, .max_y = DISP_VER_RES};
+    CHECK(ft6336u_init(&touch_dev, &config));
+    gpio_set_irq_enabled_with_callback(PIN_TOUCH_INT, GPIO_IRQ_EDGE_FALL, true, touch_int_callback);
+    CHECK(touch_ring_init(&touch_dev));
+
+    /* Until the last report was pulsed and read */
+    uint32_t end_ms = trace[trace_len - 1].time_ms + TRACE_TIMEOUT_MS;
+    while ((atomic_load(&int_edges) < trace_len && to_ms_since_boot(get_absolute_time()) < end_ms) ||
+           touch_ring_pending()) {
+        main_loop_step(indev, frame_us);
+    }
+    main_loop_step(indev, frame_us);
+    CHECK(atomic_load(&int_edges) == trace_len);
+
+    /* Every INT edge was read or counted as dropped. The main loop keeps up with the
+     * reports unless the host stalls it, the tap still ends in a click then. */
+    touch_ring_stats_t stats;
+    touch_ring_get_stats(&stats);
+    CHECK(stats.pushed + stats.dropped == trace_len);
+    CHECK(stats.delivered == stats.pushed);
+    CHECK(expected == trace_len - 1);
+    CHECK(out_of_order == 0);
+    CHECK(clicks == 1);
+    CHECK(stats.latency_max_us <= frame_us + LATENCY_SLACK_US);
+    CHECK(lv_indev_get_state(indev) == LV_INDEV_STATE_RELEASED);
+
+    printf("Frame %u us, %u reports every %u ms, %u dropped\n", (unsigned)frame_us, (unsigned)trace_len,
+           REPORT_MS, (unsigned)stats.dropped);
+    printf("INT to lv_indev_read(): avg %u us, max %u us\n",
+           (unsigned)(stats.delivered ? stats.latency_sum_us / stats.delivered : 0),
+           (unsigned)stats.latency_max_us);
+
+    /* The main loop stalls while the controller keeps reporting: the edges are merged
+     * into one read of the newest report, the others are counted as dropped */
+    touch_ring_stats_t before = stats;
+    for (uint32_t i = 0; i < STALL_EDGES; i++) {
+        touch_int_callback(PIN_TOUCH_INT, GPIO_IRQ_EDGE_FALL);
+    }
+    touch_ring_get_stats(&stats);
+    CHECK(stats.dropped - before.dropped == STALL_EDGES - 1);
+    CHECK(stats.pushed == before.pushed);
+
+    /* The registers hold the release at the end of the trace */
+    main_loop_step(indev, frame_us);
+    touch_ring_get_stats(&stats);
+    CHECK(stats.pushed - before.pushed == 1);
+    CHECK(stats.delivered - before.delivered == 1);
+    CHECK(out_of_order == 0);
+    CHECK(lv_indev_get_state(indev) == LV_INDEV_STATE_RELEASED);
+    printf("Stalled main loop: %u of %u reports dropped\n",
+           (unsigned)(stats.dropped - before.dropped), (unsigned)STALL_EDGES);
+
+    lv_display_delete(disp);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
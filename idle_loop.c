@@ -0,0 +1,74 @@
+/**
+ * @file idle_loop.c
+ * @brief Tickless main loop implementation
+ */
+
+#include "idle_loop.h"
+#include "core_port.h"
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+/* Between idle_loop_begin() and idle_loop_sleep(): LVGL runs on core 0 */
+static volatile bool loop_busy;
+
+/* Statistics, only written by core 0 */
+static idle_loop_stats_t loop_stats;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+/**
+ * @brief LVGL resumed a timer or made one ready
+ *
+ * Called on every invalidation, so only wake the loop if it doesn't run
+ * lv_timer_handler() afterwards anyway.
+ */
+static void timer_resume_cb(void *data) {
+    (void)data;
+    if (!loop_busy) {
+        core_port_wake();
+    }
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void idle_loop_init(void) {
+    loop_stats = (idle_loop_stats_t){0};
+    lv_timer_handler_set_resume_cb(timer_resume_cb, NULL);
+}
+
+void idle_loop_begin(void) {
+    loop_busy = true;
+}
+
+void idle_loop_sleep(uint32_t time_until_next) {
+    loop_busy = false;
+    loop_stats.loops++;
+
+    if (time_until_next == 0) {
+        return;
+    }
+    if (time_until_next > IDLE_LOOP_MAX_SLEEP_MS) {
+        time_until_next = IDLE_LOOP_MAX_SLEEP_MS;
+    }
+
+    uint32_t t = core_port_time_us();
+    if (core_port_sleep(time_until_next * 1000)) {
+        loop_stats.wakeups++;
+    }
+    loop_stats.sleeps++;
+    loop_stats.slept_us += core_port_time_us() - t;
+}
+
+void idle_loop_wake(void) {
+    core_port_wake();
+}
+
+void idle_loop_get_stats(idle_loop_stats_t *stats) {
+    *stats = loop_stats;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file idle_loop.h
+ * @brief Tickless main loop: sleep until the next LVGL timer is due
+ *
+ * lv_timer_handler() returns the time until its next timer is due. Instead
+ * of calling it again right away, the main loop sleeps on core 0 for that
+ * long (core_port_sleep()), or until an interrupt has new work for LVGL:
+ * the touch INT, a finished DMA transfer, or a timer resumed outside the
+ * loop (lv_timer_handler_set_resume_cb()). Idle screens no longer keep the
+ * core busy scanning the timer list.
+ *
+ * The loop is:
+ *
+ *     while (true) {
+ *         idle_loop_begin();
+ *         ... lv_indev_read() for the queued input ...
+ *         idle_loop_sleep(lv_timer_handler());
+ *     }
+ */
+
+#ifndef IDLE_LOOP_H
+#define IDLE_LOOP_H
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Longest sleep when no timer is due (LV_NO_TIMER_READY). Every source of
+ * work wakes the loop, this only bounds the damage of a forgotten wake-up */
+#define IDLE_LOOP_MAX_SLEEP_MS  500
+
+/*===========================================
+ * Data Structures
+ *===========================================*/
+
+/**
+ * @brief Loop statistics (counters wrap around)
+ */
+typedef struct {
+    uint32_t loops;             /* idle_loop_sleep() calls */
+    uint32_t sleeps;            /* Calls that slept (the next timer wasn't due yet) */
+    uint32_t wakeups;           /* Sleeps ended early by idle_loop_wake() */
+    uint32_t slept_us;          /* Total time asleep */
+} idle_loop_stats_t;
+
+/*===========================================
+ * Function Prototypes
+ *===========================================*/
+
+/**
+ * @brief Register the timer resume callback, call after lv_init()
+ */
+void idle_loop_init(void);
+
+/**
+ * @brief Mark the start of a loop iteration
+ *
+ * Timers the loop resumes itself from here on (an invalidated area resumes
+ * the refresh timer, a press the input device timer) are part of the next
+ * lv_timer_handler() return value and don't cut the sleep short.
+ */
+void idle_loop_begin(void);
+
+/**
+ * @brief End the iteration and sleep until the next timer or idle_loop_wake()
+ * @param time_until_next Return value of lv_timer_handler() in ms
+ */
+void idle_loop_sleep(uint32_t time_until_next);
+
+/**
+ * @brief Wake the loop, call when an interrupt has queued work for LVGL
+ *
+ * Callable from interrupts and from core 1. A wake-up during an iteration
+ * makes the following idle_loop_sleep() return at once.
+ */
+void idle_loop_wake(void);
+
+/**
+ * @brief Get a snapshot of the loop statistics
+ * @param stats Pointer to the structure to fill
+ */
+void idle_loop_get_stats(idle_loop_stats_t *stats);
+
+#endif /* IDLE_LOOP_H */
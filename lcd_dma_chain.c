@@ -0,0 +1,154 @@
+/**
+ * @file lcd_dma_chain.c
+ * @brief Batched MIPI DBI transfers as one chain of DMA transfers
+ */
+
+#include "lcd_dma_chain.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/io_bank0.h"
+#include <assert.h>
+
+/*===========================================
+ * Private Types and Variables
+ *===========================================*/
+
+/* Every segment needs at most 3 steps (wait for the wire, switch DC, send) and the chain ends with a null step */
+#define CHAIN_MAX_STEPS     (LV_LCD_TRANSFER_SEG_MAX * 3 + 1)
+
+/**
+ * @brief One step of the chain, in the order of the data channel's alias 1
+ * registers (CTRL, READ_ADDR, WRITE_ADDR, TRANS_COUNT_TRIG)
+ */
+typedef struct {
+    uint32_t ctrl;
+    uint32_t read_addr;
+    uint32_t write_addr;
+    uint32_t transfer_count;
+} chain_step_t;
+
+/* The control channel writes the steps through a 16 byte write ring */
+static chain_step_t chain_steps[CHAIN_MAX_STEPS] __attribute__((aligned(16)));
+
+static spi_inst_t *chain_spi;
+static uint chain_pin_dc;
+static uint chain_pin_cs;
+static int data_chan;
+static int ctrl_chan;
+
+/* IO_BANK0 GPIO_CTRL values which force DC low (command) and high (data) */
+static uint32_t dc_ctrl_word[2];
+
+/* Destination of the bytes drained from the RX FIFO */
+static uint8_t rx_sink;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static void chain_add(uint *n, const dma_channel_config *c, const volatile void *read_addr,
+                      volatile void *write_addr, uint32_t count) {
+    assert(*n < CHAIN_MAX_STEPS);
+    chain_steps[*n] = (chain_step_t){
+        .ctrl = channel_config_get_ctrl_value(c),
+        .read_addr = (uint32_t)(uintptr_t)read_addr,
+        .write_addr = (uint32_t)(uintptr_t)write_addr,
+        .transfer_count = count,
+    };
+    (*n)++;
+}
+
+/**
+ * @brief Step configuration: 8 or 32 bit, paced by `dreq`, back to the control channel when done
+ */
+static dma_channel_config step_config(enum dma_channel_transfer_size size, bool read_incr, uint dreq) {
+    dma_channel_config c = dma_channel_get_default_config(data_chan);
+    channel_config_set_transfer_data_size(&c, size);
+    channel_config_set_read_increment(&c, read_incr);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, dreq);
+    channel_config_set_chain_to(&c, ctrl_chan);
+    /* Raise the interrupt only on the null trigger at the end of the chain */
+    channel_config_set_irq_quiet(&c, true);
+    return c;
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void lcd_dma_chain_init(spi_inst_t *spi, uint pin_dc, uint pin_cs) {
+    chain_spi = spi;
+    chain_pin_dc = pin_dc;
+    chain_pin_cs = pin_cs;
+    data_chan = dma_claim_unused_channel(true);
+    ctrl_chan = dma_claim_unused_channel(true);
+
+    uint32_t ctrl = io_bank0_hw->io[pin_dc].ctrl & ~IO_BANK0_GPIO0_CTRL_OUTOVER_BITS;
+    dc_ctrl_word[LV_LCD_DC_COMMAND] = ctrl | (GPIO_OVERRIDE_LOW << IO_BANK0_GPIO0_CTRL_OUTOVER_LSB);
+    dc_ctrl_word[LV_LCD_DC_DATA] = ctrl | (GPIO_OVERRIDE_HIGH << IO_BANK0_GPIO0_CTRL_OUTOVER_LSB);
+}
+
+void lcd_dma_chain_run(const lv_lcd_transfer_t *xfer) {
+    spi_hw_t *spi_hw = spi_get_hw(chain_spi);
+    dma_channel_config send = step_config(DMA_SIZE_8, true, spi_get_dreq(chain_spi, true));
+    dma_channel_config wait = step_config(DMA_SIZE_8, false, spi_get_dreq(chain_spi, false));
+    dma_channel_config dc = step_config(DMA_SIZE_32, false, DREQ_FORCE);
+
+    /* Build the chain */
+    uint n = 0;
+    uint32_t pending = 0;       /* Bytes sent since the last wait step */
+    lv_lcd_dc_t dc_level = xfer->seg[0].dc;
+    for (uint32_t i = 0; i < xfer->seg_cnt; i++) {
+        const lv_lcd_transfer_seg_t *seg = &xfer->seg[i];
+        if (seg->size == 0) {
+            continue;
+        }
+
+        if (seg->dc != dc_level) {
+            /* The RX FIFO receives a byte when it has been shifted out: once all pending
+             * bytes are received the DC line can change without corrupting them */
+            assert(pending <= LCD_DMA_CHAIN_FIFO_DEPTH);
+            chain_add(&n, &wait, &spi_hw->dr, &rx_sink, pending);
+            chain_add(&n, &dc, &dc_ctrl_word[seg->dc], &io_bank0_hw->io[chain_pin_dc].ctrl, 1);
+            pending = 0;
+            dc_level = seg->dc;
+        }
+
+        chain_add(&n, &send, lv_lcd_transfer_seg_get_data(seg), &spi_hw->dr, seg->size);
+        pending += seg->size;
+    }
+    /* Null trigger: stops the chain and raises the interrupt flag of the data channel */
+    chain_add(&n, &send, NULL, NULL, 0);
+
+    /* Drop what earlier transfers left in the RX FIFO so the wait steps count only this chain */
+    while (spi_is_readable(chain_spi)) {
+        (void)spi_hw->dr;
+    }
+    spi_hw->icr = SPI_SSPICR_RORIC_BITS;
+    dma_hw->intr = 1u << data_chan;
+
+    gpio_put(chain_pin_dc, xfer->seg[0].dc == LV_LCD_DC_DATA);
+    gpio_put(chain_pin_cs, 0);
+
+    /* The control channel copies 4 words (one step) into the data channel each time it is chained */
+    dma_channel_config c = dma_channel_get_default_config(ctrl_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 4);
+    dma_channel_configure(ctrl_chan, &c, &dma_hw->ch[data_chan].al1_ctrl, chain_steps, 4, true);
+
+    /* Wait for the end of the chain, then for the last segment to leave the FIFO */
+    while (!(dma_hw->intr & (1u << data_chan))) {
+        tight_loop_contents();
+    }
+    dma_hw->intr = 1u << data_chan;
+    while (spi_is_busy(chain_spi)) {
+        tight_loop_contents();
+    }
+
+    gpio_set_outover(chain_pin_dc, GPIO_OVERRIDE_NORMAL);
+    gpio_put(chain_pin_cs, 1);
+}
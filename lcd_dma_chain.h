@@ -0,0 +1,52 @@
+/**
+ * @file lcd_dma_chain.h
+ * @brief Batched MIPI DBI transfers as one chain of DMA transfers
+ *
+ * Runs an `lv_lcd_transfer_t` (CASET, RASET, RAMWR and the pixels of a strip)
+ * without CPU round-trips between the segments: a control DMA channel loads
+ * the data channel with one step after the other. Before the DC level
+ * changes, a step paced by the SPI RX DREQ waits until the last byte of the
+ * previous segment is on the wire, then a step writes the DC pin's output
+ * override in IO_BANK0.
+ *
+ * On the host the same interface replays the segments on the simulated bus
+ * (host/lcd_dma_chain_replay.c).
+ */
+
+#ifndef LCD_DMA_CHAIN_H
+#define LCD_DMA_CHAIN_H
+
+#include "hardware/spi.h"
+#include "lvgl.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* SPI RX FIFO depth: a DC change can only follow this many bytes since the previous one */
+#define LCD_DMA_CHAIN_FIFO_DEPTH    8
+
+/*===========================================
+ * Function Prototypes
+ *===========================================*/
+
+/**
+ * @brief Claim the DMA channels
+ * @param spi SPI instance connected to the display (already initialized)
+ * @param pin_dc DC pin (already an output)
+ * @param pin_cs CS pin (already an output)
+ */
+void lcd_dma_chain_init(spi_inst_t *spi, uint pin_dc, uint pin_cs);
+
+/**
+ * @brief Send a batched transfer and wait until its last bit is on the wire
+ *
+ * Can be used as `lcd_pipeline_sink_t::send_transfer`. Only the last
+ * segment may be longer than the SPI FIFO (LCD_DMA_CHAIN_FIFO_DEPTH), as the DC level can
+ * only change after a segment whose bytes all fit in the RX FIFO.
+ *
+ * @param xfer Transfer to send
+ */
+void lcd_dma_chain_run(const lv_lcd_transfer_t *xfer);
+
+#endif /* LCD_DMA_CHAIN_H */
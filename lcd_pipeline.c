@@ -0,0 +1,241 @@
+/**
+ * @file lcd_pipeline.c
+ * @brief Dual-core render/flush pipeline implementation
+ */
+
+#include "lcd_pipeline.h"
+#include "core_port.h"
+#include <assert.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*===========================================
+ * Private Types and Variables
+ *===========================================*/
+
+/**
+ * @brief One queued transfer, either a command or a pixel strip
+ */
+typedef struct {
+    lv_display_t *disp;
+    uint8_t *px;                            /* Pixel strip, NULL for commands */
+    size_t px_size;
+    bool batched;                           /* The strip and its window are in `batch` */
+    lv_lcd_transfer_t batch;
+    uint8_t cmd[2];                         /* MIPI uses 8 bit commands, 16 bit ones still fit */
+    uint8_t cmd_size;
+    uint8_t param_size;
+    uint8_t param[LCD_PIPELINE_MAX_PARAM];
+} lcd_pipeline_xfer_t;
+
+static lcd_pipeline_sink_t pipeline_sink;
+static bool pipeline_running;
+
+/* Single-producer/single-consumer ring: core 0 only writes `head`, core 1 only writes `tail` */
+static lcd_pipeline_xfer_t xfer_queue[LCD_PIPELINE_QUEUE_LEN];
+static atomic_uint queue_head;
+static atomic_uint queue_tail;
+
+/* Statistics, each one is written by a single core */
+static atomic_uint stat_strips;
+static atomic_uint stat_pixel_bytes;
+static atomic_uint stat_busy_us;
+static atomic_uint stat_idle_us;
+static atomic_uint stat_queue_full;
+
+/* Previous values for lcd_pipeline_get_idle_percent() */
+static uint32_t last_busy_us;
+static uint32_t last_idle_us;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+/**
+ * @brief Wait for a free slot in the queue (core 0)
+ */
+static lcd_pipeline_xfer_t *xfer_alloc(void) {
+    unsigned head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+
+    if (head - atomic_load_explicit(&queue_tail, memory_order_acquire) >= LCD_PIPELINE_QUEUE_LEN) {
+        atomic_store_explicit(&stat_queue_full, atomic_load_explicit(&stat_queue_full, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        while (head - atomic_load_explicit(&queue_tail, memory_order_acquire) >= LCD_PIPELINE_QUEUE_LEN) {
+            core_port_wait_event();
+        }
+    }
+
+    return &xfer_queue[head % LCD_PIPELINE_QUEUE_LEN];
+}
+
+/**
+ * @brief Hand the slot returned by xfer_alloc() over to core 1 (core 0)
+ */
+static void xfer_commit(void) {
+    unsigned head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    atomic_store_explicit(&queue_head, head + 1, memory_order_release);
+    core_port_signal_event();
+}
+
+static void stat_add(atomic_uint *stat, uint32_t value) {
+    atomic_store_explicit(stat, atomic_load_explicit(stat, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+/**
+ * @brief Flush side main loop (core 1)
+ */
+static void pipeline_core1_entry(void) {
+    while (true) {
+        unsigned tail = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+
+        /* Wait for work */
+        uint32_t t = core_port_time_us();
+        while (atomic_load_explicit(&queue_head, memory_order_acquire) == tail) {
+            core_port_wait_event();
+        }
+        uint32_t now = core_port_time_us();
+        stat_add(&stat_idle_us, now - t);
+        t = now;
+
+        lcd_pipeline_xfer_t *xfer = &xfer_queue[tail % LCD_PIPELINE_QUEUE_LEN];
+        lv_display_t *disp = xfer->disp;
+        bool is_strip = xfer->px != NULL;
+        /* A flush split into two batched transfers is done after the second one */
+        bool flush_done = is_strip && !(xfer->batched && xfer->batch.flush_continues);
+
+        if (is_strip) {
+            if (pipeline_sink.swap_bytes) {
+                lv_draw_sw_rgb565_swap(xfer->px, xfer->px_size / 2);
+            }
+            if (xfer->batched) {
+                if (pipeline_sink.tear_sync) {
+                    /* Stay clear of the panel's scan, core 1 has nothing else to do meanwhile */
+                    uint32_t start = core_port_time_us();
+                    uint32_t delay = lv_lcd_generic_mipi_get_tear_delay(disp, &xfer->batch, start);
+                    while (core_port_time_us() - start < delay) {
+                    }
+                }
+                pipeline_sink.send_transfer(&xfer->batch);
+            } else {
+                pipeline_sink.send_color(xfer->cmd, xfer->cmd_size, xfer->px, xfer->px_size);
+            }
+            stat_add(&stat_strips, flush_done ? 1 : 0);
+            stat_add(&stat_pixel_bytes, xfer->px_size);
+        } else {
+            pipeline_sink.send_cmd(xfer->cmd, xfer->cmd_size, xfer->param, xfer->param_size);
+        }
+
+        /* Release the slot before reporting so core 0 can queue the next strip right away */
+        atomic_store_explicit(&queue_tail, tail + 1, memory_order_release);
+        core_port_signal_event();
+
+        if (flush_done) {
+            lv_display_flush_ready(disp);
+            /* Wake core 0 if it waits in lcd_pipeline_flush_wait_cb() */
+            core_port_signal_event();
+        }
+
+        stat_add(&stat_busy_us, core_port_time_us() - t);
+    }
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void lcd_pipeline_init(const lcd_pipeline_sink_t *sink) {
+    pipeline_sink = *sink;
+    atomic_store(&queue_head, 0);
+    atomic_store(&queue_tail, 0);
+    pipeline_running = true;
+    core_port_launch(pipeline_core1_entry);
+}
+
+void lcd_pipeline_send_cmd(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                           const uint8_t *param, size_t param_size) {
+    assert(cmd_size <= sizeof(((lcd_pipeline_xfer_t *)0)->cmd));
+    assert(param_size <= LCD_PIPELINE_MAX_PARAM);
+
+    lcd_pipeline_xfer_t *xfer = xfer_alloc();
+    xfer->disp = disp;
+    xfer->px = NULL;
+    xfer->px_size = 0;
+    xfer->batched = false;
+    memcpy(xfer->cmd, cmd, cmd_size);
+    xfer->cmd_size = (uint8_t)cmd_size;
+    if (param_size > 0) {
+        memcpy(xfer->param, param, param_size);
+    }
+    xfer->param_size = (uint8_t)param_size;
+    xfer_commit();
+}
+
+void lcd_pipeline_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                             uint8_t *param, size_t param_size) {
+    assert(cmd_size <= sizeof(((lcd_pipeline_xfer_t *)0)->cmd));
+
+    lcd_pipeline_xfer_t *xfer = xfer_alloc();
+    xfer->disp = disp;
+    xfer->px = param;
+    xfer->px_size = param_size;
+    xfer->batched = false;
+    memcpy(xfer->cmd, cmd, cmd_size);
+    xfer->cmd_size = (uint8_t)cmd_size;
+    xfer->param_size = 0;
+    xfer_commit();
+}
+
+void lcd_pipeline_send_transfer(lv_display_t *disp, const lv_lcd_transfer_t *xfer) {
+    assert(pipeline_sink.send_transfer != NULL);
+
+    lcd_pipeline_xfer_t *slot = xfer_alloc();
+    slot->disp = disp;
+    slot->batch = *xfer;
+    slot->batched = true;
+    slot->cmd_size = 0;
+    slot->param_size = 0;
+
+    /* The pixels are the segment which is referenced instead of copied */
+    slot->px = NULL;
+    slot->px_size = 0;
+    for (uint32_t i = 0; i < xfer->seg_cnt; i++) {
+        if (xfer->seg[i].data != NULL) {
+            slot->px = xfer->seg[i].data;
+            slot->px_size = xfer->seg[i].size;
+        }
+    }
+    assert(slot->px != NULL);
+    xfer_commit();
+}
+
+void lcd_pipeline_flush_wait_cb(lv_display_t *disp) {
+    (void)disp;
+    core_port_wait_event();
+}
+
+void lcd_pipeline_get_stats(lcd_pipeline_stats_t *stats) {
+    stats->strips = atomic_load_explicit(&stat_strips, memory_order_relaxed);
+    stats->pixel_bytes = atomic_load_explicit(&stat_pixel_bytes, memory_order_relaxed);
+    stats->busy_us = atomic_load_explicit(&stat_busy_us, memory_order_relaxed);
+    stats->idle_us = atomic_load_explicit(&stat_idle_us, memory_order_relaxed);
+    stats->queue_full = atomic_load_explicit(&stat_queue_full, memory_order_relaxed);
+}
+
+uint32_t lcd_pipeline_get_idle_percent(void) {
+    if (!pipeline_running) {
+        return 100;
+    }
+
+    uint32_t busy_us = atomic_load_explicit(&stat_busy_us, memory_order_relaxed);
+    uint32_t idle_us = atomic_load_explicit(&stat_idle_us, memory_order_relaxed);
+    uint32_t busy = busy_us - last_busy_us;
+    uint32_t idle = idle_us - last_idle_us;
+    last_busy_us = busy_us;
+    last_idle_us = idle_us;
+
+    if (busy + idle == 0) {
+        return 100;
+    }
+
+    return (uint32_t)(((uint64_t)idle * 100) / (busy + idle));
+}
@@ -0,0 +1,115 @@
+/**
+ * @file lcd_pipeline.h
+ * @brief Dual-core render/flush pipeline for MIPI DBI displays
+ *
+ * Core 0 runs LVGL and only queues the transfers requested by the display
+ * driver. Core 1 owns the bus: it sends the windowing commands, optionally
+ * converts the pixels, runs the pixel transfer and reports its completion
+ * with lv_display_flush_ready(). The cores are connected by a lock-free
+ * single-producer/single-consumer queue.
+ */
+
+#ifndef LCD_PIPELINE_H
+#define LCD_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Number of queued transfers (commands and pixel strips). Every strip takes three
+ * slots (CASET, RASET and RAMWR) or one or two (wrapping around the hardware scrolling)
+ * as batched transfers, so keep it above 3x the buffer ring depth */
+#define LCD_PIPELINE_QUEUE_LEN      32
+
+/* Longest command parameter list that can be queued (ST7796 gamma tables need 14) */
+#define LCD_PIPELINE_MAX_PARAM      16
+
+/*===========================================
+ * Data Structures
+ *===========================================*/
+
+/**
+ * @brief Bus access used by core 1
+ *
+ * The functions are called on core 1 only and must return when the
+ * transfer has finished.
+ */
+typedef struct {
+    void (*send_cmd)(const uint8_t *cmd, size_t cmd_size, const uint8_t *param, size_t param_size);
+    void (*send_color)(const uint8_t *cmd, size_t cmd_size, uint8_t *param, size_t param_size);
+    void (*send_transfer)(const lv_lcd_transfer_t *xfer);  /* Needed only for lcd_pipeline_send_transfer() */
+    bool swap_bytes;        /* Swap RGB565 bytes on core 1 before sending the pixels */
+    bool tear_sync;         /* Hold back batched transfers as lv_lcd_generic_mipi_get_tear_delay() asks */
+} lcd_pipeline_sink_t;
+
+/**
+ * @brief Pipeline statistics (counters wrap around)
+ */
+typedef struct {
+    uint32_t strips;        /* Pixel strips sent */
+    uint32_t pixel_bytes;   /* Pixel bytes sent */
+    uint32_t busy_us;       /* Time core 1 spent on transfers */
+    uint32_t idle_us;       /* Time core 1 waited for work */
+    uint32_t queue_full;    /* Number of times core 0 had to wait for a free slot */
+} lcd_pipeline_stats_t;
+
+/*===========================================
+ * Function Prototypes
+ *===========================================*/
+
+/**
+ * @brief Start the flush side of the pipeline on core 1
+ * @param sink Bus access functions (copied)
+ */
+void lcd_pipeline_init(const lcd_pipeline_sink_t *sink);
+
+/**
+ * @brief Queue a command, can be used as `lv_lcd_send_cmd_cb_t`
+ * @note The command and its parameters are copied
+ */
+void lcd_pipeline_send_cmd(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                           const uint8_t *param, size_t param_size);
+
+/**
+ * @brief Queue a pixel strip, can be used as `lv_lcd_send_color_cb_t`
+ * @note The pixels are not copied, core 1 calls lv_display_flush_ready() when it is done with them
+ */
+void lcd_pipeline_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_size,
+                             uint8_t *param, size_t param_size);
+
+/**
+ * @brief Queue a batched transfer, can be used as `lv_lcd_send_transfer_cb_t`
+ * @note The descriptor is copied, the pixels are not. Core 1 calls lv_display_flush_ready() when it is done
+ *       with a transfer without `flush_continues`.
+ */
+void lcd_pipeline_send_transfer(lv_display_t *disp, const lv_lcd_transfer_t *xfer);
+
+/**
+ * @brief Sleep until core 1 reports a flushed strip, can be used as `lv_display_flush_wait_cb_t`
+ *
+ * With a buffer ring (lv_display_set_buffer_ring()) core 0 waits here for the
+ * oldest strip instead of spinning on the flush counters.
+ */
+void lcd_pipeline_flush_wait_cb(lv_display_t *disp);
+
+/**
+ * @brief Get a snapshot of the pipeline statistics
+ * @param stats Pointer to the structure to fill
+ */
+void lcd_pipeline_get_stats(lcd_pipeline_stats_t *stats);
+
+/**
+ * @brief Idle percentage of core 1 since the previous call
+ *
+ * Set with lv_sysmon_performance_set_proc_idle_cb() so that lv_sysmon
+ * reports the load of both cores. Returns 100 while the pipeline is not
+ * running.
+ */
+uint32_t lcd_pipeline_get_idle_percent(void);
+
+#endif /* LCD_PIPELINE_H */
@@ -94,7 +94,14 @@
         #define LV_DRAW_SW_SHADOW_CACHE_SIZE    0
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE    4
     #endif
-    #define LV_USE_DRAW_SW_ASM                  LV_DRAW_SW_ASM_NONE
+    /* Blending on the DSP extension of the Cortex-M33 (blend_dsp.h),
+     * SSE2 / AVX2 on x86 hosts (blend_simd.h) */
+    #define LV_USE_DRAW_SW_ASM                  LV_DRAW_SW_ASM_CUSTOM
+    #define LV_DRAW_SW_ASM_CUSTOM_INCLUDE       "blend_asm.h"
+    /* The DSP blending of the firmware. Only the C emulation of its instructions
+     * is tested (host/test_blend_dsp): set to 1 once the native path has been
+     * checked on the device, until then the firmware blends with LVGL's code */
+    #define DISP_BLEND_DSP                      0
     #define LV_USE_DRAW_SW_COMPLEX_GRADIENTS    0
 #endif
 
@@ -184,6 +191,10 @@
 /** Use Matrix for transformations. */
 #define LV_USE_MATRIX           0
 
+/** Pinch, rotate and two-finger swipe from the two FT6336U touch points. The recognizers compute in
+ *  single precision float (the Cortex-M33 has an FPU), LV_USE_FLOAT stays off */
+#define LV_USE_GESTURE_RECOGNITION 1
+
 /*=====================
  *  COMPILER SETTINGS
  *====================*/
@@ -245,6 +256,10 @@
 /** Default font */
 #define LV_FONT_DEFAULT &lv_font_montserrat_14
 
+/** Decode the compressed fonts (lv_font_conv without --no-compress). Their
+ *  glyphs can be kept decoded with lv_font_fmt_txt_cache_resize() */
+#define LV_USE_FONT_COMPRESSED  1
+
 /** Enable FreeType library */
 #define LV_USE_FREETYPE         0
 
@@ -392,6 +407,10 @@
         #define LV_USE_PERF_MONITOR_LOG_MODE 0
     #endif
 
+    /** The load of core 1 (the flush side of lcd_pipeline.c) is reported next to core 0 by main.c with
+     *  lv_sysmon_performance_set_proc_idle_cb(), so LVGL doesn't depend on the application */
+    #define LV_SYSMON_PROC_IDLE_AVAILABLE 0
+
     /** Show used memory and memory fragmentation */
     #define LV_USE_MEM_MONITOR 0
 #endif
@@ -34,6 +34,7 @@ extern "C" {
 #include "src/libs/barcode/lv_barcode_private.h"
 #include "src/draw/lv_draw_triangle_private.h"
 #include "src/draw/lv_draw_private.h"
+#include "src/draw/lv_draw_arena_private.h"
 #include "src/draw/lv_draw_rect_private.h"
 #include "src/draw/lv_draw_image_private.h"
 #include "src/draw/lv_image_decoder_private.h"
@@ -54,6 +55,8 @@ extern "C" {
 #include "src/core/lv_obj_private.h"
 #include "src/core/lv_obj_scroll_private.h"
 #include "src/core/lv_obj_draw_private.h"
+#include "src/core/lv_obj_render_cache_private.h"
+#include "src/core/lv_obj_draw_list_private.h"
 #include "src/core/lv_obj_class_private.h"
 #include "src/core/lv_group_private.h"
 #include "src/core/lv_obj_event_private.h"
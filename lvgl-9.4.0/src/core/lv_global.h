@@ -22,6 +22,7 @@ extern "C" {
 #endif
 #include "../misc/lv_anim.h"
 #include "../misc/lv_area.h"
+#include "../misc/lv_array.h"
 #include "../misc/lv_color_op.h"
 #include "../misc/lv_ll.h"
 #include "../misc/lv_log.h"
@@ -51,6 +52,7 @@ extern "C" {
 #include "../others/sysmon/lv_sysmon_private.h"
 #include "../others/test/lv_test_private.h"
 #include "../layouts/lv_layout_private.h"
+#include "lv_obj_draw_list_private.h"
 
 /*********************
  *      DEFINES
@@ -134,8 +136,14 @@ typedef struct _lv_global_t {
     lv_cache_t * img_cache;
     lv_cache_t * img_header_cache;
 
+    lv_cache_t * obj_render_cache;
+    lv_array_t obj_render_cache_acquired;   /**< Cached buffers drawn in the current refresh*/
+    uint32_t obj_render_cache_cnt;          /**< Widgets with the render cache enabled*/
+    lv_obj_draw_list_state_t obj_draw_list;
+
     lv_draw_global_info_t draw_info;
     lv_ll_t draw_sw_blend_handler_ll;
+    uint32_t draw_sw_band_min_px;
 #if defined(LV_DRAW_SW_SHADOW_CACHE_SIZE) && LV_DRAW_SW_SHADOW_CACHE_SIZE > 0
     lv_draw_sw_shadow_cache_t sw_shadow_cache;
 #endif
@@ -207,9 +215,8 @@ typedef struct _lv_global_t {
     struct _lv_freetype_context_t * ft_context;
 #endif
 
-#if LV_USE_FONT_COMPRESSED
-    lv_font_fmt_rle_t font_fmt_rle;
-#endif
+    lv_cache_t * font_fmt_txt_cache;
+    lv_font_fmt_txt_lookup_state_t font_fmt_txt_lookup;
 
 #if LV_USE_SPAN != 0
     struct _snippet_stack * span_snippet_stack;
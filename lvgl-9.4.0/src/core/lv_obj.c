@@ -12,6 +12,7 @@
 #include "lv_obj_style_private.h"
 #include "lv_obj_event_private.h"
 #include "lv_obj_class_private.h"
+#include "lv_obj_draw_list_private.h"
 #include "../indev/lv_indev.h"
 #include "../indev/lv_indev_private.h"
 #include "lv_refr.h"
@@ -27,6 +28,7 @@
 #include "../tick/lv_tick.h"
 #include "../stdlib/lv_string.h"
 #include "lv_obj_draw_private.h"
+#include "lv_obj_scroll_private.h"
 
 /*********************
  *      DEFINES
@@ -67,6 +69,7 @@ static void draw_scrollbar(lv_obj_t * obj, lv_layer_t * layer);
 static lv_result_t scrollbar_init_draw_dsc(lv_obj_t * obj, lv_draw_rect_dsc_t * dsc);
 static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find);
 static void update_obj_state(lv_obj_t * obj, lv_state_t new_state);
+static bool scrollbar_style_diff_only(lv_obj_t * obj, lv_state_t state1, lv_state_t state2);
 static void lv_obj_children_add_state(lv_obj_t * obj, lv_state_t state);
 static void lv_obj_children_remove_state(lv_obj_t * obj, lv_state_t state);
 static void null_on_delete_cb(lv_event_t * e);
@@ -594,6 +597,10 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
 
     lv_event_mark_deleted(obj);
 
+    /*Free the cached rendering, another widget might be allocated at the same address*/
+    lv_obj_set_render_cache(obj, false);
+    lv_obj_draw_list_invalidate(obj);
+
     /*Remove all style*/
     lv_obj_enable_style_refresh(false); /*No need to refresh the style because the object will be deleted*/
     lv_obj_remove_style_all(obj);
@@ -997,8 +1004,14 @@ static void update_obj_state(lv_obj_t * obj, lv_state_t new_state)
         return;
     }
 
-    /*Invalidate the object in their current state*/
-    lv_obj_invalidate(obj);
+    /*Invalidate the object in their current state.
+     *E.g. the scrolled state usually changes only how the scrollbars look.*/
+    bool scrollbar_only = cmp_res == LV_STYLE_STATE_CMP_DIFF_REDRAW && scrollbar_style_diff_only(obj, prev_state, new_state);
+    if(scrollbar_only) lv_obj_invalidate_scrollbars(obj);
+    else lv_obj_invalidate(obj);
+
+    /*The children inherit the properties of the new state*/
+    if(!scrollbar_only) lv_obj_draw_list_drop(obj);
 
     obj->state = new_state;
     lv_obj_update_layer_type(obj);
@@ -1047,7 +1060,10 @@ static void update_obj_state(lv_obj_t * obj, lv_state_t new_state)
 
     lv_free(ts);
 
-    if(cmp_res == LV_STYLE_STATE_CMP_DIFF_REDRAW) {
+    if(scrollbar_only) {
+        lv_obj_invalidate_scrollbars(obj);
+    }
+    else if(cmp_res == LV_STYLE_STATE_CMP_DIFF_REDRAW) {
         /*Invalidation is not enough, e.g. layer type needs to be updated too*/
         lv_obj_refresh_style(obj, LV_PART_ANY, LV_STYLE_PROP_ANY);
     }
@@ -1060,6 +1076,30 @@ static void update_obj_state(lv_obj_t * obj, lv_state_t new_state)
     }
 }
 
+/**
+ * Check if the styles which apply only in one of two states are all scrollbar styles
+ * @param obj       pointer to an object
+ * @param state1    a state
+ * @param state2    another state
+ * @return          true: only the scrollbars look different
+ */
+static bool scrollbar_style_diff_only(lv_obj_t * obj, lv_state_t state1, lv_state_t state2)
+{
+    uint32_t i;
+    for(i = 0; i < obj->style_cnt; i++) {
+        if(obj->styles[i].is_trans) continue;
+
+        lv_state_t state_act = lv_obj_style_get_selector_state(obj->styles[i].selector);
+        bool valid1 = state_act & (~state1) ? false : true;
+        bool valid2 = state_act & (~state2) ? false : true;
+        if(valid1 != valid2 && lv_obj_style_get_selector_part(obj->styles[i].selector) != LV_PART_SCROLLBAR) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * Apply the state to the children of the object
  * @param obj pointer to an object
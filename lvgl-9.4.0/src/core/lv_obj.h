@@ -26,6 +26,8 @@ extern "C" {
 #include "lv_obj_scroll.h"
 #include "lv_obj_style.h"
 #include "lv_obj_draw.h"
+#include "lv_obj_render_cache.h"
+#include "lv_obj_draw_list.h"
 #include "lv_obj_class.h"
 #include "lv_obj_event.h"
 #include "lv_obj_property.h"
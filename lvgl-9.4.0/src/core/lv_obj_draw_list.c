@@ -0,0 +1,522 @@
+/**
+ * @file lv_obj_draw_list.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_obj_draw_list_private.h"
+#include "lv_obj_private.h"
+#include "lv_obj_draw_private.h"
+#include "lv_global.h"
+#include "../draw/lv_draw_private.h"
+#include "../draw/lv_draw_label_private.h"
+#include "../draw/lv_draw_arena_private.h"
+#include "../misc/lv_area_private.h"
+#include "../misc/lv_event_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define state_p (&LV_GLOBAL_DEFAULT()->obj_draw_list)
+
+#define LIST_HEADER_SIZE    LV_ALIGN_UP(sizeof(lv_obj_draw_list_t), 8)
+#define TASK_HEADER_SIZE    LV_ALIGN_UP(sizeof(recorded_task_t), 8)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** A recorded draw task. It's followed by its draw descriptor and the copy of its local text.*/
+typedef struct {
+    lv_area_t area;
+    lv_area_t real_area;
+    lv_area_t clip_area;
+    uint32_t size;          /**< With the draw descriptor and the text, aligned to 8*/
+    uint32_t text_len;      /**< Length of the local text of a label, 0 if there is none*/
+    uint16_t dsc_size;
+    uint8_t type;
+} recorded_task_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static bool is_recordable(lv_obj_t * obj);
+static lv_obj_draw_list_t ** bucket_get(const lv_obj_t * obj);
+static bool key_match(const lv_obj_draw_list_t * list, const lv_obj_draw_list_t * key);
+static bool key_covers(const lv_obj_draw_list_t * list, const lv_obj_draw_list_t * key);
+static void replay(lv_layer_t * layer, const lv_obj_draw_list_t * list);
+static bool rec_buf_reserve(uint32_t size);
+static void rec_buf_free(void);
+static void list_free(lv_obj_draw_list_t * list);
+static void drop_obj(const lv_obj_t * obj);
+static void drop_tree(const lv_obj_t * obj);
+static void drop_all(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_obj_draw_list_init(uint32_t size)
+{
+    lv_memzero(state_p, sizeof(lv_obj_draw_list_state_t));
+    state_p->size = size;
+    state_p->stats.size = size;
+}
+
+void lv_obj_draw_list_deinit(void)
+{
+    drop_all();
+    lv_free(state_p->buckets);
+    lv_free(state_p->rec_buf);
+    lv_memzero(state_p, sizeof(lv_obj_draw_list_state_t));
+}
+
+void lv_obj_draw_list_resize(uint32_t new_size)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+
+    if(new_size && st->buckets == NULL) {
+        st->buckets = lv_malloc_zeroed(LV_OBJ_DRAW_LIST_BUCKET_CNT * sizeof(lv_obj_draw_list_t *));
+        LV_ASSERT_MALLOC(st->buckets);
+        if(st->buckets == NULL) new_size = 0;
+    }
+
+    st->size = new_size;
+    st->stats.size = new_size;
+
+    while(st->lru_tail && st->used > new_size) {
+        list_free(st->lru_tail);
+        st->stats.evict_cnt++;
+    }
+
+    if(new_size == 0) {
+        st->rec_layer = NULL;
+        rec_buf_free();
+        lv_free(st->buckets);
+        st->buckets = NULL;
+    }
+}
+
+void lv_obj_draw_list_drop(const lv_obj_t * obj)
+{
+    if(obj == NULL) drop_all();
+    else drop_tree(obj);
+}
+
+void lv_obj_draw_list_get_stats(lv_obj_draw_list_stats_t * stats)
+{
+    *stats = state_p->stats;
+    stats->used = state_p->used;
+}
+
+void lv_obj_draw_list_reset_stats(void)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+    uint32_t list_cnt = st->stats.list_cnt;
+    lv_memzero(&st->stats, sizeof(st->stats));
+    st->stats.size = st->size;
+    st->stats.list_cnt = list_cnt;
+    st->stats.max_used = st->used;
+}
+
+bool lv_obj_draw_list_replay(lv_layer_t * layer, lv_obj_t * obj, lv_obj_draw_list_phase_t phase)
+{
+#if LV_DRAW_TRANSFORM_USE_MATRIX
+    /*The draw tasks would need the matrix of the layer too*/
+    LV_UNUSED(layer);
+    LV_UNUSED(obj);
+    LV_UNUSED(phase);
+    return false;
+#else
+    lv_obj_draw_list_state_t * st = state_p;
+
+    /*Disabled, or drawn in the draw events of an other widget*/
+    if(st->size == 0 || st->rec_layer) return false;
+    if(obj->draw_list_skip || !is_recordable(obj)) return false;
+
+    lv_obj_draw_list_t * key = &st->rec_key;
+    key->obj = obj;
+    key->clip_area = layer->_clip_area;
+    key->coords = obj->coords;
+    key->color_format = layer->color_format;
+    key->opa = layer->opa;
+    key->recolor = layer->recolor;
+    key->phase = phase;
+
+    lv_obj_draw_list_t * list = *bucket_get(obj);
+    while(list) {
+        if(list->obj == obj && key_covers(list, key)) break;
+        list = list->bucket_next;
+    }
+
+    if(list) {
+        replay(layer, list);
+
+        /*Move it to the head of the LRU list*/
+        if(list != st->lru_head) {
+            list->lru_prev->lru_next = list->lru_next;
+            if(list->lru_next) list->lru_next->lru_prev = list->lru_prev;
+            else st->lru_tail = list->lru_prev;
+            list->lru_prev = NULL;
+            list->lru_next = st->lru_head;
+            st->lru_head->lru_prev = list;
+            st->lru_head = list;
+        }
+
+        st->stats.replay_cnt++;
+        st->stats.replay_task_cnt += list->task_cnt;
+        return true;
+    }
+
+    /*Record only if it's drawn unchanged for the second time, not the widgets which change in
+     *every refresh. The post draw phase ends drawing the widget.*/
+    if(!obj->draw_list_seen) {
+        if(phase == LV_OBJ_DRAW_LIST_PHASE_POST) obj->draw_list_seen = 1;
+        return false;
+    }
+
+    /*Record the draw tasks added by the draw events. Draw the whole widget to be able to replay
+     *it for any clip area, the draw tasks are clipped to the real clip area when they are added.*/
+    st->rec_layer = layer;
+    st->rec_clip_area = layer->_clip_area;
+    st->rec_used = 0;
+    st->rec_task_cnt = 0;
+    st->rec_invalid = false;
+
+    int32_t ext_draw_size = lv_obj_get_ext_draw_size(obj);
+    key->clip_area = obj->coords;
+    lv_area_increase(&key->clip_area, ext_draw_size, ext_draw_size);
+    layer->_clip_area = key->clip_area;
+    return false;
+#endif
+}
+
+void lv_obj_draw_list_record_end(lv_layer_t * layer, lv_obj_t * obj)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+    if(st->rec_layer == NULL || st->rec_layer != layer || st->rec_key.obj != obj) return;
+
+    st->rec_layer = NULL;
+    layer->_clip_area = st->rec_clip_area;
+
+    uint32_t size = LIST_HEADER_SIZE + st->rec_used;
+    if(st->rec_invalid || obj->is_deleting || !rec_buf_reserve(st->rec_used)) {
+        /*Don't try again, drawing the whole widget costs more than what the replays could save*/
+        obj->draw_list_skip = 1;
+        st->stats.skip_cnt++;
+        rec_buf_free();
+        return;
+    }
+
+    /*The lists drawn to a part of the new one's clip area are not needed anymore*/
+    lv_obj_draw_list_t * old = *bucket_get(obj);
+    while(old) {
+        lv_obj_draw_list_t * next = old->bucket_next;
+        if(old->obj == obj && key_covers(&st->rec_key, old)) list_free(old);
+        old = next;
+    }
+
+    while(st->lru_tail && st->used + size > st->size) {
+        list_free(st->lru_tail);
+        st->stats.evict_cnt++;
+    }
+
+    /*The tasks were recorded into the list, return the unused part to the heap*/
+    lv_obj_draw_list_t * list = lv_realloc(st->rec_buf, size);
+    if(list == NULL) list = (lv_obj_draw_list_t *)st->rec_buf;
+    st->rec_buf = NULL;
+    st->rec_buf_size = 0;
+
+    *list = st->rec_key;
+    list->size = size;
+    list->task_cnt = st->rec_task_cnt;
+
+    lv_obj_draw_list_t ** bucket = bucket_get(obj);
+    list->bucket_next = *bucket;
+    *bucket = list;
+
+    list->lru_prev = NULL;
+    list->lru_next = st->lru_head;
+    if(st->lru_head) st->lru_head->lru_prev = list;
+    else st->lru_tail = list;
+    st->lru_head = list;
+
+    st->used += size;
+    st->stats.list_cnt++;
+    st->stats.record_cnt++;
+    if(st->used > st->stats.max_used) st->stats.max_used = st->used;
+}
+
+void lv_obj_draw_list_record_task(lv_layer_t * layer, lv_draw_task_t * t, size_t dsc_size)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+    if(st->rec_layer == NULL) return;
+
+    /*Added to the whole widget but draw it only where the widget is really redrawn.
+     *If there is no common area the clip area stays invalid and nothing is drawn.*/
+    lv_area_t clip_area = t->clip_area;
+    if(layer == st->rec_layer) lv_area_intersect(&t->clip_area, &clip_area, &st->rec_clip_area);
+
+    if(st->rec_invalid) return;
+
+    /*Only simple draw tasks added directly to the widget's layer can be replayed.
+     *Layers and vector graphics own memory which is freed with the draw task.*/
+    const lv_draw_dsc_base_t * base_dsc = t->draw_dsc;
+    bool simple;
+    switch(t->type) {
+        case LV_DRAW_TASK_TYPE_FILL:
+        case LV_DRAW_TASK_TYPE_BORDER:
+        case LV_DRAW_TASK_TYPE_BOX_SHADOW:
+        case LV_DRAW_TASK_TYPE_LETTER:
+        case LV_DRAW_TASK_TYPE_LABEL:
+        case LV_DRAW_TASK_TYPE_IMAGE:
+        case LV_DRAW_TASK_TYPE_LINE:
+        case LV_DRAW_TASK_TYPE_ARC:
+        case LV_DRAW_TASK_TYPE_TRIANGLE:
+            simple = true;
+            break;
+        default:
+            simple = false;
+            break;
+    }
+
+    if(!simple || layer != st->rec_layer || LV_GLOBAL_DEFAULT()->draw_info.task_running ||
+       (base_dsc->obj && lv_obj_has_flag(base_dsc->obj, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS))) {
+        st->rec_invalid = true;
+        return;
+    }
+
+    const char * text = NULL;
+    uint32_t text_len = 0;
+    if(t->type == LV_DRAW_TASK_TYPE_LABEL) {
+        const lv_draw_label_dsc_t * label_dsc = t->draw_dsc;
+        if(label_dsc->text_local && label_dsc->text) {
+            text = label_dsc->text;
+            text_len = lv_strlen(text);
+        }
+    }
+
+    uint32_t size = LV_ALIGN_UP(TASK_HEADER_SIZE + dsc_size + (text ? text_len + 1 : 0), 8);
+    if(!rec_buf_reserve(st->rec_used + size)) {
+        st->rec_invalid = true;
+        return;
+    }
+
+    recorded_task_t * rt = (recorded_task_t *)(st->rec_buf + LIST_HEADER_SIZE + st->rec_used);
+    rt->area = t->area;
+    rt->real_area = t->_real_area;
+    rt->clip_area = clip_area;
+    rt->size = size;
+    rt->text_len = text ? text_len + 1 : 0;
+    rt->dsc_size = (uint16_t)dsc_size;
+    rt->type = (uint8_t)t->type;
+
+    uint8_t * dsc = (uint8_t *)rt + TASK_HEADER_SIZE;
+    lv_memcpy(dsc, t->draw_dsc, dsc_size);
+    if(text) lv_memcpy(dsc + dsc_size, text, text_len + 1);
+
+    st->rec_used += size;
+    st->rec_task_cnt++;
+}
+
+void lv_obj_draw_list_invalidate(const lv_obj_t * obj)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+
+    /*Changed in its own draw events, e.g. a label which updates its text*/
+    if(st->rec_layer && st->rec_key.obj == obj) st->rec_invalid = true;
+
+    drop_obj(obj);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Check if the draw events of a widget add the same draw tasks until it's invalidated.
+ * It's unknown for widgets whose draw tasks or draw events are handled by the application.
+ * @param obj   pointer to a widget
+ * @return      true: the draw tasks can be recorded
+ */
+static bool is_recordable(lv_obj_t * obj)
+{
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS)) return false;
+
+    uint32_t event_cnt = lv_obj_get_event_count(obj);
+    uint32_t i;
+    for(i = 0; i < event_cnt; i++) {
+        lv_event_dsc_t * dsc = lv_obj_get_event_dsc(obj, i);
+        uint32_t code = dsc->filter & ~(LV_EVENT_PREPROCESS | LV_EVENT_MARKED_DELETING);
+        if(code == LV_EVENT_ALL) return false;
+        if(code >= LV_EVENT_DRAW_MAIN_BEGIN && code <= LV_EVENT_DRAW_POST_END) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Get the hash bucket of a widget's lists
+ * @param obj   pointer to a widget
+ * @return      the head of the bucket's list
+ */
+static lv_obj_draw_list_t ** bucket_get(const lv_obj_t * obj)
+{
+    uintptr_t h = (uintptr_t)obj;
+    h ^= h >> 11;
+    return &state_p->buckets[(h >> 4) & (LV_OBJ_DRAW_LIST_BUCKET_CNT - 1)];
+}
+
+static bool key_match(const lv_obj_draw_list_t * list, const lv_obj_draw_list_t * key)
+{
+    return list->phase == key->phase &&
+           list->color_format == key->color_format &&
+           list->opa == key->opa &&
+           lv_color32_eq(list->recolor, key->recolor) &&
+           lv_area_is_equal(&list->coords, &key->coords);
+}
+
+/**
+ * Check if a list can be replayed for a key: the widget is drawn to the same place in the same way
+ * and the clip area is the same or a part of the list's. The draw tasks are clipped when they are
+ * replayed.
+ * @param list      a recorded list
+ * @param key       the key of the widget being drawn
+ * @return          true: the list has all the draw tasks of the key
+ */
+static bool key_covers(const lv_obj_draw_list_t * list, const lv_obj_draw_list_t * key)
+{
+    return key_match(list, key) && lv_area_is_in(&key->clip_area, &list->clip_area, 0);
+}
+
+/**
+ * Add the recorded draw tasks to a layer as if the draw events added them
+ * @param layer     the layer to draw to
+ * @param list      the recorded list
+ */
+static void replay(lv_layer_t * layer, const lv_obj_draw_list_t * list)
+{
+    const uint8_t * p = (const uint8_t *)list + LIST_HEADER_SIZE;
+    uint32_t i;
+    for(i = 0; i < list->task_cnt; i++) {
+        const recorded_task_t * rt = (const recorded_task_t *)p;
+        const uint8_t * dsc = p + TASK_HEADER_SIZE;
+        p += rt->size;
+
+        /*The list is recorded to the whole widget*/
+        lv_area_t clip_area;
+        if(!lv_area_intersect(&clip_area, &rt->clip_area, &layer->_clip_area)) continue;
+        if(!lv_area_is_on(&clip_area, &rt->real_area)) continue;
+
+        lv_draw_task_t * t = lv_draw_add_task(layer, &rt->area, rt->type);
+        t->_real_area = rt->real_area;
+        t->clip_area = clip_area;
+        lv_memcpy(t->draw_dsc, dsc, rt->dsc_size);
+
+        if(rt->text_len) {
+            /*Copy the local text next to the draw task as `lv_draw_label()` does*/
+            lv_draw_label_dsc_t * label_dsc = t->draw_dsc;
+            char * text = lv_draw_arena_alloc(rt->text_len);
+            LV_ASSERT_MALLOC(text);
+            if(text) lv_memcpy(text, dsc + rt->dsc_size, rt->text_len);
+            label_dsc->text = text;
+        }
+
+        lv_draw_finalize_task_creation(layer, t);
+    }
+}
+
+/**
+ * Make sure the list being recorded has room for the given size of recorded tasks.
+ * It grows by doubling and it's shrunk to its size when the recording ends.
+ * @param size      the required size of the recorded tasks in bytes
+ * @return          false if it doesn't fit in the budget or out of memory
+ */
+static bool rec_buf_reserve(uint32_t size)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+    size += LIST_HEADER_SIZE;
+    if(size <= st->rec_buf_size) return true;
+    if(size > st->size) return false;
+
+    uint32_t new_size = LV_MAX(size, st->rec_buf_size * 2);
+    new_size = LV_MIN(LV_MAX(new_size, 256), st->size);
+    uint8_t * new_buf = lv_realloc(st->rec_buf, new_size);
+    if(new_buf == NULL) return false;
+
+    st->rec_buf = new_buf;
+    st->rec_buf_size = new_size;
+    return true;
+}
+
+static void rec_buf_free(void)
+{
+    lv_free(state_p->rec_buf);
+    state_p->rec_buf = NULL;
+    state_p->rec_buf_size = 0;
+}
+
+/**
+ * Unlink a list from its widget and the LRU list and free it
+ * @param list  the list to free
+ */
+static void list_free(lv_obj_draw_list_t * list)
+{
+    lv_obj_draw_list_state_t * st = state_p;
+
+    lv_obj_draw_list_t ** link = bucket_get(list->obj);
+    while(*link != list) link = &(*link)->bucket_next;
+    *link = list->bucket_next;
+
+    if(list->lru_prev) list->lru_prev->lru_next = list->lru_next;
+    else st->lru_head = list->lru_next;
+    if(list->lru_next) list->lru_next->lru_prev = list->lru_prev;
+    else st->lru_tail = list->lru_prev;
+
+    st->used -= list->size;
+    st->stats.list_cnt--;
+    lv_free(list);
+}
+
+static void drop_obj(const lv_obj_t * obj)
+{
+    if(state_p->buckets) {
+        lv_obj_draw_list_t * list = *bucket_get(obj);
+        while(list) {
+            lv_obj_draw_list_t * next = list->bucket_next;
+            if(list->obj == obj) list_free(list);
+            list = next;
+        }
+    }
+
+    /*It might draw different draw tasks now*/
+    ((lv_obj_t *)obj)->draw_list_skip = 0;
+    ((lv_obj_t *)obj)->draw_list_seen = 0;
+}
+
+static void drop_tree(const lv_obj_t * obj)
+{
+    drop_obj(obj);
+
+    uint32_t child_cnt = lv_obj_get_child_count(obj);
+    uint32_t i;
+    for(i = 0; i < child_cnt; i++) {
+        drop_tree(obj->spec_attr->children[i]);
+    }
+}
+
+static void drop_all(void)
+{
+    while(state_p->lru_head) list_free(state_p->lru_head);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file lv_obj_draw_list.h
+ *
+ */
+
+#ifndef LV_OBJ_DRAW_LIST_H
+#define LV_OBJ_DRAW_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../misc/lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Usage of the draw lists*/
+typedef struct {
+    uint32_t size;              /**< Memory budget in bytes, 0 if the draw lists are disabled*/
+    uint32_t used;              /**< Bytes used by the recorded lists now*/
+    uint32_t max_used;          /**< The most bytes used at once*/
+    uint32_t list_cnt;          /**< Recorded lists now*/
+    uint32_t record_cnt;        /**< Lists recorded*/
+    uint32_t replay_cnt;        /**< Lists replayed instead of sending the draw events*/
+    uint32_t replay_task_cnt;   /**< Draw tasks added by the replays*/
+    uint32_t skip_cnt;          /**< Recordings dropped as they can't be replayed or don't fit*/
+    uint32_t evict_cnt;         /**< Lists freed to make room for new ones*/
+} lv_obj_draw_list_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Set the memory budget of the draw lists.
+ * When a widget is drawn, the draw tasks added by its draw events are recorded, and while the
+ * widget is not invalidated and is drawn at the same place to the same or a smaller clip area,
+ * the draw tasks are added again from the recorded list without sending the draw events.
+ * It saves the CPU time of getting the style properties and building the draw descriptors of the
+ * widgets which are redrawn only because something around or on top of them changes.
+ * Widgets with `LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS` or a draw event handler are always drawn as usual.
+ * When a new list doesn't fit, the least recently replayed ones are freed.
+ * @param new_size  the new size in bytes, 0 to disable the draw lists and free them
+ */
+void lv_obj_draw_list_resize(uint32_t new_size);
+
+/**
+ * Free the recorded draw lists of a widget and its children. They will be recorded again when
+ * they are drawn the next time.
+ * Needed only if the drawing of a widget changed without invalidating it.
+ * @param obj       pointer to a widget, or NULL to free the lists of all widgets
+ */
+void lv_obj_draw_list_drop(const lv_obj_t * obj);
+
+/**
+ * Get the usage of the draw lists since they were enabled or since `lv_obj_draw_list_reset_stats()`
+ * @param stats     store the statistics here
+ */
+void lv_obj_draw_list_get_stats(lv_obj_draw_list_stats_t * stats);
+
+/**
+ * Restart the counters and the high-water mark of the draw lists
+ */
+void lv_obj_draw_list_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OBJ_DRAW_LIST_H*/
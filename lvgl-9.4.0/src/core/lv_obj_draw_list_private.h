@@ -0,0 +1,139 @@
+/**
+ * @file lv_obj_draw_list_private.h
+ *
+ */
+
+#ifndef LV_OBJ_DRAW_LIST_PRIVATE_H
+#define LV_OBJ_DRAW_LIST_PRIVATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_obj_draw_list.h"
+#include "../misc/lv_area.h"
+#include "../misc/lv_color.h"
+#include "../draw/lv_draw.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#ifndef LV_OBJ_DRAW_LIST_DEF_SIZE
+#define LV_OBJ_DRAW_LIST_DEF_SIZE 0     /**< Default memory budget of the draw lists in bytes*/
+#endif
+
+#ifndef LV_OBJ_DRAW_LIST_BUCKET_CNT
+#define LV_OBJ_DRAW_LIST_BUCKET_CNT 64  /**< Buckets of the widget -> lists hash table, a power of 2*/
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    LV_OBJ_DRAW_LIST_PHASE_MAIN,    /**< `LV_EVENT_DRAW_MAIN_BEGIN` ... `LV_EVENT_DRAW_MAIN_END`*/
+    LV_OBJ_DRAW_LIST_PHASE_POST,    /**< `LV_EVENT_DRAW_POST_BEGIN` ... `LV_EVENT_DRAW_POST_END`*/
+} lv_obj_draw_list_phase_t;
+
+/** The draw tasks added by the draw events of a widget in a draw phase.
+ * The recorded tasks follow it in the same allocation.*/
+typedef struct _lv_obj_draw_list_t {
+    struct _lv_obj_draw_list_t * bucket_next;   /**< The next list in the same hash bucket*/
+    struct _lv_obj_draw_list_t * lru_prev;      /**< More recently replayed*/
+    struct _lv_obj_draw_list_t * lru_next;      /**< Less recently replayed*/
+    lv_obj_t * obj;
+    /*The key: drawn to the same place in the same way*/
+    lv_area_t clip_area;        /**< Recorded to this clip area, replayed for it or a part of it*/
+    lv_area_t coords;
+    lv_color_format_t color_format;
+    lv_opa_t opa;
+    lv_color32_t recolor;       /**< Of the layer, set by the ancestors too: not dropped when they are restyled*/
+    uint8_t phase;
+    uint32_t size;              /**< Size of the allocation*/
+    uint32_t task_cnt;
+} lv_obj_draw_list_t;
+
+/** State of the draw lists*/
+typedef struct {
+    lv_obj_draw_list_t ** buckets;  /**< The lists by widget, allocated while the draw lists are enabled*/
+    lv_obj_draw_list_t * lru_head;
+    lv_obj_draw_list_t * lru_tail;
+    uint32_t size;              /**< The memory budget*/
+    uint32_t used;
+
+    /*Recording*/
+    lv_layer_t * rec_layer;     /**< NULL if no recording is running*/
+    lv_area_t rec_clip_area;    /**< The real clip area of the widget, restored when the recording ends*/
+    lv_obj_draw_list_t rec_key;
+    uint8_t * rec_buf;          /**< The list being recorded, it becomes the new list*/
+    uint32_t rec_buf_size;
+    uint32_t rec_used;
+    uint32_t rec_task_cnt;
+    bool rec_invalid;           /**< Something was drawn which can't be replayed*/
+
+    lv_obj_draw_list_stats_t stats;
+} lv_obj_draw_list_state_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the draw lists
+ * @param size      the memory budget in bytes
+ */
+void lv_obj_draw_list_init(uint32_t size);
+
+/**
+ * Free the draw lists
+ */
+void lv_obj_draw_list_deinit(void);
+
+/**
+ * Add the recorded draw tasks of a widget's draw phase if there is a matching list.
+ * Else start recording the draw tasks added by its draw events if the widget can be recorded.
+ * While recording, the clip area of the layer is the whole widget.
+ * @param layer     the layer to draw to, its clip area is already set for the widget
+ * @param obj       the widget to draw
+ * @param phase     the draw phase
+ * @return          true: replayed, don't send the draw events; false: send the draw events and
+ *                  call `lv_obj_draw_list_record_end()`
+ */
+bool lv_obj_draw_list_replay(lv_layer_t * layer, lv_obj_t * obj, lv_obj_draw_list_phase_t phase);
+
+/**
+ * Finish the recording started by `lv_obj_draw_list_replay()` and store the list
+ * @param layer     the layer passed to `lv_obj_draw_list_replay()`
+ * @param obj       the widget passed to `lv_obj_draw_list_replay()`
+ */
+void lv_obj_draw_list_record_end(lv_layer_t * layer, lv_obj_t * obj);
+
+/**
+ * Record a draw task if a recording is running and clip it to the clip area of the widget.
+ * Called when the draw task is created, before it's dispatched.
+ * @param layer     the layer of the draw task
+ * @param t         the new draw task
+ * @param dsc_size  size of its draw descriptor
+ */
+void lv_obj_draw_list_record_task(lv_layer_t * layer, lv_draw_task_t * t, size_t dsc_size);
+
+/**
+ * Free the lists of a widget as it was invalidated or it's being deleted
+ * @param obj       pointer to a widget
+ */
+void lv_obj_draw_list_invalidate(const lv_obj_t * obj);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OBJ_DRAW_LIST_PRIVATE_H*/
@@ -12,6 +12,8 @@
 #include "lv_obj_draw_private.h"
 #include "lv_obj_style_private.h"
 #include "lv_obj_private.h"
+#include "lv_obj_render_cache_private.h"
+#include "lv_obj_draw_list_private.h"
 #include "../display/lv_display.h"
 #include "../display/lv_display_private.h"
 #include "lv_refr_private.h"
@@ -835,6 +837,10 @@ void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+    /*Even if it's not visible now, the cached rendering of the widget and its parents is outdated*/
+    lv_obj_render_cache_invalidate(obj);
+    lv_obj_draw_list_invalidate(obj);
+
     lv_display_t * disp   = lv_obj_get_display(obj);
     if(!lv_display_is_invalidation_enabled(disp)) return;
 
@@ -76,6 +76,9 @@ struct _lv_obj_t {
     uint16_t h_layout   : 1;
     uint16_t w_layout   : 1;
     uint16_t is_deleting : 1;
+    uint16_t render_cache : 1;
+    uint16_t draw_list_skip : 1;    /**< Its draw tasks can't be recorded until it's invalidated*/
+    uint16_t draw_list_seen : 1;    /**< Drawn once since it was invalidated*/
 };
 
 /**********************
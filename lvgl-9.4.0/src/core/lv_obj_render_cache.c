@@ -0,0 +1,329 @@
+/**
+ * @file lv_obj_render_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_obj_render_cache_private.h"
+#include "lv_obj_private.h"
+#include "lv_obj_draw_private.h"
+#include "lv_obj_event_private.h"
+#include "lv_refr_private.h"
+#include "lv_global.h"
+#include "../display/lv_display_private.h"
+#include "../draw/lv_draw_private.h"
+#include "../misc/lv_area_private.h"
+#include "../misc/cache/lv_cache.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS (&lv_obj_class)
+
+#define CACHE_NAME  "OBJ_RENDER"
+
+#define render_cache_p (LV_GLOBAL_DEFAULT()->obj_render_cache)
+#define acquired_p (&LV_GLOBAL_DEFAULT()->obj_render_cache_acquired)
+#define obj_cnt (LV_GLOBAL_DEFAULT()->obj_render_cache_cnt)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static lv_cache_entry_t * render(lv_obj_t * obj, const lv_area_t * area, int32_t ext_draw_size,
+                                 lv_color_format_t layer_cf);
+static uint32_t get_pinned_size(void);
+static lv_cache_compare_res_t render_cache_compare_cb(const lv_obj_render_cache_data_t * lhs,
+                                                      const lv_obj_render_cache_data_t * rhs);
+static void render_cache_free_cb(lv_obj_render_cache_data_t * data, void * user_data);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_obj_render_cache_init(uint32_t size)
+{
+    if(render_cache_p != NULL) return;
+
+    render_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(lv_obj_render_cache_data_t), size, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t) render_cache_compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t) render_cache_free_cb,
+    });
+    lv_cache_set_name(render_cache_p, CACHE_NAME);
+
+    lv_array_init(acquired_p, 8, sizeof(lv_cache_entry_t *));
+    obj_cnt = 0;
+}
+
+void lv_obj_render_cache_deinit(void)
+{
+    if(render_cache_p == NULL) return;
+
+    lv_obj_render_cache_refr_ready();
+    lv_array_deinit(acquired_p);
+    lv_cache_destroy(render_cache_p, NULL);
+    render_cache_p = NULL;
+}
+
+void lv_obj_set_render_cache(lv_obj_t * obj, bool en)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    if(obj->render_cache == en) return;
+
+    if(en) {
+        obj_cnt++;
+    }
+    else {
+        lv_obj_render_cache_drop(obj);
+        obj_cnt--;
+    }
+    obj->render_cache = en;
+}
+
+bool lv_obj_get_render_cache(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    return obj->render_cache;
+}
+
+void lv_obj_render_cache_resize(uint32_t new_size, bool evict_now)
+{
+    if(render_cache_p == NULL) return;
+
+    lv_cache_set_max_size(render_cache_p, new_size, NULL);
+    if(evict_now) {
+        lv_cache_reserve(render_cache_p, new_size, NULL);
+    }
+}
+
+void lv_obj_render_cache_drop(const lv_obj_t * obj)
+{
+    if(render_cache_p == NULL) return;
+
+    if(obj == NULL) {
+        lv_cache_drop_all(render_cache_p, NULL);
+        return;
+    }
+
+    lv_obj_render_cache_data_t search_key;
+    search_key.obj = obj;
+    lv_cache_drop(render_cache_p, &search_key, NULL);
+}
+
+lv_result_t lv_obj_render_cache_draw(lv_layer_t * layer, lv_obj_t * obj)
+{
+#if LV_DRAW_TRANSFORM_USE_MATRIX
+    LV_UNUSED(layer);
+    LV_UNUSED(obj);
+    return LV_RESULT_INVALID;
+#else
+    if(render_cache_p == NULL || lv_cache_get_max_size(render_cache_p, NULL) == 0) return LV_RESULT_INVALID;
+
+    /*The buffer is rendered without the opacity and recolor the layer would apply*/
+    if(layer->opa < LV_OPA_MAX || layer->recolor.alpha > LV_OPA_MIN) return LV_RESULT_INVALID;
+
+    int32_t ext_draw_size = lv_obj_get_ext_draw_size(obj);
+    lv_area_t area = obj->coords;
+    lv_area_increase(&area, ext_draw_size, ext_draw_size);
+    if(!lv_area_is_on(&area, &layer->_clip_area)) return LV_RESULT_OK;
+
+    LV_PROFILER_REFR_BEGIN;
+
+    lv_obj_render_cache_data_t search_key;
+    search_key.obj = obj;
+    lv_cache_entry_t * entry = lv_cache_acquire(render_cache_p, &search_key, NULL);
+    if(entry) {
+        /*Moving the widget (e.g. scrolling its parent) keeps the buffer, resizing it doesn't*/
+        lv_obj_render_cache_data_t * data = lv_cache_entry_get_data(entry);
+        if(data->ext_draw_size != ext_draw_size ||
+           data->draw_buf->header.w != lv_area_get_width(&area) ||
+           data->draw_buf->header.h != lv_area_get_height(&area)) {
+            lv_cache_release(render_cache_p, entry, NULL);
+            lv_cache_drop(render_cache_p, &search_key, NULL);
+            entry = NULL;
+        }
+    }
+
+    if(entry == NULL) {
+        entry = render(obj, &area, ext_draw_size, layer->color_format);
+        if(entry == NULL) {
+            LV_PROFILER_REFR_END;
+            return LV_RESULT_INVALID;
+        }
+    }
+
+    /*Keep the buffer until the draw task is ready*/
+    lv_array_push_back(acquired_p, &entry);
+
+    lv_obj_render_cache_data_t * data = lv_cache_entry_get_data(entry);
+    lv_draw_image_dsc_t draw_dsc;
+    lv_draw_image_dsc_init(&draw_dsc);
+    draw_dsc.src = data->draw_buf;
+    lv_draw_image(layer, &draw_dsc, &area);
+
+    LV_PROFILER_REFR_END;
+    return LV_RESULT_OK;
+#endif
+}
+
+void lv_obj_render_cache_invalidate(const lv_obj_t * obj)
+{
+    if(obj_cnt == 0 || render_cache_p == NULL) return;
+
+    while(obj) {
+        if(obj->render_cache) lv_obj_render_cache_drop(obj);
+        obj = obj->parent;
+    }
+}
+
+void lv_obj_render_cache_refr_ready(void)
+{
+    if(render_cache_p == NULL) return;
+
+    uint32_t i;
+    uint32_t cnt = lv_array_size(acquired_p);
+    for(i = 0; i < cnt; i++) {
+        lv_cache_entry_t ** entry = lv_array_at(acquired_p, i);
+        lv_cache_release(render_cache_p, *entry, NULL);
+    }
+    lv_array_clear(acquired_p);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Render a widget into a new cached buffer
+ * @param obj           pointer to a widget
+ * @param area          the area of the widget increased by `ext_draw_size`
+ * @param ext_draw_size the extended draw size of the widget
+ * @param layer_cf      color format of the layer the buffer will be drawn to
+ * @return              the acquired cache entry or NULL if the buffer doesn't fit into the cache
+ */
+static lv_cache_entry_t * render(lv_obj_t * obj, const lv_area_t * area, int32_t ext_draw_size,
+                                 lv_color_format_t layer_cf)
+{
+    /*If the widget covers its whole area no alpha channel is needed.
+     *Render it as it would be rendered to the layer, so copying the buffer gives the same pixels.*/
+    lv_color_format_t cf = LV_COLOR_FORMAT_ARGB8888;
+    if(ext_draw_size == 0) {
+        lv_cover_check_info_t info;
+        info.res = LV_COVER_RES_COVER;
+        info.area = area;
+        lv_obj_send_event(obj, LV_EVENT_COVER_CHECK, &info);
+        if(info.res == LV_COVER_RES_COVER) cf = layer_cf;
+    }
+
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    lv_obj_render_cache_data_t search_key;
+    search_key.obj = obj;
+    search_key.draw_buf = NULL;
+    search_key.slot.size = lv_draw_buf_width_to_stride(w, cf) * h;
+    /*The buffers drawn in this refresh can't be evicted*/
+    if(search_key.slot.size + get_pinned_size() > lv_cache_get_max_size(render_cache_p, NULL)) {
+        LV_LOG_INFO("%" LV_PRId32 "x%" LV_PRId32 " px don't fit into the render cache", w, h);
+        return NULL;
+    }
+
+    /*Evict the least recently used buffers before allocating the new one*/
+    lv_cache_entry_t * entry = lv_cache_add(render_cache_p, &search_key, NULL);
+    if(entry == NULL) return NULL;
+
+    lv_obj_render_cache_data_t * data = lv_cache_entry_get_data(entry);
+    data->ext_draw_size = ext_draw_size;
+    data->draw_buf = lv_draw_buf_create(w, h, cf, LV_STRIDE_AUTO);
+    if(data->draw_buf == NULL) {
+        LV_LOG_WARN("No memory for the render cache of %" LV_PRId32 "x%" LV_PRId32 " px", w, h);
+        lv_cache_release(render_cache_p, entry, NULL);
+        lv_cache_drop(render_cache_p, &search_key, NULL);
+        return NULL;
+    }
+    if(cf == LV_COLOR_FORMAT_ARGB8888) lv_draw_buf_clear(data->draw_buf, NULL);
+
+    lv_layer_t layer;
+    lv_layer_init(&layer);
+    layer.draw_buf = data->draw_buf;
+    layer.buf_area = *area;
+    layer.color_format = cf;
+    layer._clip_area = *area;
+    layer.phy_clip_area = *area;
+
+    /*Render only this layer (and the layers created in it) until it's ready, like a snapshot*/
+    lv_display_t * disp = lv_obj_get_display(obj);
+    lv_layer_t * layer_head_ori = disp->layer_head;
+    disp->layer_head = &layer;
+
+    lv_obj_redraw(&layer, obj);
+    while(layer.draw_task_head) {
+        lv_draw_dispatch_wait_for_request();
+        lv_draw_dispatch();
+    }
+
+    disp->layer_head = layer_head_ori;
+
+    return entry;
+}
+
+/**
+ * Get the size of the cached buffers drawn in the current refresh
+ * @return      the size in bytes
+ */
+static uint32_t get_pinned_size(void)
+{
+    uint32_t size = 0;
+    uint32_t cnt = lv_array_size(acquired_p);
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        lv_cache_entry_t * entry = *(lv_cache_entry_t **)lv_array_at(acquired_p, i);
+        /*Dropped ones are not counted by the cache anymore*/
+        if(lv_cache_entry_is_invalid(entry)) continue;
+
+        /*A buffer drawn in several strips is acquired several times*/
+        uint32_t j;
+        for(j = 0; j < i; j++) {
+            if(*(lv_cache_entry_t **)lv_array_at(acquired_p, j) == entry) break;
+        }
+        if(j < i) continue;
+
+        lv_obj_render_cache_data_t * data = lv_cache_entry_get_data(entry);
+        size += data->slot.size;
+    }
+    return size;
+}
+
+static lv_cache_compare_res_t render_cache_compare_cb(const lv_obj_render_cache_data_t * lhs,
+                                                      const lv_obj_render_cache_data_t * rhs)
+{
+    if(lhs->obj != rhs->obj) {
+        return lhs->obj > rhs->obj ? 1 : -1;
+    }
+    return 0;
+}
+
+static void render_cache_free_cb(lv_obj_render_cache_data_t * data, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    if(data->draw_buf) lv_draw_buf_destroy(data->draw_buf);
+    data->draw_buf = NULL;
+}
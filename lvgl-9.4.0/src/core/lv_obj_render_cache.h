@@ -0,0 +1,74 @@
+/**
+ * @file lv_obj_render_cache.h
+ *
+ */
+
+#ifndef LV_OBJ_RENDER_CACHE_H
+#define LV_OBJ_RENDER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../misc/lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Render a widget and its children once into a cached draw buffer and draw only that buffer
+ * in the later refreshes, until the widget or one of its children is invalidated.
+ * Good for static subtrees which are expensive to draw (shadows, gradients, rounded corners)
+ * and are redrawn only because something on top of them changes.
+ * The cache is used only if the widget has no transformation, opacity or recolor (on itself or
+ * its parents). The draw events of the subtree are sent only when the cache is rendered.
+ * The buffer is in the native color format if the widget covers its whole area, else ARGB8888.
+ * @param obj       pointer to a widget
+ * @param en        true: enable the render cache; false: disable it and free the cached buffer
+ */
+void lv_obj_set_render_cache(lv_obj_t * obj, bool en);
+
+/**
+ * Get whether the render cache is enabled on a widget
+ * @param obj       pointer to a widget
+ * @return          true: the render cache is enabled
+ */
+bool lv_obj_get_render_cache(const lv_obj_t * obj);
+
+/**
+ * Set the memory budget of the cached buffers of all widgets.
+ * When a new buffer doesn't fit, the least recently drawn ones are freed.
+ * A widget whose buffer doesn't fit at all is drawn as usual.
+ * @param new_size  the new size in bytes, 0 to disable the render cache
+ * @param evict_now true: free buffers now to fit the new size; false: only when a new buffer is added
+ */
+void lv_obj_render_cache_resize(uint32_t new_size, bool evict_now);
+
+/**
+ * Free the cached buffer of a widget. It will be rendered again when it's drawn the next time.
+ * Needed only if the drawing of the widget changed without invalidating it.
+ * @param obj       pointer to a widget, or NULL to free the buffers of all widgets
+ */
+void lv_obj_render_cache_drop(const lv_obj_t * obj);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OBJ_RENDER_CACHE_H*/
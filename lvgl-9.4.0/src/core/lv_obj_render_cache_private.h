@@ -0,0 +1,83 @@
+/**
+ * @file lv_obj_render_cache_private.h
+ *
+ */
+
+#ifndef LV_OBJ_RENDER_CACHE_PRIVATE_H
+#define LV_OBJ_RENDER_CACHE_PRIVATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_obj_render_cache.h"
+#include "../misc/cache/lv_cache_private.h"
+#include "../draw/lv_draw_buf.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#ifndef LV_OBJ_RENDER_CACHE_DEF_SIZE
+#define LV_OBJ_RENDER_CACHE_DEF_SIZE (64 * 1024) /**< Default memory budget of the render cache in bytes */
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** A cached rendering of a widget*/
+typedef struct {
+    lv_cache_slot_size_t slot;
+    const lv_obj_t * obj;       /**< The key*/
+    lv_draw_buf_t * draw_buf;
+    int32_t ext_draw_size;      /**< The buffer is the widget's area increased by this size*/
+} lv_obj_render_cache_data_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create the render cache
+ * @param size      the memory budget in bytes
+ */
+void lv_obj_render_cache_init(uint32_t size);
+
+/**
+ * Free the render cache
+ */
+void lv_obj_render_cache_deinit(void);
+
+/**
+ * Draw a widget from its cached buffer, rendering the buffer first if it's not cached yet
+ * @param layer     the layer to draw to
+ * @param obj       a widget with the render cache enabled
+ * @return          LV_RESULT_OK: drawn; LV_RESULT_INVALID: can't be cached now, draw it as usual
+ */
+lv_result_t lv_obj_render_cache_draw(lv_layer_t * layer, lv_obj_t * obj);
+
+/**
+ * Free the cached buffers of a widget and its parents as the widget was invalidated
+ * @param obj       pointer to a widget
+ */
+void lv_obj_render_cache_invalidate(const lv_obj_t * obj);
+
+/**
+ * Release the buffers drawn during a refresh. Call when all draw tasks of the refresh are ready.
+ */
+void lv_obj_render_cache_refr_ready(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OBJ_RENDER_CACHE_PRIVATE_H*/
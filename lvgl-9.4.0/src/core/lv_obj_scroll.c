@@ -9,10 +9,15 @@
 #include "lv_obj_scroll_private.h"
 #include "../misc/lv_anim_private.h"
 #include "lv_obj_private.h"
+#include "lv_obj_draw_private.h"
+#include "lv_obj_render_cache_private.h"
+#include "lv_refr_private.h"
 #include "../indev/lv_indev.h"
 #include "../indev/lv_indev_scroll.h"
 #include "../display/lv_display.h"
 #include "../misc/lv_area.h"
+#include "../misc/lv_area_private.h"
+#include "../misc/lv_event_private.h"
 
 /*********************
  *      DEFINES
@@ -38,6 +43,11 @@ static void scroll_y_anim(void * obj, int32_t v);
 static void scroll_end_cb(lv_anim_t * a);
 static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_point_t * scroll_value,
                                   lv_anim_enable_t anim_en);
+static lv_result_t scroll_blit(lv_obj_t * obj, int32_t dx, int32_t dy, const lv_area_t old_scrollbars[2]);
+static bool scroll_blit_can_draw(lv_obj_t * obj);
+static void get_overlay_area(lv_obj_t * obj, lv_area_t * area);
+static void inv_overlay(lv_display_t * disp, const lv_area_t * blit_area, const lv_area_t * area, int32_t dx,
+                        int32_t dy);
 
 /**********************
  *  STATIC VARIABLES
@@ -416,16 +426,33 @@ lv_result_t lv_obj_scroll_by_raw(lv_obj_t * obj, int32_t x, int32_t y)
 
     lv_obj_allocate_spec_attr(obj);
 
+    /*The scrollbars are moved with the pixels, they are redrawn where they get*/
+    lv_area_t old_scrollbars[2];
+    bool blit = lv_display_get_scroll_blit(lv_obj_get_display(obj));
+    if(blit) {
+        /*The pixels are moved as they are drawn with the current layout*/
+        lv_obj_update_layout(obj);
+        lv_obj_get_scrollbar_area(obj, &old_scrollbars[0], &old_scrollbars[1]);
+    }
+
     obj->spec_attr->scroll.x += x;
     obj->spec_attr->scroll.y += y;
 
     lv_obj_move_children_by(obj, x, y, true);
     lv_result_t res = lv_obj_send_event(obj, LV_EVENT_SCROLL, NULL);
     if(res != LV_RESULT_OK) return res;
-    lv_obj_invalidate(obj);
+    if(!blit || scroll_blit(obj, x, y, old_scrollbars) != LV_RESULT_OK) lv_obj_invalidate(obj);
     return LV_RESULT_OK;
 }
 
+void lv_obj_invalidate_scrollbars(lv_obj_t * obj)
+{
+    lv_area_t hor_area, ver_area;
+    lv_obj_get_scrollbar_area(obj, &hor_area, &ver_area);
+    lv_obj_invalidate_area(obj, &hor_area);
+    lv_obj_invalidate_area(obj, &ver_area);
+}
+
 bool lv_obj_is_scrolling(const lv_obj_t * obj)
 {
     lv_indev_t * indev = lv_indev_get_next(NULL);
@@ -811,3 +838,214 @@ static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_p
     scroll_value->y += anim_en ? y_scroll : 0;
     lv_obj_scroll_by(parent, x_scroll, y_scroll, anim_en);
 }
+
+/**
+ * Move the rendered pixels of a scrolled widget instead of invalidating it (see `lv_display_set_scroll_blit`)
+ * @param obj               the scrolled widget, its children are already moved
+ * @param dx                the children moved this many pixels to the right
+ * @param dy                the children moved this many pixels down
+ * @param old_scrollbars    the horizontal and vertical scrollbar before scrolling
+ * @return                  LV_RESULT_OK: moved; LV_RESULT_INVALID: invalidate the widget as usual
+ */
+static lv_result_t scroll_blit(lv_obj_t * obj, int32_t dx, int32_t dy, const lv_area_t old_scrollbars[2])
+{
+#if LV_DRAW_TRANSFORM_USE_MATRIX
+    LV_UNUSED(obj);
+    LV_UNUSED(dx);
+    LV_UNUSED(dy);
+    LV_UNUSED(old_scrollbars);
+    return LV_RESULT_INVALID;
+#else
+    /*Only the widgets drawn over the active screen are known. It's drawn as it is now in the next refresh.*/
+    lv_display_t * disp = lv_obj_get_display(obj);
+    lv_obj_t * scr = lv_obj_get_screen(obj);
+    if(lv_display_get_screen_prev(disp) || scr->scr_layout_inv) return LV_RESULT_INVALID;
+    if(scr != lv_display_get_screen_active(disp) && scr != lv_display_get_layer_top(disp) &&
+       scr != lv_display_get_layer_sys(disp)) {
+        return LV_RESULT_INVALID;
+    }
+
+    if(!scroll_blit_can_draw(obj)) return LV_RESULT_INVALID;
+
+    /*Inside the border and, along the scrolling, the rounded corners*/
+    int32_t w = lv_obj_get_width(obj);
+    int32_t h = lv_obj_get_height(obj);
+    int32_t radius = LV_MIN(lv_obj_get_style_radius(obj, LV_PART_MAIN), LV_MIN(w, h) / 2);
+    int32_t border = lv_obj_get_style_border_width(obj, LV_PART_MAIN);
+    lv_area_t area = obj->coords;
+    lv_area_increase(&area, -(dx ? LV_MAX(border, radius) : border), -(dy ? LV_MAX(border, radius) : border));
+
+    lv_area_t scr_area;
+    lv_area_set(&scr_area, 0, 0, lv_display_get_horizontal_resolution(disp) - 1,
+                lv_display_get_vertical_resolution(disp) - 1);
+    if(!lv_area_intersect(&area, &area, &scr_area)) return LV_RESULT_INVALID;
+    if(!lv_obj_area_is_visible(obj, &area)) return LV_RESULT_INVALID;
+
+    if(lv_inv_scroll(disp, &area, dx, dy) != LV_RESULT_OK) return LV_RESULT_INVALID;
+
+    lv_obj_render_cache_invalidate(obj);
+
+    /*The frame around the moved area*/
+    lv_area_t frame;
+    int32_t ext_size = lv_obj_get_ext_draw_size(obj);
+    lv_area_copy(&frame, &obj->coords);
+    lv_area_increase(&frame, ext_size, ext_size);
+    lv_area_t frame_parts[4];
+    int8_t part_cnt = lv_area_diff(frame_parts, &frame, &area);
+    int8_t p;
+    for(p = 0; p < part_cnt; p++) {
+        lv_obj_invalidate_area(obj, &frame_parts[p]);
+    }
+
+    /*The old scrollbars where they were moved to, and the new ones*/
+    lv_area_t scrollbars[2];
+    lv_obj_get_scrollbar_area(obj, &scrollbars[0], &scrollbars[1]);
+    for(p = 0; p < 2; p++) {
+        lv_area_t moved = old_scrollbars[p];
+        lv_area_move(&moved, dx, dy);
+        if(lv_area_get_size(&old_scrollbars[p]) > 0) inv_overlay(disp, &area, &moved, 0, 0);
+        if(lv_area_get_size(&scrollbars[p]) > 0) inv_overlay(disp, &area, &scrollbars[p], 0, 0);
+    }
+
+    /*The floating children don't move*/
+    lv_area_t overlay;
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_count(obj);
+    for(i = 0; i < child_cnt; i++) {
+        lv_obj_t * child = obj->spec_attr->children[i];
+        if(!lv_obj_has_flag(child, LV_OBJ_FLAG_FLOATING) || lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+        get_overlay_area(child, &overlay);
+        inv_overlay(disp, &area, &overlay, dx, dy);
+    }
+
+    /*The widgets drawn later over it and the scrollbars of the parents don't move either*/
+    lv_obj_t * child = obj;
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    while(parent) {
+        lv_obj_get_scrollbar_area(parent, &scrollbars[0], &scrollbars[1]);
+        for(p = 0; p < 2; p++) {
+            if(lv_area_get_size(&scrollbars[p]) > 0) inv_overlay(disp, &area, &scrollbars[p], dx, dy);
+        }
+
+        child_cnt = lv_obj_get_child_count(parent);
+        for(i = lv_obj_get_index(child) + 1; i < child_cnt; i++) {
+            lv_obj_t * sibling = parent->spec_attr->children[i];
+            if(lv_obj_has_flag(sibling, LV_OBJ_FLAG_HIDDEN)) continue;
+            get_overlay_area(sibling, &overlay);
+            inv_overlay(disp, &area, &overlay, dx, dy);
+        }
+        child = parent;
+        parent = lv_obj_get_parent(parent);
+    }
+
+    lv_obj_t * layers[2] = {lv_display_get_layer_top(disp), lv_display_get_layer_sys(disp)};
+    for(p = scr == layers[0] ? 1 : 0; p < 2; p++) {
+        if(scr == layers[p]) break;
+        if(lv_obj_has_flag(layers[p], LV_OBJ_FLAG_HIDDEN)) continue;
+        if(lv_obj_get_style_bg_opa(layers[p], LV_PART_MAIN) > LV_OPA_TRANSP) {
+            inv_overlay(disp, &area, &layers[p]->coords, dx, dy);
+        }
+        child_cnt = lv_obj_get_child_count(layers[p]);
+        for(i = 0; i < child_cnt; i++) {
+            lv_obj_t * layer_child = layers[p]->spec_attr->children[i];
+            if(lv_obj_has_flag(layer_child, LV_OBJ_FLAG_HIDDEN)) continue;
+            get_overlay_area(layer_child, &overlay);
+            inv_overlay(disp, &area, &overlay, dx, dy);
+        }
+    }
+
+    return LV_RESULT_OK;
+#endif
+}
+
+/**
+ * Check if a scrolled widget's area is drawn only by its children and a plain background,
+ * and if it's blended directly to the display by its parents
+ * @param obj       the scrolled widget
+ * @return          true: the pixels of its children can be moved
+ */
+static bool scroll_blit_can_draw(lv_obj_t * obj)
+{
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return false;
+    if(lv_obj_get_style_opa_recursive(obj, LV_PART_MAIN) < LV_OPA_MAX) return false;
+
+    if(lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) < LV_OPA_MAX ||
+       lv_obj_get_style_bg_grad_dir(obj, LV_PART_MAIN) != LV_GRAD_DIR_NONE ||
+       lv_obj_get_style_bg_grad(obj, LV_PART_MAIN) != NULL ||
+       lv_obj_get_style_bg_image_src(obj, LV_PART_MAIN) != NULL) {
+        return false;
+    }
+    if(lv_obj_get_style_outline_width(obj, LV_PART_MAIN) > 0 && lv_obj_get_style_outline_pad(obj, LV_PART_MAIN) < 0) {
+        return false;
+    }
+
+    lv_obj_t * parent;
+    for(parent = obj; parent; parent = lv_obj_get_parent(parent)) {
+        /*Other widgets may draw anything over their children*/
+        if(parent->class_p != &lv_obj_class) return false;
+        if(lv_obj_get_layer_type(parent) != LV_LAYER_TYPE_NONE) return false;
+        if(lv_obj_get_style_transform_width(parent, LV_PART_MAIN) != 0 ||
+           lv_obj_get_style_transform_height(parent, LV_PART_MAIN) != 0) {
+            return false;
+        }
+        if(parent != obj && lv_obj_get_style_border_post(parent, LV_PART_MAIN)) return false;
+
+        /*The widget's own drawing and what the parents draw after their children*/
+        lv_event_code_t first = parent == obj ? LV_EVENT_DRAW_MAIN_BEGIN : LV_EVENT_DRAW_POST_BEGIN;
+        uint32_t event_cnt = lv_obj_get_event_count(parent);
+        uint32_t i;
+        for(i = 0; i < event_cnt; i++) {
+            lv_event_code_t filter = lv_obj_get_event_dsc(parent, i)->filter & ~LV_EVENT_PREPROCESS;
+            if(filter == LV_EVENT_ALL || (filter >= first && filter <= LV_EVENT_DRAW_POST_END)) return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get the area a widget and its overflowing children draw to
+ * @param obj       pointer to a widget
+ * @param area      store the area here
+ */
+static void get_overlay_area(lv_obj_t * obj, lv_area_t * area)
+{
+    int32_t ext_size = lv_obj_get_ext_draw_size(obj);
+    lv_area_copy(area, &obj->coords);
+    lv_area_increase(area, ext_size, ext_size);
+
+    /*Anywhere*/
+    if(lv_obj_get_layer_type(obj) == LV_LAYER_TYPE_TRANSFORM) {
+        lv_area_set(area, LV_COORD_MIN, LV_COORD_MIN, LV_COORD_MAX, LV_COORD_MAX);
+        return;
+    }
+
+    if(!lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return;
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_count(obj);
+    for(i = 0; i < child_cnt; i++) {
+        lv_area_t child_area;
+        get_overlay_area(obj->spec_attr->children[i], &child_area);
+        lv_area_join(area, area, &child_area);
+    }
+}
+
+/**
+ * Invalidate a widget drawn over a moved area, where it is and where its pixels are moved to
+ * @param disp      pointer to a display
+ * @param blit_area the moved area
+ * @param area      the area of the widget
+ * @param dx        horizontal offset of the moved pixels
+ * @param dy        vertical offset of the moved pixels
+ */
+static void inv_overlay(lv_display_t * disp, const lv_area_t * blit_area, const lv_area_t * area, int32_t dx,
+                        int32_t dy)
+{
+    lv_area_t inv;
+    if(lv_area_intersect(&inv, area, blit_area)) lv_inv_area(disp, &inv);
+    if(dx == 0 && dy == 0) return;
+
+    lv_area_t moved = *area;
+    lv_area_move(&moved, dx, dy);
+    if(lv_area_intersect(&inv, &moved, blit_area)) lv_inv_area(disp, &inv);
+}
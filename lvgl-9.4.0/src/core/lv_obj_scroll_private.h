@@ -39,6 +39,12 @@ extern "C" {
  */
 lv_result_t lv_obj_scroll_by_raw(lv_obj_t * obj, int32_t x, int32_t y);
 
+/**
+ * Invalidate the area of the scrollbars of an object
+ * @param obj       pointer to an object
+ */
+void lv_obj_invalidate_scrollbars(lv_obj_t * obj);
+
 /**********************
  *      MACROS
  **********************/
@@ -10,6 +10,7 @@
 #include "../misc/lv_anim_private.h"
 #include "lv_obj_style_private.h"
 #include "lv_obj_class_private.h"
+#include "lv_obj_scroll_private.h"
 #include "../display/lv_display.h"
 #include "../display/lv_display_private.h"
 #include "../misc/lv_color.h"
@@ -270,6 +271,13 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
 
     if(!style_refr) return;
 
+    /*If only the look of the scrollbars changes only they are redrawn*/
+    if(part == LV_PART_SCROLLBAR && prop != LV_STYLE_PROP_ANY &&
+       !lv_style_prop_has_flag(prop, LV_STYLE_PROP_FLAG_LAYOUT_UPDATE | LV_STYLE_PROP_FLAG_EXT_DRAW_UPDATE)) {
+        lv_obj_invalidate_scrollbars(obj);
+        return;
+    }
+
     LV_PROFILER_STYLE_BEGIN;
 
     lv_obj_invalidate(obj);
@@ -279,6 +287,9 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
     bool is_inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_FLAG_INHERITABLE);
     bool is_layer_refr = lv_style_prop_has_flag(prop, LV_STYLE_PROP_FLAG_LAYER_UPDATE);
 
+    /*The children are drawn with the inherited properties too*/
+    if(prop == LV_STYLE_PROP_ANY || is_inheritable) lv_obj_draw_list_drop(obj);
+
     if(is_layout_refr) {
         if(part == LV_PART_ANY ||
            part == LV_PART_MAIN ||
@@ -13,6 +13,8 @@
 #include "../draw/lv_draw_mask_private.h"
 #include "lv_obj_private.h"
 #include "lv_obj_event_private.h"
+#include "lv_obj_render_cache_private.h"
+#include "lv_obj_draw_list_private.h"
 #include "../display/lv_display.h"
 #include "../display/lv_display_private.h"
 #include "../tick/lv_tick.h"
@@ -40,6 +42,18 @@
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static uint64_t get_px_cost(lv_display_t * disp);
+static inline uint64_t get_area_cost(uint32_t window, uint64_t px_cost, const lv_area_t * area);
+static int32_t join_max_gap(lv_display_t * disp, uint64_t px_cost);
+static int32_t area_gap(const lv_area_t * a1_p, const lv_area_t * a2_p);
+static void sort_by_y1(const lv_area_t * areas, uint16_t * order, uint32_t cnt);
+static void inv_coalesce(lv_display_t * disp, const lv_area_t * scr_area);
+static void inv_join_aligned(lv_display_t * disp);
+static uint32_t inv_tiles_find(const uint32_t * row, uint32_t col, uint32_t cols, bool dirty);
+static bool scroll_blit_supported(lv_display_t * disp);
+static lv_result_t inv_scroll_pending(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy);
+static void refr_blit_display(void);
+static void refr_blit_draw_buf(void);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p, int32_t y_offset);
@@ -52,6 +66,7 @@ static void wait_for_flushing(lv_display_t * disp);
 static lv_result_t layer_get_area(lv_layer_t * layer, lv_obj_t * obj, lv_layer_type_t layer_type,
                                   lv_area_t * layer_area_out, lv_area_t * obj_draw_size_out);
 static bool alpha_test_area_on_obj(lv_obj_t * obj, const lv_area_t * area);
+static void draw_phase(lv_layer_t * layer, lv_obj_t * obj, lv_obj_draw_list_phase_t phase);
 #if LV_DRAW_TRANSFORM_USE_MATRIX
     static bool refr_check_obj_clip_overflow(lv_layer_t * layer, lv_obj_t * obj);
     static void refr_obj_matrix(lv_layer_t * layer, lv_obj_t * obj);
@@ -121,9 +136,7 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
     /*If the object is visible on the current clip area*/
     layer->_clip_area = clip_coords_for_obj;
 
-    lv_obj_send_event(obj, LV_EVENT_DRAW_MAIN_BEGIN, layer);
-    lv_obj_send_event(obj, LV_EVENT_DRAW_MAIN, layer);
-    lv_obj_send_event(obj, LV_EVENT_DRAW_MAIN_END, layer);
+    draw_phase(layer, obj, LV_OBJ_DRAW_LIST_PHASE_MAIN);
 #if LV_USE_REFR_DEBUG
     lv_color_t debug_color = lv_color_make(lv_rand(0, 0xFF), lv_rand(0, 0xFF), lv_rand(0, 0xFF));
     lv_draw_rect_dsc_t draw_dsc;
@@ -155,9 +168,7 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
         if(child_cnt == 0) {
             /*If the object was visible on the clip area call the post draw events too*/
             /*If all the children are redrawn make 'post draw' draw*/
-            lv_obj_send_event(obj, LV_EVENT_DRAW_POST_BEGIN, layer);
-            lv_obj_send_event(obj, LV_EVENT_DRAW_POST, layer);
-            lv_obj_send_event(obj, LV_EVENT_DRAW_POST_END, layer);
+            draw_phase(layer, obj, LV_OBJ_DRAW_LIST_PHASE_POST);
         }
         else {
             layer->_clip_area = clip_coords_for_children;
@@ -177,9 +188,7 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
 
                 /*If the object was visible on the clip area call the post draw events too*/
                 /*If all the children are redrawn make 'post draw' draw*/
-                lv_obj_send_event(obj, LV_EVENT_DRAW_POST_BEGIN, layer);
-                lv_obj_send_event(obj, LV_EVENT_DRAW_POST, layer);
-                lv_obj_send_event(obj, LV_EVENT_DRAW_POST_END, layer);
+                draw_phase(layer, obj, LV_OBJ_DRAW_LIST_PHASE_POST);
             }
             else {
                 lv_layer_t * layer_children;
@@ -205,9 +214,7 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
                     }
 
                     /*If all the children are redrawn send 'post draw' draw*/
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST_BEGIN, layer_children);
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST, layer_children);
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST_END, layer_children);
+                    draw_phase(layer_children, obj, LV_OBJ_DRAW_LIST_PHASE_POST);
 
                     lv_draw_mask_rect(layer_children, &mask_draw_dsc);
 
@@ -226,9 +233,7 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
                     }
 
                     /*If all the children are redrawn send 'post draw' draw*/
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST_BEGIN, layer_children);
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST, layer_children);
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST_END, layer_children);
+                    draw_phase(layer_children, obj, LV_OBJ_DRAW_LIST_PHASE_POST);
 
                     lv_draw_mask_rect(layer_children, &mask_draw_dsc);
 
@@ -248,9 +253,7 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
                     }
 
                     /*If all the children are redrawn make 'post draw' draw*/
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST_BEGIN, layer);
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST, layer);
-                    lv_obj_send_event(obj, LV_EVENT_DRAW_POST_END, layer);
+                    draw_phase(layer, obj, LV_OBJ_DRAW_LIST_PHASE_POST);
 
                 }
 
@@ -284,6 +287,11 @@ void lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+        disp->blit_pending = 0;
+        if(disp->inv_tiles_dirty) {
+            lv_memzero(disp->inv_tiles, disp->inv_tile_rows * disp->inv_tile_stride * sizeof(uint32_t));
+            disp->inv_tiles_dirty = 0;
+        }
         return;
     }
 
@@ -317,24 +325,110 @@ void lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
     lv_result_t res = lv_display_send_event(disp, LV_EVENT_INVALIDATE_AREA, &com_area);
     if(res != LV_RESULT_OK) return;
 
-    /*Save only if this area is not in one of the saved areas*/
-    uint16_t i;
-    for(i = 0; i < disp->inv_p; i++) {
-        if(lv_area_is_in(&com_area, &disp->inv_areas[i], 0) != false) return;
+    /*With dirty tiles just mark the tiles of the area*/
+    if(disp->inv_tiles) {
+        lv_display_mark_inv_tiles(disp, &com_area);
+        disp->inv_stats.saved++;
+        lv_display_send_event(disp, LV_EVENT_REFR_REQUEST, NULL);
+        return;
     }
 
-    /*Save the area*/
-    lv_area_t * tmp_area_p = &com_area;
-    if(disp->inv_p >= LV_INV_BUF_SIZE) { /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        tmp_area_p = &scr_area;
+    /*Save only if this area is not in one of the saved areas, and drop the saved areas which are in this one*/
+    uint32_t i = 0;
+    while(i < disp->inv_p) {
+        if(lv_area_is_in(&com_area, &disp->inv_areas[i], 0)) {
+            disp->inv_stats.dropped++;
+            return;
+        }
+        if(lv_area_is_in(&disp->inv_areas[i], &com_area, 0)) {
+            disp->inv_p--;
+            disp->inv_areas[i] = disp->inv_areas[disp->inv_p];
+            continue;
+        }
+        i++;
     }
-    lv_area_copy(&disp->inv_areas[disp->inv_p], tmp_area_p);
+
+    /*If no place for the area grow the buffer, or coalesce the saved areas when it's at its largest*/
+    if(disp->inv_p >= disp->inv_cap) {
+        uint32_t cap = LV_MIN(disp->inv_cap * 2, LV_INV_BUF_MAX);
+        if(cap <= disp->inv_cap || lv_display_resize_inv_buf(disp, cap) != LV_RESULT_OK) {
+            disp->inv_stats.overflows++;
+            inv_coalesce(disp, &scr_area);
+        }
+    }
+
+    /*Save the area*/
+    lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
     disp->inv_p++;
+    disp->inv_stats.saved++;
+    if(disp->inv_p > disp->inv_stats.peak) disp->inv_stats.peak = disp->inv_p;
 
     lv_display_send_event(disp, LV_EVENT_REFR_REQUEST, NULL);
 }
 
+lv_result_t lv_inv_scroll(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy)
+{
+    if(!disp) disp = lv_display_get_default();
+    if(!disp) return LV_RESULT_INVALID;
+    if(!disp->scroll_blit || !lv_display_is_invalidation_enabled(disp)) return LV_RESULT_INVALID;
+    if(!scroll_blit_supported(disp)) return LV_RESULT_INVALID;
+
+    LV_ASSERT_MSG(!disp->rendering_in_progress, "Invalidate area is not allowed during rendering.");
+
+    lv_area_t scr_area;
+    scr_area.x1 = 0;
+    scr_area.y1 = 0;
+    scr_area.x2 = lv_display_get_horizontal_resolution(disp) - 1;
+    scr_area.y2 = lv_display_get_vertical_resolution(disp) - 1;
+
+    lv_area_t blit_area;
+    if(!lv_area_intersect(&blit_area, area, &scr_area)) return LV_RESULT_INVALID;
+
+    /*One area is moved per refresh, scrolling it again adds up*/
+    lv_point_t ofs = {dx, dy};
+    if(disp->blit_pending) {
+        if(!lv_area_is_equal(&blit_area, &disp->blit_area)) return LV_RESULT_INVALID;
+        ofs.x += disp->blit_ofs.x;
+        ofs.y += disp->blit_ofs.y;
+    }
+    else {
+        /*Not worth moving if it's redrawn anyway*/
+        uint32_t i;
+        for(i = 0; i < disp->inv_p; i++) {
+            if(lv_area_is_in(&blit_area, &disp->inv_areas[i], 0)) return LV_RESULT_INVALID;
+        }
+    }
+
+    /*Scrolled back to its place or out of the area: the caller redraws all of it*/
+    if((ofs.x == 0 && ofs.y == 0) ||
+       LV_ABS(ofs.x) >= lv_area_get_width(&blit_area) || LV_ABS(ofs.y) >= lv_area_get_height(&blit_area)) {
+        disp->blit_pending = 0;
+        return LV_RESULT_INVALID;
+    }
+
+    /*The stale pixels of the pending invalidations are moved too*/
+    if(inv_scroll_pending(disp, &blit_area, dx, dy) != LV_RESULT_OK) {
+        disp->blit_pending = 0;
+        return LV_RESULT_INVALID;
+    }
+
+    disp->blit_area = blit_area;
+    disp->blit_ofs = ofs;
+    disp->blit_pending = 1;
+
+    /*Redraw what this step scrolled in. What the previous steps scrolled in was moved above.*/
+    lv_area_t moved = blit_area;
+    lv_area_move(&moved, dx, dy);
+    lv_area_t exposed[4];
+    int8_t exposed_cnt = lv_area_diff(exposed, &blit_area, &moved);
+    int8_t i;
+    for(i = 0; i < exposed_cnt; i++) {
+        lv_inv_area(disp, &exposed[i]);
+    }
+
+    return LV_RESULT_OK;
+}
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
@@ -401,6 +495,12 @@ void lv_display_refr_timer(lv_timer_t * tmr)
     lv_obj_update_layout(disp_refr->sys_layer);
     LV_PROFILER_LAYOUT_END_TAG("layout");
 
+    /*Let the display move the scrolled pixels, or redraw them if it can't*/
+    if(disp_refr->blit_pending) refr_blit_display();
+
+    /*The dirty tiles become areas which need no joining*/
+    if(disp_refr->inv_tiles) lv_refr_inv_tiles_to_areas(disp_refr);
+
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
@@ -408,10 +508,17 @@ void lv_display_refr_timer(lv_timer_t * tmr)
         goto refr_finish;
     }
 
-    lv_refr_join_area();
+    if(disp_refr->inv_tiles == NULL) lv_refr_join_area();
     refr_sync_areas();
+    if(disp_refr->blit_pending) refr_blit_draw_buf();
     refr_invalid_areas();
 
+    /*In double buffered direct mode the moved pixels need to be synchronized too*/
+    if(disp_refr->blit_pending && lv_display_is_double_buffered(disp_refr)) {
+        lv_area_t * sync_area = lv_ll_ins_tail(&disp_refr->sync_areas);
+        if(sync_area) *sync_area = disp_refr->blit_area;
+    }
+
     if(disp_refr->inv_p == 0) goto refr_finish;
     /*In double buffered direct mode save the updated areas.
      *They will be used on the next call to synchronize the buffers.*/
@@ -426,11 +533,11 @@ void lv_display_refr_timer(lv_timer_t * tmr)
         }
     }
 
-    lv_memzero(disp_refr->inv_areas, sizeof(disp_refr->inv_areas));
-    lv_memzero(disp_refr->inv_area_joined, sizeof(disp_refr->inv_area_joined));
+    lv_memzero(disp_refr->inv_area_joined, disp_refr->inv_p);
     disp_refr->inv_p = 0;
 
 refr_finish:
+    disp_refr->blit_pending = 0;
 
 #if LV_DRAW_SW_COMPLEX == 1
     lv_draw_sw_mask_cleanup();
@@ -508,7 +615,9 @@ void lv_obj_refr(lv_layer_t * layer, lv_obj_t * obj)
 
     lv_layer_type_t layer_type = lv_obj_get_layer_type(obj);
     if(layer_type == LV_LAYER_TYPE_NONE) {
-        lv_obj_redraw(layer, obj);
+        if(!obj->render_cache || lv_obj_render_cache_draw(layer, obj) != LV_RESULT_OK) {
+            lv_obj_redraw(layer, obj);
+        }
     }
 #if LV_DRAW_TRANSFORM_USE_MATRIX
     /*If the layer opa is full then use the matrix transform*/
@@ -598,46 +707,528 @@ void lv_obj_refr(lv_layer_t * layer, lv_obj_t * obj)
     layer->recolor = layer_recolor;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+void lv_refr_join_areas_sweep(lv_display_t * disp)
+{
+    uint16_t * order = disp->inv_order;
+    uint16_t * active = disp->inv_order + disp->inv_cap;
+    uint32_t order_cnt = 0;
+    uint32_t active_cnt = 0;
+    uint32_t window = disp->area_cost.window;
+    uint64_t px_cost = get_px_cost(disp);
+    int32_t max_gap = join_max_gap(disp, px_cost);
+
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i] == 0) order[order_cnt++] = (uint16_t)i;
+    }
+    sort_by_y1(disp->inv_areas, order, order_cnt);
 
-/**
- * Join the areas which has got common parts
- */
-static void lv_refr_join_area(void)
+    for(i = 0; i < order_cnt; i++) {
+        uint32_t cur = order[i];
+        lv_area_t * cur_area = &disp->inv_areas[cur];
+        int32_t sweep_y = cur_area->y1;
+        uint64_t cur_cost = get_area_cost(window, px_cost, cur_area);
+
+        uint32_t a = 0;
+        while(a < active_cnt) {
+            lv_area_t * act_area = &disp->inv_areas[active[a]];
+
+            /*The later areas start at `sweep_y` or below, so an area which ends too far above is done*/
+            if(act_area->y2 + max_gap < sweep_y) {
+                active[a] = active[--active_cnt];
+                continue;
+            }
+
+            if(area_gap(act_area, cur_area) > max_gap) {
+                a++;
+                continue;
+            }
+
+            lv_area_t joined_area;
+            lv_area_join(&joined_area, act_area, cur_area);
+            uint64_t joined_cost = get_area_cost(window, px_cost, &joined_area);
+            if(joined_cost >= cur_cost + get_area_cost(window, px_cost, act_area)) {
+                a++;
+                continue;
+            }
+
+            /*Join the active area into the current one and compare the larger area with all of them again*/
+            *cur_area = joined_area;
+            cur_cost = joined_cost;
+            disp->inv_area_joined[active[a]] = 1;
+            active[a] = active[--active_cnt];
+            a = 0;
+        }
+
+        active[active_cnt++] = (uint16_t)cur;
+    }
+}
+
+void lv_refr_join_areas_pairwise(lv_display_t * disp)
 {
-    LV_PROFILER_REFR_BEGIN;
+    uint32_t window = disp->area_cost.window;
+    uint64_t px_cost = get_px_cost(disp);
+    int32_t max_gap = join_max_gap(disp, px_cost);
     uint32_t join_from;
     uint32_t join_in;
     lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
+    for(join_in = 0; join_in < disp->inv_p; join_in++) {
+        if(disp->inv_area_joined[join_in] != 0) continue;
 
         /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
+        for(join_from = 0; join_from < disp->inv_p; join_from++) {
             /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
+            if(disp->inv_area_joined[join_from] != 0 || join_in == join_from) {
                 continue;
             }
 
-            /*Check if the areas are on each other*/
-            if(lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
+            /*Check if the areas are close enough*/
+            if(area_gap(&disp->inv_areas[join_in], &disp->inv_areas[join_from]) > max_gap) {
                 continue;
             }
 
-            lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+            lv_area_join(&joined_area, &disp->inv_areas[join_in], &disp->inv_areas[join_from]);
 
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+            /*Join two area only if refreshing the joined area is cheaper*/
+            uint64_t joined_cost = get_area_cost(window, px_cost, &joined_area);
+            if(joined_cost < get_area_cost(window, px_cost, &disp->inv_areas[join_in]) +
+               get_area_cost(window, px_cost, &disp->inv_areas[join_from])) {
+                lv_area_copy(&disp->inv_areas[join_in], &joined_area);
 
                 /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+                disp->inv_area_joined[join_from] = 1;
+            }
+        }
+    }
+}
+
+void lv_refr_inv_tiles_to_areas(lv_display_t * disp)
+{
+    if(!disp->inv_tiles_dirty) return;
+    LV_PROFILER_REFR_BEGIN;
+
+    int32_t tile = (int32_t)disp->inv_tile_size;
+    uint32_t cols = disp->inv_tile_cols;
+    int32_t x_max = lv_display_get_horizontal_resolution(disp) - 1;
+    int32_t y_max = lv_display_get_vertical_resolution(disp) - 1;
+
+    /*Refresh the clean tiles between two runs too if it costs less than an other window*/
+    uint64_t gap_cost = get_px_cost(disp) * (uint64_t)(tile * tile);
+    uint32_t max_gap = gap_cost ? (uint32_t)LV_MIN(disp->area_cost.window / gap_cost, (uint64_t)cols) : cols;
+
+    /*The areas of the runs of the previous and the current row, from left to right*/
+    uint16_t * prev = disp->inv_order;
+    uint16_t * cur = disp->inv_order + disp->inv_cap;
+    uint32_t prev_cnt = 0;
+
+    uint32_t * row = disp->inv_tiles;
+    uint32_t r;
+    for(r = 0; r < disp->inv_tile_rows; r++, row += disp->inv_tile_stride) {
+        int32_t y1 = (int32_t)r * tile;
+        int32_t y2 = LV_MIN(y1 + tile - 1, y_max);
+        uint32_t cur_cnt = 0;
+        uint32_t p = 0;
+
+        uint32_t col = inv_tiles_find(row, 0, cols, true);
+        while(col < cols) {
+            uint32_t first = col;
+            uint32_t end = inv_tiles_find(row, col, cols, false);
+            col = inv_tiles_find(row, end, cols, true);
+            while(col < cols && col - end <= max_gap) {
+                end = inv_tiles_find(row, col, cols, false);
+                col = inv_tiles_find(row, end, cols, true);
+            }
+
+            lv_area_t run;
+            run.x1 = (int32_t)first * tile;
+            run.x2 = LV_MIN((int32_t)end * tile - 1, x_max);
+            run.y1 = y1;
+            run.y2 = y2;
+
+            /*Continue the area of the row above if it has the same columns*/
+            while(p < prev_cnt && disp->inv_areas[prev[p]].x1 < run.x1) p++;
+            if(p < prev_cnt && disp->inv_areas[prev[p]].x1 == run.x1 && disp->inv_areas[prev[p]].x2 == run.x2) {
+                disp->inv_areas[prev[p]].y2 = y2;
+                cur[cur_cnt++] = prev[p];
+                p++;
+            }
+            else {
+                disp->inv_areas[disp->inv_p] = run;
+                disp->inv_area_joined[disp->inv_p] = 0;
+                cur[cur_cnt++] = (uint16_t)disp->inv_p;
+                disp->inv_p++;
+            }
+        }
+
+        lv_memzero(row, disp->inv_tile_stride * sizeof(uint32_t));
+
+        uint16_t * tmp = prev;
+        prev = cur;
+        cur = tmp;
+        prev_cnt = cur_cnt;
+    }
+
+    disp->inv_tiles_dirty = 0;
+    if(disp->inv_p > disp->inv_stats.peak) disp->inv_stats.peak = disp->inv_p;
+    LV_PROFILER_REFR_END;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Join the invalidated areas with the strategy of the display
+ */
+static void lv_refr_join_area(void)
+{
+    LV_PROFILER_REFR_BEGIN;
+    if(disp_refr->join_areas_cb) disp_refr->join_areas_cb(disp_refr);
+    else lv_refr_join_areas_sweep(disp_refr);
+    LV_PROFILER_REFR_END;
+}
+
+/**
+ * Get the cost of one pixel with the cost model of a display
+ * @param disp      pointer to a display
+ * @return          cost of rendering and sending a pixel
+ */
+static uint64_t get_px_cost(lv_display_t * disp)
+{
+    return disp->area_cost.px_render +
+           (uint64_t)lv_color_format_get_size(disp->color_format) * disp->area_cost.byte_flush;
+}
+
+/**
+ * Same as `lv_display_get_area_cost` with the pixel cost already calculated
+ * @param window    cost of a window
+ * @param px_cost   cost of a pixel
+ * @param area      the area to refresh
+ * @return          cost of the area
+ */
+static inline uint64_t get_area_cost(uint32_t window, uint64_t px_cost, const lv_area_t * area)
+{
+    return window + (uint64_t)lv_area_get_size(area) * px_cost;
+}
+
+/**
+ * Get the largest gap between two areas which can be worth joining them:
+ * the joined area has at least one extra pixel per row or column of the gap
+ * @param disp      pointer to a display
+ * @param px_cost   cost of a pixel
+ * @return          the gap in pixels
+ */
+static int32_t join_max_gap(lv_display_t * disp, uint64_t px_cost)
+{
+    int32_t res_max = LV_MAX(disp->hor_res, disp->ver_res);
+    if(px_cost == 0) return res_max;
+
+    return (int32_t)LV_MIN(disp->area_cost.window / px_cost, (uint64_t)res_max);
+}
+
+/**
+ * Get the gap between two areas
+ * @param a1_p      pointer to an area
+ * @param a2_p      pointer to an other area
+ * @return          the larger of the horizontal and vertical gap in pixels, negative if they overlap
+ */
+static int32_t area_gap(const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+    int32_t gap_x = LV_MAX(a2_p->x1 - a1_p->x2, a1_p->x1 - a2_p->x2) - 1;
+    int32_t gap_y = LV_MAX(a2_p->y1 - a1_p->y2, a1_p->y1 - a2_p->y2) - 1;
+    return LV_MAX(gap_x, gap_y);
+}
+
+/**
+ * Sort area indices by the top edge of the areas (heap sort, no extra memory)
+ * @param areas     the areas
+ * @param order     indices into `areas` to sort
+ * @param cnt       number of indices
+ */
+static void sort_by_y1(const lv_area_t * areas, uint16_t * order, uint32_t cnt)
+{
+    uint32_t heap_cnt = cnt;
+    uint32_t start = cnt / 2;
+    while(heap_cnt > 1) {
+        if(start > 0) {
+            /*Build the heap*/
+            start--;
+        }
+        else {
+            /*Move the largest to the end*/
+            heap_cnt--;
+            uint16_t tmp = order[0];
+            order[0] = order[heap_cnt];
+            order[heap_cnt] = tmp;
+        }
+
+        /*Sift down*/
+        uint32_t root = start;
+        while(root * 2 + 1 < heap_cnt) {
+            uint32_t child = root * 2 + 1;
+            if(child + 1 < heap_cnt && areas[order[child + 1]].y1 > areas[order[child]].y1) child++;
+            if(areas[order[child]].y1 <= areas[order[root]].y1) break;
+
+            uint16_t tmp = order[root];
+            order[root] = order[child];
+            order[child] = tmp;
+            root = child;
+        }
+    }
+}
+
+/**
+ * Make room in the full buffer of the invalidated areas: snap the areas to a grid and join
+ * the ones which overlap or line up on it, with a coarser grid until half of the buffer is free.
+ * Coarser than the screen all of them become the screen, so it always succeeds.
+ * @param disp      pointer to a display
+ * @param scr_area  the area of the screen
+ */
+static void inv_coalesce(lv_display_t * disp, const lv_area_t * scr_area)
+{
+    LV_PROFILER_REFR_BEGIN;
+    int32_t tile = LV_INV_COALESCE_TILE;
+    while(disp->inv_p > disp->inv_cap / 2) {
+        uint32_t i;
+        for(i = 0; i < disp->inv_p; i++) {
+            lv_area_t * a = &disp->inv_areas[i];
+            a->x1 = a->x1 / tile * tile;
+            a->y1 = a->y1 / tile * tile;
+            a->x2 = LV_MIN((a->x2 / tile + 1) * tile - 1, scr_area->x2);
+            a->y2 = LV_MIN((a->y2 / tile + 1) * tile - 1, scr_area->y2);
+        }
+        inv_join_aligned(disp);
+        tile *= 2;
+    }
+    LV_PROFILER_REFR_END;
+}
+
+/**
+ * Join the invalidated areas which are in each other, or whose joined area isn't larger than the two
+ * (e.g. neighbours on a grid), and remove the joined ones from the buffer
+ * @param disp      pointer to a display
+ */
+static void inv_join_aligned(lv_display_t * disp)
+{
+    uint32_t i = 0;
+    while(i < disp->inv_p) {
+        lv_area_t * a = &disp->inv_areas[i];
+        bool joined = false;
+        uint32_t j;
+        for(j = i + 1; j < disp->inv_p; j++) {
+            lv_area_t * b = &disp->inv_areas[j];
+            if(area_gap(a, b) > 0) continue;
+
+            lv_area_t joined_area;
+            lv_area_join(&joined_area, a, b);
+            if(lv_area_get_size(&joined_area) > lv_area_get_size(a) + lv_area_get_size(b)) continue;
+
+            /*Keep the joined area in `b` and compare it with the others again*/
+            *b = joined_area;
+            joined = true;
+            break;
+        }
+
+        if(joined) {
+            disp->inv_p--;
+            disp->inv_areas[i] = disp->inv_areas[disp->inv_p];
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+/**
+ * Find the next dirty or clean tile in a row of tiles
+ * @param row       the bits of the row
+ * @param col       start searching from this column
+ * @param cols      number of tiles in the row
+ * @param dirty     true: find a dirty tile; false: find a clean tile
+ * @return          column of the tile, or `cols` if there is no more
+ */
+static uint32_t inv_tiles_find(const uint32_t * row, uint32_t col, uint32_t cols, bool dirty)
+{
+    while(col < cols) {
+        uint32_t word = row[col >> 5];
+        if(!dirty) word = ~word;
+        word >>= col & 31;
+        if(word == 0) {
+            col = (col | 31) + 1;
+            continue;
+        }
+        while((word & 1) == 0) {
+            word >>= 1;
+            col++;
+        }
+        return LV_MIN(col, cols);
+    }
+    return cols;
+}
+
+/**
+ * Check if the pixels can be moved on a display for `lv_inv_scroll`
+ * @param disp      pointer to a display
+ * @return          true: the display moves them (partial mode), or they are moved in the draw buffer
+ */
+static bool scroll_blit_supported(lv_display_t * disp)
+{
+    if(disp->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL) return disp->blit_cb != NULL;
+    if(disp->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT) return false;
+
+    /*In direct mode the buffers have the last rendered image in the display's coordinates*/
+    if(disp->buf_3 || lv_display_get_rotation(disp) != LV_DISPLAY_ROTATION_0) return false;
+    return lv_color_format_get_bpp(disp->color_format) >= 8;
+}
+
+/**
+ * Invalidate the pending invalidations of an area again where they will be after it's moved
+ * @param disp      pointer to a display
+ * @param area      the moved area
+ * @param dx        horizontal offset
+ * @param dy        vertical offset
+ * @return          LV_RESULT_OK or LV_RESULT_INVALID if out of memory (nothing was invalidated)
+ */
+static lv_result_t inv_scroll_pending(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy)
+{
+    lv_area_t moved;
+
+    /*Invalidating changes the list, so walk a copy of it*/
+    if(disp->inv_tiles == NULL) {
+        uint32_t cnt = disp->inv_p;
+        if(cnt == 0) return LV_RESULT_OK;
+        lv_area_t * areas = lv_malloc(cnt * sizeof(lv_area_t));
+        if(areas == NULL) return LV_RESULT_INVALID;
+        lv_memcpy(areas, disp->inv_areas, cnt * sizeof(lv_area_t));
+
+        uint32_t i;
+        for(i = 0; i < cnt; i++) {
+            if(!lv_area_intersect(&moved, &areas[i], area)) continue;
+            lv_area_move(&moved, dx, dy);
+            if(lv_area_intersect(&moved, &moved, area)) lv_inv_area(disp, &moved);
+        }
+        lv_free(areas);
+        return LV_RESULT_OK;
+    }
+
+    if(!disp->inv_tiles_dirty) return LV_RESULT_OK;
+
+    /*The same with the rows of tiles on the area*/
+    uint32_t shift = disp->inv_tile_shift;
+    uint32_t row1 = (uint32_t)area->y1 >> shift;
+    uint32_t row2 = (uint32_t)area->y2 >> shift;
+    uint32_t col1 = (uint32_t)area->x1 >> shift;
+    uint32_t col_end = ((uint32_t)area->x2 >> shift) + 1;
+    uint32_t stride = disp->inv_tile_stride;
+    uint32_t * rows = lv_malloc((row2 - row1 + 1) * stride * sizeof(uint32_t));
+    if(rows == NULL) return LV_RESULT_INVALID;
+    lv_memcpy(rows, disp->inv_tiles + row1 * stride, (row2 - row1 + 1) * stride * sizeof(uint32_t));
+
+    int32_t tile = (int32_t)disp->inv_tile_size;
+    uint32_t r;
+    for(r = row1; r <= row2; r++) {
+        const uint32_t * row = rows + (r - row1) * stride;
+        uint32_t col = inv_tiles_find(row, col1, col_end, true);
+        while(col < col_end) {
+            uint32_t end = inv_tiles_find(row, col, col_end, false);
+            lv_area_t run;
+            run.x1 = (int32_t)col * tile;
+            run.x2 = (int32_t)end * tile - 1;
+            run.y1 = (int32_t)r * tile;
+            run.y2 = run.y1 + tile - 1;
+            if(lv_area_intersect(&moved, &run, area)) {
+                lv_area_move(&moved, dx, dy);
+                if(lv_area_intersect(&moved, &moved, area)) lv_display_mark_inv_tiles(disp, &moved);
             }
+            col = inv_tiles_find(row, end, col_end, true);
         }
     }
+    lv_free(rows);
+    return LV_RESULT_OK;
+}
+
+/**
+ * Move the scrolled pixels on the display with its `blit_cb` in partial mode.
+ * If the pixels can't be moved redraw the area.
+ */
+static void refr_blit_display(void)
+{
+    lv_display_t * disp = disp_refr;
+
+    /*Moved later in the draw buffer*/
+    if(disp->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT && scroll_blit_supported(disp)) return;
+
+    LV_PROFILER_REFR_BEGIN;
+    bool moved = false;
+    if(disp->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL && disp->blit_cb) {
+        moved = disp->blit_cb(disp, &disp->blit_area, disp->blit_ofs.x, disp->blit_ofs.y);
+    }
+
+    disp->blit_pending = 0;
+    if(moved) disp->inv_stats.blitted++;
+    else lv_inv_area(disp, &disp->blit_area);
+    LV_PROFILER_REFR_END;
+}
+
+/**
+ * Move the scrolled pixels in the draw buffer in direct mode and flush them
+ */
+static void refr_blit_draw_buf(void)
+{
+    LV_PROFILER_REFR_BEGIN;
+    lv_display_t * disp = disp_refr;
+
+    /*The area may be smaller since it was scrolled (e.g. the resolution has changed)*/
+    lv_area_t scr_area;
+    scr_area.x1 = 0;
+    scr_area.y1 = 0;
+    scr_area.x2 = lv_display_get_horizontal_resolution(disp) - 1;
+    scr_area.y2 = lv_display_get_vertical_resolution(disp) - 1;
+    if(!lv_area_intersect(&disp->blit_area, &disp->blit_area, &scr_area)) {
+        disp->blit_pending = 0;
+        LV_PROFILER_REFR_END;
+        return;
+    }
+
+    /*Only the part of the area whose pixels were in it before*/
+    lv_area_t src = disp->blit_area;
+    lv_area_move(&src, -disp->blit_ofs.x, -disp->blit_ofs.y);
+    lv_area_t dst;
+    if(lv_area_intersect(&src, &src, &disp->blit_area)) {
+        dst = src;
+        lv_area_move(&dst, disp->blit_ofs.x, disp->blit_ofs.y);
+
+        /*Don't change the pixels being sent. With two buffers the other one has the last image.*/
+        wait_for_flushing(disp);
+        lv_draw_buf_t * buf = disp->buf_act;
+        lv_draw_buf_t * src_buf = buf;
+        if(lv_display_is_double_buffered(disp)) src_buf = buf == disp->buf_1 ? disp->buf_2 : disp->buf_1;
+
+        /*In place read each row before it's overwritten*/
+        bool bottom_up = src_buf == buf && disp->blit_ofs.y > 0;
+        uint32_t row_size = lv_area_get_width(&dst) * lv_color_format_get_size(disp->color_format);
+        int32_t h = lv_area_get_height(&dst);
+        int32_t i;
+        for(i = 0; i < h; i++) {
+            int32_t y = bottom_up ? h - 1 - i : i;
+            lv_memmove(lv_draw_buf_goto_xy(buf, dst.x1, dst.y1 + y),
+                       lv_draw_buf_goto_xy(src_buf, src.x1, src.y1 + y), row_size);
+        }
+    }
+
+    /*Flush the area like a rendered one. It's the last one if nothing else is redrawn.*/
+    bool last = true;
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i] == 0) last = false;
+    }
+    disp->last_area = last;
+    disp->last_part = last;
+    disp->layer_head->draw_buf = disp->buf_act;
+    disp->refreshed_area = disp->blit_area;
+    draw_buf_flush(disp);
+
+    disp->inv_stats.blitted++;
     LV_PROFILER_REFR_END;
 }
 
@@ -776,6 +1367,9 @@ static void refr_invalid_areas(void)
         disp_refr->last_part = 0;
 
         lv_area_t inv_a = disp_refr->inv_areas[i];
+#if LV_USE_PERF_MONITOR
+        disp_refr->perf_sysmon_info.measured.render_px += lv_area_get_size(&inv_a);
+#endif
         if(disp_refr->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL) {
             /*Calculate the max row num*/
             int32_t w = lv_area_get_width(&inv_a);
@@ -820,6 +1414,9 @@ static void refr_invalid_areas(void)
         }
     }
 
+    /*All draw tasks are ready, the cached buffers they used can be freed*/
+    lv_obj_render_cache_refr_ready();
+
     lv_display_send_event(disp_refr, LV_EVENT_RENDER_READY, NULL);
     disp_refr->rendering_in_progress = false;
     LV_PROFILER_REFR_END;
@@ -1015,7 +1612,8 @@ static void refr_configured_layer(lv_layer_t * layer)
 #endif /* LV_DRAW_TRANSFORM_USE_MATRIX */
 
     /* In single buffered mode wait here until the buffer is freed.
-     * Else we would draw into the buffer while it's still being transferred to the display*/
+     * Else we would draw into the buffer while it's still being transferred to the display.
+     * With a buffer ring wait only if the next buffer of the ring is still being transferred.*/
     if(!lv_display_is_double_buffered(disp_refr)) {
         wait_for_flushing(disp_refr);
     }
@@ -1184,6 +1782,30 @@ static bool alpha_test_area_on_obj(lv_obj_t * obj, const lv_area_t * area)
     else return true;
 }
 
+/**
+ * Send the draw events of a draw phase, or add the draw tasks they added the last time
+ * @param layer     the layer to draw to
+ * @param obj       the widget to draw
+ * @param phase     `LV_OBJ_DRAW_LIST_PHASE_MAIN` or `LV_OBJ_DRAW_LIST_PHASE_POST`
+ */
+static void draw_phase(lv_layer_t * layer, lv_obj_t * obj, lv_obj_draw_list_phase_t phase)
+{
+    if(lv_obj_draw_list_replay(layer, obj, phase)) return;
+
+    if(phase == LV_OBJ_DRAW_LIST_PHASE_MAIN) {
+        lv_obj_send_event(obj, LV_EVENT_DRAW_MAIN_BEGIN, layer);
+        lv_obj_send_event(obj, LV_EVENT_DRAW_MAIN, layer);
+        lv_obj_send_event(obj, LV_EVENT_DRAW_MAIN_END, layer);
+    }
+    else {
+        lv_obj_send_event(obj, LV_EVENT_DRAW_POST_BEGIN, layer);
+        lv_obj_send_event(obj, LV_EVENT_DRAW_POST, layer);
+        lv_obj_send_event(obj, LV_EVENT_DRAW_POST_END, layer);
+    }
+
+    lv_obj_draw_list_record_end(layer, obj);
+}
+
 #if LV_DRAW_TRANSFORM_USE_MATRIX
 
 static bool obj_get_matrix(lv_obj_t * obj, lv_matrix_t * matrix)
@@ -1370,8 +1992,9 @@ static void draw_buf_flush(lv_display_t * disp)
     /* In double buffered mode wait until the other buffer is freed
      * and driver is ready to receive the new buffer.
      * If we need to wait here it means that the content of one buffer is being sent to display
-     * and other buffer already contains the new rendered image. */
-    if(lv_display_is_double_buffered(disp)) {
+     * and other buffer already contains the new rendered image.
+     * With a buffer ring the driver queues the buffers so there is no need to wait. */
+    if(lv_display_is_double_buffered(disp) && disp->buf_ring == NULL) {
         wait_for_flushing(disp_refr);
     }
 
@@ -1382,9 +2005,18 @@ static void draw_buf_flush(lv_display_t * disp)
 
     bool flushing_last = disp->flushing_last;
 
+    /*Count the buffer before calling `flush_cb` as it might call `lv_display_flush_ready()` right away*/
+    if(disp->buf_ring) disp->buf_ring_submitted++;
+
     if(disp->flush_cb) {
         call_flush_cb(disp, &disp->refreshed_area, layer->draw_buf->data);
     }
+
+    /*Continue with the next buffer of the ring. `refr_area_part` waits until it's flushed*/
+    if(disp->buf_ring) {
+        disp->buf_act = disp->buf_ring[disp->buf_ring_submitted % disp->buf_ring_cnt];
+        return;
+    }
     /*If there are 2 buffers swap them. With direct mode swap only on the last area*/
     if(lv_display_is_double_buffered(disp) && (disp->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT || flushing_last)) {
         if(disp->buf_act == disp->buf_1) {
@@ -1432,7 +2064,14 @@ static void wait_for_flushing(lv_display_t * disp)
 
     lv_display_send_event(disp, LV_EVENT_FLUSH_WAIT_START, NULL);
 
-    if(disp->flush_wait_cb) {
+    if(disp->buf_ring) {
+        /*The buffers are flushed in order, so `buf_act` is free
+         *if less than `buf_ring_cnt` buffers are waiting for `lv_display_flush_ready()`*/
+        while(disp->buf_ring_submitted - disp->buf_ring_flushed >= disp->buf_ring_cnt) {
+            if(disp->flush_wait_cb) disp->flush_wait_cb(disp);
+        }
+    }
+    else if(disp->flush_wait_cb) {
         if(disp->flushing) {
             disp->flush_wait_cb(disp);
             disp->flushing = 0;
@@ -63,6 +63,29 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj);
  */
 void lv_display_refr_timer(lv_timer_t * timer);
 
+/**
+ * Join the invalidated areas of a display with a sort and sweep: the areas are visited
+ * in the order of their top edge, and each is compared only with the earlier ones which end
+ * close enough above to be worth joining with the display's cost model (see `lv_display_set_area_cost`).
+ * The default strategy of `lv_display_set_join_areas_cb`.
+ * @param disp      pointer to a display
+ */
+void lv_refr_join_areas_sweep(lv_display_t * disp);
+
+/**
+ * Join the invalidated areas of a display by comparing every area with every other one,
+ * with the display's cost model. With the default cost model it's the strategy of the earlier versions.
+ * @param disp      pointer to a display
+ */
+void lv_refr_join_areas_pairwise(lv_display_t * disp);
+
+/**
+ * Turn the dirty tiles of a display into invalidated areas and clean the tiles
+ * (see `lv_display_set_inv_tile_size`). Called by the refresh instead of joining the areas.
+ * @param disp      pointer to a display
+ */
+void lv_refr_inv_tiles_to_areas(lv_display_t * disp);
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -46,6 +46,19 @@ void lv_refr_deinit(void);
  */
 void lv_inv_area(lv_display_t * disp, const lv_area_t * area_p);
 
+/**
+ * Move the rendered pixels of an area at the next refresh instead of redrawing it, and invalidate
+ * only the part which is not covered by the moved pixels.
+ * The pending invalidations in the area are moved too. See `lv_display_set_scroll_blit`.
+ * @param disp      pointer to display (NULL: the default display)
+ * @param area      the area in its new position, on the display
+ * @param dx        the content moved this many pixels to the right (negative: to the left)
+ * @param dy        the content moved this many pixels down (negative: up)
+ * @return          LV_RESULT_OK: the area will be moved; LV_RESULT_INVALID: not possible now,
+ *                  nothing was invalidated, invalidate the area as usual
+ */
+lv_result_t lv_inv_scroll(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy);
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
@@ -46,6 +46,9 @@ static void set_y_anim(void * obj, int32_t v);
 static void scr_anim_completed(lv_anim_t * a);
 static bool is_out_anim(lv_screen_load_anim_t a);
 static void disp_event_cb(lv_event_t * e);
+static void buf_ring_reset(lv_display_t * disp);
+static lv_result_t inv_tiles_create(lv_display_t * disp, uint32_t tile_size);
+static void inv_tiles_delete(lv_display_t * disp);
 
 /**********************
  *  STATIC VARIABLES
@@ -84,9 +87,21 @@ lv_display_t * lv_display_create(int32_t hor_res, int32_t ver_res)
     disp->tile_cnt = 1;
 #endif
 
+    /*The invalidated areas first: if it fails only the display needs to be freed*/
+    if(lv_display_resize_inv_buf(disp, LV_INV_BUF_SIZE) != LV_RESULT_OK) {
+        lv_ll_remove(disp_ll_p, disp);
+        lv_free(disp);
+        return NULL;
+    }
+
     disp->layer_head = lv_malloc(sizeof(lv_layer_t));
     LV_ASSERT_MALLOC(disp->layer_head);
-    if(disp->layer_head == NULL) return NULL;
+    if(disp->layer_head == NULL) {
+        lv_free(disp->inv_areas);
+        lv_ll_remove(disp_ll_p, disp);
+        lv_free(disp);
+        return NULL;
+    }
     lv_layer_init(disp->layer_head);
 
     if(disp->layer_init) disp->layer_init(disp, disp->layer_head);
@@ -97,6 +112,7 @@ lv_display_t * lv_display_create(int32_t hor_res, int32_t ver_res)
     disp->layer_head->color_format = disp->color_format;
 
     disp->inv_en_cnt = 1;
+    disp->area_cost.px_render = 1;
     disp->last_activity_time = lv_tick_get();
 
     lv_ll_init(&disp->sync_areas, sizeof(lv_area_t));
@@ -108,6 +124,10 @@ lv_display_t * lv_display_create(int32_t hor_res, int32_t ver_res)
     disp->refr_timer = lv_timer_create(lv_display_refr_timer, LV_DEF_REFR_PERIOD, disp);
     LV_ASSERT_MALLOC(disp->refr_timer);
     if(disp->refr_timer == NULL) {
+        disp_def = disp_def_tmp;
+        lv_free(disp->layer_head);
+        lv_free(disp->inv_areas);
+        lv_ll_remove(disp_ll_p, disp);
         lv_free(disp);
         return NULL;
     }
@@ -220,6 +240,10 @@ void lv_display_delete(lv_display_t * disp)
     if(disp->layer_deinit) disp->layer_deinit(disp, disp->layer_head);
     lv_free(disp->layer_head);
 
+    buf_ring_reset(disp);
+    inv_tiles_delete(disp);
+    lv_free(disp->inv_areas);
+
     lv_free(disp);
 
     if(was_default) lv_display_set_default(lv_ll_get_head(disp_ll_p));
@@ -444,6 +468,8 @@ void lv_display_set_draw_buffers(lv_display_t * disp, lv_draw_buf_t * buf1, lv_d
     if(disp == NULL) disp = lv_display_get_default();
     if(disp == NULL) return;
 
+    buf_ring_reset(disp);
+
     disp->buf_1 = buf1;
     disp->buf_2 = buf2;
     disp->buf_act = disp->buf_1;
@@ -462,6 +488,75 @@ void lv_display_set_3rd_draw_buffer(lv_display_t * disp, lv_draw_buf_t * buf3)
     disp->buf_3 = buf3;
 }
 
+void lv_display_set_draw_buffer_ring(lv_display_t * disp, lv_draw_buf_t ** bufs, uint32_t buf_cnt)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    LV_ASSERT_NULL(bufs);
+    LV_ASSERT_MSG(buf_cnt >= 2, "a ring needs at least 2 buffers");
+
+    buf_ring_reset(disp);
+
+    disp->buf_1 = bufs[0];
+    disp->buf_2 = NULL;
+    disp->buf_3 = NULL;
+    disp->buf_act = bufs[0];
+    disp->buf_ring = bufs;
+    disp->buf_ring_cnt = buf_cnt;
+    disp->buf_ring_submitted = 0;
+    disp->buf_ring_flushed = 0;
+
+    disp->stride_is_auto = 0;
+    lv_display_set_render_mode(disp, LV_DISPLAY_RENDER_MODE_PARTIAL);
+}
+
+void lv_display_set_buffer_ring(lv_display_t * disp, void * buf, uint32_t buf_size, uint32_t buf_cnt)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    LV_ASSERT_MSG(buf != NULL, "Null buffer");
+    LV_ASSERT_MSG(buf_cnt >= 2, "a ring needs at least 2 buffers");
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    uint32_t w = lv_display_get_original_horizontal_resolution(disp);
+    LV_ASSERT_MSG(w != 0, "display resolution is 0");
+
+    /* every buffer of the ring has to be aligned, not only the first one */
+    LV_ASSERT_FORMAT_MSG(buf == lv_draw_buf_align(buf, cf), "buf is not aligned: %p", buf);
+    LV_ASSERT_FORMAT_MSG(buf_size % LV_DRAW_BUF_ALIGN == 0, "buf_size is not a multiple of %d", LV_DRAW_BUF_ALIGN);
+
+    uint32_t stride = lv_draw_buf_width_to_stride(w, cf);
+    LV_ASSERT_FORMAT_MSG(stride != 0, "stride is 0, check your color format %d and width: %" LV_PRIu32, cf, w);
+    uint32_t h = buf_size / stride;
+    LV_ASSERT_MSG(h != 0, "the buffer is too small");
+
+    lv_draw_buf_t * ring = lv_malloc(buf_cnt * sizeof(lv_draw_buf_t));
+    lv_draw_buf_t ** ring_ptrs = lv_malloc(buf_cnt * sizeof(lv_draw_buf_t *));
+    LV_ASSERT_MALLOC(ring);
+    LV_ASSERT_MALLOC(ring_ptrs);
+    if(ring == NULL || ring_ptrs == NULL) {
+        lv_free(ring);
+        lv_free(ring_ptrs);
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < buf_cnt; i++) {
+        lv_draw_buf_init(&ring[i], w, h, cf, stride, (uint8_t *)buf + i * buf_size, buf_size);
+        ring_ptrs[i] = &ring[i];
+    }
+
+    lv_display_set_draw_buffer_ring(disp, ring_ptrs, buf_cnt);
+
+    /* set only now as `lv_display_set_draw_buffer_ring` frees the previous static ring */
+    disp->_static_ring = ring;
+    disp->_static_ring_ptrs = ring_ptrs;
+
+    /* the stride was not set explicitly */
+    disp->stride_is_auto = 1;
+}
+
 void lv_display_set_buffers(lv_display_t * disp, void * buf1, void * buf2, uint32_t buf_size,
                             lv_display_render_mode_t render_mode)
 {
@@ -551,6 +646,153 @@ void lv_display_set_flush_wait_cb(lv_display_t * disp, lv_display_flush_wait_cb_
     disp->flush_wait_cb = wait_cb;
 }
 
+void lv_display_set_area_cost(lv_display_t * disp, const lv_display_area_cost_t * cost)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    if(cost) {
+        disp->area_cost = *cost;
+    }
+    else {
+        lv_memzero(&disp->area_cost, sizeof(disp->area_cost));
+        disp->area_cost.px_render = 1;
+    }
+}
+
+uint64_t lv_display_get_area_cost(lv_display_t * disp, const lv_area_t * area)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return 0;
+
+    uint64_t px_cost = disp->area_cost.px_render +
+                       (uint64_t)lv_color_format_get_size(disp->color_format) * disp->area_cost.byte_flush;
+    return disp->area_cost.window + (uint64_t)lv_area_get_size(area) * px_cost;
+}
+
+lv_result_t lv_display_resize_inv_buf(lv_display_t * disp, uint32_t cap)
+{
+    LV_ASSERT(cap >= disp->inv_p && cap <= UINT16_MAX);
+
+    /*One block: the areas, the scratch indices, then the joined flags*/
+    uint8_t * buf = lv_malloc(cap * (sizeof(lv_area_t) + 2 * sizeof(uint16_t) + sizeof(uint8_t)));
+    LV_ASSERT_MALLOC(buf);
+    if(buf == NULL) return LV_RESULT_INVALID;
+
+    lv_area_t * areas = (lv_area_t *)buf;
+    uint16_t * order = (uint16_t *)(areas + cap);
+    uint8_t * joined = (uint8_t *)(order + 2 * cap);
+    if(disp->inv_p) {
+        lv_memcpy(areas, disp->inv_areas, disp->inv_p * sizeof(lv_area_t));
+        lv_memcpy(joined, disp->inv_area_joined, disp->inv_p);
+    }
+    lv_memzero(joined + disp->inv_p, cap - disp->inv_p);
+
+    lv_free(disp->inv_areas);
+    disp->inv_areas = areas;
+    disp->inv_order = order;
+    disp->inv_area_joined = joined;
+    disp->inv_cap = cap;
+    disp->inv_stats.capacity = cap;
+    return LV_RESULT_OK;
+}
+
+void lv_display_get_inv_stats(lv_display_t * disp, lv_display_inv_stats_t * stats)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) {
+        lv_memzero(stats, sizeof(*stats));
+        return;
+    }
+
+    *stats = disp->inv_stats;
+}
+
+void lv_display_reset_inv_stats(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    lv_memzero(&disp->inv_stats, sizeof(disp->inv_stats));
+    disp->inv_stats.capacity = disp->inv_cap;
+}
+
+lv_result_t lv_display_set_inv_tile_size(lv_display_t * disp, uint32_t tile_size)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return LV_RESULT_INVALID;
+
+    if(tile_size == disp->inv_tile_size) return LV_RESULT_OK;
+    if(tile_size != 0 && (tile_size < 4 || (tile_size & (tile_size - 1)) != 0)) {
+        LV_LOG_WARN("The tile size must be a power of 2 from 4, not %" LV_PRIu32, tile_size);
+        return LV_RESULT_INVALID;
+    }
+
+    /*Keep the areas invalidated so far: turn the tiles into areas...*/
+    if(disp->inv_tiles) {
+        lv_refr_inv_tiles_to_areas(disp);
+        inv_tiles_delete(disp);
+    }
+    if(tile_size == 0) return LV_RESULT_OK;
+
+    if(inv_tiles_create(disp, tile_size) != LV_RESULT_OK) return LV_RESULT_INVALID;
+
+    /*...or the areas into tiles*/
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i] == 0) lv_display_mark_inv_tiles(disp, &disp->inv_areas[i]);
+    }
+    lv_memzero(disp->inv_area_joined, disp->inv_p);
+    disp->inv_p = 0;
+
+    return LV_RESULT_OK;
+}
+
+uint32_t lv_display_get_inv_tile_size(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return 0;
+
+    return disp->inv_tile_size;
+}
+
+void lv_display_mark_inv_tiles(lv_display_t * disp, const lv_area_t * area)
+{
+    uint32_t shift = disp->inv_tile_shift;
+    uint32_t col1 = (uint32_t)area->x1 >> shift;
+    uint32_t col2 = (uint32_t)area->x2 >> shift;
+    uint32_t row1 = (uint32_t)area->y1 >> shift;
+    uint32_t row2 = (uint32_t)area->y2 >> shift;
+
+    uint32_t word1 = col1 >> 5;
+    uint32_t word2 = col2 >> 5;
+    uint32_t mask1 = UINT32_MAX << (col1 & 31);
+    uint32_t mask2 = UINT32_MAX >> (31 - (col2 & 31));
+    if(word1 == word2) mask1 &= mask2;
+
+    uint32_t * row = disp->inv_tiles + row1 * disp->inv_tile_stride;
+    uint32_t r;
+    for(r = row1; r <= row2; r++) {
+        row[word1] |= mask1;
+        if(word2 != word1) {
+            uint32_t w;
+            for(w = word1 + 1; w < word2; w++) row[w] = UINT32_MAX;
+            row[word2] |= mask2;
+        }
+        row += disp->inv_tile_stride;
+    }
+
+    disp->inv_tiles_dirty = 1;
+}
+
+void lv_display_set_join_areas_cb(lv_display_t * disp, lv_display_join_areas_cb_t join_cb)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->join_areas_cb = join_cb;
+}
+
 void lv_display_set_color_format(lv_display_t * disp, lv_color_format_t color_format)
 {
     if(disp == NULL) disp = lv_display_get_default();
@@ -561,6 +803,10 @@ void lv_display_set_color_format(lv_display_t * disp, lv_color_format_t color_fo
     if(disp->buf_1) disp->buf_1->header.cf = color_format;
     if(disp->buf_2) disp->buf_2->header.cf = color_format;
     if(disp->buf_3) disp->buf_3->header.cf = color_format;
+    if(disp->buf_ring) {
+        uint32_t i;
+        for(i = 0; i < disp->buf_ring_cnt; i++) disp->buf_ring[i]->header.cf = color_format;
+    }
 
     lv_display_send_event(disp, LV_EVENT_COLOR_FORMAT_CHANGED, NULL);
 }
@@ -591,6 +837,62 @@ uint32_t lv_display_get_tile_cnt(lv_display_t * disp)
     return disp->tile_cnt;
 }
 
+void lv_display_set_occlusion_culling(lv_display_t * disp, bool en)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->occlusion_culling = en;
+}
+
+bool lv_display_get_occlusion_culling(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return false;
+
+    return disp->occlusion_culling;
+}
+
+void lv_display_set_draw_task_graph(lv_display_t * disp, bool en)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->draw_task_graph = en;
+}
+
+bool lv_display_get_draw_task_graph(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return false;
+
+    return disp->draw_task_graph;
+}
+
+void lv_display_set_scroll_blit(lv_display_t * disp, bool en)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->scroll_blit = en;
+}
+
+bool lv_display_get_scroll_blit(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return false;
+
+    return disp->scroll_blit;
+}
+
+void lv_display_set_blit_cb(lv_display_t * disp, lv_display_blit_cb_t blit_cb)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->blit_cb = blit_cb;
+}
+
 void lv_display_set_antialiasing(lv_display_t * disp, bool en)
 {
     LV_LOG_WARN("Disabling anti-aliasing is not supported since v9. This function will be removed.");
@@ -611,6 +913,10 @@ bool lv_display_get_antialiasing(lv_display_t * disp)
 
 LV_ATTRIBUTE_FLUSH_READY void lv_display_flush_ready(lv_display_t * disp)
 {
+    /*The ring buffers are flushed in order so counting them is enough.
+     *Only the driver writes this counter so it's safe to increment it here.*/
+    if(disp->buf_ring) disp->buf_ring_flushed++;
+
     disp->flushing = 0;
 }
 
@@ -1268,9 +1574,9 @@ static void update_resolution(lv_display_t * disp)
     lv_area_set_height(&disp->bottom_layer->coords, ver_res);
     lv_obj_send_event(disp->bottom_layer, LV_EVENT_SIZE_CHANGED, &prev_coords);
 
-    lv_memzero(disp->inv_areas, sizeof(disp->inv_areas));
-    lv_memzero(disp->inv_area_joined, sizeof(disp->inv_area_joined));
+    lv_memzero(disp->inv_area_joined, disp->inv_cap);
     disp->inv_p = 0;
+    if(disp->inv_tiles) inv_tiles_create(disp, disp->inv_tile_size);
     lv_obj_invalidate(disp->sys_layer);
 
     lv_obj_tree_walk(NULL, invalidate_layout_cb, NULL);
@@ -1370,3 +1676,65 @@ static void disp_event_cb(lv_event_t * e)
             break;
     }
 }
+
+static void buf_ring_reset(lv_display_t * disp)
+{
+    disp->buf_ring = NULL;
+    disp->buf_ring_cnt = 0;
+
+    lv_free(disp->_static_ring);
+    lv_free(disp->_static_ring_ptrs);
+    disp->_static_ring = NULL;
+    disp->_static_ring_ptrs = NULL;
+}
+
+/**
+ * Allocate the dirty tiles for the current resolution, all clean, and make sure that the areas
+ * of the most scattered tiles fit into the buffer of the invalidated areas
+ * @param disp          pointer to a display
+ * @param tile_size     width and height of the tiles, a power of 2
+ * @return              LV_RESULT_OK: created; LV_RESULT_INVALID: out of memory, there are no tiles
+ */
+static lv_result_t inv_tiles_create(lv_display_t * disp, uint32_t tile_size)
+{
+    inv_tiles_delete(disp);
+
+    uint32_t shift = 0;
+    while((1U << shift) < tile_size) shift++;
+    uint32_t cols = ((uint32_t)lv_display_get_horizontal_resolution(disp) + tile_size - 1) >> shift;
+    uint32_t rows = ((uint32_t)lv_display_get_vertical_resolution(disp) + tile_size - 1) >> shift;
+    uint32_t stride = (cols + 31) / 32;
+
+    /*Every other tile of every row, and the areas which are already saved*/
+    uint32_t areas_max = rows * ((cols + 1) / 2) + disp->inv_p;
+    if(areas_max > UINT16_MAX) {
+        LV_LOG_WARN("Too many tiles of %" LV_PRIu32 " pixels", tile_size);
+        return LV_RESULT_INVALID;
+    }
+    if(areas_max > disp->inv_cap && lv_display_resize_inv_buf(disp, areas_max) != LV_RESULT_OK) {
+        return LV_RESULT_INVALID;
+    }
+
+    disp->inv_tiles = lv_malloc_zeroed(rows * stride * sizeof(uint32_t));
+    LV_ASSERT_MALLOC(disp->inv_tiles);
+    if(disp->inv_tiles == NULL) return LV_RESULT_INVALID;
+
+    disp->inv_tile_size = tile_size;
+    disp->inv_tile_shift = (uint8_t)shift;
+    disp->inv_tile_cols = (uint16_t)cols;
+    disp->inv_tile_rows = (uint16_t)rows;
+    disp->inv_tile_stride = (uint16_t)stride;
+    return LV_RESULT_OK;
+}
+
+/**
+ * Free the dirty tiles and go back to the list of invalidated areas
+ * @param disp      pointer to a display
+ */
+static void inv_tiles_delete(lv_display_t * disp)
+{
+    lv_free(disp->inv_tiles);
+    disp->inv_tiles = NULL;
+    disp->inv_tile_size = 0;
+    disp->inv_tiles_dirty = 0;
+}
@@ -81,6 +81,44 @@ typedef enum {
 typedef void (*lv_display_flush_cb_t)(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
 typedef void (*lv_display_flush_wait_cb_t)(lv_display_t * disp);
 
+/**
+ * Cost model of refreshing an area as one window, used to decide which invalidated areas to join.
+ * An area of `n` pixels costs `window + n * (px_render + px_size * byte_flush)` in any unit, e.g. ns.
+ */
+typedef struct {
+    uint32_t window;        /**< fixed cost of an area: render pass set-up, object traversal, flush commands */
+    uint32_t px_render;     /**< cost of rendering one pixel */
+    uint32_t byte_flush;    /**< cost of sending one byte of the rendered pixels */
+} lv_display_area_cost_t;
+
+/**
+ * Statistics of the invalidated areas of a display
+ */
+typedef struct {
+    uint32_t saved;         /**< areas saved to be redrawn */
+    uint32_t dropped;       /**< areas not saved because they were in a saved one */
+    uint32_t overflows;     /**< times the buffer was full at its largest size and the areas were coalesced */
+    uint32_t peak;          /**< most areas saved at once */
+    uint32_t capacity;      /**< current size of the buffer */
+    uint32_t blitted;       /**< scrolled areas whose pixels were moved instead of redrawn */
+} lv_display_inv_stats_t;
+
+/**
+ * Join the invalidated areas of a display (`inv_areas`) by marking the joined ones in `inv_area_joined`.
+ */
+typedef void (*lv_display_join_areas_cb_t)(lv_display_t * disp);
+
+/**
+ * Move the pixels of an area on the display itself, e.g. with the scrolling commands of the controller.
+ * Called at the start of a refresh, after the flushes of the previous refresh and before the new ones.
+ * @param disp      pointer to a display
+ * @param area      the area in its new position
+ * @param dx        the content moved this many pixels to the right (negative: to the left)
+ * @param dy        the content moved this many pixels down (negative: up)
+ * @return          true: moved; false: not supported for this area, it will be redrawn
+ */
+typedef bool (*lv_display_blit_cb_t)(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -299,6 +337,31 @@ void lv_display_set_draw_buffers(lv_display_t * disp, lv_draw_buf_t * buf1, lv_d
  */
 void lv_display_set_3rd_draw_buffer(lv_display_t * disp, lv_draw_buf_t * buf3);
 
+/**
+ * Set a ring of draw buffers for PARTIAL rendering instead of one or two buffers.
+ * LVGL renders into the buffers in order and keeps rendering into the next free buffer while
+ * the previous ones are still being flushed, so many small buffers can keep a slow bus busy.
+ * It means `flush_cb` is called again before `lv_display_flush_ready()` was called for the previous
+ * buffer: the driver needs to queue the areas and call `lv_display_flush_ready()` once for each of them,
+ * in the same order.
+ * If set, `flush_wait_cb` is called while all buffers are being flushed and it should return
+ * after at least one `lv_display_flush_ready()`.
+ * @param disp              pointer to a display
+ * @param bufs              array of draw buffers with the same size (only the pointer is saved)
+ * @param buf_cnt           number of buffers in `bufs`, at least 2
+ */
+void lv_display_set_draw_buffer_ring(lv_display_t * disp, lv_draw_buf_t ** bufs, uint32_t buf_cnt);
+
+/**
+ * Set a ring of draw buffers for PARTIAL rendering, similarly to `lv_display_set_draw_buffer_ring`,
+ * but accept a single raw memory block which is split into `buf_cnt` buffers.
+ * @param disp              pointer to a display
+ * @param buf               memory for all the buffers (`buf_size * buf_cnt` bytes)
+ * @param buf_size          size of one buffer in bytes, it should be a multiple of `LV_DRAW_BUF_ALIGN`
+ * @param buf_cnt           number of buffers, at least 2
+ */
+void lv_display_set_buffer_ring(lv_display_t * disp, void * buf, uint32_t buf_size, uint32_t buf_cnt);
+
 /**
  * Set display render mode
  * @param disp              pointer to a display
@@ -323,6 +386,68 @@ void lv_display_set_flush_cb(lv_display_t * disp, lv_display_flush_cb_t flush_cb
  */
 void lv_display_set_flush_wait_cb(lv_display_t * disp, lv_display_flush_wait_cb_t wait_cb);
 
+/**
+ * Set the cost model of refreshing an area. Two invalidated areas are joined only if refreshing
+ * the joined area is cheaper than refreshing both, so a costly window (e.g. the commands
+ * and set-up of a transfer on a serial bus) joins nearby areas even if they don't overlap.
+ * @param disp      pointer to a display
+ * @param cost      the cost model (only its value is saved). NULL: the pixel count
+ *                  (an area is joined only if the joined area is smaller than the two together)
+ */
+void lv_display_set_area_cost(lv_display_t * disp, const lv_display_area_cost_t * cost);
+
+/**
+ * Get the cost of refreshing an area as one window with the display's cost model
+ * @param disp      pointer to a display
+ * @param area      the area to refresh
+ * @return          the cost in the unit of the cost model
+ */
+uint64_t lv_display_get_area_cost(lv_display_t * disp, const lv_area_t * area);
+
+/**
+ * Get the statistics of the invalidated areas. The buffer of the areas grows up to `LV_INV_BUF_MAX` areas,
+ * then the areas are snapped to a coarse grid and joined instead of redrawing the whole screen.
+ * @param disp      pointer to a display
+ * @param stats     the statistics are copied here
+ */
+void lv_display_get_inv_stats(lv_display_t * disp, lv_display_inv_stats_t * stats);
+
+/**
+ * Reset the statistics of the invalidated areas (except the size of the buffer)
+ * @param disp      pointer to a display
+ */
+void lv_display_reset_inv_stats(lv_display_t * disp);
+
+/**
+ * Keep the invalidated areas as a grid of dirty tiles instead of a list of areas.
+ * Invalidating an area just marks its tiles, and the refresh turns the runs of dirty tiles
+ * into areas. The runs of a row are joined over the gaps which cost less than an other window
+ * with the display's cost model (see `lv_display_set_area_cost`), and the runs with the
+ * same columns in the next rows are stacked into one area. The areas aren't joined further
+ * (`lv_display_set_join_areas_cb` isn't used).
+ * @param disp          pointer to a display
+ * @param tile_size     width and height of the tiles in pixels, a power of 2 from 4 (e.g. 16 or 32),
+ *                      0: keep a list of areas (default)
+ * @return              LV_RESULT_OK: set; LV_RESULT_INVALID: invalid size (not changed), or out of memory
+ *                      (the areas are kept in a list)
+ */
+lv_result_t lv_display_set_inv_tile_size(lv_display_t * disp, uint32_t tile_size);
+
+/**
+ * Get the size of the dirty tiles
+ * @param disp      pointer to a display
+ * @return          width and height of the tiles, 0 if the invalidated areas are kept in a list
+ */
+uint32_t lv_display_get_inv_tile_size(lv_display_t * disp);
+
+/**
+ * Set the strategy to join the invalidated areas before they are refreshed.
+ * @param disp      pointer to a display
+ * @param join_cb   `lv_refr_join_areas_sweep` (default), `lv_refr_join_areas_pairwise` or a custom one.
+ *                  NULL: the default
+ */
+void lv_display_set_join_areas_cb(lv_display_t * disp, lv_display_join_areas_cb_t join_cb);
+
 /**
  * Set the color format of the display.
  * @param disp              pointer to a display
@@ -357,6 +482,72 @@ void lv_display_set_tile_cnt(lv_display_t * disp, uint32_t tile_cnt);
  */
 uint32_t lv_display_get_tile_cnt(lv_display_t * disp);
 
+/**
+ * Drop the draw tasks hidden by opaque content drawn later in the same layer. Each layer keeps up to
+ * `LV_DRAW_OCCLUSION_QUEUE` draw tasks waiting instead of dispatching them right away. When an opaque
+ * fill, image or border is added, the waiting tasks it covers are dropped, and the ones it covers
+ * along a whole side are clipped. The rendered image is the same, only the overdraw is less.
+ * With `LV_USE_PERF_MONITOR` the overdraw with and without culling is shown too.
+ * @param disp      pointer to a display
+ * @param en        true: enable; false: dispatch every draw task right away (default)
+ */
+void lv_display_set_occlusion_culling(lv_display_t * disp, bool en);
+
+/**
+ * Get if the hidden draw tasks are dropped
+ * @param disp      pointer to a display (NULL to use the default display)
+ * @return          true/false
+ */
+bool lv_display_get_occlusion_culling(lv_display_t * disp);
+
+/**
+ * Track which draw tasks wait for which in a dependency graph instead of searching the older draw
+ * tasks of the layer each time a draw unit asks for work. When a draw task is added it's compared only
+ * with the unfinished tasks in the bins (`LV_DRAW_TASK_BIN_SIZE` pixels) of its area, and when it's
+ * finished the tasks waiting for it only are updated. The draw tasks without dependencies are
+ * handed out from a list. Worth it with several draw units or threads and many draw tasks per layer.
+ * A draw unit which queues draw tasks gets a task only after the older overlapping ones are finished,
+ * even if they are queued in the same draw unit.
+ * @param disp      pointer to a display
+ * @param en        true: enable; false: search the older draw tasks (default)
+ */
+void lv_display_set_draw_task_graph(lv_display_t * disp, bool en);
+
+/**
+ * Get if the dependencies of the draw tasks are tracked in a graph
+ * @param disp      pointer to a display (NULL to use the default display)
+ * @return          true/false
+ */
+bool lv_display_get_draw_task_graph(lv_display_t * disp);
+
+/**
+ * Move the rendered pixels of a scrolled widget instead of redrawing them, and redraw only the newly
+ * exposed parts, the scrollbars and the widgets on top of it. Used for plain widgets (`lv_obj`) with
+ * an opaque background without gradient or image, without opacity, transformation or draw events on
+ * them or their parents. One area is moved per refresh, the other scrolled widgets are redrawn.
+ * In `LV_DISPLAY_RENDER_MODE_DIRECT` the pixels are moved in the draw buffer (single or double
+ * buffered, not rotated). In `LV_DISPLAY_RENDER_MODE_PARTIAL` the display moves them, see
+ * `lv_display_set_blit_cb`. `LV_DISPLAY_RENDER_MODE_FULL` redraws the whole screen anyway.
+ * @param disp      pointer to a display
+ * @param en        true: enable; false: redraw the scrolled widgets (default)
+ */
+void lv_display_set_scroll_blit(lv_display_t * disp, bool en);
+
+/**
+ * Get if the pixels of the scrolled widgets are moved
+ * @param disp      pointer to a display (NULL to use the default display)
+ * @return          true/false
+ */
+bool lv_display_get_scroll_blit(lv_display_t * disp);
+
+/**
+ * Set the callback which moves pixels on the display for `lv_display_set_scroll_blit` in
+ * `LV_DISPLAY_RENDER_MODE_PARTIAL`
+ * @param disp      pointer to a display
+ * @param blit_cb   the callback, NULL: the scrolled widgets are redrawn
+ */
+void lv_display_set_blit_cb(lv_display_t * disp, lv_display_blit_cb_t blit_cb);
+
 /**
  * Disabling anti-aliasing is not supported since v9. This function will be removed.
  * Enable anti-aliasing for the render engine
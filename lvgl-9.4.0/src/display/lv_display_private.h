@@ -26,7 +26,15 @@ extern "C" {
  *      DEFINES
  *********************/
 #ifndef LV_INV_BUF_SIZE
-#define LV_INV_BUF_SIZE 32 /**< Buffer size for invalid areas */
+#define LV_INV_BUF_SIZE 32 /**< Initial buffer size for invalid areas */
+#endif
+
+#ifndef LV_INV_BUF_MAX
+#define LV_INV_BUF_MAX 256 /**< The buffer for invalid areas grows up to this size, then the areas are coalesced */
+#endif
+
+#ifndef LV_INV_COALESCE_TILE
+#define LV_INV_COALESCE_TILE 16 /**< Coalescing snaps the invalid areas to a grid, starting with this size */
 #endif
 
 /**********************
@@ -70,6 +78,18 @@ struct _lv_display_t {
     /** Internal, used by the library*/
     lv_draw_buf_t * buf_act;
 
+    /** Ring of draw buffers used instead of `buf_1`/`buf_2`/`buf_3` in PARTIAL mode.
+     * `NULL` if not used. See `lv_display_set_draw_buffer_ring()`*/
+    lv_draw_buf_t ** buf_ring;
+    uint32_t buf_ring_cnt;
+
+    /** Number of ring buffers passed to `flush_cb`. Written only by the rendering.*/
+    uint32_t buf_ring_submitted;
+
+    /** Number of ring buffers reported as flushed by `lv_display_flush_ready()`.
+     * Written only by the driver so it can be updated from an IRQ or an other core without locking.*/
+    volatile uint32_t buf_ring_flushed;
+
     /** MANDATORY: Write the internal buffer (draw_buf) to the display. 'lv_display_flush_ready()' has to be
      * called when finished*/
     lv_display_flush_cb_t flush_cb;
@@ -94,6 +114,10 @@ struct _lv_display_t {
     uint32_t antialiasing : 1;       /**< 1: anti-aliasing is enabled on this display.*/
     uint32_t tile_cnt     : 8;       /**< Divide the display buffer into these number of tiles */
     uint32_t stride_is_auto : 1;     /**< 1: The stride of the buffers was not set explicitly. */
+    uint32_t occlusion_culling : 1;  /**< 1: Drop the draw tasks hidden by opaque tasks added later*/
+    uint32_t scroll_blit : 1;        /**< 1: Move the pixels of the scrolled widgets instead of redrawing them*/
+    uint32_t blit_pending : 1;       /**< 1: `blit_area` is moved by `blit_ofs` at the next refresh*/
+    uint32_t draw_task_graph : 1;    /**< 1: Track the dependencies of the draw tasks in a graph*/
 
 
     /** 1: The current screen rendering is in progress*/
@@ -101,17 +125,40 @@ struct _lv_display_t {
 
     lv_color_format_t   color_format;
 
-    /** Invalidated (marked to redraw) areas*/
-    lv_area_t inv_areas[LV_INV_BUF_SIZE];
-    uint8_t inv_area_joined[LV_INV_BUF_SIZE];
+    /** Invalidated (marked to redraw) areas, `inv_cap` of them fit into the buffer*/
+    lv_area_t * inv_areas;
+    uint8_t * inv_area_joined;
+    uint16_t * inv_order;       /**< Scratch for joining the areas: `2 * inv_cap` indices */
     uint32_t inv_p;
+    uint32_t inv_cap;
+    lv_display_inv_stats_t inv_stats;
+
+    /** Dirty tiles instead of the list of areas if `inv_tile_size` isn't 0: a bit per tile, row by row*/
+    uint32_t * inv_tiles;
+    uint32_t inv_tile_size;
+    uint16_t inv_tile_cols;
+    uint16_t inv_tile_rows;
+    uint16_t inv_tile_stride;   /**< 32 bit words per row of tiles */
+    uint8_t inv_tile_shift;
+    uint8_t inv_tiles_dirty : 1;
+
+    /** Cost model and strategy to join the invalidated areas */
+    lv_display_area_cost_t area_cost;
+    lv_display_join_areas_cb_t join_areas_cb;
     int32_t inv_en_cnt;
 
+    /** Scrolled area to move at the next refresh, in its new position, and how much it moved*/
+    lv_area_t blit_area;
+    lv_point_t blit_ofs;
+    lv_display_blit_cb_t blit_cb;
+
     /** Double buffer sync areas (redrawn during last refresh) */
     lv_ll_t sync_areas;
 
     lv_draw_buf_t _static_buf1; /**< Used when user pass in a raw buffer as display draw buffer */
     lv_draw_buf_t _static_buf2;
+    lv_draw_buf_t * _static_ring;   /**< Allocated when the user passes in a raw buffer as a draw buffer ring */
+    lv_draw_buf_t ** _static_ring_ptrs;
     /*---------------------
      * Layer
      *--------------------*/
@@ -177,6 +224,21 @@ struct _lv_display_t {
  * GLOBAL PROTOTYPES
  **********************/
 
+/**
+ * Resize the buffer of the invalidated areas, keeping the saved areas
+ * @param disp      pointer to a display
+ * @param cap       new number of areas, at least `inv_p`
+ * @return          LV_RESULT_OK: resized; LV_RESULT_INVALID: out of memory, the buffer is unchanged
+ */
+lv_result_t lv_display_resize_inv_buf(lv_display_t * disp, uint32_t cap);
+
+/**
+ * Mark the tiles of an area dirty
+ * @param disp      pointer to a display with dirty tiles (see `lv_display_set_inv_tile_size`)
+ * @param area      area on the screen
+ */
+void lv_display_mark_inv_tiles(lv_display_t * disp, const lv_area_t * area);
+
 /**********************
  *      MACROS
  **********************/
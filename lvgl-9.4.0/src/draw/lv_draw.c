@@ -39,6 +39,23 @@ static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check, uint8_t
 static void cleanup_task(lv_draw_task_t * t, lv_display_t * disp);
 static inline size_t get_draw_dsc_size(lv_draw_task_type_t type);
 static lv_draw_task_t * get_first_available_task(lv_layer_t * layer);
+static uint32_t occlusion_cull(lv_display_t * disp, lv_layer_t * layer, lv_draw_task_t * t);
+static uint32_t get_opaque_areas(const lv_draw_task_t * t, lv_area_t areas[]);
+static bool is_opaque_image_cf(lv_color_format_t cf);
+static bool get_drawn_area(const lv_draw_task_t * t, lv_area_t * area);
+static uint32_t get_task_px(const lv_draw_task_t * t);
+static void unlink_task(lv_layer_t * layer, lv_draw_task_t * t);
+static void task_graph_create(lv_layer_t * layer);
+static void task_graph_delete(lv_layer_t * layer);
+static void task_graph_add(lv_layer_t * layer, lv_draw_task_t * t);
+static void task_graph_drop(lv_layer_t * layer, lv_draw_task_t * t);
+static void task_graph_remove(lv_layer_t * layer, lv_draw_task_t * t);
+static bool task_graph_collect(lv_display_t * disp, lv_layer_t * layer);
+static void task_graph_sweep_offered(lv_draw_task_graph_t * graph);
+static lv_draw_task_t * task_graph_get_ready(lv_layer_t * layer, lv_draw_task_t * t_prev, uint8_t draw_unit_id);
+static void task_graph_link(lv_draw_task_graph_t * graph, lv_draw_task_t * t, lv_draw_task_graph_list_t list);
+static void task_graph_unlink(lv_draw_task_graph_t * graph, lv_draw_task_t * t);
+static bool task_graph_push(lv_draw_task_t *** tasks, uint32_t * cnt, uint32_t * size, lv_draw_task_t * t);
 
 #if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
 static inline uint32_t get_layer_size_kb(uint32_t size_byte)
@@ -64,6 +81,7 @@ void lv_draw_init(void)
 #if LV_USE_OS
     lv_thread_sync_init(&_draw_info.sync);
 #endif
+    lv_draw_arena_init(LV_DRAW_ARENA_DEF_SIZE);
 }
 
 void lv_draw_deinit(void)
@@ -81,6 +99,8 @@ void lv_draw_deinit(void)
         lv_free(cur_unit);
     }
     _draw_info.unit_head = NULL;
+
+    lv_draw_arena_deinit();
 }
 
 void * lv_draw_create_unit(size_t size)
@@ -102,8 +122,10 @@ lv_draw_task_t * lv_draw_add_task(lv_layer_t * layer, const lv_area_t * coords,
     LV_PROFILER_DRAW_BEGIN;
     size_t dsc_size = get_draw_dsc_size(type);
     LV_ASSERT_FORMAT_MSG(dsc_size > 0, "Draw task size is 0 for type %d", type);
-    lv_draw_task_t * new_task = lv_malloc_zeroed(LV_ALIGN_UP(sizeof(lv_draw_task_t), 8) + dsc_size);
+    size_t task_size = LV_ALIGN_UP(sizeof(lv_draw_task_t), 8) + dsc_size;
+    lv_draw_task_t * new_task = lv_draw_arena_alloc(task_size);
     LV_ASSERT_MALLOC(new_task);
+    lv_memzero(new_task, task_size);
     new_task->area = *coords;
     new_task->_real_area = *coords;
     new_task->target_layer = layer;
@@ -116,16 +138,15 @@ lv_draw_task_t * lv_draw_add_task(lv_layer_t * layer, const lv_area_t * coords,
     new_task->draw_dsc = (uint8_t *)new_task + LV_ALIGN_UP(sizeof(lv_draw_task_t), 8);
     new_task->state = LV_DRAW_TASK_STATE_WAITING;
 
-    /*Find the tail*/
+    /*Append to the tail*/
     if(layer->draw_task_head == NULL) {
         layer->draw_task_head = new_task;
     }
     else {
-        lv_draw_task_t * tail = layer->draw_task_head;
-        while(tail->next) tail = tail->next;
-
-        tail->next = new_task;
+        new_task->prev = layer->draw_task_tail;
+        layer->draw_task_tail->next = new_task;
     }
+    layer->draw_task_tail = new_task;
 
     LV_PROFILER_DRAW_END;
     return new_task;
@@ -137,7 +158,22 @@ void lv_draw_finalize_task_creation(lv_layer_t * layer, lv_draw_task_t * t)
     lv_draw_dsc_base_t * base_dsc = t->draw_dsc;
     base_dsc->layer = layer;
 
+    /*Keep it for the widget being drawn to add it again without its draw events*/
+    lv_obj_draw_list_record_task(layer, t, get_draw_dsc_size(t->type));
+
     lv_draw_global_info_t * info = &_draw_info;
+    lv_display_t * disp = lv_refr_get_disp_refreshing();
+
+#if LV_USE_PERF_MONITOR
+    if(disp) disp->perf_sysmon_info.measured.draw_px += get_task_px(t);
+#endif
+
+    /*Before the event, as the draw tasks added in it have to wait for this one.
+     *A graph is started only with the first draw task of the layer.*/
+    if(layer->task_graph == NULL && layer->draw_task_head == t && disp && disp->draw_task_graph) {
+        task_graph_create(layer);
+    }
+    if(layer->task_graph) task_graph_add(layer, t);
 
     /*Send LV_EVENT_DRAW_TASK_ADDED and dispatch only on the "main" draw_task
      *and not on the draw tasks added in the event.
@@ -168,6 +204,12 @@ void lv_draw_finalize_task_creation(lv_layer_t * layer, lv_draw_task_t * t)
         if(t->preferred_draw_unit_id == LV_DRAW_UNIT_NONE) {
             LV_LOG_WARN("the draw task was not taken by any units");
             t->state = LV_DRAW_TASK_STATE_FINISHED;
+            if(layer->task_graph) task_graph_drop(layer, t);
+        }
+        else if(disp && disp->occlusion_culling &&
+                occlusion_cull(disp, layer, t) < LV_DRAW_OCCLUSION_QUEUE) {
+            /*Keep it waiting for opaque tasks on top of it, the refresh will dispatch it*/
+            lv_draw_dispatch_request();
         }
         else {
             lv_draw_dispatch();
@@ -235,24 +277,24 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
 {
     LV_PROFILER_DRAW_BEGIN;
     /*Remove the finished tasks first*/
-    lv_draw_task_t * t_prev = NULL;
-    lv_draw_task_t * t = layer->draw_task_head;
-    lv_draw_task_t * t_next;
     bool remove_task = false;
-    while(t) {
-        t_next = t->next;
-        if(t->state == LV_DRAW_TASK_STATE_FINISHED) {
-            cleanup_task(t, disp);
-            remove_task = true;
-            if(t_prev != NULL)
-                t_prev->next = t_next;
-            else
-                layer->draw_task_head = t_next;
-        }
-        else {
-            t_prev = t;
+    if(layer->task_graph) {
+        /*Only the taken ones can be finished*/
+        remove_task = task_graph_collect(disp, layer);
+        if(layer->draw_task_head == NULL) task_graph_delete(layer);
+    }
+    else {
+        lv_draw_task_t * t = layer->draw_task_head;
+        lv_draw_task_t * t_next;
+        while(t) {
+            t_next = t->next;
+            if(t->state == LV_DRAW_TASK_STATE_FINISHED) {
+                unlink_task(layer, t);
+                cleanup_task(t, disp);
+                remove_task = true;
+            }
+            t = t_next;
         }
-        t = t_next;
     }
 
     bool task_dispatched = false;
@@ -284,6 +326,7 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
             int32_t taken_cnt = u->dispatch_cb(u, layer);
             LV_PROFILER_DRAW_END_TAG(u->name);
             LV_PROFILER_DRAW_END_TAG("dispatch_cb");
+            if(layer->task_graph) task_graph_sweep_offered(layer->task_graph);
             if(taken_cnt != LV_DRAW_UNIT_IDLE) task_dispatched = true;
             u = u->next;
         }
@@ -323,7 +366,10 @@ uint32_t lv_draw_get_unit_count(void)
 
 lv_draw_task_t * lv_draw_get_available_task(lv_layer_t * layer, lv_draw_task_t * t_prev, uint8_t draw_unit_id)
 {
-    if(_draw_info.unit_cnt == 1) {
+    if(layer->task_graph) {
+        return task_graph_get_ready(layer, t_prev, draw_unit_id);
+    }
+    else if(_draw_info.unit_cnt == 1) {
         return get_first_available_task(layer);
     }
     else {
@@ -333,6 +379,8 @@ lv_draw_task_t * lv_draw_get_available_task(lv_layer_t * layer, lv_draw_task_t *
 
 lv_draw_task_t * lv_draw_get_next_available_task(lv_layer_t * layer, lv_draw_task_t * t_prev, uint8_t draw_unit_id)
 {
+    if(layer->task_graph) return task_graph_get_ready(layer, t_prev, draw_unit_id);
+
     LV_PROFILER_DRAW_BEGIN;
 
     /*If the first task is screen sized, there cannot be independent areas*/
@@ -429,12 +477,13 @@ void lv_layer_reset(lv_layer_t * layer)
 lv_layer_t * lv_draw_layer_create(lv_layer_t * parent_layer, lv_color_format_t color_format, const lv_area_t * area)
 {
     LV_PROFILER_DRAW_BEGIN;
-    lv_layer_t * new_layer = lv_malloc_zeroed(sizeof(lv_layer_t));
+    lv_layer_t * new_layer = lv_draw_arena_alloc(sizeof(lv_layer_t));
     LV_ASSERT_MALLOC(new_layer);
     if(new_layer == NULL) {
         LV_PROFILER_DRAW_END;
         return NULL;
     }
+    lv_memzero(new_layer, sizeof(lv_layer_t));
 
     lv_draw_layer_init(new_layer, parent_layer, color_format, area);
 
@@ -575,6 +624,231 @@ static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check, uint8_t
     return true;
 }
 
+/**
+ * Drop the waiting draw tasks of a layer which are hidden by the opaque areas of a new draw task,
+ * and clip the ones which are hidden along a whole side.
+ * @param disp      the display being refreshed
+ * @param layer     the layer of the new draw task
+ * @param t         the new draw task, the last one in the layer
+ * @return          number of draw tasks waiting in the layer including `t`
+ */
+static uint32_t occlusion_cull(lv_display_t * disp, lv_layer_t * layer, lv_draw_task_t * t)
+{
+    LV_PROFILER_DRAW_BEGIN;
+    lv_area_t opaque_areas[4];
+    uint32_t opaque_cnt = get_opaque_areas(t, opaque_areas);
+    uint32_t waiting_cnt = 1;
+    uint32_t culled_px = 0;
+
+    lv_draw_task_t * t_prev;
+    for(t_prev = layer->draw_task_head; t_prev != t; t_prev = t_prev->next) {
+        if(t_prev->state != LV_DRAW_TASK_STATE_WAITING) continue;
+        waiting_cnt++;
+
+        lv_area_t drawn;
+        if(opaque_cnt == 0 || !get_drawn_area(t_prev, &drawn)) continue;
+
+        lv_area_t visible = drawn;
+        bool hidden = false;
+        uint32_t i;
+        for(i = 0; i < opaque_cnt && !hidden; i++) {
+            const lv_area_t * o = &opaque_areas[i];
+            if(o->x1 <= visible.x1 && o->x2 >= visible.x2) {
+                /*Covers whole rows: cut the top or bottom*/
+                if(o->y1 <= visible.y1 && o->y2 >= visible.y1) visible.y1 = o->y2 + 1;
+                else if(o->y1 <= visible.y2 && o->y2 >= visible.y2) visible.y2 = o->y1 - 1;
+            }
+            else if(o->y1 <= visible.y1 && o->y2 >= visible.y2) {
+                /*Covers whole columns: cut the left or right*/
+                if(o->x1 <= visible.x1 && o->x2 >= visible.x1) visible.x1 = o->x2 + 1;
+                else if(o->x1 <= visible.x2 && o->x2 >= visible.x2) visible.x2 = o->x1 - 1;
+            }
+            hidden = visible.x1 > visible.x2 || visible.y1 > visible.y2;
+        }
+
+        uint32_t px = get_task_px(t_prev);
+        if(hidden) {
+            t_prev->state = LV_DRAW_TASK_STATE_FINISHED;
+            if(layer->task_graph) task_graph_drop(layer, t_prev);
+            culled_px += px;
+            waiting_cnt--;
+        }
+        else if(!lv_area_is_equal(&visible, &drawn)) {
+            /*Only the cut sides are clipped, the others can draw out of `_real_area` (e.g. letters)*/
+            if(visible.x1 != drawn.x1) t_prev->clip_area.x1 = visible.x1;
+            if(visible.x2 != drawn.x2) t_prev->clip_area.x2 = visible.x2;
+            if(visible.y1 != drawn.y1) t_prev->clip_area.y1 = visible.y1;
+            if(visible.y2 != drawn.y2) t_prev->clip_area.y2 = visible.y2;
+            culled_px += px - get_task_px(t_prev);
+        }
+    }
+
+#if LV_USE_PERF_MONITOR
+    disp->perf_sysmon_info.measured.draw_px -= culled_px;
+    disp->perf_sysmon_info.measured.draw_px_culled += culled_px;
+    disp->perf_sysmon_info.measured.occlusion_culling = 1;
+#else
+    LV_UNUSED(disp);
+    LV_UNUSED(culled_px);
+#endif
+
+    LV_PROFILER_DRAW_END;
+    return waiting_cnt;
+}
+
+/**
+ * Get the areas a draw task surely covers with opaque pixels
+ * @param t         the draw task
+ * @param areas     store the areas here, at most 4 of them
+ * @return          number of areas, 0 if the draw task isn't opaque anywhere
+ */
+static uint32_t get_opaque_areas(const lv_draw_task_t * t, lv_area_t areas[])
+{
+#if LV_DRAW_TRANSFORM_USE_MATRIX
+    /*The areas would need to be transformed*/
+    LV_UNUSED(t);
+    LV_UNUSED(areas);
+    return 0;
+#else
+    if(t->opa < LV_OPA_MAX) return 0;
+
+    const lv_area_t * a = &t->area;
+    int32_t w = lv_area_get_width(a);
+    int32_t h = lv_area_get_height(a);
+    int32_t short_side = LV_MIN(w, h);
+    uint32_t cnt = 0;
+
+    switch(t->type) {
+        case LV_DRAW_TASK_TYPE_FILL: {
+                const lv_draw_fill_dsc_t * dsc = t->draw_dsc;
+                if(dsc->opa < LV_OPA_MAX) return 0;
+                if(dsc->grad.dir != LV_GRAD_DIR_NONE) {
+                    uint32_t s;
+                    for(s = 0; s < dsc->grad.stops_count; s++) {
+                        if(dsc->grad.stops[s].opa != LV_OPA_COVER) return 0;
+                    }
+                }
+
+                /*With a radius the rows between the corners and the columns between the corners are covered*/
+                int32_t r = LV_MIN(dsc->radius, short_side >> 1);
+#if LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX == 0
+                /*Not drawn at all by the software renderer*/
+                if(r > 0 || dsc->grad.dir != LV_GRAD_DIR_NONE) return 0;
+#endif
+                lv_area_set(&areas[cnt++], a->x1, a->y1 + r, a->x2, a->y2 - r);
+                if(r > 0) lv_area_set(&areas[cnt++], a->x1 + r, a->y1, a->x2 - r, a->y2);
+                break;
+            }
+        case LV_DRAW_TASK_TYPE_BORDER: {
+                const lv_draw_border_dsc_t * dsc = t->draw_dsc;
+                if(dsc->opa < LV_OPA_MAX || dsc->side != LV_BORDER_SIDE_FULL) return 0;
+                if(dsc->width <= 0 || dsc->width * 2 >= short_side) return 0;
+
+                /*The straight parts of the sides*/
+                int32_t r = LV_MIN(dsc->radius, short_side >> 1);
+#if LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX == 0
+                if(r > 0) return 0;
+#endif
+                int32_t bw = dsc->width;
+                lv_area_set(&areas[cnt++], a->x1 + r, a->y1, a->x2 - r, a->y1 + bw - 1);
+                lv_area_set(&areas[cnt++], a->x1 + r, a->y2 - bw + 1, a->x2 - r, a->y2);
+                lv_area_set(&areas[cnt++], a->x1, a->y1 + r, a->x1 + bw - 1, a->y2 - r);
+                lv_area_set(&areas[cnt++], a->x2 - bw + 1, a->y1 + r, a->x2, a->y2 - r);
+                break;
+            }
+        case LV_DRAW_TASK_TYPE_IMAGE: {
+                const lv_draw_image_dsc_t * dsc = t->draw_dsc;
+                if(dsc->opa < LV_OPA_MAX || !is_opaque_image_cf(dsc->header.cf)) return 0;
+                if(dsc->rotation != 0 || dsc->scale_x != LV_SCALE_NONE || dsc->scale_y != LV_SCALE_NONE ||
+                   dsc->skew_x != 0 || dsc->skew_y != 0) return 0;
+                if(dsc->blend_mode != LV_BLEND_MODE_NORMAL || dsc->clip_radius != 0 ||
+                   dsc->colorkey || dsc->bitmap_mask_src) return 0;
+                /*Files might fail to open, so an image from a file can't hide anything*/
+                if(lv_image_src_get_type(dsc->src) != LV_IMAGE_SRC_VARIABLE) return 0;
+                if(!lv_area_is_equal(&dsc->image_area, a)) return 0;
+                if(!dsc->tile && (w != dsc->header.w || h != dsc->header.h)) return 0;
+
+                areas[cnt++] = *a;
+                break;
+            }
+        default:
+            return 0;
+    }
+
+    /*Only the part which is drawn*/
+    uint32_t i;
+    uint32_t kept = 0;
+    for(i = 0; i < cnt; i++) {
+        if(lv_area_intersect(&areas[kept], &areas[i], &t->clip_area)) kept++;
+    }
+    return kept;
+#endif /*LV_DRAW_TRANSFORM_USE_MATRIX*/
+}
+
+/**
+ * Check if an image of a color format is opaque and can be drawn by the software renderer
+ * @param cf        the color format of the image
+ * @return          true: all pixels are opaque
+ */
+static bool is_opaque_image_cf(lv_color_format_t cf)
+{
+    switch(cf) {
+        case LV_COLOR_FORMAT_RGB565:
+#if LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+        case LV_COLOR_FORMAT_RGB565_SWAPPED:
+#endif
+#if LV_DRAW_SW_SUPPORT_RGB888
+        case LV_COLOR_FORMAT_RGB888:
+#endif
+#if LV_DRAW_SW_SUPPORT_XRGB8888
+        case LV_COLOR_FORMAT_XRGB8888:
+#endif
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Get the area a draw task can draw to if it's a task that only draws there
+ * @param t         the draw task
+ * @param area      store the area here
+ * @return          true: the draw task can be culled; false: unknown effect or nothing is drawn
+ */
+static bool get_drawn_area(const lv_draw_task_t * t, lv_area_t * area)
+{
+    switch(t->type) {
+        case LV_DRAW_TASK_TYPE_FILL:
+        case LV_DRAW_TASK_TYPE_BORDER:
+        case LV_DRAW_TASK_TYPE_BOX_SHADOW:
+        case LV_DRAW_TASK_TYPE_IMAGE:
+        case LV_DRAW_TASK_TYPE_LINE:
+        case LV_DRAW_TASK_TYPE_ARC:
+        case LV_DRAW_TASK_TYPE_TRIANGLE:
+            return lv_area_intersect(area, &t->_real_area, &t->clip_area);
+        case LV_DRAW_TASK_TYPE_LABEL:
+        case LV_DRAW_TASK_TYPE_LETTER:
+            /*Glyphs can be out of the area of the label*/
+            *area = t->clip_area;
+            return true;
+        default:
+            /*Layers and masks also use what was drawn before them*/
+            return false;
+    }
+}
+
+/**
+ * Get the number of pixels a draw task draws to
+ * @param t         the draw task
+ * @return          the size of its area on the clip area
+ */
+static uint32_t get_task_px(const lv_draw_task_t * t)
+{
+    lv_area_t a;
+    if(!lv_area_intersect(&a, &t->_real_area, &t->clip_area)) return 0;
+    return lv_area_get_size(&a);
+}
+
 /**
  * Get the size of the draw descriptor of a draw task
  * @param type      type of the draw task
@@ -672,16 +946,17 @@ static void cleanup_task(lv_draw_task_t * t, lv_display_t * disp)
                 disp->layer_deinit(disp, layer_drawn);
                 LV_PROFILER_DRAW_END_TAG("layer_deinit");
             }
-            lv_free(layer_drawn);
+            lv_draw_arena_free(layer_drawn);
         }
     }
     lv_draw_label_dsc_t * draw_label_dsc = lv_draw_task_get_label_dsc(t);
     if(draw_label_dsc && draw_label_dsc->text_local) {
-        lv_free((void *)draw_label_dsc->text);
+        lv_draw_arena_free((void *)draw_label_dsc->text);
         draw_label_dsc->text = NULL;
     }
 
-    lv_free(t);
+    lv_free(t->dependents);
+    lv_draw_arena_free(t);
     LV_PROFILER_DRAW_END;
 }
 
@@ -713,3 +988,347 @@ static lv_draw_task_t * get_first_available_task(lv_layer_t * layer)
     LV_PROFILER_DRAW_END;
     return t;
 }
+
+/**
+ * Remove a draw task from the list of its layer
+ * @param layer     the layer of the draw task
+ * @param t         the draw task to remove
+ */
+static void unlink_task(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    if(t->prev) t->prev->next = t->next;
+    else layer->draw_task_head = t->next;
+
+    if(t->next) t->next->prev = t->prev;
+    else layer->draw_task_tail = t->prev;
+}
+
+/**
+ * Start tracking the dependencies of the draw tasks of a layer. The bins cover the buffer of the layer.
+ * If out of memory the older draw tasks will be searched as without the graph.
+ * @param layer     the layer, it has no draw tasks yet
+ */
+static void task_graph_create(lv_layer_t * layer)
+{
+    int32_t w = lv_area_get_width(&layer->buf_area);
+    int32_t h = lv_area_get_height(&layer->buf_area);
+    if(w <= 0 || h <= 0) return;
+
+    lv_draw_task_graph_t * graph = lv_malloc_zeroed(sizeof(lv_draw_task_graph_t));
+    if(graph == NULL) return;
+
+    graph->area = layer->buf_area;
+    graph->cols = (w + LV_DRAW_TASK_BIN_SIZE - 1) / LV_DRAW_TASK_BIN_SIZE;
+    graph->rows = (h + LV_DRAW_TASK_BIN_SIZE - 1) / LV_DRAW_TASK_BIN_SIZE;
+    graph->bins = lv_malloc_zeroed(graph->cols * graph->rows * sizeof(lv_draw_task_bin_t));
+    if(graph->bins == NULL) {
+        lv_free(graph);
+        return;
+    }
+
+    layer->task_graph = graph;
+}
+
+/**
+ * Stop tracking the dependencies of the draw tasks of a layer
+ * @param layer     the layer
+ */
+static void task_graph_delete(lv_layer_t * layer)
+{
+    lv_draw_task_graph_t * graph = layer->task_graph;
+    uint32_t i;
+    for(i = 0; i < graph->cols * graph->rows; i++) {
+        lv_free(graph->bins[i].tasks);
+    }
+    lv_free(graph->bins);
+    lv_free(graph);
+    layer->task_graph = NULL;
+}
+
+/**
+ * Make a new draw task wait for the older unfinished ones it overlaps. Only the tasks in the bins of its
+ * area are compared with it. The ones it hides in a bin are removed from there: a later task overlapping
+ * them in the bin overlaps the new task too, and waits for it.
+ * If out of memory the graph is deleted, and the older draw tasks will be searched as without it.
+ * @param layer     the layer of the draw task
+ * @param t         the new draw task
+ */
+static void task_graph_add(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    LV_PROFILER_DRAW_BEGIN;
+    lv_draw_task_graph_t * graph = layer->task_graph;
+    graph->stamp++;
+    t->blocker_cnt = 0;
+
+    /*Only the pixels it can change matter*/
+    if(!lv_area_intersect(&t->graph_area, &t->_real_area, &t->clip_area) ||
+       !lv_area_intersect(&t->graph_area, &t->graph_area, &graph->area)) {
+        lv_area_set(&t->graph_area, 0, 0, -1, -1);
+        task_graph_link(graph, t, LV_DRAW_TASK_GRAPH_LIST_READY);
+        LV_PROFILER_DRAW_END;
+        return;
+    }
+
+    const int32_t bin_size = LV_DRAW_TASK_BIN_SIZE;
+    int32_t col1 = (t->graph_area.x1 - graph->area.x1) / bin_size;
+    int32_t col2 = (t->graph_area.x2 - graph->area.x1) / bin_size;
+    int32_t row1 = (t->graph_area.y1 - graph->area.y1) / bin_size;
+    int32_t row2 = (t->graph_area.y2 - graph->area.y1) / bin_size;
+    int32_t row;
+    for(row = row1; row <= row2; row++) {
+        int32_t col;
+        for(col = col1; col <= col2; col++) {
+            lv_draw_task_bin_t * bin = &graph->bins[row * graph->cols + col];
+            lv_area_t bin_area;
+            bin_area.x1 = graph->area.x1 + col * bin_size;
+            bin_area.y1 = graph->area.y1 + row * bin_size;
+            bin_area.x2 = bin_area.x1 + bin_size - 1;
+            bin_area.y2 = bin_area.y1 + bin_size - 1;
+            lv_area_intersect(&bin_area, &bin_area, &graph->area);
+
+            uint32_t kept = 0;
+            uint32_t i;
+            for(i = 0; i < bin->cnt; i++) {
+                lv_draw_task_t * t_old = bin->tasks[i];
+                if(t_old->graph_stamp != graph->stamp && lv_area_is_on(&t_old->graph_area, &t->graph_area)) {
+                    t_old->graph_stamp = graph->stamp;
+                    if(!task_graph_push(&t_old->dependents, &t_old->dependent_cnt, &t_old->dependent_size, t)) {
+                        task_graph_delete(layer);
+                        LV_PROFILER_DRAW_END;
+                        return;
+                    }
+                    t->blocker_cnt++;
+                }
+
+                lv_area_t in_bin;
+                lv_area_intersect(&in_bin, &t_old->graph_area, &bin_area);
+                if(!lv_area_is_in(&in_bin, &t->graph_area, 0)) bin->tasks[kept++] = t_old;
+            }
+            bin->cnt = kept;
+
+            if(!task_graph_push(&bin->tasks, &bin->cnt, &bin->size, t)) {
+                task_graph_delete(layer);
+                LV_PROFILER_DRAW_END;
+                return;
+            }
+        }
+    }
+
+    if(t->blocker_cnt == 0) task_graph_link(graph, t, LV_DRAW_TASK_GRAPH_LIST_READY);
+    LV_PROFILER_DRAW_END;
+}
+
+/**
+ * A draw task was finished without drawing it (e.g. hidden by an other one).
+ * It's removed from the graph when the older draw tasks it waits for are finished too.
+ * @param layer     the layer of the draw task
+ * @param t         the finished draw task
+ */
+static void task_graph_drop(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    lv_draw_task_graph_t * graph = layer->task_graph;
+
+    /*It might be freed soon*/
+    task_graph_sweep_offered(graph);
+
+    if(t->graph_list == LV_DRAW_TASK_GRAPH_LIST_READY) {
+        task_graph_unlink(graph, t);
+        task_graph_link(graph, t, LV_DRAW_TASK_GRAPH_LIST_TAKEN);
+    }
+}
+
+/**
+ * Remove a finished draw task from the graph and let the draw tasks waiting only for it go
+ * @param layer     the layer of the draw task
+ * @param t         the finished draw task
+ */
+static void task_graph_remove(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    lv_draw_task_graph_t * graph = layer->task_graph;
+    task_graph_unlink(graph, t);
+
+    if(t->graph_area.x1 <= t->graph_area.x2) {
+        const int32_t bin_size = LV_DRAW_TASK_BIN_SIZE;
+        int32_t col1 = (t->graph_area.x1 - graph->area.x1) / bin_size;
+        int32_t col2 = (t->graph_area.x2 - graph->area.x1) / bin_size;
+        int32_t row1 = (t->graph_area.y1 - graph->area.y1) / bin_size;
+        int32_t row2 = (t->graph_area.y2 - graph->area.y1) / bin_size;
+        int32_t row;
+        for(row = row1; row <= row2; row++) {
+            int32_t col;
+            for(col = col1; col <= col2; col++) {
+                /*The order in a bin doesn't matter*/
+                lv_draw_task_bin_t * bin = &graph->bins[row * graph->cols + col];
+                uint32_t i;
+                for(i = 0; i < bin->cnt; i++) {
+                    if(bin->tasks[i] == t) {
+                        bin->tasks[i] = bin->tasks[--bin->cnt];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    uint32_t i;
+    for(i = 0; i < t->dependent_cnt; i++) {
+        lv_draw_task_t * t_dep = t->dependents[i];
+        t_dep->blocker_cnt--;
+        if(t_dep->blocker_cnt == 0) {
+            task_graph_link(graph, t_dep, t_dep->state == LV_DRAW_TASK_STATE_FINISHED ?
+                            LV_DRAW_TASK_GRAPH_LIST_TAKEN : LV_DRAW_TASK_GRAPH_LIST_READY);
+        }
+    }
+    t->dependent_cnt = 0;
+}
+
+/**
+ * Remove and free the finished draw tasks of a layer with a graph
+ * @param disp      the display being refreshed or NULL
+ * @param layer     the layer
+ * @return          true: at least one draw task was removed
+ */
+static bool task_graph_collect(lv_display_t * disp, lv_layer_t * layer)
+{
+    LV_PROFILER_DRAW_BEGIN;
+    lv_draw_task_graph_t * graph = layer->task_graph;
+    task_graph_sweep_offered(graph);
+
+    /*Removing a task can make dropped ones finished too*/
+    bool removed = false;
+    bool found;
+    do {
+        found = false;
+        lv_draw_task_t * t = graph->taken_head;
+        while(t) {
+            lv_draw_task_t * t_next = t->graph_next;
+            if(t->state == LV_DRAW_TASK_STATE_FINISHED) {
+                task_graph_remove(layer, t);
+                unlink_task(layer, t);
+                cleanup_task(t, disp);
+                found = true;
+            }
+            t = t_next;
+        }
+        removed |= found;
+    } while(found);
+
+    LV_PROFILER_DRAW_END;
+    return removed;
+}
+
+/**
+ * Move the handed out draw tasks which were taken by a draw unit to the taken list
+ * @param graph     the graph of a layer
+ */
+static void task_graph_sweep_offered(lv_draw_task_graph_t * graph)
+{
+    uint32_t i;
+    for(i = 0; i < graph->offered_cnt; i++) {
+        lv_draw_task_t * t = graph->offered[i];
+        if(t->graph_list == LV_DRAW_TASK_GRAPH_LIST_READY &&
+           t->state != LV_DRAW_TASK_STATE_WAITING && t->state != LV_DRAW_TASK_STATE_BLOCKED) {
+            task_graph_unlink(graph, t);
+            task_graph_link(graph, t, LV_DRAW_TASK_GRAPH_LIST_TAKEN);
+        }
+    }
+    graph->offered_cnt = 0;
+}
+
+/**
+ * Get a draw task which waits for no other draw task from the ready list
+ * @param layer         the layer with a graph
+ * @param t_prev        continue after this draw task, NULL to start from the first one
+ * @param draw_unit_id  the ID of the draw unit asking for a task
+ * @return              a draw task or NULL if there is none for the draw unit
+ */
+static lv_draw_task_t * task_graph_get_ready(lv_layer_t * layer, lv_draw_task_t * t_prev, uint8_t draw_unit_id)
+{
+    LV_PROFILER_DRAW_BEGIN;
+    lv_draw_task_graph_t * graph = layer->task_graph;
+    if(graph->offered_cnt == LV_DRAW_TASK_GRAPH_OFFERED) task_graph_sweep_offered(graph);
+
+    /*Usually the first one. The taken ones are skipped until they are swept, and so are the
+     *blocked layers and the tasks of the other draw units.*/
+    lv_draw_task_t * t = t_prev && t_prev->graph_list == LV_DRAW_TASK_GRAPH_LIST_READY ?
+                         t_prev->graph_next : graph->ready_head;
+    while(t) {
+        if(t->state == LV_DRAW_TASK_STATE_WAITING &&
+           (t->preferred_draw_unit_id == draw_unit_id || t->preferred_draw_unit_id == LV_DRAW_UNIT_NONE)) {
+            graph->offered[graph->offered_cnt++] = t;
+            LV_PROFILER_DRAW_END;
+            return t;
+        }
+        t = t->graph_next;
+    }
+
+    LV_PROFILER_DRAW_END;
+    return NULL;
+}
+
+/**
+ * Append a draw task to the ready list or add it to the taken list
+ * @param graph     the graph of a layer
+ * @param t         the draw task, it's in none of the lists
+ * @param list      the list
+ */
+static void task_graph_link(lv_draw_task_graph_t * graph, lv_draw_task_t * t, lv_draw_task_graph_list_t list)
+{
+    t->graph_list = list;
+    if(list == LV_DRAW_TASK_GRAPH_LIST_READY) {
+        t->graph_prev = graph->ready_tail;
+        t->graph_next = NULL;
+        if(graph->ready_tail) graph->ready_tail->graph_next = t;
+        else graph->ready_head = t;
+        graph->ready_tail = t;
+    }
+    else {
+        t->graph_prev = NULL;
+        t->graph_next = graph->taken_head;
+        if(graph->taken_head) graph->taken_head->graph_prev = t;
+        graph->taken_head = t;
+    }
+}
+
+/**
+ * Remove a draw task from the ready or the taken list
+ * @param graph     the graph of a layer
+ * @param t         the draw task
+ */
+static void task_graph_unlink(lv_draw_task_graph_t * graph, lv_draw_task_t * t)
+{
+    if(t->graph_list == LV_DRAW_TASK_GRAPH_LIST_NONE) return;
+
+    bool ready = t->graph_list == LV_DRAW_TASK_GRAPH_LIST_READY;
+    if(t->graph_prev) t->graph_prev->graph_next = t->graph_next;
+    else if(ready) graph->ready_head = t->graph_next;
+    else graph->taken_head = t->graph_next;
+
+    if(t->graph_next) t->graph_next->graph_prev = t->graph_prev;
+    else if(ready) graph->ready_tail = t->graph_prev;
+
+    t->graph_prev = NULL;
+    t->graph_next = NULL;
+    t->graph_list = LV_DRAW_TASK_GRAPH_LIST_NONE;
+}
+
+/**
+ * Append a draw task to an array, growing it if needed
+ * @param tasks     pointer to the array
+ * @param cnt       pointer to the number of draw tasks in it
+ * @param size      pointer to the size of the array
+ * @param t         the draw task to append
+ * @return          true: appended; false: out of memory
+ */
+static bool task_graph_push(lv_draw_task_t *** tasks, uint32_t * cnt, uint32_t * size, lv_draw_task_t * t)
+{
+    if(*cnt == *size) {
+        uint32_t new_size = *size ? *size * 2 : 4;
+        lv_draw_task_t ** new_tasks = lv_realloc(*tasks, new_size * sizeof(lv_draw_task_t *));
+        if(new_tasks == NULL) return false;
+        *tasks = new_tasks;
+        *size = new_size;
+    }
+    (*tasks)[(*cnt)++] = t;
+    return true;
+}
@@ -27,6 +27,7 @@ extern "C" {
 #include "../misc/lv_event.h"
 #include "lv_image_decoder.h"
 #include "lv_draw_buf.h"
+#include "lv_draw_arena.h"
 
 /*********************
  *      DEFINES
@@ -99,6 +100,12 @@ struct _lv_layer_t  {
     /** Linked list of draw tasks */
     lv_draw_task_t * draw_task_head;
 
+    /** Last draw task of the list */
+    lv_draw_task_t * draw_task_tail;
+
+    /** Dependencies of the draw tasks, NULL if they are not tracked (see `lv_display_set_draw_task_graph`) */
+    lv_draw_task_graph_t * task_graph;
+
     /** Parent layer */
     lv_layer_t * parent;
 
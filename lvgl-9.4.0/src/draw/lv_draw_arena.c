@@ -0,0 +1,143 @@
+/**
+ * @file lv_draw_arena.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_arena_private.h"
+#include "lv_draw_private.h"
+#include "../core/lv_global.h"
+#include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_math.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define arena (LV_GLOBAL_DEFAULT()->draw_info.arena)
+
+#define ARENA_ALIGN 8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void apply_size(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_arena_init(uint32_t size)
+{
+    lv_memzero(&arena, sizeof(arena));
+    arena.size_req = size;
+    apply_size();
+}
+
+void lv_draw_arena_deinit(void)
+{
+    if(arena.live_cnt) LV_LOG_WARN("%" LV_PRIu32 " allocations were not freed", arena.live_cnt);
+
+    lv_free(arena.buf_unaligned);
+    lv_memzero(&arena, sizeof(arena));
+}
+
+void lv_draw_arena_resize(uint32_t new_size)
+{
+    arena.size_req = new_size;
+    if(arena.live_cnt == 0) apply_size();
+}
+
+void lv_draw_arena_get_stats(lv_draw_arena_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+    *stats = arena.stats;
+    stats->size = arena.size;
+    stats->used = arena.used;
+}
+
+void lv_draw_arena_reset_stats(void)
+{
+    lv_memzero(&arena.stats, sizeof(arena.stats));
+    arena.stats.max_used = arena.used;
+}
+
+void * lv_draw_arena_alloc(size_t size)
+{
+    size = LV_ALIGN_UP(size, ARENA_ALIGN);
+    if(size <= arena.size - arena.used) {
+        void * p = arena.buf + arena.used;
+        arena.used += size;
+        arena.live_cnt++;
+        arena.stats.alloc_cnt++;
+        if(arena.used > arena.stats.max_used) arena.stats.max_used = arena.used;
+        return p;
+    }
+
+    arena.stats.heap_alloc_cnt++;
+    return lv_malloc(size);
+}
+
+void lv_draw_arena_free(void * p)
+{
+    if(p == NULL) return;
+
+    uint8_t * p8 = p;
+    if(arena.buf == NULL || p8 < arena.buf || p8 >= arena.buf + arena.size) {
+        lv_free(p);
+        return;
+    }
+
+    /*Only the whole arena is freed, when nothing uses it*/
+    LV_ASSERT(arena.live_cnt > 0);
+    arena.live_cnt--;
+    if(arena.live_cnt == 0) {
+        arena.used = 0;
+        arena.stats.reset_cnt++;
+        if(arena.size_req != arena.size) apply_size();
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Allocate the buffer of the arena with the requested size. The arena has to be empty.
+ * On out of memory there is no arena and everything is allocated from the heap.
+ */
+static void apply_size(void)
+{
+    lv_free(arena.buf_unaligned);
+    arena.buf_unaligned = NULL;
+    arena.buf = NULL;
+    arena.size = 0;
+    arena.used = 0;
+
+    if(arena.size_req == 0) return;
+
+    arena.buf_unaligned = lv_malloc(arena.size_req + ARENA_ALIGN - 1);
+    if(arena.buf_unaligned == NULL) {
+        LV_LOG_WARN("couldn't allocate %" LV_PRIu32 " bytes", arena.size_req);
+        arena.size_req = 0;
+        return;
+    }
+
+    arena.buf = (uint8_t *)LV_ALIGN_UP((lv_uintptr_t)arena.buf_unaligned, ARENA_ALIGN);
+    arena.size = arena.size_req;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file lv_draw_arena.h
+ *
+ */
+
+#ifndef LV_DRAW_ARENA_H
+#define LV_DRAW_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../misc/lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Usage of the draw arena*/
+typedef struct {
+    uint32_t size;              /**< Size of the arena in bytes, 0 if there is none*/
+    uint32_t used;              /**< Bytes in use now*/
+    uint32_t max_used;          /**< The most bytes used at once*/
+    uint32_t alloc_cnt;         /**< Allocations served by the arena*/
+    uint32_t heap_alloc_cnt;    /**< Allocations which didn't fit and were taken from the heap*/
+    uint32_t reset_cnt;         /**< Times the arena became empty and was reused from its start*/
+} lv_draw_arena_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Set the size of the draw arena. The draw tasks, their draw descriptors, the copied texts of the
+ * labels and the layers are allocated one after the other in this buffer instead of the heap, and
+ * the whole buffer is reused when all of them are freed, at the latest at the end of each refresh.
+ * What doesn't fit is allocated from the heap.
+ * The new size is applied when the arena is empty.
+ * @param new_size  size in bytes, 0 to allocate everything from the heap
+ */
+void lv_draw_arena_resize(uint32_t new_size);
+
+/**
+ * Get the usage of the draw arena since it was created or since `lv_draw_arena_reset_stats()`.
+ * If `heap_alloc_cnt` is not 0 the arena is too small.
+ * @param stats     store the statistics here
+ */
+void lv_draw_arena_get_stats(lv_draw_arena_stats_t * stats);
+
+/**
+ * Restart the counters and the high-water marks of the draw arena
+ */
+void lv_draw_arena_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_ARENA_H*/
@@ -0,0 +1,80 @@
+/**
+ * @file lv_draw_arena_private.h
+ *
+ */
+
+#ifndef LV_DRAW_ARENA_PRIVATE_H
+#define LV_DRAW_ARENA_PRIVATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_draw_arena.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#ifndef LV_DRAW_ARENA_DEF_SIZE
+#define LV_DRAW_ARENA_DEF_SIZE 0    /**< Default size of the draw arena in bytes*/
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** A buffer for the allocations which live only until the draw tasks are ready*/
+typedef struct {
+    void * buf_unaligned;       /**< As allocated from the heap*/
+    uint8_t * buf;              /**< Aligned to 8 bytes*/
+    uint32_t size;
+    uint32_t size_req;          /**< Applied when the arena is empty*/
+    uint32_t used;              /**< Allocations are taken from here*/
+    uint32_t live_cnt;          /**< Allocations in the arena not freed yet*/
+    lv_draw_arena_stats_t stats;
+} lv_draw_arena_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create the draw arena
+ * @param size      size in bytes, 0 for no arena
+ */
+void lv_draw_arena_init(uint32_t size);
+
+/**
+ * Free the draw arena
+ */
+void lv_draw_arena_deinit(void);
+
+/**
+ * Allocate memory which is freed when a draw task is ready. Used only from the thread
+ * which creates and removes the draw tasks.
+ * @param size      size in bytes
+ * @return          pointer to the memory aligned to 8 bytes (not zeroed) or NULL if out of memory
+ */
+void * lv_draw_arena_alloc(size_t size);
+
+/**
+ * Free memory allocated by `lv_draw_arena_alloc()`. The arena is reused from its start when
+ * all its allocations are freed.
+ * @param p         pointer to the memory, it can be in the arena or in the heap. NULL is ignored.
+ */
+void lv_draw_arena_free(void * p);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_ARENA_PRIVATE_H*/
@@ -112,11 +112,17 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_layer_t * layer, const lv_draw_label
 
     lv_memcpy(t->draw_dsc, dsc, sizeof(*dsc));
 
-    /*The text is stored in a local variable so malloc memory for it*/
+    /*The text is stored in a local variable so copy it next to the draw task*/
     if(dsc->text_local) {
         lv_draw_label_dsc_t * new_dsc = t->draw_dsc;
-        new_dsc->text = lv_strndup(dsc->text, dsc->text_length);
-        LV_ASSERT_MALLOC(new_dsc->text);
+        size_t len = lv_strnlen(dsc->text, dsc->text_length);
+        char * text = lv_draw_arena_alloc(len + 1);
+        LV_ASSERT_MALLOC(text);
+        if(text) {
+            lv_memcpy(text, dsc->text, len);
+            text[len] = '\0';
+        }
+        new_dsc->text = text;
     }
 
     lv_draw_finalize_task_creation(layer, t);
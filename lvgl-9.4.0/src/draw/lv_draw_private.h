@@ -21,11 +21,23 @@ extern "C" {
 #include "lv_draw.h"
 #include "../osal/lv_os_private.h"
 #include "../misc/cache/lv_cache.h"
+#include "lv_draw_arena_private.h"
 
 /*********************
  *      DEFINES
  *********************/
 
+/** With occlusion culling a layer keeps up to this many draw tasks waiting for opaque tasks on top of them*/
+#define LV_DRAW_OCCLUSION_QUEUE     32
+
+/** The draw task graph compares a new draw task with the unfinished ones in bins of this size (pixels)*/
+#ifndef LV_DRAW_TASK_BIN_SIZE
+#define LV_DRAW_TASK_BIN_SIZE       64
+#endif
+
+/** Draw tasks handed out during a dispatch before the graph checks which ones were taken*/
+#define LV_DRAW_TASK_GRAPH_OFFERED  16
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -84,6 +96,60 @@ struct _lv_draw_task_t {
      */
     uint8_t preference_score;
 
+    /**
+     * Dependency graph (see `lv_display_set_draw_task_graph`). The area compared with other draw tasks
+     * (`_real_area` on the clip area), the number of older unfinished draw tasks overlapping it and the
+     * newer ones waiting for it.
+     */
+    lv_area_t graph_area;
+    uint32_t blocker_cnt;
+    lv_draw_task_t ** dependents;
+    uint32_t dependent_cnt;
+    uint32_t dependent_size;
+    uint32_t graph_stamp;               /**< The last draw task which was made to wait for this one */
+
+    /** Neighbors in the ready or in the taken list of the graph */
+    lv_draw_task_t * graph_prev;
+    lv_draw_task_t * graph_next;
+    uint8_t graph_list;                 /**< LV_DRAW_TASK_GRAPH_LIST_... */
+
+    /** Previous draw task in the layer, to remove it without searching the list */
+    lv_draw_task_t * prev;
+};
+
+/**
+ * Draw tasks overlapping a bin of the graph, in the order they were added
+ */
+typedef struct {
+    lv_draw_task_t ** tasks;
+    uint32_t cnt;
+    uint32_t size;
+} lv_draw_task_bin_t;
+
+/**
+ * Lists of a draw task graph
+ */
+typedef enum {
+    LV_DRAW_TASK_GRAPH_LIST_NONE,   /**< Waits for older draw tasks, or it's not in the graph*/
+    LV_DRAW_TASK_GRAPH_LIST_READY,  /**< Can be drawn, or it's a blocked layer*/
+    LV_DRAW_TASK_GRAPH_LIST_TAKEN,  /**< Taken by a draw unit or dropped, watched until it's finished*/
+} lv_draw_task_graph_list_t;
+
+struct _lv_draw_task_graph_t {
+    lv_area_t area;                 /**< The bins cover this area*/
+    uint32_t cols;
+    uint32_t rows;
+    lv_draw_task_bin_t * bins;
+
+    lv_draw_task_t * ready_head;
+    lv_draw_task_t * ready_tail;
+    lv_draw_task_t * taken_head;
+
+    /**The draw tasks handed out since the last check*/
+    lv_draw_task_t * offered[LV_DRAW_TASK_GRAPH_OFFERED];
+    uint32_t offered_cnt;
+
+    uint32_t stamp;                 /**< Increased for each new draw task*/
 };
 
 struct _lv_draw_mask_t {
@@ -193,6 +259,7 @@ typedef struct {
 #endif
     lv_mutex_t circle_cache_mutex;
     bool task_running;
+    lv_draw_arena_t arena;
 } lv_draw_global_info_t;
 
 /**********************
@@ -30,6 +30,9 @@
  *      DEFINES
  *********************/
 
+/*The channels of an RGB565 pixel spread to 0x07E0F81F (green in the upper half) with room for a 5-bit factor*/
+#define RGB565_SPREAD_MASK  0x07E0F81F
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -77,6 +80,16 @@ static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ lv_color_8_16_mix(const uint8
 
 static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ lv_color_24_16_mix(const uint8_t * c1, uint16_t c2, uint8_t mix);
 
+static inline uint32_t /* LV_ATTRIBUTE_FAST_MEM */ rgb565_mix_spread(uint32_t fg, uint32_t bg, uint32_t mix);
+
+static inline uint32_t /* LV_ATTRIBUTE_FAST_MEM */ rgb565_pair_spread_hi(uint32_t px2);
+
+static inline uint32_t /* LV_ATTRIBUTE_FAST_MEM */ rgb565_mix_pair(uint32_t fg_lo, uint32_t fg_hi, uint32_t bg2,
+                                                                   uint32_t mix);
+
+static inline uint32_t /* LV_ATTRIBUTE_FAST_MEM */ rgb565_mix_pair_mask(uint32_t fg, uint32_t bg2, uint32_t mix0,
+                                                                        uint32_t mix1);
+
 static inline void * /* LV_ATTRIBUTE_FAST_MEM */ drawbuf_next_row(const void * buf, uint32_t stride);
 
 #if LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
@@ -359,22 +372,25 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
     /*Masked with full opacity*/
     else if(mask && opa >= LV_OPA_MAX) {
         if(LV_RESULT_INVALID == LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)) {
+            uint32_t color32 = (uint32_t)color16 + ((uint32_t)color16 << 16);
+            uint32_t fg = color32 & RGB565_SPREAD_MASK;
             for(y = 0; y < h; y++) {
                 x = 0;
-                if((lv_uintptr_t)(mask) & 0x1) {
+                if((lv_uintptr_t)(dest_buf_u16) & 0x3) {
                     dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], mask[x]);
                     x++;
                 }
 
+                /*Two pixels per word*/
                 for(; x <= w - 2; x += 2) {
-                    uint16_t mask16 = *((uint16_t *)&mask[x]);
-                    if(mask16 == 0xFFFF) {
-                        dest_buf_u16[x + 0] = color16;
-                        dest_buf_u16[x + 1] = color16;
+                    uint32_t mask0 = mask[x];
+                    uint32_t mask1 = mask[x + 1];
+                    uint32_t * dest32 = (uint32_t *)&dest_buf_u16[x];
+                    if((mask0 & mask1) == 0xFF) {
+                        *dest32 = color32;
                     }
-                    else if(mask16 != 0) {
-                        dest_buf_u16[x + 0] = lv_color_16_16_mix(color16, dest_buf_u16[x + 0], mask[x + 0]);
-                        dest_buf_u16[x + 1] = lv_color_16_16_mix(color16, dest_buf_u16[x + 1], mask[x + 1]);
+                    else if(mask0 | mask1) {
+                        *dest32 = rgb565_mix_pair_mask(fg, *dest32, (mask0 + 4) >> 3, (mask1 + 4) >> 3);
                     }
                 }
 
@@ -389,8 +405,26 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
     /*Masked with opacity*/
     else if(mask && opa < LV_OPA_MAX) {
         if(LV_RESULT_INVALID == LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)) {
+            uint32_t fg = ((uint32_t)color16 + ((uint32_t)color16 << 16)) & RGB565_SPREAD_MASK;
             for(y = 0; y < h; y++) {
-                for(x = 0; x < w; x++) {
+                x = 0;
+                if((lv_uintptr_t)(dest_buf_u16) & 0x3) {
+                    dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], LV_OPA_MIX2(mask[x], opa));
+                    x++;
+                }
+
+                /*Two pixels per word*/
+                for(; x <= w - 2; x += 2) {
+                    uint32_t mask0 = mask[x];
+                    uint32_t mask1 = mask[x + 1];
+                    if(mask0 | mask1) {
+                        uint32_t * dest32 = (uint32_t *)&dest_buf_u16[x];
+                        *dest32 = rgb565_mix_pair_mask(fg, *dest32, (LV_OPA_MIX2(mask0, opa) + 4) >> 3,
+                                                       (LV_OPA_MIX2(mask1, opa) + 4) >> 3);
+                    }
+                }
+
+                for(; x < w ; x++) {
                     dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], LV_OPA_MIX2(mask[x], opa));
                 }
                 dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
@@ -846,8 +880,22 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
         }
         else if(mask_buf == NULL && opa < LV_OPA_MAX) {
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)) {
+                uint32_t mix = ((uint32_t)opa + 4) >> 3;
                 for(y = 0; y < h; y++) {
-                    for(x = 0; x < w; x++) {
+                    x = 0;
+                    if((lv_uintptr_t)(dest_buf_u16) & 0x3) {
+                        dest_buf_u16[x] = lv_color_16_16_mix(src_buf_u16[x], dest_buf_u16[x], opa);
+                        x++;
+                    }
+
+                    /*Two pixels per word*/
+                    for(; x <= w - 2; x += 2) {
+                        uint32_t src2 = (uint32_t)src_buf_u16[x] + ((uint32_t)src_buf_u16[x + 1] << 16);
+                        uint32_t * dest32 = (uint32_t *)&dest_buf_u16[x];
+                        *dest32 = rgb565_mix_pair(src2 & RGB565_SPREAD_MASK, rgb565_pair_spread_hi(src2), *dest32, mix);
+                    }
+
+                    for(; x < w; x++) {
                         dest_buf_u16[x] = lv_color_16_16_mix(src_buf_u16[x], dest_buf_u16[x], opa);
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
@@ -1510,6 +1558,66 @@ static inline uint8_t LV_ATTRIBUTE_FAST_MEM get_bit(const uint8_t * buf, int32_t
 
 #endif
 
+/**
+ * `lv_color_16_16_mix()` of spread channels: bg + (fg - bg) * mix / 32 in each channel
+ * @param fg    the foreground channels, spread with `RGB565_SPREAD_MASK`
+ * @param bg    the background channels, spread with `RGB565_SPREAD_MASK`
+ * @param mix   `(opa + 4) >> 3`, 0..32
+ * @return      the mixed channels, spread
+ */
+static inline uint32_t LV_ATTRIBUTE_FAST_MEM rgb565_mix_spread(uint32_t fg, uint32_t bg, uint32_t mix)
+{
+    return ((((fg - bg) * mix) >> 5) + bg) & RGB565_SPREAD_MASK;
+}
+
+/**
+ * Spread the other half of two pixels packed in a word (the first in the lower half).
+ * `px2 & RGB565_SPREAD_MASK` is the red and blue of the first pixel with the green of the second,
+ * this is the red and blue of the second pixel with the green of the first.
+ * @param px2   two RGB565 pixels
+ * @return      the red and blue of the second pixel and the green of the first, spread
+ */
+static inline uint32_t LV_ATTRIBUTE_FAST_MEM rgb565_pair_spread_hi(uint32_t px2)
+{
+    return ((px2 >> 16) & 0xF81F) | ((px2 << 16) & 0x07E00000);
+}
+
+/**
+ * Mix two RGB565 pixels packed in a word with the same opacity.
+ * Each channel only needs the room above it, not its own pixel: the two halves of
+ * the pair are mixed in two words, three channels per multiply, and joined again.
+ * @param fg_lo     `fg2 & RGB565_SPREAD_MASK` of the two foreground pixels `fg2`
+ * @param fg_hi     `rgb565_pair_spread_hi(fg2)`
+ * @param bg2       the two background pixels
+ * @param mix       `(opa + 4) >> 3`, 0..32
+ * @return          the two mixed pixels
+ */
+static inline uint32_t LV_ATTRIBUTE_FAST_MEM rgb565_mix_pair(uint32_t fg_lo, uint32_t fg_hi, uint32_t bg2,
+                                                             uint32_t mix)
+{
+    uint32_t lo = rgb565_mix_spread(fg_lo, bg2 & RGB565_SPREAD_MASK, mix);
+    uint32_t hi = rgb565_mix_spread(fg_hi, rgb565_pair_spread_hi(bg2), mix);
+    return lo | ((hi & 0xF81F) << 16) | ((hi >> 16) & 0x07E0);
+}
+
+/**
+ * Mix a color to two RGB565 pixels packed in a word, with an opacity for each pixel (the mask)
+ * @param fg        the color, spread with `RGB565_SPREAD_MASK`
+ * @param bg2       the two background pixels
+ * @param mix0      `(opa + 4) >> 3` of the first pixel, 0..32
+ * @param mix1      `(opa + 4) >> 3` of the second pixel, 0..32
+ * @return          the two mixed pixels
+ */
+static inline uint32_t LV_ATTRIBUTE_FAST_MEM rgb565_mix_pair_mask(uint32_t fg, uint32_t bg2, uint32_t mix0,
+                                                                  uint32_t mix1)
+{
+    uint32_t bg0 = ((bg2 & 0xFFFF) | (bg2 << 16)) & RGB565_SPREAD_MASK;
+    uint32_t bg1 = ((bg2 >> 16) | (bg2 & 0xFFFF0000)) & RGB565_SPREAD_MASK;
+    uint32_t res0 = rgb565_mix_spread(fg, bg0, mix0);
+    uint32_t res1 = rgb565_mix_spread(fg, bg1, mix1);
+    return (res0 & 0xF81F) | ((res0 >> 16) & 0x07E0) | ((res1 & 0xF81F) << 16) | (res1 & 0x07E00000);
+}
+
 static inline void * LV_ATTRIBUTE_FAST_MEM drawbuf_next_row(const void * buf, uint32_t stride)
 {
     return (void *)((uint8_t *)buf + stride);
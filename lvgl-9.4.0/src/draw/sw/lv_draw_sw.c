@@ -48,6 +48,11 @@
  **********************/
 #if LV_USE_OS
     static void render_thread_cb(void * ptr);
+    static bool band_job_start(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc);
+    static void band_job_wait(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc);
+    static bool band_draw_next(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc);
+    static bool band_steal(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc);
+    static bool band_is_splittable(lv_draw_task_t * t);
 #endif
 
 static void execute_drawing(lv_draw_task_t * t);
@@ -89,7 +94,11 @@ void lv_draw_sw_init(void)
     draw_sw_unit->base_unit.name = "SW";
 #endif
 
+    LV_GLOBAL_DEFAULT()->draw_sw_band_min_px = LV_DRAW_SW_BAND_MIN_PX;
+
 #if LV_USE_OS
+    lv_mutex_init(&draw_sw_unit->band_mutex);
+
     uint32_t i;
     for(i = 0; i < LV_DRAW_SW_DRAW_UNIT_CNT; i++) {
         lv_draw_sw_thread_dsc_t * thread_dsc = &draw_sw_unit->thread_dscs[i];
@@ -141,6 +150,8 @@ static int32_t lv_draw_sw_delete(lv_draw_unit_t * draw_unit)
         lv_thread_delete(&thread_dsc->thread);
     }
 
+    lv_mutex_delete(&draw_sw_unit->band_mutex);
+
     return 0;
 #else
     LV_UNUSED(draw_unit);
@@ -148,6 +159,16 @@ static int32_t lv_draw_sw_delete(lv_draw_unit_t * draw_unit)
 #endif
 }
 
+void lv_draw_sw_set_band_min_size(uint32_t px_cnt)
+{
+    LV_GLOBAL_DEFAULT()->draw_sw_band_min_px = px_cnt;
+}
+
+uint32_t lv_draw_sw_get_band_min_size(void)
+{
+    return LV_GLOBAL_DEFAULT()->draw_sw_band_min_px;
+}
+
 bool lv_draw_sw_register_blend_handler(lv_draw_sw_custom_blend_handler_t * handler)
 {
     lv_draw_sw_custom_blend_handler_t * existing_handler = NULL;
@@ -345,6 +366,7 @@ static int32_t dispatch(lv_draw_unit_t * draw_unit, lv_layer_t * layer)
 static void render_thread_cb(void * ptr)
 {
     lv_draw_sw_thread_dsc_t * thread_dsc = ptr;
+    lv_draw_sw_unit_t * draw_sw_unit = (lv_draw_sw_unit_t *) thread_dsc->draw_unit;
 
     lv_thread_sync_init(&thread_dsc->sync);
     thread_dsc->inited = true;
@@ -354,6 +376,10 @@ static void render_thread_cb(void * ptr)
             if(thread_dsc->exit_status) {
                 break;
             }
+
+            /*Help the other threads with the bands of their tasks*/
+            if(band_draw_next(draw_sw_unit, thread_dsc)) continue;
+
             lv_thread_sync_wait(&thread_dsc->sync);
         }
 
@@ -362,7 +388,13 @@ static void render_thread_cb(void * ptr)
             break;
         }
 
-        execute_drawing(thread_dsc->task_act);
+        if(band_job_start(draw_sw_unit, thread_dsc)) {
+            while(band_draw_next(draw_sw_unit, thread_dsc)) {}
+            band_job_wait(draw_sw_unit, thread_dsc);
+        }
+        else {
+            execute_drawing(thread_dsc->task_act);
+        }
 #if LV_USE_PARALLEL_DRAW_DEBUG
         parallel_debug_draw(thread_dsc->task_act, thread_dsc->idx);
 #endif
@@ -378,6 +410,178 @@ static void render_thread_cb(void * ptr)
     lv_thread_sync_delete(&thread_dsc->sync);
     LV_LOG_INFO("exit software rendering thread");
 }
+
+/**
+ * Cut the task of a thread into bands if it's large enough, and wake up the idle threads to help
+ * @param u             pointer to the SW draw unit
+ * @param thread_dsc    the thread which took the task
+ * @return              true: the task was cut into bands; false: draw it as it is
+ */
+static bool band_job_start(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc)
+{
+    if(LV_DRAW_SW_DRAW_UNIT_CNT < 2) return false;
+
+    uint32_t min_px = LV_GLOBAL_DEFAULT()->draw_sw_band_min_px;
+    if(min_px == 0) return false;
+
+    lv_draw_task_t * t = thread_dsc->task_act;
+    if(!band_is_splittable(t)) return false;
+
+    lv_area_t area;
+    if(!lv_area_intersect(&area, &t->_real_area, &t->clip_area)) return false;
+    if(lv_area_get_size(&area) < min_px) return false;
+
+    int32_t h = lv_area_get_height(&area);
+    uint32_t band_cnt = LV_MIN((uint32_t)h / LV_DRAW_SW_BAND_MIN_H,
+                               LV_DRAW_SW_DRAW_UNIT_CNT * LV_DRAW_SW_BAND_PER_THREAD);
+    if(band_cnt < 2) return false;
+
+    lv_mutex_lock(&u->band_mutex);
+    /*It still has bands stolen from an other thread, don't overwrite them*/
+    if(thread_dsc->band_next < thread_dsc->band_end) {
+        lv_mutex_unlock(&u->band_mutex);
+        return false;
+    }
+
+    lv_draw_sw_band_job_t * job = &thread_dsc->job;
+    job->task = t;
+    job->area = area;
+    job->band_h = h / (int32_t)band_cnt;
+    job->band_cnt = band_cnt;
+    job->left_cnt = band_cnt;
+    job->sync = &thread_dsc->sync;
+    thread_dsc->band_job = job;
+    thread_dsc->band_next = 0;
+    thread_dsc->band_end = band_cnt;
+    lv_mutex_unlock(&u->band_mutex);
+
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_DRAW_UNIT_CNT; i++) {
+        lv_draw_sw_thread_dsc_t * other = &u->thread_dscs[i];
+        if(other != thread_dsc && other->inited && other->task_act == NULL) {
+            lv_thread_sync_signal(&other->sync);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Wait until the other threads are ready with the bands they took from the task of a thread
+ * @param u             pointer to the SW draw unit
+ * @param thread_dsc    the thread which took the task
+ */
+static void band_job_wait(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc)
+{
+    while(1) {
+        lv_mutex_lock(&u->band_mutex);
+        uint32_t left_cnt = thread_dsc->job.left_cnt;
+        lv_mutex_unlock(&u->band_mutex);
+        if(left_cnt == 0) break;
+
+        lv_thread_sync_wait(&thread_dsc->sync);
+    }
+}
+
+/**
+ * Draw the next band of a thread. If it has no more bands, steal some from an other thread.
+ * @param u             pointer to the SW draw unit
+ * @param thread_dsc    the thread to draw with
+ * @return              true: a band was drawn; false: there are no bands left to draw
+ */
+static bool band_draw_next(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc)
+{
+    lv_mutex_lock(&u->band_mutex);
+    if(thread_dsc->band_next >= thread_dsc->band_end && !band_steal(u, thread_dsc)) {
+        lv_mutex_unlock(&u->band_mutex);
+        return false;
+    }
+
+    lv_draw_sw_band_job_t * job = thread_dsc->band_job;
+    uint32_t band = thread_dsc->band_next;
+    thread_dsc->band_next++;
+    lv_mutex_unlock(&u->band_mutex);
+
+    /*Draw a copy of the task clipped to the band*/
+    lv_draw_task_t band_task = *job->task;
+    band_task.clip_area.y1 = job->area.y1 + (int32_t)band * job->band_h;
+    if(band < job->band_cnt - 1) band_task.clip_area.y2 = band_task.clip_area.y1 + job->band_h - 1;
+    else band_task.clip_area.y2 = job->area.y2;
+    execute_drawing(&band_task);
+
+    lv_mutex_lock(&u->band_mutex);
+    thread_dsc->band_drawn_cnt++;
+    if(job != &thread_dsc->job) thread_dsc->band_stolen_cnt++;
+    job->left_cnt--;
+    lv_thread_sync_t * sync = job->left_cnt == 0 ? job->sync : NULL;
+    lv_mutex_unlock(&u->band_mutex);
+
+    /*Let the thread of the task finish it*/
+    if(sync && sync != &thread_dsc->sync) lv_thread_sync_signal(sync);
+
+    return true;
+}
+
+/**
+ * Take the second half of the bands from the thread which has the most bands left.
+ * `band_mutex` needs to be locked.
+ * @param u             pointer to the SW draw unit
+ * @param thread_dsc    the thread without bands
+ * @return              true: some bands were taken; false: no thread has bands left
+ */
+static bool band_steal(lv_draw_sw_unit_t * u, lv_draw_sw_thread_dsc_t * thread_dsc)
+{
+    lv_draw_sw_thread_dsc_t * victim = NULL;
+    uint32_t victim_left_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_DRAW_UNIT_CNT; i++) {
+        lv_draw_sw_thread_dsc_t * other = &u->thread_dscs[i];
+        uint32_t left_cnt = other->band_end - other->band_next;
+        if(left_cnt > victim_left_cnt) {
+            victim = other;
+            victim_left_cnt = left_cnt;
+        }
+    }
+
+    if(victim == NULL) return false;
+
+    uint32_t mid = victim->band_next + victim_left_cnt / 2;
+    thread_dsc->band_job = victim->band_job;
+    thread_dsc->band_next = mid;
+    thread_dsc->band_end = victim->band_end;
+    victim->band_end = mid;
+    return true;
+}
+
+/**
+ * Check if a task can be drawn band by band, in parallel
+ * @param t     pointer to a draw task
+ * @return      true: it draws only in its clip area and doesn't change anything else
+ */
+static bool band_is_splittable(lv_draw_task_t * t)
+{
+    switch(t->type) {
+        case LV_DRAW_TASK_TYPE_FILL:
+        case LV_DRAW_TASK_TYPE_BOX_SHADOW:
+            return true;
+        case LV_DRAW_TASK_TYPE_LAYER: {
+                /*The mask is applied on the whole layer*/
+                lv_draw_image_dsc_t * draw_dsc = t->draw_dsc;
+                return draw_dsc->bitmap_mask_src == NULL;
+            }
+        case LV_DRAW_TASK_TYPE_IMAGE: {
+                /*Every band opens the image: it should be cheap, i.e. nothing to decode*/
+                lv_draw_image_dsc_t * draw_dsc = t->draw_dsc;
+                if(draw_dsc->bitmap_mask_src) return false;
+                if(lv_image_src_get_type(draw_dsc->src) != LV_IMAGE_SRC_VARIABLE) return false;
+                if(draw_dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED) return false;
+                if(LV_COLOR_FORMAT_IS_INDEXED(draw_dsc->header.cf)) return false;
+                return true;
+            }
+        default:
+            return false;
+    }
+}
 #endif
 
 static void execute_drawing(lv_draw_task_t * t)
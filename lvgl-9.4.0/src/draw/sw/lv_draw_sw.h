@@ -48,6 +48,20 @@ void lv_draw_sw_init(void);
  */
 void lv_draw_sw_deinit(void);
 
+/**
+ * Set from which size the render threads split a fill, image, layer or box shadow draw task
+ * into horizontal bands to draw them in parallel. The threads without a task take bands
+ * from the others. Has effect only with `LV_USE_OS` and `LV_DRAW_SW_DRAW_UNIT_CNT > 1`.
+ * @param px_cnt    visible pixels of the draw task, 0 to never split the draw tasks
+ */
+void lv_draw_sw_set_band_min_size(uint32_t px_cnt);
+
+/**
+ * Get from which size the draw tasks are split into bands
+ * @return          visible pixels of the draw task, 0 if they are never split
+ */
+uint32_t lv_draw_sw_get_band_min_size(void);
+
 /**
  * Fill an area using SW render. Handle gradient and radius.
  * @param t             pointer to a draw task
@@ -23,14 +23,31 @@ extern "C" {
  *      DEFINES
  *********************/
 
-/**********************
- *      TYPEDEFS
- **********************/
+#ifndef LV_DRAW_SW_BAND_MIN_PX
+#define LV_DRAW_SW_BAND_MIN_PX      (4 * 1024)  /**< Default of `lv_draw_sw_set_band_min_size()`*/
+#endif
+
+#ifndef LV_DRAW_SW_BAND_MIN_H
+#define LV_DRAW_SW_BAND_MIN_H       8           /**< The bands are at least this many rows high*/
+#endif
+
+/** Cut a draw task into this many bands per render thread, so the faster threads can take more*/
+#define LV_DRAW_SW_BAND_PER_THREAD  4
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/** A draw task cut into horizontal bands*/
+typedef struct {
+    lv_draw_task_t * task;
+    lv_area_t area;             /**< The drawn area of the task, cut into the bands*/
+    int32_t band_h;             /**< The last band takes the remaining rows too*/
+    uint32_t band_cnt;
+    uint32_t left_cnt;          /**< Bands not drawn yet, protected by `band_mutex`*/
+    lv_thread_sync_t * sync;    /**< Of the thread which took the task, signaled when the last band is ready*/
+} lv_draw_sw_band_job_t;
+
 typedef struct {
     lv_draw_task_t * task_act;
     lv_thread_t thread;
@@ -39,12 +56,21 @@ typedef struct {
     uint32_t idx;
     volatile bool inited;
     volatile bool exit_status;
+
+    /*Band rendering, protected by `band_mutex` of the unit*/
+    lv_draw_sw_band_job_t job;          /**< The bands of `task_act`*/
+    lv_draw_sw_band_job_t * band_job;   /**< The job of the bands to take, own or stolen*/
+    uint32_t band_next;                 /**< The next band to take*/
+    uint32_t band_end;                  /**< The other threads steal from the end*/
+    uint32_t band_drawn_cnt;            /**< Statistics: all bands drawn by this thread*/
+    uint32_t band_stolen_cnt;           /**< Statistics: bands drawn for other threads*/
 } lv_draw_sw_thread_dsc_t;
 
 struct _lv_draw_sw_unit_t {
     lv_draw_unit_t base_unit;
 #if LV_USE_OS
     lv_draw_sw_thread_dsc_t thread_dscs[LV_DRAW_SW_DRAW_UNIT_CNT];
+    lv_mutex_t band_mutex;
 #else
     lv_draw_task_t * task_act;
 #endif
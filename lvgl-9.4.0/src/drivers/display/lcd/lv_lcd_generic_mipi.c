@@ -11,10 +11,26 @@
 
 #if LV_USE_GENERIC_MIPI
 
+#include "../../../stdlib/lv_string.h"
+#include "../../../others/sysmon/lv_sysmon.h"
+#include "../../../core/lv_obj.h"
+
 /*********************
  *      DEFINES
  *********************/
 
+/* FNV-1a */
+#define ROW_HASH_BASIS      2166136261u
+#define ROW_HASH_PRIME      16777619u
+
+/* plausible TE periods, the first measurement is taken as is */
+#define TEAR_PERIOD_MIN_US  4000
+#define TEAR_PERIOD_MAX_US  100000
+/* no pulse for this many periods: the TE pin is not (or no longer) working */
+#define TEAR_STALE_PERIODS  4
+/* keep this many lines between the beam and the writes, for the jitter of the pulse and its interrupt */
+#define TEAR_GUARD_LINES    2
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -33,6 +49,18 @@ static void res_chg_event_cb(lv_event_t * e);
 static void delete_cb(lv_event_t * e);
 static lv_lcd_generic_mipi_driver_t * get_driver(lv_display_t * disp);
 static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+static void transfer_add(lv_lcd_transfer_t * xfer, lv_lcd_dc_t dc, const uint8_t * bytes, uint8_t * data, uint32_t size);
+static lv_result_t row_hash_alloc(lv_lcd_generic_mipi_driver_t * drv);
+static uint32_t row_hash_compute(const uint8_t * px, uint32_t size, int32_t x1, int32_t x2);
+static bool row_hash_filter(lv_lcd_generic_mipi_driver_t * drv, const lv_area_t * area, const uint8_t * px_map,
+                            uint32_t px_size, int32_t * y_first, int32_t * y_last);
+static void set_scan_window(lv_lcd_generic_mipi_driver_t * drv, lv_lcd_transfer_t * xfer, int32_t x_start,
+                            int32_t x_end, int32_t y_start, int32_t y_end);
+static bool hw_scroll_blit_cb(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy);
+static void hw_scroll_reset(lv_lcd_generic_mipi_driver_t * drv);
+static void hw_scroll_set_area(lv_lcd_generic_mipi_driver_t * drv, uint32_t top, uint32_t rows);
+static bool tear_prone(const lv_lcd_transfer_t * xfer, int64_t start_ns, int64_t duration_ns, int64_t period_ns,
+                       int64_t line_ns, uint32_t vblank_lines);
 
 /**********************
  *  STATIC VARIABLES
@@ -64,6 +92,19 @@ lv_display_t * lv_lcd_generic_mipi_create(uint32_t hor_res, uint32_t ver_res, lv
     drv->disp = disp;
     drv->send_cmd = send_cmd_cb;
     drv->send_color = send_color_cb;
+    drv->send_transfer = NULL;
+    drv->row_hash = NULL;
+    drv->row_hash_tile_w = 0;
+    drv->row_hash_tile_cnt = 0;
+    drv->row_hash_row_cnt = 0;
+    lv_memzero(&drv->row_hash_stats, sizeof(drv->row_hash_stats));
+    lv_memzero(&drv->tear_cfg, sizeof(drv->tear_cfg));
+    drv->tear_pulse_us = 0;
+    drv->tear_period_us = 0;
+    drv->tear_pulse_cnt = 0;
+    lv_memzero(&drv->tear_stats, sizeof(drv->tear_stats));
+    drv->scroll_lines = 0;
+    drv->scroll_ofs = 0;
     lv_display_set_driver_data(disp, (void *)drv);
 
     /* init controller */
@@ -106,6 +147,8 @@ void lv_lcd_generic_mipi_set_address_mode(lv_display_t * disp, bool mirror_x, bo
     drv->mirror_y = mirror_y;
     drv->swap_xy = swap_xy;
     set_rotation(drv, lv_display_get_rotation(disp));   /* update screen */
+    lv_lcd_generic_mipi_reset_row_hash(disp);           /* the windows map to other pixels now */
+    hw_scroll_reset(drv);
 }
 
 void lv_lcd_generic_mipi_set_gamma_curve(lv_display_t * disp, uint8_t gamma)
@@ -116,6 +159,147 @@ void lv_lcd_generic_mipi_set_gamma_curve(lv_display_t * disp, uint8_t gamma)
     }, 1);
 }
 
+void lv_lcd_generic_mipi_set_send_transfer_cb(lv_display_t * disp, lv_lcd_send_transfer_cb_t send_transfer_cb)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    drv->send_transfer = send_transfer_cb;
+    /* a scrolled window may need two of them */
+    if(send_transfer_cb == NULL) hw_scroll_reset(drv);
+}
+
+lv_result_t lv_lcd_generic_mipi_set_row_hash(lv_display_t * disp, uint32_t tile_w)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    drv->row_hash_tile_w = tile_w;
+    return row_hash_alloc(drv);
+}
+
+void lv_lcd_generic_mipi_reset_row_hash(lv_display_t * disp)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    if(drv->row_hash) {
+        lv_memzero(drv->row_hash, drv->row_hash_tile_cnt * drv->row_hash_row_cnt * sizeof(uint32_t));
+    }
+}
+
+void lv_lcd_generic_mipi_get_row_hash_stats(lv_display_t * disp, lv_lcd_row_hash_stats_t * stats)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    *stats = drv->row_hash_stats;
+}
+
+void lv_lcd_generic_mipi_set_tear_sync(lv_display_t * disp, const lv_lcd_tear_sync_config_t * config)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    drv->tear_period_us = 0;
+    drv->tear_pulse_cnt = 0;
+    if(config == NULL || config->scan_lines == 0) {
+        lv_memzero(&drv->tear_cfg, sizeof(drv->tear_cfg));
+        send_cmd(drv, LV_LCD_CMD_SET_TEAR_OFF, NULL, 0);
+        return;
+    }
+
+    LV_ASSERT(config->bus_hz > 0);
+    drv->tear_cfg = *config;
+    /* TE high during the vertical blanking only */
+    send_cmd(drv, LV_LCD_CMD_SET_TEAR_ON, (uint8_t[]) {
+        0x00,
+    }, 1);
+}
+
+void lv_lcd_generic_mipi_tear_pulse(lv_display_t * disp, uint32_t time_us)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    if(drv->tear_pulse_cnt > 0) {
+        uint32_t interval = time_us - drv->tear_pulse_us;
+        uint32_t period = drv->tear_period_us;
+        if(period == 0) {
+            if(interval >= TEAR_PERIOD_MIN_US && interval <= TEAR_PERIOD_MAX_US) {
+                drv->tear_period_us = interval;
+            }
+        }
+        else if(interval > period / 2 && interval < period + period / 2) {
+            /* a missed pulse only moves the reference */
+            drv->tear_period_us = (period * 7 + interval) / 8;
+        }
+    }
+    drv->tear_pulse_us = time_us;
+    drv->tear_pulse_cnt++;
+}
+
+uint32_t lv_lcd_generic_mipi_get_tear_delay(lv_display_t * disp, const lv_lcd_transfer_t * xfer, uint32_t now_us)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    if(drv->tear_cfg.scan_lines == 0) {
+        return 0;
+    }
+    drv->tear_stats.writes++;
+
+    /* an interrupt may update them in between, it only shifts the prediction by a few lines */
+    uint32_t pulse_us = drv->tear_pulse_us;
+    uint32_t period_us = drv->tear_period_us;
+    if(period_us == 0 || now_us - pulse_us > TEAR_STALE_PERIODS * period_us) {
+        drv->tear_stats.unsynced++;
+        return 0;
+    }
+
+    /* the commands go out first, then the pixels */
+    uint32_t cmd_bytes = 0;
+    uint32_t px_bytes = 0;
+    for(uint32_t i = 0; i < xfer->seg_cnt; i++) {
+        if(xfer->seg[i].data) px_bytes += xfer->seg[i].size;
+        else cmd_bytes += xfer->seg[i].size;
+    }
+    int64_t bus_hz = drv->tear_cfg.bus_hz;
+    int64_t period_ns = (int64_t)period_us * 1000;
+    int64_t line_ns = period_ns / (drv->tear_cfg.scan_lines + drv->tear_cfg.vblank_lines);
+    int64_t start_ns = (int64_t)(now_us - pulse_us) * 1000 + (int64_t)cmd_bytes * 8 * 1000000000 / bus_hz;
+    int64_t duration_ns = (int64_t)px_bytes * 8 * 1000000000 / bus_hz;
+
+    for(int64_t delay_ns = 0; delay_ns < period_ns; delay_ns += line_ns) {
+        if(!tear_prone(xfer, start_ns + delay_ns, duration_ns, period_ns, line_ns, drv->tear_cfg.vblank_lines)) {
+            uint32_t delay_us = (uint32_t)((delay_ns + 999) / 1000);
+            if(delay_us) {
+                drv->tear_stats.delayed++;
+                drv->tear_stats.delay_us += delay_us;
+            }
+            return delay_us;
+        }
+    }
+
+    /* e.g. every line is written all along (swapped axes) and the write is longer than the blanking */
+    drv->tear_stats.tear_prone++;
+    return 0;
+}
+
+void lv_lcd_generic_mipi_get_tear_sync_stats(lv_display_t * disp, lv_lcd_tear_sync_stats_t * stats)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    *stats = drv->tear_stats;
+}
+
+void lv_lcd_generic_mipi_set_hw_scroll(lv_display_t * disp, uint32_t mem_lines)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    if(mem_lines == 0) {
+        /* the whole memory unscrolled, as after a reset */
+        hw_scroll_reset(drv);
+        if(drv->scroll_lines) hw_scroll_set_area(drv, 0, drv->scroll_lines);
+    }
+    else {
+        LV_ASSERT(mem_lines >= (uint32_t)(lv_display_get_vertical_resolution(disp) + drv->y_gap));
+    }
+
+    drv->scroll_lines = mem_lines;
+    hw_scroll_reset(drv);
+    lv_display_set_blit_cb(disp, mem_lines ? hw_scroll_blit_cb : NULL);
+}
+
+const uint8_t * lv_lcd_transfer_seg_get_data(const lv_lcd_transfer_seg_t * seg)
+{
+    return seg->data ? seg->data : seg->inline_data;
+}
+
 void lv_lcd_generic_mipi_send_cmd_list(lv_display_t * disp, const uint8_t * cmd_list)
 {
     lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
@@ -263,29 +447,430 @@ static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_m
 
     LV_ASSERT((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
 
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(disp));
+    int32_t y_first;
+    int32_t y_last;
+    if(drv->row_hash && row_hash_filter(drv, area, px_map, px_size, &y_first, &y_last)) {
+        /* only the changed rows. Without any, one row still goes out: `lv_display_flush_ready`
+         * has to come from the transfer, in order with the flushes still in flight */
+        uint32_t row_size = (x_end - x_start) * px_size;
+        uint32_t saved = (uint32_t)((y_end - y_start) - (y_last - y_first + 1)) * row_size;
+        px_map += (y_first - y_start) * row_size;
+        y_start = y_first;
+        y_end = y_last + 1;
+
+        drv->row_hash_stats.bytes_sent += (uint64_t)(y_end - y_start) * row_size;
+        drv->row_hash_stats.bytes_saved += saved;
+#if LV_USE_PERF_MONITOR
+        lv_sysmon_performance_add_flush_bytes(disp, (y_end - y_start) * row_size, saved);
+#endif
+    }
+
     x_start += drv->x_gap;
     x_end += drv->x_gap;
     y_start += drv->y_gap;
     y_end += drv->y_gap;
 
-    /* define an area of frame memory where MCU can access */
-    send_cmd(drv, LV_LCD_CMD_SET_COLUMN_ADDRESS, (uint8_t[]) {
+    uint8_t caset[4] = {
         (x_start >> 8) & 0xFF,
         x_start & 0xFF,
         ((x_end - 1) >> 8) & 0xFF,
         (x_end - 1) & 0xFF,
-    }, 4);
-    send_cmd(drv, LV_LCD_CMD_SET_PAGE_ADDRESS, (uint8_t[]) {
+    };
+    uint8_t raset[4] = {
         (y_start >> 8) & 0xFF,
         y_start & 0xFF,
         ((y_end - 1) >> 8) & 0xFF,
         (y_end - 1) & 0xFF,
-    }, 4);
+    };
+    size_t len = (x_end - x_start) * (y_end - y_start) * px_size;
+
+    if(drv->send_transfer) {
+        /* the whole window setup and pixel write as one sequence */
+        static const uint8_t cmds[3] = {
+            LV_LCD_CMD_SET_COLUMN_ADDRESS,
+            LV_LCD_CMD_SET_PAGE_ADDRESS,
+            LV_LCD_CMD_WRITE_MEMORY_START,
+        };
+        lv_lcd_transfer_t xfer;
+        xfer.seg_cnt = 0;
+        /* the panel shows the rows where they were before the hardware scrolling */
+        int32_t scan_y_start = y_start;
+        int32_t scan_y_end = y_end;
+
+        /* with hardware scrolling the rows are written to where they are shown now,
+         * the part wrapping around the end of the scrolling area in a second window */
+        int32_t wrap_rows = 0;
+        if(drv->scroll_ofs) {
+            int32_t ver_res = lv_display_get_vertical_resolution(disp);
+            int32_t rows = y_end - y_start;
+            y_start = drv->y_gap + (y_start - drv->y_gap + (int32_t)drv->scroll_ofs) % ver_res;
+            y_end = y_start + rows;
+            if(y_end > drv->y_gap + ver_res) {
+                wrap_rows = y_end - (drv->y_gap + ver_res);
+                y_end -= wrap_rows;
+            }
+            raset[0] = (y_start >> 8) & 0xFF;
+            raset[1] = y_start & 0xFF;
+            raset[2] = ((y_end - 1) >> 8) & 0xFF;
+            raset[3] = (y_end - 1) & 0xFF;
+        }
+        size_t wrap_len = (x_end - x_start) * wrap_rows * px_size;
+
+        set_scan_window(drv, &xfer, x_start, x_end, scan_y_start, scan_y_end - wrap_rows);
+        transfer_add(&xfer, LV_LCD_DC_COMMAND, &cmds[0], NULL, 1);
+        transfer_add(&xfer, LV_LCD_DC_DATA, caset, NULL, sizeof(caset));
+        transfer_add(&xfer, LV_LCD_DC_COMMAND, &cmds[1], NULL, 1);
+        transfer_add(&xfer, LV_LCD_DC_DATA, raset, NULL, sizeof(raset));
+        transfer_add(&xfer, LV_LCD_DC_COMMAND, &cmds[2], NULL, 1);
+        transfer_add(&xfer, LV_LCD_DC_DATA, NULL, px_map, len - wrap_len);
+        xfer.flush_continues = wrap_rows != 0;
+        drv->send_transfer(disp, &xfer);
+
+        /* the DC line can only change after short segments, so the second window is a transfer of its own.
+         * CASET still holds. */
+        if(wrap_rows) {
+            uint8_t raset_wrap[4] = {
+                (drv->y_gap >> 8) & 0xFF,
+                drv->y_gap & 0xFF,
+                ((drv->y_gap + wrap_rows - 1) >> 8) & 0xFF,
+                (drv->y_gap + wrap_rows - 1) & 0xFF,
+            };
+            xfer.seg_cnt = 0;
+            set_scan_window(drv, &xfer, x_start, x_end, scan_y_end - wrap_rows, scan_y_end);
+            transfer_add(&xfer, LV_LCD_DC_COMMAND, &cmds[1], NULL, 1);
+            transfer_add(&xfer, LV_LCD_DC_DATA, raset_wrap, NULL, sizeof(raset_wrap));
+            transfer_add(&xfer, LV_LCD_DC_COMMAND, &cmds[2], NULL, 1);
+            transfer_add(&xfer, LV_LCD_DC_DATA, NULL, px_map + len - wrap_len, wrap_len);
+            xfer.flush_continues = false;
+            drv->send_transfer(disp, &xfer);
+        }
+        return;
+    }
+
+    /* define an area of frame memory where MCU can access */
+    send_cmd(drv, LV_LCD_CMD_SET_COLUMN_ADDRESS, caset, sizeof(caset));
+    send_cmd(drv, LV_LCD_CMD_SET_PAGE_ADDRESS, raset, sizeof(raset));
     /* transfer frame buffer */
-    size_t len = (x_end - x_start) * (y_end - y_start) * lv_color_format_get_size(lv_display_get_color_format(disp));
     send_color(drv, LV_LCD_CMD_WRITE_MEMORY_START, px_map, len);
 }
 
+/**
+ * Append a segment to a batched transfer
+ * @param xfer          transfer descriptor
+ * @param dc            DC level of the segment
+ * @param bytes         short data to copy into the descriptor, or NULL
+ * @param data          data to reference (pixels) if `bytes` is NULL
+ * @param size          number of bytes
+ */
+static void transfer_add(lv_lcd_transfer_t * xfer, lv_lcd_dc_t dc, const uint8_t * bytes, uint8_t * data, uint32_t size)
+{
+    LV_ASSERT(xfer->seg_cnt < LV_LCD_TRANSFER_SEG_MAX);
+
+    lv_lcd_transfer_seg_t * seg = &xfer->seg[xfer->seg_cnt++];
+    seg->dc = dc;
+    seg->size = size;
+    if(bytes) {
+        LV_ASSERT(size <= LV_LCD_TRANSFER_INLINE_MAX);
+        lv_memcpy(seg->inline_data, bytes, size);
+        seg->data = NULL;
+    }
+    else {
+        seg->data = data;
+    }
+}
+
+/**
+ * (Re)allocate the row hash table for the current resolution and tile width
+ * @param drv           LCD driver object
+ * @return              LV_RESULT_OK or LV_RESULT_INVALID if out of memory (the filter is disabled then)
+ */
+static lv_result_t row_hash_alloc(lv_lcd_generic_mipi_driver_t * drv)
+{
+    lv_free(drv->row_hash);
+    drv->row_hash = NULL;
+    drv->row_hash_tile_cnt = 0;
+    drv->row_hash_row_cnt = 0;
+    if(drv->row_hash_tile_w == 0) {
+        return LV_RESULT_OK;
+    }
+
+    uint32_t hor_res = lv_display_get_horizontal_resolution(drv->disp);
+    uint32_t ver_res = lv_display_get_vertical_resolution(drv->disp);
+    uint32_t tile_cnt = (hor_res + drv->row_hash_tile_w - 1) / drv->row_hash_tile_w;
+
+    /* all zero: nothing known, every row is sent */
+    drv->row_hash = lv_zalloc(tile_cnt * ver_res * sizeof(uint32_t));
+    if(drv->row_hash == NULL) {
+        LV_LOG_WARN("not enough memory for the row hash table, filter disabled");
+        drv->row_hash_tile_w = 0;
+        return LV_RESULT_INVALID;
+    }
+    drv->row_hash_tile_cnt = tile_cnt;
+    drv->row_hash_row_cnt = ver_res;
+    return LV_RESULT_OK;
+}
+
+/**
+ * Hash the pixels of a row in a tile
+ * @param px            first pixel
+ * @param size          number of bytes
+ * @param x1            first column, the columns are part of the hash:
+ *                      a match means the same pixels were sent to the same columns
+ * @param x2            last column
+ * @return              the hash, never 0
+ */
+static uint32_t row_hash_compute(const uint8_t * px, uint32_t size, int32_t x1, int32_t x2)
+{
+    uint32_t h = ROW_HASH_BASIS;
+    h = (h ^ (uint32_t)x1) * ROW_HASH_PRIME;
+    h = (h ^ (uint32_t)x2) * ROW_HASH_PRIME;
+
+    if((size & 1) == 0 && ((lv_uintptr_t)px & 1) == 0) {
+        /* RGB565: a pixel per step */
+        const uint16_t * px16 = (const uint16_t *)px;
+        for(uint32_t i = 0; i < size / 2; i++) {
+            h = (h ^ px16[i]) * ROW_HASH_PRIME;
+        }
+    }
+    else {
+        for(uint32_t i = 0; i < size; i++) {
+            h = (h ^ px[i]) * ROW_HASH_PRIME;
+        }
+    }
+
+    return h ? h : 1;
+}
+
+/**
+ * Compare the rows of a flushed area with what was last sent and remember the new hashes
+ * @param drv           LCD driver object
+ * @param area          flushed area
+ * @param px_map        pixels of the area
+ * @param px_size       bytes per pixel
+ * @param y_first       set to the first changed row
+ * @param y_last        set to the last changed row (`y_first` if no row changed)
+ * @return              true: trim the flush to `y_first`..`y_last`,
+ *                      false: the area is outside of the table, send all of it
+ */
+static bool row_hash_filter(lv_lcd_generic_mipi_driver_t * drv, const lv_area_t * area, const uint8_t * px_map,
+                            uint32_t px_size, int32_t * y_first, int32_t * y_last)
+{
+    uint32_t tile_w = drv->row_hash_tile_w;
+    if(area->x1 < 0 || area->y1 < 0 || (uint32_t)area->y2 >= drv->row_hash_row_cnt ||
+       (uint32_t)area->x2 >= drv->row_hash_tile_cnt * tile_w) {
+        return false;
+    }
+
+    uint32_t row_size = lv_area_get_width(area) * px_size;
+    uint32_t tile_first = area->x1 / tile_w;
+    uint32_t tile_last = area->x2 / tile_w;
+
+    drv->row_hash_stats.flush_cnt++;
+    *y_first = -1;
+    *y_last = -1;
+    for(int32_t y = area->y1; y <= area->y2; y++) {
+        const uint8_t * row = px_map + (y - area->y1) * row_size;
+        uint32_t * hashes = &drv->row_hash[y * drv->row_hash_tile_cnt];
+        bool changed = false;
+
+        for(uint32_t t = tile_first; t <= tile_last; t++) {
+            int32_t x1 = LV_MAX(area->x1, (int32_t)(t * tile_w));
+            int32_t x2 = LV_MIN(area->x2, (int32_t)((t + 1) * tile_w - 1));
+            uint32_t h = row_hash_compute(row + (x1 - area->x1) * px_size, (x2 - x1 + 1) * px_size, x1, x2);
+            if(hashes[t] != h) {
+                hashes[t] = h;
+                changed = true;
+            }
+        }
+
+        if(changed) {
+            if(*y_first < 0) *y_first = y;
+            *y_last = y;
+        }
+    }
+
+    if(*y_first < 0) {
+        drv->row_hash_stats.unchanged_cnt++;
+        *y_first = area->y1;
+        *y_last = area->y1;
+    }
+    return true;
+}
+
+/**
+ * Store the panel scan lines a transfer writes to, in the order it writes them
+ * @param drv           LCD driver object
+ * @param xfer          transfer descriptor
+ * @param x_start       first column address
+ * @param x_end         last column address + 1
+ * @param y_start       first page address
+ * @param y_end         last page address + 1
+ */
+static void set_scan_window(lv_lcd_generic_mipi_driver_t * drv, lv_lcd_transfer_t * xfer, int32_t x_start,
+                            int32_t x_end, int32_t y_start, int32_t y_end)
+{
+    /* the panel scans the rows of the memory. With swapped axes these are the column addresses,
+     * so each page written (row of the area) touches every scan line of the window */
+    bool swap = drv->madctl_reg & LV_LCD_MASK_PAGE_COLUMN_ORDER;
+    bool mirror = drv->madctl_reg & (swap ? LV_LCD_MASK_COLUMN_ADDRESS_ORDER : LV_LCD_MASK_PAGE_ADDRESS_ORDER);
+    int32_t first = swap ? x_start : y_start;
+    int32_t last = (swap ? x_end : y_end) - 1;
+
+    if(mirror) {
+        int32_t lines = drv->tear_cfg.scan_lines;
+        if(lines == 0) {
+            lines = swap ? lv_display_get_horizontal_resolution(drv->disp) : lv_display_get_vertical_resolution(drv->disp);
+        }
+        first = lines - 1 - first;
+        last = lines - 1 - last;
+    }
+
+    xfer->scan_first = (uint16_t)first;
+    xfer->scan_last = (uint16_t)last;
+    xfer->scan_progressive = !swap;
+}
+
+/**
+ * Check whether a write would show up partially during a refresh of the panel.
+ * Times are relative to the last TE pulse, where the vertical blanking starts.
+ * Scan line `l` is read at `(vblank_lines + l) * line_ns` after each pulse.
+ * @param xfer          transfer with the scan window
+ * @param start_ns      start of the pixel data
+ * @param duration_ns   duration of the pixel data
+ * @param period_ns     frame period
+ * @param line_ns       time of one scan line
+ * @param vblank_lines  blanking lines after the pulse
+ * @return              true: some pass of the beam reads old and new (or partially written) lines
+ */
+static bool tear_prone(const lv_lcd_transfer_t * xfer, int64_t start_ns, int64_t duration_ns, int64_t period_ns,
+                       int64_t line_ns, uint32_t vblank_lines)
+{
+    int32_t line_min = LV_MIN(xfer->scan_first, xfer->scan_last);
+    int32_t line_cnt = LV_ABS((int32_t)xfer->scan_last - (int32_t)xfer->scan_first) + 1;
+    int64_t pass_ns = (line_cnt - 1) * line_ns;     /* first to last line of the window */
+    int64_t end_ns = start_ns + duration_ns;
+    int64_t guard_ns = TEAR_GUARD_LINES * line_ns;
+
+    /* the first pass that may end after the write started */
+    int64_t pass0_ns = (vblank_lines + line_min) * line_ns;
+    int64_t m = (start_ns - guard_ns - pass0_ns - pass_ns) / period_ns - 1;
+
+    for(int64_t pass_start = pass0_ns + m * period_ns; pass_start <= end_ns; pass_start += period_ns) {
+        bool all_old;
+        bool all_new;
+        if(xfer->scan_progressive) {
+            /* write k (in write order) takes line_write_ns from start + k * line_write_ns,
+             * the beam reads it at pass_start + (line - line_min) * line_ns. Both are linear in k,
+             * so checking the first and the last written line is enough */
+            int64_t line_write_ns = duration_ns / line_cnt;
+            int64_t read_first = pass_start + (xfer->scan_first - line_min) * line_ns;
+            int64_t read_last = pass_start + (xfer->scan_last - line_min) * line_ns;
+            int64_t margin_first = read_first - start_ns;
+            int64_t margin_last = read_last - (start_ns + (line_cnt - 1) * line_write_ns);
+            all_old = margin_first < -guard_ns && margin_last < -guard_ns;
+            all_new = margin_first >= line_write_ns + guard_ns && margin_last >= line_write_ns + guard_ns;
+        }
+        else {
+            /* every line is written from the start to the end */
+            all_old = pass_start + pass_ns < start_ns - guard_ns;
+            all_new = pass_start >= end_ns + guard_ns;
+        }
+
+        if(!all_old && !all_new) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Move the rows of the whole display with the controller's vertical scrolling
+ * @param disp          display object
+ * @param area          the moved area
+ * @param dx            must be 0
+ * @param dy            the content moves this many rows down (negative: up)
+ * @return              true: moved; false: not supported for this area
+ */
+static bool hw_scroll_blit_cb(lv_display_t * disp, const lv_area_t * area, int32_t dx, int32_t dy)
+{
+    lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(disp);
+
+    /* the scrolling area consists of whole rows of the memory */
+    if(drv->scroll_lines == 0 || drv->send_transfer == NULL || dx != 0) return false;
+    if(drv->madctl_reg & LV_LCD_MASK_PAGE_COLUMN_ORDER) return false;
+    if(area->x1 != 0 || area->y1 != 0 || area->x2 != hor_res - 1 || area->y2 != ver_res - 1) return false;
+
+    /* row y is shown where row y - dy was */
+    drv->scroll_ofs = (uint32_t)(((int32_t)drv->scroll_ofs - dy) % ver_res + ver_res) % ver_res;
+
+    /* the first row of the scrolling area shown. The memory is written bottom to top if the pages are mirrored. */
+    bool mirror = drv->madctl_reg & LV_LCD_MASK_PAGE_ADDRESS_ORDER;
+    uint32_t top = mirror ? drv->scroll_lines - drv->y_gap - ver_res : drv->y_gap;
+    uint32_t start = top + (mirror ? (ver_res - drv->scroll_ofs) % ver_res : drv->scroll_ofs);
+    send_cmd(drv, LV_LCD_CMD_SET_SCROLL_START, (uint8_t[]) {
+        (start >> 8) & 0xFF, start & 0xFF,
+    }, 2);
+
+    /* the pixels sent for each row moved with it */
+    if(drv->row_hash) {
+        uint32_t row_size = drv->row_hash_tile_cnt * sizeof(uint32_t);
+        uint32_t rows = drv->row_hash_row_cnt - LV_ABS(dy);
+        if(dy > 0) {
+            lv_memmove(&drv->row_hash[dy * drv->row_hash_tile_cnt], drv->row_hash, rows * row_size);
+            lv_memzero(drv->row_hash, dy * row_size);
+        }
+        else {
+            lv_memmove(drv->row_hash, &drv->row_hash[-dy * drv->row_hash_tile_cnt], rows * row_size);
+            lv_memzero(&drv->row_hash[rows * drv->row_hash_tile_cnt], -dy * row_size);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Set the scrolling area for the current resolution and show the memory unscrolled.
+ * If it was scrolled the screen is redrawn.
+ * @param drv           LCD driver object
+ */
+static void hw_scroll_reset(lv_lcd_generic_mipi_driver_t * drv)
+{
+    if(drv->scroll_lines == 0) return;
+
+    /* the rows of the display, bottom to top in the memory if the pages are mirrored */
+    uint32_t ver_res = lv_display_get_vertical_resolution(drv->disp);
+    bool mirror = drv->madctl_reg & LV_LCD_MASK_PAGE_ADDRESS_ORDER;
+    uint32_t top = mirror ? drv->scroll_lines - drv->y_gap - ver_res : drv->y_gap;
+    hw_scroll_set_area(drv, top, ver_res);
+
+    if(drv->scroll_ofs) {
+        drv->scroll_ofs = 0;
+        lv_obj_invalidate(lv_display_get_screen_active(drv->disp));
+        lv_lcd_generic_mipi_reset_row_hash(drv->disp);
+    }
+}
+
+/**
+ * Send the scrolling area and show it unscrolled
+ * @param drv           LCD driver object
+ * @param top           first row of the scrolling area in the memory
+ * @param rows          rows of the scrolling area
+ */
+static void hw_scroll_set_area(lv_lcd_generic_mipi_driver_t * drv, uint32_t top, uint32_t rows)
+{
+    uint32_t bottom = drv->scroll_lines - top - rows;
+    send_cmd(drv, LV_LCD_CMD_SET_SCROLL_AREA, (uint8_t[]) {
+        (top >> 8) & 0xFF, top & 0xFF,
+        (rows >> 8) & 0xFF, rows & 0xFF,
+        (bottom >> 8) & 0xFF, bottom & 0xFF,
+    }, 6);
+    send_cmd(drv, LV_LCD_CMD_SET_SCROLL_START, (uint8_t[]) {
+        (top >> 8) & 0xFF, top & 0xFF,
+    }, 2);
+}
+
 /**
  * Set rotation taking into account the current mirror and swap settings
  * @param drv           LCD driver object
@@ -335,6 +920,14 @@ static void res_chg_event_cb(lv_event_t * e)
 
     /* handle rotation */
     set_rotation(drv, rot);
+
+    /* the hash table follows the resolution */
+    if(drv->row_hash_tile_w) {
+        row_hash_alloc(drv);
+    }
+
+    /* and so does the scrolling area */
+    hw_scroll_reset(drv);
 }
 
 static void delete_cb(lv_event_t * e)
@@ -342,6 +935,7 @@ static void delete_cb(lv_event_t * e)
     lv_display_t * disp = lv_event_get_current_target(e);
     lv_lcd_generic_mipi_driver_t * drv = get_driver(disp);
     LV_ASSERT_NULL(drv);
+    lv_free(drv->row_hash);
     lv_free(drv);
     lv_display_set_driver_data(disp, NULL);
 }
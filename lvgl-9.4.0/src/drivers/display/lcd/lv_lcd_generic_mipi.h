@@ -121,6 +121,12 @@ extern "C" {
 #define LV_LCD_CMD_DELAY_MS     0xff
 #define LV_LCD_CMD_EOF          0xff
 
+/* batched transfers */
+#define LV_LCD_TRANSFER_SEG_MAX         10      /* CASET + parameters, RASET + parameters, RAMWR + pixels, and
+                                                 * RASET + parameters, RAMWR + pixels again for the rows wrapping
+                                                 * around in the hardware scrolled memory */
+#define LV_LCD_TRANSFER_INLINE_MAX      4       /* longest command or parameter list stored in the descriptor */
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -144,6 +150,9 @@ typedef void (*lv_lcd_send_cmd_cb_t)(lv_display_t * disp, const uint8_t * cmd, s
 
 /**
  * Prototype of a platform-dependent callback to transfer pixel data to the LCD controller.
+ * MIPI DBI controllers expect 16 bit pixels in big-endian byte order. If the display renders
+ * `LV_COLOR_FORMAT_RGB565_SWAPPED` the buffer is already in that order and can be sent as-is,
+ * otherwise (`LV_COLOR_FORMAT_RGB565`) the callback has to swap the bytes before sending.
  * @param disp          display object
  * @param cmd           command buffer (can handle 16 bit commands as well)
  * @param cmd_size      number of bytes of the command
@@ -153,6 +162,82 @@ typedef void (*lv_lcd_send_cmd_cb_t)(lv_display_t * disp, const uint8_t * cmd, s
 typedef void (*lv_lcd_send_color_cb_t)(lv_display_t * disp, const uint8_t * cmd, size_t cmd_size, uint8_t * param,
                                        size_t param_size);
 
+/**
+ * Level of the DC (data/command) line
+ */
+typedef enum {
+    LV_LCD_DC_COMMAND = 0,
+    LV_LCD_DC_DATA = 1,
+} lv_lcd_dc_t;
+
+/**
+ * Part of a batched transfer sent with one DC level
+ */
+typedef struct {
+    uint8_t       *       data;                                     /* bytes to send, NULL if they are in `inline_data` */
+    uint32_t              size;                                     /* number of bytes */
+    uint8_t               inline_data[LV_LCD_TRANSFER_INLINE_MAX];  /* short commands and parameters */
+    lv_lcd_dc_t           dc;                                       /* DC level while the segment is sent */
+} lv_lcd_transfer_seg_t;
+
+/**
+ * Batched transfer: the window commands and the pixels of a flush as one sequence.
+ * The DC line changes only between segments, after the last bit of the previous segment
+ * has left the bus. The descriptor contains no pointers to itself, so it can be copied as-is.
+ */
+typedef struct {
+    lv_lcd_transfer_seg_t seg[LV_LCD_TRANSFER_SEG_MAX];
+    uint32_t              seg_cnt;
+    uint16_t              scan_first;       /* panel scan line written first */
+    uint16_t              scan_last;        /* panel scan line written last */
+    bool                  scan_progressive; /* the scan lines are written one after the other,
+                                             * false: all of them all along (swapped axes) */
+    bool                  flush_continues;  /* another transfer of the same flush follows,
+                                             * `lv_display_flush_ready` only after that one */
+} lv_lcd_transfer_t;
+
+/**
+ * Prototype of a platform-dependent callback to run a batched transfer,
+ * e.g. as a chain of DMA transfers without CPU round-trips between the segments.
+ * The descriptor is valid only during the call, copy it if the transfer finishes later.
+ * The pixels are valid until `lv_display_flush_ready` is called, which is the callback's job
+ * just like for `lv_lcd_send_color_cb_t`, after the transfer without `flush_continues`.
+ * The pixels have the same byte order requirements too.
+ * @param disp          display object
+ * @param xfer          the transfer to run
+ */
+typedef void (*lv_lcd_send_transfer_cb_t)(lv_display_t * disp, const lv_lcd_transfer_t * xfer);
+
+/**
+ * Statistics of the row hash filter (see `lv_lcd_generic_mipi_set_row_hash()`)
+ */
+typedef struct {
+    uint32_t flush_cnt;             /* flushes filtered */
+    uint32_t unchanged_cnt;         /* flushes without a changed row, sent as a single row */
+    uint64_t bytes_sent;            /* pixel bytes sent to the controller */
+    uint64_t bytes_saved;           /* pixel bytes of the unchanged rows that weren't sent */
+} lv_lcd_row_hash_stats_t;
+
+/**
+ * Panel timing for the tearing effect synchronization (see `lv_lcd_generic_mipi_set_tear_sync()`)
+ */
+typedef struct {
+    uint32_t scan_lines;            /* lines refreshed per frame, i.e. rows of the controller's memory */
+    uint32_t vblank_lines;          /* blanking lines from the TE pulse to the first line (front and back porch) */
+    uint32_t bus_hz;                /* bit rate of the interface, to time the writes */
+} lv_lcd_tear_sync_config_t;
+
+/**
+ * Statistics of the tearing effect synchronization
+ */
+typedef struct {
+    uint32_t writes;                /* transfers scheduled */
+    uint32_t delayed;               /* transfers held back to stay clear of the beam */
+    uint32_t tear_prone;            /* transfers without a safe start within a frame, sent at once */
+    uint32_t unsynced;              /* transfers sent at once as there was no recent TE pulse */
+    uint64_t delay_us;              /* total delay */
+} lv_lcd_tear_sync_stats_t;
+
 /**
  * Generic MIPI compatible LCD driver
  */
@@ -160,6 +245,7 @@ typedef struct {
     lv_display_t      *     disp;          /* the associated LVGL display object */
     lv_lcd_send_cmd_cb_t    send_cmd;       /* platform-specific implementation to send a command to the LCD controller */
     lv_lcd_send_color_cb_t  send_color;     /* platform-specific implementation to send pixel data to the LCD controller */
+    lv_lcd_send_transfer_cb_t send_transfer; /* optional, sends the window commands and the pixels in one go */
     uint16_t                x_gap;          /* x offset of the (0,0) pixel in VRAM */
     uint16_t                y_gap;          /* y offset of the (0,0) pixel in VRAM */
     uint8_t                 madctl_reg;     /* current value of MADCTL register */
@@ -167,6 +253,18 @@ typedef struct {
     bool                    mirror_x;
     bool                    mirror_y;
     bool                    swap_xy;
+    uint32_t        *       row_hash;       /* hash of the last pixels sent per row and tile, NULL: filter disabled */
+    uint32_t                row_hash_tile_w; /* width of a tile in pixels */
+    uint32_t                row_hash_tile_cnt; /* tiles per row */
+    uint32_t                row_hash_row_cnt;
+    lv_lcd_row_hash_stats_t row_hash_stats;
+    lv_lcd_tear_sync_config_t tear_cfg;     /* scan_lines == 0: no tearing effect synchronization */
+    volatile uint32_t       tear_pulse_us;  /* time of the last TE pulse */
+    volatile uint32_t       tear_period_us; /* measured frame period, 0: not known yet */
+    volatile uint32_t       tear_pulse_cnt;
+    lv_lcd_tear_sync_stats_t tear_stats;
+    uint32_t                scroll_lines;   /* rows of the controller's memory, 0: no hardware scrolling */
+    uint32_t                scroll_ofs;     /* the display's row 0 is written to this row of the scrolling area */
 } lv_lcd_generic_mipi_driver_t;
 
 /**********************
@@ -225,6 +323,102 @@ void lv_lcd_generic_mipi_set_gamma_curve(lv_display_t * disp, uint8_t gamma);
  */
 void lv_lcd_generic_mipi_send_cmd_list(lv_display_t * disp, const uint8_t * cmd_list);
 
+/**
+ * Flush the pixels with batched transfers instead of separate commands and `send_color` calls.
+ * Other commands are still sent with `send_cmd`.
+ * @param disp              display object
+ * @param send_transfer_cb  platform-dependent function to run a batched transfer, NULL to send separately
+ */
+void lv_lcd_generic_mipi_set_send_transfer_cb(lv_display_t * disp, lv_lcd_send_transfer_cb_t send_transfer_cb);
+
+/**
+ * Skip the rows that didn't change since they were last sent.
+ * A hash of the pixels sent is kept per row and `tile_w` wide tile. Each flush is trimmed
+ * to the span from its first to its last changed row, with a tighter RASET.
+ * The columns aren't trimmed, the pixels of the window must be contiguous in the buffer.
+ * Only for LV_DISPLAY_RENDER_MODE_PARTIAL.
+ * @param disp          display object
+ * @param tile_w        width of the hashed tiles in pixels (the horizontal resolution hashes whole rows),
+ *                      0: disable the filter
+ * @return              LV_RESULT_OK or LV_RESULT_INVALID if the hash table couldn't be allocated
+ * @note                Narrow tiles cost memory (4 bytes per tile) but keep narrow areas flushed at
+ *                      different x positions of the same rows from invalidating each other.
+ */
+lv_result_t lv_lcd_generic_mipi_set_row_hash(lv_display_t * disp, uint32_t tile_w);
+
+/**
+ * Forget the hashes of the row hash filter so that every row is sent again.
+ * Call it when the controller's memory was written by other means (e.g. after a reset).
+ * @param disp          display object
+ */
+void lv_lcd_generic_mipi_reset_row_hash(lv_display_t * disp);
+
+/**
+ * Get the statistics of the row hash filter
+ * @param disp          display object
+ * @param stats         pointer to the structure to fill
+ */
+void lv_lcd_generic_mipi_get_row_hash_stats(lv_display_t * disp, lv_lcd_row_hash_stats_t * stats);
+
+/**
+ * Synchronize the batched transfers to the panel's refresh with its TE (tearing effect) output.
+ * The TE output of the controller is enabled (V-blank only). The platform reports every TE pulse with
+ * `lv_lcd_generic_mipi_tear_pulse()`, and the transport asks `lv_lcd_generic_mipi_get_tear_delay()`
+ * how long to hold back each transfer. Without recent TE pulses, e.g. if the pin isn't wired,
+ * the transfers are sent at once.
+ * @param disp          display object
+ * @param config        panel timing (copied), NULL to disable the synchronization and the TE output
+ */
+void lv_lcd_generic_mipi_set_tear_sync(lv_display_t * disp, const lv_lcd_tear_sync_config_t * config);
+
+/**
+ * Report a TE pulse, can be called from an interrupt
+ * @param disp          display object
+ * @param time_us       time of the rising edge in microseconds, same clock as for `lv_lcd_generic_mipi_get_tear_delay()`
+ */
+void lv_lcd_generic_mipi_tear_pulse(lv_display_t * disp, uint32_t time_us);
+
+/**
+ * Get how long to wait before starting a batched transfer so that it doesn't race the panel's scan.
+ * From the last TE pulse and the measured frame period the scan line of the panel is predicted for
+ * the duration of the transfer. A start is tear-free if every beam pass over the written lines
+ * shows either only old or only new lines. The earliest such start within a frame is chosen.
+ * @param disp          display object
+ * @param xfer          the transfer about to be sent
+ * @param now_us        current time in microseconds
+ * @return              delay in microseconds, 0: send it now (tear-free, or no tear-free start exists,
+ *                      or not synchronized)
+ */
+uint32_t lv_lcd_generic_mipi_get_tear_delay(lv_display_t * disp, const lv_lcd_transfer_t * xfer, uint32_t now_us);
+
+/**
+ * Get the statistics of the tearing effect synchronization
+ * @param disp          display object
+ * @param stats         pointer to the structure to fill
+ */
+void lv_lcd_generic_mipi_get_tear_sync_stats(lv_display_t * disp, lv_lcd_tear_sync_stats_t * stats);
+
+/**
+ * Move the pixels of a scrolled screen with the controller's vertical scrolling instead of sending
+ * them again (see `lv_display_set_scroll_blit()`). The whole display becomes the scrolling area
+ * (SET_SCROLL_AREA) and the rows of the memory form a ring: scrolling only moves its start
+ * (SET_SCROLL_START) and the flushes write each row to where it is shown now.
+ * Only the vertical scrolling of the whole display is moved, and only if the rows of the display are
+ * the rows of the memory (no swapped axes). Needs batched transfers (`lv_lcd_generic_mipi_set_send_transfer_cb()`)
+ * as a window may wrap around the end of the ring. Other scrolled areas are redrawn.
+ * @param disp          display object
+ * @param mem_lines     rows of the controller's memory, at least the rows of the display and `y_gap`
+ *                      (e.g. 480 for the ST7796), 0: disable
+ */
+void lv_lcd_generic_mipi_set_hw_scroll(lv_display_t * disp, uint32_t mem_lines);
+
+/**
+ * Get the bytes of a segment of a batched transfer
+ * @param seg           segment of a transfer
+ * @return              pointer to `seg->size` bytes
+ */
+const uint8_t * lv_lcd_transfer_seg_get_data(const lv_lcd_transfer_seg_t * seg);
+
 /**********************
  *      OTHERS
  **********************/
@@ -13,14 +13,18 @@
 #include "../misc/lv_types.h"
 #include "../misc/lv_log.h"
 #include "../misc/lv_utils.h"
+#include "../misc/lv_iter.h"
+#include "../misc/cache/lv_cache_entry.h"
+#include "../misc/cache/class/lv_cache_lru_rb.h"
 #include "../stdlib/lv_mem.h"
 
 /*********************
  *      DEFINES
  *********************/
-#if LV_USE_FONT_COMPRESSED
-    #define font_rle LV_GLOBAL_DEFAULT()->font_fmt_rle
-#endif /*LV_USE_FONT_COMPRESSED*/
+#define glyph_cache_p (LV_GLOBAL_DEFAULT()->font_fmt_txt_cache)
+#define font_draw_buf_handlers &(LV_GLOBAL_DEFAULT()->font_draw_buf_handlers)
+#define CACHE_NAME  "FONT_FMT_TXT_GLYPH"
+#define lookup_state_p (&(LV_GLOBAL_DEFAULT()->font_fmt_txt_lookup))
 
 /**********************
  *      TYPEDEFS
@@ -36,15 +40,33 @@ typedef struct {
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int unicode_list_compare(const void * ref, const void * element);
+static const lv_font_fmt_txt_lookup_t * lookup_get(const lv_font_t * font);
+static lv_font_fmt_txt_lookup_t * lookup_create(const lv_font_t * font);
+static lv_font_fmt_txt_lookup_entry_t lookup_find(const lv_font_fmt_txt_lookup_t * lookup, const lv_font_t * font,
+                                                  uint32_t letter);
+static lv_font_fmt_txt_lookup_entry_t lookup_entry(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid,
+                                                   const uint8_t * pair_rows, const uint8_t * pair_cols);
+static void lookup_drop(const lv_font_fmt_txt_dsc_t * fdsc);
+static lv_font_fmt_txt_lookup_t ** lookup_bucket_get(const lv_font_fmt_txt_dsc_t * fdsc);
+static inline uint32_t lookup_hash(uint32_t letter);
+static uint32_t cmap_letter_cnt(const lv_font_fmt_txt_cmap_t * cmap);
+static uint32_t cmap_letter(const lv_font_fmt_txt_cmap_t * cmap, uint32_t i);
 static int kern_pair_8_compare(const void * ref, const void * element);
 static int kern_pair_16_compare(const void * ref, const void * element);
+static void expand_bitmap(const lv_font_fmt_txt_dsc_t * fdsc, const lv_font_fmt_txt_glyph_dsc_t * gdsc,
+                          uint32_t stride_in, uint8_t * bitmap_out);
+static lv_cache_entry_t * glyph_cache_acquire(lv_font_glyph_dsc_t * g_dsc);
+static bool glyph_cache_create_cb(lv_font_fmt_txt_cache_data_t * data, lv_font_glyph_dsc_t * g_dsc);
+static void glyph_cache_free_cb(lv_font_fmt_txt_cache_data_t * data, void * user_data);
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_font_fmt_txt_cache_data_t * lhs,
+                                                     const lv_font_fmt_txt_cache_data_t * rhs);
 
 #if LV_USE_FONT_COMPRESSED
     static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h, uint8_t bpp, bool prefilter);
-    static inline void decompress_line(uint8_t * out, int32_t w);
+    static inline void decompress_line(lv_font_fmt_rle_t * rle, uint8_t * out, int32_t w);
     static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len);
-    static inline void rle_init(const uint8_t * in,  uint8_t bpp);
-    static inline uint8_t rle_next(void);
+    static inline void rle_init(lv_font_fmt_rle_t * rle, const uint8_t * in,  uint8_t bpp);
+    static inline uint8_t rle_next(lv_font_fmt_rle_t * rle);
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 static lv_font_t * builtin_font_create_cb(const lv_font_info_t * info, const void * src);
@@ -99,13 +121,217 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, lv_draw_buf
 
     if(g_dsc->req_raw_bitmap) return &fdsc->glyph_bitmap[gdsc->bitmap_index];
 
-    uint8_t * bitmap_out = draw_buf->data;
     int32_t gsize = (int32_t) gdsc->box_w * gdsc->box_h;
     if(gsize == 0) return NULL;
 
-    uint32_t stride_in = g_dsc->stride;
+#if !LV_USE_FONT_COMPRESSED
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) {
+        LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
+        return NULL;
+    }
+#endif
+
+    /*8 bpp bitmaps are only copied, the others are worth keeping expanded*/
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN || fdsc->bpp != 8) {
+        lv_cache_entry_t * entry = glyph_cache_acquire(g_dsc);
+        if(entry) {
+            lv_font_fmt_txt_cache_data_t * data = lv_cache_entry_get_data(entry);
+            g_dsc->entry = entry;
+            return data->draw_buf;
+        }
+    }
+
+    expand_bitmap(fdsc, gdsc, g_dsc->stride, draw_buf->data);
+    lv_draw_buf_flush_cache(draw_buf, NULL);
+    return draw_buf;
+}
+
+bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
+                                   uint32_t unicode_letter_next)
+{
+    /*It fixes a strange compiler optimization issue: https://github.com/lvgl/lvgl/issues/4370*/
+    bool is_tab = unicode_letter == '\t';
+    if(is_tab) {
+        unicode_letter = ' ';
+    }
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    uint32_t gid;
+    int8_t kvalue = 0;
+
+    const lv_font_fmt_txt_lookup_t * lookup = lookup_get(font);
+    if(lookup) {
+        lv_font_fmt_txt_lookup_entry_t entry = lookup_find(lookup, font, unicode_letter);
+        gid = entry.gid;
+        if(!gid) return false;
+
+        if(fdsc->kern_dsc && unicode_letter_next) {
+            lv_font_fmt_txt_lookup_entry_t entry_next = lookup_find(lookup, font, unicode_letter_next);
+            if(entry_next.gid == 0) {
+                /*No kerning with a missing glyph*/
+            }
+            else if(lookup->kern_values == NULL) {
+                kvalue = get_kern_value(font, gid, entry_next.gid);
+            }
+            else if(entry.left_class > 0 && entry_next.right_class > 0) {
+                kvalue = lookup->kern_values[(entry.left_class - 1) * lookup->kern_right_cnt + (entry_next.right_class - 1)];
+            }
+        }
+    }
+    else {
+        gid = get_glyph_dsc_id(font, unicode_letter);
+        if(!gid) return false;
+
+        if(fdsc->kern_dsc) {
+            uint32_t gid_next = get_glyph_dsc_id(font, unicode_letter_next);
+            if(gid_next) {
+                kvalue = get_kern_value(font, gid, gid_next);
+            }
+        }
+    }
+
+    /*Put together a glyph dsc*/
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+
+    int32_t kv = ((int32_t)((int32_t)kvalue * fdsc->kern_scale) >> 4);
+
+    uint32_t adv_w = gdsc->adv_w;
+    if(is_tab) adv_w *= 2;
+
+    adv_w += kv;
+    adv_w  = (adv_w + (1 << 3)) >> 4;
+
+    dsc_out->adv_w = adv_w;
+    dsc_out->box_h = gdsc->box_h;
+    dsc_out->box_w = gdsc->box_w;
+    dsc_out->ofs_x = gdsc->ofs_x;
+    dsc_out->ofs_y = gdsc->ofs_y;
+
+    if(fdsc->stride == 0) dsc_out->stride = 0;
+    else {
+        /*E.g. w = 5, bpp = 2, means 2 bytes/line*/
+        uint32_t bit_count = dsc_out->box_w * fdsc->bpp;
+        uint32_t width_in_bytes = (bit_count + 7) >> 3; /*No division round up*/
+
+        /*E.g. font_dsc stride == 4 means align to 4 byte boundary.
+         *In glyph_dsc store the actual line length in bytes*/
+        dsc_out->stride = LV_ROUND_UP(width_in_bytes, fdsc->stride);
+    }
+
+    dsc_out->format = (uint8_t)fdsc->bpp;
+    dsc_out->is_placeholder = false;
+    dsc_out->gid.index = gid;
+
+    if(is_tab) dsc_out->box_w = dsc_out->box_w * 2;
+
+    return true;
+}
+
+void lv_font_fmt_txt_cache_init(uint32_t size)
+{
+    if(glyph_cache_p != NULL) return;
+
+    glyph_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(lv_font_fmt_txt_cache_data_t), size, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t) glyph_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t) glyph_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t) glyph_cache_free_cb,
+    });
+    lv_cache_set_name(glyph_cache_p, CACHE_NAME);
+}
+
+void lv_font_fmt_txt_cache_deinit(void)
+{
+    if(glyph_cache_p == NULL) return;
+
+    lv_cache_destroy(glyph_cache_p, NULL);
+    glyph_cache_p = NULL;
+}
+
+void lv_font_fmt_txt_cache_resize(uint32_t new_size, bool evict_now)
+{
+    if(glyph_cache_p == NULL) return;
+
+    lv_cache_set_max_size(glyph_cache_p, new_size, NULL);
+    if(evict_now) {
+        lv_cache_reserve(glyph_cache_p, new_size, NULL);
+    }
+}
+
+void lv_font_fmt_txt_cache_drop(const lv_font_t * font)
+{
+    lookup_drop(font ? font->dsc : NULL);
+
+    if(glyph_cache_p == NULL) return;
+
+    if(font == NULL) {
+        lv_cache_drop_all(glyph_cache_p, NULL);
+        return;
+    }
+
+    /*Collect the glyphs first, dropping them would break the iteration*/
+    lv_array_t gids;
+    lv_array_init(&gids, 16, sizeof(uint32_t));
+    lv_font_fmt_txt_cache_data_t * elem = lv_malloc(lv_cache_entry_get_size(sizeof(lv_font_fmt_txt_cache_data_t)));
+    LV_ASSERT_MALLOC(elem);
+    lv_iter_t * iter = lv_cache_iter_create(glyph_cache_p);
+    while(lv_iter_next(iter, elem) == LV_RESULT_OK) {
+        if(elem->font == font) lv_array_push_back(&gids, &elem->gid);
+    }
+    lv_iter_destroy(iter);
+    lv_free(elem);
+
+    lv_font_fmt_txt_cache_data_t search_key;
+    search_key.font = font;
+    uint32_t i;
+    for(i = 0; i < lv_array_size(&gids); i++) {
+        search_key.gid = *(uint32_t *)lv_array_at(&gids, i);
+        lv_cache_drop(glyph_cache_p, &search_key, NULL);
+    }
+    lv_array_deinit(&gids);
+}
+
+void lv_font_fmt_txt_release_glyph(lv_font_glyph_dsc_t * g_dsc)
+{
+    if(g_dsc->entry == NULL || glyph_cache_p == NULL) return;
+
+    lv_cache_release(glyph_cache_p, g_dsc->entry, NULL);
+    g_dsc->entry = NULL;
+}
+
+void lv_font_fmt_txt_lookup_init(uint32_t max_size)
+{
+    lv_font_fmt_txt_lookup_state_t * st = lookup_state_p;
+    lv_memzero(st->buckets, sizeof(st->buckets));
+    lv_mutex_init(&st->lock);
+    st->max_size = max_size;
+}
+
+void lv_font_fmt_txt_lookup_deinit(void)
+{
+    lookup_drop(NULL);
+    lv_mutex_delete(&lookup_state_p->lock);
+}
+
+void lv_font_fmt_txt_lookup_set_max_size(uint32_t max_size)
+{
+    lookup_drop(NULL);
+    lookup_state_p->max_size = max_size;
+}
 
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
 
+/**
+ * Expand the bitmap of a glyph to A8
+ * @param fdsc          the font's descriptor
+ * @param gdsc          the glyph's descriptor
+ * @param stride_in     bytes in a line of the stored bitmap, 0 if the lines are not padded
+ * @param bitmap_out    store the A8 bitmap here, with the stride of `lv_draw_buf_width_to_stride()`
+ */
+static void expand_bitmap(const lv_font_fmt_txt_dsc_t * fdsc, const lv_font_fmt_txt_glyph_dsc_t * gdsc,
+                          uint32_t stride_in, uint8_t * bitmap_out)
+{
     if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
         const uint8_t * bitmap_in = &fdsc->glyph_bitmap[gdsc->bitmap_index];
         uint8_t * bitmap_out_tmp = bitmap_out;
@@ -197,88 +423,431 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, lv_draw_buf
                 bitmap_in += line_rem;
             }
         }
-
-        lv_draw_buf_flush_cache(draw_buf, NULL);
-        return draw_buf;
     }
+#if LV_USE_FONT_COMPRESSED
     /*Handle compressed bitmap*/
     else {
-#if LV_USE_FONT_COMPRESSED
         bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED;
         decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], bitmap_out, gdsc->box_w, gdsc->box_h,
                    (uint8_t)fdsc->bpp, prefilter);
-        lv_draw_buf_flush_cache(draw_buf, NULL);
-        return draw_buf;
-#else /*!LV_USE_FONT_COMPRESSED*/
-        LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
-        return NULL;
+    }
 #endif
+}
+
+/**
+ * Get the expanded bitmap of a glyph from the cache, expand it into the cache if it's not there yet
+ * @param g_dsc     the glyph
+ * @return          the acquired cache entry or NULL if the cache is disabled or the bitmap doesn't fit
+ */
+static lv_cache_entry_t * glyph_cache_acquire(lv_font_glyph_dsc_t * g_dsc)
+{
+    if(glyph_cache_p == NULL || !lv_cache_is_enabled(glyph_cache_p)) return NULL;
+
+    const lv_font_fmt_txt_dsc_t * fdsc = g_dsc->resolved_font->dsc;
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[g_dsc->gid.index];
+
+    lv_font_fmt_txt_cache_data_t search_key;
+    search_key.font = g_dsc->resolved_font;
+    search_key.gid = g_dsc->gid.index;
+    search_key.draw_buf = NULL;
+    search_key.slot.size = sizeof(lv_draw_buf_t) +
+                           lv_draw_buf_width_to_stride(gdsc->box_w, LV_COLOR_FORMAT_A8) * gdsc->box_h;
+    if(search_key.slot.size > lv_cache_get_max_size(glyph_cache_p, NULL)) return NULL;
+
+    /*Expanded under the cache's lock, the other draw units wait instead of expanding the same glyph*/
+    return lv_cache_acquire_or_create(glyph_cache_p, &search_key, g_dsc);
+}
+
+static bool glyph_cache_create_cb(lv_font_fmt_txt_cache_data_t * data, lv_font_glyph_dsc_t * g_dsc)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = data->font->dsc;
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[data->gid];
+
+    data->draw_buf = lv_draw_buf_create_ex(font_draw_buf_handlers, gdsc->box_w, gdsc->box_h, LV_COLOR_FORMAT_A8,
+                                           LV_STRIDE_AUTO);
+    if(data->draw_buf == NULL) {
+        LV_LOG_WARN("No memory to cache a %dx%d glyph", (int)gdsc->box_w, (int)gdsc->box_h);
+        return false;
     }
 
-    /*If not returned earlier then the letter is not found in this font*/
-    return NULL;
+    expand_bitmap(fdsc, gdsc, g_dsc->stride, data->draw_buf->data);
+    lv_draw_buf_flush_cache(data->draw_buf, NULL);
+    return true;
 }
 
-bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
-                                   uint32_t unicode_letter_next)
+static void glyph_cache_free_cb(lv_font_fmt_txt_cache_data_t * data, void * user_data)
 {
-    /*It fixes a strange compiler optimization issue: https://github.com/lvgl/lvgl/issues/4370*/
-    bool is_tab = unicode_letter == '\t';
-    if(is_tab) {
-        unicode_letter = ' ';
+    LV_UNUSED(user_data);
+
+    if(data->draw_buf) lv_draw_buf_destroy(data->draw_buf);
+    data->draw_buf = NULL;
+}
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_font_fmt_txt_cache_data_t * lhs,
+                                                     const lv_font_fmt_txt_cache_data_t * rhs)
+{
+    if(lhs->font != rhs->font) {
+        return lhs->font > rhs->font ? 1 : -1;
     }
-    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
-    uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
-    if(!gid) return false;
+    if(lhs->gid != rhs->gid) {
+        return lhs->gid > rhs->gid ? 1 : -1;
+    }
+    return 0;
+}
 
-    int8_t kvalue = 0;
-    if(fdsc->kern_dsc) {
-        uint32_t gid_next = get_glyph_dsc_id(font, unicode_letter_next);
-        if(gid_next) {
-            kvalue = get_kern_value(font, gid, gid_next);
+/**
+ * Get the lookup tables of a font, build them on the first use
+ * @param font      pointer to a font
+ * @return          the lookup or NULL if the lookups are disabled or there is no memory for it
+ */
+static const lv_font_fmt_txt_lookup_t * lookup_get(const lv_font_t * font)
+{
+    lv_font_fmt_txt_lookup_state_t * st = lookup_state_p;
+    if(st->max_size == 0) return NULL;
+
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    lv_font_fmt_txt_lookup_t ** bucket = lookup_bucket_get(fdsc);
+    lv_font_fmt_txt_lookup_t * lookup;
+    /*Acquire pairs with the release below: a linked lookup is seen with its tables filled in*/
+    for(lookup = __atomic_load_n(bucket, __ATOMIC_ACQUIRE); lookup;
+        lookup = __atomic_load_n(&lookup->bucket_next, __ATOMIC_ACQUIRE)) {
+        if(lookup->fdsc == fdsc) return lookup->latin1 ? lookup : NULL;
+    }
+
+    /*Draw units can get glyphs at the same time, only one of them builds the tables*/
+    lv_mutex_lock(&st->lock);
+    for(lookup = *bucket; lookup; lookup = lookup->bucket_next) {
+        if(lookup->fdsc == fdsc) break;
+    }
+    if(lookup == NULL) {
+        lookup = lookup_create(font);
+        if(lookup) {
+            /*Published only when it's complete, the readers don't take the lock*/
+            lookup->bucket_next = *bucket;
+            __atomic_store_n(bucket, lookup, __ATOMIC_RELEASE);
         }
     }
+    lv_mutex_unlock(&st->lock);
 
-    /*Put together a glyph dsc*/
-    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    /*Without tables it only marks that they didn't fit*/
+    return lookup && lookup->latin1 ? lookup : NULL;
+}
 
-    int32_t kv = ((int32_t)((int32_t)kvalue * fdsc->kern_scale) >> 4);
+/**
+ * Build the lookup tables of a font. The tables are added in the order of their benefit
+ * (characters below 256, the other characters, a kerning matrix from the kern pairs)
+ * as long as they fit into the memory cap.
+ * @param font      pointer to a font
+ * @return          the new lookup (without tables if even the first one doesn't fit) or NULL on out of memory
+ */
+static lv_font_fmt_txt_lookup_t * lookup_create(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t max_size = lookup_state_p->max_size;
+
+    /*Count the characters with a glyph. The cmaps can overlap, so ask get_glyph_dsc_id() for each*/
+    uint32_t latin1_first = 256;
+    uint32_t latin1_last = 0;
+    uint32_t hash_cnt = 0;
+    uint32_t gid_max = 0;
+    uint32_t letter;
+    uint32_t gid;
+    for(letter = 1; letter < 256; letter++) {
+        gid = get_glyph_dsc_id(font, letter);
+        if(gid == 0) continue;
+        if(letter < latin1_first) latin1_first = letter;
+        latin1_last = letter;
+        gid_max = LV_MAX(gid_max, gid);
+    }
 
-    uint32_t adv_w = gdsc->adv_w;
-    if(is_tab) adv_w *= 2;
+    uint32_t c;
+    uint32_t i;
+    for(c = 0; c < fdsc->cmap_num; c++) {
+        uint32_t cnt = cmap_letter_cnt(&fdsc->cmaps[c]);
+        for(i = 0; i < cnt; i++) {
+            letter = cmap_letter(&fdsc->cmaps[c], i);
+            if(letter < 256) continue;
+            gid = get_glyph_dsc_id(font, letter);
+            if(gid == 0) continue;
+            hash_cnt++;
+            gid_max = LV_MAX(gid_max, gid);
+        }
+    }
 
-    adv_w += kv;
-    adv_w  = (adv_w + (1 << 3)) >> 4;
+    uint32_t latin1_cnt = latin1_first <= latin1_last ? latin1_last - latin1_first + 1 : 0;
+    /*Keep the hash table at most 3/4 full*/
+    uint32_t hash_slot_cnt = 4;
+    while(hash_slot_cnt < hash_cnt + hash_cnt / 3 + 1) hash_slot_cnt <<= 1;
+
+    /*Give a row and a column of a dense matrix to each glyph in the kern pairs*/
+    uint8_t * pair_rows = NULL;
+    uint8_t * pair_cols = NULL;
+    uint32_t pair_row_cnt = 0;
+    uint32_t pair_col_cnt = 0;
+    if(fdsc->kern_dsc && fdsc->kern_classes == 0 && gid_max <= UINT16_MAX) {
+        const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+        pair_rows = lv_malloc_zeroed(gid_max + 1);
+        pair_cols = lv_malloc_zeroed(gid_max + 1);
+        bool ok = pair_rows && pair_cols && kdsc->glyph_ids_size <= 1;
+        for(i = 0; ok && i < kdsc->pair_cnt; i++) {
+            uint32_t gid_left = kdsc->glyph_ids_size == 0 ? ((const uint8_t *)kdsc->glyph_ids)[i * 2] :
+                                ((const uint16_t *)kdsc->glyph_ids)[i * 2];
+            uint32_t gid_right = kdsc->glyph_ids_size == 0 ? ((const uint8_t *)kdsc->glyph_ids)[i * 2 + 1] :
+                                 ((const uint16_t *)kdsc->glyph_ids)[i * 2 + 1];
+            /*Glyphs without a character are never kerned*/
+            if(gid_left > gid_max || gid_right > gid_max) continue;
+
+            if(pair_rows[gid_left] == 0) {
+                if(pair_row_cnt == UINT8_MAX) ok = false;
+                else pair_rows[gid_left] = (uint8_t)++pair_row_cnt;
+            }
+            if(pair_cols[gid_right] == 0) {
+                if(pair_col_cnt == UINT8_MAX) ok = false;
+                else pair_cols[gid_right] = (uint8_t)++pair_col_cnt;
+            }
+        }
 
-    dsc_out->adv_w = adv_w;
-    dsc_out->box_h = gdsc->box_h;
-    dsc_out->box_w = gdsc->box_w;
-    dsc_out->ofs_x = gdsc->ofs_x;
-    dsc_out->ofs_y = gdsc->ofs_y;
+        if(!ok) {
+            lv_free(pair_rows);
+            lv_free(pair_cols);
+            pair_rows = NULL;
+            pair_cols = NULL;
+            pair_row_cnt = 0;
+            pair_col_cnt = 0;
+        }
+    }
 
-    if(fdsc->stride == 0) dsc_out->stride = 0;
-    else {
-        /*E.g. w = 5, bpp = 2, means 2 bytes/line*/
-        uint32_t bit_count = dsc_out->box_w * fdsc->bpp;
-        uint32_t width_in_bytes = (bit_count + 7) >> 3; /*No division round up*/
+    uint32_t size = sizeof(lv_font_fmt_txt_lookup_t);
+    uint32_t latin1_size = latin1_cnt * sizeof(lv_font_fmt_txt_lookup_entry_t);
+    uint32_t hash_size = hash_slot_cnt * (sizeof(uint32_t) + sizeof(lv_font_fmt_txt_lookup_entry_t));
+    uint32_t matrix_size = pair_row_cnt * pair_col_cnt;
+    /*The glyph ids are stored on 16 bits*/
+    bool has_latin1 = gid_max <= UINT16_MAX && size + latin1_size <= max_size;
+    if(has_latin1) size += latin1_size;
+    bool has_hash = has_latin1 && size + hash_size <= max_size;
+    if(has_hash) size += hash_size;
+    bool has_matrix = has_hash && matrix_size > 0 && size + matrix_size <= max_size;
+    if(has_matrix) size += matrix_size;
+
+    lv_font_fmt_txt_lookup_t * lookup = lv_malloc_zeroed(size);
+    if(lookup == NULL && size > sizeof(lv_font_fmt_txt_lookup_t)) {
+        /*Search the cmaps as before but don't try to build it again for every character*/
+        LV_LOG_WARN("No memory for the %" LV_PRIu32 " bytes lookup tables of a font", size);
+        has_latin1 = false;
+        has_hash = false;
+        has_matrix = false;
+        size = sizeof(lv_font_fmt_txt_lookup_t);
+        lookup = lv_malloc_zeroed(size);
+    }
+    if(lookup == NULL) {
+        lv_free(pair_rows);
+        lv_free(pair_cols);
+        return NULL;
+    }
 
-        /*E.g. font_dsc stride == 4 means align to 4 byte boundary.
-         *In glyph_dsc store the actual line length in bytes*/
-        dsc_out->stride = LV_ROUND_UP(width_in_bytes, fdsc->stride);
+    lookup->fdsc = fdsc;
+    lookup->size = size;
+    uint8_t * tables = (uint8_t *)(lookup + 1);
+    if(!has_matrix) {
+        /*The classes would point into a matrix which doesn't exist*/
+        lv_free(pair_rows);
+        lv_free(pair_cols);
+        pair_rows = NULL;
+        pair_cols = NULL;
     }
 
-    dsc_out->format = (uint8_t)fdsc->bpp;
-    dsc_out->is_placeholder = false;
-    dsc_out->gid.index = gid;
+    if(has_latin1) {
+        lv_font_fmt_txt_lookup_entry_t * latin1 = (lv_font_fmt_txt_lookup_entry_t *)tables;
+        tables += latin1_size;
+        for(i = 0; i < latin1_cnt; i++) {
+            gid = get_glyph_dsc_id(font, latin1_first + i);
+            latin1[i] = lookup_entry(fdsc, gid, pair_rows, pair_cols);
+        }
+        lookup->latin1 = latin1;
+        lookup->latin1_first = (uint16_t)latin1_first;
+        lookup->latin1_cnt = (uint16_t)latin1_cnt;
+    }
 
-    if(is_tab) dsc_out->box_w = dsc_out->box_w * 2;
+    if(has_hash) {
+        uint32_t * keys = (uint32_t *)tables;
+        tables += hash_slot_cnt * sizeof(uint32_t);
+        lv_font_fmt_txt_lookup_entry_t * entries = (lv_font_fmt_txt_lookup_entry_t *)tables;
+        tables += hash_slot_cnt * sizeof(lv_font_fmt_txt_lookup_entry_t);
+        uint32_t mask = hash_slot_cnt - 1;
+        for(c = 0; c < fdsc->cmap_num; c++) {
+            uint32_t cnt = cmap_letter_cnt(&fdsc->cmaps[c]);
+            for(i = 0; i < cnt; i++) {
+                letter = cmap_letter(&fdsc->cmaps[c], i);
+                if(letter < 256) continue;
+                gid = get_glyph_dsc_id(font, letter);
+                if(gid == 0) continue;
+
+                /*Linear probing, the letters of overlapping cmaps are added only once*/
+                uint32_t slot = lookup_hash(letter) & mask;
+                while(keys[slot] != 0 && keys[slot] != letter) slot = (slot + 1) & mask;
+                keys[slot] = letter;
+                entries[slot] = lookup_entry(fdsc, gid, pair_rows, pair_cols);
+            }
+        }
+        lookup->hash_keys = keys;
+        lookup->hash_entries = entries;
+        lookup->hash_mask = mask;
+    }
 
-    return true;
+    if(has_matrix) {
+        int8_t * matrix = (int8_t *)tables;
+        const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+        for(i = 0; i < kdsc->pair_cnt; i++) {
+            uint32_t gid_left = kdsc->glyph_ids_size == 0 ? ((const uint8_t *)kdsc->glyph_ids)[i * 2] :
+                                ((const uint16_t *)kdsc->glyph_ids)[i * 2];
+            uint32_t gid_right = kdsc->glyph_ids_size == 0 ? ((const uint8_t *)kdsc->glyph_ids)[i * 2 + 1] :
+                                 ((const uint16_t *)kdsc->glyph_ids)[i * 2 + 1];
+            if(gid_left > gid_max || gid_right > gid_max) continue;
+            matrix[(pair_rows[gid_left] - 1) * pair_col_cnt + (pair_cols[gid_right] - 1)] = kdsc->values[i];
+        }
+        lookup->kern_values = matrix;
+        lookup->kern_right_cnt = pair_col_cnt;
+        lv_free(pair_rows);
+        lv_free(pair_cols);
+    }
+    else if(fdsc->kern_dsc && fdsc->kern_classes) {
+        /*The classes of the font are already a dense matrix*/
+        const lv_font_fmt_txt_kern_classes_t * kdsc = fdsc->kern_dsc;
+        lookup->kern_values = kdsc->class_pair_values;
+        lookup->kern_right_cnt = kdsc->right_class_cnt;
+    }
+
+    return lookup;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+/**
+ * Map a character to a glyph and its kerning classes
+ * @param lookup    the lookup of the font
+ * @param font      pointer to the font
+ * @param letter    a Unicode code point
+ * @return          the glyph's id and classes, the id is 0 if the font has no glyph for `letter`
+ */
+static lv_font_fmt_txt_lookup_entry_t lookup_find(const lv_font_fmt_txt_lookup_t * lookup, const lv_font_t * font,
+                                                  uint32_t letter)
+{
+    static const lv_font_fmt_txt_lookup_entry_t no_glyph = {0, 0, 0};
+
+    if(letter < 256) {
+        uint32_t i = letter - lookup->latin1_first;
+        return i < lookup->latin1_cnt ? lookup->latin1[i] : no_glyph;
+    }
+
+    if(lookup->hash_keys) {
+        uint32_t slot = lookup_hash(letter) & lookup->hash_mask;
+        while(lookup->hash_keys[slot] != 0) {
+            if(lookup->hash_keys[slot] == letter) return lookup->hash_entries[slot];
+            slot = (slot + 1) & lookup->hash_mask;
+        }
+        return no_glyph;
+    }
+
+    /*The hash table didn't fit. There is a kerning matrix only if it did.*/
+    return lookup_entry(font->dsc, get_glyph_dsc_id(font, letter), NULL, NULL);
+}
+
+/**
+ * Create the lookup entry of a glyph
+ * @param fdsc      the font's descriptor
+ * @param gid       the glyph's id or 0
+ * @param pair_rows the kerning matrix row of the glyphs on the left side of kern pairs or NULL
+ * @param pair_cols the kerning matrix column of the glyphs on the right side of kern pairs or NULL
+ * @return          the entry
+ */
+static lv_font_fmt_txt_lookup_entry_t lookup_entry(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid,
+                                                   const uint8_t * pair_rows, const uint8_t * pair_cols)
+{
+    lv_font_fmt_txt_lookup_entry_t entry = {(uint16_t)gid, 0, 0};
+    if(gid == 0) return entry;
+
+    if(pair_rows) {
+        entry.left_class = pair_rows[gid];
+        entry.right_class = pair_cols[gid];
+    }
+    else if(fdsc->kern_dsc && fdsc->kern_classes) {
+        const lv_font_fmt_txt_kern_classes_t * kdsc = fdsc->kern_dsc;
+        entry.left_class = kdsc->left_class_mapping[gid];
+        entry.right_class = kdsc->right_class_mapping[gid];
+    }
+
+    return entry;
+}
+
+/**
+ * Free the lookup tables of a font
+ * @param fdsc      the descriptor of the font, NULL to free the lookups of all fonts
+ */
+static void lookup_drop(const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    lv_font_fmt_txt_lookup_state_t * st = lookup_state_p;
+
+    lv_mutex_lock(&st->lock);
+    uint32_t b;
+    for(b = 0; b < LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT; b++) {
+        lv_font_fmt_txt_lookup_t ** link = &st->buckets[b];
+        while(*link) {
+            lv_font_fmt_txt_lookup_t * lookup = *link;
+            if(fdsc == NULL || lookup->fdsc == fdsc) {
+                *link = lookup->bucket_next;
+                lv_free(lookup);
+            }
+            else {
+                link = &lookup->bucket_next;
+            }
+        }
+    }
+    lv_mutex_unlock(&st->lock);
+}
+
+/**
+ * Get the hash bucket of a font's lookup
+ * @param fdsc      the descriptor of the font
+ * @return          the head of the bucket's list
+ */
+static lv_font_fmt_txt_lookup_t ** lookup_bucket_get(const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    uintptr_t h = (uintptr_t)fdsc;
+    h ^= h >> 11;
+    return &lookup_state_p->buckets[(h >> 4) & (LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT - 1)];
+}
+
+static inline uint32_t lookup_hash(uint32_t letter)
+{
+    /*Fibonacci hashing, the letters of a font are often consecutive*/
+    uint32_t h = letter * 0x9E3779B1u;
+    return h ^ (h >> 16);
+}
+
+/**
+ * Get the number of code points a cmap lists
+ * @param cmap      pointer to a cmap
+ * @return          the number of code points
+ */
+static uint32_t cmap_letter_cnt(const lv_font_fmt_txt_cmap_t * cmap)
+{
+    if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+        return cmap->list_length;
+    }
+    return cmap->range_length;
+}
+
+/**
+ * Get a code point listed by a cmap. It doesn't necessarily have a glyph.
+ * @param cmap      pointer to a cmap
+ * @param i         index of the code point, less than `cmap_letter_cnt()`
+ * @return          the code point
+ */
+static uint32_t cmap_letter(const lv_font_fmt_txt_cmap_t * cmap, uint32_t i)
+{
+    if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+        return cmap->range_start + cmap->unicode_list[i];
+    }
+    return cmap->range_start + i;
+}
 
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 {
@@ -437,7 +1006,8 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
             return;
     }
 
-    rle_init(in, bpp);
+    lv_font_fmt_rle_t rle;
+    rle_init(&rle, in, bpp);
 
     uint8_t * line_buf1 = lv_malloc(w);
 
@@ -447,7 +1017,7 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
         line_buf2 = lv_malloc(w);
     }
 
-    decompress_line(line_buf1, w);
+    decompress_line(&rle, line_buf1, w);
 
     int32_t y;
     int32_t x;
@@ -460,7 +1030,7 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
 
     for(y = 1; y < h; y++) {
         if(prefilter) {
-            decompress_line(line_buf2, w);
+            decompress_line(&rle, line_buf2, w);
 
             for(x = 0; x < w; x++) {
                 line_buf1[x] = line_buf2[x] ^ line_buf1[x];
@@ -468,7 +1038,7 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
             }
         }
         else {
-            decompress_line(line_buf1, w);
+            decompress_line(&rle, line_buf1, w);
 
             for(x = 0; x < w; x++) {
                 out[x] = opa_table[line_buf1[x]];
@@ -483,14 +1053,15 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
 
 /**
  * Decompress one line. Store one pixel per byte
+ * @param rle the state of the decoder
  * @param out output buffer
  * @param w width of the line in pixel count
  */
-static inline void decompress_line(uint8_t * out, int32_t w)
+static inline void decompress_line(lv_font_fmt_rle_t * rle, uint8_t * out, int32_t w)
 {
     int32_t i;
     for(i = 0; i < w; i++) {
-        out[i] = rle_next();
+        out[i] = rle_next(rle);
     }
 }
 
@@ -536,9 +1107,8 @@ static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len
     }
 }
 
-static inline void rle_init(const uint8_t * in,  uint8_t bpp)
+static inline void rle_init(lv_font_fmt_rle_t * rle, const uint8_t * in,  uint8_t bpp)
 {
-    lv_font_fmt_rle_t * rle = &font_rle;
     rle->in = in;
     rle->bpp = bpp;
     rle->state = RLE_STATE_SINGLE;
@@ -547,11 +1117,10 @@ static inline void rle_init(const uint8_t * in,  uint8_t bpp)
     rle->count = 0;
 }
 
-static inline uint8_t rle_next(void)
+static inline uint8_t rle_next(lv_font_fmt_rle_t * rle)
 {
     uint8_t v = 0;
     uint8_t ret = 0;
-    lv_font_fmt_rle_t * rle = &font_rle;
 
     if(rle->state == RLE_STATE_SINGLE) {
         ret = get_bits(rle->in, rle->rdp, rle->bpp);
@@ -224,6 +224,30 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, lv_draw_buf
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                    uint32_t unicode_letter_next);
 
+/**
+ * Set the memory budget of the glyph cache of the fonts in this format.
+ * Glyphs stored with less than 8 bpp or compressed are expanded to A8 when they are drawn;
+ * the cache keeps the expanded bitmaps and frees the least recently drawn ones when a new one doesn't fit.
+ * @param new_size  the new size in bytes, 0 to disable the cache
+ * @param evict_now true: free bitmaps now to fit the new size; false: only when a new bitmap is added
+ */
+void lv_font_fmt_txt_cache_resize(uint32_t new_size, bool evict_now);
+
+/**
+ * Free the cached bitmaps and the lookup tables of a font. Needed before a font's memory is freed or reused.
+ * @param font      pointer to a font, or NULL to free the bitmaps and lookup tables of all fonts
+ */
+void lv_font_fmt_txt_cache_drop(const lv_font_t * font);
+
+/**
+ * Set the memory cap of the lookup tables built for each font in this format when it's first used.
+ * They map the characters to glyphs and kerning values in constant time instead of searching the
+ * character maps and kern pairs of the font for every character. Tables that don't fit are left out.
+ * The tables built so far are freed, so don't call it while rendering.
+ * @param max_size  bytes per font, 0 to disable the lookup tables
+ */
+void lv_font_fmt_txt_lookup_set_max_size(uint32_t max_size);
+
 /**********************
  *      MACROS
  **********************/
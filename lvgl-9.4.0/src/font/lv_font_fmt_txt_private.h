@@ -15,11 +15,25 @@ extern "C" {
  *********************/
 
 #include "lv_font_fmt_txt.h"
+#include "../misc/cache/lv_cache.h"
+#include "../osal/lv_os_private.h"
 
 /*********************
  *      DEFINES
  *********************/
 
+#ifndef LV_FONT_FMT_TXT_CACHE_DEF_SIZE
+#define LV_FONT_FMT_TXT_CACHE_DEF_SIZE 0 /**< Default memory budget of the glyph cache in bytes */
+#endif
+
+#ifndef LV_FONT_FMT_TXT_LOOKUP_DEF_SIZE
+#define LV_FONT_FMT_TXT_LOOKUP_DEF_SIZE 0 /**< Default memory cap of the lookup tables of a font in bytes */
+#endif
+
+#ifndef LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT
+#define LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT 16 /**< Buckets of the font -> lookup tables hash table, a power of 2*/
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -41,10 +55,83 @@ typedef struct {
 } lv_font_fmt_rle_t;
 #endif
 
+/** A glyph of a built-in font expanded to A8*/
+typedef struct {
+    lv_cache_slot_size_t slot;
+    const lv_font_t * font;     /**< The key: the font and the glyph's index*/
+    uint32_t gid;
+    lv_draw_buf_t * draw_buf;
+} lv_font_fmt_txt_cache_data_t;
+
+/** What a character maps to in a font*/
+typedef struct {
+    uint16_t gid;           /**< Index of the glyph, 0 if the font has no glyph for the character*/
+    uint8_t left_class;     /**< Row of the kerning matrix, 0 if the glyph isn't kerned on the left side*/
+    uint8_t right_class;    /**< Column of the kerning matrix, 0 if the glyph isn't kerned on the right side*/
+} lv_font_fmt_txt_lookup_entry_t;
+
+/** Lookup tables of a font built on its first use.
+ * The tables follow it in the same allocation.*/
+typedef struct _lv_font_fmt_txt_lookup_t {
+    struct _lv_font_fmt_txt_lookup_t * bucket_next; /**< The next lookup in the same hash bucket*/
+    const lv_font_fmt_txt_dsc_t * fdsc;             /**< The key: fonts sharing a descriptor share the lookup*/
+
+    /*Characters `latin1_first` ... `latin1_first + latin1_cnt - 1` (all below 256) by code point*/
+    const lv_font_fmt_txt_lookup_entry_t * latin1;  /**< NULL if it didn't fit into the memory cap*/
+    uint16_t latin1_first;
+    uint16_t latin1_cnt;
+
+    /*The other characters in an open addressing hash table, `hash_keys[i] == 0` marks a free slot*/
+    const uint32_t * hash_keys;                     /**< NULL if it didn't fit: the cmaps are searched*/
+    const lv_font_fmt_txt_lookup_entry_t * hash_entries;
+    uint32_t hash_mask;                             /**< Slot count - 1*/
+
+    /*Kerning values by the classes of the entries*/
+    const int8_t * kern_values;                     /**< NULL: no kerning or the kern pairs are searched*/
+    uint32_t kern_right_cnt;                        /**< Columns of `kern_values`*/
+
+    uint32_t size;                                  /**< Size of the allocation*/
+} lv_font_fmt_txt_lookup_t;
+
+/** State of the lookup tables of the built-in fonts*/
+typedef struct {
+    lv_font_fmt_txt_lookup_t * buckets[LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT]; /**< The lookups by font descriptor*/
+    lv_mutex_t lock;        /**< Held while a lookup is built or freed, reading needs no lock*/
+    uint32_t max_size;      /**< Memory cap of a font's lookup in bytes, 0: disabled*/
+} lv_font_fmt_txt_lookup_state_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
+/**
+ * Create the glyph cache of the built-in fonts
+ * @param size      the memory budget in bytes
+ */
+void lv_font_fmt_txt_cache_init(uint32_t size);
+
+/**
+ * Free the glyph cache of the built-in fonts
+ */
+void lv_font_fmt_txt_cache_deinit(void);
+
+/**
+ * Release the cached bitmap returned by `lv_font_get_bitmap_fmt_txt()`
+ * @param g_dsc     the glyph descriptor whose `entry` is set
+ */
+void lv_font_fmt_txt_release_glyph(lv_font_glyph_dsc_t * g_dsc);
+
+/**
+ * Initialize the lookup tables of the built-in fonts
+ * @param max_size  the memory cap of a font's lookup in bytes, 0 to disable the lookups
+ */
+void lv_font_fmt_txt_lookup_init(uint32_t max_size);
+
+/**
+ * Free the lookup tables of all fonts
+ */
+void lv_font_fmt_txt_lookup_deinit(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -22,9 +22,7 @@ extern "C" {
 
 #if LV_USE_GESTURE_RECOGNITION
 
-#if LV_USE_FLOAT == 0
-#error "LV_USE_FLOAT is required for gesture detection."
-#endif
+/*The recognizers use `float` themselves, `LV_USE_FLOAT` (float coordinates and angles) isn't needed*/
 
 /*********************
  *      DEFINES
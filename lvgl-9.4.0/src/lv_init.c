@@ -14,6 +14,9 @@
 #include "core/lv_refr_private.h"
 #include "core/lv_obj_style_private.h"
 #include "core/lv_group_private.h"
+#include "core/lv_obj_render_cache_private.h"
+#include "core/lv_obj_draw_list_private.h"
+#include "font/lv_font_fmt_txt_private.h"
 #include "lv_init.h"
 #include "core/lv_global.h"
 #include "core/lv_obj.h"
@@ -294,6 +297,10 @@ void lv_init(void)
 #endif
 
     lv_image_decoder_init(LV_CACHE_DEF_SIZE, LV_IMAGE_HEADER_CACHE_DEF_CNT);
+    lv_obj_render_cache_init(LV_OBJ_RENDER_CACHE_DEF_SIZE);
+    lv_obj_draw_list_init(LV_OBJ_DRAW_LIST_DEF_SIZE);
+    lv_font_fmt_txt_cache_init(LV_FONT_FMT_TXT_CACHE_DEF_SIZE);
+    lv_font_fmt_txt_lookup_init(LV_FONT_FMT_TXT_LOOKUP_DEF_SIZE);
     lv_bin_decoder_init();  /*LVGL built-in binary image decoder*/
 
 #if LV_USE_DRAW_VG_LITE
@@ -463,6 +470,10 @@ void lv_deinit(void)
     lv_theme_mono_deinit();
 #endif
 
+    lv_font_fmt_txt_cache_deinit();
+    lv_font_fmt_txt_lookup_deinit();
+    lv_obj_draw_list_deinit();
+    lv_obj_render_cache_deinit();
     lv_image_decoder_deinit();
 
     lv_refr_deinit();
@@ -15,6 +15,7 @@
 #include "../../core/lv_global.h"
 #include "../../misc/lv_async.h"
 #include "../../stdlib/lv_string.h"
+#include "../../stdlib/lv_sprintf.h"
 #include "../../widgets/label/lv_label.h"
 #include "../../display/lv_display_private.h"
 
@@ -43,6 +44,7 @@
     static void perf_monitor_disp_event_cb(lv_event_t * e);
     static void perf_dump_info(lv_display_t * disp);
     static void perf_control(lv_display_t * disp, bool start);
+    static lv_sysmon_proc_idle_cb_t perf_get_proc_idle_cb(const lv_sysmon_perf_info_t * info);
 #endif
 
 #if LV_USE_MEM_MONITOR
@@ -159,6 +161,18 @@ void lv_sysmon_performance_pause(lv_display_t * disp)
     perf_control(disp, false);
 }
 
+void lv_sysmon_performance_add_flush_bytes(lv_display_t * disp, uint32_t sent, uint32_t saved)
+{
+    lv_sysmon_perf_info_t * info = &disp->perf_sysmon_info;
+    info->measured.flush_bytes += sent;
+    info->measured.flush_bytes_saved += saved;
+}
+
+void lv_sysmon_performance_set_proc_idle_cb(lv_display_t * disp, lv_sysmon_proc_idle_cb_t cb)
+{
+    disp->perf_sysmon_info.proc_idle_cb = cb;
+}
+
 #endif
 
 #if LV_USE_MEM_MONITOR
@@ -271,10 +285,8 @@ static void perf_dump_info(lv_display_t * disp)
                                   1000 / disp_refr_period);   /*Limit due to possible off-by-one error*/
 
     info->calculated.cpu = 100 - LV_SYSMON_GET_IDLE();
-#if LV_SYSMON_PROC_IDLE_AVAILABLE
-    uint32_t LV_SYSMON_GET_PROC_IDLE(void);
-    info->calculated.cpu_proc = 100 - LV_SYSMON_GET_PROC_IDLE();
-#endif /*LV_SYSMON_PROC_IDLE_AVAILABLE*/
+    lv_sysmon_proc_idle_cb_t proc_idle_cb = perf_get_proc_idle_cb(info);
+    if(proc_idle_cb) info->calculated.cpu_proc = 100 - proc_idle_cb();
     info->calculated.refr_avg_time = info->measured.refr_cnt ? (info->measured.refr_elaps_sum / info->measured.refr_cnt) :
                                      0;
 
@@ -286,6 +298,15 @@ static void perf_dump_info(lv_display_t * disp)
                                                                      info->measured.flush_in_render_elaps_sum) /
                                                                     info->measured.render_cnt) : 0;
 
+    info->calculated.flush_kbps = time_since_last_report ? (info->measured.flush_bytes / time_since_last_report) : 0;
+    uint32_t flush_bytes_total = info->measured.flush_bytes + info->measured.flush_bytes_saved;
+    info->calculated.flush_saved_pct = flush_bytes_total ? (uint32_t)((uint64_t)info->measured.flush_bytes_saved * 100 /
+                                                                      flush_bytes_total) : 0;
+    uint32_t render_px = info->measured.render_px;
+    info->calculated.overdraw_pct = render_px ? (uint32_t)((uint64_t)info->measured.draw_px * 100 / render_px) : 0;
+    info->calculated.overdraw_unculled_pct = render_px ? (uint32_t)(((uint64_t)info->measured.draw_px +
+                                                                     info->measured.draw_px_culled) * 100 / render_px) : 0;
+
     info->calculated.cpu_avg_total = ((info->calculated.cpu_avg_total * (info->calculated.run_cnt - 1)) +
                                       info->calculated.cpu) / info->calculated.run_cnt;
     info->calculated.fps_avg_total = ((info->calculated.fps_avg_total * (info->calculated.run_cnt - 1)) +
@@ -297,9 +318,8 @@ static void perf_dump_info(lv_display_t * disp)
     lv_memzero(info, sizeof(lv_sysmon_perf_info_t));
     info->measured.refr_start = prev_info.measured.refr_start;
     info->calculated.cpu_avg_total = prev_info.calculated.cpu_avg_total;
-#if LV_SYSMON_PROC_IDLE_AVAILABLE
     info->calculated.cpu_proc = prev_info.calculated.cpu_proc;
-#endif  /*LV_SYSMON_PROC_IDLE_AVAILABLE*/
+    info->proc_idle_cb = prev_info.proc_idle_cb;
     info->calculated.fps_avg_total = prev_info.calculated.fps_avg_total;
     info->calculated.run_cnt = prev_info.calculated.run_cnt;
 
@@ -319,45 +339,74 @@ static void perf_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
 
 #if LV_USE_PERF_MONITOR_LOG_MODE
     LV_UNUSED(observer);
-#if LV_SYSMON_PROC_IDLE_AVAILABLE
-    LV_LOG("sysmon: "
-           "%" LV_PRIu32 " FPS (refr_cnt: %" LV_PRIu32 " | redraw_cnt: %" LV_PRIu32"), "
-           "refr %" LV_PRIu32 "ms (render %" LV_PRIu32 "ms | flush %" LV_PRIu32 "ms), "
-           "CPU (total %" LV_PRIu32 "%% proc %" LV_PRIu32 "%%)\n",
-           perf->calculated.fps, perf->measured.refr_cnt, perf->measured.render_cnt,
-           perf->calculated.refr_avg_time, perf->calculated.render_avg_time, perf->calculated.flush_avg_time,
-           perf->calculated.cpu, perf->calculated.cpu_proc);
+    if(perf_get_proc_idle_cb(perf)) {
+        LV_LOG("sysmon: "
+               "%" LV_PRIu32 " FPS (refr_cnt: %" LV_PRIu32 " | redraw_cnt: %" LV_PRIu32"), "
+               "refr %" LV_PRIu32 "ms (render %" LV_PRIu32 "ms | flush %" LV_PRIu32 "ms), "
+               "CPU (total %" LV_PRIu32 "%% proc %" LV_PRIu32 "%%)\n",
+               perf->calculated.fps, perf->measured.refr_cnt, perf->measured.render_cnt,
+               perf->calculated.refr_avg_time, perf->calculated.render_avg_time, perf->calculated.flush_avg_time,
+               perf->calculated.cpu, perf->calculated.cpu_proc);
+    }
+    else {
+        LV_LOG("sysmon: "
+               "%" LV_PRIu32 " FPS (refr_cnt: %" LV_PRIu32 " | redraw_cnt: %" LV_PRIu32"), "
+               "refr %" LV_PRIu32 "ms (render %" LV_PRIu32 "ms | flush %" LV_PRIu32 "ms), "
+               "CPU %" LV_PRIu32 "%%\n",
+               perf->calculated.fps, perf->measured.refr_cnt, perf->measured.render_cnt,
+               perf->calculated.refr_avg_time, perf->calculated.render_avg_time, perf->calculated.flush_avg_time,
+               perf->calculated.cpu);
+    }
 #else
-    LV_LOG("sysmon: "
-           "%" LV_PRIu32 " FPS (refr_cnt: %" LV_PRIu32 " | redraw_cnt: %" LV_PRIu32"), "
-           "refr %" LV_PRIu32 "ms (render %" LV_PRIu32 "ms | flush %" LV_PRIu32 "ms), "
-           "CPU %" LV_PRIu32 "%%\n",
-           perf->calculated.fps, perf->measured.refr_cnt, perf->measured.render_cnt,
-           perf->calculated.refr_avg_time, perf->calculated.render_avg_time, perf->calculated.flush_avg_time,
-           perf->calculated.cpu);
+    lv_obj_t * label = lv_observer_get_target(observer);
+    if(perf_get_proc_idle_cb(perf)) {
+        lv_label_set_text_fmt(
+            label,
+            "%" LV_PRIu32" FPS | CPU (%" LV_PRIu32 "%% | %" LV_PRIu32 "%%)\n"
+            "%" LV_PRIu32" ms (%" LV_PRIu32" | %" LV_PRIu32")",
+            perf->calculated.fps, perf->calculated.cpu, perf->calculated.cpu_proc,
+            perf->calculated.render_avg_time + perf->calculated.flush_avg_time,
+            perf->calculated.render_avg_time, perf->calculated.flush_avg_time
+        );
+    }
+    else {
+        lv_label_set_text_fmt(
+            label,
+            "%" LV_PRIu32" FPS, %" LV_PRIu32 "%% CPU\n"
+            "%" LV_PRIu32" ms (%" LV_PRIu32" | %" LV_PRIu32")",
+            perf->calculated.fps, perf->calculated.cpu,
+            perf->calculated.render_avg_time + perf->calculated.flush_avg_time,
+            perf->calculated.render_avg_time, perf->calculated.flush_avg_time
+        );
+    }
+#endif /*LV_USE_PERF_MONITOR_LOG_MODE*/
+
+#if !LV_USE_PERF_MONITOR_LOG_MODE
+    char buf[32];
 #endif
+
+    /*Only displays with occlusion culling get the overdraw line*/
+    if(perf->measured.occlusion_culling) {
+#if LV_USE_PERF_MONITOR_LOG_MODE
+        LV_LOG("sysmon: overdraw %" LV_PRIu32 "%%, %" LV_PRIu32 "%% without occlusion culling\n",
+               perf->calculated.overdraw_pct, perf->calculated.overdraw_unculled_pct);
 #else
-    lv_obj_t * label = lv_observer_get_target(observer);
-#if LV_SYSMON_PROC_IDLE_AVAILABLE
-    lv_label_set_text_fmt(
-        label,
-        "%" LV_PRIu32" FPS | CPU (%" LV_PRIu32 "%% | %" LV_PRIu32 "%%)\n"
-        "%" LV_PRIu32" ms (%" LV_PRIu32" | %" LV_PRIu32")",
-        perf->calculated.fps, perf->calculated.cpu, perf->calculated.cpu_proc,
-        perf->calculated.render_avg_time + perf->calculated.flush_avg_time,
-        perf->calculated.render_avg_time, perf->calculated.flush_avg_time
-    );
+        lv_snprintf(buf, sizeof(buf), "\nOverdraw %" LV_PRIu32 "%% (%" LV_PRIu32 "%%)",
+                    perf->calculated.overdraw_pct, perf->calculated.overdraw_unculled_pct);
+        lv_label_ins_text(label, LV_LABEL_POS_LAST, buf);
+#endif
+    }
+
+    /*Only drivers that call `lv_sysmon_performance_add_flush_bytes` get the bandwidth line*/
+    if(perf->measured.flush_bytes == 0 && perf->measured.flush_bytes_saved == 0) return;
+#if LV_USE_PERF_MONITOR_LOG_MODE
+    LV_LOG("sysmon: flush %" LV_PRIu32 " kB/s, %" LV_PRIu32 "%% not sent\n",
+           perf->calculated.flush_kbps, perf->calculated.flush_saved_pct);
 #else
-    lv_label_set_text_fmt(
-        label,
-        "%" LV_PRIu32" FPS, %" LV_PRIu32 "%% CPU\n"
-        "%" LV_PRIu32" ms (%" LV_PRIu32" | %" LV_PRIu32")",
-        perf->calculated.fps, perf->calculated.cpu,
-        perf->calculated.render_avg_time + perf->calculated.flush_avg_time,
-        perf->calculated.render_avg_time, perf->calculated.flush_avg_time
-    );
-#endif /*LV_SYSMON_PROC_IDLE_AVAILABLE*/
-#endif /*LV_USE_PERF_MONITOR_LOG_MODE*/
+    lv_snprintf(buf, sizeof(buf), "\n%" LV_PRIu32 " kB/s (%" LV_PRIu32 "%% saved)",
+                perf->calculated.flush_kbps, perf->calculated.flush_saved_pct);
+    lv_label_ins_text(label, LV_LABEL_POS_LAST, buf);
+#endif
 }
 
 static void perf_control(lv_display_t * disp, bool start)
@@ -378,6 +427,22 @@ static void perf_control(lv_display_t * disp, bool start)
     }
 }
 
+/**
+ * Get the function which reports the idle time of the other core or process
+ * @param info      the performance data of a display
+ * @return          the callback of the display, else `LV_SYSMON_GET_PROC_IDLE` if available, else NULL
+ */
+static lv_sysmon_proc_idle_cb_t perf_get_proc_idle_cb(const lv_sysmon_perf_info_t * info)
+{
+    if(info->proc_idle_cb) return info->proc_idle_cb;
+#if LV_SYSMON_PROC_IDLE_AVAILABLE
+    uint32_t LV_SYSMON_GET_PROC_IDLE(void);
+    return LV_SYSMON_GET_PROC_IDLE;
+#else
+    return NULL;
+#endif
+}
+
 #endif
 
 #if LV_USE_MEM_MONITOR
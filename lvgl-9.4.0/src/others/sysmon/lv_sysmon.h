@@ -35,6 +35,11 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * Report the idle time of an other core or process in percent
+ */
+typedef uint32_t (*lv_sysmon_proc_idle_cb_t)(void);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -81,6 +86,21 @@ void lv_sysmon_performance_resume(lv_display_t * disp);
  */
 void lv_sysmon_performance_pause(lv_display_t * disp);
 
+/**
+ * Report the bytes a display driver sent for a flush, shown next to the timings.
+ * @param disp      the display
+ * @param sent      bytes sent to the display
+ * @param saved     bytes of the flushed area the driver didn't need to send (e.g. unchanged rows)
+ */
+void lv_sysmon_performance_add_flush_bytes(lv_display_t * disp, uint32_t sent, uint32_t saved);
+
+/**
+ * Set a function which reports the idle time of an other core or process, its load is shown next to the CPU usage.
+ * Overrides `LV_SYSMON_GET_PROC_IDLE`.
+ * @param disp      the display
+ * @param cb        the function, NULL: use `LV_SYSMON_GET_PROC_IDLE` if it's available
+ */
+void lv_sysmon_performance_set_proc_idle_cb(lv_display_t * disp, lv_sysmon_proc_idle_cb_t cb);
 
 #endif /*LV_USE_PERF_MONITOR*/
 
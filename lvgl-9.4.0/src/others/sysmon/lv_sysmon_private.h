@@ -47,23 +47,32 @@ struct _lv_sysmon_perf_info_t {
         uint32_t flush_not_in_render_start;
         uint32_t flush_not_in_render_elaps_sum;
         uint32_t last_report_timestamp;
+        uint32_t flush_bytes;               /**< Bytes sent to the display, reported by the driver*/
+        uint32_t flush_bytes_saved;         /**< Bytes the driver didn't need to send*/
+        uint32_t render_px;                 /**< Pixels of the refreshed areas*/
+        uint32_t draw_px;                   /**< Pixels of the draw tasks which were drawn*/
+        uint32_t draw_px_culled;            /**< Pixels of the draw tasks dropped or clipped by occlusion culling*/
         uint32_t render_in_progress : 1;
+        uint32_t occlusion_culling : 1;     /**< Occlusion culling was enabled while rendering*/
     } measured;
 
     struct {
         uint32_t fps;
         uint32_t cpu;
-#if LV_SYSMON_PROC_IDLE_AVAILABLE
-        uint32_t cpu_proc;              /** The applications idle time percentage */
-#endif
+        uint32_t cpu_proc;              /**< Load of the process or core of `proc_idle_cb`*/
         uint32_t refr_avg_time;
         uint32_t render_avg_time;       /**< Pure rendering time without flush time*/
         uint32_t flush_avg_time;        /**< Pure flushing time without rendering time*/
+        uint32_t flush_kbps;            /**< Bytes sent to the display in kB/s*/
+        uint32_t flush_saved_pct;       /**< Share of the rendered bytes the driver didn't send*/
+        uint32_t overdraw_pct;          /**< Pixels drawn per refreshed pixel in percent*/
+        uint32_t overdraw_unculled_pct; /**< The same without occlusion culling*/
         uint32_t cpu_avg_total;
         uint32_t fps_avg_total;
         uint32_t run_cnt;
     } calculated;
 
+    lv_sysmon_proc_idle_cb_t proc_idle_cb;  /**< Set by `lv_sysmon_performance_set_proc_idle_cb()`*/
 };
 #endif
 
@@ -0,0 +1,225 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     64
+#define VER_RES     48
+#define STRIP_LINES 8
+#define STRIP_SIZE  (HOR_RES * STRIP_LINES * 2)
+#define RING_CNT    3
+
+/*Every buffer of a raw ring has to start aligned*/
+#define RAW_STRIP_SIZE  LV_ROUND_UP(STRIP_SIZE, LV_DRAW_BUF_ALIGN)
+#define RAW_STRIP_LINES (RAW_STRIP_SIZE / (HOR_RES * 2))
+#define RAW_STRIP_CNT   ((VER_RES + RAW_STRIP_LINES - 1) / RAW_STRIP_LINES)
+
+typedef struct {
+    lv_area_t area;
+    uint8_t * px_map;
+    uint32_t checksum;
+} pending_strip_t;
+
+/*The strips LVGL passed to flush_cb and the driver hasn't finished yet*/
+static pending_strip_t pending[RING_CNT + 1];
+static uint32_t pending_cnt;
+static uint32_t pending_max;
+static uint32_t flush_cnt;
+
+static uint16_t frame[VER_RES][HOR_RES];
+static uint8_t * ring_bufs[RING_CNT];
+static bool flush_ready_in_cb;
+
+void setUp(void)
+{
+    pending_cnt = 0;
+    pending_max = 0;
+    flush_cnt = 0;
+    flush_ready_in_cb = false;
+    lv_memzero(frame, sizeof(frame));
+}
+
+void tearDown(void)
+{
+}
+
+static uint32_t checksum(const uint8_t * px_map, const lv_area_t * area)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+    for(i = 0; i < lv_area_get_size(area) * 2; i++) sum = sum * 31 + px_map[i];
+    return sum;
+}
+
+static void copy_to_frame(const lv_area_t * area, const uint8_t * px_map)
+{
+    const uint16_t * px = (const uint16_t *)px_map;
+    int32_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_memcpy(&frame[y][area->x1], px, lv_area_get_width(area) * 2);
+        px += lv_area_get_width(area);
+    }
+}
+
+/*Complete the oldest strip like a DMA finishing in the background*/
+static void complete_oldest(lv_display_t * disp)
+{
+    TEST_ASSERT_GREATER_THAN(0, pending_cnt);
+
+    pending_strip_t * s = &pending[0];
+    /*LVGL must not have rendered into a buffer which is still being flushed*/
+    TEST_ASSERT_EQUAL_UINT32(s->checksum, checksum(s->px_map, &s->area));
+    copy_to_frame(&s->area, s->px_map);
+
+    pending_cnt--;
+    lv_memmove(&pending[0], &pending[1], pending_cnt * sizeof(pending_strip_t));
+    lv_display_flush_ready(disp);
+}
+
+static void ring_flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    /*The buffers have to be used in order*/
+    TEST_ASSERT_EQUAL_PTR(ring_bufs[flush_cnt % RING_CNT], px_map);
+    flush_cnt++;
+
+    if(flush_ready_in_cb) {
+        copy_to_frame(area, px_map);
+        lv_display_flush_ready(disp);
+        return;
+    }
+
+    TEST_ASSERT_LESS_THAN(RING_CNT, pending_cnt);
+    pending[pending_cnt].area = *area;
+    pending[pending_cnt].px_map = px_map;
+    pending[pending_cnt].checksum = checksum(px_map, area);
+    pending_cnt++;
+    if(pending_cnt > pending_max) pending_max = pending_cnt;
+}
+
+static void ring_flush_wait_cb(lv_display_t * disp)
+{
+    complete_oldest(disp);
+}
+
+static void direct_flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    copy_to_frame(area, px_map);
+    lv_display_flush_ready(disp);
+}
+
+static void create_scene(lv_display_t * disp)
+{
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_hide_performance(disp);
+#endif
+#if LV_USE_MEM_MONITOR
+    lv_sysmon_hide_memory(disp);
+#endif
+    lv_obj_t * scr = lv_display_get_screen_active(disp);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x1234ab), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_color_hex(0xfedc21), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_VER, 0);
+
+    lv_obj_t * obj = lv_obj_create(scr);
+    lv_obj_set_size(obj, 40, 30);
+    lv_obj_set_pos(obj, 4, 6);
+    lv_obj_set_style_radius(obj, 8, 0);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_60, 0);
+
+    lv_obj_t * label = lv_label_create(scr);
+    lv_label_set_text(label, "Ring");
+    lv_obj_align(label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+}
+
+static void render_reference(uint16_t ref[VER_RES][HOR_RES])
+{
+    lv_display_t * disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_draw_buf_t * buf = lv_draw_buf_create(HOR_RES, VER_RES, LV_COLOR_FORMAT_RGB565, HOR_RES * 2);
+    lv_display_set_draw_buffers(disp, buf, NULL);
+    lv_display_set_render_mode(disp, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, direct_flush_cb);
+    create_scene(disp);
+    lv_refr_now(disp);
+    lv_memcpy(ref, frame, sizeof(frame));
+
+    lv_display_delete(disp);
+    lv_draw_buf_destroy(buf);
+    lv_memzero(frame, sizeof(frame));
+}
+
+void test_display_buffer_ring_queues_strips(void)
+{
+    static uint16_t ref[VER_RES][HOR_RES];
+    render_reference(ref);
+
+    lv_display_t * disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+
+    lv_draw_buf_t * bufs[RING_CNT];
+    uint32_t i;
+    for(i = 0; i < RING_CNT; i++) {
+        bufs[i] = lv_draw_buf_create(HOR_RES, STRIP_LINES, LV_COLOR_FORMAT_RGB565, HOR_RES * 2);
+        ring_bufs[i] = bufs[i]->data;
+    }
+    lv_display_set_draw_buffer_ring(disp, bufs, RING_CNT);
+    lv_display_set_flush_cb(disp, ring_flush_cb);
+    lv_display_set_flush_wait_cb(disp, ring_flush_wait_cb);
+    create_scene(disp);
+
+    lv_refr_now(disp);
+
+    /*The whole screen in 8 line strips, at most RING_CNT of them were in flight at once*/
+    TEST_ASSERT_EQUAL_UINT32(VER_RES / STRIP_LINES, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(RING_CNT, pending_max);
+
+    /*Finish the transfers which are still queued*/
+    while(pending_cnt) complete_oldest(disp);
+    TEST_ASSERT_EQUAL_MEMORY(ref, frame, sizeof(frame));
+
+    lv_display_delete(disp);
+    for(i = 0; i < RING_CNT; i++) lv_draw_buf_destroy(bufs[i]);
+}
+
+void test_display_buffer_ring_raw_buffer(void)
+{
+    static uint16_t ref[VER_RES][HOR_RES];
+    render_reference(ref);
+
+    static LV_ATTRIBUTE_MEM_ALIGN uint8_t ring[RING_CNT * RAW_STRIP_SIZE + LV_DRAW_BUF_ALIGN];
+    uint8_t * ring_aligned = lv_draw_buf_align(ring, LV_COLOR_FORMAT_RGB565);
+
+    lv_display_t * disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffer_ring(disp, ring_aligned, RAW_STRIP_SIZE, RING_CNT);
+    lv_display_set_flush_cb(disp, ring_flush_cb);
+    create_scene(disp);
+
+    uint32_t i;
+    for(i = 0; i < RING_CNT; i++) ring_bufs[i] = ring_aligned + i * RAW_STRIP_SIZE;
+
+    TEST_ASSERT_EQUAL_UINT32(RAW_STRIP_SIZE, lv_display_get_draw_buf_size(disp));
+    TEST_ASSERT_EQUAL(LV_DISPLAY_RENDER_MODE_PARTIAL, disp->render_mode);
+
+    /*A synchronous driver calls lv_display_flush_ready() from flush_cb*/
+    flush_ready_in_cb = true;
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(RAW_STRIP_CNT, flush_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(ref, frame, sizeof(frame));
+
+    /*The ring continues where it stopped in the next refresh*/
+    lv_obj_invalidate(lv_display_get_screen_active(disp));
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(2 * RAW_STRIP_CNT, flush_cnt);
+
+    /*Switching back to normal buffers drops the ring*/
+    static LV_ATTRIBUTE_MEM_ALIGN uint8_t buf[STRIP_SIZE + LV_DRAW_BUF_ALIGN];
+    lv_display_set_buffers(disp, lv_draw_buf_align(buf, LV_COLOR_FORMAT_RGB565), NULL, STRIP_SIZE,
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    TEST_ASSERT_NULL(disp->buf_ring);
+
+    lv_display_delete(disp);
+}
+
+#endif
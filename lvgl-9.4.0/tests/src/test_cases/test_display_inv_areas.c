@@ -0,0 +1,151 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     480
+#define VER_RES     320
+#define BUF_SIZE    (HOR_RES * 20 * 2)
+
+static lv_display_t * disp;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint64_t flushed_px;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(px_map);
+    flushed_px += lv_area_get_size(area);
+    lv_display_flush_ready(d);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_refr_now(disp);
+    lv_display_reset_inv_stats(disp);
+    flushed_px = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+}
+
+static bool is_saved(const lv_area_t * area)
+{
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(lv_area_is_in(area, &disp->inv_areas[i], 0)) return true;
+    }
+    return false;
+}
+
+void test_inv_areas_grow(void)
+{
+    lv_display_inv_stats_t stats;
+    lv_display_get_inv_stats(disp, &stats);
+    TEST_ASSERT_EQUAL_UINT32(LV_INV_BUF_SIZE, stats.capacity);
+
+    /*100 separate areas fit after growing the buffer twice*/
+    uint32_t i;
+    for(i = 0; i < 100; i++) {
+        lv_area_t a = {(i % 20) * 24, (i / 20) * 24, (i % 20) * 24 + 9, (i / 20) * 24 + 9};
+        lv_inv_area(disp, &a);
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, disp->inv_p);
+
+    lv_display_get_inv_stats(disp, &stats);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.saved);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.peak);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overflows);
+    TEST_ASSERT_EQUAL_UINT32(LV_INV_BUF_SIZE * 4, stats.capacity);
+
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+    TEST_ASSERT_EQUAL_UINT64(100 * 100, flushed_px);
+}
+
+void test_inv_areas_contained(void)
+{
+    lv_area_t small1 = {10, 10, 19, 19};
+    lv_area_t small2 = {30, 30, 39, 39};
+    lv_area_t large = {0, 0, 99, 99};
+
+    lv_inv_area(disp, &small1);
+    lv_inv_area(disp, &small2);
+    lv_inv_area(disp, &large);
+    /*The saved ones in the new area are dropped*/
+    TEST_ASSERT_EQUAL_UINT32(1, disp->inv_p);
+
+    /*A new one in a saved area isn't saved*/
+    lv_inv_area(disp, &small1);
+    TEST_ASSERT_EQUAL_UINT32(1, disp->inv_p);
+
+    lv_display_inv_stats_t stats;
+    lv_display_get_inv_stats(disp, &stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.saved);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dropped);
+}
+
+void test_inv_areas_overflow(void)
+{
+    /*Many small areas in a band at the top: coalesced, but not into the whole screen*/
+    lv_area_t areas[1000];
+    uint32_t i;
+    lv_rand_set_seed(42);
+    for(i = 0; i < 1000; i++) {
+        areas[i].x1 = lv_rand(0, HOR_RES - 10);
+        areas[i].y1 = lv_rand(0, 30);
+        areas[i].x2 = areas[i].x1 + lv_rand(0, 9);
+        areas[i].y2 = areas[i].y1 + lv_rand(0, 9);
+        lv_inv_area(disp, &areas[i]);
+    }
+
+    lv_display_inv_stats_t stats;
+    lv_display_get_inv_stats(disp, &stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.overflows);
+    TEST_ASSERT_EQUAL_UINT32(LV_INV_BUF_MAX, stats.capacity);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_INV_BUF_MAX, disp->inv_p);
+    for(i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(is_saved(&areas[i]));
+    }
+    /*Only snapped to the tiles in the band*/
+    for(i = 0; i < disp->inv_p; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(47, disp->inv_areas[i].y2);
+    }
+
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT64(HOR_RES * 48, flushed_px);
+}
+
+void test_inv_areas_overflow_everywhere(void)
+{
+    /*Areas all over the screen: coalescing can end with the whole screen but never loses an area*/
+    lv_area_t areas[2000];
+    uint32_t i;
+    lv_rand_set_seed(7);
+    for(i = 0; i < 2000; i++) {
+        int32_t w = lv_rand(1, 31);
+        int32_t h = lv_rand(1, 31);
+        areas[i].x1 = lv_rand(0, HOR_RES - 1);
+        areas[i].y1 = lv_rand(0, VER_RES - 1);
+        areas[i].x2 = LV_MIN(areas[i].x1 + w - 1, HOR_RES - 1);
+        areas[i].y2 = LV_MIN(areas[i].y1 + h - 1, VER_RES - 1);
+        lv_inv_area(disp, &areas[i]);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_INV_BUF_MAX, disp->inv_p);
+    }
+    for(i = 0; i < 2000; i++) {
+        TEST_ASSERT_TRUE(is_saved(&areas[i]));
+    }
+
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+}
+
+#endif
@@ -0,0 +1,262 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     480
+#define VER_RES     320
+#define BUF_SIZE    (HOR_RES * 20 * 2)
+
+static lv_display_t * disp;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static lv_area_t flushed[64];
+static uint32_t flush_cnt;
+static uint8_t cover_map[VER_RES][HOR_RES];
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(px_map);
+    if(flush_cnt < 64) flushed[flush_cnt] = *area;
+    flush_cnt++;
+    lv_display_flush_ready(d);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_refr_now(disp);
+    flush_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+}
+
+static uint32_t get_areas(lv_area_t * out)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i] == 0) out[cnt++] = disp->inv_areas[i];
+    }
+    return cnt;
+}
+
+void test_inv_tiles_size(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, lv_display_get_inv_tile_size(disp));
+    TEST_ASSERT_EQUAL(LV_RESULT_INVALID, lv_display_set_inv_tile_size(disp, 24));
+    TEST_ASSERT_EQUAL(LV_RESULT_INVALID, lv_display_set_inv_tile_size(disp, 2));
+    TEST_ASSERT_EQUAL_UINT32(0, lv_display_get_inv_tile_size(disp));
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_display_set_inv_tile_size(disp, 32));
+    TEST_ASSERT_EQUAL_UINT32(32, lv_display_get_inv_tile_size(disp));
+    TEST_ASSERT_EQUAL_UINT32(HOR_RES / 32, disp->inv_tile_cols);
+    TEST_ASSERT_EQUAL_UINT32(VER_RES / 32, disp->inv_tile_rows);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_display_set_inv_tile_size(disp, 0));
+    TEST_ASSERT_NULL(disp->inv_tiles);
+}
+
+void test_inv_tiles_runs(void)
+{
+    lv_display_set_inv_tile_size(disp, 16);
+
+    /*Two areas in the same tiles, one next to them and one far away*/
+    lv_area_t a1 = {20, 20, 25, 25};
+    lv_area_t a2 = {18, 30, 30, 31};
+    lv_area_t a3 = {35, 17, 40, 28};
+    lv_area_t a4 = {300, 200, 301, 201};
+    lv_inv_area(disp, &a1);
+    lv_inv_area(disp, &a2);
+    lv_inv_area(disp, &a3);
+    lv_inv_area(disp, &a4);
+    /*Nothing is saved to the list*/
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+
+    lv_refr_inv_tiles_to_areas(disp);
+    lv_area_t areas[8];
+    TEST_ASSERT_EQUAL_UINT32(2, get_areas(areas));
+    TEST_ASSERT_EQUAL_INT32(16, areas[0].x1);
+    TEST_ASSERT_EQUAL_INT32(16, areas[0].y1);
+    TEST_ASSERT_EQUAL_INT32(47, areas[0].x2);
+    TEST_ASSERT_EQUAL_INT32(31, areas[0].y2);
+    TEST_ASSERT_EQUAL_INT32(288, areas[1].x1);
+    TEST_ASSERT_EQUAL_INT32(192, areas[1].y1);
+    TEST_ASSERT_EQUAL_INT32(303, areas[1].x2);
+    TEST_ASSERT_EQUAL_INT32(207, areas[1].y2);
+
+    /*The tiles are clean again*/
+    lv_inv_area(disp, NULL);
+    lv_refr_inv_tiles_to_areas(disp);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+}
+
+void test_inv_tiles_stack_rows(void)
+{
+    lv_display_set_inv_tile_size(disp, 16);
+
+    /*Same columns in 3 rows of tiles: one area. Different columns below it: an other one.*/
+    lv_area_t a1 = {40, 10, 60, 40};
+    lv_area_t a2 = {40, 50, 100, 60};
+    lv_inv_area(disp, &a1);
+    lv_inv_area(disp, &a2);
+
+    lv_refr_inv_tiles_to_areas(disp);
+    lv_area_t areas[8];
+    TEST_ASSERT_EQUAL_UINT32(2, get_areas(areas));
+    TEST_ASSERT_EQUAL_INT32(32, areas[0].x1);
+    TEST_ASSERT_EQUAL_INT32(0, areas[0].y1);
+    TEST_ASSERT_EQUAL_INT32(63, areas[0].x2);
+    TEST_ASSERT_EQUAL_INT32(47, areas[0].y2);
+    TEST_ASSERT_EQUAL_INT32(32, areas[1].x1);
+    TEST_ASSERT_EQUAL_INT32(48, areas[1].y1);
+    TEST_ASSERT_EQUAL_INT32(111, areas[1].x2);
+    TEST_ASSERT_EQUAL_INT32(63, areas[1].y2);
+}
+
+void test_inv_tiles_window_cost(void)
+{
+    lv_display_set_inv_tile_size(disp, 16);
+
+    /*Two dirty tiles with 2 clean tiles between them*/
+    lv_area_t a1 = {0, 0, 5, 5};
+    lv_area_t a2 = {48, 0, 53, 5};
+    lv_area_t areas[8];
+
+    /*Without a window cost the gap is not worth refreshing*/
+    lv_inv_area(disp, &a1);
+    lv_inv_area(disp, &a2);
+    lv_refr_inv_tiles_to_areas(disp);
+    TEST_ASSERT_EQUAL_UINT32(2, get_areas(areas));
+    lv_inv_area(disp, NULL);
+
+    /*A window costs as much as 3 tiles*/
+    lv_display_area_cost_t cost = {.window = 3 * 16 * 16, .px_render = 1, .byte_flush = 0};
+    lv_display_set_area_cost(disp, &cost);
+    lv_inv_area(disp, &a1);
+    lv_inv_area(disp, &a2);
+    lv_refr_inv_tiles_to_areas(disp);
+    TEST_ASSERT_EQUAL_UINT32(1, get_areas(areas));
+    TEST_ASSERT_EQUAL_INT32(0, areas[0].x1);
+    TEST_ASSERT_EQUAL_INT32(63, areas[0].x2);
+}
+
+void test_inv_tiles_edges(void)
+{
+    /*The tiles on the right and bottom are cut by the screen*/
+    lv_display_set_inv_tile_size(disp, 64);
+    TEST_ASSERT_EQUAL_UINT32((HOR_RES + 63) / 64, disp->inv_tile_cols);
+
+    lv_area_t a = {HOR_RES - 10, VER_RES - 10, HOR_RES + 100, VER_RES + 100};
+    lv_inv_area(disp, &a);
+    lv_refr_inv_tiles_to_areas(disp);
+    lv_area_t areas[8];
+    TEST_ASSERT_EQUAL_UINT32(1, get_areas(areas));
+    TEST_ASSERT_EQUAL_INT32(448, areas[0].x1);
+    TEST_ASSERT_EQUAL_INT32(256, areas[0].y1);
+    TEST_ASSERT_EQUAL_INT32(HOR_RES - 1, areas[0].x2);
+    TEST_ASSERT_EQUAL_INT32(VER_RES - 1, areas[0].y2);
+}
+
+void test_inv_tiles_random(void)
+{
+    lv_display_area_cost_t cost = {.window = 20000, .px_render = 40, .byte_flush = 107};
+    lv_area_t inv[200];
+    uint32_t round;
+
+    lv_rand_set_seed(99);
+    for(round = 0; round < 100; round++) {
+        lv_display_set_inv_tile_size(disp, 4 << (round % 4));
+        lv_display_set_area_cost(disp, round % 2 ? &cost : NULL);
+
+        uint32_t cnt = lv_rand(1, 200);
+        uint32_t i;
+        for(i = 0; i < cnt; i++) {
+            int32_t w = lv_rand(1, 60);
+            int32_t h = lv_rand(1, 40);
+            inv[i].x1 = lv_rand(0, HOR_RES - 1);
+            inv[i].y1 = lv_rand(0, VER_RES - 1);
+            inv[i].x2 = LV_MIN(inv[i].x1 + w - 1, HOR_RES - 1);
+            inv[i].y2 = LV_MIN(inv[i].y1 + h - 1, VER_RES - 1);
+            lv_inv_area(disp, &inv[i]);
+        }
+
+        lv_refr_inv_tiles_to_areas(disp);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(disp->inv_cap, disp->inv_p);
+        /*The areas don't overlap and cover every invalidated pixel*/
+        lv_memzero(cover_map, sizeof(cover_map));
+        for(i = 0; i < disp->inv_p; i++) {
+            const lv_area_t * a = &disp->inv_areas[i];
+            int32_t x, y;
+            for(y = a->y1; y <= a->y2; y++) {
+                for(x = a->x1; x <= a->x2; x++) {
+                    TEST_ASSERT_EQUAL_UINT8(0, cover_map[y][x]);
+                    cover_map[y][x] = 1;
+                }
+            }
+        }
+        for(i = 0; i < cnt; i++) {
+            int32_t x, y;
+            for(y = inv[i].y1; y <= inv[i].y2; y++) {
+                for(x = inv[i].x1; x <= inv[i].x2; x++) {
+                    TEST_ASSERT_EQUAL_UINT8(1, cover_map[y][x]);
+                }
+            }
+        }
+        lv_inv_area(disp, NULL);
+    }
+}
+
+void test_inv_tiles_switch(void)
+{
+    /*The areas invalidated so far are kept when switching to tiles and back*/
+    lv_area_t a = {100, 100, 109, 109};
+    lv_inv_area(disp, &a);
+    lv_display_set_inv_tile_size(disp, 32);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+    TEST_ASSERT_TRUE(disp->inv_tiles_dirty);
+
+    lv_display_set_inv_tile_size(disp, 0);
+    lv_area_t areas[8];
+    TEST_ASSERT_EQUAL_UINT32(1, get_areas(areas));
+    TEST_ASSERT_TRUE(lv_area_is_in(&a, &areas[0], 0));
+}
+
+void test_inv_tiles_refresh(void)
+{
+    lv_obj_t * obj = lv_obj_create(lv_display_get_screen_active(disp));
+    lv_obj_set_pos(obj, 100, 100);
+    lv_obj_set_size(obj, 50, 50);
+    lv_refr_now(disp);
+
+    lv_display_set_inv_tile_size(disp, 32);
+    lv_obj_invalidate(obj);
+    flush_cnt = 0;
+    lv_refr_now(disp);
+
+    /*The tiles of the object are redrawn*/
+    TEST_ASSERT_EQUAL_UINT32(1, flush_cnt);
+    TEST_ASSERT_EQUAL_INT32(96, flushed[0].x1);
+    TEST_ASSERT_EQUAL_INT32(96, flushed[0].y1);
+    TEST_ASSERT_EQUAL_INT32(159, flushed[0].x2);
+    TEST_ASSERT_EQUAL_INT32(159, flushed[0].y2);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+    TEST_ASSERT_FALSE(disp->inv_tiles_dirty);
+
+    /*Rotating reallocates the tiles*/
+    lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_90);
+    TEST_ASSERT_EQUAL_UINT32(VER_RES / 32, disp->inv_tile_cols);
+    TEST_ASSERT_EQUAL_UINT32(HOR_RES / 32, disp->inv_tile_rows);
+    flush_cnt = 0;
+    lv_refr_now(disp);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, flush_cnt);
+}
+
+#endif
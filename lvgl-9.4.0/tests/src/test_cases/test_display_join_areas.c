@@ -0,0 +1,205 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     480
+#define VER_RES     320
+
+#define BUF_SIZE    (HOR_RES * 20 * 2)
+
+static lv_display_t * disp;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint32_t join_cb_cnt;
+static uint32_t flush_cnt;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(px_map);
+    flush_cnt++;
+    lv_display_flush_ready(d);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    join_cb_cnt = 0;
+    flush_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+}
+
+static void set_areas(const lv_area_t * areas, uint32_t cnt)
+{
+    lv_memzero(disp->inv_area_joined, cnt);
+    lv_memcpy(disp->inv_areas, areas, cnt * sizeof(lv_area_t));
+    disp->inv_p = cnt;
+}
+
+static uint32_t get_joined_areas(lv_area_t * out)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i] == 0) out[cnt++] = disp->inv_areas[i];
+    }
+    return cnt;
+}
+
+static uint64_t get_total_cost(const lv_area_t * areas, uint32_t cnt)
+{
+    uint64_t sum = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++) sum += lv_display_get_area_cost(disp, &areas[i]);
+    return sum;
+}
+
+/*Every invalidated area has to be in a refreshed one*/
+static void assert_covered(const lv_area_t * areas, uint32_t cnt, const lv_area_t * joined, uint32_t joined_cnt)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        bool found = false;
+        uint32_t j;
+        for(j = 0; j < joined_cnt && !found; j++) {
+            found = lv_area_is_in(&areas[i], &joined[j], 0);
+        }
+        TEST_ASSERT_TRUE(found);
+    }
+}
+
+static void join_cb(lv_display_t * d)
+{
+    join_cb_cnt++;
+    lv_refr_join_areas_pairwise(d);
+}
+
+void test_join_areas_default_cost(void)
+{
+    static const lv_area_t areas[] = {
+        {10, 10, 109, 59},
+        {20, 20, 49, 39},       /*In the first one*/
+        {100, 50, 159, 99},     /*Overlaps the first one a little: joining adds more than it saves*/
+        {100, 200, 199, 259},
+        {100, 230, 199, 289},   /*Overlaps the previous one by half*/
+        {300, 10, 301, 11},     /*Far from everything*/
+    };
+    lv_area_t joined[LV_INV_BUF_SIZE];
+
+    set_areas(areas, 6);
+    lv_refr_join_areas_sweep(disp);
+    TEST_ASSERT_EQUAL_UINT32(4, get_joined_areas(joined));
+    assert_covered(areas, 6, joined, 4);
+
+    /*Same result as the strategy of the earlier versions*/
+    set_areas(areas, 6);
+    lv_refr_join_areas_pairwise(disp);
+    TEST_ASSERT_EQUAL_UINT32(4, get_joined_areas(joined));
+    assert_covered(areas, 6, joined, 4);
+}
+
+void test_join_areas_window_cost(void)
+{
+    /*Two labels next to each other and one on the other side of the screen*/
+    static const lv_area_t areas[] = {
+        {10, 100, 89, 119},
+        {94, 100, 173, 119},
+        {400, 280, 469, 299},
+    };
+    lv_area_t joined[LV_INV_BUF_SIZE];
+
+    /*Without a window cost nothing is worth joining*/
+    set_areas(areas, 3);
+    lv_refr_join_areas_sweep(disp);
+    TEST_ASSERT_EQUAL_UINT32(3, get_joined_areas(joined));
+
+    /*A window costs as much as 100 pixels: the 4 x 20 px gap is worth refreshing*/
+    lv_display_area_cost_t cost = {.window = 10000, .px_render = 40, .byte_flush = 30};
+    lv_display_set_area_cost(disp, &cost);
+    TEST_ASSERT_EQUAL_UINT64(10000 + 100 * (40 + 2 * 30), lv_display_get_area_cost(disp, &(lv_area_t) {0, 0, 9, 9}));
+
+    set_areas(areas, 3);
+    lv_refr_join_areas_sweep(disp);
+    TEST_ASSERT_EQUAL_UINT32(2, get_joined_areas(joined));
+    assert_covered(areas, 3, joined, 2);
+    TEST_ASSERT_LESS_THAN_UINT64(get_total_cost(areas, 3), get_total_cost(joined, 2));
+
+    set_areas(areas, 3);
+    lv_refr_join_areas_pairwise(disp);
+    TEST_ASSERT_EQUAL_UINT32(2, get_joined_areas(joined));
+
+    /*Back to the default*/
+    lv_display_set_area_cost(disp, NULL);
+    TEST_ASSERT_EQUAL_UINT64(100, lv_display_get_area_cost(disp, &(lv_area_t) {0, 0, 9, 9}));
+}
+
+void test_join_areas_random(void)
+{
+    lv_display_area_cost_t cost = {.window = 20000, .px_render = 40, .byte_flush = 107};
+    lv_area_t areas[LV_INV_BUF_SIZE];
+    lv_area_t joined[LV_INV_BUF_SIZE];
+    uint32_t round;
+
+    lv_rand_set_seed(1234);
+    for(round = 0; round < 200; round++) {
+        lv_display_set_area_cost(disp, round % 2 ? &cost : NULL);
+
+        uint32_t cnt = lv_rand(1, LV_INV_BUF_SIZE);
+        uint32_t i;
+        for(i = 0; i < cnt; i++) {
+            areas[i].x1 = lv_rand(0, HOR_RES - 1);
+            areas[i].y1 = lv_rand(0, VER_RES - 1);
+            areas[i].x2 = LV_MIN(areas[i].x1 + (int32_t)lv_rand(0, 120), HOR_RES - 1);
+            areas[i].y2 = LV_MIN(areas[i].y1 + (int32_t)lv_rand(0, 40), VER_RES - 1);
+        }
+
+        set_areas(areas, cnt);
+        lv_refr_join_areas_sweep(disp);
+        uint32_t joined_cnt = get_joined_areas(joined);
+        assert_covered(areas, cnt, joined, joined_cnt);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(get_total_cost(areas, cnt), get_total_cost(joined, joined_cnt));
+
+        set_areas(areas, cnt);
+        lv_refr_join_areas_pairwise(disp);
+        joined_cnt = get_joined_areas(joined);
+        assert_covered(areas, cnt, joined, joined_cnt);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(get_total_cost(areas, cnt), get_total_cost(joined, joined_cnt));
+    }
+}
+
+void test_join_areas_custom_cb(void)
+{
+    lv_obj_t * scr = lv_display_get_screen_active(disp);
+    lv_obj_t * obj1 = lv_obj_create(scr);
+    lv_obj_set_pos(obj1, 10, 10);
+    lv_obj_set_size(obj1, 50, 50);
+    lv_obj_t * obj2 = lv_obj_create(scr);
+    lv_obj_set_pos(obj2, 30, 30);
+    lv_obj_set_size(obj2, 50, 50);
+    lv_refr_now(disp);
+
+    lv_display_set_join_areas_cb(disp, join_cb);
+    lv_obj_invalidate(obj1);
+    lv_obj_invalidate(obj2);
+    flush_cnt = 0;
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(1, join_cb_cnt);
+    /*Joined into one area which fits into the buffer at once*/
+    TEST_ASSERT_EQUAL_UINT32(1, flush_cnt);
+
+    lv_display_set_join_areas_cb(disp, NULL);
+    lv_obj_invalidate(obj1);
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(1, join_cb_cnt);
+}
+
+#endif
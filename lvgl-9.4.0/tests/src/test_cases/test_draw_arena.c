@@ -0,0 +1,163 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     256
+#define VER_RES     160
+#define BUF_SIZE    (HOR_RES * VER_RES * 2)
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t frame_ref[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint8_t * frame_act;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    lv_memcpy(frame_act, px_map, BUF_SIZE);
+    lv_display_flush_ready(d);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    scr = lv_display_get_screen_active(disp);
+    lv_draw_arena_reset_stats();
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+    lv_draw_arena_resize(0);
+    lv_draw_arena_reset_stats();
+}
+
+static void widgets_create(void)
+{
+    lv_obj_t * btn = lv_button_create(scr);
+    lv_obj_set_pos(btn, 10, 10);
+    lv_label_set_text(lv_label_create(btn), "Button");
+
+    /*Its labels are drawn from a local buffer, so they are copied*/
+    lv_obj_t * scale = lv_scale_create(scr);
+    lv_obj_set_pos(scale, 10, 60);
+    lv_obj_set_size(scale, 200, 40);
+    lv_scale_set_mode(scale, LV_SCALE_MODE_HORIZONTAL_BOTTOM);
+    lv_scale_set_label_show(scale, true);
+    lv_scale_set_total_tick_count(scale, 21);
+    lv_scale_set_major_tick_every(scale, 5);
+
+    /*Drawn in a layer*/
+    lv_obj_t * semi = lv_obj_create(scr);
+    lv_obj_set_pos(semi, 120, 10);
+    lv_obj_set_size(semi, 120, 50);
+    lv_obj_set_style_opa(semi, LV_OPA_50, 0);
+    lv_label_set_text(lv_label_create(semi), "In a layer");
+
+    lv_obj_t * arc = lv_arc_create(scr);
+    lv_obj_set_pos(arc, 180, 100);
+    lv_obj_set_size(arc, 60, 60);
+}
+
+static void render(uint8_t * buf)
+{
+    lv_obj_invalidate(scr);
+    frame_act = buf;
+    lv_refr_now(disp);
+}
+
+void test_draw_arena_none_by_default(void)
+{
+    lv_draw_arena_stats_t stats;
+    widgets_create();
+    render(frame_ref);
+
+    lv_draw_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.size);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.alloc_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.heap_alloc_cnt);
+}
+
+void test_draw_arena_render(void)
+{
+    lv_draw_arena_stats_t stats;
+    widgets_create();
+    render(frame_ref);
+
+    lv_draw_arena_resize(16 * 1024);
+    lv_draw_arena_reset_stats();
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    lv_draw_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(16 * 1024, stats.size);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.alloc_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.heap_alloc_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.max_used);
+
+    /*Everything was freed so the arena is reused*/
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.reset_cnt);
+}
+
+void test_draw_arena_heap_fallback(void)
+{
+    lv_draw_arena_stats_t stats;
+    widgets_create();
+    render(frame_ref);
+
+    /*Only a few draw tasks fit, the rest is taken from the heap*/
+    lv_draw_arena_resize(512);
+    lv_draw_arena_reset_stats();
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    lv_draw_arena_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.alloc_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.heap_alloc_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(512, stats.max_used);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+}
+
+void test_draw_arena_resize_when_empty(void)
+{
+    lv_draw_arena_stats_t stats;
+    lv_draw_arena_resize(64);
+
+    uint8_t * p1 = lv_draw_arena_alloc(5);
+    uint8_t * p2 = lv_draw_arena_alloc(8);
+    TEST_ASSERT_NOT_NULL(p1);
+    TEST_ASSERT_EQUAL_PTR(p1 + 8, p2);
+    TEST_ASSERT_EQUAL_UINT32(0, (lv_uintptr_t)p1 % 8);
+
+    /*Doesn't fit*/
+    uint8_t * p3 = lv_draw_arena_alloc(100);
+    TEST_ASSERT_NOT_NULL(p3);
+    lv_draw_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(16, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.heap_alloc_cnt);
+
+    /*Applied only when the arena is empty*/
+    lv_draw_arena_resize(128);
+    lv_draw_arena_free(p3);
+    lv_draw_arena_free(p1);
+    lv_draw_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(64, stats.size);
+    TEST_ASSERT_EQUAL_UINT32(16, stats.used);
+
+    lv_draw_arena_free(p2);
+    lv_draw_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(128, stats.size);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.reset_cnt);
+}
+
+#endif
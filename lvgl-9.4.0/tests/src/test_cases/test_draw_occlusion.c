@@ -0,0 +1,281 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     256
+#define VER_RES     160
+#define BUF_SIZE    (HOR_RES * VER_RES * 2)
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t frame_ref[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint8_t * frame_act;
+
+static uint16_t image_rgb565_map[32 * 24];
+static uint32_t image_argb8888_map[32 * 24];
+
+static const lv_image_dsc_t image_rgb565 = {
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.cf = LV_COLOR_FORMAT_RGB565,
+    .header.w = 32,
+    .header.h = 24,
+    .header.stride = 32 * 2,
+    .data_size = sizeof(image_rgb565_map),
+    .data = (const uint8_t *)image_rgb565_map,
+};
+
+static const lv_image_dsc_t image_argb8888 = {
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.cf = LV_COLOR_FORMAT_ARGB8888,
+    .header.w = 32,
+    .header.h = 24,
+    .header.stride = 32 * 4,
+    .data_size = sizeof(image_argb8888_map),
+    .data = (const uint8_t *)image_argb8888_map,
+};
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    lv_memcpy(frame_act, px_map, BUF_SIZE);
+    lv_display_flush_ready(d);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    scr = lv_display_get_screen_active(disp);
+
+    uint32_t i;
+    for(i = 0; i < 32 * 24; i++) {
+        image_rgb565_map[i] = (uint16_t)(i * 2654435761u >> 16);
+        image_argb8888_map[i] = (i * 2654435761u) | 0x40000000;
+    }
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+}
+
+/**
+ * Render the screen without and with occlusion culling
+ * @param culled_px     the pixels of the culled draw tasks are stored here
+ * @return              the pixels of the draw tasks without culling
+ */
+static uint32_t render_both(uint32_t * culled_px)
+{
+    lv_sysmon_perf_info_t * perf = &disp->perf_sysmon_info;
+
+    lv_display_set_occlusion_culling(disp, false);
+    lv_obj_invalidate(scr);
+    frame_act = frame_ref;
+    lv_memzero(&perf->measured, sizeof(perf->measured));
+    lv_refr_now(disp);
+    uint32_t draw_px = perf->measured.draw_px;
+    TEST_ASSERT_EQUAL_UINT32(0, perf->measured.draw_px_culled);
+    TEST_ASSERT_EQUAL_UINT32(HOR_RES * VER_RES, perf->measured.render_px);
+
+    lv_display_set_occlusion_culling(disp, true);
+    lv_obj_invalidate(scr);
+    frame_act = frame;
+    lv_memzero(&perf->measured, sizeof(perf->measured));
+    lv_refr_now(disp);
+    TEST_ASSERT_TRUE(perf->measured.occlusion_culling);
+
+    /*The same draw tasks were added, and the image is the same*/
+    TEST_ASSERT_EQUAL_UINT32(draw_px, perf->measured.draw_px + perf->measured.draw_px_culled);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    *culled_px = perf->measured.draw_px_culled;
+    return draw_px;
+}
+
+static lv_obj_t * card_create(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    lv_obj_t * card = lv_obj_create(scr);
+    lv_obj_remove_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(card, x, y);
+    lv_obj_set_size(card, w, h);
+
+    lv_obj_t * label = lv_label_create(card);
+    lv_label_set_text(label, "Card\nwith text");
+    return card;
+}
+
+void test_occlusion_stacked_cards(void)
+{
+    /*Each card hides the bottom of the previous one*/
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        card_create(10, 10 + i * 12, 140, 90);
+    }
+
+    uint32_t culled_px;
+    uint32_t draw_px = render_both(&culled_px);
+    TEST_ASSERT_GREATER_THAN_UINT32(draw_px / 5, culled_px);
+}
+
+void test_occlusion_transparent(void)
+{
+    card_create(10, 10, 140, 100);
+    lv_obj_t * top = card_create(20, 20, 140, 100);
+    lv_obj_set_style_bg_opa(top, LV_OPA_50, 0);
+    lv_obj_set_style_border_opa(top, LV_OPA_50, 0);
+
+    /*The top card hides nothing, but the labels are still clipped by the opaque card below them*/
+    lv_obj_t * overlay = lv_obj_create(scr);
+    lv_obj_remove_style_all(overlay);
+    lv_obj_set_size(overlay, HOR_RES, VER_RES);
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_70, 0);
+
+    uint32_t culled_px;
+    render_both(&culled_px);
+
+    /*Only the screen's background is clipped by the cards*/
+    lv_obj_delete(top);
+    lv_obj_delete(overlay);
+    uint32_t culled_px_bottom;
+    render_both(&culled_px_bottom);
+    TEST_ASSERT_EQUAL_UINT32(culled_px_bottom, culled_px);
+}
+
+void test_occlusion_clip(void)
+{
+    /*A full width bar on the bottom half of a label: the label is clipped, not dropped*/
+    lv_obj_t * label = lv_label_create(scr);
+    lv_label_set_text(label, "Clipped\nlabel\nwith\nmore\nlines");
+    lv_obj_set_pos(label, 20, 20);
+
+    lv_obj_t * bar = lv_obj_create(scr);
+    lv_obj_remove_style_all(bar);
+    lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(bar, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_pos(bar, 0, 50);
+    lv_obj_set_size(bar, HOR_RES, 80);
+
+    /*The bottom of the label, the screen's background around the bar can't be clipped*/
+    uint32_t culled_px;
+    render_both(&culled_px);
+    TEST_ASSERT_EQUAL_UINT32(lv_area_get_width(&label->coords) * (label->coords.y2 - 50 + 1), culled_px);
+}
+
+void test_occlusion_image(void)
+{
+    lv_obj_t * label = lv_label_create(scr);
+    lv_label_set_text(label, "ab");
+    lv_obj_set_pos(label, 24, 24);
+
+    lv_obj_t * image = lv_image_create(scr);
+    lv_image_set_src(image, &image_argb8888);
+    lv_obj_set_pos(image, 20, 20);
+
+    /*With alpha the image hides nothing*/
+    uint32_t culled_px;
+    render_both(&culled_px);
+    TEST_ASSERT_EQUAL_UINT32(0, culled_px);
+
+    /*An opaque image hides the label*/
+    lv_image_set_src(image, &image_rgb565);
+    render_both(&culled_px);
+    TEST_ASSERT_EQUAL_UINT32(lv_area_get_size(&label->coords), culled_px);
+
+    /*Not when it's scaled*/
+    lv_image_set_scale(image, 300);
+    render_both(&culled_px);
+    TEST_ASSERT_EQUAL_UINT32(0, culled_px);
+}
+
+void test_occlusion_border(void)
+{
+    /*A thick border hides the labels under its sides, not the one in the middle*/
+    lv_obj_t * label_side = lv_label_create(scr);
+    lv_label_set_text(label_side, "x");
+    lv_obj_set_pos(label_side, 22, 50);
+    lv_obj_t * label_middle = lv_label_create(scr);
+    lv_label_set_text(label_middle, "x");
+    lv_obj_set_pos(label_middle, 80, 50);
+
+    lv_obj_t * frame_obj = lv_obj_create(scr);
+    lv_obj_remove_style_all(frame_obj);
+    lv_obj_set_pos(frame_obj, 20, 20);
+    lv_obj_set_size(frame_obj, 160, 100);
+    lv_obj_set_style_border_width(frame_obj, 20, 0);
+    lv_obj_set_style_border_opa(frame_obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(frame_obj, 8, 0);
+
+    uint32_t culled_px;
+    render_both(&culled_px);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(lv_area_get_size(&label_side->coords), culled_px);
+}
+
+void test_occlusion_random(void)
+{
+    /*Opaque and transparent objects with radius, border, shadow, labels and images on each other*/
+    lv_rand_set_seed(1234);
+    uint32_t i;
+    for(i = 0; i < 40; i++) {
+        lv_obj_t * obj = lv_obj_create(scr);
+        lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+        int32_t w = lv_rand(10, 120);
+        int32_t h = lv_rand(10, 90);
+        lv_obj_set_pos(obj, lv_rand(0, HOR_RES - 10) - 10, lv_rand(0, VER_RES - 10) - 10);
+        lv_obj_set_size(obj, w, h);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(lv_rand(0, 0xffffff)), 0);
+        lv_obj_set_style_bg_opa(obj, lv_rand(0, 3) ? LV_OPA_COVER : LV_OPA_60, 0);
+        lv_obj_set_style_radius(obj, lv_rand(0, 2) == 0 ? 0 : lv_rand(1, 60), 0);
+        lv_obj_set_style_border_width(obj, lv_rand(0, 6), 0);
+        lv_obj_set_style_border_opa(obj, lv_rand(0, 1) ? LV_OPA_COVER : LV_OPA_50, 0);
+        lv_obj_set_style_shadow_width(obj, lv_rand(0, 3) == 0 ? 10 : 0, 0);
+        lv_obj_set_style_pad_all(obj, 2, 0);
+
+        if(lv_rand(0, 1)) {
+            lv_obj_t * label = lv_label_create(obj);
+            lv_label_set_text(label, "Lorem ipsum dolor sit amet");
+        }
+        if(lv_rand(0, 3) == 0) {
+            lv_obj_t * image = lv_image_create(obj);
+            lv_image_set_src(image, lv_rand(0, 1) ? &image_rgb565 : &image_argb8888);
+        }
+    }
+
+    uint32_t culled_px;
+    uint32_t draw_px = render_both(&culled_px);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, culled_px);
+    TEST_ASSERT_LESS_THAN_UINT32(draw_px, culled_px);
+}
+
+void test_occlusion_queue(void)
+{
+    /*Draw tasks are dispatched when `LV_DRAW_OCCLUSION_QUEUE` are waiting in a layer*/
+    lv_obj_t * label = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_OCCLUSION_QUEUE * 2; i++) {
+        label = lv_label_create(scr);
+        lv_label_set_text(label, "x");
+        lv_obj_set_pos(label, (i % 16) * 12, (i / 16) * 20);
+    }
+
+    lv_obj_t * cover = lv_obj_create(scr);
+    lv_obj_remove_style_all(cover);
+    lv_obj_set_style_bg_opa(cover, LV_OPA_COVER, 0);
+    /*Not the whole screen, else the refresh would start with it*/
+    lv_obj_set_size(cover, HOR_RES, VER_RES - 1);
+
+    /*The screen's background was dispatched before the cover was added. How many labels were
+     *dispatched too depends on how fast the draw threads are.*/
+    uint32_t culled_px;
+    render_both(&culled_px);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, culled_px);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_DRAW_OCCLUSION_QUEUE * 2 * lv_area_get_size(&label->coords), culled_px);
+}
+
+#endif
@@ -0,0 +1,153 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     256
+#define VER_RES     160
+#define BUF_SIZE    (HOR_RES * VER_RES * 2)
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t frame_ref[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint8_t * frame_act;
+static uint32_t graph_seen;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    lv_memcpy(frame_act, px_map, BUF_SIZE);
+    lv_display_flush_ready(d);
+}
+
+static void draw_task_added_cb(lv_event_t * e)
+{
+    lv_draw_task_t * t = lv_event_get_draw_task(e);
+    if(t->target_layer->task_graph) graph_seen++;
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    scr = lv_display_get_screen_active(disp);
+    lv_obj_add_event_cb(scr, draw_task_added_cb, LV_EVENT_DRAW_TASK_ADDED, NULL);
+    lv_obj_add_flag(scr, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
+    graph_seen = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+}
+
+/**
+ * Render the screen without and with the draw task graph, and compare the frames
+ */
+static void render_both(void)
+{
+    lv_display_set_draw_task_graph(disp, false);
+    lv_obj_invalidate(scr);
+    frame_act = frame_ref;
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(0, graph_seen);
+
+    lv_display_set_draw_task_graph(disp, true);
+    lv_obj_invalidate(scr);
+    frame_act = frame;
+    lv_refr_now(disp);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, graph_seen);
+    graph_seen = 0;
+
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    /*Deleted with the last draw task of the layer*/
+    TEST_ASSERT_NULL(disp->layer_head->draw_task_head);
+    TEST_ASSERT_NULL(disp->layer_head->draw_task_tail);
+    TEST_ASSERT_NULL(disp->layer_head->task_graph);
+}
+
+static void random_objects_create(uint32_t cnt)
+{
+    lv_rand_set_seed(1234);
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        lv_obj_t * obj = lv_obj_create(scr);
+        lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_pos(obj, lv_rand(0, HOR_RES - 10) - 10, lv_rand(0, VER_RES - 10) - 10);
+        lv_obj_set_size(obj, lv_rand(10, 120), lv_rand(10, 90));
+        lv_obj_set_style_bg_color(obj, lv_color_hex(lv_rand(0, 0xffffff)), 0);
+        lv_obj_set_style_bg_opa(obj, lv_rand(0, 3) ? LV_OPA_COVER : LV_OPA_60, 0);
+        lv_obj_set_style_radius(obj, lv_rand(0, 20), 0);
+        lv_obj_set_style_border_width(obj, lv_rand(0, 4), 0);
+        lv_obj_set_style_shadow_width(obj, lv_rand(0, 3) == 0 ? 10 : 0, 0);
+        lv_obj_set_style_pad_all(obj, 2, 0);
+
+        if(lv_rand(0, 1)) {
+            lv_obj_t * label = lv_label_create(obj);
+            lv_label_set_text(label, "Lorem ipsum dolor sit amet");
+        }
+    }
+}
+
+void test_task_graph_random(void)
+{
+    random_objects_create(60);
+    render_both();
+}
+
+void test_task_graph_layers(void)
+{
+    /*Layers wait for their draw tasks, and the tasks on top of them wait for the layers*/
+    random_objects_create(20);
+
+    lv_obj_t * semi = lv_obj_create(scr);
+    lv_obj_set_pos(semi, 30, 20);
+    lv_obj_set_size(semi, 120, 100);
+    lv_obj_set_style_opa(semi, LV_OPA_50, 0);
+    lv_obj_t * label = lv_label_create(semi);
+    lv_label_set_text(label, "In a layer");
+
+    lv_obj_t * rotated = lv_obj_create(scr);
+    lv_obj_set_pos(rotated, 120, 40);
+    lv_obj_set_size(rotated, 80, 60);
+    lv_obj_set_style_transform_rotation(rotated, 300, 0);
+
+    lv_obj_t * top = lv_obj_create(scr);
+    lv_obj_set_pos(top, 60, 60);
+    lv_obj_set_size(top, 120, 60);
+
+    render_both();
+}
+
+void test_task_graph_many_tasks(void)
+{
+    /*Hundreds of overlapping draw tasks in the same bins*/
+    uint32_t i;
+    for(i = 0; i < 400; i++) {
+        lv_obj_t * obj = lv_obj_create(scr);
+        lv_obj_remove_style_all(obj);
+        lv_obj_set_pos(obj, (i * 7) % (HOR_RES - 20), (i * 13) % (VER_RES - 20));
+        lv_obj_set_size(obj, 20 + i % 30, 20 + i % 17);
+        lv_obj_set_style_bg_opa(obj, LV_OPA_50, 0);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(i * 0x10101), 0);
+    }
+
+    render_both();
+}
+
+void test_task_graph_occlusion_culling(void)
+{
+    /*The culled draw tasks are finished without being drawn*/
+    lv_display_set_occlusion_culling(disp, true);
+    random_objects_create(60);
+    render_both();
+}
+
+#endif
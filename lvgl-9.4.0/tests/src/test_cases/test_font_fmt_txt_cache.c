@@ -0,0 +1,212 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     320
+#define VER_RES     120
+#define BUF_SIZE    (HOR_RES * VER_RES * 2)
+
+/*Glyph rows are aligned to 64 bytes in the tests: every glyph on the screen fits*/
+#define CACHE_SIZE  (256 * 1024)
+
+LV_FONT_DECLARE(test_font_montserrat_ascii_1bpp)
+LV_FONT_DECLARE(test_font_montserrat_ascii_2bpp)
+LV_FONT_DECLARE(test_font_montserrat_ascii_4bpp)
+LV_FONT_DECLARE(test_font_montserrat_ascii_8bpp)
+LV_FONT_DECLARE(test_font_montserrat_ascii_3bpp_compressed)
+
+#define glyph_cache_p (LV_GLOBAL_DEFAULT()->font_fmt_txt_cache)
+
+static const char * txt = "The quick brown fox jumps over the lazy dog 0123456789 !?";
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t frame_ref[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint8_t * frame_act;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    lv_memcpy(frame_act, px_map, BUF_SIZE);
+    lv_display_flush_ready(d);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    scr = lv_display_get_screen_active(disp);
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+    lv_font_fmt_txt_cache_resize(LV_FONT_FMT_TXT_CACHE_DEF_SIZE, true);
+    lv_font_fmt_txt_cache_drop(NULL);
+}
+
+static void labels_create(void)
+{
+    const lv_font_t * fonts[] = {
+        &test_font_montserrat_ascii_1bpp,
+        &test_font_montserrat_ascii_2bpp,
+        &test_font_montserrat_ascii_4bpp,
+        &test_font_montserrat_ascii_3bpp_compressed,
+        &lv_font_montserrat_14,
+    };
+
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_COLUMN);
+    uint32_t i;
+    for(i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++) {
+        lv_obj_t * label = lv_label_create(scr);
+        lv_obj_set_style_text_font(label, fonts[i], 0);
+        lv_label_set_text_static(label, txt);
+    }
+    /*Rotated glyphs are drawn as images from the same bitmaps*/
+    lv_obj_t * label = lv_label_create(scr);
+    lv_obj_set_style_text_font(label, &test_font_montserrat_ascii_3bpp_compressed, 0);
+    lv_obj_set_style_transform_rotation(label, 900, 0);
+    lv_obj_add_flag(label, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    lv_obj_set_pos(label, 300, 0);
+    lv_label_set_text_static(label, "Rotated");
+}
+
+static void render(uint8_t * buf)
+{
+    frame_act = buf;
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+}
+
+static uint32_t cached_glyph_cnt(const lv_font_t * font)
+{
+    uint32_t cnt = 0;
+    lv_font_fmt_txt_cache_data_t * elem = lv_malloc(lv_cache_entry_get_size(sizeof(lv_font_fmt_txt_cache_data_t)));
+    lv_iter_t * iter = lv_cache_iter_create(glyph_cache_p);
+    while(lv_iter_next(iter, elem) == LV_RESULT_OK) {
+        if(font == NULL || elem->font == font) cnt++;
+    }
+    lv_iter_destroy(iter);
+    lv_free(elem);
+    return cnt;
+}
+
+void test_font_fmt_txt_cache_same_pixels(void)
+{
+    labels_create();
+
+    lv_font_fmt_txt_cache_resize(0, true);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL(0, lv_cache_get_size(glyph_cache_p, NULL));
+
+    /*Filled from the first frame, drawn from the cache in the second one*/
+    lv_font_fmt_txt_cache_resize(CACHE_SIZE, false);
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    TEST_ASSERT_GREATER_THAN(0, cached_glyph_cnt(&test_font_montserrat_ascii_3bpp_compressed));
+    TEST_ASSERT_GREATER_THAN(0, cached_glyph_cnt(&test_font_montserrat_ascii_1bpp));
+
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_font_fmt_txt_cache_skips_8bpp(void)
+{
+    lv_obj_t * label = lv_label_create(scr);
+    lv_obj_set_style_text_font(label, &test_font_montserrat_ascii_8bpp, 0);
+    lv_label_set_text_static(label, txt);
+
+    lv_font_fmt_txt_cache_resize(CACHE_SIZE, false);
+    render(frame);
+    TEST_ASSERT_EQUAL(0, cached_glyph_cnt(&test_font_montserrat_ascii_8bpp));
+}
+
+void test_font_fmt_txt_cache_budget(void)
+{
+    labels_create();
+
+    lv_font_fmt_txt_cache_resize(0, true);
+    render(frame_ref);
+
+    /*Much less than the glyphs on the screen: they are evicted while drawing*/
+    lv_font_fmt_txt_cache_resize(2 * 1024, false);
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    TEST_ASSERT_LESS_OR_EQUAL(2 * 1024, lv_cache_get_size(glyph_cache_p, NULL));
+    TEST_ASSERT_GREATER_THAN(0, lv_cache_get_size(glyph_cache_p, NULL));
+
+    /*Nothing is left acquired after drawing*/
+    lv_font_fmt_txt_cache_resize(0, true);
+    TEST_ASSERT_EQUAL(0, lv_cache_get_size(glyph_cache_p, NULL));
+
+    lv_font_fmt_txt_cache_resize(CACHE_SIZE, false);
+    render(frame);
+    size_t size = lv_cache_get_size(glyph_cache_p, NULL);
+    lv_font_fmt_txt_cache_resize(size / 2, true);
+    TEST_ASSERT_LESS_OR_EQUAL(size / 2, lv_cache_get_size(glyph_cache_p, NULL));
+}
+
+void test_font_fmt_txt_cache_drop(void)
+{
+    labels_create();
+
+    lv_font_fmt_txt_cache_resize(CACHE_SIZE, false);
+    render(frame);
+    uint32_t cnt = cached_glyph_cnt(NULL);
+    uint32_t cnt_compressed = cached_glyph_cnt(&test_font_montserrat_ascii_3bpp_compressed);
+    TEST_ASSERT_GREATER_THAN(0, cnt_compressed);
+
+    lv_font_fmt_txt_cache_drop(&test_font_montserrat_ascii_3bpp_compressed);
+    TEST_ASSERT_EQUAL(0, cached_glyph_cnt(&test_font_montserrat_ascii_3bpp_compressed));
+    TEST_ASSERT_EQUAL(cnt - cnt_compressed, cached_glyph_cnt(NULL));
+
+    lv_font_fmt_txt_cache_drop(NULL);
+    TEST_ASSERT_EQUAL(0, cached_glyph_cnt(NULL));
+    TEST_ASSERT_EQUAL(0, lv_cache_get_size(glyph_cache_p, NULL));
+}
+
+void test_font_fmt_txt_cache_glyph_bitmap(void)
+{
+    lv_font_fmt_txt_cache_resize(CACHE_SIZE, false);
+
+    const lv_font_t * font = &test_font_montserrat_ascii_3bpp_compressed;
+    lv_font_glyph_dsc_t g;
+    lv_memzero(&g, sizeof(g));
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(font, &g, 'A', '\0'));
+
+    lv_draw_buf_t * draw_buf = lv_draw_buf_create(g.box_w, g.box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+    const lv_draw_buf_t * bitmap = lv_font_get_glyph_bitmap(&g, draw_buf);
+    TEST_ASSERT_NOT_NULL(g.entry);
+    TEST_ASSERT_NOT_EQUAL(draw_buf, bitmap);
+    TEST_ASSERT_EQUAL(LV_COLOR_FORMAT_A8, bitmap->header.cf);
+    TEST_ASSERT_EQUAL(g.box_w, bitmap->header.w);
+    TEST_ASSERT_EQUAL(g.box_h, bitmap->header.h);
+    TEST_ASSERT_EQUAL(1, lv_cache_entry_get_ref(g.entry));
+
+    lv_cache_entry_t * entry = g.entry;
+    lv_font_glyph_release_draw_data(&g);
+    TEST_ASSERT_NULL(g.entry);
+    TEST_ASSERT_EQUAL(0, lv_cache_entry_get_ref(entry));
+
+    /*The same bitmap as expanded without the cache*/
+    lv_font_fmt_txt_cache_resize(0, true);
+    const lv_draw_buf_t * expanded = lv_font_get_glyph_bitmap(&g, draw_buf);
+    TEST_ASSERT_NULL(g.entry);
+    TEST_ASSERT_EQUAL_PTR(draw_buf, expanded);
+
+    lv_font_fmt_txt_cache_resize(CACHE_SIZE, false);
+    bitmap = lv_font_get_glyph_bitmap(&g, NULL);
+    TEST_ASSERT_EQUAL_MEMORY(expanded->data, bitmap->data, bitmap->header.stride * g.box_h);
+    lv_font_glyph_release_draw_data(&g);
+
+    lv_draw_buf_destroy(draw_buf);
+}
+
+#endif
@@ -0,0 +1,261 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define LETTER_MAX      0x10FFFF
+#define KERN_LETTER_MAX 160         /**< Compare the kerning of all pairs of this many letters*/
+
+extern lv_font_t test_font_1;
+extern lv_font_t test_font_3;
+
+#define lookup_state_p (&(LV_GLOBAL_DEFAULT()->font_fmt_txt_lookup))
+
+typedef struct {
+    uint32_t letter;
+    lv_font_glyph_dsc_t dsc;
+} ref_glyph_t;
+
+static ref_glyph_t * ref_glyphs;
+static uint32_t ref_glyph_cnt;
+static int32_t ref_kern[KERN_LETTER_MAX][KERN_LETTER_MAX];
+
+/*Kern pairs over the glyphs of test_font_1, sorted by the left then the right glyph*/
+static uint8_t pair_ids_8[2 * 40 * 12];
+static uint16_t pair_ids_16[2 * 40 * 12];
+static int8_t pair_values[40 * 12];
+static lv_font_fmt_txt_kern_pair_t kern_pairs;
+static lv_font_fmt_txt_dsc_t pair_font_dsc;
+static lv_font_t pair_font;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_font_fmt_txt_lookup_set_max_size(LV_FONT_FMT_TXT_LOOKUP_DEF_SIZE);
+    lv_free(ref_glyphs);
+    ref_glyphs = NULL;
+}
+
+static bool glyph_dsc_get(const lv_font_t * font, lv_font_glyph_dsc_t * dsc, uint32_t letter, uint32_t letter_next)
+{
+    lv_memzero(dsc, sizeof(*dsc));
+    return font->get_glyph_dsc(font, dsc, letter, letter_next);
+}
+
+/*Collect every glyph and kerning value without the lookup tables*/
+static void ref_create(const lv_font_t * font)
+{
+    lv_font_fmt_txt_lookup_set_max_size(0);
+
+    uint32_t cap = 256;
+    lv_free(ref_glyphs);
+    ref_glyphs = lv_malloc(cap * sizeof(ref_glyph_t));
+    ref_glyph_cnt = 0;
+    lv_font_glyph_dsc_t dsc;
+    uint32_t letter;
+    for(letter = 0; letter <= LETTER_MAX; letter++) {
+        if(!glyph_dsc_get(font, &dsc, letter, 0)) continue;
+        if(ref_glyph_cnt == cap) {
+            cap *= 2;
+            ref_glyphs = lv_realloc(ref_glyphs, cap * sizeof(ref_glyph_t));
+        }
+        ref_glyphs[ref_glyph_cnt].letter = letter;
+        ref_glyphs[ref_glyph_cnt].dsc = dsc;
+        ref_glyph_cnt++;
+    }
+
+    uint32_t kern_cnt = LV_MIN(ref_glyph_cnt, KERN_LETTER_MAX);
+    uint32_t i, j;
+    for(i = 0; i < kern_cnt; i++) {
+        for(j = 0; j < kern_cnt; j++) {
+            glyph_dsc_get(font, &dsc, ref_glyphs[i].letter, ref_glyphs[j].letter);
+            ref_kern[i][j] = dsc.adv_w;
+        }
+    }
+}
+
+/*Compare every glyph and kerning value with the lookup tables to the reference*/
+static void ref_compare(const lv_font_t * font, uint32_t max_size)
+{
+    lv_font_fmt_txt_lookup_set_max_size(max_size);
+
+    lv_font_glyph_dsc_t dsc;
+    uint32_t letter;
+    uint32_t i = 0;
+    for(letter = 0; letter <= LETTER_MAX; letter++) {
+        bool found = glyph_dsc_get(font, &dsc, letter, 0);
+        bool found_ref = i < ref_glyph_cnt && ref_glyphs[i].letter == letter;
+        if(found != found_ref) {
+            TEST_PRINTF("U+%04" LV_PRIX32 " found: %d, expected: %d", letter, found, found_ref);
+            TEST_FAIL();
+        }
+        if(found) {
+            TEST_ASSERT_EQUAL_MEMORY(&ref_glyphs[i].dsc, &dsc, sizeof(dsc));
+            i++;
+        }
+    }
+
+    uint32_t kern_cnt = LV_MIN(ref_glyph_cnt, KERN_LETTER_MAX);
+    uint32_t j;
+    for(i = 0; i < kern_cnt; i++) {
+        for(j = 0; j < kern_cnt; j++) {
+            glyph_dsc_get(font, &dsc, ref_glyphs[i].letter, ref_glyphs[j].letter);
+            TEST_ASSERT_EQUAL_INT32(ref_kern[i][j], dsc.adv_w);
+        }
+    }
+}
+
+static const lv_font_fmt_txt_lookup_t * lookup_find(const lv_font_t * font)
+{
+    uint32_t b;
+    for(b = 0; b < LV_FONT_FMT_TXT_LOOKUP_BUCKET_CNT; b++) {
+        const lv_font_fmt_txt_lookup_t * lookup;
+        for(lookup = lookup_state_p->buckets[b]; lookup; lookup = lookup->bucket_next) {
+            if(lookup->fdsc == font->dsc) return lookup;
+        }
+    }
+    return NULL;
+}
+
+static void sweep(const lv_font_t * font)
+{
+    ref_create(font);
+    TEST_ASSERT_GREATER_THAN(0, ref_glyph_cnt);
+
+    /*All tables*/
+    ref_compare(font, 1024 * 1024);
+    const lv_font_fmt_txt_lookup_t * lookup = lookup_find(font);
+    TEST_ASSERT_NOT_NULL(lookup);
+    TEST_ASSERT_NOT_NULL(lookup->latin1);
+    TEST_ASSERT_NOT_NULL(lookup->hash_keys);
+    uint32_t size = lookup->size;
+
+    /*Without the hash table and the kerning matrix*/
+    uint32_t latin1_size = sizeof(lv_font_fmt_txt_lookup_t) +
+                           lookup->latin1_cnt * sizeof(lv_font_fmt_txt_lookup_entry_t);
+    ref_compare(font, latin1_size);
+    lookup = lookup_find(font);
+    TEST_ASSERT_NOT_NULL(lookup->latin1);
+    TEST_ASSERT_NULL(lookup->hash_keys);
+    TEST_ASSERT_LESS_OR_EQUAL(latin1_size, lookup->size);
+
+    /*Without tables*/
+    ref_compare(font, latin1_size - 1);
+    lookup = lookup_find(font);
+    TEST_ASSERT_NULL(lookup->latin1);
+    TEST_ASSERT_EQUAL(sizeof(lv_font_fmt_txt_lookup_t), lookup->size);
+
+    /*Dropped with the font*/
+    lv_font_fmt_txt_lookup_set_max_size(size);
+    glyph_dsc_get(font, &(lv_font_glyph_dsc_t) {
+        0
+    }, 'A', 0);
+    TEST_ASSERT_EQUAL(size, lookup_find(font)->size);
+    lv_font_fmt_txt_cache_drop(font);
+    TEST_ASSERT_NULL(lookup_find(font));
+}
+
+static void pair_font_init(uint32_t glyph_ids_size)
+{
+    /*Every 3rd glyph kerned with every 5th one, also glyphs with and without a character*/
+    const lv_font_fmt_txt_dsc_t * fdsc = test_font_1.dsc;
+    uint32_t cnt = 0;
+    uint32_t l, r;
+    for(l = 1; l <= 40 * 3; l += 3) {
+        for(r = 1; r <= 12 * 5; r += 5) {
+            pair_ids_8[cnt * 2] = (uint8_t)l;
+            pair_ids_8[cnt * 2 + 1] = (uint8_t)r;
+            pair_ids_16[cnt * 2] = (uint16_t)l;
+            pair_ids_16[cnt * 2 + 1] = (uint16_t)r;
+            pair_values[cnt] = (int8_t)((l * 7 + r * 13) % 41 - 20);
+            cnt++;
+        }
+    }
+
+    kern_pairs.glyph_ids = glyph_ids_size == 0 ? (const void *)pair_ids_8 : (const void *)pair_ids_16;
+    kern_pairs.values = pair_values;
+    kern_pairs.pair_cnt = cnt;
+    kern_pairs.glyph_ids_size = glyph_ids_size;
+
+    pair_font_dsc = *fdsc;
+    pair_font_dsc.kern_dsc = &kern_pairs;
+    pair_font_dsc.kern_classes = 0;
+    pair_font_dsc.kern_scale = 16 * 16;    /*A kern value is a pixel: a wrong one is visible*/
+    pair_font = test_font_1;
+    pair_font.dsc = &pair_font_dsc;
+}
+
+void test_font_fmt_txt_lookup_kern_classes(void)
+{
+    sweep(&test_font_1);
+    sweep(&lv_font_montserrat_14);
+}
+
+void test_font_fmt_txt_lookup_no_kerning(void)
+{
+    sweep(&test_font_3);
+    sweep(&lv_font_unscii_8);
+}
+
+void test_font_fmt_txt_lookup_kern_pairs(void)
+{
+    pair_font_init(0);
+    sweep(&pair_font);
+
+    /*The pairs are kept in a dense matrix*/
+    lv_font_fmt_txt_lookup_set_max_size(1024 * 1024);
+    glyph_dsc_get(&pair_font, &(lv_font_glyph_dsc_t) {
+        0
+    }, 'A', 'V');
+    TEST_ASSERT_NOT_NULL(lookup_find(&pair_font)->kern_values);
+    TEST_ASSERT_EQUAL(12, lookup_find(&pair_font)->kern_right_cnt);
+
+    lv_font_fmt_txt_cache_drop(&pair_font);
+    pair_font_init(1);
+    sweep(&pair_font);
+}
+
+void test_font_fmt_txt_lookup_many_cmaps(void)
+{
+    /*Overlapping ranges, sparse and full formats*/
+    sweep(&lv_font_dejavu_16_persian_hebrew);
+    sweep(&lv_font_source_han_sans_sc_14_cjk);
+}
+
+void test_font_fmt_txt_lookup_shared_dsc(void)
+{
+    /*Fonts with the same descriptor (e.g. with another fallback) use the same tables*/
+    lv_font_t font_copy = lv_font_montserrat_14;
+    font_copy.fallback = &test_font_1;
+
+    lv_font_fmt_txt_lookup_set_max_size(64 * 1024);
+    lv_font_glyph_dsc_t dsc;
+    TEST_ASSERT_TRUE(glyph_dsc_get(&lv_font_montserrat_14, &dsc, 'A', 0));
+    const lv_font_fmt_txt_lookup_t * lookup = lookup_find(&lv_font_montserrat_14);
+    TEST_ASSERT_TRUE(glyph_dsc_get(&font_copy, &dsc, 'A', 0));
+    TEST_ASSERT_EQUAL_PTR(lookup, lookup_find(&font_copy));
+
+    lv_font_fmt_txt_cache_drop(NULL);
+    TEST_ASSERT_NULL(lookup_find(&lv_font_montserrat_14));
+}
+
+void test_font_fmt_txt_lookup_text_size(void)
+{
+    /*Same layout with the lookup tables*/
+    const char * txt = "The quick brown fox jumps over the lazy dog. AVAWATAY To Ty Yo 0123456789 \xC2\xB0";
+
+    lv_font_fmt_txt_lookup_set_max_size(0);
+    lv_point_t size_ref;
+    lv_text_get_size(&size_ref, txt, &test_font_1, 0, 0, 300, LV_TEXT_FLAG_NONE);
+
+    lv_font_fmt_txt_lookup_set_max_size(64 * 1024);
+    lv_point_t size;
+    lv_text_get_size(&size, txt, &test_font_1, 0, 0, 300, LV_TEXT_FLAG_NONE);
+    TEST_ASSERT_EQUAL_INT32(size_ref.x, size.x);
+    TEST_ASSERT_EQUAL_INT32(size_ref.y, size.y);
+}
+
+#endif
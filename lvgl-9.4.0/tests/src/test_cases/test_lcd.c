@@ -221,6 +221,231 @@ void test_lcd_ili9341(void)
                           lv_ili9341_send_cmd_list);
 }
 
+/* Frame captured from the pixel transfers, placed according to the last CASET/RASET window */
+static uint8_t capture_frame[TEST_LCD_WIDTH * TEST_LCD_HEIGHT * 2];
+static uint32_t capture_rows;
+static int32_t capture_x1;
+static int32_t capture_y1;
+static int32_t capture_x2;
+
+static void capture_send_cmd_cb(lv_display_t * disp, const uint8_t * cmd, size_t cmd_size, const uint8_t * param,
+                                size_t param_size)
+{
+    LV_UNUSED(disp);
+    LV_UNUSED(cmd_size);
+
+    if(param_size != 4) return;
+    int32_t start = (param[0] << 8) | param[1];
+    int32_t end = (param[2] << 8) | param[3];
+    if(cmd[0] == LV_LCD_CMD_SET_COLUMN_ADDRESS) {
+        capture_x1 = start;
+        capture_x2 = end;
+    }
+    else if(cmd[0] == LV_LCD_CMD_SET_PAGE_ADDRESS) {
+        capture_y1 = start;
+    }
+}
+
+static void capture_send_color_cb(lv_display_t * disp, const uint8_t * cmd, size_t cmd_size, uint8_t * param,
+                                  size_t param_size)
+{
+    LV_UNUSED(cmd_size);
+    TEST_ASSERT_EQUAL_UINT8(LV_LCD_CMD_WRITE_MEMORY_START, cmd[0]);
+
+    size_t line_size = (capture_x2 - capture_x1 + 1) * 2;
+    size_t lines = param_size / line_size;
+    for(size_t y = 0; y < lines; y++) {
+        lv_memcpy(&capture_frame[((capture_y1 + y) * TEST_LCD_WIDTH + capture_x1) * 2], &param[y * line_size], line_size);
+    }
+    capture_rows += lines;
+
+    lv_display_flush_ready(disp);
+}
+
+static uint32_t capture_transfer_cnt;
+
+static void capture_send_transfer_cb(lv_display_t * disp, const lv_lcd_transfer_t * xfer)
+{
+    static const lv_lcd_dc_t dc_ref[] = {
+        LV_LCD_DC_COMMAND, LV_LCD_DC_DATA, LV_LCD_DC_COMMAND, LV_LCD_DC_DATA, LV_LCD_DC_COMMAND, LV_LCD_DC_DATA
+    };
+
+    /* Transports may queue a copy of the descriptor */
+    lv_lcd_transfer_t copy = *xfer;
+    TEST_ASSERT_EQUAL_UINT32(6, copy.seg_cnt);
+    for(uint32_t i = 0; i < copy.seg_cnt; i++) {
+        TEST_ASSERT_EQUAL(dc_ref[i], copy.seg[i].dc);
+    }
+
+    const uint8_t * caset = lv_lcd_transfer_seg_get_data(&copy.seg[1]);
+    const uint8_t * raset = lv_lcd_transfer_seg_get_data(&copy.seg[3]);
+    TEST_ASSERT_EQUAL_UINT8(LV_LCD_CMD_SET_COLUMN_ADDRESS, *lv_lcd_transfer_seg_get_data(&copy.seg[0]));
+    TEST_ASSERT_EQUAL_UINT8(LV_LCD_CMD_SET_PAGE_ADDRESS, *lv_lcd_transfer_seg_get_data(&copy.seg[2]));
+    TEST_ASSERT_EQUAL_UINT32(4, copy.seg[1].size);
+    TEST_ASSERT_EQUAL_UINT32(4, copy.seg[3].size);
+    TEST_ASSERT_NOT_EQUAL(caset, xfer->seg[1].inline_data);
+
+    /* The pixels are referenced, not copied */
+    TEST_ASSERT_NOT_NULL(copy.seg[5].data);
+
+    capture_send_cmd_cb(disp, lv_lcd_transfer_seg_get_data(&copy.seg[0]), 1, caset, 4);
+    capture_send_cmd_cb(disp, lv_lcd_transfer_seg_get_data(&copy.seg[2]), 1, raset, 4);
+    capture_send_color_cb(disp, lv_lcd_transfer_seg_get_data(&copy.seg[4]), 1, copy.seg[5].data, copy.seg[5].size);
+    capture_transfer_cnt++;
+}
+
+static lv_draw_buf_t * scene_buf1;
+static lv_draw_buf_t * scene_buf2;
+static lv_obj_t * scene_label;
+static const char * scene_text = "Ab";
+
+static lv_display_t * create_rgb565_scene(lv_color_format_t cf, bool batched)
+{
+    lv_display_t * disp = lv_st7796_create(TEST_LCD_WIDTH, TEST_LCD_HEIGHT, LV_LCD_FLAG_NONE, capture_send_cmd_cb,
+                                           capture_send_color_cb);
+    lv_display_set_color_format(disp, cf);
+    if(batched) lv_lcd_generic_mipi_set_send_transfer_cb(disp, capture_send_transfer_cb);
+
+    /* Use small strips to cover several flushes and their windows */
+    scene_buf1 = lv_draw_buf_create(TEST_LCD_WIDTH, 10, cf, TEST_LCD_WIDTH * 2);
+    scene_buf2 = lv_draw_buf_create(TEST_LCD_WIDTH, 10, cf, TEST_LCD_WIDTH * 2);
+    lv_display_set_draw_buffers(disp, scene_buf1, scene_buf2);
+
+    /* The monitors would cover most of this small screen */
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_hide_performance(disp);
+#endif
+#if LV_USE_MEM_MONITOR
+    lv_sysmon_hide_memory(disp);
+#endif
+
+    lv_obj_t * scr = lv_display_get_screen_active(disp);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x1234ab), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_color_hex(0xfedc21), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_HOR, 0);
+
+    lv_obj_t * obj = lv_obj_create(scr);
+    lv_obj_set_size(obj, 40, 20);
+    lv_obj_center(obj);
+    lv_obj_set_style_radius(obj, 8, 0);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_60, 0);
+
+    scene_label = lv_label_create(scr);
+    lv_label_set_text(scene_label, scene_text);
+    lv_obj_align(scene_label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+
+    return disp;
+}
+
+static void delete_rgb565_scene(lv_display_t * disp)
+{
+    lv_display_delete(disp);
+    lv_draw_buf_destroy(scene_buf1);
+    lv_draw_buf_destroy(scene_buf2);
+}
+
+static void render_rgb565_scene(lv_color_format_t cf, bool batched)
+{
+    lv_display_t * disp = create_rgb565_scene(cf, batched);
+
+    lv_memzero(capture_frame, sizeof(capture_frame));
+    lv_refr_now(disp);
+
+    delete_rgb565_scene(disp);
+}
+
+void test_lcd_st7796_rgb565_swapped(void)
+{
+    static uint8_t ref_frame[sizeof(capture_frame)];
+
+    /* Reference: render native RGB565 and swap it on the CPU, as a send_color callback would */
+    render_rgb565_scene(LV_COLOR_FORMAT_RGB565, false);
+    lv_memcpy(ref_frame, capture_frame, sizeof(ref_frame));
+    lv_draw_sw_rgb565_swap(ref_frame, TEST_LCD_WIDTH * TEST_LCD_HEIGHT);
+
+    /* Rendering straight into the swapped format has to produce the same bytes on the bus */
+    render_rgb565_scene(LV_COLOR_FORMAT_RGB565_SWAPPED, false);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref_frame, capture_frame, sizeof(ref_frame));
+
+    /* The top left pixel is the plain background color, sent in big-endian order */
+    uint16_t c16 = lv_color_to_u16(lv_color_hex(0x1234ab));
+    TEST_ASSERT_EQUAL_UINT8(c16 >> 8, capture_frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(c16 & 0xff, capture_frame[1]);
+}
+
+void test_lcd_st7796_batched_transfer(void)
+{
+    static uint8_t ref_frame[sizeof(capture_frame)];
+
+    render_rgb565_scene(LV_COLOR_FORMAT_RGB565_SWAPPED, false);
+    lv_memcpy(ref_frame, capture_frame, sizeof(ref_frame));
+
+    /* The same windows and pixels, described as one sequence per strip */
+    capture_transfer_cnt = 0;
+    render_rgb565_scene(LV_COLOR_FORMAT_RGB565_SWAPPED, true);
+    TEST_ASSERT_EQUAL_UINT32((TEST_LCD_HEIGHT + 9) / 10, capture_transfer_cnt);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref_frame, capture_frame, sizeof(ref_frame));
+}
+
+void test_lcd_st7796_row_hash(void)
+{
+    static uint8_t ref_frame[sizeof(capture_frame)];
+    const uint32_t strip_cnt = (TEST_LCD_HEIGHT + 9) / 10;
+
+    render_rgb565_scene(LV_COLOR_FORMAT_RGB565_SWAPPED, false);
+    lv_memcpy(ref_frame, capture_frame, sizeof(ref_frame));
+
+    lv_display_t * disp = create_rgb565_scene(LV_COLOR_FORMAT_RGB565_SWAPPED, true);
+    lv_obj_t * scr = lv_display_get_screen_active(disp);
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_lcd_generic_mipi_set_row_hash(disp, 16));
+
+    /* Nothing is known yet: every row goes out */
+    lv_memzero(capture_frame, sizeof(capture_frame));
+    capture_rows = 0;
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(TEST_LCD_HEIGHT, capture_rows);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref_frame, capture_frame, sizeof(ref_frame));
+
+    /* Redrawing the same pixels: a single row per strip to complete the flush */
+    capture_rows = 0;
+    capture_transfer_cnt = 0;
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(strip_cnt, capture_transfer_cnt);
+    TEST_ASSERT_EQUAL_UINT32(strip_cnt, capture_rows);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref_frame, capture_frame, sizeof(ref_frame));
+
+    /* A new text in the bottom right corner: only its rows, but the whole frame has to be right */
+    lv_label_set_text(scene_label, "Xy");
+    capture_rows = 0;
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, capture_rows);
+    TEST_ASSERT_LESS_THAN_UINT32(lv_obj_get_height(scene_label) + strip_cnt, capture_rows);
+    lv_memcpy(ref_frame, capture_frame, sizeof(ref_frame));
+
+    lv_lcd_row_hash_stats_t stats;
+    lv_lcd_generic_mipi_get_row_hash_stats(disp, &stats);
+    TEST_ASSERT_EQUAL_UINT32(3 * strip_cnt, stats.flush_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(strip_cnt + 1, stats.unchanged_cnt);
+    TEST_ASSERT_EQUAL_UINT64(3 * TEST_LCD_WIDTH * TEST_LCD_HEIGHT * 2, stats.bytes_sent + stats.bytes_saved);
+
+    /* After a reset everything is sent again */
+    lv_lcd_generic_mipi_reset_row_hash(disp);
+    capture_rows = 0;
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(TEST_LCD_HEIGHT, capture_rows);
+
+    delete_rgb565_scene(disp);
+
+    scene_text = "Xy";
+    render_rgb565_scene(LV_COLOR_FORMAT_RGB565_SWAPPED, false);
+    scene_text = "Ab";
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(capture_frame, ref_frame, sizeof(ref_frame));
+}
+
 static uint32_t lv_ft81x_encode_read_address(uint32_t address)
 {
     return lv_swap_bytes_32(address << 8);
@@ -0,0 +1,282 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     256
+#define VER_RES     160
+#define BUF_SIZE    (HOR_RES * VER_RES * 2)
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t frame_ref[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint8_t * frame_act;
+static uint32_t draw_cnt;
+
+static lv_obj_t * btn;
+static lv_obj_t * btn_label;
+static lv_obj_t * value_label;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    lv_memcpy(frame_act, px_map, BUF_SIZE);
+    lv_display_flush_ready(d);
+}
+
+static void draw_main_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+    draw_cnt++;
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    scr = lv_display_get_screen_active(disp);
+    draw_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+    lv_obj_draw_list_resize(LV_OBJ_DRAW_LIST_DEF_SIZE);
+    lv_obj_draw_list_reset_stats();
+}
+
+static bool has_list(const lv_obj_t * obj)
+{
+    const lv_obj_draw_list_t * list = LV_GLOBAL_DEFAULT()->obj_draw_list.lru_head;
+    while(list) {
+        if(list->obj == obj) return true;
+        list = list->lru_next;
+    }
+    return false;
+}
+
+static void widgets_create(void)
+{
+    btn = lv_button_create(scr);
+    lv_obj_set_pos(btn, 10, 10);
+    btn_label = lv_label_create(btn);
+    lv_label_set_text(btn_label, "Button");
+
+    value_label = lv_label_create(scr);
+    lv_obj_set_pos(value_label, 120, 20);
+    lv_label_set_text(value_label, "12.5 V");
+
+    /*Its labels are drawn from a local buffer*/
+    lv_obj_t * scale = lv_scale_create(scr);
+    lv_obj_set_pos(scale, 10, 60);
+    lv_obj_set_size(scale, 200, 40);
+    lv_scale_set_mode(scale, LV_SCALE_MODE_HORIZONTAL_BOTTOM);
+    lv_scale_set_label_show(scale, true);
+    lv_scale_set_total_tick_count(scale, 21);
+    lv_scale_set_major_tick_every(scale, 5);
+
+    /*Drawn in a layer*/
+    lv_obj_t * semi = lv_obj_create(scr);
+    lv_obj_set_pos(semi, 180, 10);
+    lv_obj_set_size(semi, 70, 40);
+    lv_obj_set_style_opa(semi, LV_OPA_50, 0);
+
+    lv_obj_t * arc = lv_arc_create(scr);
+    lv_obj_set_pos(arc, 180, 100);
+    lv_obj_set_size(arc, 60, 60);
+}
+
+/**
+ * Render the whole screen
+ * @param dest      the flushed pixels are stored here
+ */
+static void render(uint8_t * dest)
+{
+    lv_obj_invalidate(scr);
+    frame_act = dest;
+    lv_refr_now(disp);
+}
+
+/**
+ * Render the screen without draw lists into `frame_ref` and with draw lists into `frame`.
+ * The widgets are recorded when they are drawn unchanged for the second time.
+ */
+static void render_both(void)
+{
+    lv_obj_draw_list_resize(0);
+    render(frame_ref);
+    lv_obj_draw_list_resize(16 * 1024);
+    render(frame);
+    render(frame);
+}
+
+void test_obj_draw_list_disabled_by_default(void)
+{
+    lv_obj_draw_list_stats_t stats;
+    widgets_create();
+    render(frame_ref);
+    render(frame_ref);
+
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.size);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.record_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.replay_cnt);
+}
+
+void test_obj_draw_list_record_second_draw(void)
+{
+    lv_obj_draw_list_stats_t stats;
+    widgets_create();
+    lv_obj_draw_list_resize(16 * 1024);
+    render(frame);
+
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.record_cnt);
+    TEST_ASSERT_FALSE(has_list(btn));
+
+    render(frame);
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.record_cnt);
+    TEST_ASSERT_TRUE(has_list(btn));
+}
+
+void test_obj_draw_list_replay(void)
+{
+    lv_obj_draw_list_stats_t stats;
+    widgets_create();
+    render_both();
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    lv_obj_draw_list_reset_stats();
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.replay_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.replay_task_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.list_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(16 * 1024, stats.used);
+
+    /*The invalidated screen is not recorded again*/
+    TEST_ASSERT_EQUAL_UINT32(0, stats.record_cnt);
+}
+
+void test_obj_draw_list_changed_widget(void)
+{
+    lv_obj_draw_list_stats_t stats;
+    widgets_create();
+    lv_obj_draw_list_resize(16 * 1024);
+    render(frame);
+
+    lv_obj_draw_list_reset_stats();
+    lv_label_set_text(value_label, "13.0 V");
+    render(frame);
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(2, stats.record_cnt);
+
+    lv_obj_draw_list_resize(0);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_obj_draw_list_inherited_style(void)
+{
+    widgets_create();
+    lv_obj_draw_list_resize(16 * 1024);
+    render(frame);
+    render(frame);
+    TEST_ASSERT_TRUE(has_list(btn_label));
+
+    /*The label of the button is not invalidated but it inherits the color*/
+    lv_obj_set_style_text_color(btn, lv_color_hex(0xff0000), 0);
+    TEST_ASSERT_FALSE(has_list(btn_label));
+    render(frame);
+
+    render(frame);
+    lv_obj_add_state(btn, LV_STATE_PRESSED);
+    TEST_ASSERT_FALSE(has_list(btn_label));
+    render(frame);
+
+    lv_obj_draw_list_resize(0);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_obj_draw_list_parent_recolor(void)
+{
+    widgets_create();
+    lv_obj_draw_list_resize(16 * 1024);
+    render(frame);
+    render(frame);
+    TEST_ASSERT_TRUE(has_list(btn_label));
+
+    /*The recolor is not inherited, the label keeps its list but gets it from the layer*/
+    lv_obj_set_style_recolor(btn, lv_color_hex(0x00ff00), 0);
+    lv_obj_set_style_recolor_opa(btn, LV_OPA_50, 0);
+    TEST_ASSERT_TRUE(has_list(btn_label));
+    render(frame);
+    render(frame);
+
+    lv_obj_draw_list_resize(0);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_obj_draw_list_moved_widget(void)
+{
+    widgets_create();
+    lv_obj_draw_list_resize(16 * 1024);
+    render(frame);
+    render(frame);
+
+    lv_obj_set_pos(btn, 20, 30);
+    render(frame);
+
+    lv_obj_draw_list_resize(0);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_obj_draw_list_draw_event(void)
+{
+    widgets_create();
+    lv_obj_add_event_cb(value_label, draw_main_cb, LV_EVENT_DRAW_MAIN, NULL);
+    render_both();
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    /*The event is sent in each refresh*/
+    TEST_ASSERT_EQUAL_UINT32(4, draw_cnt);
+    TEST_ASSERT_FALSE(has_list(value_label));
+    TEST_ASSERT_TRUE(has_list(btn));
+}
+
+void test_obj_draw_list_evict(void)
+{
+    lv_obj_draw_list_stats_t stats;
+    widgets_create();
+    render_both();
+
+    lv_obj_draw_list_resize(1024);
+    lv_obj_draw_list_reset_stats();
+    render(frame);
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.evict_cnt + stats.skip_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1024, stats.max_used);
+
+    lv_obj_draw_list_drop(NULL);
+    lv_obj_draw_list_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.list_cnt);
+}
+
+#endif
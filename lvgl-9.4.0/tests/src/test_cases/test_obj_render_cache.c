@@ -0,0 +1,287 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     256
+#define VER_RES     160
+#define BUF_SIZE    (HOR_RES * VER_RES * 2)
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t frame_ref[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint8_t * frame_act;
+static uint32_t draw_cnt;
+
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    LV_UNUSED(area);
+    lv_memcpy(frame_act, px_map, BUF_SIZE);
+    lv_display_flush_ready(d);
+}
+
+static void draw_main_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+    draw_cnt++;
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf, LV_COLOR_FORMAT_RGB565), NULL, BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    scr = lv_display_get_screen_active(disp);
+    draw_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+    lv_obj_render_cache_resize(LV_OBJ_RENDER_CACHE_DEF_SIZE, true);
+}
+
+static size_t cache_size(void)
+{
+    return lv_cache_get_size(LV_GLOBAL_DEFAULT()->obj_render_cache, NULL);
+}
+
+/**
+ * Render the whole screen
+ * @param dest      the flushed pixels are stored here
+ */
+static void render(uint8_t * dest)
+{
+    lv_obj_invalidate(scr);
+    frame_act = dest;
+    lv_refr_now(disp);
+}
+
+/**
+ * Render the screen with the render cache of `obj` disabled into `frame_ref`
+ * and enabled into `frame`
+ */
+static void render_both(lv_obj_t * obj)
+{
+    lv_obj_set_render_cache(obj, false);
+    render(frame_ref);
+    lv_obj_set_render_cache(obj, true);
+    render(frame);
+}
+
+/**
+ * Compare `frame` with `frame_ref`
+ * @return      the largest difference of a color channel (in 5 or 6 bit units)
+ */
+static uint32_t frame_diff(void)
+{
+    const uint16_t * a = (const uint16_t *)frame_ref;
+    const uint16_t * b = (const uint16_t *)frame;
+    uint32_t max_diff = 0;
+    uint32_t i;
+    for(i = 0; i < HOR_RES * VER_RES; i++) {
+        static const uint16_t masks[3] = {0x001F, 0x07E0, 0xF800};
+        static const uint8_t shifts[3] = {0, 5, 11};
+        uint32_t c;
+        for(c = 0; c < 3; c++) {
+            int32_t ca = (a[i] & masks[c]) >> shifts[c];
+            int32_t cb = (b[i] & masks[c]) >> shifts[c];
+            max_diff = LV_MAX(max_diff, (uint32_t)LV_ABS(ca - cb));
+        }
+    }
+    return max_diff;
+}
+
+/**
+ * A panel covering its area with a gradient, a few labels and a bar
+ */
+static lv_obj_t * panel_create(lv_obj_t * parent, int32_t x, int32_t y)
+{
+    lv_obj_t * panel = lv_obj_create(parent);
+    lv_obj_remove_style_all(panel);
+    lv_obj_remove_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(panel, x, y);
+    lv_obj_set_size(panel, 120, 80);
+    lv_obj_set_style_bg_opa(panel, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(panel, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_bg_grad_color(panel, lv_palette_darken(LV_PALETTE_BLUE, 3), 0);
+    lv_obj_set_style_bg_grad_dir(panel, LV_GRAD_DIR_VER, 0);
+    lv_obj_set_style_pad_all(panel, 6, 0);
+
+    lv_obj_t * label = lv_label_create(panel);
+    lv_label_set_text(label, "Temperature");
+    lv_obj_add_event_cb(label, draw_main_cb, LV_EVENT_DRAW_MAIN, NULL);
+
+    lv_obj_t * bar = lv_bar_create(panel);
+    lv_obj_set_size(bar, 100, 12);
+    lv_obj_align(bar, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_bar_set_value(bar, 60, LV_ANIM_OFF);
+    return panel;
+}
+
+void test_render_cache_blit(void)
+{
+    lv_obj_t * panel = panel_create(scr, 20, 30);
+    lv_obj_t * gauge = lv_label_create(scr);
+    lv_obj_set_pos(gauge, 60, 60);
+    lv_label_set_text(gauge, "12");
+
+    render_both(panel);
+    TEST_ASSERT_TRUE(lv_obj_get_render_cache(panel));
+    TEST_ASSERT_EQUAL_UINT32(2, draw_cnt);
+
+    /*The panel covers its area: a buffer in the display's format, pixel by pixel the same*/
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    TEST_ASSERT_EQUAL(lv_draw_buf_width_to_stride(120, LV_COLOR_FORMAT_RGB565) * 80, cache_size());
+
+    /*A label on top changes, the panel's subtree is not drawn again*/
+    lv_label_set_text(gauge, "13");
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(2, draw_cnt);
+
+    lv_obj_set_render_cache(panel, false);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_render_cache_child_change(void)
+{
+    lv_obj_t * panel = panel_create(scr, 20, 30);
+    render_both(panel);
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(2, draw_cnt);
+
+    /*A change of a child renders the cache again*/
+    lv_obj_t * label = lv_obj_get_child(panel, 0);
+    lv_label_set_text(label, "Humidity");
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(3, draw_cnt);
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(3, draw_cnt);
+
+    lv_obj_set_render_cache(panel, false);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_render_cache_alpha(void)
+{
+    /*Rounded corners and a shadow need an ARGB8888 buffer*/
+    lv_obj_render_cache_resize(256 * 1024, false);
+    lv_obj_t * panel = panel_create(scr, 30, 30);
+    lv_obj_set_style_radius(panel, 12, 0);
+    lv_obj_set_style_shadow_width(panel, 16, 0);
+    lv_obj_set_style_shadow_opa(panel, LV_OPA_50, 0);
+    lv_obj_set_style_shadow_offset_y(panel, 4, 0);
+    lv_obj_set_style_bg_color(scr, lv_palette_lighten(LV_PALETTE_GREY, 2), 0);
+
+    render_both(panel);
+    int32_t ext = lv_obj_get_ext_draw_size(panel);
+    TEST_ASSERT_GREATER_THAN(0, ext);
+    TEST_ASSERT_EQUAL(lv_draw_buf_width_to_stride(120 + 2 * ext, LV_COLOR_FORMAT_ARGB8888) * (80 + 2 * ext),
+                      cache_size());
+
+    /*Blending the semi-transparent pixels once more rounds them a little differently*/
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, frame_diff());
+}
+
+void test_render_cache_scroll(void)
+{
+    /*Scrolling moves the cached panel without invalidating it. The scrolled state of the
+     *default theme's container would refresh the styles of the children, so no styles here.*/
+    lv_obj_t * cont = lv_obj_create(scr);
+    lv_obj_remove_style_all(cont);
+    lv_obj_set_size(cont, 200, 140);
+    lv_obj_t * panel = panel_create(cont, 0, 0);
+    lv_obj_t * filler = lv_obj_create(cont);
+    lv_obj_set_pos(filler, 0, 200);
+
+    render_both(panel);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(2, draw_cnt);
+
+    lv_obj_scroll_to_y(cont, 25, LV_ANIM_OFF);
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(2, draw_cnt);
+
+    /*A child changed while the panel is scrolled out is rendered again when it's scrolled back*/
+    lv_obj_scroll_to_y(cont, 120, LV_ANIM_OFF);
+    render(frame);
+    lv_label_set_text(lv_obj_get_child(panel, 0), "Humidity");
+    lv_obj_scroll_to_y(cont, 25, LV_ANIM_OFF);
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(3, draw_cnt);
+
+    lv_obj_set_render_cache(panel, false);
+    render(frame_ref);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(4, draw_cnt);
+}
+
+void test_render_cache_budget(void)
+{
+    uint32_t panel_size = lv_draw_buf_width_to_stride(120, LV_COLOR_FORMAT_RGB565) * 80;
+    lv_obj_render_cache_resize(panel_size + panel_size / 2, true);
+
+    lv_obj_t * panel1 = panel_create(scr, 0, 0);
+    lv_obj_t * panel2 = panel_create(scr, 130, 70);
+    lv_obj_set_render_cache(panel1, true);
+
+    /*Both are drawn in the same refresh: the second one doesn't fit and is drawn as usual*/
+    lv_obj_set_render_cache(panel2, false);
+    render(frame_ref);
+    lv_obj_set_render_cache(panel2, true);
+    render(frame);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    TEST_ASSERT_EQUAL(panel_size, cache_size());
+
+    /*The least recently drawn one is evicted if only the other one is drawn*/
+    draw_cnt = 0;
+    lv_obj_invalidate(panel2);
+    frame_act = frame;
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_UINT32(1, draw_cnt);
+    TEST_ASSERT_EQUAL(panel_size, cache_size());
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+
+    /*Disabled*/
+    lv_obj_render_cache_resize(0, true);
+    TEST_ASSERT_EQUAL(0, cache_size());
+    draw_cnt = 0;
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(2, draw_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+}
+
+void test_render_cache_not_used(void)
+{
+    /*The opacity of a parent is applied to every draw task, not to the cached buffer*/
+    lv_obj_t * cont = lv_obj_create(scr);
+    lv_obj_set_size(cont, 200, 140);
+    lv_obj_set_style_opa(cont, LV_OPA_50, 0);
+    lv_obj_t * panel = panel_create(cont, 0, 0);
+
+    render_both(panel);
+    TEST_ASSERT_EQUAL(0, cache_size());
+    TEST_ASSERT_EQUAL_MEMORY(frame_ref, frame, BUF_SIZE);
+    render(frame);
+    TEST_ASSERT_EQUAL_UINT32(3, draw_cnt);
+}
+
+void test_render_cache_delete(void)
+{
+    lv_obj_t * panel = panel_create(scr, 20, 30);
+    render_both(panel);
+    TEST_ASSERT_NOT_EQUAL(0, cache_size());
+
+    lv_obj_delete(panel);
+    render(frame);
+    TEST_ASSERT_EQUAL(0, cache_size());
+}
+
+#endif
@@ -0,0 +1,314 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../../lvgl_private.h"
+#include "unity/unity.h"
+
+#define HOR_RES     256
+#define VER_RES     160
+#define STRIDE      (HOR_RES * 2)
+#define BUF_SIZE    (STRIDE * VER_RES)
+
+static lv_display_t * disp;
+static lv_obj_t * scr;
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf1[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static LV_ATTRIBUTE_MEM_ALIGN uint8_t disp_buf2[BUF_SIZE + LV_DRAW_BUF_ALIGN];
+static uint8_t panel[BUF_SIZE];
+static uint8_t frame[BUF_SIZE];
+static uint32_t inv_px;
+static uint32_t redrawn_px;
+static uint32_t blit_cnt;
+
+/*Like a display with its own memory: only the flushed areas are copied*/
+static void flush_cb(lv_display_t * d, const lv_area_t * area, uint8_t * px_map)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        const uint8_t * src;
+        if(d->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL) {
+            src = px_map + (y - area->y1) * lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_RGB565);
+        }
+        else src = px_map + y * STRIDE + area->x1 * 2;
+        lv_memcpy(panel + y * STRIDE + area->x1 * 2, src, w * 2);
+    }
+    lv_display_flush_ready(d);
+}
+
+/*Move the pixels in the display's memory*/
+static bool blit_cb(lv_display_t * d, const lv_area_t * area, int32_t dx, int32_t dy)
+{
+    LV_UNUSED(d);
+    lv_area_t src = *area;
+    lv_area_move(&src, -dx, -dy);
+    lv_area_t dst;
+    if(!lv_area_intersect(&src, &src, area)) return true;
+    dst = src;
+    lv_area_move(&dst, dx, dy);
+
+    int32_t h = lv_area_get_height(&dst);
+    int32_t i;
+    for(i = 0; i < h; i++) {
+        int32_t y = dy > 0 ? h - 1 - i : i;
+        lv_memmove(panel + (dst.y1 + y) * STRIDE + dst.x1 * 2, panel + (src.y1 + y) * STRIDE + src.x1 * 2,
+                   lv_area_get_width(&dst) * 2);
+    }
+    blit_cnt++;
+    return true;
+}
+
+static void invalidate_area_cb(lv_event_t * e)
+{
+    const lv_area_t * area = lv_event_get_param(e);
+    inv_px += lv_area_get_size(area);
+}
+
+static void setup_display(lv_display_render_mode_t mode, bool double_buf)
+{
+    lv_display_set_buffers(disp, lv_draw_buf_align(disp_buf1, LV_COLOR_FORMAT_RGB565),
+                           double_buf ? lv_draw_buf_align(disp_buf2, LV_COLOR_FORMAT_RGB565) : NULL,
+                           mode == LV_DISPLAY_RENDER_MODE_PARTIAL ? STRIDE * 20 : BUF_SIZE, mode);
+}
+
+void setUp(void)
+{
+    disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    setup_display(LV_DISPLAY_RENDER_MODE_DIRECT, false);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_set_scroll_blit(disp, true);
+    scr = lv_display_get_screen_active(disp);
+    blit_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_display_delete(disp);
+    disp = NULL;
+}
+
+static uint32_t get_blitted(void)
+{
+    lv_display_inv_stats_t stats;
+    lv_display_get_inv_stats(disp, &stats);
+    return stats.blitted;
+}
+
+/**
+ * Refresh the display, then redraw all of it and check that the display shows the same.
+ * The pixels invalidated since the last check are saved in `redrawn_px`.
+ */
+static void refr_and_check(void)
+{
+    lv_refr_now(disp);
+    redrawn_px = inv_px;
+    lv_memcpy(frame, panel, BUF_SIZE);
+
+    lv_obj_invalidate(scr);
+    lv_obj_invalidate(lv_display_get_layer_top(disp));
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL_MEMORY(panel, frame, BUF_SIZE);
+    inv_px = 0;
+}
+
+/**
+ * Start scrolling like an input device does when dragging starts.
+ * The steps of the dragging are done with `lv_obj_scroll_by_raw`.
+ */
+static void scroll_begin(lv_obj_t * obj)
+{
+    lv_obj_send_event(obj, LV_EVENT_SCROLL_BEGIN, NULL);
+    refr_and_check();
+}
+
+/**
+ * A list with the default theme: rounded corners, border, padding and scrollbars
+ */
+static lv_obj_t * list_create(void)
+{
+    lv_obj_t * list = lv_obj_create(scr);
+    lv_obj_set_size(list, 180, 140);
+    lv_obj_set_pos(list, 10, 10);
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_scrollbar_mode(list, LV_SCROLLBAR_MODE_ON);
+
+    uint32_t i;
+    for(i = 0; i < 12; i++) {
+        lv_obj_t * btn = lv_button_create(list);
+        lv_obj_set_width(btn, lv_pct(100));
+        lv_obj_t * label = lv_label_create(btn);
+        lv_label_set_text_fmt(label, "Item %" LV_PRIu32, i);
+    }
+
+    refr_and_check();
+    scroll_begin(list);
+    return list;
+}
+
+void test_scroll_blit_list(void)
+{
+    /*The labels of the performance monitor would be redrawn where the pixels are moved under them*/
+    lv_obj_add_flag(lv_display_get_layer_sys(disp), LV_OBJ_FLAG_HIDDEN);
+    lv_obj_t * list = list_create();
+    uint32_t i;
+    for(i = 0; i < 6; i++) {
+        lv_obj_scroll_by_raw(list, 0, -13);
+        refr_and_check();
+        TEST_ASSERT_EQUAL_UINT32(i + 1, get_blitted());
+        /*Much less than the list is redrawn*/
+        TEST_ASSERT_LESS_THAN_UINT32(lv_area_get_size(&list->coords) / 2, redrawn_px);
+    }
+
+    /*Scrolling by a step adds and removes the scrolled state, which changes only the scrollbars*/
+    lv_obj_send_event(list, LV_EVENT_SCROLL_END, NULL);
+    refr_and_check();
+    lv_obj_scroll_by(list, 0, 20, LV_ANIM_OFF);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(7, get_blitted());
+    TEST_ASSERT_LESS_THAN_UINT32(lv_area_get_size(&list->coords), redrawn_px);
+}
+
+void test_scroll_blit_overlays(void)
+{
+    lv_obj_t * list = list_create();
+
+    /*A sibling over the list, a floating child and a label on the top layer*/
+    lv_obj_t * badge = lv_obj_create(scr);
+    lv_obj_set_size(badge, 50, 30);
+    lv_obj_set_pos(badge, 120, 60);
+    lv_obj_t * floating = lv_button_create(list);
+    lv_obj_add_flag(floating, LV_OBJ_FLAG_FLOATING);
+    lv_obj_align(floating, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_obj_t * title = lv_label_create(lv_display_get_layer_top(disp));
+    lv_label_set_text(title, "Title");
+    lv_obj_set_pos(title, 30, 20);
+    refr_and_check();
+
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        lv_obj_scroll_by_raw(list, 0, -9);
+        refr_and_check();
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, get_blitted());
+}
+
+void test_scroll_blit_pending(void)
+{
+    lv_obj_t * list = list_create();
+    lv_obj_t * label = lv_obj_get_child(lv_obj_get_child(list, 3), 0);
+
+    /*Changed before and after scrolling in the same refresh*/
+    lv_label_set_text(label, "Changed");
+    lv_obj_scroll_by_raw(list, 0, -11);
+    lv_obj_set_style_bg_color(lv_obj_get_child(list, 2), lv_palette_main(LV_PALETTE_RED), 0);
+    refr_and_check();
+
+    /*Scrolled twice in one refresh, the second time back a little*/
+    lv_label_set_text(label, "Changed again");
+    lv_obj_scroll_by_raw(list, 0, -17);
+    lv_obj_scroll_by_raw(list, 0, 6);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(2, get_blitted());
+
+    /*The same with dirty tiles*/
+    lv_display_set_inv_tile_size(disp, 16);
+    lv_label_set_text(label, "Tiles");
+    lv_obj_scroll_by_raw(list, 0, -7);
+    lv_obj_scroll_by_raw(list, 0, -5);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(3, get_blitted());
+}
+
+void test_scroll_blit_horizontal(void)
+{
+    lv_obj_t * row = lv_obj_create(scr);
+    lv_obj_set_size(row, 220, 80);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    uint32_t i;
+    for(i = 0; i < 8; i++) {
+        lv_obj_t * btn = lv_button_create(row);
+        lv_label_set_text_fmt(lv_label_create(btn), "%" LV_PRIu32, i);
+    }
+    refr_and_check();
+    scroll_begin(row);
+
+    for(i = 0; i < 4; i++) {
+        lv_obj_scroll_by_raw(row, -15, 0);
+        refr_and_check();
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, get_blitted());
+}
+
+void test_scroll_blit_double_buffered(void)
+{
+    setup_display(LV_DISPLAY_RENDER_MODE_DIRECT, true);
+    lv_obj_t * list = list_create();
+
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        lv_obj_scroll_by_raw(list, 0, -10);
+        refr_and_check();
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, get_blitted());
+}
+
+void test_scroll_blit_partial(void)
+{
+    /*Without a callback it's redrawn*/
+    setup_display(LV_DISPLAY_RENDER_MODE_PARTIAL, false);
+    lv_obj_t * list = list_create();
+    lv_obj_scroll_by_raw(list, 0, -10);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(0, get_blitted());
+
+    lv_display_set_blit_cb(disp, blit_cb);
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        lv_obj_scroll_by_raw(list, 0, -10);
+        refr_and_check();
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, get_blitted());
+    TEST_ASSERT_EQUAL_UINT32(5, blit_cnt);
+}
+
+void test_scroll_blit_not_used(void)
+{
+    lv_obj_t * list = list_create();
+
+    /*Semi-transparent*/
+    lv_obj_set_style_opa(list, LV_OPA_70, 0);
+    lv_obj_scroll_by_raw(list, 0, -10);
+    refr_and_check();
+    lv_obj_set_style_opa(list, LV_OPA_COVER, 0);
+
+    /*Gradient background*/
+    lv_obj_set_style_bg_grad_dir(list, LV_GRAD_DIR_VER, 0);
+    lv_obj_scroll_by_raw(list, 0, -10);
+    refr_and_check();
+    lv_obj_set_style_bg_grad_dir(list, LV_GRAD_DIR_NONE, 0);
+
+    /*Not a plain container*/
+    lv_obj_t * ta = lv_textarea_create(scr);
+    lv_obj_set_size(ta, 60, 50);
+    lv_textarea_set_text(ta, "1\n2\n3\n4\n5\n6\n7");
+    refr_and_check();
+    scroll_begin(ta);
+    lv_obj_scroll_by_raw(ta, 0, -10);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(0, get_blitted());
+
+    /*Disabled*/
+    lv_display_set_scroll_blit(disp, false);
+    lv_obj_scroll_by_raw(list, 0, -10);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(0, get_blitted());
+
+    /*Full refresh mode redraws everything*/
+    lv_display_set_scroll_blit(disp, true);
+    setup_display(LV_DISPLAY_RENDER_MODE_FULL, false);
+    lv_obj_scroll_by_raw(list, 0, -10);
+    refr_and_check();
+    TEST_ASSERT_EQUAL_UINT32(0, get_blitted());
+}
+
+#endif
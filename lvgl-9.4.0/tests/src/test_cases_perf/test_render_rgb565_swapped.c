@@ -0,0 +1,90 @@
+/* Performance test for rendering straight into RGB565_SWAPPED instead of swapping RGB565 in the flush callback */
+#if LV_BUILD_TEST_PERF
+#include "unity/unity.h"
+
+#include <time.h>
+
+#define HOR_RES     480
+#define VER_RES     320
+#define BUF_LINES   160
+#define FRAME_CNT   100
+
+typedef struct {
+    double frame_ms;    /* Rendering and flushing */
+    double flush_ms;    /* Time spent in the flush callback only */
+} render_time_t;
+
+static bool swap_in_flush;
+static clock_t flush_time;
+
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    clock_t t = clock();
+    /* This is what an SPI driver has to do when the panel needs big-endian RGB565 */
+    if(swap_in_flush) lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    flush_time += clock() - t;
+
+    lv_display_flush_ready(disp);
+}
+
+static render_time_t render_frames(lv_color_format_t cf, bool swap)
+{
+    lv_display_t * disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_color_format(disp, cf);
+    lv_draw_buf_t * buf1 = lv_draw_buf_create(HOR_RES, BUF_LINES, cf, LV_STRIDE_AUTO);
+    lv_draw_buf_t * buf2 = lv_draw_buf_create(HOR_RES, BUF_LINES, cf, LV_STRIDE_AUTO);
+    lv_display_set_draw_buffers(disp, buf1, buf2);
+    lv_display_set_flush_cb(disp, flush_cb);
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_hide_performance(disp);
+#endif
+    swap_in_flush = swap;
+    flush_time = 0;
+
+    lv_obj_t * scr = lv_display_get_screen_active(disp);
+    uint32_t i;
+    for(i = 0; i < 12; i++) {
+        lv_obj_t * obj = lv_obj_create(scr);
+        lv_obj_set_size(obj, 140, 90);
+        lv_obj_set_pos(obj, (i % 4) * 118, (i / 4) * 104);
+        lv_obj_set_style_radius(obj, 12, 0);
+        lv_obj_set_style_bg_opa(obj, LV_OPA_70, 0);
+        lv_obj_t * label = lv_label_create(obj);
+        lv_label_set_text(label, "Flush me\nover SPI");
+    }
+
+    clock_t t = clock();
+    for(i = 0; i < FRAME_CNT; i++) {
+        lv_obj_invalidate(scr);
+        lv_refr_now(disp);
+    }
+    t = clock() - t;
+
+    lv_display_delete(disp);
+    lv_draw_buf_destroy(buf1);
+    lv_draw_buf_destroy(buf2);
+
+    render_time_t res;
+    res.frame_ms = ((double)t * 1000.) / CLOCKS_PER_SEC;
+    res.flush_ms = ((double)flush_time * 1000.) / CLOCKS_PER_SEC;
+    return res;
+}
+
+void test_rgb565_swap_half_screen(void)
+{
+    /* The cost removed from every half screen flush when rendering swapped */
+    static uint16_t buf[HOR_RES * BUF_LINES];
+    TEST_ASSERT_MAX_TIME_ITER(lv_draw_sw_rgb565_swap, 50, 100, buf, HOR_RES * BUF_LINES);
+}
+
+void test_render_rgb565_swapped(void)
+{
+    render_time_t native = render_frames(LV_COLOR_FORMAT_RGB565, true);
+    render_time_t swapped = render_frames(LV_COLOR_FORMAT_RGB565_SWAPPED, false);
+
+    TEST_PRINTF("%d frames, RGB565 + swap: %d ms (flush %d ms), RGB565_SWAPPED: %d ms (flush %d ms)", FRAME_CNT,
+                (int)native.frame_ms, (int)native.flush_ms, (int)swapped.frame_ms, (int)swapped.flush_ms);
+    TEST_ASSERT_LESS_THAN_DOUBLE(native.flush_ms, swapped.flush_ms);
+}
+
+#endif
@@ -11,6 +11,15 @@
 #include "src/drivers/display/lcd/lv_lcd_generic_mipi.h"
 #include "demos/lv_demos.h"
 #include "ft6336u.h"
+#include "lcd_pipeline.h"
+#include "lcd_dma_chain.h"
+#include "touch_ring.h"
+#include "touch_gesture.h"
+#include "idle_loop.h"
+#include "core_port.h"
+#if !PICO_ON_DEVICE
+#include "hal_sim.h"
+#endif
 
 /*===========================================
  * ST7796 Display Configuration
@@ -20,6 +29,95 @@
 #define DISP_HOR_RES    480
 #define DISP_VER_RES    320
 
+/* Render straight into byte-swapped RGB565 (the big-endian order the ST7796 expects
+ * on the SPI bus), so the flush buffer can be handed to DMA as-is.
+ * Set to 0 to render native RGB565 and swap the bytes on the CPU before each transfer. */
+#define DISP_RENDER_SWAPPED 1
+
+/* Split rendering and flushing across the two cores: core 0 runs LVGL, core 1
+ * owns the SPI bus and the DMA channel (see lcd_pipeline.h).
+ * Set to 0 to run everything on core 0 with the DMA interrupt completing the flush. */
+#define DISP_PIPELINE       1
+
+/* Send the window commands and the pixels of each strip as one chained DMA
+ * sequence (see lcd_dma_chain.h) instead of blocking CASET/RASET/RAMWR writes.
+ * Needs DISP_PIPELINE. */
+#define DISP_DMA_CHAIN      1
+
+/* Only send the rows of a strip that changed since they were last sent: the
+ * MIPI driver keeps a hash per row and tile of this width (4 bytes each, 6.4 KB
+ * at 96 px) and trims the window to the changed rows.
+ * Set to 0 to send every flushed row. */
+#define DISP_ROW_HASH_TILE_W    96
+
+/* Cost model to join the invalidated areas (lv_display_set_area_cost()): a
+ * window costs the render pass set-up, the object traversal and the window
+ * commands, a pixel its rendering plus its bytes on the SPI bus. Estimates for
+ * the RP2350 at 150 MHz, see host/bench_area_join for their effect. */
+#define DISP_AREA_COST_WINDOW_NS    30000
+#define DISP_AREA_COST_PX_NS        40
+
+/* Keep the invalidated areas as dirty tiles of this size instead of a list
+ * (lv_display_set_inv_tile_size()). Invalidating is cheaper with hundreds of
+ * small areas, but the tiles render more pixels; see host/bench_inv_tiles.
+ * Set to 0 for the list of areas. */
+#define DISP_INV_TILE_SIZE  0
+
+/* Drop the draw tasks, or the parts of them, hidden by opaque rectangles,
+ * images and borders drawn later (lv_display_set_occlusion_culling()). The
+ * overdraw is shown by the performance monitor; see host/bench_occlusion.
+ * Set to 0 to draw every task. */
+#define DISP_OCCLUSION_CULLING  1
+
+/* Track which draw tasks wait for which in a graph instead of searching the
+ * older tasks at every dispatch (lv_display_set_draw_task_graph()). Only pays
+ * off with several draw units or render threads and many draw tasks per
+ * layer; see host/bench_task_graph. Set to 1 to enable. */
+#define DISP_DRAW_TASK_GRAPH    0
+
+/* Allocate the draw tasks, their descriptors and the copied label texts from
+ * one buffer reused after every rendered area instead of the heap
+ * (lv_draw_arena_resize()); what doesn't fit still comes from the heap.
+ * 8 kB takes ~98% of these allocations in lv_demo_benchmark; see
+ * host/bench_draw_arena. Set to 0 to allocate everything from the heap. */
+#define DISP_DRAW_ARENA_SIZE    (8 * 1024)
+
+/* Record the draw tasks of the widgets drawn unchanged twice and add them
+ * again instead of sending their draw events while they are not invalidated
+ * (lv_obj_draw_list_resize()). Saves the style lookups and draw descriptors
+ * of the widgets redrawn only because something on them changes; the least
+ * recently replayed lists are freed to stay in the budget. The lists live in
+ * the LVGL heap: 8 kB cut 10-17% of the redraw CPU in host/bench_draw_list but
+ * halve the largest free block in the widgets demo. Set to e.g. (8 * 1024)
+ * to enable. */
+#define DISP_DRAW_LIST_SIZE     0
+
+/* Keep the glyphs of the built-in fonts expanded to A8 instead of expanding
+ * the 4 bpp bitmaps, or decoding the compressed ones, whenever a glyph is
+ * drawn (lv_font_fmt_txt_cache_resize()); the least recently drawn glyphs are
+ * freed to stay in the budget. Halves the text render time of compressed
+ * fonts in host/bench_glyph_cache, but saves only 2-6% with the 4 bpp
+ * Montserrat fonts of this build, and every glyph is a small block in the
+ * LVGL heap. Set to e.g. (8 * 1024) to enable. */
+#define DISP_GLYPH_CACHE_SIZE   0
+
+/* Find the characters of the built-in fonts in per font tables instead of
+ * searching the cmaps and the kerning pairs (lv_font_fmt_txt_lookup_set_max_size(),
+ * a cap per font): a direct table below U+0100, a hash table for the symbols
+ * and the kerning classes next to the glyph ids. The symbols are found 3x
+ * faster and the text 10-30% in host/bench_font_lookup; every Montserrat font
+ * drawn takes 1.7 kB of the LVGL heap (0.7 kB without the symbols' table with
+ * a 1024 byte cap). Set to e.g. 2048 to enable. */
+#define DISP_FONT_LOOKUP_SIZE   0
+
+/* Move the pixels of a scrolled widget instead of rendering it again
+ * (lv_display_set_scroll_blit()); only the rows scrolled in are rendered. In
+ * partial mode the panel moves them: the ST7796 scrolls the rows of its memory
+ * (lv_lcd_generic_mipi_set_hw_scroll()), which are the columns in the landscape
+ * orientation used here, so it only works in portrait with a scrolled screen.
+ * See host/bench_scroll_blit. Needs DISP_PIPELINE and DISP_DMA_CHAIN. */
+#define DISP_SCROLL_BLIT    0
+
 /* SPI Configuration */
 #define SPI_PORT        spi0
 #define SPI_BAUDRATE    (1000 * 1000 * 1000)  /* 75 MHz - maximum for ST7796 */
@@ -32,6 +130,16 @@
 #define PIN_DC          20   /* Data/Command */
 #define PIN_RST         21   /* Reset */
 #define PIN_BL          22   /* Backlight (optional) */
+#define PIN_LCD_TE      -1   /* Tearing effect output (optional, -1 if not wired) */
+
+/* With PIN_LCD_TE wired, core 1 holds back the strips that would race the
+ * panel's scan (see lv_lcd_generic_mipi_set_tear_sync()). This only helps in
+ * portrait: in the landscape mode main() sets, every strip crosses all 480 scan
+ * lines and takes longer to send than the blanking, so the strips are sent
+ * as without TE and can still tear. Panel timing of the ST7796 after reset:
+ * 480 lines, 2 + 2 lines of porch (B5h). */
+#define LCD_SCAN_LINES      480
+#define LCD_VBLANK_LINES    4
 
 /*===========================================
  * FT6336U Touch Configuration
@@ -50,20 +158,42 @@
 #define TOUCH_INVERT_X      true   /* Invert X axis for landscape */
 #define TOUCH_INVERT_Y      false  /* Invert Y axis */
 
+/* Read the touch controller only when it pulls INT low and queue the samples
+ * for LVGL (see touch_ring.h). Set to 0 to poll it over I2C on every indev read. */
+#define TOUCH_USE_INT       1
+
+#if TOUCH_USE_INT && PIN_TOUCH_INT < 0
+#error "TOUCH_USE_INT needs PIN_TOUCH_INT"
+#endif
+#if PIN_LCD_TE >= 0 && !(DISP_PIPELINE && DISP_DMA_CHAIN)
+#error "PIN_LCD_TE needs DISP_PIPELINE and DISP_DMA_CHAIN"
+#endif
+#if DISP_SCROLL_BLIT && !(DISP_PIPELINE && DISP_DMA_CHAIN)
+#error "DISP_SCROLL_BLIT needs DISP_PIPELINE and DISP_DMA_CHAIN"
+#endif
+
 /* FT6336U device handle */
 static ft6336u_t touch_dev;
+static lv_indev_t *touch_indev;
 
-/* Display buffer - Half screen double buffering */
-/* 480 x 160 x 2 bytes = 153,600 bytes (150KB) per buffer */
-#define DISP_BUF_LINES  160  /* Half screen */
-#define DISP_BUF_SIZE   (DISP_HOR_RES * DISP_BUF_LINES)
-static uint8_t disp_buf1[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));  /* RGB565 buffer 1 */
-static uint8_t disp_buf2[DISP_BUF_SIZE * 2] __attribute__((aligned(4)));  /* RGB565 buffer 2 */
+/* Display buffer - ring of small strips
+ * 6 x 480 x 40 x 2 bytes = 230,400 bytes (225KB) in total. While one strip is
+ * being sent the next ones are rendered, so the bus rarely waits for the renderer.
+ * Run host/bench_ring to compare other depths and strip heights. */
+#define DISP_RING_STRIPS    6
+#define DISP_BUF_LINES      40
+#define DISP_BUF_SIZE       (DISP_HOR_RES * DISP_BUF_LINES)
+static uint8_t disp_ring[DISP_RING_STRIPS][DISP_BUF_SIZE * 2] __attribute__((aligned(4)));  /* RGB565 strips */
 
 /* DMA channel for SPI transfer */
 static int dma_channel;
+#if !DISP_PIPELINE
 static volatile bool dma_transfer_done = true;
 static lv_display_t *current_disp = NULL;
+#endif
+#if PIN_LCD_TE >= 0
+static lv_display_t *tear_disp = NULL;
+#endif
 
 /*===========================================
  * SPI and GPIO Low-level Functions
@@ -93,6 +223,7 @@ static void lcd_reset(void) {
     sleep_ms(100);
 }
 
+#if !DISP_PIPELINE
 /* DMA interrupt handler */
 static void dma_irq_handler(void) {
     if (dma_channel_get_irq0_status(dma_channel)) {
@@ -104,13 +235,17 @@ static void dma_irq_handler(void) {
         if (current_disp) {
             lv_display_flush_ready(current_disp);
         }
+        idle_loop_wake();
     }
 }
+#endif
 
 /*===========================================
  * LVGL Display Driver Callbacks
  *===========================================*/
 
+#if !DISP_PIPELINE
+
 /**
  * Send command to LCD controller (blocking)
  */
@@ -152,6 +287,7 @@ static void lcd_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_si
     
     current_disp = disp;
     
+#if !DISP_RENDER_SWAPPED
     /* Swap bytes for RGB565 using optimized 32-bit operations */
     uint32_t *pixels32 = (uint32_t *)param;
     size_t count32 = param_size / 4;
@@ -160,6 +296,7 @@ static void lcd_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_si
         /* Swap bytes within each 16-bit word: ABCD -> BADC */
         pixels32[i] = ((v & 0x00FF00FF) << 8) | ((v & 0xFF00FF00) >> 8);
     }
+#endif
     
     cs_select();
     
@@ -182,6 +319,58 @@ static void lcd_send_color(lv_display_t *disp, const uint8_t *cmd, size_t cmd_si
     
     /* DMA transfer started - will complete in background via interrupt */
 }
+#endif
+
+/*===========================================
+ * Pipeline Bus Access (Core 1)
+ *===========================================*/
+
+#if DISP_PIPELINE
+/**
+ * Send command to LCD controller, called on core 1
+ */
+static void pipeline_send_cmd(const uint8_t *cmd, size_t cmd_size, const uint8_t *param, size_t param_size)
+{
+    cs_select();
+    
+    dc_command();
+    spi_write_blocking(SPI_PORT, cmd, cmd_size);
+    
+    if (param_size > 0) {
+        dc_data();
+        spi_write_blocking(SPI_PORT, param, param_size);
+    }
+    
+    cs_deselect();
+}
+
+/**
+ * Send pixel data to LCD controller with DMA, called on core 1
+ */
+static void pipeline_send_color(const uint8_t *cmd, size_t cmd_size, uint8_t *param, size_t param_size)
+{
+    cs_select();
+    
+    dc_command();
+    spi_write_blocking(SPI_PORT, cmd, cmd_size);
+    
+    dc_data();
+    dma_channel_config cfg = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, spi_get_dreq(SPI_PORT, true));
+    dma_channel_configure(dma_channel, &cfg, &spi_get_hw(SPI_PORT)->dr, param, param_size, true);
+    
+    /* Core 1 has nothing else to do, wait for the DMA and for the SPI FIFO to drain */
+    dma_channel_wait_for_finish_blocking(dma_channel);
+    while (spi_is_busy(SPI_PORT)) {
+        tight_loop_contents();
+    }
+    
+    cs_deselect();
+}
+#endif
 
 /*===========================================
  * Tick Callback
@@ -199,7 +388,7 @@ static void hardware_init(void) {
     /* Initialize SPI */
     uint actual_baudrate = spi_init(SPI_PORT, SPI_BAUDRATE);
     printf("SPI baudrate: requested %lu MHz, actual %lu MHz\n", 
-           SPI_BAUDRATE / 1000000, actual_baudrate / 1000000);
+           (unsigned long)(SPI_BAUDRATE / 1000000), (unsigned long)(actual_baudrate / 1000000));
     gpio_set_function(PIN_SCK, GPIO_FUNC_SPI);
     gpio_set_function(PIN_MOSI, GPIO_FUNC_SPI);
     gpio_set_function(PIN_MISO, GPIO_FUNC_SPI);
@@ -242,13 +431,26 @@ static void hardware_init(void) {
     #if PIN_TOUCH_INT >= 0
     gpio_init(PIN_TOUCH_INT);
     gpio_set_dir(PIN_TOUCH_INT, GPIO_IN);
+    gpio_pull_up(PIN_TOUCH_INT);
+    #endif
+    
+    /* Initialize the display's TE pin if wired */
+    #if PIN_LCD_TE >= 0
+    gpio_init(PIN_LCD_TE);
+    gpio_set_dir(PIN_LCD_TE, GPIO_IN);
     #endif
     
     /* Initialize DMA */
     dma_channel = dma_claim_unused_channel(true);
+#if DISP_PIPELINE && DISP_DMA_CHAIN
+    lcd_dma_chain_init(SPI_PORT, PIN_DC, PIN_CS);
+#endif
+#if !DISP_PIPELINE
+    /* With the pipeline core 1 polls the DMA channel instead */
     dma_channel_set_irq0_enabled(dma_channel, true);
     irq_set_exclusive_handler(DMA_IRQ_0, dma_irq_handler);
     irq_set_enabled(DMA_IRQ_0, true);
+#endif
     
     /* Hardware reset the display */
     lcd_reset();
@@ -273,6 +475,93 @@ static void touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
     }
 }
 
+#if TOUCH_USE_INT || PIN_LCD_TE >= 0
+/**
+ * GPIO interrupt: the touch controller has a new report, or the panel starts its vertical blanking
+ */
+static void gpio_irq_callback(uint gpio, uint32_t events)
+{
+    (void)events;
+    
+#if PIN_LCD_TE >= 0
+    if (gpio == PIN_LCD_TE) {
+        lv_lcd_generic_mipi_tear_pulse(tear_disp, core_port_time_us());
+    }
+#endif
+#if TOUCH_USE_INT
+    if (gpio == PIN_TOUCH_INT) {
+        touch_ring_irq_handler();
+        idle_loop_wake();
+    }
+#endif
+}
+#endif
+
+/*===========================================
+ * Benchmark Report
+ *===========================================*/
+
+/**
+ * Print the benchmark results over stdio and show the summary screen
+ */
+static void benchmark_end_cb(const lv_demo_benchmark_summary_t *summary)
+{
+    printf("%-28s %5s %5s %10s %9s\n", "Scene", "FPS", "CPU", "Render ms", "Flush ms");
+    for (const lv_demo_benchmark_scene_dsc_t *scene = summary->scenes; scene->create_cb; scene++) {
+        uint32_t cnt = scene->measurement_cnt;
+        if (cnt == 0) {
+            continue;
+        }
+        printf("%-28s %5lu %4lu%% %10lu %9lu\n", scene->name,
+               (unsigned long)(scene->fps_avg / cnt), (unsigned long)(scene->cpu_avg_usage / cnt),
+               (unsigned long)(scene->render_avg_time / cnt), (unsigned long)(scene->flush_avg_time / cnt));
+    }
+    
+    uint32_t avg_fps = 0;
+    if (summary->valid_scene_cnt > 0) {
+        int32_t cnt = summary->valid_scene_cnt;
+        avg_fps = summary->total_avg_fps / cnt;
+        printf("%-28s %5lu %4lu%% %10lu %9lu\n", "All scenes avg.",
+               (unsigned long)avg_fps, (unsigned long)(summary->total_avg_cpu / cnt),
+               (unsigned long)(summary->total_avg_render_time / cnt),
+               (unsigned long)(summary->total_avg_flush_time / cnt));
+    }
+    
+#if TOUCH_USE_INT
+    touch_ring_stats_t touch_stats;
+    touch_ring_get_stats(&touch_stats);
+    printf("Touch: %lu samples, %lu dropped, latency avg %lu us, max %lu us\n",
+           (unsigned long)touch_stats.delivered, (unsigned long)touch_stats.dropped,
+           (unsigned long)(touch_stats.delivered ? touch_stats.latency_sum_us / touch_stats.delivered : 0),
+           (unsigned long)touch_stats.latency_max_us);
+#endif
+    
+    idle_loop_stats_t idle_stats;
+    idle_loop_get_stats(&idle_stats);
+    printf("Main loop: %lu iterations, %lu sleeps (%lu woken early), %lu ms asleep\n",
+           (unsigned long)idle_stats.loops, (unsigned long)idle_stats.sleeps,
+           (unsigned long)idle_stats.wakeups, (unsigned long)(idle_stats.slept_us / 1000));
+    
+    lv_display_inv_stats_t inv_stats;
+    lv_display_get_inv_stats(lv_display_get_default(), &inv_stats);
+    printf("Invalidation: %lu areas saved, %lu in saved ones, %lu overflows, peak %lu of %lu\n",
+           (unsigned long)inv_stats.saved, (unsigned long)inv_stats.dropped,
+           (unsigned long)inv_stats.overflows, (unsigned long)inv_stats.peak,
+           (unsigned long)inv_stats.capacity);
+    
+#if PICO_ON_DEVICE
+    (void)avg_fps;
+    lv_demo_benchmark_summary_display(summary);
+#if LV_USE_GESTURE_RECOGNITION
+    /* Pinch to zoom the results table */
+    touch_gesture_add_zoom(lv_obj_get_child(lv_screen_active(), 0), false);
+#endif
+#else
+    /* Host simulation (host/): the run ends with the benchmark */
+    sim_benchmark_done(avg_fps);
+#endif
+}
+
 /*===========================================
  * Touch Controller Initialization
  *===========================================*/
@@ -300,16 +589,41 @@ int main(void)
 {
     stdio_init_all();
     
-    printf("System clock: %lu MHz\n", clock_get_hz(clk_sys) / 1000000);
+    printf("System clock: %lu MHz\n", (unsigned long)(clock_get_hz(clk_sys) / 1000000));
     printf("Initializing hardware...\n");
     hardware_init();
     
     printf("Initializing LVGL...\n");
     lv_init();
     lv_tick_set_cb(lv_tick_cb);
+    idle_loop_init();
     
     printf("Creating ST7796 display...\n");
     
+#if DISP_PIPELINE
+    /* Start the flush side on core 1 before the driver sends its init sequence */
+    lcd_pipeline_sink_t sink = {
+        .send_cmd = pipeline_send_cmd,
+        .send_color = pipeline_send_color,
+        .send_transfer = lcd_dma_chain_run,
+        .swap_bytes = !DISP_RENDER_SWAPPED,
+        .tear_sync = PIN_LCD_TE >= 0,
+    };
+    lcd_pipeline_init(&sink);
+    
+    /* Create ST7796 display, core 0 only queues the transfers */
+    lv_display_t *disp = lv_st7796_create(
+        DISP_HOR_RES, 
+        DISP_VER_RES, 
+        LV_LCD_FLAG_BGR,
+        lcd_pipeline_send_cmd, 
+        lcd_pipeline_send_color
+    );
+#if DISP_DMA_CHAIN
+    /* One queue slot and one DMA chain per strip */
+    lv_lcd_generic_mipi_set_send_transfer_cb(disp, lcd_pipeline_send_transfer);
+#endif
+#else
     /* Create ST7796 display */
     lv_display_t *disp = lv_st7796_create(
         DISP_HOR_RES, 
@@ -318,36 +632,133 @@ int main(void)
         lcd_send_cmd, 
         lcd_send_color
     );
+#endif
     
     /* Set landscape mode: swap X/Y axes and adjust mirroring */
     lv_lcd_generic_mipi_set_address_mode(disp, false, true, true, true);
     
-    /* Set display buffer - double buffering for async DMA transfer */
-    lv_display_set_buffers(disp, disp_buf1, disp_buf2, sizeof(disp_buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+#if DISP_ROW_HASH_TILE_W
+    /* Skip unchanged rows, after the address mode as it resets the hashes */
+    lv_lcd_generic_mipi_set_row_hash(disp, DISP_ROW_HASH_TILE_W);
+#endif
+    
+    /* Join the invalidated areas by what they cost on this bus */
+    lv_display_area_cost_t area_cost = {
+        .window = DISP_AREA_COST_WINDOW_NS,
+        .px_render = DISP_AREA_COST_PX_NS,
+        .byte_flush = (uint32_t)(8ull * 1000000000u / spi_get_baudrate(SPI_PORT)),
+    };
+    lv_display_set_area_cost(disp, &area_cost);
+    
+#if DISP_INV_TILE_SIZE
+    lv_display_set_inv_tile_size(disp, DISP_INV_TILE_SIZE);
+#endif
+    
+#if DISP_OCCLUSION_CULLING
+    lv_display_set_occlusion_culling(disp, true);
+#endif
+    
+#if DISP_DRAW_TASK_GRAPH
+    lv_display_set_draw_task_graph(disp, true);
+#endif
+    
+#if DISP_DRAW_ARENA_SIZE
+    lv_draw_arena_resize(DISP_DRAW_ARENA_SIZE);
+#endif
+    
+#if DISP_DRAW_LIST_SIZE
+    lv_obj_draw_list_resize(DISP_DRAW_LIST_SIZE);
+#endif
+    
+#if DISP_GLYPH_CACHE_SIZE
+    lv_font_fmt_txt_cache_resize(DISP_GLYPH_CACHE_SIZE, false);
+#endif
+    
+#if DISP_FONT_LOOKUP_SIZE
+    lv_font_fmt_txt_lookup_set_max_size(DISP_FONT_LOOKUP_SIZE);
+#endif
+    
+#if DISP_SCROLL_BLIT
+    /* After the address mode, the scrolling area depends on it */
+    lv_lcd_generic_mipi_set_hw_scroll(disp, LCD_SCAN_LINES);
+    lv_display_set_scroll_blit(disp, true);
+#endif
+    
+#if PIN_LCD_TE >= 0
+    /* Follow the panel's scan with the TE pulses */
+    lv_lcd_tear_sync_config_t tear_config = {
+        .scan_lines = LCD_SCAN_LINES,
+        .vblank_lines = LCD_VBLANK_LINES,
+        .bus_hz = spi_get_baudrate(SPI_PORT),
+    };
+    tear_disp = disp;
+    lv_lcd_generic_mipi_set_tear_sync(disp, &tear_config);
+    gpio_set_irq_enabled_with_callback(PIN_LCD_TE, GPIO_IRQ_EDGE_RISE, true, gpio_irq_callback);
+#endif
+    
+#if DISP_RENDER_SWAPPED
+    /* Render in the panel's byte order - must be set before the buffers are assigned */
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+#endif
+    
+    /* Set display buffer - ring of strips, each strip is flushed with its own DMA transfer */
+    lv_display_set_buffer_ring(disp, disp_ring, sizeof(disp_ring[0]), DISP_RING_STRIPS);
+#if DISP_PIPELINE
+    lv_display_set_flush_wait_cb(disp, lcd_pipeline_flush_wait_cb);
+    /* The perf monitor shows the load of core 1 next to core 0 */
+    lv_sysmon_performance_set_proc_idle_cb(disp, lcd_pipeline_get_idle_percent);
+#endif
     
     /* Initialize touch controller */
     printf("Initializing FT6336U touch controller...\n");
     if (touch_init()) {
         /* Create LVGL input device for touch */
-        lv_indev_t *indev = lv_indev_create();
-        lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-        lv_indev_set_read_cb(indev, touch_read_cb);
-        lv_indev_set_display(indev, disp);
+        touch_indev = lv_indev_create();
+        lv_indev_set_type(touch_indev, LV_INDEV_TYPE_POINTER);
+        lv_indev_set_display(touch_indev, disp);
+#if TOUCH_USE_INT
+        /* Event mode: the main loop reads the indev once per sample queued after an INT edge */
+        if (touch_ring_init(&touch_dev)) {
+            lv_indev_set_read_cb(touch_indev, touch_ring_read_cb);
+            lv_indev_set_mode(touch_indev, LV_INDEV_MODE_EVENT);
+            gpio_set_irq_enabled_with_callback(PIN_TOUCH_INT, GPIO_IRQ_EDGE_FALL, true, gpio_irq_callback);
+        } else {
+            printf("Warning: Touch interrupt mode failed, polling the controller!\n");
+            lv_indev_set_read_cb(touch_indev, touch_read_cb);
+        }
+#else
+        lv_indev_set_read_cb(touch_indev, touch_read_cb);
+#endif
         printf("Touch controller initialized!\n");
     } else {
         printf("Warning: Touch controller initialization failed!\n");
     }
     
+#if DISP_PIPELINE
+    printf("Starting LVGL Benchmark Demo (Dual Core: render on core 0, flush on core 1)...\n");
+#else
     printf("Starting LVGL Benchmark Demo (Single Core)...\n");
+#endif
     
     /* Run the benchmark demo */
+    lv_demo_benchmark_set_end_cb(benchmark_end_cb);
     lv_demo_benchmark();
     
     printf("LVGL initialized! Entering main loop...\n");
 
     while (true) {
-        lv_timer_handler();
-        /* No delay - run as fast as possible */
+        idle_loop_begin();
+#if TOUCH_USE_INT
+        /* Read the controller after an INT edge, then hand the queued touch samples to
+         * LVGL in order. Bounded, as lv_indev_read() doesn't read while a screen load
+         * animation runs */
+        touch_ring_service();
+        for (int i = 0; touch_indev && i < TOUCH_RING_LEN && touch_ring_pending(); i++) {
+            lv_indev_read(touch_indev);
+        }
+#endif
+        /* Sleep until the next timer, the touch INT or the DMA interrupt */
+        idle_loop_sleep(lv_timer_handler());
     }
     
     return 0;
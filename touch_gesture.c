@@ -0,0 +1,126 @@
+/**
+ * @file touch_gesture.c
+ * @brief Pinch to zoom and two-finger rotation implementation
+ */
+
+#include "touch_gesture.h"
+
+#if LV_USE_GESTURE_RECOGNITION
+
+/*===========================================
+ * Private Defines
+ *===========================================*/
+
+/* The recognizers report floats, converted once to fixed point with 8 (scale)
+ * and 10 (radians) fractional bits; the rest is integer math */
+#define SCALE_FRAC_BITS     8
+#define RAD_FRAC_BITS       10
+
+/* 0.1 degree units per radian (1800 / pi) with 16 fractional bits */
+#define DECIDEG_PER_RAD_Q16 37549362
+
+/*===========================================
+ * Private Types
+ *===========================================*/
+
+/**
+ * @brief Per object state, the transform at the start of the current gesture
+ */
+typedef struct {
+    bool rotate;
+    bool active;            /* A pinch or rotation is in progress */
+    int32_t base_scale;     /* 256 is 100% */
+    int32_t base_rotation;  /* 0.1 degree units */
+} touch_gesture_t;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static bool is_image(lv_obj_t *obj) {
+    return lv_obj_check_type(obj, &lv_image_class);
+}
+
+static int32_t get_scale(lv_obj_t *obj) {
+    return is_image(obj) ? lv_image_get_scale(obj) : lv_obj_get_style_transform_scale_x(obj, LV_PART_MAIN);
+}
+
+static int32_t get_rotation(lv_obj_t *obj) {
+    return is_image(obj) ? lv_image_get_rotation(obj) : lv_obj_get_style_transform_rotation(obj, LV_PART_MAIN);
+}
+
+static void set_scale(lv_obj_t *obj, int32_t scale) {
+    scale = LV_CLAMP(TOUCH_GESTURE_SCALE_MIN, scale, TOUCH_GESTURE_SCALE_MAX);
+    if (is_image(obj)) {
+        lv_image_set_scale(obj, (uint32_t)scale);
+    } else {
+        lv_obj_set_style_transform_scale(obj, scale, LV_PART_MAIN);
+    }
+}
+
+static void set_rotation(lv_obj_t *obj, int32_t rotation) {
+    if (is_image(obj)) {
+        lv_image_set_rotation(obj, rotation);
+    } else {
+        lv_obj_set_style_transform_rotation(obj, rotation, LV_PART_MAIN);
+    }
+}
+
+static void gesture_event_cb(lv_event_t *e) {
+    lv_obj_t *obj = lv_event_get_current_target(e);
+    touch_gesture_t *g = lv_event_get_user_data(e);
+
+    if (lv_event_get_code(e) == LV_EVENT_DELETE) {
+        lv_free(g);
+        return;
+    }
+
+    lv_indev_gesture_type_t type = lv_event_get_gesture_type(e);
+    if (type != LV_INDEV_GESTURE_PINCH && !(type == LV_INDEV_GESTURE_ROTATE && g->rotate)) {
+        return;
+    }
+
+    lv_indev_gesture_state_t state = lv_event_get_gesture_state(e, type);
+    if (state != LV_INDEV_GESTURE_STATE_RECOGNIZED) {
+        /* Ended: keep the transform, the next gesture starts from it */
+        g->active = false;
+        return;
+    }
+
+    if (!g->active) {
+        g->active = true;
+        g->base_scale = get_scale(obj);
+        g->base_rotation = get_rotation(obj);
+    }
+
+    if (type == LV_INDEV_GESTURE_PINCH) {
+        int32_t factor = (int32_t)(lv_event_get_pinch_scale(e) * (1 << SCALE_FRAC_BITS));
+        set_scale(obj, (int32_t)(((int64_t)g->base_scale * factor) >> SCALE_FRAC_BITS));
+    } else {
+        /* Radians to 0.1 degrees */
+        int32_t rad = (int32_t)(lv_event_get_rotation(e) * (1 << RAD_FRAC_BITS));
+        int32_t rotation = (int32_t)(((int64_t)rad * DECIDEG_PER_RAD_Q16) >> (16 + RAD_FRAC_BITS));
+        set_rotation(obj, g->base_rotation + rotation);
+    }
+}
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+void touch_gesture_add_zoom(lv_obj_t *obj, bool rotate) {
+    touch_gesture_t *g = lv_malloc_zeroed(sizeof(touch_gesture_t));
+    LV_ASSERT_MALLOC(g);
+    g->rotate = rotate;
+
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    if (!is_image(obj)) {
+        /* Scale and rotate around the center */
+        lv_obj_set_style_transform_pivot_x(obj, lv_pct(50), LV_PART_MAIN);
+        lv_obj_set_style_transform_pivot_y(obj, lv_pct(50), LV_PART_MAIN);
+    }
+    lv_obj_add_event_cb(obj, gesture_event_cb, LV_EVENT_GESTURE, g);
+    lv_obj_add_event_cb(obj, gesture_event_cb, LV_EVENT_DELETE, g);
+}
+
+#endif /* LV_USE_GESTURE_RECOGNITION */
@@ -0,0 +1,49 @@
+/**
+ * @file touch_gesture.h
+ * @brief Pinch to zoom and two-finger rotation for LVGL objects
+ *
+ * Reacts to the LV_EVENT_GESTURE events the recognizers send while two
+ * fingers are down (see touch_ring.h). Images are scaled and rotated with
+ * lv_image_set_scale()/lv_image_set_rotation(), other objects such as
+ * scrollable containers with the transform_scale/transform_rotation styles
+ * around their center.
+ *
+ * LV_EVENT_GESTURE goes to the pressed object and bubbles to its parent only
+ * with LV_OBJ_FLAG_EVENT_BUBBLE (LV_OBJ_FLAG_GESTURE_BUBBLE is for the
+ * one-finger swipe): set it on the children of a zoomable container.
+ */
+
+#ifndef TOUCH_GESTURE_H
+#define TOUCH_GESTURE_H
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+#if LV_USE_GESTURE_RECOGNITION
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Scale limits, 256 is 100% */
+#define TOUCH_GESTURE_SCALE_MIN     64
+#define TOUCH_GESTURE_SCALE_MAX     2048
+
+/*===========================================
+ * Function Prototypes
+ *===========================================*/
+
+/**
+ * @brief Scale (and optionally rotate) an object with two-finger gestures
+ *
+ * The object is made clickable so the gestures reach it. The gesture state
+ * is allocated here, once, and freed with the object.
+ *
+ * @param obj Object to transform
+ * @param rotate Also follow rotate gestures
+ */
+void touch_gesture_add_zoom(lv_obj_t *obj, bool rotate);
+
+#endif /* LV_USE_GESTURE_RECOGNITION */
+
+#endif /* TOUCH_GESTURE_H */
@@ -0,0 +1,195 @@
+/**
+ * @file touch_ring.c
+ * @brief Interrupt-driven FT6336U sampling implementation
+ */
+
+#include "touch_ring.h"
+#include "core_port.h"
+#include <stdatomic.h>
+
+/*===========================================
+ * Private Variables
+ *===========================================*/
+
+static ft6336u_t *ring_dev;
+
+/* Time of the oldest INT edge not read yet with the lowest bit set, 0 if none.
+ * Written by the interrupt, taken by touch_ring_service() */
+static atomic_uint int_edge;
+
+/* Single-producer/single-consumer ring: touch_ring_service() on the main loop only writes `head`,
+ * the LVGL input device read only writes `tail` */
+static touch_ring_sample_t ring[TOUCH_RING_LEN];
+static atomic_uint ring_head;
+static atomic_uint ring_tail;
+
+/* Last sample handed to LVGL, repeated while the ring is empty */
+static touch_ring_sample_t last_sample;
+
+#if LV_USE_GESTURE_RECOGNITION
+/* Touch IDs pressed in the last sample, to report the lifted ones as released */
+static uint16_t pressed_ids;
+#endif
+
+/* Statistics, each one is written by a single side */
+static atomic_uint stat_pushed;
+static atomic_uint stat_dropped;
+static atomic_uint stat_merged;     /* INT edges merged into one not read yet, by the interrupt */
+static atomic_uint stat_delivered;
+static atomic_uint stat_latency_max_us;
+static atomic_uint stat_latency_sum_us;
+
+/*===========================================
+ * Private Functions
+ *===========================================*/
+
+static void stat_add(atomic_uint *stat, uint32_t value) {
+    atomic_store_explicit(stat, atomic_load_explicit(stat, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+#if LV_USE_GESTURE_RECOGNITION
+/**
+ * @brief Feed the contacts of a new sample to the gesture recognizers
+ *
+ * Every pressed point is reported with its touch ID, the IDs pressed in the
+ * previous sample but missing from this one as released.
+ */
+static void gesture_update(lv_indev_t *indev, lv_indev_data_t *data, const ft6336u_touch_data_t *touch) {
+    lv_indev_touch_data_t touches[FT6336U_MAX_TOUCH_POINTS * 2];
+    uint16_t cnt = 0;
+    uint16_t ids = 0;
+
+    for (uint8_t i = 0; i < touch->touch_count; i++) {
+        const ft6336u_touch_point_t *p = &touch->points[i];
+        if (!p->valid) {
+            continue;
+        }
+        touches[cnt++] = (lv_indev_touch_data_t){
+            .point = {p->x, p->y},
+            .state = LV_INDEV_STATE_PRESSED,
+            .id = p->id,
+            .timestamp = last_sample.time_us / 1000,
+        };
+        ids |= 1u << p->id;
+    }
+
+    for (uint8_t id = 0; id < 16; id++) {
+        if ((pressed_ids & ~ids) & (1u << id)) {
+            touches[cnt++] = (lv_indev_touch_data_t){
+                .state = LV_INDEV_STATE_RELEASED,
+                .id = id,
+                .timestamp = last_sample.time_us / 1000,
+            };
+            if (cnt == sizeof(touches) / sizeof(touches[0])) {
+                break;
+            }
+        }
+    }
+    pressed_ids = ids;
+
+    lv_indev_gesture_recognizers_update(indev, touches, cnt);
+    lv_indev_gesture_recognizers_set_data(indev, data);
+}
+#endif
+
+/*===========================================
+ * Public Functions
+ *===========================================*/
+
+bool touch_ring_init(ft6336u_t *dev) {
+    ring_dev = dev;
+    atomic_store(&int_edge, 0);
+    atomic_store(&ring_head, 0);
+    atomic_store(&ring_tail, 0);
+    last_sample = (touch_ring_sample_t){0};
+#if LV_USE_GESTURE_RECOGNITION
+    pressed_ids = 0;
+#endif
+
+    /* One INT pulse per report instead of INT held low while touched */
+    return ft6336u_set_interrupt_mode(dev, FT6336U_G_MODE_TRIGGER);
+}
+
+void touch_ring_irq_handler(void) {
+    /* Keep the oldest edge: the read gets the newest report anyway, the ones in between are lost */
+    unsigned none = 0;
+    if (!atomic_compare_exchange_strong_explicit(&int_edge, &none, core_port_time_us() | 1u,
+                                                 memory_order_release, memory_order_relaxed)) {
+        stat_add(&stat_merged, 1);
+    }
+}
+
+bool touch_ring_service(void) {
+    uint32_t edge = atomic_exchange_explicit(&int_edge, 0, memory_order_acquire);
+    if (edge == 0) {
+        return false;
+    }
+
+    /* A failed read leaves `data` cleared and reports a release, like the polled read */
+    ft6336u_touch_data_t data;
+    ft6336u_read(ring_dev, &data);
+    return touch_ring_push(&data, edge & ~1u);
+}
+
+bool touch_ring_push(const ft6336u_touch_data_t *data, uint32_t time_us) {
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+
+    if (head - atomic_load_explicit(&ring_tail, memory_order_acquire) >= TOUCH_RING_LEN) {
+        stat_add(&stat_dropped, 1);
+        return false;
+    }
+
+    touch_ring_sample_t *sample = &ring[head % TOUCH_RING_LEN];
+    sample->time_us = time_us;
+    sample->data = *data;
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+    stat_add(&stat_pushed, 1);
+    return true;
+}
+
+bool touch_ring_pending(void) {
+    return atomic_load_explicit(&ring_head, memory_order_acquire) !=
+           atomic_load_explicit(&ring_tail, memory_order_relaxed);
+}
+
+void touch_ring_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    if (atomic_load_explicit(&ring_head, memory_order_acquire) != tail) {
+        last_sample = ring[tail % TOUCH_RING_LEN];
+        atomic_store_explicit(&ring_tail, tail + 1, memory_order_release);
+
+        uint32_t latency_us = core_port_time_us() - last_sample.time_us;
+        stat_add(&stat_delivered, 1);
+        stat_add(&stat_latency_sum_us, latency_us);
+        if (latency_us > atomic_load_explicit(&stat_latency_max_us, memory_order_relaxed)) {
+            atomic_store_explicit(&stat_latency_max_us, latency_us, memory_order_relaxed);
+        }
+
+#if LV_USE_GESTURE_RECOGNITION
+        /* Only new samples move the recognizers, the periodic reads while pressed
+         * would report an ended gesture again */
+        gesture_update(indev, data, &last_sample.data);
+#endif
+    }
+#if !LV_USE_GESTURE_RECOGNITION
+    (void)indev;
+#endif
+
+    /* The first point drives the pointer and the pressed state, whatever the recognizers set */
+    const ft6336u_touch_data_t *touch = &last_sample.data;
+    if (touch->touch_count > 0 && touch->points[0].valid) {
+        data->point.x = touch->points[0].x;
+        data->point.y = touch->points[0].y;
+        data->state = LV_INDEV_STATE_PRESSED;
+    } else {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+void touch_ring_get_stats(touch_ring_stats_t *stats) {
+    stats->pushed = atomic_load(&stat_pushed);
+    stats->dropped = atomic_load(&stat_dropped) + atomic_load(&stat_merged);
+    stats->delivered = atomic_load(&stat_delivered);
+    stats->latency_max_us = atomic_load(&stat_latency_max_us);
+    stats->latency_sum_us = atomic_load(&stat_latency_sum_us);
+}
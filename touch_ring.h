@@ -0,0 +1,116 @@
+/**
+ * @file touch_ring.h
+ * @brief Interrupt-driven FT6336U sampling
+ *
+ * The FT6336U pulls its INT pin low whenever it has a new report. The GPIO
+ * interrupt only latches the time of the edge; the main loop then reads the
+ * touch registers with touch_ring_service() and pushes the timestamped sample
+ * into a lock-free single-producer/single-consumer ring, so nothing is read
+ * over I2C while the screen is not touched, and never with interrupts held.
+ * LVGL runs the input device in `LV_INDEV_MODE_EVENT` mode: the main loop
+ * calls lv_indev_read() once per pending sample and touch_ring_read_cb()
+ * hands them over in order.
+ */
+
+#ifndef TOUCH_RING_H
+#define TOUCH_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft6336u.h"
+#include "lvgl.h"
+
+/*===========================================
+ * Configuration
+ *===========================================*/
+
+/* Number of samples the ring holds (power of two). touch_ring_service()
+ * queues at most one sample per main loop iteration, so on the device the
+ * ring only fills if the main loop skips lv_indev_read() */
+#define TOUCH_RING_LEN      32
+
+/*===========================================
+ * Data Structures
+ *===========================================*/
+
+/**
+ * @brief One report of the touch controller
+ */
+typedef struct {
+    uint32_t time_us;               /* core_port_time_us() of the INT edge */
+    ft6336u_touch_data_t data;      /* Transformed touch points */
+} touch_ring_sample_t;
+
+/**
+ * @brief Ring statistics (counters wrap around)
+ */
+typedef struct {
+    uint32_t pushed;            /* Samples put into the ring */
+    uint32_t dropped;           /* Reports lost: INT edges merged before touch_ring_service() read them,
+                                 * or samples that didn't fit into the ring */
+    uint32_t delivered;         /* Samples handed to LVGL */
+    uint32_t latency_max_us;    /* Longest INT edge to lv_indev_read() time */
+    uint32_t latency_sum_us;    /* Sum of the latencies of the delivered samples */
+} touch_ring_stats_t;
+
+/*===========================================
+ * Function Prototypes
+ *===========================================*/
+
+/**
+ * @brief Empty the ring and switch the controller to trigger mode
+ * @param dev Initialized device, read by touch_ring_service() from now on
+ * @return true on success, false if the controller couldn't be configured
+ */
+bool touch_ring_init(ft6336u_t *dev);
+
+/**
+ * @brief Latch the time of a report, call on the falling edge of INT
+ *
+ * Runs in interrupt context and doesn't touch the I2C bus. Edges before the
+ * next touch_ring_service() are merged, keeping the time of the first one;
+ * the reports of the later ones are counted as dropped.
+ */
+void touch_ring_irq_handler(void);
+
+/**
+ * @brief Read the controller and queue the sample if an INT edge was latched
+ *
+ * Call from the main loop, before handing the samples to LVGL: a 15 byte
+ * burst at 400 kHz takes about 0.4 ms.
+ * @return true if a sample was queued
+ */
+bool touch_ring_service(void);
+
+/**
+ * @brief Queue a sample (producer side)
+ * @param data Touch data to queue (copied)
+ * @param time_us Time of the report, core_port_time_us() base
+ * @return true if queued, false if the ring was full and the sample was dropped
+ */
+bool touch_ring_push(const ft6336u_touch_data_t *data, uint32_t time_us);
+
+/**
+ * @brief Check whether samples are waiting for lv_indev_read()
+ * @return true if the ring is not empty
+ */
+bool touch_ring_pending(void);
+
+/**
+ * @brief Input device read callback (consumer side)
+ *
+ * Hands over the oldest queued sample. With an empty ring (LVGL also reads
+ * periodically while pressed to detect long presses) the last state is
+ * repeated. With LV_USE_GESTURE_RECOGNITION every new sample also feeds both
+ * contacts to the pinch/rotate/two-finger swipe recognizers, without
+ * allocating.
+ */
+void touch_ring_read_cb(lv_indev_t *indev, lv_indev_data_t *data);
+
+/**
+ * @brief Get a snapshot of the ring statistics
+ * @param stats Pointer to the structure to fill
+ */
+void touch_ring_get_stats(touch_ring_stats_t *stats);
+
+#endif /* TOUCH_RING_H */